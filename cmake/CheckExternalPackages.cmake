@@ -121,6 +121,26 @@ foreach (_dalcmake ${_cmakeModules} )
   
 endforeach (_dalcmake)
 
+##____________________________________________________________________
+##                                                                zlib
+
+message (STATUS "Checking for package ZLIB")
+
+if (DAL_VERBOSE_CONFIGURE)
+  find_package (ZLIB)
+else (DAL_VERBOSE_CONFIGURE)
+  find_package (ZLIB QUIET)
+endif (DAL_VERBOSE_CONFIGURE)
+
+if (ZLIB_FOUND)
+  set (HAVE_ZLIB      TRUE )
+  set (DAL_WITH_ZLIB  TRUE )
+  include_directories (${ZLIB_INCLUDE_DIRS})
+  message (STATUS "Checking for package ZLIB - Success")
+else (ZLIB_FOUND)
+  message (STATUS "Checking for package ZLIB - FAIL")
+endif (ZLIB_FOUND)
+
 ##____________________________________________________________________
 ##                                                          Type sizes
 
@@ -26,6 +26,7 @@
 
 #include <dal_config.h>
 #include <data_hl/TBBraw.h>
+#include <data_hl/TBB_FrameRing.h>
 
 //includes for networking
 #include <unistd.h>
@@ -133,11 +134,45 @@ frames in 200MHz mode (default)
        <td> Check the CRCs of the frames:
   (0): do not check the CRCs
        (1): check the header CRCs and discard broken frames (default)
+       (2): check the header and payload CRCs and discard broken frames
             </td>
             <tr>
             <td>-B [--bufferSize] arg</td>
             <td> Size of the input buffer (in frames) when reading from a socket. The default is 
-            50000, which is about 100MByte. </td>
+            50000, which is about 100MByte. The buffer is split evenly into one lock-free
+            frame ring per port (at least 100 frames each). </td>
+            </tr>
+            <tr>
+            <td>--batchSize arg</td>
+            <td> Maximum number of datagrams taken off a socket with a single system call
+            (recvmmsg). The default is 32; 1 reads every frame with a separate recvfrom. </td>
+            </tr>
+            <tr>
+            <td>--socketBuffer arg</td>
+            <td> Size of the kernel receive buffer of each socket, [MB]. Going beyond
+            net.core.rmem_max requires CAP_NET_ADMIN. The default (0) keeps the system
+            setting. </td>
+            </tr>
+            <tr>
+            <td>--workers arg</td>
+            <td> Number of parser threads checking the frames in multi-station mode (-M).
+            The frames of a station are always handled by the same thread; a single
+            additional thread writes all files. The default (0) does everything in the
+            main thread. </td>
+            </tr>
+            <tr>
+            <td>--compression arg</td>
+            <td> Compression of the dipole datasets: none (default), deflate, lz4 or
+            bitshuffle. The samples are shuffled before compression; lz4 and
+            bitshuffle require the corresponding HDF5 filter plugin, otherwise deflate
+            is used. </td>
+            </tr>
+            <tr>
+            <td>--compressionThreads arg</td>
+            <td> Number of threads compressing the chunks of the dipole datasets; complete
+            chunks are then stored with direct chunk writes. Only deflate compression can
+            be run outside the HDF5 library. The default (0) compresses in the thread
+            writing the file. </td>
             </tr>
             <tr>
             <td>-K [--keepRunning]</td>
@@ -161,13 +196,17 @@ frames in 200MHz mode (default)
 #define UDP_PACKET_BUFFER_SIZE 2141
             //!number of frames in the input buffer (50000 is ca. 100MB)
             // (the vBuf of the system on the storage nodes can store ca. 800 frames)
-            //#define INPUT_BUFFER_SIZE 50000
+            // The buffer is split evenly between the per-port frame rings.
             int input_buffer_size;
-
-            //!pointers (array indices) for the last buffer processed and the last buffer written
-            int inBufProcessID,inBufStorID;
-            //!the Input Buffer
-            char * inputBuffer_p;
+            //!max. number of datagrams taken off a socket per system call
+            unsigned int recv_batch_size;
+            //!size of the kernel receive buffer of the sockets, [MB] (0: system default)
+            int recv_buffer_size;
+
+            //!one frame ring per port, filled by the socket reader threads
+            std::vector<DAL::TBB_FrameRing*> frameRings;
+            //!wakes up the processing thread when a frame got published
+            DAL::TBB_FrameSignal * frameSignal;
             //!end all running reader threads
             bool terminateThreads;
             //!maximum number of frames waiting in the vBuf while reading
@@ -178,9 +217,25 @@ frames in 200MHz mode (default)
             int noFramesDropped;
             //!number of running reader-threads
             int noRunning;
-            //!mutex for writing into the buffer
+            //!mutex for the reader-thread bookkeeping
             boost::mutex writeMutex;
 
+            //!number of parser threads in multi-station mode (0: no separate threads)
+            unsigned int nof_workers;
+            //!one frame ring per parser thread, read by the writer thread
+            std::vector<DAL::TBB_FrameRing*> parsedRings;
+            //!wakes up the writer thread when a parser published a frame
+            DAL::TBB_FrameSignal * parsedSignal;
+            //!set once the last frame was handed on to the parser threads
+            volatile bool dispatchDone;
+            //!number of running parser threads
+            volatile int noParsing;
+
+            //!filters applied to the chunks of the dipole datasets
+            DAL::HDF5FilterPipeline filters;
+            //!number of threads compressing the chunks (0: compress upon writing)
+            unsigned int compression_threads=0;
+
             //_______________________________________________________________________________
             // Handling of IO-Priority settings
 
@@ -562,6 +617,101 @@ std::string stationIdToName(int n)
   return s;
 }
 
+//_______________________________________________________________________________
+//                                                               setupFrameRings
+
+/*!
+  \brief Allocate one frame ring per port, sharing the input buffer between them
+
+  \param nofPorts -- Number of ports (i.e. reader threads)
+  \param verbose  -- Produce more output
+ */
+void setupFrameRings (unsigned int nofPorts,
+    bool verbose)
+{
+  unsigned int nofSlots = input_buffer_size/nofPorts;
+
+  if (nofSlots < 100) {
+    nofSlots = 100;
+  };
+
+  frameSignal = new DAL::TBB_FrameSignal();
+  frameRings.resize(nofPorts);
+  for (unsigned int i=0; i<nofPorts; i++) {
+    frameRings[i] = new DAL::TBB_FrameRing(nofSlots, UDP_PACKET_BUFFER_SIZE, frameSignal);
+  };
+
+  if (verbose) {
+    cout << "TBBraw2h5::setupFrameRings: Allocated " << nofPorts << " x "
+      << nofSlots*UDP_PACKET_BUFFER_SIZE << " bytes for the input buffer." << endl;
+  };
+}
+
+//_______________________________________________________________________________
+//                                                             releaseFrameRings
+
+/*!
+  \brief Collect the statistics of the frame rings and release them
+
+  All reader threads must have been joined before calling this.
+ */
+void releaseFrameRings ()
+{
+  for (unsigned int i=0; i<frameRings.size(); i++) {
+    noFramesDropped += frameRings[i]->nofDropped();
+    delete frameRings[i];
+  };
+  frameRings.clear();
+  delete frameSignal;
+  frameSignal = NULL;
+}
+
+//_______________________________________________________________________________
+//                                                                     nextFrame
+
+/*!
+  \brief Get the next frame waiting in any of the frame rings
+
+  \retval ringID   -- Index of the ring the frame was taken from; on input the
+           ring served last, such that all ports are served round-robin.
+  \retval nofBytes -- Number of bytes in the frame
+
+  \return frame -- Pointer to the frame, or \e NULL if all rings are empty. The
+          frame has to be handed back through <tt>frameRings[ringID]->release()</tt>
+ */
+char * nextFrame (unsigned int &ringID,
+    int &nofBytes)
+{
+  char * frame;
+  unsigned int nofRings = frameRings.size();
+
+  for (unsigned int n=1; n<=nofRings; n++) {
+    unsigned int id = (ringID+n)%nofRings;
+    if ((frame = frameRings[id]->readSlot(nofBytes)) != NULL) {
+      ringID = id;
+      if ((int)frameRings[id]->maxFill() > maxCachedFrames) {
+        maxCachedFrames = frameRings[id]->maxFill();
+      };
+      return frame;
+    };
+  };
+
+  return NULL;
+}
+
+//_______________________________________________________________________________
+//                                                               readerThreadDone
+
+//! Book-keeping when a reader thread ends; wakes up the processing thread
+void readerThreadDone ()
+{
+  {
+    boost::mutex::scoped_lock lock(writeMutex);
+    noRunning--;
+  };
+  frameSignal->notify();
+}
+
 //_______________________________________________________________________________
 //                                                             socketReaderThread
 
@@ -569,6 +719,7 @@ std::string stationIdToName(int n)
   \brief Thread that creates and then reads from a socket into the buffer
 
   \param port -- UDP port number to read data from
+  \param ring -- Frame ring to store the received frames in
   \param ip -- Hostname (ip-address) to bind to (not used)
   \param startTimeout -- Timeout when opening socket connection [in sec]
   \param readTimeout -- Timeout while reading from the socket [in sec] 
@@ -578,6 +729,7 @@ std::string stationIdToName(int n)
   \return \t true if successful
  */
 void socketReaderThread (int port,
+    DAL::TBB_FrameRing *ring,
     string ip,
     double startTimeout,
     double readTimeout,
@@ -597,8 +749,7 @@ void socketReaderThread (int port,
   if (main_socket<0) {
     cerr << "[TBBraw2h5::socketReaderThread] " << port
       << " : Failed to create the main socket."<<endl;
-    boost::mutex::scoped_lock lock(writeMutex);
-    noRunning--;
+    readerThreadDone();
     return;
   };
 
@@ -613,10 +764,17 @@ void socketReaderThread (int port,
   {
     cerr << "TBBraw2h5::socketReaderThread:"<<port<<": Failed to bind to port"
       << "(with ip: " << ip <<")"<< endl;
-    boost::mutex::scoped_lock lock(writeMutex);
-    noRunning--;
+    readerThreadDone();
     return;
   };
+  //Enlarge the kernel buffer, to ride out hiccups of the processing thread
+  if (recv_buffer_size > 0) {
+    erg = DAL::TBB_FrameRing::setReceiveBufferSize(main_socket, recv_buffer_size*1024*1024);
+    if (verbose) {
+      cout << "TBBraw2h5::socketReaderThread:"<<port<<": Receive buffer size set to "
+        << erg << " bytes." << endl;
+    };
+  };
   //Wait for the first data to arrive
   cout << "TBBraw2h5::socketReaderThread:"<<port<<": Waiting for data." << endl;
   FD_ZERO(&readSet);
@@ -637,8 +795,7 @@ void socketReaderThread (int port,
       };
       if (lastEvent)
       {
-        boost::mutex::scoped_lock lock(writeMutex);
-        noRunning--;
+        readerThreadDone();
         return;
       }
     }
@@ -652,14 +809,14 @@ void socketReaderThread (int port,
       };
       if (lastEvent)
       {
-        boost::mutex::scoped_lock lock(writeMutex);
-        noRunning--;
+        readerThreadDone();
         return;
       }
     };
   };
   bool ImRunning=true;
-  int status, numWaiting=0, newBufID;
+  int status, numWaiting=0;
+  char * slot;
   struct sockaddr_in incoming_addr;
   socklen_t socklen = sizeof(incoming_addr);
   while (ImRunning && !terminateThreads)
@@ -685,33 +842,27 @@ void socketReaderThread (int port,
     FD_ZERO(&readSet);
     FD_SET(main_socket, &readSet);
     TimeoutWait = TimeoutRead;
-    if ((status = select(main_socket + 1, &readSet, NULL, NULL, &TimeoutWait)) )
+    if ((status = select(main_socket + 1, &readSet, NULL, NULL, &TimeoutWait)) &&
+        (recv_batch_size > 1))
     {
-      //there is a frame waiting in the vBuffer
-      {
-        //  make sure that we are the only ones writing to the input buffer
-        //  (concurrent reading is O.K.)
-        boost::mutex::scoped_lock lock(writeMutex);
-        newBufID = inBufStorID+1;
-        if (newBufID >= input_buffer_size)
-        {
-          newBufID =0;
-        }
-        if (newBufID == inBufProcessID)
-        {
-          noFramesDropped++;
-          newBufID = inBufStorID;
-        };
-        //perform the actual read
-        erg = recvfrom (main_socket,
-            (inputBuffer_p + (newBufID*UDP_PACKET_BUFFER_SIZE)),
-            UDP_PACKET_BUFFER_SIZE,
-            0,
-            (sockaddr *) &incoming_addr,
-            &socklen);
-        inBufStorID = newBufID;
-      }
-      ;// writeMutex lock is released here
+      //there are frames waiting in the vBuffer; take as many as possible
+      //into the ring with a single system call
+      ring->receive(main_socket, recv_batch_size);
+    }
+    else if (status)
+    {
+      //there is a frame waiting in the vBuffer; receive it directly into the
+      //ring (if the ring is full this is a scratch slot and the frame is dropped)
+      slot = ring->writeSlot();
+      erg = recvfrom (main_socket,
+          slot,
+          UDP_PACKET_BUFFER_SIZE,
+          0,
+          (sockaddr *) &incoming_addr,
+          &socklen);
+      if (erg > 0) {
+        ring->commit(erg);
+      };
       if (verbose)
       {
         if (erg != 2140)
@@ -733,11 +884,13 @@ void socketReaderThread (int port,
   if (verbose && ImRunning && terminateThreads ) {
     cout << "TBBraw2h5::socketReaderThread:"<<port<<": stopped because terminateThreads was set!" << endl;
   };
-  {
-    boost::mutex::scoped_lock lock(writeMutex);
-    noRunning--;
+  if (verbose && ring->nofBatches() > 0) {
+    cout << "TBBraw2h5::socketReaderThread:"<<port<<": Received " << ring->nofFrames()
+      << " frames in " << ring->nofBatches() << " batches (max. "
+      << ring->maxBatch() << " frames per batch)." << endl;
   };
   close(main_socket);
+  readerThreadDone();
   return;
 };
 
@@ -788,17 +941,9 @@ bool readFromSockets (std::vector<int> ports,
 
   terminateThreads = false;
   maxCachedFrames  = maxWaitingFrames = 0;
-  inBufProcessID   = inBufStorID =0;
+  noFramesDropped  = 0;
   noRunning        = 0;
-  inputBuffer_p    = new char[(input_buffer_size*UDP_PACKET_BUFFER_SIZE)];
-
-  if (inputBuffer_p == NULL) {
-    cerr << "TBBraw2h5::readFromSockets: Failed to allocate input buffer!" <<endl;
-    return false;
-  } else if (verbose) {
-    cout << "TBBraw2h5::readFromSockets: Allocated " << input_buffer_size*UDP_PACKET_BUFFER_SIZE
-      << " bytes for the input buffer." << endl;
-  };
+  setupFrameRings (ports.size(), verbose);
 
   // start the reader-threads
   boost::thread **readerThreads;
@@ -806,6 +951,7 @@ bool readFromSockets (std::vector<int> ports,
   for (i=0; i < ports.size(); i++) {
     readerThreads[i] = new boost::thread(boost::bind(socketReaderThread,
           ports[i],
+          frameRings[i],
           ip,
           startTimeout,
           readTimeout,
@@ -820,17 +966,30 @@ bool readFromSockets (std::vector<int> ports,
       return false;
     };
   };
-  int processingID, tmpint;
+  unsigned int ringID = 0;
+  unsigned long sequence;
+  int nofBytes;
   int amWaiting=0;
-  while ((noRunning>0) || (inBufStorID != inBufProcessID) )  {
-    if (inBufStorID == inBufProcessID)  {
+  while (true)  {
+    sequence      = frameSignal->sequence();
+    bufferPointer = nextFrame(ringID, nofBytes);
+    if (bufferPointer == NULL)  {
+      if (noRunning<=0) {
+        break;
+      };
       if (verbose && ((amWaiting%100)==1) ) {
         cout << "TBBraw2h5::readFromSockets: Status report: Buffer is empty! waiting." << endl;
-        cout << "  Status: inBufStorID:" << inBufStorID << " inBufProcessID: " << inBufProcessID
-          << " noRunning: " << noRunning << " waiting for: " << amWaiting*0.10 << " sec."<< endl;
+        cout << "  Status: noRunning: " << noRunning
+          << " waiting for: " << amWaiting*0.10 << " sec."<< endl;
+      };
+      // block until a reader thread publishes a frame (or 0.1 sec passed)
+      if (!frameSignal->wait(sequence, 0.1)) {
+        amWaiting++;
+        // the data stream paused: write out the data staged for the dipoles
+        if (amWaiting==1 && tbb != NULL) {
+          tbb->flush();
+        };
       };
-      amWaiting++;
-      usleep(100000);
       if (!waitForAllPorts && maxCachedFrames>0 && (amWaiting*0.10 > readTimeout)){
         if (verbose && ! terminateThreads) {
           cout << "TBBraw2h5::readFromSockets: Stopping all other reader-threads." << endl;
@@ -840,17 +999,8 @@ bool readFromSockets (std::vector<int> ports,
       continue;
     };
     amWaiting=0;
-    tmpint = (inBufStorID-inBufProcessID+input_buffer_size)%input_buffer_size;
-    if (tmpint > maxCachedFrames) {
-      maxCachedFrames = tmpint;
-    };
-    processingID = inBufProcessID+1;
-    if (processingID >= input_buffer_size) {
-      processingID -= input_buffer_size;
-    };
 
     // Create new time stamped file if required
-    bufferPointer = inputBuffer_p + (processingID*UDP_PACKET_BUFFER_SIZE);
     if (tbb == NULL)
     {
       // Get timestamp and convert to ISO 8601 format for filename
@@ -886,12 +1036,15 @@ bool readFromSockets (std::vector<int> ports,
       else {
         tbb->doHeaderCRC(false);
       };
+      tbb->doDataCRC(doCheckCRC>1);
       tbb->setFixTimes(fixTransientTimes);
+      tbb->setFilters(filters);
+      tbb->setCompressionThreads(compression_threads);
     }
 
     tbb->processTBBrawBlock(bufferPointer,
-        UDP_PACKET_BUFFER_SIZE);
-    inBufProcessID = processingID;
+        nofBytes);
+    frameRings[ringID]->release();
   };
   terminateThreads = true;
   for (i=0;  i< ports.size(); i++){
@@ -899,7 +1052,7 @@ bool readFromSockets (std::vector<int> ports,
     delete readerThreads[i];
   };
   delete [] readerThreads;
-  delete inputBuffer_p;
+  releaseFrameRings();
   if (verbose) {
     cout << "Socket and Buffer Stats: Maximum # of waiting frames:" << maxWaitingFrames << endl;
     cout << "                        Maximum # of frames in cache:" << maxCachedFrames << endl;
@@ -908,6 +1061,242 @@ bool readFromSockets (std::vector<int> ports,
   return true;
 };
 
+//_______________________________________________________________________________
+//                                                                   StationFiles
+
+/*!
+  \brief The output files of readStationsFromSockets(), one per station
+
+  Opens a new file for a station when its first frame arrives, or when its data
+  resumes after a pause longer than the read time-out. Only a single thread may
+  use an object of this type, as none of the HDF5 calls are thread-safe.
+ */
+struct StationFiles {
+
+  //! Output file of each station ID (NULL if there is none open)
+  DAL::TBBraw *files[256];
+  //! Time-stamp of the last frame written for each station ID
+  int lasttimes[256];
+  //! Prefix of the file names
+  std::string outFileBase;
+  //! Common attributes of the files
+  std::string observer, project, observationID, filterSelection, antennaSet;
+  //! Time-out while reading from the socket [in sec]
+  float readTimeout;
+  //! Produce more output
+  bool verbose;
+
+  StationFiles (std::string const &outFileBase_,
+      std::string const &observer_,
+      std::string const &project_,
+      std::string const &observationID_,
+      std::string const &filterSelection_,
+      std::string const &antennaSet_,
+      float readTimeout_,
+      bool verbose_)
+    : outFileBase(outFileBase_),
+    observer(observer_),
+    project(project_),
+    observationID(observationID_),
+    filterSelection(filterSelection_),
+    antennaSet(antennaSet_),
+    readTimeout(readTimeout_),
+    verbose(verbose_)
+  {
+    for (int i=0; i<256; i++) {
+      files[i]     = NULL;
+      lasttimes[i] = 0;
+    };
+  }
+
+  ~StationFiles () {
+    closeAll();
+  }
+
+  //! Get the file to write a frame to, starting a new file if required
+  DAL::TBBraw * get (char *frame) {
+    unsigned char stationId = DAL::TBBraw::getStationId(frame);
+    time_t timestamp;
+    struct tm *timestamp_utc;
+    double timestamp_fraction;
+    char timestamp_buffer[20];
+
+    if ( (files[stationId] != NULL) &&
+        (DAL::TBBraw::getDataTime(frame) <= (lasttimes[stationId]+ceil(readTimeout)) ) ){
+      return files[stationId];
+    };
+    close(stationId);
+
+    // Get timestamp and convert to ISO 8601 format for filename
+    timestamp = (time_t) DAL::TBBraw::getDataTime(frame);
+    timestamp_utc = gmtime( &timestamp );
+    timestamp_fraction = DAL::TBBraw::getDataTimeFraction(frame) + timestamp_utc->tm_sec;
+    strftime (timestamp_buffer, 20, "%Y%m%dT%H%M", timestamp_utc);
+
+    // Generate filename
+    std::ostringstream outfile;
+    outfile << outFileBase << observationID << "_D" << timestamp_buffer << std::setw(6) << std::setfill('0') << std::setiosflags(std::ios::fixed) << std::setprecision(3) << timestamp_fraction << "Z" << "_" << stationIdToName(stationId);
+
+    // Check if filename exists already and change it accordingly
+    int n = 0;
+    while (boost::filesystem::exists(outfile.str()+"_R"+zero_padded_number(n, 3)+"_tbb.h5"))
+    {
+      ++n;
+    }
+    outfile << "_R" << std::setw(3) << std::setfill('0') << n;
+
+    files[stationId] = new DAL::TBBraw(outfile.str()+"_tbb.h5", observer, project, observationID, filterSelection, "LOFAR", antennaSet);
+    if ( !files[stationId]->isConnected() ) {
+      cout << "TBBraw2h5::readStationsFromSockets: Failed to open output file:" 
+        << outfile.str() << endl;
+      terminateThreads=true;
+      delete files[stationId];
+      files[stationId] = NULL;
+    } else {
+      files[stationId]->setFilters(filters);
+      files[stationId]->setCompressionThreads(compression_threads);
+    };
+    return files[stationId];
+  }
+
+  //! Book-keeping after a frame got written to its file
+  void written (char *frame) {
+    lasttimes[DAL::TBBraw::getStationId(frame)] = DAL::TBBraw::getDataTime(frame);
+  }
+
+  //! Write out the data staged in all open files
+  void flush () {
+    for (int i=0; i<256; i++) {
+      if (files[i] != NULL) {
+        files[i]->flush();
+      };
+    };
+  }
+
+  //! Close the file of one station
+  void close (int stationId) {
+    if (files[stationId] != NULL) {
+      files[stationId]->flush();
+      if (verbose) {
+        files[stationId]->summary();
+      };
+      delete files[stationId];
+      files[stationId] = NULL;
+    };
+  }
+
+  //! Close all open files
+  void closeAll () {
+    for (int i=0; i<256; i++) {
+      close(i);
+    };
+  }
+};
+
+//_______________________________________________________________________________
+//                                                                   parserThread
+
+/*!
+  \brief Thread checking the frames of a subset of the stations
+
+  \param input  -- Frame ring filled by the dispatcher
+  \param output -- Frame ring the valid frames are handed on to the writer in
+  \param parser -- Unconnected TBBraw object holding the settings and
+         statistics of this parser
+
+  Runs DAL::TBBraw::prepareTBBrawBlock() on the frames, i.e. byte swapping, CRC
+  checks and time-stamp fixing, which do not touch the output file. Ends once
+  \t dispatchDone is set and the input ring is drained.
+ */
+void parserThread (DAL::TBB_FrameRing *input,
+    DAL::TBB_FrameRing *output,
+    DAL::TBBraw *parser)
+{
+  int nofBytes;
+  bool done;
+  char * frame;
+
+  while (true) {
+    done  = dispatchDone;
+    frame = input->readSlot(nofBytes);
+    if (frame == NULL) {
+      if (done) {
+        break;
+      };
+      input->waitForFrame(0.1);
+      continue;
+    };
+    if (parser->prepareTBBrawBlock(frame, nofBytes)) {
+      //if the writer does not keep up this is a scratch slot and the frame is dropped
+      memcpy(output->writeSlot(), frame, nofBytes);
+      output->commit(nofBytes);
+    };
+    input->release();
+  };
+
+  {
+    boost::mutex::scoped_lock lock(writeMutex);
+    noParsing--;
+  };
+  parsedSignal->notify();
+}
+
+//_______________________________________________________________________________
+//                                                                   writerThread
+
+/*!
+  \brief Thread writing the frames checked by the parser threads to the files
+
+  \param files -- The output files; only accessed by this thread
+  \param readTimeout -- Timeout while reading from the socket [in sec]
+
+  Ends once all parser threads have ended and their rings are drained.
+ */
+void writerThread (StationFiles *files,
+    float readTimeout)
+{
+  unsigned int ringID = 0;
+  unsigned int nofRings = parsedRings.size();
+  unsigned long sequence;
+  int nofBytes;
+  int amWaiting = 0;
+  int running;
+  char * frame;
+  DAL::TBBraw *tbbfile;
+
+  while (true) {
+    sequence = parsedSignal->sequence();
+    running  = noParsing;
+    frame    = NULL;
+    for (unsigned int n=1; n<=nofRings && frame==NULL; n++) {
+      ringID = (ringID+1)%nofRings;
+      frame  = parsedRings[ringID]->readSlot(nofBytes);
+    };
+    if (frame == NULL) {
+      if (running<=0) {
+        break;
+      };
+      if (!parsedSignal->wait(sequence, 0.1)) {
+        amWaiting++;
+        // the data stream paused: write out the data staged for the dipoles
+        if (amWaiting==1) {
+          files->flush();
+        };
+      };
+      if (amWaiting*0.10 > readTimeout){
+        files->closeAll();
+      };
+      continue;
+    };
+    amWaiting=0;
+    tbbfile = files->get(frame);
+    if ( (tbbfile != NULL) && tbbfile->writeTBBrawBlock(frame) ){
+      files->written(frame);
+    };
+    parsedRings[ringID]->release();
+  };
+}
+
 //_______________________________________________________________________________
 //                                                        readStationsFromSockets
 
@@ -924,6 +1313,12 @@ bool readFromSockets (std::vector<int> ports,
 
   Compared to \t readFromSockets() this function generates less (usefull)
   debug output. So the other (old) version should stay around.
+
+  If \t nof_workers is larger than zero, the frames are handed on to that many
+  parser threads -- all frames of a station to the same thread, so the order of
+  the frames of a dipole is kept -- which check them and pass them on to a
+  single writer thread. There is only one thread writing to the files, as the
+  HDF5 library does not support concurrent calls.
  */
 bool readStationsFromSockets (std::vector<int> ports,
     std::string ip,
@@ -945,38 +1340,47 @@ bool readStationsFromSockets (std::vector<int> ports,
   terminateThreads = false;
   maxCachedFrames  = 0;
   maxWaitingFrames = 0;
-  inBufProcessID   = 0;
-  inBufStorID      = 0;
+  noFramesDropped  = 0;
   noRunning        = 0;
-  inputBuffer_p    = new char[(input_buffer_size*UDP_PACKET_BUFFER_SIZE)];
+  setupFrameRings (ports.size(), verbose);
 
-  if (inputBuffer_p == NULL) {
-    std::cerr << "TBBraw2h5::readStationsFromSockets: Failed to allocate input buffer!"
-      << std::endl;
-    return false;
-  } else if (verbose) {
-    cout << "TBBraw2h5::readStationsFromSockets: Allocated "
-      << input_buffer_size*UDP_PACKET_BUFFER_SIZE
-      << " bytes for the input buffer." << endl;
-  };
+  StationFiles files (outFileBase, observer, project, observationID,
+      filterSelection, antennaSet, readTimeout, verbose);
 
   //________________________________________________________
-  // Get and initialize memory for the TBB pointers
-
-  unsigned int nofTBBfiles = 256;
-  int lasttimes[nofTBBfiles];  
-  int runnumbers[nofTBBfiles];  
-  time_t timestamp;
-  struct tm *timestamp_utc;
-  double timestamp_fraction;
-  char timestamp_buffer[20];
-
-  DAL::TBBraw **TBBfiles = new DAL::TBBraw* [nofTBBfiles]; 
-
-  for (i=0; i<nofTBBfiles; i++) {
-    TBBfiles[i]   = NULL;
-    runnumbers[i] = 0;
-  }
+  // Start the parser threads and the writer thread
+
+  std::vector<DAL::TBB_FrameRing*> workerRings (nof_workers);
+  std::vector<DAL::TBBraw*> parsers (nof_workers);
+  std::vector<boost::thread*> parserThreads (nof_workers);
+  boost::thread *writer = NULL;
+
+  dispatchDone = false;
+  noParsing    = 0;
+  if (nof_workers > 0) {
+    unsigned int nofSlots = input_buffer_size/(2*nof_workers);
+    if (nofSlots < 1000) {
+      nofSlots = 1000;
+    };
+    parsedSignal = new DAL::TBB_FrameSignal();
+    parsedRings.resize(nof_workers);
+    for (i=0; i<nof_workers; i++) {
+      workerRings[i] = new DAL::TBB_FrameRing(nofSlots, UDP_PACKET_BUFFER_SIZE);
+      parsedRings[i] = new DAL::TBB_FrameRing(nofSlots, UDP_PACKET_BUFFER_SIZE, parsedSignal);
+      parsers[i]     = new DAL::TBBraw();
+      noParsing++;
+      parserThreads[i] = new boost::thread (boost::bind(parserThread,
+            workerRings[i],
+            parsedRings[i],
+            parsers[i]));
+    };
+    writer = new boost::thread (boost::bind(writerThread, &files, readTimeout));
+    if (verbose) {
+      cout << "TBBraw2h5::readStationsFromSockets: Started " << nof_workers
+        << " parser threads with 2 x " << nofSlots*UDP_PACKET_BUFFER_SIZE
+        << " bytes of buffer each." << endl;
+    };
+  };
 
   //________________________________________________________
   // Start the reader-threads
@@ -986,6 +1390,7 @@ bool readStationsFromSockets (std::vector<int> ports,
   for (i=0; i < ports.size(); i++) {
     readerThreads[i] = new boost::thread (boost::bind(socketReaderThread,
           ports[i],
+          frameRings[i],
           ip,
           startTimeout,
           readTimeout,
@@ -1004,94 +1409,95 @@ bool readStationsFromSockets (std::vector<int> ports,
   //________________________________________________________
   // Look for and process incoming data
 
-  int processingID = 0;
-  int tmpint       = 0;
+  unsigned int ringID = 0;
+  unsigned long sequence;
+  int nofBytes;
   int amWaiting    = 0;
-  unsigned char stationId;
   char * bufferPointer;
+  DAL::TBBraw *tbbfile;
 
-  while (((noRunning>0) || (inBufStorID != inBufProcessID)) )  {
-    if (inBufStorID == inBufProcessID)  {
+  while (true)  {
+    sequence      = frameSignal->sequence();
+    bufferPointer = nextFrame(ringID, nofBytes);
+    if (bufferPointer == NULL)  {
+      if (noRunning<=0) {
+        break;
+      };
       if (verbose && ((amWaiting%100)==1) ) {
         std::cout << "[TBBraw2h5::readStationsFromSockets]"
           << " Status report: Buffer is empty! waiting." << std::endl;
         // Do not split this up into several lines, as it makes the logfile hard to read!
-        std::cout << "  Status: inBufStorID:" << inBufStorID 
-          << " inBufProcessID: " << inBufProcessID
-          << " noRunning: " << noRunning 
+        std::cout << "  Status: noRunning: " << noRunning 
           << " waiting for: " << amWaiting*0.10 << " sec." << std::endl;
       };
-      amWaiting++;
-      usleep(100000);
-      if (amWaiting*0.10 > readTimeout){
-        for (i=0; i<256; i++) {
-          if (TBBfiles[i] != NULL) {
-            if (verbose) {
-              TBBfiles[i]->summary();
-            };
-            delete TBBfiles[i];
-            TBBfiles[i] = NULL;
-          };
-        };	
+      // block until a reader thread publishes a frame (or 0.1 sec passed)
+      if (!frameSignal->wait(sequence, 0.1)) {
+        amWaiting++;
+        // the data stream paused: write out the data staged for the dipoles
+        if (amWaiting==1 && nof_workers==0) {
+          files.flush();
+        };
+      };
+      if (amWaiting*0.10 > readTimeout && nof_workers==0){
+        files.closeAll();
       };
       continue;
     };
     amWaiting=0;
-    tmpint = (inBufStorID-inBufProcessID+input_buffer_size)%input_buffer_size;
-    if (tmpint > maxCachedFrames) {
-      maxCachedFrames = tmpint;
-    };
-    processingID = inBufProcessID+1;
-    if (processingID >= input_buffer_size) {
-      processingID -= input_buffer_size;
-    };
-    bufferPointer = (inputBuffer_p + (processingID*UDP_PACKET_BUFFER_SIZE));
-    stationId = DAL::TBBraw::getStationId(bufferPointer);
-    if ( (TBBfiles[stationId] == NULL) || 
-        (DAL::TBBraw::getDataTime(bufferPointer) > (lasttimes[stationId]+ceil(readTimeout)) ) ){
-      if (TBBfiles[stationId] != NULL) {
-        if (verbose) {
-          TBBfiles[stationId]->summary();
-        };
-        delete TBBfiles[stationId];
-        TBBfiles[stationId] = NULL;
+    if (nof_workers > 0) {
+      // hand the frame on to the parser thread of its station
+      DAL::TBB_FrameRing *ring = workerRings[DAL::TBBraw::getStationId(bufferPointer)%nof_workers];
+      memcpy(ring->writeSlot(), bufferPointer, nofBytes);
+      ring->commit(nofBytes);
+    } else {
+      tbbfile = files.get(bufferPointer);
+      if ( (tbbfile != NULL) && tbbfile->processTBBrawBlock(bufferPointer, nofBytes) ){ 
+        files.written(bufferPointer);
       };
+    };
+    frameRings[ringID]->release();
+  };
 
-      // Get timestamp and convert to ISO 8601 format for filename
-      timestamp = (time_t) DAL::TBBraw::getDataTime(bufferPointer);
-      timestamp_utc = gmtime( &timestamp );
-      timestamp_fraction = DAL::TBBraw::getDataTimeFraction(bufferPointer) + timestamp_utc->tm_sec;
-      strftime (timestamp_buffer, 20, "%Y%m%dT%H%M", timestamp_utc);
-
-      // Generate filename
-      std::ostringstream outfile;
-      outfile << outFileBase << observationID << "_D" << timestamp_buffer << std::setw(6) << std::setfill('0') << std::setiosflags(std::ios::fixed) << std::setprecision(3) << timestamp_fraction << "Z" << "_" << stationIdToName(stationId);
+  terminateThreads = true;
 
-      // Check if filename exists already and change it accordingly
-      int n = 0;
-      while (boost::filesystem::exists(outfile.str()+"_R"+zero_padded_number(n, 3)+"_tbb.h5"))
-      {
-        ++n;
-      }
-      outfile << "_R" << std::setw(3) << std::setfill('0') << n;
+  //________________________________________________________
+  // Drain the pipeline and release allocated memory
 
-      TBBfiles[stationId] = new DAL::TBBraw(outfile.str()+"_tbb.h5", observer, project, observationID, filterSelection, "LOFAR", antennaSet);
-      if ( !TBBfiles[stationId]->isConnected() ) {
-        cout << "TBBraw2h5::readStationsFromSockets: Failed to open output file:" 
-          << outfile.str() << endl;
-        terminateThreads=true;
-      };       
+  if (nof_workers > 0) {
+    dispatchDone = true;
+    for (i=0; i<nof_workers; i++) {
+      workerRings[i]->signal()->notify();
     };
-    if ( TBBfiles[stationId]->processTBBrawBlock(bufferPointer, UDP_PACKET_BUFFER_SIZE) ){ 
-      lasttimes[stationId] = DAL::TBBraw::getDataTime(bufferPointer);
+    for (i=0; i<nof_workers; i++) {
+      parserThreads[i]->join();
+      delete parserThreads[i];
     };
-    inBufProcessID = processingID;    
+    writer->join();
+    delete writer;
+    for (i=0; i<nof_workers; i++) {
+      noFramesDropped += workerRings[i]->nofDropped() + parsedRings[i]->nofDropped();
+      if (verbose) {
+        parsers[i]->summary();
+      };
+      delete workerRings[i];
+      delete parsedRings[i];
+      delete parsers[i];
+    };
+    parsedRings.clear();
+    delete parsedSignal;
+    parsedSignal = NULL;
   };
+  files.closeAll();
 
-  // Release allocated memory
-  delete [] TBBfiles;
-
-  terminateThreads = true;
+  for (i=0; i<ports.size(); i++) {
+    readerThreads[i]->join();
+    delete readerThreads[i];
+  };
+  delete [] readerThreads;
+  releaseFrameRings();
+  if (verbose) {
+    cout << "     Number of frames dropped due to buffer overflow:" << noFramesDropped << endl;
+  };
 
   return true;
 }
@@ -1180,6 +1586,9 @@ int main(int argc, char *argv[])
   keepRunning            = false;
   lastEvent              = false;
   input_buffer_size = 50000;
+  recv_batch_size   = 32;
+  recv_buffer_size  = 0;
+  nof_workers       = 0;
 
   // Register signal and signal handler
   signal(SIGTERM, signal_callback_handler);
@@ -1203,8 +1612,13 @@ int main(int argc, char *argv[])
     ("timeoutStart,S", bpo::value<float>(), "Time-out when opening socket connection, [sec].")
     ("timeoutRead,R", bpo::value<float>(), "Time-out when while reading from socket, [sec].")
     ("fixTimes,F", bpo::value<int>(), "Fix broken time-stamps old style (1), new style (2, default), or not (0)")
-    ("doCheckCRC,C", bpo::value<int>(), "Check the CRCs: (0) no check, (1,default) check header.")
+    ("doCheckCRC,C", bpo::value<int>(), "Check the CRCs: (0) no check, (1,default) check header, (2) check header and payload.")
     ("bufferSize,B", bpo::value<int>(), "Size of the input buffer, [frames] (default=50000, about 100MB).")
+    ("batchSize", bpo::value<int>(), "Max. number of frames received per system call (default=32, 1: no batching).")
+    ("socketBuffer", bpo::value<int>(), "Size of the kernel receive buffer per socket, [MB] (default=0: system setting).")
+    ("workers", bpo::value<int>(), "Number of parser threads in multi-station mode (default=0: process in the main thread).")
+    ("compression", bpo::value<std::string>(), "Compression of the dipole datasets: none (default), deflate, lz4 or bitshuffle.")
+    ("compressionThreads", bpo::value<int>(), "Number of threads compressing the chunks (default=0: compress upon writing).")
     ("keepRunning,K", "Keep running, i.e. process more than one event by restarting the procedure.")
     ("waitForAll,W", "Wait until (some) data was received on all ports.")
     ("multipeStations,M", "Process data from multiple stations into seperate files. (implies -K)")
@@ -1321,6 +1735,47 @@ int main(int argc, char *argv[])
     input_buffer_size = vm["bufferSize"].as<int>();
   }
 
+  if (vm.count("batchSize"))
+  {
+    int batchSize = vm["batchSize"].as<int>();
+    recv_batch_size = batchSize > 1 ? batchSize : 1;
+    if (recv_batch_size > TBB_FRAMERING_MAX_BATCH) {
+      recv_batch_size = TBB_FRAMERING_MAX_BATCH;
+    };
+  }
+
+  if (vm.count("socketBuffer"))
+  {
+    recv_buffer_size = vm["socketBuffer"].as<int>();
+  }
+
+  if (vm.count("workers"))
+  {
+    int workers = vm["workers"].as<int>();
+    nof_workers = workers > 0 ? workers : 0;
+  }
+
+  if (vm.count("compression"))
+  {
+    std::string compression = vm["compression"].as<std::string>();
+    if (compression == "deflate") {
+      filters = DAL::HDF5FilterPipeline(DAL::HDF5FilterPipeline::Deflate, 1);
+    } else if (compression == "lz4") {
+      filters = DAL::HDF5FilterPipeline(DAL::HDF5FilterPipeline::LZ4);
+    } else if (compression == "bitshuffle") {
+      filters = DAL::HDF5FilterPipeline(DAL::HDF5FilterPipeline::BitshuffleLZ4);
+    } else if (compression != "none") {
+      std::cerr << "[TBBraw2h5] Unknown compression " << compression << std::endl;
+      return 1;
+    }
+  }
+
+  if (vm.count("compressionThreads"))
+  {
+    int threads = vm["compressionThreads"].as<int>();
+    compression_threads = threads > 0 ? threads : 0;
+  }
+
   //________________________________________________________
   // Check the provided input
 
@@ -1365,9 +1820,12 @@ int main(int argc, char *argv[])
       std::cout << "-- Port numbers    = " << ports           << std::endl;
       std::cout << "-- Timeout (start) = " << timeoutStart    << std::endl;
       std::cout << "-- Timeout (read)  = " << timeoutRead     << std::endl;
+      std::cout << "-- Batch size      = " << recv_batch_size << std::endl;
+      std::cout << "-- Socket buffer   = " << recv_buffer_size << " MB" << std::endl;
       std::cout << "-- Wait for ports  = " << waitForAll      << std::endl;
       std::cout << "-- Keep Running    = " << keepRunning     << std::endl;
       std::cout << "-- Multipe Stations= " << multipeStations << std::endl;
+      std::cout << "-- Parser threads  = " << nof_workers     << std::endl;
     }
     else {
       std::cout << "-- Input file   = " << infile  << std::endl;
@@ -1421,6 +1879,7 @@ int main(int argc, char *argv[])
 
       //__________________________________________________
       // Finish up, print some statistics.
+      tbb->flush();
       tbb->summary();
 
       delete tbb;
@@ -1466,7 +1925,10 @@ int main(int argc, char *argv[])
     else {
       tbb->doHeaderCRC(false);
     };
+    tbb->doDataCRC(doCheckCRC>1);
     tbb->setFixTimes(fixTransientTimes);
+    tbb->setFilters(filters);
+    tbb->setCompressionThreads(compression_threads);
 
     // -----------------------------------------------------------------
     // call the conversion routines
@@ -1475,6 +1937,7 @@ int main(int argc, char *argv[])
 
     // -----------------------------------------------------------------
     //finish up, print some statistics.
+    tbb->flush();
     tbb->summary();
 
     // and free the memory:
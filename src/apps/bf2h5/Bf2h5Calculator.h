@@ -25,18 +25,15 @@
 #define BF2H5CALCULATOR_H
 
 #include <pthread.h>
-#include <map>
-#include <deque>
 #include <string>
 
 #include <data_hl/BFRawFormat.h>
+#include <data_hl/BF_TaskPool.h>
 
 class BF2H5;
-//                 block                               subband       pointer to data
-typedef std::map<long int, std::deque<std::pair<uint8_t, BFRawFormat::Sample *> > > calculationMap;
 
-#define NUM_CALCULATION_THREADS 4
-#define NUM_OUTPUT_BUFFERS 2
+//! Number of blocks whose output can be held by the calculator at once
+#define NUM_OUTPUT_BUFFERS 4
 
 namespace DAL { // Namespace DAL -- begin
   
@@ -47,6 +44,16 @@ namespace DAL { // Namespace DAL -- begin
     \ingroup dal_apps
     
     \author Alwin de Jong
+
+    <h3>Synopsis</h3>
+
+    The subbands of every data block handed in through calculateDataBlock()
+    are processed as separate tasks by a DAL::BF_TaskPool, i.e. a configurable
+    number of threads sharing the work by stealing tasks from each other.
+
+    The output of a block goes into one of \c NUM_OUTPUT_BUFFERS buffers,
+    taken in turn; a buffer is reused only once the writer has taken over all
+    subbands of the block it held, which it signals through subbandWritten().
   */
   class Bf2h5Calculator
   {
@@ -57,24 +64,33 @@ namespace DAL { // Namespace DAL -- begin
     //! Argumented constructor
     Bf2h5Calculator (BF2H5 *parent,
 		     uint8_t nofSubbands,
-		     uint32_t nr_samples_subband);
+		     uint32_t nr_samples_subband,
+		     unsigned int nofThreads=0);
     
     // === Destruction ==========================================================
     
     //! Default destructor
     ~Bf2h5Calculator();
     
+    // === Parameter access =====================================================
+
+    //! Get the number of calculation threads
+    inline unsigned int nofThreads (void) const {
+      return itsPool->nofThreads();
+    }
+
     // === Methods ==============================================================
     
     //! Allocate memory
     void allocateMemory (void);
     
-    //! Calculate the numer of the data block
+    //! Queue a data block for processing; blocks while no output buffer is free
     void calculateDataBlock (long int blockNr,
 			     BFRawFormat::Sample *sampleData);
     
-    //! Signal that the subband has been written
-    void subbandWritten(/*unsigned int blockNr,*/ uint8_t subband);
+    //! Signal that the output of a subband has been taken over by the writer
+    void subbandWritten (long int blockNr,
+			 uint8_t subband);
     
     //! Enable the processing of datablock
     void startProcessing(void);
@@ -92,59 +108,36 @@ namespace DAL { // Namespace DAL -- begin
     void showStatus(void);
     
   private:
-    //		bool unscheduledDataLeft(void); // checks if there are still data blocks that need to be scheduled for processing
-    
-    //! Check if a complete block of subbands has been calculated
-    void checkIfBlockComplete (void);
-    
-    //! Each calculation thread uses one of these structs
-    struct thread_data
-    {
-      //! Is this thread currently being used?
-      bool busy;
-      //! Number of the block being processed
-      long int blockNr;
-      //! Number of the subband being processed by this thread
-      uint8_t subbandNr;
-      //! Pointer to the input data block
-      BFRawFormat::Sample *input_data;
-      float * subband_output_data; // pointer into output buffer where the calculated ata for this subband needs to be written
-      Bf2h5Calculator * This;
-    } thread_data_array[NUM_CALCULATION_THREADS];
-    
-    static void * startInternalThread(void * tData)
-    {
-      reinterpret_cast<thread_data *>(tData)->This->doDownSampleSingleSubband(tData);
-      return NULL;
-    }
     
-    void * doDownSampleSingleSubband(void *); // the actual thread that does the downsample calculation for a single subband
+    //! Task function of the pool: process a single subband of a block
+    static void processSubband (BF_TaskPool::Task const &task,
+				void *context);
+    
+    //! Compute the output components of a single subband
+    void computeSubband (BFRawFormat::Sample const *input,
+			 float *output);
     
   private:
     
-    unsigned level;
     //! Parent application BF2H5    
     BF2H5 * itsParent;
     unsigned short itsDownSampleFactor;
     uint8_t nrOfSubbands;
     uint32_t nrSamplesPerSubband;
-    //! Points to array of flags marking subbands that have been written
-    bool * subbandReady;
-    bool checking_completeness;
-    // the parallel threads for calculation
-    pthread_t itsCalculationThread[NUM_CALCULATION_THREADS]; // the calculation threads
-    // the tread_data_array contain input, settings and output data for that tread
-    bool itsStopProcessing;
-    //! Number of the currently processed block
-    long int currentBlockNr;
-    //! The size in float units of a single subband output data block
+    //! The number of output samples of a single subband output data block
     uint32_t itsSingleSubbandNrOutputSamples;
-    float ** dataBlockOutput; // the pointers to the output buffers for output data. Pointer to pointer to single subband output buffer
-    
-    // itsDatamap is protected by the calculationMapMutex and the pthread condition
-    calculationMap itsData; // first = blockNr; second.first = subbandNr; second.second = pointer to start sample of one subband datablock
-    pthread_mutex_t calculationMapMutex;
-    pthread_cond_t  condition;
+    //! The size in float units of a single subband output data block
+    uint32_t itsSingleSubbandNrOutputValues;
+    //! Output buffers, NUM_OUTPUT_BUFFERS blocks of nrOfSubbands subbands each
+    float ** dataBlockOutput;
+    //! Number of subbands still to be computed, per output buffer
+    volatile int itsNofUncomputed[NUM_OUTPUT_BUFFERS];
+    //! Number of subbands not yet taken over by the writer, per output buffer
+    volatile int itsNofUnwritten[NUM_OUTPUT_BUFFERS];
+    //! Signal notified whenever the writer has taken over a subband
+    TBB_FrameSignal itsWrittenSignal;
+    //! Pool of calculation threads
+    BF_TaskPool *itsPool;
   };
   
 } // Namespace DAL -- end
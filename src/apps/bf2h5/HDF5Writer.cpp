@@ -21,6 +21,7 @@
 #include "bf2h5.h"
 #include "HDF5Writer.h"
 #include <data_hl/BFRawFormat.h>
+#include <core/HDF5Datatype.h>
 
 using namespace DAL;
 using std::vector;
@@ -40,7 +41,9 @@ HDF5Writer::HDF5Writer (BF2H5 *parent,
 			uint8_t nr_subbands)
   : itsParent(parent),
     rawfile(0), 
-    table(0),
+    itsChunkWriter(0),
+    itsBlockBuffer(0),
+    itsWriteFailed(false),
     stopWriting(false),
     itsOutputFile(output_file), 
     waitForDataTimeOut(0),
@@ -58,11 +61,26 @@ HDF5Writer::HDF5Writer (BF2H5 *parent,
   }
   
   pthread_mutex_init(&writeMapMutex, NULL);
-  
-  zeroBlock = new float [outputBlockSize];
-  memset(zeroBlock, 0, outputBlockSize * sizeof(float));
+
+  itsChannelIntegration = parent->getChannelIntegration();
+  itsNofChannels        = (nrOfSubbands+itsChannelIntegration-1)/itsChannelIntegration;
+  itsNofComponents      = parent->nofComponents();
+  itsNofValues          = parent->nofValuesPerSample();
+
+  size_t bufferSize = itsNofComponents*outputBlockSize*itsNofChannels*itsNofValues;
+  itsBlockBuffer    = new float [bufferSize];
+  memset(itsBlockBuffer, 0, bufferSize * sizeof(float));
+
   // create output file
   createHDF5File(ps);
+
+  /* Blocks are compressed in parallel, provided they map onto single chunks */
+  if (!parent->getFilters().isEmpty() && !itsStokesDatasets.empty()) {
+    std::vector<hsize_t> chunk = itsStokesDatasets[0]->chunking();
+    if (chunk.size() == 2 && chunk[0] == outputBlockSize && chunk[1] == itsNofChannels) {
+      itsChunkWriter = new HDF5ChunkWriter (parent->getNofThreads());
+    }
+  }
 }
 #endif
 
@@ -75,12 +93,12 @@ HDF5Writer::HDF5Writer (BF2H5 *parent,
 HDF5Writer::~HDF5Writer()
 {
   pthread_mutex_destroy(&writeMapMutex);
-  delete [] zeroBlock;
+  delete [] itsBlockBuffer;
   delete [] subbandReady;
-  for (uint8_t i = 0; i < nrOfSubbands; ++i) {
-    delete table[i];
+  delete itsChunkWriter;
+  for (size_t i = 0; i < itsStokesDatasets.size(); ++i) {
+    delete itsStokesDatasets[i];
   }
-  delete table;
 }
 
 // ==============================================================================
@@ -255,6 +273,8 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
   
   int n_subbands[] = { header.nrSubbands };
   beamGroup->setAttribute( "NUMBER_OF_SUBBANDS", n_subbands );
+  int channel_integration[] = { static_cast<int>(itsChannelIntegration) };
+  beamGroup->setAttribute( "CHANNEL_INTEGRATION", channel_integration );
   
   // write the center frequencies of the subbands
   int * center_frequency = new int[header.nrSubbands];
@@ -266,38 +286,42 @@ void HDF5Writer::createHDF5File (const LOFAR::RTCP::Parset *ps)
       beamGroup->setAttribute( cfName, &center_frequency[idx] );
     }
   delete [] cfName;
+
+  // create the Stokes datasets of the beam, shaped [time,channel]
+  DAL::Stokes::Component components[4] = { DAL::Stokes::I,
+					    DAL::Stokes::Q,
+					    DAL::Stokes::U,
+					    DAL::Stokes::V };
+  hid_t datatype = H5Tcopy (H5T_NATIVE_FLOAT);
+  if (itsParent->outputMode() == BF2H5::Voltages) {
+    H5Tclose (datatype);
+    datatype      = HDF5Datatype::complexFloat();
+    components[0] = DAL::Stokes::X;
+    components[1] = DAL::Stokes::Y;
+  }
+  /* One chunk per output block, written as a whole by writeBlock() */
+  for (unsigned int idx=0; idx<itsNofComponents; idx++)
+    {
+      itsStokesDatasets.push_back (new BF_StokesDataset (beamGroup->getId(),
+							  idx,
+							  outputBlockSize,
+							  itsNofChannels,
+							  1,
+							  itsParent->getFilters(),
+							  HDF5ChunkPlanner (HDF5ChunkPlanner::Extent),
+							  components[idx],
+							  datatype));
+    }
+  H5Tclose (datatype);
   delete beamGroup;
   
 #ifdef DAL_DEBUGGING_MESSAGES
   std::cerr << "CREATED New beam group: " << string(beamstr) << std::endl;
   std::cerr << "   " << header.nrSubbands << " subbands" << std::endl;
+  std::cerr << "   " << itsNofComponents << " Stokes datasets of "
+	    << itsNofChannels << " channels" << std::endl;
 #endif
   
-  table = new dalTable * [ header.nrSubbands ];
-  char * sbName = new char[8];
-  
-  // nrSubbands is actually the number of subbands (see email from J.Romein)
-  for (unsigned int idx=0; idx<header.nrSubbands; idx++)
-    {
-      sprintf( sbName, "SB%03d", idx );
-      table[idx] = dataset.createTable( sbName, beamstr );
-    }
-  
-  for (unsigned int idx=0; idx<header.nrSubbands; idx++)
-    {
-      if ( itsParent->doDownSampling() || itsParent->doIntensity() )
-	{
-	  table[idx]->addColumn( "TOTAL_INTENSITY_SQUARED", dal_FLOAT );
-	}
-      else
-	{
-	  table[idx]->addColumn( "X", dal_COMPLEX_SHORT );
-	  table[idx]->addColumn( "Y", dal_COMPLEX_SHORT );
-	}
-    }
-  
-  delete [] sbName;
-  sbName = 0;
   delete [] center_frequency;
   center_frequency = 0;
   delete [] beamstr;
@@ -344,12 +368,24 @@ bool HDF5Writer::stop (void)
 #endif 
 
   stopWriting = true;
+  itsDataSignal.notify();
   status      = pthread_join (itsWriteThread, &thread_result);
 
-  if (status != 0 || thread_result != NULL) {
+  if (status != 0 || thread_result != NULL || itsWriteFailed) {
+    bResult = false;
+  }
+
+  /* Store the blocks still being compressed */
+  if (itsChunkWriter != NULL && !itsChunkWriter->flush()) {
     bResult = false;
   }
 
+  /* Record the final length of the time axis */
+  unsigned int nofSamples = currentBlockNr * outputBlockSize;
+  for (size_t i = 0; i < itsStokesDatasets.size(); ++i) {
+    itsStokesDatasets[i]->writeAttribute ("NOF_SAMPLES", nofSamples);
+  }
+
   return bResult;
 }
 
@@ -363,8 +399,15 @@ void HDF5Writer::writeSubband (long int blockNr,
 {
   std::pair<unsigned int, float *> dataPair(subband, calculator_data);
   pthread_mutex_lock (&writeMapMutex);
+  if (blockNr < currentBlockNr) {
+    // the block has been written without this subband, because it was late
+    pthread_mutex_unlock(&writeMapMutex);
+    itsParent->subbandWritten(blockNr, subband);
+    return;
+  }
   itsData[blockNr].push_back(dataPair);
   pthread_mutex_unlock(&writeMapMutex);
+  itsDataSignal.notify();
 }
 
 //_______________________________________________________________________________
@@ -429,18 +472,112 @@ void HDF5Writer::checkIfBlockComplete (void)
 
 void HDF5Writer::startNextBlock (void)
 {
+  writeBlock();
   cout << "block " << currentBlockNr << " is done." << endl;
   for (uint8_t i=0; i < nrOfSubbands; ++i) {
     subbandReady[i] = false;
   }
+  std::deque<std::pair<uint8_t, float *> > late;
+  long int blockNr = currentBlockNr;
   pthread_mutex_lock(&writeMapMutex);
-  itsData.erase(itsData.find(currentBlockNr++));
+  writeMap::iterator it = itsData.find(currentBlockNr++);
+  if (it != itsData.end()) {
+    late.swap(it->second);
+    itsData.erase(it);
+  }
   pthread_mutex_unlock(&writeMapMutex);
+  // hand back the buffers of subbands that arrived too late for the block
+  for (size_t i = 0; i < late.size(); ++i) {
+    itsParent->subbandWritten(blockNr, late[i].first);
+  }
   waitForDataTimeOut = 0;
   foundDataForCurrentBlock = false;
   return;
 }
 
+//_______________________________________________________________________________
+//                                                                     addSubband
+
+/*!
+  \param subband -- Number of the subband.
+  \param data    -- Output of the calculator for the subband, with the
+         components one after the other.
+*/
+void HDF5Writer::addSubband (uint8_t subband,
+			     float const *data)
+{
+  uint32_t channel = subband / itsChannelIntegration;
+  size_t rowSize   = itsNofChannels * itsNofValues;
+  float *buffer    = itsBlockBuffer + channel * itsNofValues;
+
+  for (uint32_t n = 0; n < itsNofComponents * outputBlockSize; ++n) {
+    for (uint32_t v = 0; v < itsNofValues; ++v) {
+      buffer[v] += data[v];
+    }
+    buffer += rowSize;
+    data   += itsNofValues;
+  }
+}
+
+//_______________________________________________________________________________
+//                                                                     writeBlock
+
+/*!
+  Each component of the block buffer is written as one hyperslab of shape
+  <tt>[outputBlockSize,nofChannels]</tt>, extending the dataset along the time
+  axis; the buffer is cleared afterwards. With a chunk writer the block is
+  copied and handed over as a chunk instead; if the chunk writer fails, the
+  block is written as a hyperslab. Failures are reported by stop().
+*/
+void HDF5Writer::writeBlock (void)
+{
+  size_t componentSize = outputBlockSize * itsNofChannels * itsNofValues;
+  std::vector<int> start (2, 0);
+  std::vector<int> block (2, 0);
+
+  start[0] = currentBlockNr * outputBlockSize;
+  block[0] = outputBlockSize;
+  block[1] = itsNofChannels;
+
+  for (uint32_t i = 0; i < itsNofComponents; ++i) {
+    float *component = itsBlockBuffer + i * componentSize;
+    bool status      = false;
+
+    if (itsChunkWriter != NULL) {
+      std::vector<hsize_t> offset (2, 0);
+      offset[0] = start[0];
+      status    = itsChunkWriter->write (itsStokesDatasets[i]->objectID(),
+					 component,
+					 offset);
+      if (!status) {
+	/* Chunks stored before may have failed as well, which is not recoverable */
+	std::cerr << "[HDF5Writer::writeBlock] Failed to write block "
+		  << currentBlockNr << " as chunk, writing hyperslab instead"
+		  << std::endl;
+	itsWriteFailed = true;
+      }
+    }
+
+    if (!status) {
+      if (itsNofValues == 2) {
+	status = itsStokesDatasets[i]->writeData (reinterpret_cast<std::complex<float> *>(component),
+						  start,
+						  block);
+      } else {
+	status = itsStokesDatasets[i]->writeData (component, start, block);
+      }
+    }
+
+    if (!status) {
+      std::cerr << "[HDF5Writer::writeBlock] Failed to write block "
+		<< currentBlockNr << " of component " << i << std::endl;
+      itsWriteFailed = true;
+    }
+  }
+
+  memset(itsBlockBuffer, 0, itsNofComponents * componentSize * sizeof(float));
+}
+
 //_______________________________________________________________________________
 //                                                                      writeData
 
@@ -450,30 +587,34 @@ void HDF5Writer::startNextBlock (void)
 void HDF5Writer::writeData (void)
 {
   while (!stopWriting) {
+    // take the sequence before looking for data, see DAL::TBB_FrameSignal
+    unsigned long sequence = itsDataSignal.sequence();
     if (getDataForCurrentBlock()) {
-      table[dataPair.first]->appendRows( dataPair.second, outputBlockSize );
+      addSubband(dataPair.first, dataPair.second);
+      itsParent->subbandWritten(currentBlockNr, dataPair.first);
       subbandReady[dataPair.first] = true;
       /*#ifdef DAL_DEBUGGING_MESSAGES
 	cout << "HDF5Writer:Wrote subband " << static_cast<int>(dataPair.first) << " for data block " << currentBlockNr << endl;
 	#endif*/
       checkIfBlockComplete();
       waitForDataTimeOut = 0;
-      usleep(50);
     }
-    else { // no data to write, check if subbands received within time limit and go to sleep for a little while
+    else if (itsDataSignal.wait(sequence, 0.01)) {
+      continue; // woken up by new data
+    }
+    else { // no data arrived within 10 ms, check if subbands received within time limit
       if (foundDataForCurrentBlock) { // we don't want to skip a block which the calculator hasn't yet started
 	if (++waitForDataTimeOut > 25) {
 	  cout << "HDF5Writer: block " << currentBlockNr << ", skipping subbands: ";
 	  for (uint8_t sb=0; sb < nrOfSubbands; ++sb) {
 	    if (subbandReady[sb] == false) {
-	      table[sb]->appendRows( zeroBlock, outputBlockSize );
+	      // the block buffer was cleared, so missing subbands are zero
 	      cout << static_cast<int>(sb) << ", ";
 	    }
 	  }
 	  startNextBlock();
 	}
       }
-      usleep(10000); // wait when the data of the new block hasn't arrived yet
     }
   }
 }
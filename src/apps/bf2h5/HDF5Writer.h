@@ -34,6 +34,9 @@
 #include <dal_config.h>
 #include <core/dalCommon.h>
 #include <core/dalDataset.h>
+#include <core/HDF5ChunkWriter.h>
+#include <data_hl/BF_StokesDataset.h>
+#include <data_hl/TBB_FrameRing.h>
 
 // LOFAR header files
 #ifdef DAL_WITH_LOFAR
@@ -59,8 +62,28 @@ class BF2H5;
   
   <ul type="square">
     <li>DAL::Bf2h5Calculator
+    <li>DAL::BF_StokesDataset
     <li>LOFAR::RTCP::Parset
   </ul>
+
+  <h3>Synopsis</h3>
+
+  The subbands handed in by the calculator are collected into a block buffer
+  per component, laid out as <tt>[time,channel]</tt> like the \c STOKES_{N}
+  datasets of the beam group; adjacent subbands are summed into one channel
+  if channel integration is enabled. Once all subbands of a block have arrived
+  (or the wait for the missing ones timed out, leaving them zero), each
+  component is written to its dataset as a single hyperslab.
+
+  The chunks of the Stokes datasets are of the shape of a block, so with
+  filters set (see BF2H5::setFilters()) every block is one chunk; these are
+  handed to a DAL::HDF5ChunkWriter, compressing the blocks of all components
+  in parallel while the next block is collected.
+
+  The writing thread sleeps on a DAL::TBB_FrameSignal, which writeSubband()
+  notifies, so it picks up new data as soon as it arrives instead of polling
+  for it. After copying a subband into the block buffer, the calculator gets
+  its output buffer back through BF2H5::subbandWritten().
   
 */
 class HDF5Writer {
@@ -106,6 +129,10 @@ public:
   //! Check if the currently processed block is complete
   void checkIfBlockComplete(void);
   void startNextBlock(void);
+  //! Add the data of a subband to the block buffer
+  void addSubband(uint8_t subband, float const *data);
+  //! Write the block buffer to the Stokes datasets
+  void writeBlock(void);
   //! Thread to perform the writing of the data
   void writeData(void);
   //! Start new internal thread
@@ -119,17 +146,33 @@ public:
 
   BF2H5 * itsParent;
   std::fstream * rawfile;
-  DAL::dalTable ** table;
   DAL::dalDataset dataset;
+  //! Stokes datasets, one per component
+  std::vector<DAL::BF_StokesDataset *> itsStokesDatasets;
+  //! Writer compressing the blocks in parallel (NULL if not used)
+  DAL::HDF5ChunkWriter * itsChunkWriter;
+  //! Buffer collecting the components of the current block
+  float * itsBlockBuffer;
+  //! Number of output channels
+  uint32_t itsNofChannels;
+  //! Number of adjacent subbands summed into one output channel
+  uint32_t itsChannelIntegration;
+  //! Number of components written, i.e. Stokes datasets
+  uint32_t itsNofComponents;
+  //! Number of floats per value of a component
+  uint32_t itsNofValues;
+  //! Set once a block could not be written completely
+  bool itsWriteFailed;
   bool stopWriting;
   std::string itsOutputFile;
   uint8_t waitForDataTimeOut;
   std::pair<uint8_t, float *> dataPair;
   writeMap itsData; // contains the block number, subbands and pointers to datablocks that still need to be written
   pthread_mutex_t writeMapMutex;
+  //! Signal notified by writeSubband() to wake up the writing thread
+  DAL::TBB_FrameSignal itsDataSignal;
   bool foundDataForCurrentBlock;
-  float * zeroBlock;
-  //! Size of a data block (excluded its header)
+  //! Number of output samples per subband in a data block
   size_t outputBlockSize;
   std::string creation_mode;
   long int nrOfBlocks, currentBlockNr;
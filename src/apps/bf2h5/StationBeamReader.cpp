@@ -255,6 +255,7 @@ namespace DAL { // Namespace DAL -- begin
     if (read_bytes > 0) {
       if (!bigendian) { convertEndian(&first_block_header); }
       if ((read_bytes = receiveBytes(reinterpret_cast<char *>(sample_data), dataBlockSize)) != -1) {
+	if (!bigendian) { convertEndian(sample_data); }
 	return true;
       }
       else if (read_bytes == 0) {
@@ -293,6 +294,7 @@ namespace DAL { // Namespace DAL -- begin
     if (read_bytes > 0) { // throw away block header
       //	if (!bigendian) { convertEndian(&blockheader); }
       if ((read_bytes = receiveBytes(reinterpret_cast<char *>(sample_data), dataBlockSize)) > 0) {
+	if (!bigendian) { convertEndian(sample_data); }
 	cout << "sampledata[0].xx=" << sample_data->xx << ", yy=" << sample_data->yy << endl;
 	return true;
       }
@@ -400,6 +402,15 @@ namespace DAL { // Namespace DAL -- begin
       }
   }
   
+  //_____________________________________________________________________________
+  //                                                                convertEndian
+
+  void StationBeamReader::convertEndian (BFRawFormat::Sample *sample_data)
+  {
+    // both polarizations are complex 16-bit integers, swap them in one go
+    swapbytes16 (sample_data, dataBlockSize/sizeof(int16_t));
+  }
+  
   //_____________________________________________________________________________
   //                                                        printHeaderParameters
 
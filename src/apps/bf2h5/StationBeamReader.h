@@ -105,6 +105,8 @@ namespace DAL { // Namespace DAL -- begin
     //! Swap the byte endians if not in bigendian
     void swapHeaderEndians(BFRawFormat::BFRaw_Header &header);
     void convertEndian(BFRawFormat::BlockHeader *pBlockHeader);
+    //! Swap the byte endians of a block of samples if not in bigendian
+    void convertEndian(BFRawFormat::Sample *sample_data);
     //! Close the socket or file and sets the finished_reading flag
     void finishReading(void);
     
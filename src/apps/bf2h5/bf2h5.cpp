@@ -37,13 +37,17 @@ using std::bad_alloc;
   \param outfile -- Name of the output HDF5 dataset.
   \param parset_filename -- Name of the parameter set file.
   \param downsample_factor -- Downsample factor.
-  \param do_intensity -- Compute intensities?
+  \param mode -- Data products written to the output file.
+  \param channel_integration -- Number of adjacent subbands summed into one
+         output channel.
 */
 BF2H5::BF2H5 (const std::string &outfile,
 	      const std::string &parset_filename,
 	      uint downsample_factor,
-	      bool do_intensity)
+	      OutputMode const &mode,
+	      uint channel_integration)
   : socketmode(false),
+    itsNofThreads(0),
     outputFile(outfile),
     itsCalculator(0),
     itsWriter(0),
@@ -52,17 +56,19 @@ BF2H5::BF2H5 (const std::string &outfile,
     itsReadBuffer(0),
     itsCurrentNrOfReadBuffers(INITIAL_NR_OF_READ_BUFFERS)
 {
-  itsParseFile        = parset_filename;
-  itsDownsampleFactor = downsample_factor;
-  itsDoIntensity      = do_intensity;
+  itsParseFile          = parset_filename;
+  itsDownsampleFactor   = downsample_factor > 0 ? downsample_factor : 1;
+  itsChannelIntegration = channel_integration > 0 ? channel_integration : 1;
+  itsOutputMode         = mode;
   
-  if (downsample_factor > 1) {
-    itsDoDownSample = true;
-    itsDoIntensity = true;
-  }
-  else {
-    itsDoDownSample = false;
+  /* Complex voltages are passed through without any integration */
+  if (itsOutputMode == Voltages) {
+    itsDownsampleFactor   = 1;
+    itsChannelIntegration = 1;
   }
+  itsDoDownSample = itsDownsampleFactor > 1;
+
+  pthread_mutex_init(&itsBufferMutex, NULL);
 
 #ifdef DAL_WITH_LOFAR
   // create parset
@@ -84,6 +90,7 @@ BF2H5::~BF2H5()
   for (sampleBuffers::iterator it = itsSampleBuffers.begin(); it != itsSampleBuffers.end(); ++it) {
     delete [] *it;
   }
+  pthread_mutex_destroy(&itsBufferMutex);
 
 #ifdef DAL_WITH_LOFAR
   delete itsParset;
@@ -167,12 +174,15 @@ bool BF2H5::allocateSampleBuffers(void)
 
 void BF2H5::blockComplete (long int blockNr)
 {
+  pthread_mutex_lock(&itsBufferMutex);
   for (bufferTracker::iterator it = itsBufferTracker.begin(); it != itsBufferTracker.end(); ++it) {
     if (it->second == blockNr) {
       it->second = -1;
+      pthread_mutex_unlock(&itsBufferMutex);
       return;
     }
   }
+  pthread_mutex_unlock(&itsBufferMutex);
   std::cerr << "[BF2H5::blockComplete] ERROR, trying to free a read buffer for block "
 	    << blockNr
 	    << " that doesn't have a read buffer!"
@@ -184,13 +194,16 @@ void BF2H5::blockComplete (long int blockNr)
 
 bool BF2H5::switchReadBuffer (long int block_nr)
 {
+  pthread_mutex_lock(&itsBufferMutex);
   for (bufferTracker::iterator it = itsBufferTracker.begin(); it != itsBufferTracker.end(); ++it) {
     if (it->second == -1) { // not in use
       it->second    = block_nr;
       itsReadBuffer = it->first;
+      pthread_mutex_unlock(&itsBufferMutex);
       return true;
     }
   }
+  pthread_mutex_unlock(&itsBufferMutex);
 
   // we didn't find a free read buffer, allocat a new buffer
   try {
@@ -204,7 +217,9 @@ bool BF2H5::switchReadBuffer (long int block_nr)
     cerr << "BF2H5::switchReadBuffer, ERROR cannot allocate memory for new input read buffer." << endl;
     return false;
   }
+  pthread_mutex_lock(&itsBufferMutex);
   itsBufferTracker.insert(std::pair<uint8_t, long int>(itsCurrentNrOfReadBuffers, block_nr));
+  pthread_mutex_unlock(&itsBufferMutex);
   itsReadBuffer = itsCurrentNrOfReadBuffers++; // switch to new buffer
 //	itsCalculator->showStatus();
 //	itsWriter->showStatus();
@@ -246,16 +261,17 @@ void BF2H5::start (bool const &verbose)
       }  // END : if (verbose)
       
       oneBlockdataSize = BFMainHeader.nrSamplesPerSubband * BFMainHeader.nrSubbands;
-      // size_t downSampledDataSize = BFMainHeader.nrSamplesPerSubband / itsDownsampleFactor;
 
       if (allocateSampleBuffers()) {
 
 	// Start the calculator
         itsCalculator = new DAL::Bf2h5Calculator (this,
 						  BFMainHeader.nrSubbands,
-						  getNrSamplesPerSubband());
+						  getNrSamplesPerSubband(),
+						  itsNofThreads);
 	// Start the writer
 #ifdef DAL_WITH_LOFAR
+	size_t downSampledDataSize = BFMainHeader.nrSamplesPerSubband / itsDownsampleFactor;
         itsWriter = new HDF5Writer (this,
 				    outputFile,
 				    itsParset,
@@ -24,6 +24,7 @@
 // Standard header files
 #include <string>
 #include <map>
+#include <pthread.h>
 
 #include <dal_config.h>
 
@@ -61,6 +62,26 @@ typedef std::map<uint8_t, long int> bufferTracker;
         needs to come from a parset file
   \todo LCSCommon needs to be integrated to use the parset reader
 
+  <h3>Synopsis</h3>
+
+  Depending on the output mode, the data written for each beam are
+
+  <ul>
+    <li>\e Intensity -- the total intensity, a single dataset \c STOKES_0;
+    <li>\e Stokes -- the coherent Stokes parameters \f$ (I,Q,U,V) \f$, written
+        to the datasets \c STOKES_0 to \c STOKES_3;
+    <li>\e Voltages -- the complex voltages \f$ (X,Y) \f$, written to
+        \c STOKES_0 and \c STOKES_1.
+  </ul>
+
+  The Stokes parameters can be integrated in time (downsample factor) and
+  over adjacent subbands (channel integration); the voltages are always passed
+  through at full resolution.
+
+  If filters are set (see setFilters()), the blocks written to the datasets are
+  compressed by a DAL::HDF5ChunkWriter, using as many threads as the
+  calculator.
+
   <h3>Prerequisite</h3>
   
   <ul type="square">
@@ -72,6 +93,16 @@ typedef std::map<uint8_t, long int> bufferTracker;
 class BF2H5 {
 
  public:
+
+  //! Data products written to the output file
+  enum OutputMode {
+    //! Total intensity, i.e. Stokes I
+    Intensity,
+    //! Coherent Stokes parameters (I,Q,U,V)
+    Stokes,
+    //! Complex voltages (X,Y)
+    Voltages
+  };
   
   // === Construction ===========================================================
 
@@ -79,7 +110,8 @@ class BF2H5 {
   BF2H5 (const std::string &outfile,
 	 const std::string &parset_filename,
 	 uint downsample_factor,
-	 bool do_intensity);
+	 OutputMode const &mode=Intensity,
+	 uint channel_integration=1);
 
   // === Destruction ============================================================
 
@@ -90,7 +122,26 @@ class BF2H5 {
 
   //! Is computation of the intensity enabled?
   inline bool doIntensity (void) const {
-    return itsDoIntensity;
+    return itsOutputMode==Intensity;
+  }
+  //! Get the data products written to the output file
+  inline OutputMode outputMode (void) const {
+    return itsOutputMode;
+  }
+  //! Get the number of datasets written per beam, i.e. Stokes components
+  inline uint nofComponents (void) const {
+    switch (itsOutputMode) {
+    case Stokes:
+      return 4;
+    case Voltages:
+      return 2;
+    default:
+      return 1;
+    }
+  }
+  //! Get the number of floats per value of a component (2 for complex voltages)
+  inline uint nofValuesPerSample (void) const {
+    return itsOutputMode==Voltages ? 2 : 1;
   }
   //! Is downsampling of the data enabled?
   inline bool doDownSampling (void) const {
@@ -100,6 +151,26 @@ class BF2H5 {
   inline uint getDownSampleFactor (void) const {
     return itsDownsampleFactor;
   }
+  //! Get the number of adjacent subbands summed into one output channel
+  inline uint getChannelIntegration (void) const {
+    return itsChannelIntegration;
+  }
+  //! Get the number of calculation threads (0 = one per processor)
+  inline uint getNofThreads (void) const {
+    return itsNofThreads;
+  }
+  //! Set the number of calculation threads (0 = one per processor)
+  inline void setNofThreads (uint nofThreads) {
+    itsNofThreads = nofThreads;
+  }
+  //! Get the filters applied to the chunks of the Stokes datasets
+  inline DAL::HDF5FilterPipeline const &getFilters (void) const {
+    return itsFilters;
+  }
+  //! Set the filters applied to the chunks of the Stokes datasets
+  inline void setFilters (DAL::HDF5FilterPipeline const &filters) {
+    itsFilters = filters;
+  }
   //! Set input mode to read from socket
   void setSocketMode(uint port);
   //! Set input mode to read from file
@@ -137,6 +208,13 @@ class BF2H5 {
     itsWriter->writeSubband(blockNr, subband, calculator_data);
   };
 
+  //! Called by the writer once it has taken over the output of a subband
+  inline void subbandWritten (long int blockNr,
+			      uint8_t subband)
+  {
+    itsCalculator->subbandWritten(blockNr, subband);
+  }
+
   //! Called by the calculator when a block of subbands was completed
   void blockComplete(long int blockNr);
 
@@ -158,12 +236,18 @@ class BF2H5 {
   
   //! Input mode: socket (true) or file (false)
   bool socketmode;
-  //! Compute intensities?
-  bool itsDoIntensity;
+  //! Data products written to the output file
+  OutputMode itsOutputMode;
   //! Downsample the data?
   bool itsDoDownSample;
   //! Downsampling factor
   uint itsDownsampleFactor;
+  //! Number of adjacent subbands summed into one output channel
+  uint itsChannelIntegration;
+  //! Number of calculation threads (0 = one per processor)
+  uint itsNofThreads;
+  //! Filters applied to the chunks of the Stokes datasets
+  DAL::HDF5FilterPipeline itsFilters;
   
   // some main header parameters we need to know here
   std::string itsParseFile;
@@ -183,6 +267,7 @@ class BF2H5 {
   //sample buffers things
   uint8_t itsReadBuffer, itsCurrentNrOfReadBuffers; // the current read buffer
   bufferTracker itsBufferTracker; // keeps track of which buffer is used for which data block
+  pthread_mutex_t itsBufferMutex; // protects itsBufferTracker, as blocks complete in the calculation threads
   sampleBuffers itsSampleBuffers; // pointers to input data samplebuffers
   
   std::string EpochUTC;
@@ -56,6 +56,9 @@ void print_examples (std::ostream &os)
   os << "2) Read data from TCP stream to a HDF5 file:" << endl;
   os << "  bf2h5 --port <port number> --outfile <HDF5 output>" << endl;
   os << endl;
+  os << "3) Write Stokes (I,Q,U,V), integrating over 16 samples and 4 subbands:" << endl;
+  os << "  bf2h5 --infile <raw data> --outfile <HDF5 output> --stokes -D 16 -C 4" << endl;
+  os << endl;
 }
 
 //_______________________________________________________________________________
@@ -72,8 +75,14 @@ int main (int argc, char *argv[])
   bool socketmode       = false;
   bool non_interactive  = false;
   bool doIntensity      = false;
+  bool doStokes         = false;
+  bool doVoltages       = false;
   bool doDownsample     = false;
   uint dsFactor         = 1;
+  uint channelFactor    = 1;
+  uint nofThreads       = 0;
+  std::string compression ("none");
+  BF2H5::OutputMode outputMode = BF2H5::Voltages;
   //	bool doChannelization = false;
   
   // Processing of command line options ____________________
@@ -84,12 +93,17 @@ int main (int argc, char *argv[])
     ("help,H", "Show help messages")
     ("parsetfile,F", bpo::value<std::string>(), "Use parset file for all settings and to get information about input data")
     ("downsample,D", bpo::value<uint>(), "Downsample with this factor")
+    ("channels,C", bpo::value<uint>(), "Number of adjacent subbands integrated into one channel")
+    ("threads,T", bpo::value<uint>(), "Number of calculation threads (default: one per processor)")
+    ("compression", bpo::value<std::string>(), "Compression of the Stokes datasets: none (default) or deflate; compressed on as many threads as calculation threads")
     ("infile,I", bpo::value<std::string>(), "Name of the input file")
     ("outfile,O",bpo::value<std::string>(), "Name of the output dataset")
     //			("source,S", bpo::value<std::string>(), "the source IP address from which to accept the data")
     ("port,P", bpo::value<uint>(), "Port number to accept beam formed raw data from")
     //("downsample", "Downsampling of the original data")
     ("intensity", "Compute total intensity")
+    ("stokes", "Compute the coherent Stokes parameters I, Q, U and V")
+    ("voltages", "Write the complex voltages X and Y (no integration)")
     ("noninteractive", "non-interactive mode, automatically overwrites output file if it exists")
     ;
   
@@ -146,9 +160,48 @@ int main (int argc, char *argv[])
       doDownsample = true;
     }
   }
+  if (vm.count("channels")) {
+    channelFactor = vm["channels"].as<uint>();
+    if (channelFactor < 1) {
+      channelFactor = 1;
+    }
+  }
+  if (vm.count("threads")) {
+    nofThreads = vm["threads"].as<uint>();
+  }
+  if (vm.count("compression")) {
+    compression = vm["compression"].as<std::string>();
+    if (compression != "none" && compression != "deflate") {
+      std::cerr << "[bf2h5] Unknown compression " << compression << endl;
+      return 1;
+    }
+  }
+  if (vm.count("stokes")) {
+    doStokes = true;
+  }
+  if (vm.count("voltages")) {
+    doVoltages = true;
+  }
   if (vm.count("noninteractive")) {
     non_interactive = true; 
   }
+
+  /* Select the output mode; integration requires Stokes parameters */
+  if (doVoltages) {
+    if (doStokes || doIntensity || dsFactor > 1 || channelFactor > 1) {
+      std::cerr << "[bf2h5] Complex voltages can be neither integrated nor"
+		<< " combined with other output modes!" << endl;
+      return 1;
+    }
+    outputMode = BF2H5::Voltages;
+  }
+  else if (doStokes) {
+    outputMode = BF2H5::Stokes;
+  }
+  else if (doIntensity || channelFactor > 1) {
+    doIntensity = true;
+    outputMode  = BF2H5::Intensity;
+  }
   
   // Check completeness of command line options ____________
   
@@ -194,8 +247,12 @@ int main (int argc, char *argv[])
       std::cout << "-- Output file ........... : " << outfile << endl;
     }
   std::cout << "-- Compute total intensity : " << doIntensity  << endl;
+  std::cout << "-- Compute Stokes (IQUV) . : " << doStokes     << endl;
   std::cout << "-- Downsampling of data .. : " << doDownsample << endl;
   std::cout << "-- Downsampling factor ... : " << dsFactor       << endl;
+  std::cout << "-- Channel integration ... : " << channelFactor  << endl;
+  std::cout << "-- Calculation threads ... : " << nofThreads     << endl;
+  std::cout << "-- Compression ........... : " << compression    << endl;
   
   // Processing of input data ______________________________
   
@@ -230,7 +287,11 @@ int main (int argc, char *argv[])
       }
     }
   }
-  BF2H5 bf2h5(outfile, parsetFilename, dsFactor, doIntensity);
+  BF2H5 bf2h5(outfile, parsetFilename, dsFactor, outputMode, channelFactor);
+  bf2h5.setNofThreads(nofThreads);
+  if (compression == "deflate") {
+    bf2h5.setFilters(DAL::HDF5FilterPipeline(DAL::HDF5FilterPipeline::Deflate, 1));
+  }
   
   if (socketmode) {
     bf2h5.setSocketMode(port);
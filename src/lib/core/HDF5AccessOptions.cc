@@ -0,0 +1,440 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5AccessOptions.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                            HDF5AccessOptions
+
+  HDF5AccessOptions::HDF5AccessOptions ()
+  {
+    init ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                            HDF5AccessOptions
+
+  /*!
+    \param other -- Another HDF5AccessOptions object from which to create this
+           new one.
+  */
+  HDF5AccessOptions::HDF5AccessOptions (HDF5AccessOptions const &other)
+  {
+    copy (other);
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  HDF5AccessOptions::~HDF5AccessOptions ()
+  {;}
+
+  // ============================================================================
+  //
+  //  Operators
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                    operator=
+
+  /*!
+    \param other -- Another HDF5AccessOptions object from which to make a copy.
+  */
+  HDF5AccessOptions& HDF5AccessOptions::operator= (HDF5AccessOptions const &other)
+  {
+    if (this != &other) {
+      copy (other);
+    }
+    return *this;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         copy
+
+  void HDF5AccessOptions::copy (HDF5AccessOptions const &other)
+  {
+    itsChunkCacheBytes   = other.itsChunkCacheBytes;
+    itsChunkCacheSlots   = other.itsChunkCacheSlots;
+    itsChunkCacheW0      = other.itsChunkCacheW0;
+    itsMetadataCacheSize = other.itsMetadataCacheSize;
+    itsAlignThreshold    = other.itsAlignThreshold;
+    itsAlignment         = other.itsAlignment;
+    itsSieveBufferSize   = other.itsSieveBufferSize;
+    itsPageBufferSize    = other.itsPageBufferSize;
+    itsPageSize          = other.itsPageSize;
+    itsLatestFormat      = other.itsLatestFormat;
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                setChunkCache
+
+  /*!
+    \param nofBytes -- Size of the chunk cache, [Bytes]; 0 resets the library
+           default.
+    \param nofSlots -- Number of hash slots in the chunk cache; if 0, the number
+           of slots is scaled from the library default (521 slots per MB).
+    \param w0       -- Preemption policy, \f$ 0 \leq w_0 \leq 1 \f$; 1 evicts
+           fully read/written chunks first, which suits a single pass through
+           the data.
+    \return status  -- Returns \e false if the preemption policy is out of range.
+  */
+  bool HDF5AccessOptions::setChunkCache (size_t const &nofBytes,
+					 size_t const &nofSlots,
+					 double const &w0)
+  {
+    if (w0 < 0.0 || w0 > 1.0) {
+      std::cerr << "[HDF5AccessOptions::setChunkCache] Preemption policy "
+		<< w0 << " outside range [0,1]!" << std::endl;
+      return false;
+    }
+
+    if (nofBytes == 0) {
+      itsChunkCacheBytes = 0;
+      itsChunkCacheSlots = 0;
+      itsChunkCacheW0    = 0.75;
+    } else {
+      itsChunkCacheBytes = nofBytes;
+      /* 100 slots per chunk of 100 MB/521 are 521 slots per MB */
+      itsChunkCacheSlots = nofSlots > 0 ? nofSlots : nofChunkSlots (nofBytes, 100*1024*1024/521);
+      itsChunkCacheW0    = w0;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 setAlignment
+
+  /*!
+    \param threshold -- Objects of at least this size are aligned, [Bytes].
+    \param alignment -- Objects are aligned to a multiple of this size, [Bytes];
+           1 disables the alignment.
+    \return status   -- Returns \e false if the alignment is zero.
+  */
+  bool HDF5AccessOptions::setAlignment (hsize_t const &threshold,
+					hsize_t const &alignment)
+  {
+    if (alignment == 0) {
+      std::cerr << "[HDF5AccessOptions::setAlignment] Alignment must be positive!"
+		<< std::endl;
+      return false;
+    }
+
+    itsAlignThreshold = threshold;
+    itsAlignment      = alignment;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                             setPageBuffering
+
+  /*!
+    \param bufferSize -- Size of the page buffer, [Bytes]; 0 disables page
+           buffering.
+    \param pageSize   -- Size of a file space page, [Bytes]; only used when
+           creating a new file.
+    \return status    -- Returns \e false if the HDF5 library does not support
+            page buffering, or if the buffer cannot hold a single page.
+  */
+  bool HDF5AccessOptions::setPageBuffering (size_t const &bufferSize,
+					    hsize_t const &pageSize)
+  {
+    if (bufferSize == 0) {
+      itsPageBufferSize = 0;
+      return true;
+    }
+
+#ifdef DAL_HDF5_PAGE_BUFFERING
+    if (pageSize < 512 || bufferSize < pageSize) {
+      std::cerr << "[HDF5AccessOptions::setPageBuffering] Invalid buffer size "
+		<< bufferSize << " for pages of size " << pageSize
+		<< std::endl;
+      return false;
+    }
+
+    itsPageBufferSize = bufferSize;
+    itsPageSize       = pageSize;
+
+    return true;
+#else
+    std::cerr << "[HDF5AccessOptions::setPageBuffering]"
+	      << " Page buffering requires HDF5 1.10.1 or later!" << std::endl;
+    return false;
+#endif
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    isDefault
+
+  bool HDF5AccessOptions::isDefault () const
+  {
+    return (itsChunkCacheBytes == 0
+	    && itsMetadataCacheSize == 0
+	    && itsAlignment <= 1
+	    && itsSieveBufferSize == 0
+	    && itsPageBufferSize == 0
+	    && !itsLatestFormat);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void HDF5AccessOptions::summary (std::ostream &os)
+  {
+    os << "[HDF5AccessOptions] Summary of internal parameters." << std::endl;
+    os << "-- Chunk cache size [Bytes]     = " << itsChunkCacheBytes   << std::endl;
+    os << "-- Chunk cache hash slots       = " << itsChunkCacheSlots   << std::endl;
+    os << "-- Chunk cache preemption (w0)  = " << itsChunkCacheW0      << std::endl;
+    os << "-- Metadata cache size [Bytes]  = " << itsMetadataCacheSize << std::endl;
+    os << "-- Alignment threshold [Bytes]  = " << itsAlignThreshold    << std::endl;
+    os << "-- Alignment [Bytes]            = " << itsAlignment         << std::endl;
+    os << "-- Sieve buffer size [Bytes]    = " << itsSieveBufferSize   << std::endl;
+    os << "-- Page buffer size [Bytes]     = " << itsPageBufferSize    << std::endl;
+    os << "-- File space page size [Bytes] = " << itsPageSize          << std::endl;
+    os << "-- Latest file format           = " << itsLatestFormat      << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                               fileAccessList
+
+  /*!
+    \param pageBuffering -- Include the page buffer settings? Opening a file
+           which has not been created with paged file space management fails
+           if page buffering is requested.
+    \return plist -- File-access property list; \c H5P_DEFAULT if no parameter
+            differs from the library defaults.
+  */
+  hid_t HDF5AccessOptions::fileAccessList (bool const &pageBuffering) const
+  {
+    if (isDefault()) {
+      return H5P_DEFAULT;
+    }
+
+    hid_t plist = H5Pcreate (H5P_FILE_ACCESS);
+
+    /* Default chunk cache for all datasets in the file */
+    if (itsChunkCacheBytes > 0) {
+      H5Pset_cache (plist,
+		    0,
+		    itsChunkCacheSlots,
+		    itsChunkCacheBytes,
+		    itsChunkCacheW0);
+    }
+
+    /* Metadata cache */
+    if (itsMetadataCacheSize > 0) {
+      H5AC_cache_config_t config;
+      config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+      if (H5Pget_mdc_config (plist, &config) >= 0) {
+	config.set_initial_size = 1;
+	config.initial_size     = itsMetadataCacheSize;
+	if (config.max_size < itsMetadataCacheSize) {
+	  config.max_size = itsMetadataCacheSize;
+	}
+	if (config.min_size > itsMetadataCacheSize) {
+	  config.min_size = itsMetadataCacheSize;
+	}
+	H5Pset_mdc_config (plist, &config);
+      }
+    }
+
+    /* Alignment */
+    if (itsAlignment > 1) {
+      H5Pset_alignment (plist, itsAlignThreshold, itsAlignment);
+    }
+
+    /* Sieve buffer */
+    if (itsSieveBufferSize > 0) {
+      H5Pset_sieve_buf_size (plist, itsSieveBufferSize);
+    }
+
+    /* Page buffering */
+#ifdef DAL_HDF5_PAGE_BUFFERING
+    if (pageBuffering && itsPageBufferSize > 0) {
+      H5Pset_page_buffer_size (plist, itsPageBufferSize, 0, 0);
+    }
+#else
+    (void)pageBuffering;
+#endif
+
+    /* Version bounds of the file format */
+    if (itsLatestFormat) {
+      H5Pset_libver_bounds (plist, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+    }
+
+    return plist;
+  }
+
+  //_____________________________________________________________________________
+  //                                                             fileCreationList
+
+  /*!
+    \return plist -- File-creation property list; \c H5P_DEFAULT unless page
+            buffering has been requested.
+  */
+  hid_t HDF5AccessOptions::fileCreationList () const
+  {
+#ifdef DAL_HDF5_PAGE_BUFFERING
+    if (itsPageBufferSize > 0) {
+      hid_t plist = H5Pcreate (H5P_FILE_CREATE);
+      H5Pset_file_space_strategy (plist, H5F_FSPACE_STRATEGY_PAGE, 0, 1);
+      H5Pset_file_space_page_size (plist, itsPageSize);
+      return plist;
+    }
+#endif
+
+    return H5P_DEFAULT;
+  }
+
+  //_____________________________________________________________________________
+  //                                                            datasetAccessList
+
+  /*!
+    \return plist -- Dataset-access property list; \c H5P_DEFAULT unless the
+            chunk cache has been configured.
+  */
+  hid_t HDF5AccessOptions::datasetAccessList () const
+  {
+    if (itsChunkCacheBytes == 0) {
+      return H5P_DEFAULT;
+    }
+
+    hid_t plist = H5Pcreate (H5P_DATASET_ACCESS);
+
+    H5Pset_chunk_cache (plist,
+			itsChunkCacheSlots,
+			itsChunkCacheBytes,
+			itsChunkCacheW0);
+
+    return plist;
+  }
+
+  // ============================================================================
+  //
+  //  Static methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                      release
+
+  /*!
+    \retval plist -- Property list to be released; reset to \c H5P_DEFAULT
+            afterwards.
+  */
+  void HDF5AccessOptions::release (hid_t &plist)
+  {
+    if (plist != H5P_DEFAULT && H5Iis_valid(plist) > 0) {
+      H5Pclose (plist);
+    }
+    plist = H5P_DEFAULT;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                nofChunkSlots
+
+  /*!
+    Following the advice of the HDF Group the number of hash slots should be a
+    prime number of about 100 times the number of chunks fitting into the
+    cache, keeping hash collisions -- upon which a chunk is evicted, even though
+    there would be space left in the cache -- rare.
+
+    \param cacheBytes -- Size of the chunk cache, [Bytes].
+    \param chunkBytes -- Size of a single chunk, [Bytes].
+    \return nofSlots  -- Number of hash slots; never less than the library
+            default of 521.
+  */
+  size_t HDF5AccessOptions::nofChunkSlots (size_t const &cacheBytes,
+					   size_t const &chunkBytes)
+  {
+    size_t nofSlots = 521;
+
+    if (chunkBytes > 0 && 100*(cacheBytes/chunkBytes) > nofSlots) {
+      nofSlots = 100*(cacheBytes/chunkBytes);
+    }
+
+    /* Move on to the next prime number */
+    while (true) {
+      bool isPrime = true;
+      for (size_t n=2; n*n<=nofSlots; ++n) {
+	if (nofSlots%n == 0) {
+	  isPrime = false;
+	  break;
+	}
+      }
+      if (isPrime) {
+	return nofSlots;
+      }
+      ++nofSlots;
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Private methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                         init
+
+  void HDF5AccessOptions::init ()
+  {
+    itsChunkCacheBytes   = 0;
+    itsChunkCacheSlots   = 0;
+    itsChunkCacheW0      = 0.75;
+    itsMetadataCacheSize = 0;
+    itsAlignThreshold    = 0;
+    itsAlignment         = 1;
+    itsSieveBufferSize   = 0;
+    itsPageBufferSize    = 0;
+    itsPageSize          = 4096;
+    itsLatestFormat      = false;
+  }
+
+} // Namespace DAL -- end
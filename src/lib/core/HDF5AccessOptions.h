@@ -0,0 +1,305 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef HDF5ACCESSOPTIONS_H
+#define HDF5ACCESSOPTIONS_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+
+// DAL header files
+#include <dal_config.h>
+
+/* Page buffering and paged file space management are available as of
+   HDF5 1.10.1 */
+#if (H5_VERS_MAJOR > 1) || \
+  (H5_VERS_MAJOR == 1 && H5_VERS_MINOR > 10) || \
+  (H5_VERS_MAJOR == 1 && H5_VERS_MINOR == 10 && H5_VERS_RELEASE >= 1)
+#define DAL_HDF5_PAGE_BUFFERING
+#endif
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class HDF5AccessOptions
+
+    \ingroup DAL
+    \ingroup core
+
+    \brief Tuning parameters for the access to HDF5 files and datasets
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tHDF5AccessOptions.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::IO_Mode
+      <li>DAL::HDF5Object
+      <li>DAL::HDF5Dataset
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    While DAL::IO_Mode decides \e whether a file or dataset is opened or
+    created, this class collects the parameters deciding \e how the data are
+    accessed afterwards -- i.e. the contents of the file-access, file-creation
+    and dataset-access property lists handed to the HDF5 library:
+
+    <ul>
+      <li>\b Chunk cache -- Every chunked dataset has a cache holding the most
+      recently used chunks; by default it is only 1 MB in size with 521 hash
+      slots, which is thrashed as soon as a strided selection (e.g. reading a
+      single channel from a dynamic spectrum) touches more chunks than fit
+      into it.
+      \code
+      herr_t H5Pset_chunk_cache (hid_t dapl_id, size_t rdcc_nslots, size_t rdcc_nbytes, double rdcc_w0)
+      herr_t H5Pset_cache (hid_t fapl_id, int mdc_nelmts, size_t rdcc_nslots, size_t rdcc_nbytes, double rdcc_w0)
+      \endcode
+      As part of the file-access property list the setting becomes the
+      default for all datasets within the file; as part of the dataset-access
+      property list it only applies to a single dataset. For the number of
+      hash slots a prime number about 100 times the number of chunks fitting
+      into the cache is advised, see nofChunkSlots().
+      <li>\b Metadata cache -- initial size of the cache for object headers,
+      B-trees and heaps.
+      <li>\b Alignment -- objects larger than a threshold are aligned to a
+      multiple of the given size, e.g. to match the stripe size of a parallel
+      file system.
+      <li>\b Sieve buffer -- size of the buffer used to combine small reads
+      from contiguous datasets.
+      <li>\b Page buffering -- (HDF5 1.10.1 and later) the file is organized
+      in pages of fixed size, which are cached as a whole; this requires the
+      file to have been created with paged file space management.
+      <li>\b Latest format -- use the most recent version of the file format,
+      providing e.g. faster links in large groups and the extensible array
+      chunk indices.
+    </ul>
+
+    Parameters which have not been set keep the library defaults; an
+    object without any settings therefore results in \c H5P_DEFAULT being
+    used, just as before.
+
+    Property lists returned by fileAccessList(), fileCreationList() and
+    datasetAccessList() are owned by the caller and should be handed back
+    through release().
+
+    <h3>Example(s)</h3>
+
+    <ol>
+      <li>Read from a TBB file with a 64 MB chunk cache per dataset:
+      \code
+      DAL::HDF5AccessOptions options;
+      options.setChunkCache (64*1024*1024);
+
+      DAL::TBB_Timeseries tbb (filename, options, DAL::IO_Mode(DAL::IO_Mode::ReadOnly));
+      \endcode
+
+      <li>Size the chunk cache of an already opened dataset for reading
+      along its second axis:
+      \code
+      DAL::HDF5Dataset dataset (fileID, "Stokes");
+
+      dataset.setChunkCache (dataset.shape()[1]*chunkBytes);
+      \endcode
+    </ol>
+
+  */
+  class HDF5AccessOptions {
+
+    //! Size of the chunk cache, [Bytes]
+    size_t itsChunkCacheBytes;
+    //! Number of hash slots in the chunk cache
+    size_t itsChunkCacheSlots;
+    //! Preemption policy of the chunk cache
+    double itsChunkCacheW0;
+    //! Initial size of the metadata cache, [Bytes]
+    size_t itsMetadataCacheSize;
+    //! Threshold above which objects are aligned, [Bytes]
+    hsize_t itsAlignThreshold;
+    //! Alignment of the objects, [Bytes]
+    hsize_t itsAlignment;
+    //! Size of the data sieve buffer, [Bytes]
+    size_t itsSieveBufferSize;
+    //! Size of the page buffer, [Bytes]
+    size_t itsPageBufferSize;
+    //! Size of a file space page, [Bytes]
+    hsize_t itsPageSize;
+    //! Use the latest version of the file format?
+    bool itsLatestFormat;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor
+    HDF5AccessOptions ();
+
+    //! Copy constructor
+    HDF5AccessOptions (HDF5AccessOptions const &other);
+
+    // === Destruction ==========================================================
+
+    //! Destructor
+    ~HDF5AccessOptions ();
+
+    // === Operators ============================================================
+
+    //! Overloading of the copy operator
+    HDF5AccessOptions& operator= (HDF5AccessOptions const &other);
+
+    // === Parameter access =====================================================
+
+    //! Get the size of the chunk cache; 0 if the library default is used
+    inline size_t chunkCacheBytes () const {
+      return itsChunkCacheBytes;
+    }
+
+    //! Get the number of hash slots in the chunk cache
+    inline size_t chunkCacheSlots () const {
+      return itsChunkCacheSlots;
+    }
+
+    //! Get the preemption policy of the chunk cache
+    inline double chunkCacheW0 () const {
+      return itsChunkCacheW0;
+    }
+
+    //! Set the parameters of the chunk cache
+    bool setChunkCache (size_t const &nofBytes,
+			size_t const &nofSlots=0,
+			double const &w0=0.75);
+
+    //! Get the initial size of the metadata cache; 0 if the library default is used
+    inline size_t metadataCacheSize () const {
+      return itsMetadataCacheSize;
+    }
+
+    //! Set the initial size of the metadata cache
+    inline void setMetadataCacheSize (size_t const &nofBytes) {
+      itsMetadataCacheSize = nofBytes;
+    }
+
+    //! Get the threshold above which objects are aligned
+    inline hsize_t alignThreshold () const {
+      return itsAlignThreshold;
+    }
+
+    //! Get the alignment of objects in the file; 1 if no alignment is done
+    inline hsize_t alignment () const {
+      return itsAlignment;
+    }
+
+    //! Set the alignment of objects in the file
+    bool setAlignment (hsize_t const &threshold,
+		       hsize_t const &alignment);
+
+    //! Get the size of the data sieve buffer; 0 if the library default is used
+    inline size_t sieveBufferSize () const {
+      return itsSieveBufferSize;
+    }
+
+    //! Set the size of the data sieve buffer
+    inline void setSieveBufferSize (size_t const &nofBytes) {
+      itsSieveBufferSize = nofBytes;
+    }
+
+    //! Get the size of the page buffer; 0 if page buffering is not used
+    inline size_t pageBufferSize () const {
+      return itsPageBufferSize;
+    }
+
+    //! Get the size of a file space page
+    inline hsize_t pageSize () const {
+      return itsPageSize;
+    }
+
+    //! Enable page buffering
+    bool setPageBuffering (size_t const &bufferSize,
+			   hsize_t const &pageSize=4096);
+
+    //! Use the latest version of the file format?
+    inline bool latestFormat () const {
+      return itsLatestFormat;
+    }
+
+    //! Enable/disable the use of the latest version of the file format
+    inline void setLatestFormat (bool const &latestFormat) {
+      itsLatestFormat = latestFormat;
+    }
+
+    //! Are all parameters at the library defaults?
+    bool isDefault () const;
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, HDF5AccessOptions.
+    */
+    inline std::string className () const {
+      return "HDF5AccessOptions";
+    }
+
+    // === Methods ==============================================================
+
+    //! Create the file-access property list
+    hid_t fileAccessList (bool const &pageBuffering=true) const;
+
+    //! Create the file-creation property list
+    hid_t fileCreationList () const;
+
+    //! Create the dataset-access property list
+    hid_t datasetAccessList () const;
+
+    // === Static methods =======================================================
+
+    //! Release a property list obtained from one of the methods above
+    static void release (hid_t &plist);
+
+    //! Get the advised number of hash slots for a chunk cache
+    static size_t nofChunkSlots (size_t const &cacheBytes,
+				 size_t const &chunkBytes);
+
+  private:
+
+    //! Initialize the object's internal parameters
+    void init ();
+
+    //! Unconditional copying
+    void copy (HDF5AccessOptions const &other);
+
+  }; // Class HDF5AccessOptions -- end
+
+} // Namespace DAL -- end
+
+#endif /* HDF5ACCESSOPTIONS_H */
+
@@ -0,0 +1,813 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5AttributeCache.h>
+
+#include <cstring>
+
+namespace DAL { // Namespace DAL -- begin
+
+  //_____________________________________________________________________________
+  //                                                                   memoryType
+
+  /// @cond TEMPLATE_SPECIALIZATIONS
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<char> ()
+  {
+    return H5T_NATIVE_CHAR;
+  }
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<unsigned char> ()
+  {
+    return H5T_NATIVE_UCHAR;
+  }
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<short> ()
+  {
+    return H5T_NATIVE_SHORT;
+  }
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<unsigned short> ()
+  {
+    return H5T_NATIVE_USHORT;
+  }
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<int> ()
+  {
+    return H5T_NATIVE_INT;
+  }
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<unsigned int> ()
+  {
+    return H5T_NATIVE_UINT;
+  }
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<long> ()
+  {
+    return H5T_NATIVE_LONG;
+  }
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<unsigned long> ()
+  {
+    return H5T_NATIVE_ULONG;
+  }
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<long long> ()
+  {
+    return H5T_NATIVE_LLONG;
+  }
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<unsigned long long> ()
+  {
+    return H5T_NATIVE_ULLONG;
+  }
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<float> ()
+  {
+    return H5T_NATIVE_FLOAT;
+  }
+
+  template <>
+  hid_t HDF5AttributeCache::memoryType<double> ()
+  {
+    return H5T_NATIVE_DOUBLE;
+  }
+
+  /// @endcond
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                           HDF5AttributeCache
+
+  HDF5AttributeCache::HDF5AttributeCache ()
+  {
+    init ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                           HDF5AttributeCache
+
+  /*!
+    \param location -- Identifier of the object, the attributes of which are
+           read into the cache.
+  */
+  HDF5AttributeCache::HDF5AttributeCache (hid_t const &location)
+  {
+    init ();
+    load (location);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         init
+
+  void HDF5AttributeCache::init ()
+  {
+    itsLocation       = 0;
+    itsLoaded         = false;
+    itsDeferredWrites = false;
+    itsValues.clear();
+  }
+
+  // ============================================================================
+  //
+  //  Parameter access
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                   attributes
+
+  std::set<std::string> HDF5AttributeCache::attributes () const
+  {
+    std::set<std::string> names;
+    std::map<std::string,Value>::const_iterator it;
+
+    for (it=itsValues.begin(); it!=itsValues.end(); ++it) {
+      names.insert (it->first);
+    }
+
+    return names;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  nofModified
+
+  unsigned int HDF5AttributeCache::nofModified () const
+  {
+    unsigned int nofModified = 0;
+    std::map<std::string,Value>::const_iterator it;
+
+    for (it=itsValues.begin(); it!=itsValues.end(); ++it) {
+      if (it->second.modified) {
+	++nofModified;
+      }
+    }
+
+    return nofModified;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void HDF5AttributeCache::summary (std::ostream &os)
+  {
+    os << "[HDF5AttributeCache] Summary of internal parameters." << std::endl;
+    os << "-- Location ID        = " << itsLocation       << std::endl;
+    os << "-- Attributes loaded  = " << itsLoaded         << std::endl;
+    os << "-- Deferred writes    = " << itsDeferredWrites << std::endl;
+    os << "-- nof. attributes    = " << nofAttributes()   << std::endl;
+    os << "-- nof. modified      = " << nofModified()     << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                       attach
+
+  /*!
+    Attaching the cache to another object discards the cached values,
+    including modifications not yet written by flush().
+
+    \param location -- Identifier of the object the attributes are attached to.
+  */
+  void HDF5AttributeCache::attach (hid_t const &location)
+  {
+    if (location != itsLocation) {
+      itsValues.clear();
+      itsLoaded = false;
+    }
+    itsLocation = location;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         load
+
+  /*!
+    Values which have been modified, but not yet been written to the file, are
+    kept.
+
+    \param location -- Identifier of the object, the attributes of which are
+           read into the cache.
+    \return status  -- Status of the operation; returns \e false if the
+            attributes of the object could not be iterated over.
+  */
+  bool HDF5AttributeCache::load (hid_t const &location)
+  {
+    attach (location);
+
+    if (!H5Iis_valid(itsLocation)) {
+      std::cerr << "[HDF5AttributeCache::load] Invalid object identifier!"
+		<< std::endl;
+      return false;
+    }
+
+    hsize_t index = 0;
+    herr_t h5err  = H5Aiterate (itsLocation,
+				H5_INDEX_NAME,
+				H5_ITER_NATIVE,
+				&index,
+				h5iterate,
+				this);
+
+    itsLoaded = (h5err >= 0);
+
+    return itsLoaded;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        clear
+
+  void HDF5AttributeCache::clear ()
+  {
+    itsValues.clear();
+    itsLoaded = false;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       remove
+
+  /*!
+    \param name -- Name of the attribute; a modification not yet written by
+           flush() is lost.
+  */
+  void HDF5AttributeCache::remove (std::string const &name)
+  {
+    itsValues.erase (name);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   invalidate
+
+  /*!
+    Values which have been modified, but not yet been written to the file, are
+    kept; all others are read again on the next call of load().
+  */
+  void HDF5AttributeCache::invalidate ()
+  {
+    std::map<std::string,Value>::iterator it = itsValues.begin();
+
+    while (it != itsValues.end()) {
+      if (it->second.modified) {
+	++it;
+      } else {
+	itsValues.erase (it++);
+      }
+    }
+
+    itsLoaded = false;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                resetModified
+
+  void HDF5AttributeCache::resetModified ()
+  {
+    std::map<std::string,Value>::iterator it;
+
+    for (it=itsValues.begin(); it!=itsValues.end(); ++it) {
+      it->second.modified = false;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         swap
+
+  /*!
+    \param other -- Another cache with which to exchange the attributes, the
+           identifier of the object and the write mode.
+  */
+  void HDF5AttributeCache::swap (HDF5AttributeCache &other)
+  {
+    std::swap (itsLocation,       other.itsLocation);
+    std::swap (itsLoaded,         other.itsLoaded);
+    std::swap (itsDeferredWrites, other.itsDeferredWrites);
+    itsValues.swap (other.itsValues);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        flush
+
+  /*!
+    \return status -- Returns \e false if writing any of the modified
+            attributes failed; these remain marked as modified.
+  */
+  bool HDF5AttributeCache::flush ()
+  {
+    bool status = true;
+    std::map<std::string,Value>::iterator it;
+
+    for (it=itsValues.begin(); it!=itsValues.end(); ++it) {
+      if (it->second.modified && !write (it->first, it->second)) {
+	status = false;
+      }
+    }
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          get
+
+  /*!
+    \param name    -- Name of the attribute.
+    \retval data   -- Values of the attribute.
+    \return status -- Returns \e false if the attribute is not held by the
+            cache, or is of string type.
+  */
+  bool HDF5AttributeCache::get (std::string const &name,
+				std::vector<bool> &data) const
+  {
+    std::vector<int> buffer;
+
+    if (!get (name, buffer)) {
+      return false;
+    }
+
+    data.resize (buffer.size());
+    for (size_t n=0; n<buffer.size(); ++n) {
+      data[n] = buffer[n];
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          get
+
+  /*!
+    \param name    -- Name of the attribute.
+    \retval data   -- Values of the attribute.
+    \return status -- Returns \e false if the attribute is not held by the
+            cache, or is not of string type.
+  */
+  bool HDF5AttributeCache::get (std::string const &name,
+				std::vector<std::string> &data) const
+  {
+    std::map<std::string,Value>::const_iterator it = itsValues.find(name);
+
+    if (it==itsValues.end() || !it->second.isString) {
+      return false;
+    }
+
+    data = it->second.strings;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          set
+
+  /*!
+    As with HDF5Attribute::write, values of type \e bool are stored as \e int.
+  */
+  bool HDF5AttributeCache::set (std::string const &name,
+				bool const &data)
+  {
+    int buffer = data;
+    return set (name, &buffer, 1);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          set
+
+  bool HDF5AttributeCache::set (std::string const &name,
+				std::vector<bool> const &data)
+  {
+    std::vector<int> buffer (data.size());
+
+    for (size_t n=0; n<data.size(); ++n) {
+      buffer[n] = data[n];
+    }
+
+    return set (name, buffer);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          set
+
+  bool HDF5AttributeCache::set (std::string const &name,
+				std::string const *data,
+				hsize_t const &size)
+  {
+    Value value;
+
+    value.isString    = true;
+    value.datatype    = 0;
+    value.nofElements = size;
+    value.strings.assign (data, data+size);
+
+    return store (name, value);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          set
+
+  bool HDF5AttributeCache::set (std::string const &name,
+				std::vector<std::string> const &data)
+  {
+    if (data.empty()) {
+      return false;
+    } else {
+      return set (name, &data[0], data.size());
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          set
+
+  bool HDF5AttributeCache::set (std::string const &name,
+				std::string const &data)
+  {
+    return set (name, &data, 1);
+  }
+
+  // ============================================================================
+  //
+  //  Private methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                   nativeType
+
+  /*!
+    \param datatype -- Identifier of the datatype of an attribute.
+    \return native  -- Predefined native datatype, which does not need to be
+            released; returns 0 for datatypes other than integer and floating
+            point numbers.
+  */
+  hid_t HDF5AttributeCache::nativeType (hid_t const &datatype)
+  {
+    H5T_class_t typeClass = H5Tget_class (datatype);
+
+    if (typeClass != H5T_INTEGER && typeClass != H5T_FLOAT) {
+      return 0;
+    }
+
+    hid_t predefined[] = { H5T_NATIVE_CHAR,  H5T_NATIVE_UCHAR,
+			   H5T_NATIVE_SHORT, H5T_NATIVE_USHORT,
+			   H5T_NATIVE_INT,   H5T_NATIVE_UINT,
+			   H5T_NATIVE_LONG,  H5T_NATIVE_ULONG,
+			   H5T_NATIVE_LLONG, H5T_NATIVE_ULLONG,
+			   H5T_NATIVE_FLOAT, H5T_NATIVE_DOUBLE,
+			   H5T_NATIVE_LDOUBLE };
+    unsigned int nofTypes = sizeof(predefined)/sizeof(hid_t);
+    hid_t native          = H5Tget_native_type (datatype, H5T_DIR_ASCEND);
+    hid_t result          = 0;
+
+    for (unsigned int n=0; n<nofTypes; ++n) {
+      if (H5Tequal (native, predefined[n]) > 0) {
+	result = predefined[n];
+	break;
+      }
+    }
+
+    H5Tclose (native);
+
+    return result;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    h5iterate
+
+  /*!
+    \param location -- Identifier of the object the attribute is attached to.
+    \param name     -- Name of the attribute.
+    \param info     -- Information on the attribute (not used).
+    \param cache    -- Pointer to the HDF5AttributeCache object.
+    \return status  -- Always zero, such that the iteration continues with the
+            next attribute; attributes which cannot be read are skipped.
+  */
+  herr_t HDF5AttributeCache::h5iterate (hid_t location,
+					char const *name,
+					H5A_info_t const *info,
+					void *cache)
+  {
+    HDF5AttributeCache *self = static_cast<HDF5AttributeCache*>(cache);
+    std::map<std::string,Value>::iterator it = self->itsValues.find(name);
+
+    (void)info;
+
+    /* Keep modifications which have not yet been written */
+    if (it!=self->itsValues.end() && it->second.modified) {
+      return 0;
+    }
+
+    hid_t attribute = H5Aopen (location, name, H5P_DEFAULT);
+    Value value;
+
+    if (H5Iis_valid(attribute)) {
+      if (read (attribute, value)) {
+	self->itsValues[name] = value;
+      }
+      H5Aclose (attribute);
+    }
+
+    return 0;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         read
+
+  /*!
+    \param attribute -- Identifier of the open attribute.
+    \retval value    -- Value of the attribute.
+    \return status   -- Returns \e false if the attribute is of a datatype not
+            supported by the cache, or reading it failed.
+  */
+  bool HDF5AttributeCache::read (hid_t const &attribute,
+				 Value &value)
+  {
+    bool status       = true;
+    herr_t h5err      = 0;
+    hid_t datatype    = H5Aget_type (attribute);
+    hid_t dataspace   = H5Aget_space (attribute);
+    hssize_t nofPoints = H5Sget_simple_extent_npoints (dataspace);
+
+    value.isString    = false;
+    value.datatype    = 0;
+    value.nofElements = nofPoints > 0 ? nofPoints : 0;
+    value.modified    = false;
+
+    if (H5Tget_class (datatype) == H5T_STRING) {
+
+      hid_t memtype  = H5Tcopy (H5T_C_S1);
+      value.isString = true;
+      value.strings.resize (value.nofElements);
+
+      if (value.nofElements == 0) {
+	/* Nothing to read */
+      } else if (H5Tis_variable_str (datatype) > 0) {
+	std::vector<char*> buffer (value.nofElements);
+	h5err = H5Tset_size (memtype, H5T_VARIABLE);
+	h5err = H5Aread (attribute, memtype, &buffer[0]);
+	if (h5err < 0) {
+	  status = false;
+	} else {
+	  for (hsize_t n=0; n<value.nofElements; ++n) {
+	    if (buffer[n] != NULL) {
+	      value.strings[n] = buffer[n];
+	    }
+	  }
+	  H5Dvlen_reclaim (memtype, dataspace, H5P_DEFAULT, &buffer[0]);
+	}
+      } else {
+	size_t length = H5Tget_size (datatype);
+	std::vector<char> buffer (value.nofElements*length);
+	h5err = H5Tset_size (memtype, length);
+	h5err = H5Aread (attribute, memtype, &buffer[0]);
+	if (h5err < 0) {
+	  status = false;
+	} else {
+	  for (hsize_t n=0; n<value.nofElements; ++n) {
+	    char const *first = &buffer[n*length];
+	    value.strings[n].assign (first, strnlen(first,length));
+	  }
+	}
+      }
+
+      H5Tclose (memtype);
+
+    } else {
+
+      value.datatype = nativeType (datatype);
+
+      if (value.datatype > 0) {
+	value.data.resize (value.nofElements*H5Tget_size(value.datatype));
+	if (value.nofElements > 0) {
+	  h5err  = H5Aread (attribute, value.datatype, &value.data[0]);
+	  status = (h5err >= 0);
+	}
+      } else {
+	status = false;
+      }
+
+    }
+
+    H5Tclose (datatype);
+    H5Sclose (dataspace);
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      convert
+
+  /*!
+    \param value    -- Value of the attribute.
+    \param datatype -- Predefined native datatype of the elements of \c data.
+    \param size     -- Size of an element of \c data, [Bytes].
+    \retval data    -- Array holding <tt>value.nofElements</tt> elements.
+    \return status  -- Returns \e false if the HDF5 library does not support
+            the conversion between the two datatypes.
+  */
+  bool HDF5AttributeCache::convert (Value const &value,
+				    hid_t const &datatype,
+				    size_t const &size,
+				    void *data)
+  {
+    size_t nofElements = value.nofElements;
+
+    if (H5Tequal (value.datatype, datatype) > 0) {
+      std::memcpy (data, &value.data[0], nofElements*size);
+      return true;
+    }
+
+    size_t elementSize = H5Tget_size (value.datatype);
+    std::vector<char> buffer (nofElements*(elementSize > size ? elementSize : size));
+
+    std::memcpy (&buffer[0], &value.data[0], nofElements*elementSize);
+
+    if (H5Tconvert (value.datatype,
+		    datatype,
+		    nofElements,
+		    &buffer[0],
+		    NULL,
+		    H5P_DEFAULT) < 0) {
+      return false;
+    }
+
+    std::memcpy (data, &buffer[0], nofElements*size);
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        store
+
+  /*!
+    \param name    -- Name of the attribute.
+    \param value   -- New value of the attribute.
+    \return status -- Returns \e false if the attribute is to be written
+            immediately, but writing failed.
+  */
+  bool HDF5AttributeCache::store (std::string const &name,
+				  Value const &value)
+  {
+    std::map<std::string,Value>::iterator it = itsValues.find(name);
+
+    /* Nothing to do if the value does not change */
+    if (it!=itsValues.end()) {
+      Value const &current = it->second;
+      if (current.isString == value.isString
+	  && current.nofElements == value.nofElements
+	  && current.strings == value.strings
+	  && current.data == value.data
+	  && (value.isString || H5Tequal (current.datatype, value.datatype) > 0)) {
+	return true;
+      }
+    }
+
+    Value &entry   = itsValues[name];
+    entry          = value;
+    entry.modified = true;
+
+    if (itsDeferredWrites) {
+      return true;
+    } else {
+      return write (name, entry);
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        write
+
+  /*!
+    An existing attribute is replaced if its number of elements or its
+    datatype class differs from the one of the new value.
+
+    \param name    -- Name of the attribute.
+    \param value   -- Value of the attribute; no longer marked as modified once
+           it has been written.
+    \return status -- Status of the operation.
+  */
+  bool HDF5AttributeCache::write (std::string const &name,
+				  Value &value)
+  {
+    if (!H5Iis_valid(itsLocation)) {
+      std::cerr << "[HDF5AttributeCache::write]"
+		<< " No valid HDF5 object to write attribute " << name << " to!"
+		<< std::endl;
+      return false;
+    }
+
+    bool status        = true;
+    herr_t h5err       = 0;
+    hid_t attribute    = 0;
+    hid_t memtype      = 0;
+    hsize_t dims[1]    = { value.nofElements };
+    std::vector<char const*> strings (value.strings.size());
+
+    if (value.isString) {
+      memtype = H5Tcopy (H5T_C_S1);
+      H5Tset_size (memtype, H5T_VARIABLE);
+      for (size_t n=0; n<strings.size(); ++n) {
+	strings[n] = value.strings[n].c_str();
+      }
+    } else {
+      memtype = value.datatype;
+    }
+
+    /* Check whether the existing attribute can take the new value */
+    if (H5Aexists (itsLocation, name.c_str()) > 0) {
+      attribute          = H5Aopen (itsLocation, name.c_str(), H5P_DEFAULT);
+      hid_t datatype     = H5Aget_type (attribute);
+      hid_t dataspace    = H5Aget_space (attribute);
+      bool compatible    = (H5Sget_simple_extent_npoints(dataspace) == hssize_t(value.nofElements));
+      if (value.isString) {
+	compatible = compatible && (H5Tis_variable_str(datatype) > 0);
+      } else {
+	compatible = compatible && (H5Tget_class(datatype) == H5Tget_class(memtype));
+      }
+      H5Tclose (datatype);
+      H5Sclose (dataspace);
+      if (!compatible) {
+	H5Aclose (attribute);
+	H5Adelete (itsLocation, name.c_str());
+	attribute = 0;
+      }
+    }
+
+    if (attribute <= 0) {
+      hid_t dataspace = H5Screate_simple (1, dims, NULL);
+      attribute       = H5Acreate (itsLocation,
+				   name.c_str(),
+				   memtype,
+				   dataspace,
+				   H5P_DEFAULT,
+				   H5P_DEFAULT);
+      H5Sclose (dataspace);
+    }
+
+    if (H5Iis_valid(attribute)) {
+      if (value.isString) {
+	h5err = H5Awrite (attribute, memtype, &strings[0]);
+      } else {
+	h5err = H5Awrite (attribute, memtype, &value.data[0]);
+      }
+      if (h5err < 0) {
+	std::cerr << "[HDF5AttributeCache::write]"
+		  << " H5Awrite() failed to write attribute " << name
+		  << std::endl;
+	status = false;
+      }
+      H5Aclose (attribute);
+    } else {
+      std::cerr << "[HDF5AttributeCache::write]"
+		<< " Failed to create attribute " << name
+		<< std::endl;
+      status = false;
+    }
+
+    if (value.isString) {
+      H5Tclose (memtype);
+    }
+
+    if (status) {
+      value.modified = false;
+    }
+
+    return status;
+  }
+
+} // Namespace DAL -- end
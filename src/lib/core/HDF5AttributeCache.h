@@ -0,0 +1,429 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef HDF5ATTRIBUTECACHE_H
+#define HDF5ATTRIBUTECACHE_H
+
+// Standard library header files
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// DAL header files
+#include <core/HDF5Attribute.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class HDF5AttributeCache
+
+    \ingroup DAL
+    \ingroup core
+
+    \brief In-memory copy of the attributes attached to an HDF5 object
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tHDF5AttributeCache.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::HDF5Attribute
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    Every call to HDF5Attribute::read or HDF5Attribute::write checks for the
+    attribute, opens it, queries its dataspace and datatype, and closes it
+    again; opening a group with a few dozen attributes thus takes a few hundred
+    calls into the library. This class instead reads all attributes of an
+    object in a single pass over its attribute list (\c H5Aiterate) and keeps
+    their values in memory:
+
+    <ul>
+      <li>Numerical attributes are stored in their native type and converted
+      to the requested type upon get(); strings (fixed or variable length)
+      are stored as std::string.
+      <li>Attributes of other classes (compound, enum, ...) are not cached;
+      has() returns \e false for them, so the caller can fall back to
+      HDF5Attribute::read.
+      <li>set() only marks an attribute as modified if its value actually
+      changes. By default modified attributes are written immediately; with
+      setDeferredWrites() they are kept until flush(), which writes all
+      modified attributes back in one go.
+    </ul>
+
+    The cache does not hold a reference to the object it is attached to; the
+    owner has to call flush() while the object still is open.
+
+    <h3>Example(s)</h3>
+
+    <ol>
+      <li>Read the attributes of a group with a single pass:
+      \code
+      DAL::HDF5AttributeCache cache (groupID);
+      std::string telescope;
+      std::vector<double> position;
+
+      cache.get ("TELESCOPE", telescope);
+      cache.get ("STATION_POSITION_VALUE", position);
+      \endcode
+
+      <li>Modify a number of attributes, writing them back at once:
+      \code
+      DAL::HDF5AttributeCache cache (groupID);
+      cache.setDeferredWrites (true);
+
+      cache.set ("NOF_STATIONS", 12);
+      cache.set ("OBSERVER", std::string("Lars"));
+      cache.flush ();
+      \endcode
+    </ol>
+  */
+  class HDF5AttributeCache {
+
+    //! In-memory copy of the value of an attribute
+    struct Value {
+      //! Is the attribute of string type?
+      bool isString;
+      //! Predefined native datatype of numerical values
+      hid_t datatype;
+      //! Number of elements
+      hsize_t nofElements;
+      //! Numerical values, as stored in the native datatype
+      std::vector<char> data;
+      //! String values
+      std::vector<std::string> strings;
+      //! Does the value have to be written to the file?
+      bool modified;
+    };
+
+    //! Identifier of the object the attributes are attached to
+    hid_t itsLocation;
+    //! Have the attributes of the object been read?
+    bool itsLoaded;
+    //! Keep modified attributes until flush()?
+    bool itsDeferredWrites;
+    //! Values of the attributes, by name
+    std::map<std::string,Value> itsValues;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor
+    HDF5AttributeCache ();
+
+    //! Argumented constructor, reading the attributes of an object
+    HDF5AttributeCache (hid_t const &location);
+
+    // === Parameter access =====================================================
+
+    //! Get the identifier of the object the attributes are attached to
+    inline hid_t location () const {
+      return itsLocation;
+    }
+
+    //! Have the attributes of the object been read?
+    inline bool isLoaded () const {
+      return itsLoaded;
+    }
+
+    //! Are modified attributes kept until flush()?
+    inline bool deferredWrites () const {
+      return itsDeferredWrites;
+    }
+
+    //! Keep modified attributes until flush()?
+    inline void setDeferredWrites (bool const &doit=true) {
+      itsDeferredWrites = doit;
+    }
+
+    //! Get the number of cached attributes
+    inline unsigned int nofAttributes () const {
+      return itsValues.size();
+    }
+
+    //! Get the names of the cached attributes
+    std::set<std::string> attributes () const;
+
+    //! Is an attribute of given name held by the cache?
+    inline bool has (std::string const &name) const {
+      return itsValues.count(name) > 0;
+    }
+
+    //! Get the number of attributes still to be written to the file
+    unsigned int nofModified () const;
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, HDF5AttributeCache.
+    */
+    inline std::string className () const {
+      return "HDF5AttributeCache";
+    }
+
+    // === Methods ==============================================================
+
+    //! Attach the cache to an object, without reading its attributes
+    void attach (hid_t const &location);
+
+    //! Read all attributes of an object
+    bool load (hid_t const &location);
+
+    //! Remove all attributes from the cache
+    void clear ();
+
+    //! Remove an attribute from the cache, without touching the file
+    void remove (std::string const &name);
+
+    //! Have the attributes read again, after they were written around the cache
+    void invalidate ();
+
+    //! Forget about modifications, which then are not written by flush()
+    void resetModified ();
+
+    //! Exchange the contents with another cache, without copying
+    void swap (HDF5AttributeCache &other);
+
+    //! Write the modified attributes to the file
+    bool flush ();
+
+    /*!
+      \brief Get the value of an attribute
+
+      \param name    -- Name of the attribute.
+      \retval data   -- Values of the attribute, converted to type \c T.
+      \return status -- Returns \e false if the attribute is not held by the
+              cache, or its values cannot be converted to type \c T.
+    */
+    template <class T>
+      bool get (std::string const &name,
+		std::vector<T> &data) const
+      {
+	typename std::map<std::string,Value>::const_iterator it = itsValues.find(name);
+
+	if (it==itsValues.end() || it->second.isString || memoryType<T>() <= 0) {
+	  return false;
+	}
+
+	data.resize (it->second.nofElements);
+
+	if (data.empty()) {
+	  return true;
+	} else {
+	  return convert (it->second, memoryType<T>(), sizeof(T), &data[0]);
+	}
+      }
+
+    /*!
+      \brief Get the value of an attribute
+
+      \param name    -- Name of the attribute.
+      \retval data   -- Value of the attribute; if the attribute holds more
+              than one element, this is the first one.
+      \return status -- Returns \e false if the attribute could not be
+              retrieved, or if it holds more than one element.
+    */
+    template <class T>
+      bool get (std::string const &name,
+		T &data) const
+      {
+	std::vector<T> buffer;
+
+	if (!get (name, buffer) || buffer.empty()) {
+	  return false;
+	}
+
+	data = buffer[0];
+	return buffer.size() == 1;
+      }
+
+    //! Get the value of an attribute of type \e bool
+    bool get (std::string const &name,
+	      std::vector<bool> &data) const;
+
+    //! Get the value of an attribute of type \e string
+    bool get (std::string const &name,
+	      std::vector<std::string> &data) const;
+
+    /*!
+      \brief Set the value of an attribute
+
+      \param name    -- Name of the attribute.
+      \param data    -- Values of the attribute.
+      \param size    -- Number of elements in \c data.
+      \return status -- Status of the operation; returns \e false if writing
+              the attribute failed.
+    */
+    template <class T>
+      bool set (std::string const &name,
+		T const *data,
+		hsize_t const &size)
+      {
+	Value value;
+	char const *buffer = reinterpret_cast<char const *>(data);
+
+	if (memoryType<T>() <= 0) {
+	  return false;
+	}
+
+	value.isString    = false;
+	value.datatype    = memoryType<T>();
+	value.nofElements = size;
+	value.data.assign (buffer, buffer+size*sizeof(T));
+
+	return store (name, value);
+      }
+
+    /*!
+      \brief Set the value of an attribute
+
+      \param name    -- Name of the attribute.
+      \param data    -- Values of the attribute.
+      \return status -- Status of the operation; returns \e false if writing
+              the attribute failed.
+    */
+    template <class T>
+      bool set (std::string const &name,
+		std::vector<T> const &data)
+      {
+	if (data.empty()) {
+	  return false;
+	} else {
+	  return set (name, &data[0], data.size());
+	}
+      }
+
+    /*!
+      \brief Set the value of an attribute
+
+      \param name    -- Name of the attribute.
+      \param data    -- Value of the attribute.
+      \return status -- Status of the operation; returns \e false if writing
+              the attribute failed.
+    */
+    template <class T>
+      bool set (std::string const &name,
+		T const &data)
+      {
+	return set (name, &data, 1);
+      }
+
+    //! Set the value of an attribute of type \e bool
+    bool set (std::string const &name,
+	      bool const &data);
+
+    //! Set the value of an attribute of type \e bool
+    bool set (std::string const &name,
+	      std::vector<bool> const &data);
+
+    //! Set the value of an attribute of type \e string
+    bool set (std::string const &name,
+	      std::string const *data,
+	      hsize_t const &size);
+
+    //! Set the value of an attribute of type \e string
+    bool set (std::string const &name,
+	      std::vector<std::string> const &data);
+
+    //! Set the value of an attribute of type \e string
+    bool set (std::string const &name,
+	      std::string const &data);
+
+  private:
+
+    //! Initialize the internal parameters
+    void init ();
+
+    /*!
+      \brief Get the predefined native datatype for values of type \c T
+
+      \return datatype -- Predefined native datatype; returns 0 for types not
+              supported by the cache, e.g. compound types.
+    */
+    template <class T>
+      static hid_t memoryType ()
+      {
+	return 0;
+      }
+
+    //! Map the datatype of an attribute onto a predefined native datatype
+    static hid_t nativeType (hid_t const &datatype);
+
+    //! Callback for H5Aiterate, reading a single attribute into the cache
+    static herr_t h5iterate (hid_t location,
+			     char const *name,
+			     H5A_info_t const *info,
+			     void *cache);
+
+    //! Read the value of an open attribute
+    static bool read (hid_t const &attribute,
+		      Value &value);
+
+    //! Convert the values of an attribute into an array of another type
+    static bool convert (Value const &value,
+			 hid_t const &datatype,
+			 size_t const &size,
+			 void *data);
+
+    //! Store a new value of an attribute, marking it as modified if changed
+    bool store (std::string const &name,
+		Value const &value);
+
+    //! Write the value of an attribute to the file
+    bool write (std::string const &name,
+		Value &value);
+
+  }; // Class HDF5AttributeCache -- end
+
+  /// @cond TEMPLATE_SPECIALIZATIONS
+  template <> hid_t HDF5AttributeCache::memoryType<char> ();
+  template <> hid_t HDF5AttributeCache::memoryType<unsigned char> ();
+  template <> hid_t HDF5AttributeCache::memoryType<short> ();
+  template <> hid_t HDF5AttributeCache::memoryType<unsigned short> ();
+  template <> hid_t HDF5AttributeCache::memoryType<int> ();
+  template <> hid_t HDF5AttributeCache::memoryType<unsigned int> ();
+  template <> hid_t HDF5AttributeCache::memoryType<long> ();
+  template <> hid_t HDF5AttributeCache::memoryType<unsigned long> ();
+  template <> hid_t HDF5AttributeCache::memoryType<long long> ();
+  template <> hid_t HDF5AttributeCache::memoryType<unsigned long long> ();
+  template <> hid_t HDF5AttributeCache::memoryType<float> ();
+  template <> hid_t HDF5AttributeCache::memoryType<double> ();
+  /// @endcond
+
+} // Namespace DAL -- end
+
+#endif /* HDF5ATTRIBUTECACHE_H */
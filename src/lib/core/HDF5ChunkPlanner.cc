@@ -0,0 +1,352 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5ChunkPlanner.h>
+
+#include <cmath>
+
+namespace DAL { // Namespace DAL -- begin
+
+  const size_t HDF5ChunkPlanner::defaultTargetBytes;
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                             HDF5ChunkPlanner
+
+  HDF5ChunkPlanner::HDF5ChunkPlanner ()
+  {
+    itsPattern     = Automatic;
+    itsTargetBytes = defaultTargetBytes;
+    itsGrowthAxis  = -1;
+  }
+
+  //_____________________________________________________________________________
+  //                                                             HDF5ChunkPlanner
+
+  /*!
+    \param pattern     -- Dominant access pattern of the dataset.
+    \param targetBytes -- Target size of a chunk, [Bytes].
+    \param growthAxis  -- Axis along which the dataset is extended; -1 if the
+           dataset keeps its initial shape.
+  */
+  HDF5ChunkPlanner::HDF5ChunkPlanner (AccessPattern const &pattern,
+				      size_t const &targetBytes,
+				      int const &growthAxis)
+  {
+    itsPattern     = pattern;
+    itsTargetBytes = defaultTargetBytes;
+    itsGrowthAxis  = growthAxis;
+
+    setTargetBytes (targetBytes);
+  }
+
+  //_____________________________________________________________________________
+  //                                                             HDF5ChunkPlanner
+
+  /*!
+    \param other -- Another HDF5ChunkPlanner object from which to create this
+           new one.
+  */
+  HDF5ChunkPlanner::HDF5ChunkPlanner (HDF5ChunkPlanner const &other)
+  {
+    copy (other);
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  HDF5ChunkPlanner::~HDF5ChunkPlanner ()
+  {;}
+
+  // ============================================================================
+  //
+  //  Operators
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                    operator=
+
+  /*!
+    \param other -- Another HDF5ChunkPlanner object from which to make a copy.
+  */
+  HDF5ChunkPlanner& HDF5ChunkPlanner::operator= (HDF5ChunkPlanner const &other)
+  {
+    if (this != &other) {
+      copy (other);
+    }
+    return *this;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         copy
+
+  void HDF5ChunkPlanner::copy (HDF5ChunkPlanner const &other)
+  {
+    itsPattern     = other.itsPattern;
+    itsTargetBytes = other.itsTargetBytes;
+    itsGrowthAxis  = other.itsGrowthAxis;
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                               setTargetBytes
+
+  /*!
+    \param targetBytes -- Target size of a chunk, [Bytes]; the HDF5 library
+           limits chunks to 4 GB.
+    \return status     -- Returns \e false if the size is out of range, in
+            which case the setting is left unchanged.
+  */
+  bool HDF5ChunkPlanner::setTargetBytes (size_t const &targetBytes)
+  {
+    if (targetBytes == 0 || (unsigned long long)(targetBytes) > 0xffffffffULL) {
+      std::cerr << "[HDF5ChunkPlanner::setTargetBytes] Chunk size "
+		<< targetBytes << " outside range [1,4GB)!" << std::endl;
+      return false;
+    }
+
+    itsTargetBytes = targetBytes;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void HDF5ChunkPlanner::summary (std::ostream &os)
+  {
+    os << "[HDF5ChunkPlanner] Summary of internal parameters." << std::endl;
+    os << "-- Access pattern     = " << name(itsPattern) << std::endl;
+    os << "-- Target chunk size  = " << itsTargetBytes   << " Bytes" << std::endl;
+    os << "-- Growth axis        = " << itsGrowthAxis    << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                   chunkShape
+
+  /*!
+    \param shape    -- (Initial) shape of the dataset; a length of zero is
+           treated as unknown, i.e. as not limiting the chunk shape.
+    \param typeSize -- Size of an element of the dataset, [Bytes].
+    \return chunk   -- Shape of the chunks, with a length of at least one along
+            every axis.
+  */
+  std::vector<hsize_t> HDF5ChunkPlanner::chunkShape (std::vector<hsize_t> const &shape,
+						     size_t const &typeSize) const
+  {
+    int rank = shape.size();
+    std::vector<hsize_t> chunk (rank, 1);
+
+    if (rank == 0) {
+      return chunk;
+    }
+
+    /* Single chunk covering the initial shape */
+    if (itsPattern == Automatic || itsPattern == Extent) {
+      for (int n=0; n<rank; ++n) {
+	chunk[n] = shape[n] > 0 ? shape[n] : 1;
+      }
+      return chunk;
+    }
+
+    /* Number of elements per chunk, and the lengths limiting the chunk */
+    hsize_t budget = itsTargetBytes/(typeSize > 0 ? typeSize : 1);
+    std::vector<hsize_t> extent (shape);
+
+    if (budget < 1) {
+      budget = 1;
+    }
+    for (int n=0; n<rank; ++n) {
+      if (extent[n] == 0) {
+	extent[n] = budget;
+      }
+    }
+
+    /* Along the growth axis the chunks hold at least as many slices as fit
+       into the budget, even if the dataset initially is shorter. For a time
+       series the time axis is sized first: the other axes count with at most
+       the side of a square/cubic chunk, such that a dataset starting from a
+       single time sample does not end up with chunks spanning all channels
+       but only a few samples. */
+    if (itsGrowthAxis >= 0 && itsGrowthAxis < rank) {
+      hsize_t slices = budget;
+      hsize_t side   = budget;
+      if (itsPattern == TimeSeries) {
+	side = (hsize_t)(std::pow (double(budget), 1.0/rank));
+	while (std::pow (double(side+1), rank) <= double(budget)) {
+	  ++side;
+	}
+	if (side < 1) {
+	  side = 1;
+	}
+      }
+      for (int n=0; n<rank; ++n) {
+	if (n != itsGrowthAxis) {
+	  hsize_t length = extent[n] < side ? extent[n] : side;
+	  slices = length < slices ? slices/length : 1;
+	}
+      }
+      if (extent[itsGrowthAxis] < slices) {
+	extent[itsGrowthAxis] = slices;
+      }
+    }
+
+    if (itsPattern == Tile) {
+      /* Axes shorter than the side of the tile are covered completely, the
+	 remaining budget is shared among the others */
+      std::vector<bool> done (rank, false);
+      int nofOpen = rank;
+
+      while (nofOpen > 0) {
+	hsize_t side = (hsize_t)(std::pow (double(budget), 1.0/nofOpen));
+	if (side < 1) {
+	  side = 1;
+	}
+	while (std::pow (double(side+1), nofOpen) <= double(budget)) {
+	  ++side;
+	}
+
+	bool capped = false;
+	for (int n=0; n<rank; ++n) {
+	  if (!done[n] && extent[n] <= side) {
+	    chunk[n] = extent[n];
+	    budget  /= extent[n];
+	    done[n]  = true;
+	    capped   = true;
+	    --nofOpen;
+	  }
+	}
+
+	if (!capped) {
+	  for (int n=0; n<rank; ++n) {
+	    if (!done[n]) {
+	      chunk[n] = side;
+	    }
+	  }
+	  break;
+	}
+
+	if (budget < 1) {
+	  budget = 1;
+	}
+      }
+    } else {
+      /* Fill the axes in the order of the access pattern */
+      for (int k=0; k<rank; ++k) {
+	int n = itsPattern == Spectrum ? rank-1-k : k;
+	chunk[n] = extent[n] < budget ? extent[n] : budget;
+	budget  /= chunk[n];
+	if (budget < 1) {
+	  budget = 1;
+	}
+      }
+    }
+
+    return chunk;
+  }
+
+  // ============================================================================
+  //
+  //  Static methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                         name
+
+  /*!
+    \param pattern -- Access pattern.
+    \return name   -- Name of the access pattern.
+  */
+  std::string HDF5ChunkPlanner::name (AccessPattern const &pattern)
+  {
+    switch (pattern) {
+    case Extent:
+      return "Extent";
+    case TimeSeries:
+      return "TimeSeries";
+    case Spectrum:
+      return "Spectrum";
+    case Tile:
+      return "Tile";
+    default:
+      return "Automatic";
+    };
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    nofChunks
+
+  /*!
+    \param chunk -- Shape of the chunks.
+    \param start -- Start of the selection.
+    \param count -- Length of the selection along each axis.
+    \return nofChunks -- Number of chunks overlapping the selection, i.e. the
+            number of chunks the library has to read; returns 0 for an empty
+            selection or inconsistent parameters.
+  */
+  hsize_t HDF5ChunkPlanner::nofChunks (std::vector<hsize_t> const &chunk,
+				       std::vector<hsize_t> const &start,
+				       std::vector<hsize_t> const &count)
+  {
+    if (chunk.empty()
+	|| chunk.size() != start.size()
+	|| chunk.size() != count.size()) {
+      return 0;
+    }
+
+    hsize_t result = 1;
+
+    for (unsigned int n=0; n<chunk.size(); ++n) {
+      if (chunk[n] == 0 || count[n] == 0) {
+	return 0;
+      }
+      hsize_t first = start[n]/chunk[n];
+      hsize_t last  = (start[n]+count[n]-1)/chunk[n];
+      result *= last-first+1;
+    }
+
+    return result;
+  }
+
+} // Namespace DAL -- end
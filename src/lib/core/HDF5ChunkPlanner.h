@@ -0,0 +1,256 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef HDF5CHUNKPLANNER_H
+#define HDF5CHUNKPLANNER_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+#include <vector>
+
+// DAL header files
+#include <dal_config.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class HDF5ChunkPlanner
+
+    \ingroup DAL
+    \ingroup core
+
+    \brief Choose the shape of the chunks of a dataset from the way it is read
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tHDF5ChunkPlanner.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::HDF5Dataset
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    The HDF5 library always reads complete chunks, so the shape of the chunks
+    decides how much of a file has to be read for a selection: reading the
+    time series of a single channel from a <tt>[time,channel]</tt> dataset
+    touches a single chunk if the chunks extend along the time axis, but one
+    chunk per time step if they extend along the channel axis instead.
+
+    Given the shape of a dataset and the size of its elements, this class
+    computes a chunk shape for the dominant access pattern:
+
+    <table border=0>
+      <tr>
+        <td class="indexkey">Pattern</td>
+        <td class="indexkey">Chunk shape</td>
+      </tr>
+      <tr>
+        <td>\e Automatic</td>
+        <td>Chosen by the dataset class; for a plain DAL::HDF5Dataset the same
+	as \e Extent.</td>
+      </tr>
+      <tr>
+        <td>\e Extent</td>
+        <td>A single chunk covering the initial shape of the dataset.</td>
+      </tr>
+      <tr>
+        <td>\e TimeSeries</td>
+        <td>As long as possible along the first axis (time), then the
+	following axes in turn.</td>
+      </tr>
+      <tr>
+        <td>\e Spectrum</td>
+        <td>As long as possible along the last axis (frequency), then the
+	preceding axes in turn.</td>
+      </tr>
+      <tr>
+        <td>\e Tile</td>
+        <td>About the same length along all axes, e.g. for image planes.</td>
+      </tr>
+    </table>
+
+    Apart from \e Extent, the number of elements per chunk is limited by the
+    target chunk size, which by default matches the default size of the chunk
+    cache (1 MB): larger chunks cannot be cached, smaller ones increase the
+    number of chunks -- and thereby the size of the chunk index -- without
+    reducing the amount of data read. An axis along which the dataset is
+    extended (e.g. the time axis of data being recorded) can be marked as
+    growth axis: even if the dataset initially is shorter, the chunks then
+    hold as many slices along that axis as fit into the target size. A
+    dataset created with a single time sample thus does not end up with
+    chunks of a single sample. For \e TimeSeries the remaining axes thereby
+    count with at most the side of a square (cubic, ...) chunk, such that the
+    chunks do not degenerate into a few samples spanning all channels.
+
+    <h3>Example(s)</h3>
+
+    <ol>
+      <li>Chunks for the time series of the channels of a Stokes dataset,
+      growing along the time axis:
+      \code
+      DAL::HDF5ChunkPlanner planner (DAL::HDF5ChunkPlanner::TimeSeries);
+      planner.setGrowthAxis (0);
+
+      std::vector<hsize_t> chunk = planner.chunkShape (shape, sizeof(float));
+      \endcode
+
+      <li>Set the planner for a dataset before creating it:
+      \code
+      DAL::HDF5Dataset dataset;
+      dataset.setChunkPlanner (DAL::HDF5ChunkPlanner (DAL::HDF5ChunkPlanner::Tile));
+      dataset.open (fileID, "Image", shape, H5T_NATIVE_FLOAT);
+      \endcode
+    </ol>
+
+  */
+  class HDF5ChunkPlanner {
+
+  public:
+
+    //! Dominant access pattern of a dataset
+    enum AccessPattern {
+      //! Left to the dataset class
+      Automatic,
+      //! Single chunk covering the initial shape
+      Extent,
+      //! Along the first axis
+      TimeSeries,
+      //! Along the last axis
+      Spectrum,
+      //! Balanced along all axes
+      Tile
+    };
+
+    //! Default target size of a chunk, [Bytes]
+    static const size_t defaultTargetBytes = 1024*1024;
+
+  private:
+
+    //! Dominant access pattern
+    AccessPattern itsPattern;
+    //! Target size of a chunk, [Bytes]
+    size_t itsTargetBytes;
+    //! Axis along which the dataset is extended (-1 if none)
+    int itsGrowthAxis;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor
+    HDF5ChunkPlanner ();
+
+    //! Argumented constructor
+    HDF5ChunkPlanner (AccessPattern const &pattern,
+		      size_t const &targetBytes=defaultTargetBytes,
+		      int const &growthAxis=-1);
+
+    //! Copy constructor
+    HDF5ChunkPlanner (HDF5ChunkPlanner const &other);
+
+    // === Destruction ==========================================================
+
+    //! Destructor
+    ~HDF5ChunkPlanner ();
+
+    // === Operators ============================================================
+
+    //! Overloading of the copy operator
+    HDF5ChunkPlanner& operator= (HDF5ChunkPlanner const &other);
+
+    // === Parameter access =====================================================
+
+    //! Get the dominant access pattern
+    inline AccessPattern pattern () const {
+      return itsPattern;
+    }
+
+    //! Set the dominant access pattern
+    inline void setPattern (AccessPattern const &pattern) {
+      itsPattern = pattern;
+    }
+
+    //! Get the target size of a chunk, [Bytes]
+    inline size_t targetBytes () const {
+      return itsTargetBytes;
+    }
+
+    //! Set the target size of a chunk, [Bytes]
+    bool setTargetBytes (size_t const &targetBytes);
+
+    //! Get the axis along which the dataset is extended (-1 if none)
+    inline int growthAxis () const {
+      return itsGrowthAxis;
+    }
+
+    //! Set the axis along which the dataset is extended (-1 if none)
+    inline void setGrowthAxis (int const &axis) {
+      itsGrowthAxis = axis;
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, HDF5ChunkPlanner.
+    */
+    inline std::string className () const {
+      return "HDF5ChunkPlanner";
+    }
+
+    // === Methods ==============================================================
+
+    //! Get the chunk shape for a dataset
+    std::vector<hsize_t> chunkShape (std::vector<hsize_t> const &shape,
+				     size_t const &typeSize) const;
+
+    // === Static methods =======================================================
+
+    //! Get the name of an access pattern
+    static std::string name (AccessPattern const &pattern);
+
+    //! Get the number of chunks touched by a selection
+    static hsize_t nofChunks (std::vector<hsize_t> const &chunk,
+			      std::vector<hsize_t> const &start,
+			      std::vector<hsize_t> const &count);
+
+  private:
+
+    //! Unconditional copying
+    void copy (HDF5ChunkPlanner const &other);
+
+  }; // Class HDF5ChunkPlanner -- end
+
+} // Namespace DAL -- end
+
+#endif /* HDF5CHUNKPLANNER_H */
@@ -0,0 +1,580 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5ChunkWriter.h>
+
+#include <cstring>
+#include <unistd.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                              HDF5ChunkWriter
+
+  /*!
+    \param nofThreads -- Number of threads compressing the chunks; if set to
+           zero, one thread per processor core is started.
+    \param maxPending -- Maximum number of chunks held by the writer; write()
+           blocks until the oldest chunk is stored once this number is
+           reached. If set to zero, four chunks per thread are allowed.
+  */
+  HDF5ChunkWriter::HDF5ChunkWriter (unsigned int const &nofThreads,
+				    unsigned int const &maxPending)
+  {
+    itsNofThreads = nofThreads;
+    if (itsNofThreads == 0) {
+      long nofCores = sysconf (_SC_NPROCESSORS_ONLN);
+      itsNofThreads = nofCores > 0 ? (unsigned int)(nofCores) : 1;
+    }
+
+    itsMaxPending  = maxPending > 0 ? maxPending : 4*itsNofThreads;
+    itsStop        = false;
+    itsNofChunks   = 0;
+    itsRawBytes    = 0;
+    itsStoredBytes = 0;
+
+    pthread_mutex_init (&itsMutex, NULL);
+    pthread_cond_init (&itsWork, NULL);
+    pthread_cond_init (&itsDone, NULL);
+
+    for (unsigned int n=0; n<itsNofThreads; ++n) {
+      pthread_t thread;
+      if (pthread_create (&thread, NULL, HDF5ChunkWriter::run, this) == 0) {
+	itsThreads.push_back (thread);
+      } else {
+	std::cerr << "[HDF5ChunkWriter] Failed to start worker thread "
+		  << n << "!" << std::endl;
+      }
+    }
+
+    itsNofThreads = itsThreads.size();
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  HDF5ChunkWriter::~HDF5ChunkWriter ()
+  {
+    flush ();
+
+    pthread_mutex_lock (&itsMutex);
+    itsStop = true;
+    pthread_cond_broadcast (&itsWork);
+    pthread_mutex_unlock (&itsMutex);
+
+    for (unsigned int n=0; n<itsThreads.size(); ++n) {
+      pthread_join (itsThreads[n], NULL);
+    }
+
+    for (unsigned int n=0; n<itsFree.size(); ++n) {
+      delete itsFree[n];
+    }
+
+    pthread_cond_destroy (&itsDone);
+    pthread_cond_destroy (&itsWork);
+    pthread_mutex_destroy (&itsMutex);
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                             compressionRatio
+
+  /*!
+    \return ratio -- Number of bytes handed to write(), divided by the number
+            of bytes stored; returns 1 as long as nothing has been written.
+  */
+  double HDF5ChunkWriter::compressionRatio () const
+  {
+    if (itsStoredBytes == 0) {
+      return 1.0;
+    } else {
+      return double(itsRawBytes)/double(itsStoredBytes);
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void HDF5ChunkWriter::summary (std::ostream &os)
+  {
+    os << "[HDF5ChunkWriter] Summary of internal parameters." << std::endl;
+    os << "-- nof. threads        = " << itsNofThreads      << std::endl;
+    os << "-- max. pending chunks = " << itsMaxPending      << std::endl;
+    os << "-- nof. datasets       = " << itsTargets.size()  << std::endl;
+    os << "-- nof. chunks written = " << itsNofChunks       << std::endl;
+    os << "-- Compression ratio   = " << compressionRatio() << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                        write
+
+  /*!
+    \param dataset -- Identifier of the dataset to which the chunk belongs;
+           the dataset has to be chunked.
+    \param chunk   -- Data of the chunk, in the datatype of the dataset; the
+           data are copied, so the buffer can be re-used once the function
+           returns.
+    \param offset  -- Position of the first element of the chunk within the
+           dataset; has to be a multiple of the chunk shape.
+    \return status -- Returns \e false if the chunk could not be handed over,
+            or if one of the chunks stored in the meantime failed.
+  */
+  bool HDF5ChunkWriter::write (hid_t const &dataset,
+			       void const *chunk,
+			       std::vector<hsize_t> const &offset)
+  {
+    Target const *info = target (dataset);
+
+    if (info == NULL || offset.size() != info->chunk.size()) {
+      std::cerr << "[HDF5ChunkWriter::write] Dataset is not chunked, or offset"
+		<< " does not match its rank!" << std::endl;
+      return false;
+    }
+
+    for (unsigned int n=0; n<offset.size(); ++n) {
+      if (offset[n]%info->chunk[n] != 0) {
+	std::cerr << "[HDF5ChunkWriter::write] Offset not aligned with chunk "
+		  << "boundary!" << std::endl;
+	return false;
+      }
+    }
+
+    /* Chunks which cannot be encoded go through the library, in order */
+    if (!info->encodable || itsThreads.empty()) {
+      size_t nofBytes = info->chunkBytes;
+      bool status     = flush ();
+      itsRawBytes    += nofBytes;
+      itsStoredBytes += nofBytes;
+      ++itsNofChunks;
+      return writeDirect (dataset, chunk, offset) && status;
+    }
+
+    bool status = true;
+    Chunk *job  = NULL;
+
+    /* Make room by storing the oldest chunk */
+    while (itsPending.size() >= itsMaxPending) {
+      status = commit (true) && status;
+    }
+
+    pthread_mutex_lock (&itsMutex);
+    if (itsFree.empty()) {
+      job = new Chunk;
+    } else {
+      job = itsFree.back();
+      itsFree.pop_back();
+    }
+    pthread_mutex_unlock (&itsMutex);
+
+    job->dataset  = dataset;
+    job->offset   = offset;
+    job->filters  = &(info->filters);
+    job->typeSize = info->typeSize;
+    job->taken    = false;
+    job->done     = false;
+    job->status   = false;
+    job->data.resize (info->chunkBytes);
+    memcpy (&(job->data[0]), chunk, info->chunkBytes);
+
+    pthread_mutex_lock (&itsMutex);
+    itsPending.push_back (job);
+    pthread_cond_signal (&itsWork);
+    pthread_mutex_unlock (&itsMutex);
+
+    /* Store whatever has been encoded already, without waiting */
+    return commit (false) && status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        flush
+
+  /*!
+    Also forgets about the properties of the datasets written to so far, as
+    their identifiers may be re-used by the library once the datasets are
+    closed.
+
+    \return status -- Returns \e false if one of the chunks could not be
+            encoded or stored.
+  */
+  bool HDF5ChunkWriter::flush ()
+  {
+    bool status = true;
+
+    while (!itsPending.empty()) {
+      status = commit (true) && status;
+    }
+
+    itsTargets.clear();
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       target
+
+  /*!
+    \param dataset -- Identifier of the dataset.
+    \return target -- Properties of the dataset; returns \e NULL if the
+            dataset is not chunked.
+  */
+  HDF5ChunkWriter::Target const * HDF5ChunkWriter::target (hid_t const &dataset)
+  {
+    std::map<hid_t, Target>::iterator it = itsTargets.find (dataset);
+
+    if (it != itsTargets.end()) {
+      return &(it->second);
+    }
+
+    hid_t plist = H5Dget_create_plist (dataset);
+    if (plist < 0) {
+      return NULL;
+    }
+
+    int rank = H5Pget_chunk (plist, 0, NULL);
+    if (H5Pget_layout (plist) != H5D_CHUNKED || rank <= 0) {
+      H5Pclose (plist);
+      return NULL;
+    }
+
+    Target info;
+    info.chunk.resize (rank);
+    H5Pget_chunk (plist, rank, &(info.chunk[0]));
+    H5Pclose (plist);
+
+    hid_t datatype = H5Dget_type (dataset);
+    info.typeSize  = H5Tget_size (datatype);
+    H5Tclose (datatype);
+
+    info.chunkBytes = info.typeSize;
+    for (int n=0; n<rank; ++n) {
+      info.chunkBytes *= info.chunk[n];
+    }
+
+    info.filters = HDF5FilterPipeline (dataset);
+
+    /* Only encode if the pipeline was recognized completely */
+#ifdef DAL_HDF5_DIRECT_CHUNK_WRITE
+    info.encodable = info.filters.isEncodable()
+      && info.filters.filterIDs() == HDF5FilterPipeline::filters (dataset);
+#else
+    info.encodable = false;
+#endif
+
+    it = itsTargets.insert (std::make_pair (dataset, info)).first;
+
+    return &(it->second);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       commit
+
+  /*!
+    \param wait    -- Wait for the oldest chunk to be encoded? If \e false,
+           only the chunks at the front of the list which have been encoded
+           already are stored.
+    \return status -- Returns \e false if one of the chunks could not be
+            encoded or stored.
+  */
+  bool HDF5ChunkWriter::commit (bool const &wait)
+  {
+    bool status = true;
+
+    while (true) {
+      pthread_mutex_lock (&itsMutex);
+      if (itsPending.empty()) {
+	pthread_mutex_unlock (&itsMutex);
+	break;
+      }
+      Chunk *job = itsPending.front();
+      if (!job->done && !wait) {
+	pthread_mutex_unlock (&itsMutex);
+	break;
+      }
+      while (!job->done) {
+	pthread_cond_wait (&itsDone, &itsMutex);
+      }
+      itsPending.pop_front();
+      pthread_mutex_unlock (&itsMutex);
+
+      /* All HDF5 calls are made from this thread */
+      if (job->status) {
+	status = writeEncoded (job->dataset,
+			       &(job->buffer[0]),
+			       job->buffer.size(),
+			       job->offset) && status;
+	itsStoredBytes += job->buffer.size();
+      } else {
+	std::cerr << "[HDF5ChunkWriter::commit] Failed to encode chunk,"
+		  << " writing through the library." << std::endl;
+	status = writeDirect (job->dataset, &(job->data[0]), job->offset) && status;
+	itsStoredBytes += job->data.size();
+      }
+      itsRawBytes += job->data.size();
+      ++itsNofChunks;
+
+      pthread_mutex_lock (&itsMutex);
+      itsFree.push_back (job);
+      pthread_mutex_unlock (&itsMutex);
+
+      /* Having waited for one chunk, store the others only if done */
+      if (wait) {
+	return commit (false) && status;
+      }
+    }
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          run
+
+  /*!
+    \param writer -- The HDF5ChunkWriter object the thread belongs to.
+  */
+  void * HDF5ChunkWriter::run (void *writer)
+  {
+    HDF5ChunkWriter *self = static_cast<HDF5ChunkWriter *>(writer);
+
+    pthread_mutex_lock (&(self->itsMutex));
+
+    while (true) {
+      Chunk *job = NULL;
+      std::deque<Chunk *>::iterator it;
+
+      for (it=self->itsPending.begin(); it!=self->itsPending.end(); ++it) {
+	if (!(*it)->taken) {
+	  job = *it;
+	  break;
+	}
+      }
+
+      if (job == NULL) {
+	if (self->itsStop) {
+	  break;
+	}
+	pthread_cond_wait (&(self->itsWork), &(self->itsMutex));
+	continue;
+      }
+
+      job->taken = true;
+      pthread_mutex_unlock (&(self->itsMutex));
+
+      bool status = job->filters->encode (&(job->data[0]),
+					  job->data.size(),
+					  job->typeSize,
+					  job->buffer);
+
+      pthread_mutex_lock (&(self->itsMutex));
+      job->status = status;
+      job->done   = true;
+      pthread_cond_broadcast (&(self->itsDone));
+    }
+
+    pthread_mutex_unlock (&(self->itsMutex));
+
+    return NULL;
+  }
+
+  // ============================================================================
+  //
+  //  Static methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                 writeEncoded
+
+  /*!
+    \param dataset  -- Identifier of the dataset.
+    \param buffer   -- Chunk, encoded by HDF5FilterPipeline::encode() using the
+           filters of the dataset.
+    \param nofBytes -- Size of the encoded chunk, [Bytes].
+    \param offset   -- Position of the first element of the chunk within the
+           dataset.
+    \return status  -- Returns \e false if the chunk could not be stored, or
+            if direct chunk writes are not supported by the HDF5 library.
+  */
+  bool HDF5ChunkWriter::writeEncoded (hid_t const &dataset,
+				      void const *buffer,
+				      size_t const &nofBytes,
+				      std::vector<hsize_t> const &offset)
+  {
+#ifdef DAL_HDF5_DIRECT_CHUNK_WRITE
+    std::vector<hsize_t> chunk (offset.size());
+    hid_t plist = H5Dget_create_plist (dataset);
+    H5Pget_chunk (plist, chunk.size(), &chunk[0]);
+    H5Pclose (plist);
+
+    if (!extend (dataset, offset, chunk)) {
+      return false;
+    }
+
+    herr_t h5error = H5Dwrite_chunk (dataset,
+				     H5P_DEFAULT,
+				     0,
+				     &offset[0],
+				     nofBytes,
+				     buffer);
+    return (h5error >= 0);
+#else
+    std::cerr << "[HDF5ChunkWriter::writeEncoded] Direct chunk writes require"
+	      << " HDF5 1.10.2 or later!" << std::endl;
+    return false;
+#endif
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  writeDirect
+
+  /*!
+    \param dataset -- Identifier of the dataset.
+    \param chunk   -- Data of the chunk, in the datatype of the dataset.
+    \param offset  -- Position of the first element of the chunk within the
+           dataset.
+    \return status -- Returns \e false if the chunk could not be stored.
+  */
+  bool HDF5ChunkWriter::writeDirect (hid_t const &dataset,
+				     void const *chunk,
+				     std::vector<hsize_t> const &offset)
+  {
+    std::vector<hsize_t> shape (offset.size());
+    hid_t plist = H5Dget_create_plist (dataset);
+    H5Pget_chunk (plist, shape.size(), &shape[0]);
+    H5Pclose (plist);
+
+    if (!extend (dataset, offset, shape)) {
+      return false;
+    }
+
+    /* Clip chunks overlapping the edge of the dataset */
+    hid_t filespace = H5Dget_space (dataset);
+    hid_t memspace  = H5Screate_simple (shape.size(), &shape[0], NULL);
+    hid_t datatype  = H5Dget_type (dataset);
+    std::vector<hsize_t> extent (shape.size());
+    std::vector<hsize_t> count (shape);
+    std::vector<hsize_t> start (shape.size(), 0);
+
+    H5Sget_simple_extent_dims (filespace, &extent[0], NULL);
+    for (unsigned int n=0; n<count.size(); ++n) {
+      if (offset[n]+count[n] > extent[n]) {
+	count[n] = extent[n]-offset[n];
+      }
+    }
+
+    herr_t h5error = H5Sselect_hyperslab (filespace,
+					  H5S_SELECT_SET,
+					  &offset[0],
+					  NULL,
+					  &count[0],
+					  NULL);
+    if (h5error >= 0) {
+      h5error = H5Sselect_hyperslab (memspace,
+				     H5S_SELECT_SET,
+				     &start[0],
+				     NULL,
+				     &count[0],
+				     NULL);
+    }
+    if (h5error >= 0) {
+      h5error = H5Dwrite (dataset,
+			  datatype,
+			  memspace,
+			  filespace,
+			  H5P_DEFAULT,
+			  chunk);
+    }
+
+    H5Tclose (datatype);
+    H5Sclose (memspace);
+    H5Sclose (filespace);
+
+    return (h5error >= 0);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       extend
+
+  /*!
+    \param dataset -- Identifier of the dataset.
+    \param offset  -- Position of the first element of the chunk.
+    \param chunk   -- Shape of the chunk.
+    \return status -- Returns \e false if the dataset could not be extended,
+            e.g. because its maximum dimensions would be exceeded.
+
+    The dataset only is extended along the dimensions for which the chunk lies
+    beyond the current extent; chunks overlapping the edge of the dataset
+    (which is not necessarily a multiple of the chunk shape) are left as is.
+  */
+  bool HDF5ChunkWriter::extend (hid_t const &dataset,
+				std::vector<hsize_t> const &offset,
+				std::vector<hsize_t> const &chunk)
+  {
+    hid_t dataspace = H5Dget_space (dataset);
+    int rank        = H5Sget_simple_extent_ndims (dataspace);
+
+    if (rank != int(offset.size())) {
+      H5Sclose (dataspace);
+      return false;
+    }
+
+    std::vector<hsize_t> shape (rank);
+    bool resize (false);
+
+    H5Sget_simple_extent_dims (dataspace, &shape[0], NULL);
+    H5Sclose (dataspace);
+
+    for (int n=0; n<rank; ++n) {
+      if (offset[n] >= shape[n]) {
+	shape[n] = offset[n]+chunk[n];
+	resize   = true;
+      }
+    }
+
+    if (resize) {
+      return (H5Dset_extent (dataset, &shape[0]) >= 0);
+    } else {
+      return true;
+    }
+  }
+
+} // Namespace DAL -- end
@@ -0,0 +1,274 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef HDF5CHUNKWRITER_H
+#define HDF5CHUNKWRITER_H
+
+// Standard library header files
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+// DAL header files
+#include <core/HDF5FilterPipeline.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class HDF5ChunkWriter
+
+    \ingroup DAL
+    \ingroup core
+
+    \brief Write whole chunks of datasets, compressing them on a pool of threads
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tHDF5ChunkWriter.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::HDF5FilterPipeline
+      <li>DAL::HDF5Dataset
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    When writing to a dataset with filters, the HDF5 library runs each chunk
+    through the filter pipeline inside \c H5Dwrite, i.e. on the calling
+    thread, one chunk after the other; with deflate compression this easily
+    becomes the limiting factor when ingesting data.
+
+    This class takes over complete chunks instead: the chunks are copied and
+    handed to a pool of worker threads, which run them through the filters
+    (see HDF5FilterPipeline::encode()). The encoded chunks are stored in the
+    order of submission by means of a direct chunk write,
+    \code
+    herr_t H5Dwrite_chunk (hid_t dset_id, hid_t dxpl_id, uint32_t filters, const hsize_t *offset, size_t data_size, const void *buf)
+    \endcode
+    which bypasses the filter pipeline of the library; the result is identical
+    to what \c H5Dwrite would have stored, so the datasets are read as usual.
+
+    As the HDF5 library is not necessarily thread-safe, all calls into it --
+    including the direct chunk writes -- are made from the thread calling
+    write() and flush(); the worker threads only compress.
+
+    A few constraints apply:
+    <ul>
+      <li>A chunk always is written as a whole, in the datatype of the dataset
+      (i.e. without type conversion). The dataset is extended if the chunk
+      lies beyond its current extent.
+      <li>Pipelines which cannot be encoded outside the library (LZ4,
+      bitshuffle), as well as HDF5 versions before 1.10.2, make write() fall
+      back to a plain \c H5Dwrite of the chunk.
+      <li>Chunks still pending have to be flushed before a dataset is closed,
+      resized, or written to by other means.
+    </ul>
+
+    <h3>Example(s)</h3>
+
+    <ol>
+      <li>Write a dataset chunk by chunk, compressing on four threads:
+      \code
+      DAL::HDF5Dataset dataset (fileID,
+                                "Data",
+                                shape,
+                                chunk,
+                                DAL::HDF5FilterPipeline (DAL::HDF5FilterPipeline::Deflate, 1),
+                                H5T_NATIVE_SHORT);
+      DAL::HDF5ChunkWriter writer (4);
+
+      for (hsize_t n=0; n<shape[0]; n+=chunk[0]) {
+        offset[0] = n;
+        writer.write (dataset.objectID(), data+n, offset);
+      }
+      writer.flush ();
+      \endcode
+    </ol>
+
+  */
+  class HDF5ChunkWriter {
+
+    //! Properties of a dataset written to
+    struct Target {
+      //! Filters of the dataset
+      HDF5FilterPipeline filters;
+      //! Can the chunks be encoded by the worker threads?
+      bool encodable;
+      //! Shape of a chunk
+      std::vector<hsize_t> chunk;
+      //! Size of a chunk, [Bytes]
+      size_t chunkBytes;
+      //! Size of an element, [Bytes]
+      size_t typeSize;
+    };
+
+    //! A chunk passing through the writer
+    struct Chunk {
+      //! Dataset the chunk belongs to
+      hid_t dataset;
+      //! Position of the chunk within the dataset
+      std::vector<hsize_t> offset;
+      //! Filters to apply
+      HDF5FilterPipeline const *filters;
+      //! Size of an element, [Bytes]
+      size_t typeSize;
+      //! Data of the chunk
+      std::vector<char> data;
+      //! Encoded chunk
+      std::vector<char> buffer;
+      //! Has a worker started encoding the chunk?
+      bool taken;
+      //! Has the chunk been encoded?
+      bool done;
+      //! Was the chunk encoded successfully?
+      bool status;
+    };
+
+    //! Number of worker threads
+    unsigned int itsNofThreads;
+    //! Maximum number of chunks pending
+    unsigned int itsMaxPending;
+    //! Worker threads
+    std::vector<pthread_t> itsThreads;
+    //! Properties of the datasets written to
+    std::map<hid_t, Target> itsTargets;
+    //! Chunks pending, in the order of submission
+    std::deque<Chunk *> itsPending;
+    //! Chunks no longer in use, kept for re-use
+    std::vector<Chunk *> itsFree;
+    //! Mutex protecting the chunk lists
+    pthread_mutex_t itsMutex;
+    //! Condition signalled when a chunk is submitted
+    pthread_cond_t itsWork;
+    //! Condition signalled when a chunk has been encoded
+    pthread_cond_t itsDone;
+    //! Are the worker threads supposed to stop?
+    bool itsStop;
+    //! Number of chunks written
+    unsigned long itsNofChunks;
+    //! Number of bytes handed in
+    unsigned long long itsRawBytes;
+    //! Number of bytes stored
+    unsigned long long itsStoredBytes;
+
+    //! Disabled copy constructor
+    HDF5ChunkWriter (HDF5ChunkWriter const &other);
+    //! Disabled assignment operator
+    HDF5ChunkWriter& operator= (HDF5ChunkWriter const &other);
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Argumented constructor, starting the worker threads
+    HDF5ChunkWriter (unsigned int const &nofThreads=0,
+		     unsigned int const &maxPending=0);
+
+    // === Destruction ==========================================================
+
+    //! Destructor, flushing the pending chunks and stopping the worker threads
+    ~HDF5ChunkWriter ();
+
+    // === Parameter access =====================================================
+
+    //! Get the number of worker threads
+    inline unsigned int nofThreads () const {
+      return itsNofThreads;
+    }
+
+    //! Get the maximum number of chunks pending
+    inline unsigned int maxPending () const {
+      return itsMaxPending;
+    }
+
+    //! Get the number of chunks written
+    inline unsigned long nofChunks () const {
+      return itsNofChunks;
+    }
+
+    //! Get the ratio of the size of the data handed in and stored
+    double compressionRatio () const;
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, HDF5ChunkWriter.
+    */
+    inline std::string className () const {
+      return "HDF5ChunkWriter";
+    }
+
+    // === Methods ==============================================================
+
+    //! Write a chunk of a dataset
+    bool write (hid_t const &dataset,
+		void const *chunk,
+		std::vector<hsize_t> const &offset);
+
+    //! Write all pending chunks
+    bool flush ();
+
+    // === Static methods =======================================================
+
+    //! Store an already encoded chunk
+    static bool writeEncoded (hid_t const &dataset,
+			      void const *buffer,
+			      size_t const &nofBytes,
+			      std::vector<hsize_t> const &offset);
+
+    //! Store a chunk through the filter pipeline of the library
+    static bool writeDirect (hid_t const &dataset,
+			     void const *chunk,
+			     std::vector<hsize_t> const &offset);
+
+    //! Extend a dataset to include a chunk
+    static bool extend (hid_t const &dataset,
+			std::vector<hsize_t> const &offset,
+			std::vector<hsize_t> const &chunk);
+
+  private:
+
+    //! Get the properties of a dataset
+    Target const * target (hid_t const &dataset);
+    //! Store the encoded chunks at the front of the list
+    bool commit (bool const &wait);
+    //! Main loop of a worker thread
+    static void * run (void *writer);
+
+  }; // Class HDF5ChunkWriter -- end
+
+} // Namespace DAL -- end
+
+#endif /* HDF5CHUNKWRITER_H */
@@ -19,6 +19,8 @@
  ***************************************************************************/
 
 #include <core/HDF5Dataset.h>
+#include <core/HDF5Datatype.h>
+#include <core/HDF5ChunkWriter.h>
 
 namespace DAL {
 
@@ -114,6 +116,39 @@ namespace DAL {
   //_____________________________________________________________________________
   //                                                                  HDF5Dataset
 
+  /*!
+    \param location  -- Identifier for the location at which the dataset is about
+           to be created.
+    \param name      -- Name of the dataset.
+    \param shape     -- Shape of the dataset.
+    \param chunksize -- Chunk size for extendible array
+    \param filters   -- Filters applied to the chunks of the dataset.
+    \param datatype  -- Datatype for the elements within the Dataset
+    \param flags     -- I/O mode flags.
+  */
+  HDF5Dataset::HDF5Dataset (hid_t const &location,
+			    std::string const &name,
+			    std::vector<hsize_t> const &shape,
+			    std::vector<hsize_t> const &chunksize,
+			    HDF5FilterPipeline const &filters,
+			    hid_t const &datatype,
+			    IO_Mode const &flags)
+  {
+    // initialize internal parameters
+    init ();
+    itsFilters = filters;
+    // create the dataset
+    open (location,
+	  name,
+	  shape,
+	  chunksize,
+	  datatype,
+	  flags);
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                  HDF5Dataset
+
   /*!
     \param other -- Another HDF5Dataset object from which to create this new
            one.
@@ -132,6 +167,8 @@ namespace DAL {
   
   HDF5Dataset::~HDF5Dataset ()
   {
+    HDF5IOExecutor::Lock lock;
+
     itsShape.clear();
     itsChunking.clear();
     itsHyperslab.clear();
@@ -140,18 +177,167 @@ namespace DAL {
     HDF5Object::close (itsDataspace);
   }
   
+  // ============================================================================
+  //
+  //  Operators
+  //
+  // ============================================================================
+  
+  //_____________________________________________________________________________
+  //                                                                    operator=
+  
+  /*!
+    \param other -- Another HDF5Dataset object from which to make a copy.
+  */
+  HDF5Dataset& HDF5Dataset::operator= (HDF5Dataset const &other)
+  {
+    if (this != &other) {
+      HDF5Object::operator= (other);
+      HDF5Object::close (itsDatatype);
+      HDF5Object::close (itsDataspace);
+      copy (other);
+    }
+    return *this;
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                         swap
+  
+  /*!
+    \param other -- Another HDF5Dataset object with which to exchange contents.
+
+    Neither identifiers nor the buffers holding shape, chunking and hyperslabs
+    are duplicated, which makes this the way to hand over a dataset object
+    e.g. into a container:
+    \code
+    std::map<std::string,DAL::HDF5Dataset> datasets;
+    DAL::HDF5Dataset dataset (location, name);
+
+    datasets[name].swap (dataset);
+    \endcode
+  */
+  void HDF5Dataset::swap (HDF5Dataset &other)
+  {
+    HDF5Object::swap (other);
+    itsName.swap (other.itsName);
+    std::swap (itsDataspace, other.itsDataspace);
+    std::swap (itsDatatype,  other.itsDatatype);
+    itsShape.swap (other.itsShape);
+    std::swap (itsLayout, other.itsLayout);
+    itsChunking.swap (other.itsChunking);
+    itsHyperslab.swap (other.itsHyperslab);
+    std::swap (itsAccessOptions, other.itsAccessOptions);
+    std::swap (itsFilters,       other.itsFilters);
+    std::swap (itsChunkPlanner,  other.itsChunkPlanner);
+  }
+  
   // ============================================================================
   //
   //  Parameter access
   //
   // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                             setAccessOptions
+
+  /*!
+    The options are used for all subsequent calls to open(); if the dataset
+    already is open, it is closed and opened once more, since the access
+    properties of a dataset can only be set when opening it. The new settings
+    only take effect if no other handle to the dataset is open at that time.
+
+    \param options -- Tuning parameters for the access to the dataset.
+    \return status -- Returns \e false if re-opening the dataset failed.
+  */
+  bool HDF5Dataset::setAccessOptions (HDF5AccessOptions const &options)
+  {
+    itsAccessOptions = options;
+
+    if (!H5Iis_valid(itsLocation) || objectType(itsLocation) != H5I_DATASET) {
+      return true;
+    }
+
+    /* Re-open the dataset through its path within the file; the dataset needs
+       to be closed first, as otherwise the library keeps using the existing
+       chunk cache. */
+    std::string path = HDF5Object::name (itsLocation);
+    hid_t fileID     = H5Iget_file_id (itsLocation);
+    hid_t accessList = itsAccessOptions.datasetAccessList();
+
+    H5Dclose (itsLocation);
+    itsLocation = H5Dopen (fileID, path.c_str(), accessList);
+
+    HDF5AccessOptions::release (accessList);
+    H5Fclose (fileID);
+
+    if (itsLocation < 0) {
+      std::cerr << "[HDF5Dataset::setAccessOptions] Failed to re-open dataset "
+		<< path << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                setChunkCache
+
+  /*!
+    \param nofBytes -- Size of the chunk cache, [Bytes]; 0 resets the library
+           default.
+    \param nofSlots -- Number of hash slots; if 0, the number of slots is derived
+           from the size of the chunks of the dataset, see
+           HDF5AccessOptions::nofChunkSlots().
+    \param w0       -- Preemption policy of the chunk cache.
+    \return status  -- Returns \e false in case an error was encountered.
+  */
+  bool HDF5Dataset::setChunkCache (size_t const &nofBytes,
+				   size_t const &nofSlots,
+				   double const &w0)
+  {
+    HDF5AccessOptions options = itsAccessOptions;
+    size_t slots              = nofSlots;
+
+    if (slots == 0 && chunkBytes() > 0) {
+      slots = HDF5AccessOptions::nofChunkSlots (nofBytes, chunkBytes());
+    }
+
+    if (!options.setChunkCache (nofBytes, slots, w0)) {
+      return false;
+    }
+
+    return setAccessOptions (options);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   chunkBytes
+
+  /*!
+    \return nofBytes -- Size of a single chunk, [Bytes]; returns 0 if the
+            dataset is not chunked.
+  */
+  size_t HDF5Dataset::chunkBytes () const
+  {
+    if (itsChunking.empty() || !H5Iis_valid(itsDatatype)) {
+      return 0;
+    }
+
+    size_t nofBytes = H5Tget_size (itsDatatype);
+
+    for (unsigned int n=0; n<itsChunking.size(); ++n) {
+      nofBytes *= itsChunking[n];
+    }
+
+    return nofBytes;
+  }
   
   //_____________________________________________________________________________
   //                                                                 setChunksize
 
   /*!
     \param shape     -- Shape of the dataset.
-    \param chunksize -- Chunk size for extendible array.
+    \param chunksize -- Chunk size for extendible array; if left empty, the chunk
+           shape is chosen through the chunk planner (see setChunkPlanner()).
   */
   bool HDF5Dataset::setShape (std::vector<hsize_t> const &shape,
 			      std::vector<hsize_t> const &chunksize)
@@ -182,7 +368,13 @@ namespace DAL {
 
     /* Check dimensions of the input array */
     if (chunksize.empty() || chunksize.size() != rank) {
-      itsChunking = itsShape;
+      if (itsChunkPlanner.pattern() == HDF5ChunkPlanner::Automatic
+	  || !H5Iis_valid(itsDatatype)) {
+	itsChunking = itsShape;
+      } else {
+	itsChunking = itsChunkPlanner.chunkShape (itsShape,
+						  H5Tget_size(itsDatatype));
+      }
     } else {
       itsChunking = chunksize;
     }
@@ -216,6 +408,9 @@ namespace DAL {
     itsShape.clear();
     itsChunking.clear();
     itsHyperslab.clear();
+    itsAccessOptions = HDF5AccessOptions();
+    itsFilters       = HDF5FilterPipeline();
+    itsChunkPlanner  = HDF5ChunkPlanner();
   }
 
   //_____________________________________________________________________________
@@ -265,9 +460,11 @@ namespace DAL {
     
     if ( datasetExists ) {
       /* Open existing dataset */
+      hid_t accessList = itsAccessOptions.datasetAccessList();
       itsLocation = H5Dopen (location,
 			     name.c_str(),
-			     H5P_DEFAULT);
+			     accessList);
+      HDF5AccessOptions::release (accessList);
       /* Check if opening of the dataset was successful */
       if ( H5Iis_valid(itsLocation) ) {
 	// Assign internal parameters
@@ -521,6 +718,13 @@ namespace DAL {
 	hid_t creationProperties = H5Pcreate (H5P_DATASET_CREATE);
 	// Set the chunk size
 	h5error = H5Pset_chunk (creationProperties, rank, chunkdims);
+	// Add the filters to the pipeline
+	if (!itsFilters.apply (creationProperties)) {
+	  std::cerr << "[HDF5Dataset::open] Failed to set up filters for dataset "
+		    << itsName << std::endl;
+	}
+	// Create the dataset access property list
+	hid_t accessProperties = itsAccessOptions.datasetAccessList();
 	// Create the Dataset ...
 	datasetCreate = true;
 	datasetID     = H5Dcreate (location,
@@ -529,9 +733,10 @@ namespace DAL {
 				   itsDataspace,
 				   H5P_DEFAULT,
 				   creationProperties,
-				   H5P_DEFAULT);
+				   accessProperties);
 	/* Release no longer required IDs */
 	H5Pclose (creationProperties);
+	HDF5AccessOptions::release (accessProperties);
       }
     }
     else if ( flags.flags() & IO_Mode::Truncate ) {
@@ -672,6 +877,15 @@ namespace DAL {
     bool status = true;
 
     if (H5Iis_valid(itsLocation)) {
+      std::vector<hsize_t> shape;
+
+      /* The dataset might have been extended by a request to the I/O executor */
+      HDF5Dataspace::shape (itsLocation, shape);
+      if (shape != itsShape) {
+	HDF5Object::close (itsDataspace);
+	itsDataspace = H5Dget_space (itsLocation);
+      }
+
       if (H5Iis_valid(itsDataspace)) {
 	
 	/*____________________________________________________________
@@ -817,6 +1031,17 @@ namespace DAL {
     return readData (data, slab, H5T_NATIVE_DOUBLE);
   }
   
+  //! Read data of type \c std::complex<float> (compound of two floats)
+  template <> bool HDF5Dataset::readData (std::complex<float> data[],
+					  HDF5Hyperslab &slab)
+  {
+    HDF5IOExecutor::Lock lock;
+    hid_t datatype = HDF5Datatype::complexFloat();
+    bool status    = readData (data, slab, datatype);
+    H5Tclose (datatype);
+    return status;
+  }
+  
   /// @endcond
   
   //_____________________________________________________________________________
@@ -866,8 +1091,241 @@ namespace DAL {
     return writeData (data, slab, H5T_NATIVE_DOUBLE);
   }
   
+  //! Write data of type \c std::complex<float> (compound of two floats)
+  template <> bool HDF5Dataset::writeData (std::complex<float> const data[],
+					   HDF5Hyperslab &slab)
+  {
+    HDF5IOExecutor::Lock lock;
+    hid_t datatype = HDF5Datatype::complexFloat();
+    bool status    = writeData (data, slab, datatype);
+    H5Tclose (datatype);
+    return status;
+  }
+  
   /// @endcond
   
+  //_____________________________________________________________________________
+  //                                                                readDataAsync
+
+  /// @cond TEMPLATE_SPECIALIZATIONS
+
+  template <> HDF5Future HDF5Dataset::readDataAsync (bool data[],
+						     HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Read, data, slab, H5T_NATIVE_HBOOL);
+  }
+
+  template <> HDF5Future HDF5Dataset::readDataAsync (int data[],
+						     HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Read, data, slab, H5T_NATIVE_INT);
+  }
+
+  template <> HDF5Future HDF5Dataset::readDataAsync (uint data[],
+						     HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Read, data, slab, H5T_NATIVE_UINT);
+  }
+
+  template <> HDF5Future HDF5Dataset::readDataAsync (short data[],
+						     HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Read, data, slab, H5T_NATIVE_SHORT);
+  }
+
+  template <> HDF5Future HDF5Dataset::readDataAsync (long data[],
+						     HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Read, data, slab, H5T_NATIVE_LONG);
+  }
+
+  template <> HDF5Future HDF5Dataset::readDataAsync (long long data[],
+						     HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Read, data, slab, H5T_NATIVE_LLONG);
+  }
+
+  template <> HDF5Future HDF5Dataset::readDataAsync (float data[],
+						     HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Read, data, slab, H5T_NATIVE_FLOAT);
+  }
+
+  template <> HDF5Future HDF5Dataset::readDataAsync (double data[],
+						     HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Read, data, slab, H5T_NATIVE_DOUBLE);
+  }
+
+  template <> HDF5Future HDF5Dataset::readDataAsync (std::complex<float> data[],
+						     HDF5Hyperslab &slab)
+  {
+    /* The executor keeps a copy of the datatype */
+    HDF5IOExecutor::Lock lock;
+    hid_t datatype    = HDF5Datatype::complexFloat();
+    HDF5Future future = submit (HDF5IOExecutor::Read, data, slab, datatype);
+    H5Tclose (datatype);
+    return future;
+  }
+
+  /// @endcond
+
+  //_____________________________________________________________________________
+  //                                                                writeDataAsync
+
+  /// @cond TEMPLATE_SPECIALIZATIONS
+
+  template <> HDF5Future HDF5Dataset::writeDataAsync (int const data[],
+						      HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Write, const_cast<int *>(data), slab, H5T_NATIVE_INT);
+  }
+
+  template <> HDF5Future HDF5Dataset::writeDataAsync (uint const data[],
+						      HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Write, const_cast<uint *>(data), slab, H5T_NATIVE_UINT);
+  }
+
+  template <> HDF5Future HDF5Dataset::writeDataAsync (short const data[],
+						      HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Write, const_cast<short *>(data), slab, H5T_NATIVE_SHORT);
+  }
+
+  template <> HDF5Future HDF5Dataset::writeDataAsync (long const data[],
+						      HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Write, const_cast<long *>(data), slab, H5T_NATIVE_LONG);
+  }
+
+  template <> HDF5Future HDF5Dataset::writeDataAsync (long long const data[],
+						      HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Write, const_cast<long long *>(data), slab, H5T_NATIVE_LLONG);
+  }
+
+  template <> HDF5Future HDF5Dataset::writeDataAsync (float const data[],
+						      HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Write, const_cast<float *>(data), slab, H5T_NATIVE_FLOAT);
+  }
+
+  template <> HDF5Future HDF5Dataset::writeDataAsync (double const data[],
+						      HDF5Hyperslab &slab)
+  {
+    return submit (HDF5IOExecutor::Write, const_cast<double *>(data), slab, H5T_NATIVE_DOUBLE);
+  }
+
+  template <> HDF5Future HDF5Dataset::writeDataAsync (std::complex<float> const data[],
+						      HDF5Hyperslab &slab)
+  {
+    /* The executor keeps a copy of the datatype */
+    HDF5IOExecutor::Lock lock;
+    hid_t datatype    = HDF5Datatype::complexFloat();
+    HDF5Future future = submit (HDF5IOExecutor::Write,
+				const_cast<std::complex<float> *>(data),
+				slab,
+				datatype);
+    H5Tclose (datatype);
+    return future;
+  }
+
+  /// @endcond
+
+  //_____________________________________________________________________________
+  //                                                                       submit
+
+  /*!
+    \param operation -- Read from or write to the dataset?
+    \param data      -- Array to read into or write from.
+    \param slab      -- Hyberslab defining a selection of the data.
+    \param datatype  -- Type of the individual elements in memory.
+    \return future   -- Completion state of the request; the future is ready
+             right away, with status \e false, if the dataset is not open.
+  */
+  HDF5Future HDF5Dataset::submit (HDF5IOExecutor::Operation const &operation,
+				  void *data,
+				  HDF5Hyperslab const &slab,
+				  hid_t const &datatype)
+  {
+    std::vector<int> start  = slab.start();
+    std::vector<int> stride = slab.stride();
+    std::vector<int> count  = slab.count();
+    std::vector<int> block  = slab.block();
+
+    HDF5IOExecutor &executor = HDF5IOExecutor::instance();
+    std::vector<hsize_t> offset (start.begin(), start.end());
+    std::vector<hsize_t> step (stride.begin(), stride.end());
+    std::vector<hsize_t> number (count.begin(), count.end());
+    std::vector<hsize_t> shape (block.begin(), block.end());
+
+    if (operation == HDF5IOExecutor::Read) {
+      return executor.read (itsLocation, datatype, offset, step, number, shape, data);
+    } else {
+      return executor.write (itsLocation, datatype, offset, step, number, shape, data);
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   writeChunk
+
+  /*!
+    The chunk is encoded by HDF5FilterPipeline::encode() and stored by a direct
+    chunk write; if the filters of the dataset cannot be run outside the
+    library, the chunk is written through \c H5Dwrite instead. In either case
+    the dataset is extended if the chunk lies beyond its current shape. To
+    compress several chunks in parallel use DAL::HDF5ChunkWriter.
+
+    \param chunk   -- Data of the chunk, in the datatype of the dataset.
+    \param offset  -- Position of the first element of the chunk within the
+           dataset; has to be a multiple of the chunk size.
+    \return status -- Returns \e false if the dataset is not chunked or the
+            chunk could not be written.
+  */
+  bool HDF5Dataset::writeChunk (void const *chunk,
+				std::vector<hsize_t> const &offset)
+  {
+    if (itsChunking.empty() || offset.size() != itsChunking.size()) {
+      std::cerr << "[HDF5Dataset::writeChunk] Dataset not chunked, or offset"
+		<< " does not match its rank!" << std::endl;
+      return false;
+    }
+
+    bool status = true;
+    HDF5IOExecutor::Lock lock;
+    HDF5FilterPipeline filters (itsLocation);
+    std::vector<char> buffer;
+
+#ifdef DAL_HDF5_DIRECT_CHUNK_WRITE
+    if (filters.isEncodable()
+	&& filters.filterIDs() == HDF5FilterPipeline::filters (itsLocation)) {
+      status = filters.encode (chunk,
+			       chunkBytes(),
+			       H5Tget_size (itsDatatype),
+			       buffer);
+      if (status) {
+	status = HDF5ChunkWriter::writeEncoded (itsLocation,
+						&buffer[0],
+						buffer.size(),
+						offset);
+      }
+    } else
+#endif
+      {
+	status = HDF5ChunkWriter::writeDirect (itsLocation, chunk, offset);
+      }
+
+    /* Keep track of the dataset having been extended */
+    if (H5Iis_valid(itsDataspace)) {
+      H5Sclose (itsDataspace);
+    }
+    itsDataspace = H5Dget_space (itsLocation);
+    HDF5Dataspace::shape (itsLocation, itsShape);
+
+    return status;
+  }
+
   //_____________________________________________________________________________
   //                                                                      summary
   
@@ -887,6 +1345,9 @@ namespace DAL {
     os << "-- Chunk size             = " << itsChunking         << std::endl;
     os << "-- nof. datapoints        = " << nofDatapoints()     << std::endl;
     os << "-- nof. active hyperslabs = " << itsHyperslab.size() << std::endl;
+    os << "-- Chunk cache [Bytes]    = " << itsAccessOptions.chunkCacheBytes() << std::endl;
+    os << "-- Compression            = " << HDF5FilterPipeline::name(itsFilters.compression()) << std::endl;
+    os << "-- Chunk planner          = " << HDF5ChunkPlanner::name(itsChunkPlanner.pattern()) << std::endl;
   }
   
   // ============================================================================
@@ -923,6 +1384,10 @@ namespace DAL {
 
   /*!
     \param other -- Another HDF5Dataset object from which to make the copy.
+
+    The identifiers of the dataset, its dataspace and its datatype are shared
+    with \c other (see HDF5Object::share), such that making a copy does not
+    require any call to open or re-read the dataset.
   */
   void HDF5Dataset::copy (HDF5Dataset const &other)
   {
@@ -931,12 +1396,15 @@ namespace DAL {
     itsHyperslab.clear();
 
     itsName        = other.itsName;
-    itsDataspace   = other.itsDataspace;
-    itsDatatype    = other.itsDatatype;
+    itsDataspace   = HDF5Object::share (other.itsDataspace);
+    itsDatatype    = HDF5Object::share (other.itsDatatype);
     itsLayout      = other.itsLayout;
     itsShape       = other.itsShape;
     itsChunking    = other.itsChunking;
     itsHyperslab   = other.itsHyperslab;
+    itsAccessOptions = other.itsAccessOptions;
+    itsFilters       = other.itsFilters;
+    itsChunkPlanner  = other.itsChunkPlanner;
   }
 
   //_____________________________________________________________________________
@@ -29,6 +29,9 @@
 #include <core/HDF5Attribute.h>
 #include <core/HDF5Object.h>
 #include <core/HDF5Hyperslab.h>
+#include <core/HDF5FilterPipeline.h>
+#include <core/HDF5ChunkPlanner.h>
+#include <core/HDF5IOExecutor.h>
 
 #define H5S_CHUNKSIZE_MAX ((uint32_t)(-1))  /* (4GB - 1) */
 
@@ -168,6 +171,16 @@ namespace DAL {
       \code
       herr_t H5Pset_chunk_cache (hid_t dapl_id, size_t rdcc_nslots, size_t rdcc_nbytes, double rdcc_w0)
       \endcode
+      The chunk cache is configured through setChunkCache() or, together
+      with the other access parameters, through setAccessOptions(); as the
+      settings are part of the dataset-access property list, an already opened
+      dataset is re-opened to apply them.
+      <li>\b H5Pset_deflate, \b H5Pset_shuffle, \b H5Pset_fletcher32 -- Add
+      filters to the pipeline through which the chunks are passed upon
+      writing. The filters are part of the dataset creation property list; they
+      are configured through setFilters() (or the constructor taking a
+      DAL::HDF5FilterPipeline) before the dataset is created, and are applied
+      transparently when reading the data back.
     </ul>
       
     <table border=0>
@@ -245,6 +258,18 @@ namespace DAL {
       \endcode
       For further background information on how to define hyperslabs to select
       regions within a dataset, consult the documentation for DAL::HDF5Hyperslab.
+
+      <li>Read the next block of a dataset while processing the current one;
+      the request is carried out by the DAL::HDF5IOExecutor:
+      \code
+      DAL::HDF5Future future = dataset.readDataAsync (next,start,block);
+
+      process (current);
+
+      if (future.wait()) {
+        std::swap (current, next);
+      }
+      \endcode
     </ol>
     
   */
@@ -266,6 +291,12 @@ namespace DAL {
     std::vector<hsize_t> itsChunking;
     //! Hyperslabs for the dataspace attached to the dataset
     std::vector<DAL::HDF5Hyperslab> itsHyperslab;
+    //! Tuning parameters for the access to the dataset
+    HDF5AccessOptions itsAccessOptions;
+    //! Filters applied to the chunks upon creation of the dataset
+    HDF5FilterPipeline itsFilters;
+    //! Planner for the chunk shape upon creation of the dataset
+    HDF5ChunkPlanner itsChunkPlanner;
 
   public:
     
@@ -294,6 +325,15 @@ namespace DAL {
 		 hid_t const &datatype=H5T_NATIVE_DOUBLE,
 		 IO_Mode const &flags=IO_Mode(IO_Mode::CreateNew));
     
+    //! Argumented constructor, creating a dataset with filters
+    HDF5Dataset (hid_t const &location,
+		 std::string const &name,
+		 std::vector<hsize_t> const &shape,
+		 std::vector<hsize_t> const &chunksize,
+		 HDF5FilterPipeline const &filters,
+		 hid_t const &datatype=H5T_NATIVE_DOUBLE,
+		 IO_Mode const &flags=IO_Mode(IO_Mode::CreateNew));
+    
     //! Copy constructor
     HDF5Dataset (HDF5Dataset const &other);
     
@@ -302,6 +342,14 @@ namespace DAL {
     // Destructor
     virtual ~HDF5Dataset ();
     
+    // === Operators ============================================================
+    
+    //! Overloading of the copy operator
+    HDF5Dataset& operator= (HDF5Dataset const &other);
+
+    //! Exchange the contents with another object, without copying
+    void swap (HDF5Dataset &other);
+    
     // === Parameter access =====================================================
     
     //! Get the name of the dataset
@@ -347,6 +395,55 @@ namespace DAL {
       return itsDatatype;
     }
 
+    //! Get the tuning parameters for the access to the dataset
+    inline HDF5AccessOptions accessOptions () const {
+      return itsAccessOptions;
+    }
+
+    //! Set the tuning parameters for the access to the dataset
+    bool setAccessOptions (HDF5AccessOptions const &options);
+
+    //! Set the parameters of the chunk cache of the dataset
+    bool setChunkCache (size_t const &nofBytes,
+			size_t const &nofSlots=0,
+			double const &w0=0.75);
+
+    //! Get the size of a single chunk, [Bytes]
+    size_t chunkBytes () const;
+
+    //! Get the filters applied to the chunks upon creation of the dataset
+    inline HDF5FilterPipeline filters () const {
+      return itsFilters;
+    }
+
+    /*!
+      \brief Set the filters applied to the chunks upon creation of the dataset
+
+      \param filters -- Filter pipeline used by subsequent calls to open()
+             creating a new dataset; an existing dataset keeps the filters it
+             has been created with.
+    */
+    inline void setFilters (HDF5FilterPipeline const &filters) {
+      itsFilters = filters;
+    }
+
+    //! Get the planner for the chunk shape upon creation of the dataset
+    inline HDF5ChunkPlanner chunkPlanner () const {
+      return itsChunkPlanner;
+    }
+
+    /*!
+      \brief Set the planner for the chunk shape upon creation of the dataset
+
+      \param planner -- Planner used by subsequent calls to open() creating a
+             new dataset without explicit chunk shape; with the default
+             (HDF5ChunkPlanner::Automatic) a single chunk covers the initial
+             shape of the dataset.
+    */
+    inline void setChunkPlanner (HDF5ChunkPlanner const &planner) {
+      itsChunkPlanner = planner;
+    }
+
     // === Public Methods =======================================================
     
     //! Provide a summary of the internal status
@@ -505,6 +602,42 @@ namespace DAL {
 			 block);
       }
     
+    // === Read the data asynchronously =========================================
+
+    /*!
+      \brief Read the data, leaving it to the I/O executor
+      \param data    -- Array receiving the data; it has to stay valid until the
+             request has been carried out.
+      \param slab    -- Hyberslab defining a selection of the data.
+      \return future -- Completion state of the request; see HDF5IOExecutor.
+    */
+    template <class T>
+      HDF5Future readDataAsync (T data[],
+				HDF5Hyperslab &slab);
+
+    /*!
+      \brief Read the data, leaving it to the I/O executor
+      \param data    -- Array receiving the data; it has to stay valid until the
+             request has been carried out.
+      \param start   -- Start position of the block to read.
+      \param block   -- Shape of the data array.
+      \return future -- Completion state of the request; see HDF5IOExecutor.
+    */
+    template <class T>
+      HDF5Future readDataAsync (T data[],
+				std::vector<int> const &start,
+				std::vector<int> const &block)
+      {
+	std::vector<int> stride (block.size(),1);
+	std::vector<int> count (block.size(),1);
+	HDF5Hyperslab slab (start,
+			    stride,
+			    count,
+			    block);
+	return readDataAsync (data,
+			      slab);
+      }
+
     // === Write the data =======================================================
 
     /*!
@@ -582,6 +715,47 @@ namespace DAL {
 			  block);
       }
 
+    // === Write the data asynchronously ========================================
+
+    /*!
+      \brief Write the data, leaving it to the I/O executor
+      \param data    -- Array with the data to be written; it has to stay valid,
+             and unchanged, until the request has been carried out.
+      \param slab    -- Hyberslab defining a selection of the data.
+      \return future -- Completion state of the request; see HDF5IOExecutor.
+    */
+    template <class T>
+      HDF5Future writeDataAsync (T const data[],
+				 HDF5Hyperslab &slab);
+
+    /*!
+      \brief Write the data, leaving it to the I/O executor
+      \param data    -- Array with the data to be written; it has to stay valid,
+             and unchanged, until the request has been carried out.
+      \param start   -- Start position from which on the \c data are supposed to
+             be written.
+      \param block   -- Shape of the \c data array.
+      \return future -- Completion state of the request; see HDF5IOExecutor.
+    */
+    template <class T>
+      HDF5Future writeDataAsync (T const data[],
+				 std::vector<int> const &start,
+				 std::vector<int> const &block)
+      {
+	std::vector<int> stride;
+	std::vector<int> count;
+	HDF5Hyperslab slab (start,
+			    stride,
+			    count,
+			    block);
+	return writeDataAsync (data,
+			       slab);
+      }
+
+    //! Write a complete chunk, running it through the filters outside the library
+    bool writeChunk (void const *chunk,
+		     std::vector<hsize_t> const &offset);
+
     // === Static methods =======================================================
     
     //! Returns the address in the file of the dataset \c location.
@@ -613,6 +787,11 @@ namespace DAL {
 	       std::vector<hsize_t> const &chunksize,
 	       hid_t const &datatype=H5T_NATIVE_DOUBLE,
 	       IO_Mode const &flags=IO_Mode(IO_Mode::CreateNew));
+    //! Hand a read or write request for a hyperslab over to the I/O executor
+    HDF5Future submit (HDF5IOExecutor::Operation const &operation,
+		       void *data,
+		       HDF5Hyperslab const &slab,
+		       hid_t const &datatype);
     /*!
       \brief Read the data
       \param data     -- Array with the data to be written.
@@ -627,6 +806,7 @@ namespace DAL {
 		     hid_t const &datatype)
       {
 	bool status (true);
+	HDF5IOExecutor::Lock lock;
 	
 	/* Set the Hyperslab for the dataspace attached to a dataset */
 	status = setHyperslab (slab, false);
@@ -679,6 +859,7 @@ namespace DAL {
 		      hid_t const &datatype)
       {
 	bool status = true;
+	HDF5IOExecutor::Lock lock;
 
 	// Set the Hyperslab selection _____________________
 
@@ -371,5 +371,25 @@ namespace DAL { // Namespace DAL -- begin
     
     return name;
   }
+
+  //_____________________________________________________________________________
+  //                                                                 complexFloat
+  
+  /*!
+    The memory layout of <tt>std::complex<float></tt> is two consecutive
+    floats, which is mapped onto a compound of the members \e real and \e imag.
+
+    \return datatype -- Identifier of the compound datatype; the caller is
+            responsible for releasing it through <tt>H5Tclose</tt>.
+  */
+  hid_t HDF5Datatype::complexFloat ()
+  {
+    hid_t datatype = H5Tcreate (H5T_COMPOUND, 2*sizeof(float));
+
+    H5Tinsert (datatype, "real", 0,             H5T_NATIVE_FLOAT);
+    H5Tinsert (datatype, "imag", sizeof(float), H5T_NATIVE_FLOAT);
+
+    return datatype;
+  }
   
 } // Namespace DAL -- end
@@ -110,6 +110,9 @@ namespace DAL { // Namespace DAL -- begin
     
     //! Get name for the datatype
     static std::string datatypeName (hid_t const &id);
+
+    //! Create a compound datatype for <tt>std::complex<float></tt>
+    static hid_t complexFloat ();
     
   private:
     
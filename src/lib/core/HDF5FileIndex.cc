@@ -0,0 +1,672 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5FileIndex.h>
+#include <core/HDF5Object.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+//! Version of the format of the sidecar file
+#define HDF5FILEINDEX_VERSION 2
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                HDF5FileIndex
+
+  HDF5FileIndex::HDF5FileIndex ()
+  {
+    init ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                HDF5FileIndex
+
+  /*!
+    \param filename -- Name of the HDF5 file, the index of which is read from
+           its sidecar; if the sidecar does not exist or is out of date, the
+           index is left invalid.
+  */
+  HDF5FileIndex::HDF5FileIndex (std::string const &filename)
+  {
+    init ();
+    read (filename);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         init
+
+  void HDF5FileIndex::init ()
+  {
+    itsFilename = "";
+    itsValid    = false;
+    itsEntries.clear();
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void HDF5FileIndex::summary (std::ostream &os)
+  {
+    os << "[HDF5FileIndex] Summary of internal parameters." << std::endl;
+    os << "-- Filename           = " << itsFilename              << std::endl;
+    os << "-- Sidecar            = " << sidecarName(itsFilename) << std::endl;
+    os << "-- Index valid        = " << itsValid                 << std::endl;
+    os << "-- nof. entries       = " << nofEntries()             << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                        clear
+
+  void HDF5FileIndex::clear ()
+  {
+    itsValid = false;
+    itsEntries.clear();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        build
+
+  /*!
+    \param fileID  -- Identifier of the file, the structure of which is
+           recorded; all objects reachable through hard links are visited in
+           a single pass (\c H5Lvisit).
+
+    \return status -- Status of the operation; returns \e false if the
+            traversal of the file failed.
+  */
+  bool HDF5FileIndex::build (hid_t const &fileID)
+  {
+    clear ();
+
+    if (!H5Iis_valid(fileID)) {
+      return false;
+    }
+
+    itsFilename = HDF5Object::name (fileID);
+
+    if (!add (fileID, ".", "/")) {
+      return false;
+    }
+
+    herr_t h5error = H5Lvisit (fileID,
+			       H5_INDEX_NAME,
+			       H5_ITER_INC,
+			       h5visit,
+			       this);
+
+    itsValid = (h5error >= 0);
+
+    if (!itsValid) {
+      itsEntries.clear();
+    }
+
+    return itsValid;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        write
+
+  /*!
+    The sidecar first is written under a temporary name and then renamed, such
+    that readers never see an incomplete index.
+
+    \param filename -- Name of the HDF5 file described by the index; the file
+           has to be closed already, as its size and modification time are
+           recorded with the index.
+
+    \return status -- Status of the operation; returns \e false if the index
+            is not valid, or the sidecar could not be written.
+  */
+  bool HDF5FileIndex::write (std::string const &filename)
+  {
+    long long size  = 0;
+    long long mtime = 0;
+
+    if (!itsValid || !fileStatus (filename, size, mtime)) {
+      return false;
+    }
+
+    std::string sidecar = sidecarName (filename);
+    std::string tmpname = sidecar + ".tmp";
+    std::ofstream outfile (tmpname.c_str());
+    std::map<std::string,Entry>::const_iterator it;
+    std::map<std::string,std::string>::const_iterator attr;
+
+    if (!outfile.is_open()) {
+      return false;
+    }
+
+    outfile << "HDF5FileIndex\t" << HDF5FILEINDEX_VERSION
+	    << "\t" << size
+	    << "\t" << mtime
+	    << "\n";
+
+    for (it=itsEntries.begin(); it!=itsEntries.end(); ++it) {
+      Entry const &entry = it->second;
+
+      outfile << (entry.type == H5G_GROUP ? "G" : "D")
+	      << "\t" << escape(it->first)
+	      << "\t";
+
+      if (entry.shape.empty()) {
+	outfile << "-";
+      } else {
+	for (unsigned int n=0; n<entry.shape.size(); ++n) {
+	  outfile << (n>0 ? "," : "") << entry.shape[n];
+	}
+      }
+
+      outfile << "\t" << entry.datatypeClass
+	      << "\t" << entry.datatypeSize;
+
+      for (attr=entry.attributes.begin(); attr!=entry.attributes.end(); ++attr) {
+	outfile << "\t" << escape(attr->first) << "=" << escape(attr->second);
+      }
+
+      outfile << "\n";
+    }
+
+    outfile.close();
+
+    if (outfile.fail() || std::rename (tmpname.c_str(), sidecar.c_str()) != 0) {
+      std::remove (tmpname.c_str());
+      return false;
+    }
+
+    itsFilename = filename;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         read
+
+  /*!
+    \param filename -- Name of the HDF5 file, the index of which is read.
+
+    \return status -- Returns \e true if the index was read; \e false if the
+            sidecar does not exist, cannot be parsed, or if size or
+            modification time of the HDF5 file differ from the ones recorded
+            when the index was written.
+  */
+  bool HDF5FileIndex::read (std::string const &filename)
+  {
+    long long size  = 0;
+    long long mtime = 0;
+    std::string line;
+    std::vector<std::string> fields;
+
+    clear ();
+    itsFilename = filename;
+
+    if (!fileStatus (filename, size, mtime)) {
+      return false;
+    }
+
+    std::string sidecar = sidecarName (filename);
+    std::ifstream infile (sidecar.c_str());
+
+    if (!infile.is_open()) {
+      return false;
+    }
+
+    /* Check if the index still describes the file */
+
+    std::ostringstream status;
+    status << "HDF5FileIndex\t" << HDF5FILEINDEX_VERSION
+	   << "\t" << size
+	   << "\t" << mtime;
+
+    std::getline (infile, line);
+
+    if (line != status.str()) {
+      return false;
+    }
+
+    /* Read the entries */
+
+    while (std::getline (infile, line)) {
+
+      if (line.empty()) {
+	continue;
+      }
+
+      fields = split (line);
+
+      if (fields.size() < 5 || (fields[0] != "G" && fields[0] != "D")) {
+	itsEntries.clear();
+	return false;
+      }
+
+      Entry entry;
+
+      entry.type          = (fields[0] == "G") ? H5G_GROUP : H5G_DATASET;
+      entry.datatypeClass = std::atoi (fields[3].c_str());
+      entry.datatypeSize  = std::atoi (fields[4].c_str());
+
+      if (fields[2] != "-") {
+	std::istringstream shape (fields[2]);
+	hsize_t value = 0;
+	char sep      = ',';
+	while (sep == ',' && shape >> value) {
+	  entry.shape.push_back (value);
+	  sep = 0;
+	  shape >> sep;
+	}
+      }
+
+      for (unsigned int n=5; n<fields.size(); ++n) {
+	std::string::size_type sep = fields[n].find('=');
+	if (sep != std::string::npos) {
+	  entry.attributes[unescape(fields[n].substr(0,sep))] = unescape(fields[n].substr(sep+1));
+	}
+      }
+
+      itsEntries[unescape(fields[1])] = entry;
+    }
+
+    itsValid = true;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        entry
+
+  /*!
+    \param path    -- Path of the group or dataset within the file.
+    \retval data   -- Entry recorded for the object.
+    \return status -- Returns \e false if no such object is recorded.
+  */
+  bool HDF5FileIndex::entry (std::string const &path,
+			     Entry &data) const
+  {
+    std::map<std::string,Entry>::const_iterator it = itsEntries.find(path);
+
+    if (it == itsEntries.end()) {
+      return false;
+    }
+
+    data = it->second;
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        names
+
+  /*!
+    \param path  -- Path of the group within the file, e.g. "/" for the root
+           group.
+    \param type  -- Type of the attached objects for which to get the names;
+           can be either \e H5G_GROUP or \e H5G_DATASET, as for h5get_names().
+
+    \return names -- Names of the objects directly attached to the group.
+  */
+  std::set<std::string> HDF5FileIndex::names (std::string const &path,
+					      int const &type) const
+  {
+    std::set<std::string> names;
+    std::string prefix = path;
+
+    if (prefix.empty() || prefix[prefix.size()-1] != '/') {
+      prefix += "/";
+    }
+
+    /* The paths below the group form a contiguous range of the map */
+    std::map<std::string,Entry>::const_iterator it = itsEntries.lower_bound(prefix);
+
+    for (; it!=itsEntries.end(); ++it) {
+      if (it->first.compare (0, prefix.size(), prefix) != 0) {
+	break;
+      }
+
+      std::string name = it->first.substr (prefix.size());
+
+      if (!name.empty()
+	  && name.find('/') == std::string::npos
+	  && it->second.type == type) {
+	names.insert (name);
+      }
+    }
+
+    return names;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    attribute
+
+  /*!
+    \param path    -- Path of the group or dataset within the file.
+    \param name    -- Name of the attribute.
+    \retval value  -- Value of the attribute.
+    \return status -- Returns \e false if the object is not recorded, or if
+            the attribute is not a single-valued string attribute.
+  */
+  bool HDF5FileIndex::attribute (std::string const &path,
+				 std::string const &name,
+				 std::string &value) const
+  {
+    std::map<std::string,Entry>::const_iterator it = itsEntries.find(path);
+
+    if (it == itsEntries.end()) {
+      return false;
+    }
+
+    std::map<std::string,std::string>::const_iterator attr = it->second.attributes.find(name);
+
+    if (attr == it->second.attributes.end()) {
+      return false;
+    }
+
+    value = attr->second;
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  sidecarName
+
+  /*!
+    \param filename -- Name of the HDF5 file.
+    \return sidecar -- Name of the file holding the index, <tt>filename.toc</tt>.
+  */
+  std::string HDF5FileIndex::sidecarName (std::string const &filename)
+  {
+    return filename + ".toc";
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       update
+
+  /*!
+    \param filename -- Name of the HDF5 file; the file is opened read-only, so
+           it should no longer be open for writing.
+
+    \return status -- Status of the operation; returns \e false if the file
+            could not be opened, or the sidecar could not be written.
+  */
+  bool HDF5FileIndex::update (std::string const &filename)
+  {
+    HDF5FileIndex index;
+    hid_t fileID = H5Fopen (filename.c_str(),
+			    H5F_ACC_RDONLY,
+			    H5P_DEFAULT);
+
+    if (fileID < 0) {
+      return false;
+    }
+
+    bool status = index.build (fileID);
+
+    H5Fclose (fileID);
+
+    if (status) {
+      status = index.write (filename);
+    }
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          add
+
+  /*!
+    \param location -- Identifier of the object relative to which \e name is
+           resolved.
+    \param name     -- Name of the object, relative to \e location.
+    \param path     -- Absolute path of the object, used as key of the entry.
+
+    \return status -- Returns \e false if the object could not be inspected;
+            objects other than groups and datasets are skipped silently.
+  */
+  bool HDF5FileIndex::add (hid_t const &location,
+			   std::string const &name,
+			   std::string const &path)
+  {
+    H5O_info_t info;
+    Entry entry;
+
+    if (H5Oget_info_by_name (location, name.c_str(), &info, H5P_DEFAULT) < 0) {
+      return false;
+    }
+
+    switch (info.type) {
+    case H5O_TYPE_GROUP:
+      entry.type = H5G_GROUP;
+      break;
+    case H5O_TYPE_DATASET:
+      entry.type = H5G_DATASET;
+      break;
+    default:
+      return true;
+    };
+
+    hid_t object = H5Oopen (location, name.c_str(), H5P_DEFAULT);
+
+    if (object < 0) {
+      return false;
+    }
+
+    entry.datatypeClass = -1;
+    entry.datatypeSize  = 0;
+
+    /* Shape and datatype of a dataset */
+
+    if (entry.type == H5G_DATASET) {
+      hid_t dataspace = H5Dget_space (object);
+      hid_t datatype  = H5Dget_type (object);
+      int rank        = H5Sget_simple_extent_ndims (dataspace);
+
+      if (rank > 0) {
+	entry.shape.resize (rank);
+	H5Sget_simple_extent_dims (dataspace, &entry.shape[0], NULL);
+      }
+
+      entry.datatypeClass = H5Tget_class (datatype);
+      entry.datatypeSize  = H5Tget_size (datatype);
+
+      H5Tclose (datatype);
+      H5Sclose (dataspace);
+    }
+
+    /* Single-valued string attributes */
+
+    HDF5AttributeCache cache (object);
+    std::set<std::string> attributes = cache.attributes();
+    std::set<std::string>::iterator it;
+    std::string value;
+
+    for (it=attributes.begin(); it!=attributes.end(); ++it) {
+      if (it->find('=') == std::string::npos && cache.get (*it, value)) {
+	entry.attributes[*it] = value;
+      }
+    }
+
+    H5Oclose (object);
+
+    itsEntries[path] = entry;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      h5visit
+
+  /*!
+    \param location -- Identifier of the group at which the traversal started.
+    \param name     -- Name of the link, relative to \e location.
+    \param info     -- Information on the link.
+    \param index    -- Pointer to the HDF5FileIndex object being built.
+
+    \return status -- Returns a negative value to stop the traversal if an
+            object could not be inspected.
+  */
+  herr_t HDF5FileIndex::h5visit (hid_t location,
+				 char const *name,
+				 H5L_info_t const *info,
+				 void *index)
+  {
+    /* Soft and external links are not followed by h5get_names either */
+    if (info->type != H5L_TYPE_HARD) {
+      return 0;
+    }
+
+    HDF5FileIndex *self = static_cast<HDF5FileIndex *>(index);
+    std::string path    = "/" + std::string(name);
+
+    return self->add (location, name, path) ? 0 : -1;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   fileStatus
+
+  /*!
+    \param filename -- Name of the file.
+    \retval size    -- Size of the file, [Bytes].
+    \retval mtime   -- Time of the last modification of the file, [ns]; the
+            nanoseconds are only recorded where \c stat provides them,
+            otherwise the time is a multiple of whole seconds.
+
+    \return status -- Returns \e false if the file does not exist.
+  */
+  bool HDF5FileIndex::fileStatus (std::string const &filename,
+				  long long &size,
+				  long long &mtime)
+  {
+    struct stat filestat;
+
+    if (::stat (filename.c_str(), &filestat) != 0) {
+      return false;
+    }
+
+    size  = filestat.st_size;
+    mtime = (long long)(filestat.st_mtime) * 1000000000LL;
+
+    /* Files rewritten within the same second otherwise go unnoticed */
+#if defined(__linux__)
+    mtime += filestat.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    mtime += filestat.st_mtimespec.tv_nsec;
+#endif
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       escape
+
+  std::string HDF5FileIndex::escape (std::string const &field)
+  {
+    std::string result;
+
+    for (std::string::size_type n=0; n<field.size(); ++n) {
+      switch (field[n]) {
+      case '\\':
+	result += "\\\\";
+	break;
+      case '\t':
+	result += "\\t";
+	break;
+      case '\n':
+	result += "\\n";
+	break;
+      default:
+	result += field[n];
+	break;
+      };
+    }
+
+    return result;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     unescape
+
+  std::string HDF5FileIndex::unescape (std::string const &field)
+  {
+    std::string result;
+
+    for (std::string::size_type n=0; n<field.size(); ++n) {
+      if (field[n] == '\\' && n+1 < field.size()) {
+	++n;
+	switch (field[n]) {
+	case 't':
+	  result += '\t';
+	  break;
+	case 'n':
+	  result += '\n';
+	  break;
+	default:
+	  result += field[n];
+	  break;
+	};
+      } else {
+	result += field[n];
+      }
+    }
+
+    return result;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        split
+
+  std::vector<std::string> HDF5FileIndex::split (std::string const &line)
+  {
+    std::vector<std::string> fields;
+    std::string::size_type start = 0;
+    std::string::size_type pos   = 0;
+
+    while ((pos = line.find('\t', start)) != std::string::npos) {
+      fields.push_back (line.substr(start, pos-start));
+      start = pos+1;
+    }
+    fields.push_back (line.substr(start));
+
+    return fields;
+  }
+
+} // Namespace DAL -- end
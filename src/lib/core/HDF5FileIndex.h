@@ -0,0 +1,246 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef HDF5FILEINDEX_H
+#define HDF5FILEINDEX_H
+
+// Standard library header files
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// DAL header files
+#include <core/HDF5AttributeCache.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class HDF5FileIndex
+
+    \ingroup DAL
+    \ingroup core
+
+    \brief Table of contents of an HDF5 file, kept in a sidecar file
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tHDF5FileIndex.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::HDF5AttributeCache
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    Opening one of the high-level data structures discovers the groups and
+    datasets embedded in the file by walking the links of every group
+    (DAL::h5get_names), which for a file with a few dozen stations and
+    thousands of dipoles adds up to a large number of calls into the library.
+    This class records the structure of a file once -- the path of every
+    group and dataset, the shape and datatype of the datasets, and the
+    single-valued string attributes such as \c GROUPTYPE -- and stores it in
+    a small text file next to the HDF5 file:
+
+    \verbatim
+    <filename>.toc
+    \endverbatim
+
+    A sidecar is used rather than a dataset within the file itself, as the
+    index then can be read without opening the file, and writing it does not
+    change the file it describes. The first line of the sidecar holds the
+    size and modification time of the HDF5 file at the time the index was
+    written, the latter in nanoseconds where the system provides them;
+    read() only accepts the index if both still match, otherwise the caller
+    falls back to traversing the file.
+
+    <h3>Example(s)</h3>
+
+    <ol>
+      <li>Write the index for a file, after it has been closed:
+      \code
+      DAL::HDF5FileIndex::update ("data.h5");
+      \endcode
+
+      <li>Get the names of the groups attached to the root group, if the
+      index is up to date:
+      \code
+      DAL::HDF5FileIndex index;
+      std::set<std::string> groups;
+
+      if (index.read ("data.h5")) {
+        groups = index.names ("/", H5G_GROUP);
+      } else {
+        DAL::h5get_names (groups, fileID, H5G_GROUP);
+      }
+      \endcode
+    </ol>
+  */
+  class HDF5FileIndex {
+
+  public:
+
+    //! Description of a group or dataset within the file
+    struct Entry {
+      //! Type of the object, \e H5G_GROUP or \e H5G_DATASET
+      int type;
+      //! Shape of a dataset; empty for groups and scalar datasets
+      std::vector<hsize_t> shape;
+      //! Class of the datatype of a dataset
+      int datatypeClass;
+      //! Size of the datatype of a dataset, [Bytes]
+      size_t datatypeSize;
+      //! Single-valued string attributes, by name
+      std::map<std::string,std::string> attributes;
+    };
+
+  private:
+
+    //! Name of the HDF5 file described by the index
+    std::string itsFilename;
+    //! Has the index been built or read?
+    bool itsValid;
+    //! Entries of the index, by path within the file
+    std::map<std::string,Entry> itsEntries;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor
+    HDF5FileIndex ();
+
+    //! Argumented constructor, reading the index of a file
+    HDF5FileIndex (std::string const &filename);
+
+    // === Parameter access =====================================================
+
+    //! Get the name of the HDF5 file described by the index
+    inline std::string filename () const {
+      return itsFilename;
+    }
+
+    //! Has the index been built or read?
+    inline bool isValid () const {
+      return itsValid;
+    }
+
+    //! Get the number of groups and datasets recorded in the index
+    inline unsigned int nofEntries () const {
+      return itsEntries.size();
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, HDF5FileIndex.
+    */
+    inline std::string className () const {
+      return "HDF5FileIndex";
+    }
+
+    // === Methods ==============================================================
+
+    //! Remove all entries from the index
+    void clear ();
+
+    //! Record the structure of an open file
+    bool build (hid_t const &fileID);
+
+    //! Write the index to the sidecar of a file
+    bool write (std::string const &filename);
+
+    //! Read the index from the sidecar of a file, if it is up to date
+    bool read (std::string const &filename);
+
+    //! Is a group or dataset of given path recorded in the index?
+    inline bool has (std::string const &path) const {
+      return itsEntries.count(path) > 0;
+    }
+
+    //! Get the entry for a group or dataset
+    bool entry (std::string const &path,
+		Entry &data) const;
+
+    //! Get the names of the objects attached to a group
+    std::set<std::string> names (std::string const &path,
+				 int const &type=H5G_GROUP) const;
+
+    //! Get the value of a single-valued string attribute
+    bool attribute (std::string const &path,
+		    std::string const &name,
+		    std::string &value) const;
+
+    // === Static methods =======================================================
+
+    //! Get the name of the sidecar holding the index of a file
+    static std::string sidecarName (std::string const &filename);
+
+    //! Build the index of a file and write it to its sidecar
+    static bool update (std::string const &filename);
+
+  private:
+
+    //! Initialize the internal parameters
+    void init ();
+
+    //! Add the entry for an object to the index
+    bool add (hid_t const &location,
+	      std::string const &name,
+	      std::string const &path);
+
+    //! Callback for H5Lvisit, adding an object to the index
+    static herr_t h5visit (hid_t location,
+			   char const *name,
+			   H5L_info_t const *info,
+			   void *index);
+
+    //! Get size and modification time of a file
+    static bool fileStatus (std::string const &filename,
+			    long long &size,
+			    long long &mtime);
+
+    //! Escape tabs, newlines and backslashes within a field
+    static std::string escape (std::string const &field);
+
+    //! Undo the escaping done by escape()
+    static std::string unescape (std::string const &field);
+
+    //! Split a line of the sidecar into its tab-separated fields
+    static std::vector<std::string> split (std::string const &line);
+
+  }; // Class HDF5FileIndex -- end
+
+} // Namespace DAL -- end
+
+#endif /* HDF5FILEINDEX_H */
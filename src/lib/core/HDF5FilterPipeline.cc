@@ -0,0 +1,644 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5FilterPipeline.h>
+
+#include <cstring>
+
+#if defined(DAL_WITH_ZLIB) && defined(H5_HAVE_FILTER_DEFLATE)
+#include <zlib.h>
+#endif
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                           HDF5FilterPipeline
+
+  HDF5FilterPipeline::HDF5FilterPipeline ()
+  {
+    init ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                           HDF5FilterPipeline
+
+  /*!
+    \param compression -- Compression stage of the pipeline.
+    \param level       -- Compression level, 1 (fastest) to 9 (best
+           compression); only used for deflate compression.
+    \param shuffle     -- Shuffle the bytes before compression?
+    \param fletcher32  -- Add Fletcher32 checksums?
+  */
+  HDF5FilterPipeline::HDF5FilterPipeline (Compression const &compression,
+					  unsigned int const &level,
+					  bool const &shuffle,
+					  bool const &fletcher32)
+  {
+    init ();
+
+    setCompression (compression, level);
+    itsShuffle    = shuffle;
+    itsFletcher32 = fletcher32;
+  }
+
+  //_____________________________________________________________________________
+  //                                                           HDF5FilterPipeline
+
+  /*!
+    Filters not handled by this class are ignored; use filters() to retrieve the
+    complete pipeline.
+
+    \param location -- Identifier of a dataset or of a dataset creation property
+           list.
+  */
+  HDF5FilterPipeline::HDF5FilterPipeline (hid_t const &location)
+  {
+    init ();
+
+    hid_t plist;
+
+    switch (H5Iget_type(location)) {
+    case H5I_DATASET:
+      plist = H5Dget_create_plist (location);
+      break;
+    case H5I_GENPROP_LST:
+      plist = H5Pcopy (location);
+      break;
+    default:
+      return;
+    };
+
+    if (plist < 0) {
+      return;
+    }
+
+    int nofFilters = H5Pget_nfilters (plist);
+    unsigned int flags;
+    unsigned int values[8];
+    size_t nofValues;
+    unsigned int filterConfig;
+    char filterName[64];
+
+    for (int n=0; n<nofFilters; ++n) {
+      nofValues = 8;
+      H5Z_filter_t filter = H5Pget_filter2 (plist,
+					    n,
+					    &flags,
+					    &nofValues,
+					    values,
+					    sizeof(filterName),
+					    filterName,
+					    &filterConfig);
+      switch (filter) {
+      case H5Z_FILTER_SHUFFLE:
+	itsShuffle = true;
+	break;
+      case H5Z_FILTER_DEFLATE:
+	itsCompression = Deflate;
+	itsLevel       = nofValues > 0 ? values[0] : 4;
+	break;
+      case H5Z_FILTER_FLETCHER32:
+	itsFletcher32 = true;
+	break;
+      case DAL_H5Z_FILTER_LZ4:
+	itsCompression = LZ4;
+	break;
+      case DAL_H5Z_FILTER_BITSHUFFLE:
+	itsCompression = BitshuffleLZ4;
+	break;
+      default:
+	break;
+      };
+    }
+
+    H5Pclose (plist);
+  }
+
+  //_____________________________________________________________________________
+  //                                                           HDF5FilterPipeline
+
+  /*!
+    \param other -- Another HDF5FilterPipeline object from which to create this
+           new one.
+  */
+  HDF5FilterPipeline::HDF5FilterPipeline (HDF5FilterPipeline const &other)
+  {
+    copy (other);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         init
+
+  void HDF5FilterPipeline::init ()
+  {
+    itsCompression = None;
+    itsLevel       = 4;
+    itsShuffle     = false;
+    itsFletcher32  = false;
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  HDF5FilterPipeline::~HDF5FilterPipeline ()
+  {;}
+
+  // ============================================================================
+  //
+  //  Operators
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                    operator=
+
+  /*!
+    \param other -- Another HDF5FilterPipeline object from which to make a copy.
+  */
+  HDF5FilterPipeline& HDF5FilterPipeline::operator= (HDF5FilterPipeline const &other)
+  {
+    if (this != &other) {
+      copy (other);
+    }
+    return *this;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         copy
+
+  void HDF5FilterPipeline::copy (HDF5FilterPipeline const &other)
+  {
+    itsCompression = other.itsCompression;
+    itsLevel       = other.itsLevel;
+    itsShuffle     = other.itsShuffle;
+    itsFletcher32  = other.itsFletcher32;
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                               setCompression
+
+  /*!
+    \param compression -- Compression stage of the pipeline.
+    \param level       -- Compression level, 1 (fastest) to 9 (best
+           compression); only used for deflate compression.
+    \return status     -- Returns \e false if the compression level is out of
+            range, in which case the settings are left unchanged.
+  */
+  bool HDF5FilterPipeline::setCompression (Compression const &compression,
+					   unsigned int const &level)
+  {
+    if (compression == Deflate && (level < 1 || level > 9)) {
+      std::cerr << "[HDF5FilterPipeline::setCompression] Deflate level "
+		<< level << " outside range [1,9]!" << std::endl;
+      return false;
+    }
+
+    itsCompression = compression;
+    itsLevel       = level;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void HDF5FilterPipeline::summary (std::ostream &os)
+  {
+    os << "[HDF5FilterPipeline] Summary of internal parameters." << std::endl;
+    os << "-- Compression        = " << name(itsCompression)       << std::endl;
+    os << "-- Compression level  = " << itsLevel                   << std::endl;
+    os << "-- Filter available   = " << isAvailable(itsCompression) << std::endl;
+    os << "-- Shuffle            = " << itsShuffle                 << std::endl;
+    os << "-- Fletcher32         = " << itsFletcher32              << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                        apply
+
+  /*!
+    The filters are added in the order shuffle, compression, checksum, such
+    that the checksum is computed over the data as stored on disk. If the
+    filter plugin for the requested compression is not available, shuffle and
+    deflate compression are used instead.
+
+    \param plist   -- Dataset creation property list, for which the chunking
+           already has to be set.
+    \return status -- Returns \e false if one of the filters could not be added
+            to the property list.
+  */
+  bool HDF5FilterPipeline::apply (hid_t const &plist) const
+  {
+    bool status        = true;
+    Compression method = itsCompression;
+    bool shuffle       = itsShuffle;
+    unsigned int level = itsLevel;
+
+    if (isEmpty()) {
+      return true;
+    }
+
+    /* Fall back to deflate if the plugin cannot be loaded */
+    if (method != None && !isAvailable(method)) {
+      std::cerr << "[HDF5FilterPipeline::apply] Filter plugin for "
+		<< name(method) << " compression not available"
+		<< " - using shuffle and deflate instead." << std::endl;
+      method  = Deflate;
+      shuffle = true;
+      if (level < 1 || level > 9) {
+	level = 4;
+      }
+    }
+
+    /* Byte shuffle; bitshuffle does its own re-ordering */
+    if (shuffle && method != BitshuffleLZ4) {
+      status = status && (H5Pset_shuffle (plist) >= 0);
+    }
+
+    /* Compression */
+    switch (method) {
+    case Deflate:
+      status = status && (H5Pset_deflate (plist, level) >= 0);
+      break;
+    case LZ4:
+      status = status && (H5Pset_filter (plist,
+					 DAL_H5Z_FILTER_LZ4,
+					 H5Z_FLAG_MANDATORY,
+					 0,
+					 NULL) >= 0);
+      break;
+    case BitshuffleLZ4:
+      {
+	/* Default block size, LZ4 compression */
+	const unsigned int cd_values[5] = {0, 0, 0, 0, 2};
+	status = status && (H5Pset_filter (plist,
+					   DAL_H5Z_FILTER_BITSHUFFLE,
+					   H5Z_FLAG_MANDATORY,
+					   5,
+					   cd_values) >= 0);
+      }
+      break;
+    default:
+      break;
+    };
+
+    /* Checksum */
+    if (itsFletcher32) {
+      status = status && (H5Pset_fletcher32 (plist) >= 0);
+    }
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    filterIDs
+
+  /*!
+    \return filters -- Identifiers of the filters set up by apply(), provided
+            the filter plugins are available.
+  */
+  std::vector<H5Z_filter_t> HDF5FilterPipeline::filterIDs () const
+  {
+    std::vector<H5Z_filter_t> result;
+
+    if (itsShuffle && itsCompression != BitshuffleLZ4) {
+      result.push_back (H5Z_FILTER_SHUFFLE);
+    }
+
+    switch (itsCompression) {
+    case Deflate:
+      result.push_back (H5Z_FILTER_DEFLATE);
+      break;
+    case LZ4:
+      result.push_back (DAL_H5Z_FILTER_LZ4);
+      break;
+    case BitshuffleLZ4:
+      result.push_back (DAL_H5Z_FILTER_BITSHUFFLE);
+      break;
+    default:
+      break;
+    };
+
+    if (itsFletcher32) {
+      result.push_back (H5Z_FILTER_FLETCHER32);
+    }
+
+    return result;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  isEncodable
+
+  /*!
+    \return encodable -- Returns \e true if the pipeline only consists of
+            shuffle, deflate and Fletcher32; the filter plugins are only
+            accessible through the HDF5 library, and deflate requires DAL to
+            be linked against zlib.
+  */
+  bool HDF5FilterPipeline::isEncodable () const
+  {
+    switch (itsCompression) {
+    case None:
+      return true;
+#if defined(DAL_WITH_ZLIB) && defined(H5_HAVE_FILTER_DEFLATE)
+    case Deflate:
+      return true;
+#endif
+    default:
+      return false;
+    };
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       encode
+
+  /*!
+    Runs the chunk through shuffle, deflate and Fletcher32 in the same way as
+    the HDF5 library does upon writing the chunk, such that the result can be
+    stored using \c H5Dwrite_chunk with a filter mask of zero. No HDF5
+    function is called, so chunks may be encoded from several threads at once.
+
+    \param chunk    -- Data of the chunk, in the datatype of the dataset.
+    \param nofBytes -- Size of the chunk, [Bytes].
+    \param typeSize -- Size of a single element of the chunk, [Bytes]; used
+           for shuffling.
+    \retval buffer  -- Encoded chunk.
+    \return status  -- Returns \e false if the pipeline is not encodable, or
+            if compression failed.
+  */
+  bool HDF5FilterPipeline::encode (void const *chunk,
+				   size_t const &nofBytes,
+				   size_t const &typeSize,
+				   std::vector<char> &buffer) const
+  {
+    if (!isEncodable()) {
+      return false;
+    }
+
+    char const *src = static_cast<char const *>(chunk);
+    std::vector<char> shuffled;
+
+    /* Byte shuffle, skipped by the library for single elements or bytes */
+    if (itsShuffle && typeSize > 1 && nofBytes/typeSize > 1) {
+      size_t nofElements = nofBytes/typeSize;
+      size_t leftover    = nofBytes%typeSize;
+      shuffled.resize (nofBytes);
+      for (size_t i=0; i<typeSize; ++i) {
+	char *dest = &shuffled[i*nofElements];
+	for (size_t j=0; j<nofElements; ++j) {
+	  dest[j] = src[j*typeSize+i];
+	}
+      }
+      if (leftover > 0) {
+	memcpy (&shuffled[nofBytes-leftover], src+nofBytes-leftover, leftover);
+      }
+      src = &shuffled[0];
+    }
+
+    /* Compression */
+    size_t length = nofBytes;
+#if defined(DAL_WITH_ZLIB) && defined(H5_HAVE_FILTER_DEFLATE)
+    if (itsCompression == Deflate) {
+      uLongf nofCompressed = compressBound (nofBytes);
+      buffer.resize (nofCompressed + 4);
+      if (compress2 (reinterpret_cast<Bytef *>(&buffer[0]),
+		     &nofCompressed,
+		     reinterpret_cast<Bytef const *>(src),
+		     nofBytes,
+		     itsLevel) != Z_OK) {
+	return false;
+      }
+      length = nofCompressed;
+    } else
+#endif
+      {
+	buffer.resize (nofBytes + 4);
+	if (nofBytes > 0) {
+	  memcpy (&buffer[0], src, nofBytes);
+	}
+      }
+
+    /* Checksum, appended in little-endian byte order */
+    if (itsFletcher32) {
+      unsigned int sum = checksum (&buffer[0], length);
+      buffer[length]   = (char)(sum & 0xff);
+      buffer[length+1] = (char)((sum >> 8) & 0xff);
+      buffer[length+2] = (char)((sum >> 16) & 0xff);
+      buffer[length+3] = (char)((sum >> 24) & 0xff);
+      length += 4;
+    }
+
+    buffer.resize (length);
+
+    return true;
+  }
+
+  // ============================================================================
+  //
+  //  Static methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                         name
+
+  /*!
+    \param compression -- Compression stage of the pipeline.
+    \return name       -- Name of the compression stage.
+  */
+  std::string HDF5FilterPipeline::name (Compression const &compression)
+  {
+    switch (compression) {
+    case Deflate:
+      return "Deflate";
+    case LZ4:
+      return "LZ4";
+    case BitshuffleLZ4:
+      return "BitshuffleLZ4";
+    default:
+      return "None";
+    };
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  isAvailable
+
+  /*!
+    \param compression -- Compression stage of the pipeline.
+    \return available  -- Returns \e true if the filter for the compression
+            stage is available for encoding; the filter plugins are loaded from
+            \c HDF5_PLUGIN_PATH upon the first request.
+  */
+  bool HDF5FilterPipeline::isAvailable (Compression const &compression)
+  {
+    H5Z_filter_t filter;
+    htri_t available (0);
+
+    switch (compression) {
+    case None:
+      return true;
+    case Deflate:
+      filter = H5Z_FILTER_DEFLATE;
+      break;
+    case LZ4:
+      filter = DAL_H5Z_FILTER_LZ4;
+      break;
+    case BitshuffleLZ4:
+      filter = DAL_H5Z_FILTER_BITSHUFFLE;
+      break;
+    default:
+      return false;
+    };
+
+    H5E_BEGIN_TRY {
+      available = H5Zfilter_avail (filter);
+    } H5E_END_TRY;
+
+    if (available > 0 && filter == H5Z_FILTER_DEFLATE) {
+      unsigned int config (0);
+      H5Zget_filter_info (filter, &config);
+      return (config & H5Z_FILTER_CONFIG_ENCODE_ENABLED);
+    }
+
+    return (available > 0);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      filters
+
+  /*!
+    \param location -- Identifier of a dataset or of a dataset creation property
+           list.
+    \return filters -- Identifiers of the filters in the pipeline, in the order
+            in which they are applied upon writing.
+  */
+  std::vector<H5Z_filter_t> HDF5FilterPipeline::filters (hid_t const &location)
+  {
+    std::vector<H5Z_filter_t> result;
+    hid_t plist;
+
+    switch (H5Iget_type(location)) {
+    case H5I_DATASET:
+      plist = H5Dget_create_plist (location);
+      break;
+    case H5I_GENPROP_LST:
+      plist = H5Pcopy (location);
+      break;
+    default:
+      return result;
+    };
+
+    if (plist < 0) {
+      return result;
+    }
+
+    int nofFilters = H5Pget_nfilters (plist);
+    unsigned int flags;
+    size_t nofElements;
+    unsigned int filterConfig;
+    char filterName[64];
+
+    for (int n=0; n<nofFilters; ++n) {
+      nofElements = 0;
+      result.push_back (H5Pget_filter2 (plist,
+					n,
+					&flags,
+					&nofElements,
+					NULL,
+					sizeof(filterName),
+					filterName,
+					&filterConfig));
+    }
+
+    H5Pclose (plist);
+
+    return result;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     checksum
+
+  /*!
+    The data are summed as big-endian 16-bit words, with the sums folded after
+    at most 360 words to avoid an overflow, as done by the Fletcher32 filter of
+    the HDF5 library.
+
+    \param data     -- Data to compute the checksum for.
+    \param nofBytes -- Number of bytes of \e data.
+    \return sum     -- Fletcher32 checksum.
+  */
+  unsigned int HDF5FilterPipeline::checksum (void const *data,
+					     size_t const &nofBytes)
+  {
+    unsigned char const *p = static_cast<unsigned char const *>(data);
+    size_t length          = nofBytes/2;
+    unsigned int sum1      = 0;
+    unsigned int sum2      = 0;
+
+    while (length) {
+      size_t n = length > 360 ? 360 : length;
+      length  -= n;
+      do {
+	sum1 += (((unsigned int)p[0]) << 8) | ((unsigned int)p[1]);
+	p    += 2;
+	sum2 += sum1;
+      } while (--n);
+      sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+      sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+    }
+
+    /* Odd number of bytes */
+    if (nofBytes % 2) {
+      sum1 += ((unsigned int)p[0]) << 8;
+      sum2 += sum1;
+      sum1  = (sum1 & 0xffff) + (sum1 >> 16);
+      sum2  = (sum2 & 0xffff) + (sum2 >> 16);
+    }
+
+    sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+    sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+
+    return (sum2 << 16) | sum1;
+  }
+
+} // Namespace DAL -- end
@@ -0,0 +1,285 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef HDF5FILTERPIPELINE_H
+#define HDF5FILTERPIPELINE_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+#include <vector>
+
+// DAL header files
+#include <dal_config.h>
+
+//! Identifier of the LZ4 filter plugin, as registered with the HDF Group
+#define DAL_H5Z_FILTER_LZ4        32004
+//! Identifier of the bitshuffle filter plugin, as registered with the HDF Group
+#define DAL_H5Z_FILTER_BITSHUFFLE 32008
+
+/* Direct chunk writes are part of the core library as of HDF5 1.10.2 */
+#if (H5_VERS_MAJOR > 1) || \
+  (H5_VERS_MAJOR == 1 && H5_VERS_MINOR > 10) || \
+  (H5_VERS_MAJOR == 1 && H5_VERS_MINOR == 10 && H5_VERS_RELEASE >= 2)
+#define DAL_HDF5_DIRECT_CHUNK_WRITE
+#endif
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class HDF5FilterPipeline
+
+    \ingroup DAL
+    \ingroup core
+
+    \brief Filters applied to the chunks of a dataset upon writing
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tHDF5FilterPipeline.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::HDF5Dataset
+      <li>HDF5 filter plugins (optional) --
+      <a href="https://github.com/nexusformat/HDF5-External-Filter-Plugins">LZ4</a>
+      and <a href="https://github.com/kiyo-masui/bitshuffle">bitshuffle</a>;
+      the HDF5 library loads these from the directory pointed to by
+      \c HDF5_PLUGIN_PATH.
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    The chunks of a dataset are passed through a pipeline of filters before
+    being written to disk (and through the same pipeline in reverse upon
+    reading). The pipeline is part of the dataset creation property list, so it
+    needs to be set up before the dataset is created; reading a filtered
+    dataset requires no further action.
+
+    The pipeline set up by this class consists of up to three stages:
+
+    <ol>
+      <li>\b Shuffle -- re-orders the bytes of the elements of a chunk, such
+      that the first bytes of all elements are followed by all second bytes,
+      etc. For noisy integer samples (e.g. the \c int16 TBB time-series) the
+      high bytes are mostly identical, which considerably improves the ratio
+      of the compression following this stage.
+      <li>\b Compression, one of
+      <ul>
+        <li>\e Deflate -- gzip compression, part of every HDF5 installation;
+	level 1 (fastest) to 9 (best compression).
+	<li>\e LZ4 -- very fast compression through the LZ4 filter plugin.
+	<li>\e BitshuffleLZ4 -- bit-level shuffle followed by LZ4 compression
+	through the bitshuffle plugin; this replaces the byte shuffle.
+      </ul>
+      If a filter plugin is not available, deflate is used instead.
+      <li>\b Fletcher32 -- checksum for each chunk, verified upon reading.
+    </ol>
+
+    <h3>Example(s)</h3>
+
+    <ol>
+      <li>Create a dataset with shuffle and deflate compression:
+      \code
+      DAL::HDF5Dataset dataset;
+
+      dataset.setFilters (DAL::HDF5FilterPipeline (DAL::HDF5FilterPipeline::Deflate, 1));
+      dataset.open (fileID, "Data", shape, chunksize, H5T_NATIVE_SHORT);
+      \endcode
+
+      <li>Check the filters of an existing dataset:
+      \code
+      std::vector<H5Z_filter_t> filters = DAL::HDF5FilterPipeline::filters (datasetID);
+      \endcode
+    </ol>
+
+    <h3>Encoding outside the library</h3>
+
+    Pipelines consisting of shuffle, deflate and Fletcher32 only (see
+    isEncodable()) can also be run by encode(), without calling into the HDF5
+    library; the result is identical to what the library would store, so it can
+    be handed to \c H5Dwrite_chunk directly. As encode() does not touch any
+    HDF5 object, several chunks can be encoded in parallel -- see
+    DAL::HDF5ChunkWriter.
+
+  */
+  class HDF5FilterPipeline {
+
+  public:
+
+    //! Compression stage of the pipeline
+    enum Compression {
+      //! No compression
+      None,
+      //! Deflate (gzip) compression
+      Deflate,
+      //! LZ4 compression (filter plugin)
+      LZ4,
+      //! Bitshuffle with LZ4 compression (filter plugin)
+      BitshuffleLZ4
+    };
+
+  private:
+
+    //! Compression stage of the pipeline
+    Compression itsCompression;
+    //! Compression level, used for deflate compression
+    unsigned int itsLevel;
+    //! Shuffle the bytes before compression?
+    bool itsShuffle;
+    //! Add Fletcher32 checksums?
+    bool itsFletcher32;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor, setting up an empty pipeline
+    HDF5FilterPipeline ();
+
+    //! Argumented constructor
+    HDF5FilterPipeline (Compression const &compression,
+			unsigned int const &level=4,
+			bool const &shuffle=true,
+			bool const &fletcher32=false);
+
+    //! Argumented constructor, reading the filters of a dataset
+    explicit HDF5FilterPipeline (hid_t const &location);
+
+    //! Copy constructor
+    HDF5FilterPipeline (HDF5FilterPipeline const &other);
+
+    // === Destruction ==========================================================
+
+    //! Destructor
+    ~HDF5FilterPipeline ();
+
+    // === Operators ============================================================
+
+    //! Overloading of the copy operator
+    HDF5FilterPipeline& operator= (HDF5FilterPipeline const &other);
+
+    // === Parameter access =====================================================
+
+    //! Get the compression stage of the pipeline
+    inline Compression compression () const {
+      return itsCompression;
+    }
+
+    //! Get the compression level
+    inline unsigned int level () const {
+      return itsLevel;
+    }
+
+    //! Set the compression stage of the pipeline
+    bool setCompression (Compression const &compression,
+			 unsigned int const &level=4);
+
+    //! Shuffle the bytes before compression?
+    inline bool shuffle () const {
+      return itsShuffle;
+    }
+
+    //! Enable/disable shuffling the bytes before compression
+    inline void setShuffle (bool const &shuffle) {
+      itsShuffle = shuffle;
+    }
+
+    //! Add Fletcher32 checksums?
+    inline bool fletcher32 () const {
+      return itsFletcher32;
+    }
+
+    //! Enable/disable Fletcher32 checksums
+    inline void setFletcher32 (bool const &fletcher32) {
+      itsFletcher32 = fletcher32;
+    }
+
+    //! Does the pipeline contain no filters at all?
+    inline bool isEmpty () const {
+      return (itsCompression == None && !itsShuffle && !itsFletcher32);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, HDF5FilterPipeline.
+    */
+    inline std::string className () const {
+      return "HDF5FilterPipeline";
+    }
+
+    // === Methods ==============================================================
+
+    //! Add the filters to a dataset creation property list
+    bool apply (hid_t const &plist) const;
+
+    //! Get the identifiers of the filters, in the order in which they are applied
+    std::vector<H5Z_filter_t> filterIDs () const;
+
+    //! Can the chunks be encoded by encode()?
+    bool isEncodable () const;
+
+    //! Run a chunk through the filters
+    bool encode (void const *chunk,
+		 size_t const &nofBytes,
+		 size_t const &typeSize,
+		 std::vector<char> &buffer) const;
+
+    // === Static methods =======================================================
+
+    //! Get the name of a compression stage
+    static std::string name (Compression const &compression);
+
+    //! Is the filter for a compression stage available?
+    static bool isAvailable (Compression const &compression);
+
+    //! Get the filters of a dataset or dataset creation property list
+    static std::vector<H5Z_filter_t> filters (hid_t const &location);
+
+    //! Fletcher32 checksum, as computed by the HDF5 library
+    static unsigned int checksum (void const *data,
+				  size_t const &nofBytes);
+
+  private:
+
+    //! Initialize the object's internal parameters
+    void init ();
+
+    //! Unconditional copying
+    void copy (HDF5FilterPipeline const &other);
+
+  }; // Class HDF5FilterPipeline -- end
+
+} // Namespace DAL -- end
+
+#endif /* HDF5FILTERPIPELINE_H */
+
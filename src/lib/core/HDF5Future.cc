@@ -0,0 +1,239 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5Future.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                   HDF5Future
+
+  HDF5Future::HDF5Future ()
+  {
+    itsState = NULL;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   HDF5Future
+
+  /*!
+    \param status -- Status of the operation, as returned by wait().
+  */
+  HDF5Future::HDF5Future (bool const &status)
+  {
+    itsState = NULL;
+    *this    = pending ();
+    complete (status);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   HDF5Future
+
+  /*!
+    \param other -- Another HDF5Future object, referring to the request this
+           new one is supposed to refer to.
+  */
+  HDF5Future::HDF5Future (HDF5Future const &other)
+  {
+    itsState = NULL;
+    copy (other);
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  HDF5Future::~HDF5Future ()
+  {
+    destroy ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      destroy
+
+  void HDF5Future::destroy ()
+  {
+    if (itsState != NULL) {
+      bool last;
+
+      pthread_mutex_lock (&itsState->mutex);
+      last = (--itsState->nofReferences == 0);
+      pthread_mutex_unlock (&itsState->mutex);
+
+      if (last) {
+	pthread_cond_destroy (&itsState->done);
+	pthread_mutex_destroy (&itsState->mutex);
+	delete itsState;
+      }
+
+      itsState = NULL;
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Operators
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                    operator=
+
+  /*!
+    \param other -- Another HDF5Future object from which to make a copy.
+  */
+  HDF5Future& HDF5Future::operator= (HDF5Future const &other)
+  {
+    if (this != &other) {
+      destroy ();
+      copy (other);
+    }
+    return *this;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         copy
+
+  void HDF5Future::copy (HDF5Future const &other)
+  {
+    itsState = other.itsState;
+
+    if (itsState != NULL) {
+      pthread_mutex_lock (&itsState->mutex);
+      ++itsState->nofReferences;
+      pthread_mutex_unlock (&itsState->mutex);
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Parameter access
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                      isReady
+
+  /*!
+    \return ready -- Returns \e true once the request has been carried out;
+            returns \e false as long as it is pending, or if the future does
+            not refer to any request.
+  */
+  bool HDF5Future::isReady () const
+  {
+    bool ready (false);
+
+    if (itsState != NULL) {
+      pthread_mutex_lock (&itsState->mutex);
+      ready = itsState->ready;
+      pthread_mutex_unlock (&itsState->mutex);
+    }
+
+    return ready;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void HDF5Future::summary (std::ostream &os)
+  {
+    os << "[HDF5Future] Summary of internal parameters." << std::endl;
+    os << "-- Valid request  = " << isValid()            << std::endl;
+    os << "-- Ready          = " << isReady()            << std::endl;
+    if (isReady()) {
+      os << "-- Status         = " << wait()             << std::endl;
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                         wait
+
+  /*!
+    \return status -- Status of the operation; returns \e false in case an error
+            was encountered, or if the future does not refer to any request.
+  */
+  bool HDF5Future::wait () const
+  {
+    bool status (false);
+
+    if (itsState != NULL) {
+      pthread_mutex_lock (&itsState->mutex);
+      while (!itsState->ready) {
+	pthread_cond_wait (&itsState->done, &itsState->mutex);
+      }
+      status = itsState->status;
+      pthread_mutex_unlock (&itsState->mutex);
+    }
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      pending
+
+  HDF5Future HDF5Future::pending ()
+  {
+    HDF5Future future;
+
+    future.itsState = new State;
+    future.itsState->nofReferences = 1;
+    future.itsState->ready         = false;
+    future.itsState->status        = false;
+    pthread_mutex_init (&future.itsState->mutex, NULL);
+    pthread_cond_init (&future.itsState->done, NULL);
+
+    return future;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     complete
+
+  /*!
+    \param status -- Status of the operation, as returned by wait().
+  */
+  void HDF5Future::complete (bool const &status) const
+  {
+    if (itsState != NULL) {
+      pthread_mutex_lock (&itsState->mutex);
+      itsState->status = status;
+      itsState->ready  = true;
+      pthread_cond_broadcast (&itsState->done);
+      pthread_mutex_unlock (&itsState->mutex);
+    }
+  }
+
+} // Namespace DAL -- end
@@ -0,0 +1,173 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef HDF5FUTURE_H
+#define HDF5FUTURE_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+#include <pthread.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class HDF5Future
+
+    \ingroup DAL
+    \ingroup core
+
+    \brief Outcome of a read or write request serviced by the HDF5IOExecutor
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tHDF5IOExecutor.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::HDF5IOExecutor
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    A future is a handle to the completion state of a request handed to the
+    HDF5IOExecutor: isReady() tells whether the request has been carried out,
+    and wait() blocks until this is the case, returning the status of the
+    operation. Copies of a future refer to the same request, such that a
+    future can be handed on to another thread; the state is released with the
+    last copy.
+
+    A default constructed future does not refer to any request and is never
+    ready; a future constructed from a status refers to a request which was
+    completed right away, e.g. because it could not be submitted.
+
+    <h3>Example(s)</h3>
+
+    <ol>
+      <li>Overlap reading the next block with processing the current one:
+      \code
+      DAL::HDF5Future next = dataset.readDataAsync (buffer[1], start, block);
+
+      process (buffer[0]);
+
+      if (!next.wait()) {
+        std::cerr << "Failed to read block!" << std::endl;
+      }
+      \endcode
+    </ol>
+  */
+  class HDF5Future {
+
+    //! State shared by all copies of a future
+    struct State {
+      //! Mutex protecting the state
+      pthread_mutex_t mutex;
+      //! Condition signalled upon completion of the request
+      pthread_cond_t done;
+      //! Number of futures referring to the state
+      unsigned int nofReferences;
+      //! Has the request been carried out?
+      bool ready;
+      //! Status of the operation
+      bool status;
+    };
+
+    //! State of the request, shared with the executor
+    State *itsState;
+
+    friend class HDF5IOExecutor;
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor, not referring to any request
+    HDF5Future ();
+
+    //! Argumented constructor, for a request completed with given status
+    explicit HDF5Future (bool const &status);
+
+    //! Copy constructor, referring to the same request as \e other
+    HDF5Future (HDF5Future const &other);
+
+    // === Destruction ==========================================================
+
+    //! Destructor
+    ~HDF5Future ();
+
+    // === Operators ============================================================
+
+    //! Overloading of the copy operator
+    HDF5Future& operator= (HDF5Future const &other);
+
+    // === Parameter access =====================================================
+
+    //! Does the future refer to a request?
+    inline bool isValid () const {
+      return itsState != NULL;
+    }
+
+    //! Has the request been carried out?
+    bool isReady () const;
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, HDF5Future.
+    */
+    inline std::string className () const {
+      return "HDF5Future";
+    }
+
+    // === Methods ==============================================================
+
+    //! Wait for the request to be carried out
+    bool wait () const;
+
+  private:
+
+    //! Create the state for a request still to be carried out
+    static HDF5Future pending ();
+
+    //! Mark the request as carried out
+    void complete (bool const &status) const;
+
+    //! Unconditional copying
+    void copy (HDF5Future const &other);
+
+    //! Unconditional deletion
+    void destroy (void);
+
+  }; // Class HDF5Future -- end
+
+} // Namespace DAL -- end
+
+#endif /* HDF5FUTURE_H */
@@ -0,0 +1,679 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5IOExecutor.h>
+#include <core/HDF5Object.h>
+
+#include <cstdlib>
+
+namespace DAL { // Namespace DAL -- begin
+
+  //! Executor of the process, created by HDF5IOExecutor::instance()
+  static HDF5IOExecutor *theExecutor = NULL;
+  //! Guard for the creation of the executor
+  static pthread_once_t theExecutorOnce = PTHREAD_ONCE_INIT;
+  //! Lock serializing the calls into the HDF5 library
+  static pthread_mutex_t theLibraryMutex;
+  //! Guard for the initialization of the lock
+  static pthread_once_t theLibraryMutexOnce = PTHREAD_ONCE_INIT;
+
+  //! Initialize the lock serializing the calls into the HDF5 library
+  static void initLibraryMutex ()
+  {
+    pthread_mutexattr_t attributes;
+
+    pthread_mutexattr_init (&attributes);
+    pthread_mutexattr_settype (&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init (&theLibraryMutex, &attributes);
+    pthread_mutexattr_destroy (&attributes);
+  }
+
+  // ============================================================================
+  //
+  //  HDF5IOExecutor::Lock
+  //
+  // ============================================================================
+
+  HDF5IOExecutor::Lock::Lock ()
+  {
+    pthread_once (&theLibraryMutexOnce, initLibraryMutex);
+    pthread_mutex_lock (&theLibraryMutex);
+  }
+
+  HDF5IOExecutor::Lock::~Lock ()
+  {
+    pthread_mutex_unlock (&theLibraryMutex);
+  }
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                               HDF5IOExecutor
+
+  /*!
+    If the executor thread cannot be started, the requests are carried out
+    by the thread submitting them.
+  */
+  HDF5IOExecutor::HDF5IOExecutor ()
+  {
+    itsNofActive   = 0;
+    itsStop        = false;
+    itsMerge       = true;
+    itsNofRequests = 0;
+    itsNofCalls    = 0;
+
+    pthread_mutex_init (&itsMutex, NULL);
+    pthread_cond_init (&itsWork, NULL);
+    pthread_cond_init (&itsIdle, NULL);
+
+    itsRunning = (pthread_create (&itsThread, NULL, HDF5IOExecutor::run, this) == 0);
+
+    if (!itsRunning) {
+      std::cerr << "[HDF5IOExecutor] Failed to start executor thread -"
+		<< " carrying out requests synchronously!" << std::endl;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     instance
+
+  /*!
+    \return executor -- The executor of the process; it is created, and its
+            thread started, on the first call.
+  */
+  HDF5IOExecutor & HDF5IOExecutor::instance ()
+  {
+    pthread_once (&theExecutorOnce, HDF5IOExecutor::create);
+    return *theExecutor;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       create
+
+  void HDF5IOExecutor::create ()
+  {
+    theExecutor = new HDF5IOExecutor ();
+    /* Runs before the HDF5 library shuts down, which registered itself earlier */
+    std::atexit (HDF5IOExecutor::shutdown);
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  HDF5IOExecutor::~HDF5IOExecutor ()
+  {
+    if (itsRunning) {
+      pthread_mutex_lock (&itsMutex);
+      itsStop = true;
+      pthread_cond_broadcast (&itsWork);
+      pthread_mutex_unlock (&itsMutex);
+
+      pthread_join (itsThread, NULL);
+    }
+
+    pthread_cond_destroy (&itsIdle);
+    pthread_cond_destroy (&itsWork);
+    pthread_mutex_destroy (&itsMutex);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     shutdown
+
+  void HDF5IOExecutor::shutdown ()
+  {
+    delete theExecutor;
+    theExecutor = NULL;
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                     setMerge
+
+  /*!
+    \param doit -- Merge consecutive requests on adjacent blocks of a dataset
+           into a single call of \c H5Dread or \c H5Dwrite?
+  */
+  void HDF5IOExecutor::setMerge (bool const &doit)
+  {
+    pthread_mutex_lock (&itsMutex);
+    itsMerge = doit;
+    pthread_mutex_unlock (&itsMutex);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   nofPending
+
+  /*!
+    \return nofPending -- The number of requests submitted, but not yet carried
+            out.
+  */
+  unsigned int HDF5IOExecutor::nofPending ()
+  {
+    unsigned int nofPending;
+
+    pthread_mutex_lock (&itsMutex);
+    nofPending = itsQueue.size() + itsNofActive;
+    pthread_mutex_unlock (&itsMutex);
+
+    return nofPending;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void HDF5IOExecutor::summary (std::ostream &os)
+  {
+    os << "[HDF5IOExecutor] Summary of internal parameters." << std::endl;
+    os << "-- Executor thread running = " << itsRunning      << std::endl;
+    os << "-- Merge adjacent requests = " << itsMerge        << std::endl;
+    os << "-- nof. pending requests   = " << nofPending()    << std::endl;
+    os << "-- nof. requests           = " << itsNofRequests  << std::endl;
+    os << "-- nof. calls              = " << itsNofCalls     << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                         read
+
+  /*!
+    \param dataset  -- Identifier of the dataset to read from.
+    \param datatype -- Datatype of the elements in memory.
+    \param start    -- Offset of the block within the dataset.
+    \param block    -- Shape of the block, which also is the shape of the
+           \e buffer.
+    \retval buffer  -- Buffer receiving the data; it has to stay valid until
+           the request has been carried out.
+    \return future  -- Completion state of the request.
+  */
+  HDF5Future HDF5IOExecutor::read (hid_t const &dataset,
+				   hid_t const &datatype,
+				   std::vector<hsize_t> const &start,
+				   std::vector<hsize_t> const &block,
+				   void *buffer)
+  {
+    std::vector<hsize_t> stride;
+    std::vector<hsize_t> count;
+
+    return submit (Read, dataset, datatype, start, stride, count, block, buffer);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         read
+
+  /*!
+    \param dataset  -- Identifier of the dataset to read from.
+    \param datatype -- Datatype of the elements in memory.
+    \param start    -- Offset of the selection within the dataset.
+    \param stride   -- Distance between the blocks; may be left empty.
+    \param count    -- Number of blocks along each axis; may be left empty.
+    \param block    -- Shape of a block; may be left empty.
+    \retval buffer  -- Buffer receiving the data, of shape <tt>count*block</tt>;
+           it has to stay valid until the request has been carried out.
+    \return future  -- Completion state of the request.
+  */
+  HDF5Future HDF5IOExecutor::read (hid_t const &dataset,
+				   hid_t const &datatype,
+				   std::vector<hsize_t> const &start,
+				   std::vector<hsize_t> const &stride,
+				   std::vector<hsize_t> const &count,
+				   std::vector<hsize_t> const &block,
+				   void *buffer)
+  {
+    return submit (Read, dataset, datatype, start, stride, count, block, buffer);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        write
+
+  /*!
+    \param dataset  -- Identifier of the dataset to write to.
+    \param datatype -- Datatype of the elements in memory.
+    \param start    -- Offset of the block within the dataset.
+    \param block    -- Shape of the block, which also is the shape of the
+           \e buffer.
+    \param buffer   -- Data to be written; the buffer has to stay valid, and
+           unchanged, until the request has been carried out.
+    \return future  -- Completion state of the request.
+  */
+  HDF5Future HDF5IOExecutor::write (hid_t const &dataset,
+				    hid_t const &datatype,
+				    std::vector<hsize_t> const &start,
+				    std::vector<hsize_t> const &block,
+				    void const *buffer)
+  {
+    std::vector<hsize_t> stride;
+    std::vector<hsize_t> count;
+
+    return submit (Write, dataset, datatype, start, stride, count, block,
+		   const_cast<void *>(buffer));
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        write
+
+  /*!
+    \param dataset  -- Identifier of the dataset to write to.
+    \param datatype -- Datatype of the elements in memory.
+    \param start    -- Offset of the selection within the dataset.
+    \param stride   -- Distance between the blocks; may be left empty.
+    \param count    -- Number of blocks along each axis; may be left empty.
+    \param block    -- Shape of a block; may be left empty.
+    \param buffer   -- Data to be written, of shape <tt>count*block</tt>; the
+           buffer has to stay valid, and unchanged, until the request has been
+           carried out.
+    \return future  -- Completion state of the request.
+  */
+  HDF5Future HDF5IOExecutor::write (hid_t const &dataset,
+				    hid_t const &datatype,
+				    std::vector<hsize_t> const &start,
+				    std::vector<hsize_t> const &stride,
+				    std::vector<hsize_t> const &count,
+				    std::vector<hsize_t> const &block,
+				    void const *buffer)
+  {
+    return submit (Write, dataset, datatype, start, stride, count, block,
+		   const_cast<void *>(buffer));
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        flush
+
+  void HDF5IOExecutor::flush ()
+  {
+    pthread_mutex_lock (&itsMutex);
+    while (!itsQueue.empty() || itsNofActive > 0) {
+      pthread_cond_wait (&itsIdle, &itsMutex);
+    }
+    pthread_mutex_unlock (&itsMutex);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       submit
+
+  /*!
+    \return future -- Completion state of the request; if the request could not
+            be set up, e.g. because of an invalid dataset or a parameter
+            mismatch, the future is ready right away, with status \e false.
+  */
+  HDF5Future HDF5IOExecutor::submit (Operation const &operation,
+				     hid_t const &dataset,
+				     hid_t const &datatype,
+				     std::vector<hsize_t> const &start,
+				     std::vector<hsize_t> const &stride,
+				     std::vector<hsize_t> const &count,
+				     std::vector<hsize_t> const &block,
+				     void *buffer)
+  {
+    unsigned int rank = start.size();
+
+    if (buffer == NULL
+	|| rank == 0
+	|| (!stride.empty() && stride.size() != rank)
+	|| (!count.empty() && count.size() != rank)
+	|| (!block.empty() && block.size() != rank)) {
+      std::cerr << "[HDF5IOExecutor::submit] Inconsistent selection parameters!"
+		<< std::endl;
+      return HDF5Future (false);
+    }
+
+    Request *request = new Request;
+    std::vector<hsize_t> shape = memoryShape (count, block);
+    size_t typeSize (0);
+
+    request->operation = operation;
+    request->start     = start;
+    request->stride    = stride;
+    request->count     = count;
+    request->block     = block;
+    request->buffer    = static_cast<char *>(buffer);
+
+    {
+      Lock lock;
+
+      if (H5Iis_valid(dataset) > 0 && H5Iget_type(dataset) == H5I_DATASET) {
+	request->dataset  = HDF5Object::share (dataset);
+	request->datatype = H5Tcopy (datatype);
+	typeSize          = H5Tget_size (datatype);
+      } else {
+	request->dataset  = -1;
+	request->datatype = -1;
+      }
+    }
+
+    if (request->dataset < 0 || request->datatype < 0 || typeSize == 0) {
+      std::cerr << "[HDF5IOExecutor::submit] Invalid dataset or datatype!"
+		<< std::endl;
+      {
+	Lock lock;
+	HDF5Object::close (request->datatype);
+	HDF5Object::close (request->dataset);
+      }
+      delete request;
+      return HDF5Future (false);
+    }
+
+    request->nofBytes = typeSize;
+    for (unsigned int n=0; n<shape.size(); ++n) {
+      request->nofBytes *= shape[n];
+    }
+
+    request->future = HDF5Future::pending ();
+    HDF5Future future = request->future;
+
+    if (itsRunning) {
+      pthread_mutex_lock (&itsMutex);
+      itsQueue.push_back (request);
+      pthread_cond_signal (&itsWork);
+      pthread_mutex_unlock (&itsMutex);
+    } else {
+      std::vector<Request *> requests (1, request);
+      process (requests);
+    }
+
+    return future;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          run
+
+  /*!
+    All requests queued at the time the thread wakes up are taken over in one
+    go, such that consecutive requests can be merged.
+  */
+  void * HDF5IOExecutor::run (void *executor)
+  {
+    HDF5IOExecutor *self = static_cast<HDF5IOExecutor *>(executor);
+    std::vector<Request *> requests;
+
+    pthread_mutex_lock (&self->itsMutex);
+
+    while (true) {
+      while (self->itsQueue.empty() && !self->itsStop) {
+	pthread_cond_wait (&self->itsWork, &self->itsMutex);
+      }
+
+      if (self->itsQueue.empty()) {
+	/* Asked to stop, with all requests carried out */
+	break;
+      }
+
+      requests.assign (self->itsQueue.begin(), self->itsQueue.end());
+      self->itsQueue.clear();
+      self->itsNofActive = requests.size();
+
+      pthread_mutex_unlock (&self->itsMutex);
+      self->process (requests);
+      pthread_mutex_lock (&self->itsMutex);
+
+      self->itsNofActive = 0;
+      if (self->itsQueue.empty()) {
+	pthread_cond_broadcast (&self->itsIdle);
+      }
+    }
+
+    pthread_mutex_unlock (&self->itsMutex);
+
+    return NULL;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      process
+
+  /*!
+    \param requests -- Requests to be carried out, in the order of submission;
+           the requests are released once their futures have been completed.
+  */
+  void HDF5IOExecutor::process (std::vector<Request *> &requests)
+  {
+    unsigned int first (0);
+    unsigned int last (0);
+
+    while (first < requests.size()) {
+      std::vector<hsize_t> block = requests[first]->block;
+      bool status;
+
+      {
+	Lock lock;
+
+	/* Extend the block by the requests following on along the first axis */
+	last = first;
+	while (itsMerge
+	       && last+1 < requests.size()
+	       && mergeable (*requests[last], *requests[last+1])
+	       && H5Tequal (requests[first]->datatype, requests[last+1]->datatype) > 0) {
+	  ++last;
+	  block[0] += requests[last]->block[0];
+	}
+
+	status = execute (*requests[first], block);
+
+	for (unsigned int n=first; n<=last; ++n) {
+	  HDF5Object::close (requests[n]->datatype);
+	  HDF5Object::close (requests[n]->dataset);
+	}
+      }
+
+      ++itsNofCalls;
+      itsNofRequests += last-first+1;
+
+      for (unsigned int n=first; n<=last; ++n) {
+	requests[n]->future.complete (status);
+	delete requests[n];
+	requests[n] = NULL;
+      }
+
+      first = last+1;
+    }
+
+    requests.clear();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    mergeable
+
+  /*!
+    \param previous -- Request preceding \e next.
+    \param next     -- Request following on \e previous.
+    \return status  -- Returns \e true if both requests are of the same kind,
+            select a single block each from the same dataset, the block of
+            \e next directly follows the one of \e previous along the first
+            axis, and the buffer of \e next directly follows the one of
+            \e previous in memory. The datatypes are compared by the caller.
+  */
+  bool HDF5IOExecutor::mergeable (Request const &previous,
+				  Request const &next)
+  {
+    if (next.operation != previous.operation
+	|| next.dataset != previous.dataset
+	|| next.buffer != previous.buffer + previous.nofBytes
+	|| next.start.size() != previous.start.size()
+	|| next.block.size() != next.start.size()
+	|| previous.block.size() != previous.start.size()) {
+      return false;
+    }
+
+    for (unsigned int n=0; n<next.count.size(); ++n) {
+      if (next.count[n] != 1) return false;
+    }
+    for (unsigned int n=0; n<previous.count.size(); ++n) {
+      if (previous.count[n] != 1) return false;
+    }
+
+    if (next.start[0] != previous.start[0] + previous.block[0]) {
+      return false;
+    }
+
+    for (unsigned int n=1; n<next.start.size(); ++n) {
+      if (next.start[n] != previous.start[n] || next.block[n] != previous.block[n]) {
+	return false;
+      }
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      execute
+
+  /*!
+    \param request -- Request to be carried out; the caller holds the lock.
+    \param block   -- Shape of the block, replacing the one of the request.
+    \return status -- Status of the operation; returns \e false in case an
+            error was encountered.
+  */
+  bool HDF5IOExecutor::execute (Request const &request,
+				std::vector<hsize_t> const &block)
+  {
+    unsigned int rank = request.start.size();
+    std::vector<hsize_t> count (request.count);
+    std::vector<hsize_t> shape = memoryShape (request.count, block);
+    hid_t filespace = H5Dget_space (request.dataset);
+    herr_t h5error;
+
+    if (filespace < 0 || H5Sget_simple_extent_ndims(filespace) != int(rank)) {
+      std::cerr << "[HDF5IOExecutor::execute] Rank of selection does not match"
+		<< " dataset!" << std::endl;
+      HDF5Object::close (filespace);
+      return false;
+    }
+
+    if (count.empty()) {
+      count.assign (rank, 1);
+    }
+
+    /* Extend the dataset, if writing beyond its current extent */
+    if (request.operation == Write) {
+      std::vector<hsize_t> dims (rank);
+      std::vector<hsize_t> extent (rank);
+      bool extend (false);
+
+      H5Sget_simple_extent_dims (filespace, &dims[0], NULL);
+
+      for (unsigned int n=0; n<rank; ++n) {
+	hsize_t b = block.empty()          ? 1 : block[n];
+	hsize_t s = request.stride.empty() ? b : request.stride[n];
+	extent[n] = request.start[n] + (count[n]-1)*s + b;
+	if (extent[n] > dims[n]) {
+	  extend = true;
+	} else {
+	  extent[n] = dims[n];
+	}
+      }
+
+      if (extend) {
+	HDF5Object::close (filespace);
+	if (H5Dset_extent (request.dataset, &extent[0]) < 0) {
+	  std::cerr << "[HDF5IOExecutor::execute] Error extending dataset!"
+		    << std::endl;
+	  return false;
+	}
+	filespace = H5Dget_space (request.dataset);
+      }
+    }
+
+    h5error = H5Sselect_hyperslab (filespace,
+				   H5S_SELECT_SET,
+				   &request.start[0],
+				   request.stride.empty() ? NULL : &request.stride[0],
+				   &count[0],
+				   block.empty() ? NULL : &block[0]);
+
+    if (h5error < 0) {
+      std::cerr << "[HDF5IOExecutor::execute] Error selecting hyperslab!"
+		<< std::endl;
+      HDF5Object::close (filespace);
+      return false;
+    }
+
+    hid_t memspace = H5Screate_simple (rank, &shape[0], NULL);
+
+    if (request.operation == Read) {
+      h5error = H5Dread (request.dataset,
+			 request.datatype,
+			 memspace,
+			 filespace,
+			 H5P_DEFAULT,
+			 request.buffer);
+    } else {
+      h5error = H5Dwrite (request.dataset,
+			  request.datatype,
+			  memspace,
+			  filespace,
+			  H5P_DEFAULT,
+			  request.buffer);
+    }
+
+    HDF5Object::close (memspace);
+    HDF5Object::close (filespace);
+
+    if (h5error < 0) {
+      std::cerr << "[HDF5IOExecutor::execute] Error "
+		<< (request.operation == Read ? "reading from" : "writing to")
+		<< " dataset!" << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  memoryShape
+
+  /*!
+    \param count  -- Number of blocks along each axis; may be empty.
+    \param block  -- Shape of a block; may be empty.
+    \return shape -- Shape of the memory buffer holding the selection, i.e.
+            <tt>count*block</tt>, where an empty parameter counts as one.
+  */
+  std::vector<hsize_t> HDF5IOExecutor::memoryShape (std::vector<hsize_t> const &count,
+						    std::vector<hsize_t> const &block)
+  {
+    unsigned int rank = count.empty() ? block.size() : count.size();
+    std::vector<hsize_t> shape (rank, 1);
+
+    for (unsigned int n=0; n<rank; ++n) {
+      if (!count.empty()) shape[n] *= count[n];
+      if (!block.empty()) shape[n] *= block[n];
+    }
+
+    return shape;
+  }
+
+} // Namespace DAL -- end
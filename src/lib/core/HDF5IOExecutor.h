@@ -0,0 +1,344 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef HDF5IOEXECUTOR_H
+#define HDF5IOEXECUTOR_H
+
+// Standard library header files
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+// DAL header files
+#include <core/dalCommon.h>
+#include <core/HDF5Future.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class HDF5IOExecutor
+
+    \ingroup DAL
+    \ingroup core
+
+    \brief Thread carrying out read and write requests on HDF5 datasets
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tHDF5IOExecutor.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::HDF5Future
+      <li>DAL::HDF5Dataset
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    The HDF5 library is not necessarily thread-safe, such that every read or
+    write blocks the thread issuing it. The executor instead takes over the
+    requests -- a hyperslab selection of a dataset and the buffer to read
+    into or write from -- and carries them out on a thread of its own, in the
+    order of submission; the caller receives an HDF5Future to wait for.
+    Requests are normally submitted through HDF5Dataset::readDataAsync() and
+    HDF5Dataset::writeDataAsync() rather than directly.
+
+    There is a single executor per process (see instance()), which is started
+    on first use and stopped at exit, after the requests still pending have
+    been carried out.
+
+    Consecutive requests of the same kind on the same dataset are merged into
+    a single call of \c H5Dread or \c H5Dwrite, if they select adjacent blocks
+    along the first axis of the dataset and their buffers follow each other
+    in memory -- e.g. when a dataset is read block by block into one large
+    array.
+
+    Calls into the library from other threads must not overlap with those of
+    the executor. All calls made by the executor, as well as the reading and
+    writing by HDF5Dataset, hold the lock provided by HDF5IOExecutor::Lock;
+    applications making other calls into the library while requests are in
+    flight -- opening datasets, reading attributes -- wrap them in a Lock as
+    well, rather than in a mutex of their own:
+    \code
+    {
+      DAL::HDF5IOExecutor::Lock lock;
+      DAL::HDF5Attribute::read (location, "NOF_DIPOLES", nofDipoles);
+    }
+    \endcode
+    The lock may be taken recursively, but must not be held while waiting
+    for a future or calling flush().
+
+    A few constraints apply:
+    <ul>
+      <li>The buffer of a request has to stay valid, and must not be accessed
+      by the caller, until the request has been carried out.
+      <li>The identifier of the dataset is shared with the request (see
+      HDF5Object::share), such that the dataset object may be closed before
+      the request has been carried out.
+      <li>Datasets are extended by write requests beyond their current
+      extent, as far as the maximum dimensions allow.
+    </ul>
+
+    <h3>Example(s)</h3>
+
+    <ol>
+      <li>Read a 1-dimensional dataset in blocks, waiting for them at the end:
+      \code
+      std::vector<DAL::HDF5Future> futures;
+      std::vector<hsize_t> start (1);
+      std::vector<hsize_t> block (1, 1024);
+
+      for (start[0]=0; start[0]<nofSamples; start[0]+=block[0]) {
+        futures.push_back (DAL::HDF5IOExecutor::instance().read (datasetID,
+                                                                 H5T_NATIVE_SHORT,
+                                                                 start,
+                                                                 block,
+                                                                 data+start[0]));
+      }
+
+      for (unsigned int n=0; n<futures.size(); ++n) {
+        futures[n].wait();
+      }
+      \endcode
+    </ol>
+  */
+  class HDF5IOExecutor {
+
+  public:
+
+    //! Kind of a request
+    enum Operation {
+      //! Read from a dataset
+      Read,
+      //! Write to a dataset
+      Write
+    };
+
+    /*!
+      \brief Scoped lock for calls into the HDF5 library
+
+      Holds the lock of the executor from construction to destruction; the
+      executor does not make any call into the library in the meantime.
+    */
+    class Lock {
+    public:
+      //! Acquire the lock
+      Lock ();
+      //! Release the lock
+      ~Lock ();
+    private:
+      //! Disabled copy constructor
+      Lock (Lock const &other);
+      //! Disabled assignment operator
+      Lock& operator= (Lock const &other);
+    };
+
+  private:
+
+    //! A read or write request
+    struct Request {
+      //! Kind of the request
+      Operation operation;
+      //! Identifier of the dataset, shared with the caller
+      hid_t dataset;
+      //! Datatype of the elements in memory, copied from the caller
+      hid_t datatype;
+      //! Offset of the selection
+      std::vector<hsize_t> start;
+      //! Stride of the selection; empty for contiguous blocks
+      std::vector<hsize_t> stride;
+      //! Number of blocks; empty for a single block
+      std::vector<hsize_t> count;
+      //! Shape of a block
+      std::vector<hsize_t> block;
+      //! Buffer to read into or write from
+      char *buffer;
+      //! Size of the buffer, [Bytes]
+      size_t nofBytes;
+      //! Completion state handed to the caller
+      HDF5Future future;
+    };
+
+    //! Executor thread
+    pthread_t itsThread;
+    //! Has the executor thread been started?
+    bool itsRunning;
+    //! Requests pending, in the order of submission
+    std::deque<Request *> itsQueue;
+    //! Mutex protecting the queue
+    pthread_mutex_t itsMutex;
+    //! Condition signalled when a request is submitted
+    pthread_cond_t itsWork;
+    //! Condition signalled when the queue has been worked off
+    pthread_cond_t itsIdle;
+    //! Number of requests taken from the queue, but not yet carried out
+    unsigned int itsNofActive;
+    //! Is the executor thread supposed to stop?
+    bool itsStop;
+    //! Merge adjacent requests?
+    bool itsMerge;
+    //! Number of requests carried out
+    unsigned long itsNofRequests;
+    //! Number of calls of H5Dread and H5Dwrite made for them
+    unsigned long itsNofCalls;
+
+    //! Disabled copy constructor
+    HDF5IOExecutor (HDF5IOExecutor const &other);
+    //! Disabled assignment operator
+    HDF5IOExecutor& operator= (HDF5IOExecutor const &other);
+
+    // === Construction =========================================================
+
+    //! Default constructor, starting the executor thread
+    HDF5IOExecutor ();
+
+    // === Destruction ==========================================================
+
+    //! Destructor, carrying out the pending requests and stopping the thread
+    ~HDF5IOExecutor ();
+
+  public:
+
+    //! Get the executor of the process, starting it on first use
+    static HDF5IOExecutor & instance ();
+
+    // === Parameter access =====================================================
+
+    //! Merge adjacent requests?
+    inline bool merge () const {
+      return itsMerge;
+    }
+
+    //! Merge adjacent requests?
+    void setMerge (bool const &doit=true);
+
+    //! Get the number of requests not yet carried out
+    unsigned int nofPending ();
+
+    //! Get the number of requests carried out
+    inline unsigned long nofRequests () const {
+      return itsNofRequests;
+    }
+
+    //! Get the number of calls of H5Dread and H5Dwrite made for the requests
+    inline unsigned long nofCalls () const {
+      return itsNofCalls;
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, HDF5IOExecutor.
+    */
+    inline std::string className () const {
+      return "HDF5IOExecutor";
+    }
+
+    // === Methods ==============================================================
+
+    //! Submit a request to read a selection of a dataset
+    HDF5Future read (hid_t const &dataset,
+		     hid_t const &datatype,
+		     std::vector<hsize_t> const &start,
+		     std::vector<hsize_t> const &block,
+		     void *buffer);
+
+    //! Submit a request to read a selection of a dataset
+    HDF5Future read (hid_t const &dataset,
+		     hid_t const &datatype,
+		     std::vector<hsize_t> const &start,
+		     std::vector<hsize_t> const &stride,
+		     std::vector<hsize_t> const &count,
+		     std::vector<hsize_t> const &block,
+		     void *buffer);
+
+    //! Submit a request to write a selection of a dataset
+    HDF5Future write (hid_t const &dataset,
+		      hid_t const &datatype,
+		      std::vector<hsize_t> const &start,
+		      std::vector<hsize_t> const &block,
+		      void const *buffer);
+
+    //! Submit a request to write a selection of a dataset
+    HDF5Future write (hid_t const &dataset,
+		      hid_t const &datatype,
+		      std::vector<hsize_t> const &start,
+		      std::vector<hsize_t> const &stride,
+		      std::vector<hsize_t> const &count,
+		      std::vector<hsize_t> const &block,
+		      void const *buffer);
+
+    //! Wait until all requests submitted so far have been carried out
+    void flush ();
+
+  private:
+
+    //! Set up a request and hand it to the executor thread
+    HDF5Future submit (Operation const &operation,
+		       hid_t const &dataset,
+		       hid_t const &datatype,
+		       std::vector<hsize_t> const &start,
+		       std::vector<hsize_t> const &stride,
+		       std::vector<hsize_t> const &count,
+		       std::vector<hsize_t> const &block,
+		       void *buffer);
+
+    //! Main loop of the executor thread
+    static void * run (void *executor);
+
+    //! Carry out a request, merged with the ones following it
+    void process (std::vector<Request *> &requests);
+
+    //! Can request \e next be merged with the preceding request \e previous?
+    static bool mergeable (Request const &previous,
+			   Request const &next);
+
+    //! Carry out a request, for a block of given shape
+    static bool execute (Request const &request,
+			 std::vector<hsize_t> const &block);
+
+    //! Shape of the memory buffer of a selection
+    static std::vector<hsize_t> memoryShape (std::vector<hsize_t> const &count,
+					     std::vector<hsize_t> const &block);
+
+    //! Create the executor of the process
+    static void create ();
+
+    //! Stop the executor of the process
+    static void shutdown ();
+
+  }; // Class HDF5IOExecutor -- end
+
+} // Namespace DAL -- end
+
+#endif /* HDF5IOEXECUTOR_H */
@@ -0,0 +1,581 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5MappedView.h>
+#include <core/HDF5Object.h>
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                               HDF5MappedView
+
+  HDF5MappedView::HDF5MappedView ()
+  {
+    init ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                               HDF5MappedView
+
+  /*!
+    \param dataset  -- Identifier of the dataset to view.
+    \param datatype -- Datatype of the elements in memory.
+  */
+  HDF5MappedView::HDF5MappedView (hid_t const &dataset,
+				  hid_t const &datatype)
+  {
+    init ();
+    open (dataset, datatype);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         init
+
+  void HDF5MappedView::init ()
+  {
+    itsDataset      = -1;
+    itsDatatype     = -1;
+    itsTypeSize     = 0;
+    itsMapped       = false;
+    itsMapping      = 0;
+    itsMappingBytes = 0;
+    itsFirst        = 0;
+    itsFirstIndex   = 0;
+    itsDatasetShape.clear();
+    itsStart.clear();
+    itsStride.clear();
+    itsCount.clear();
+    itsBlock.clear();
+    itsShape.clear();
+    itsBuffer.clear();
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  HDF5MappedView::~HDF5MappedView ()
+  {
+    close ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        close
+
+  void HDF5MappedView::close ()
+  {
+    if (itsMapping != 0) {
+      munmap (itsMapping, itsMappingBytes);
+    }
+
+    if (H5Iis_valid(itsDatatype)) {
+      H5Tclose (itsDatatype);
+    }
+
+    init ();
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                nofDatapoints
+
+  hsize_t HDF5MappedView::nofDatapoints () const
+  {
+    if (itsShape.empty()) {
+      return 0;
+    }
+
+    hsize_t nelem = 1;
+
+    for (unsigned int n=0; n<itsShape.size(); ++n) {
+      nelem *= itsShape[n];
+    }
+
+    return nelem;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 isContiguous
+
+  /*!
+    \return contiguous -- Returns \e true if the selected elements are stored
+            next to each other, such that they can be accessed as an array
+            through data(); this always is the case if the selection has been
+            read into a buffer.
+  */
+  bool HDF5MappedView::isContiguous () const
+  {
+    hsize_t nelem = nofDatapoints();
+
+    if (nelem == 0) {
+      return false;
+    }
+
+    if (!itsMapped) {
+      return true;
+    }
+
+    for (unsigned int n=0; n<itsShape.size(); ++n) {
+      if (itsCount[n] > 1 && itsStride[n] != itsBlock[n]) {
+	return false;
+      }
+    }
+
+    return position(nelem-1) - position(0) + 1 == nelem;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void HDF5MappedView::summary (std::ostream &os)
+  {
+    os << "[HDF5MappedView] Summary of internal parameters." << std::endl;
+    os << "-- Dataset ID           = " << itsDataset      << std::endl;
+    os << "-- Dataset shape        = " << itsDatasetShape << std::endl;
+    os << "-- Element size [Bytes] = " << itsTypeSize     << std::endl;
+    os << "-- Selection start      = " << itsStart        << std::endl;
+    os << "-- Selection stride     = " << itsStride       << std::endl;
+    os << "-- Selection count      = " << itsCount        << std::endl;
+    os << "-- Selection block      = " << itsBlock        << std::endl;
+    os << "-- Selection shape      = " << itsShape        << std::endl;
+    os << "-- Mapped from file     = " << itsMapped       << std::endl;
+    os << "-- Mapped size [Bytes]  = " << itsMappingBytes << std::endl;
+    os << "-- Buffer size [Bytes]  = " << itsBuffer.size() << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                         open
+
+  /*!
+    \param dataset  -- Identifier of the dataset to view.
+    \param datatype -- Datatype of the elements in memory.
+    \return status  -- Returns \e false if the dataset could neither be mapped
+            nor read.
+  */
+  bool HDF5MappedView::open (hid_t const &dataset,
+			     hid_t const &datatype)
+  {
+    if (!attach (dataset, datatype)) {
+      return false;
+    }
+
+    /* Select the complete dataset */
+    unsigned int rank = itsDatasetShape.size();
+    std::vector<int> start (rank, 0);
+    std::vector<int> block (rank);
+
+    for (unsigned int n=0; n<rank; ++n) {
+      block[n] = itsDatasetShape[n];
+    }
+
+    return setSelection (HDF5Hyperslab (start, block));
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         open
+
+  /*!
+    Unlike open() followed by setSelection(), this does not map or read the
+    complete dataset first.
+
+    \param dataset  -- Identifier of the dataset to view.
+    \param datatype -- Datatype of the elements in memory.
+    \param slab     -- Hyperslab selecting the elements viewed.
+    \return status  -- Returns \e false if the selection does not fit into the
+            dataset, or if it could neither be mapped nor read.
+  */
+  bool HDF5MappedView::open (hid_t const &dataset,
+			     hid_t const &datatype,
+			     HDF5Hyperslab const &slab)
+  {
+    return attach (dataset, datatype) && setSelection (slab);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       attach
+
+  /*!
+    \param dataset  -- Identifier of the dataset to view.
+    \param datatype -- Datatype of the elements in memory.
+    \return status  -- Returns \e false if \e dataset does not point to a
+            dataset with at least one axis.
+  */
+  bool HDF5MappedView::attach (hid_t const &dataset,
+			       hid_t const &datatype)
+  {
+    close ();
+
+    if (HDF5Object::objectType(dataset) != H5I_DATASET) {
+      std::cerr << "[HDF5MappedView::open] Object identifier does not point to"
+		<< " a dataset!" << std::endl;
+      return false;
+    }
+
+    /* Shape of the dataset */
+    hid_t dataspace = H5Dget_space (dataset);
+    int rank        = H5Sget_simple_extent_ndims (dataspace);
+
+    if (rank < 1) {
+      std::cerr << "[HDF5MappedView::open] Dataset without axes!" << std::endl;
+      H5Sclose (dataspace);
+      return false;
+    }
+
+    itsDatasetShape.resize (rank);
+    H5Sget_simple_extent_dims (dataspace, &itsDatasetShape[0], NULL);
+    H5Sclose (dataspace);
+
+    itsDataset  = dataset;
+    itsDatatype = H5Tcopy (datatype);
+    itsTypeSize = H5Tget_size (itsDatatype);
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 setSelection
+
+  /*!
+    \param slab    -- Hyperslab selecting the elements viewed; as with
+           HDF5Dataset::readData(), missing stride, count and block parameters
+           default to 1.
+    \return status -- Returns \e false if the selection does not fit into the
+            dataset, or if it could neither be mapped nor read.
+  */
+  bool HDF5MappedView::setSelection (HDF5Hyperslab const &slab)
+  {
+    unsigned int rank       = itsDatasetShape.size();
+    std::vector<int> start  = slab.start();
+    std::vector<int> stride = slab.stride();
+    std::vector<int> count  = slab.count();
+    std::vector<int> block  = slab.block();
+
+    if (rank == 0 || start.size() != rank) {
+      std::cerr << "[HDF5MappedView::setSelection] Parameter mismatch: start - shape."
+		<< std::endl;
+      return false;
+    }
+
+    if (stride.size() != rank) {
+      stride = std::vector<int> (rank, 1);
+    }
+    if (count.size() != rank) {
+      count = std::vector<int> (rank, 1);
+    }
+    if (block.size() != rank) {
+      block = std::vector<int> (rank, 1);
+    }
+
+    /* Check the selection against the shape of the dataset */
+    for (unsigned int n=0; n<rank; ++n) {
+      if (start[n] < 0 || count[n] < 1 || block[n] < 1
+	  || (count[n] > 1 && stride[n] < block[n])
+	  || hsize_t(start[n] + (count[n]-1)*stride[n] + block[n]) > itsDatasetShape[n]) {
+	std::cerr << "[HDF5MappedView::setSelection] Invalid selection along axis "
+		  << n << " of dataset of shape " << itsDatasetShape << std::endl;
+	return false;
+      }
+    }
+
+    /* Release the previous selection */
+    if (itsMapping != 0) {
+      munmap (itsMapping, itsMappingBytes);
+    }
+    itsMapped       = false;
+    itsMapping      = 0;
+    itsMappingBytes = 0;
+    itsFirst        = 0;
+    itsBuffer.clear();
+
+    /* Store the selection */
+    itsStart.resize (rank);
+    itsStride.resize (rank);
+    itsCount.resize (rank);
+    itsBlock.resize (rank);
+    itsShape.resize (rank);
+
+    for (unsigned int n=0; n<rank; ++n) {
+      itsStart[n]  = start[n];
+      itsStride[n] = stride[n];
+      itsCount[n]  = count[n];
+      itsBlock[n]  = block[n];
+      itsShape[n]  = itsCount[n]*itsBlock[n];
+    }
+    itsFirstIndex = position (0);
+
+    if (isMappable (itsDataset, itsDatatype) && map()) {
+      return true;
+    }
+
+    return read ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      address
+
+  /*!
+    \param index    -- Index of the element within the selection, in row-major
+           order.
+    \return address -- Address of the element; \c NULL if the index lies
+            outside the selection.
+  */
+  void const * HDF5MappedView::address (hsize_t const &index) const
+  {
+    if (index >= nofDatapoints()) {
+      return NULL;
+    }
+
+    if (itsMapped) {
+      return itsFirst + (position(index) - itsFirstIndex)*itsTypeSize;
+    } else {
+      return &itsBuffer[index*itsTypeSize];
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     position
+
+  /*!
+    \param index     -- Index of the element within the selection.
+    \return position -- Index of the element within the dataset, both in
+            row-major order.
+  */
+  hsize_t HDF5MappedView::position (hsize_t const &index) const
+  {
+    hsize_t rest   = index;
+    hsize_t pos    = 0;
+    hsize_t factor = 1;
+
+    for (int n=itsShape.size()-1; n>=0; --n) {
+      hsize_t i     = rest%itsShape[n];
+      hsize_t coord = itsStart[n] + (i/itsBlock[n])*itsStride[n] + i%itsBlock[n];
+      rest   /= itsShape[n];
+      pos    += coord*factor;
+      factor *= itsDatasetShape[n];
+    }
+
+    return pos;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          map
+
+  /*!
+    \return status -- Returns \e false if the file could not be mapped, in
+            which case the selection is to be read instead.
+  */
+  bool HDF5MappedView::map ()
+  {
+    haddr_t offset = H5Dget_offset (itsDataset);
+    hid_t fileID   = H5Iget_file_id (itsDataset);
+    unsigned intent;
+
+    /* Data still cached by the library have to be on disk */
+    if (H5Fget_intent (fileID, &intent) >= 0 && (intent & H5F_ACC_RDWR)) {
+      H5Fflush (fileID, H5F_SCOPE_LOCAL);
+    }
+
+    std::string filename = HDF5Object::name (fileID);
+    H5Fclose (fileID);
+
+    /* Region of the file covering the selection, starting at a page boundary */
+    hsize_t last     = position (nofDatapoints()-1);
+    off_t firstByte  = offset + itsFirstIndex*itsTypeSize;
+    off_t endByte    = offset + (last+1)*itsTypeSize;
+    off_t pageSize   = sysconf (_SC_PAGESIZE);
+    off_t mapStart   = firstByte - firstByte%pageSize;
+    size_t mapBytes  = endByte - mapStart;
+
+    int fd = ::open (filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+
+    void *mapping = mmap (NULL, mapBytes, PROT_READ, MAP_SHARED, fd, mapStart);
+    ::close (fd);
+
+    if (mapping == MAP_FAILED) {
+      return false;
+    }
+
+    itsMapped       = true;
+    itsMapping      = mapping;
+    itsMappingBytes = mapBytes;
+    itsFirst        = static_cast<char const *>(mapping) + (firstByte - mapStart);
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         read
+
+  /*!
+    \return status -- Returns \e false if the selection could not be read.
+  */
+  bool HDF5MappedView::read ()
+  {
+    int rank          = itsShape.size();
+    hid_t fileSpace   = H5Dget_space (itsDataset);
+    hid_t memorySpace = H5Screate_simple (rank, &itsShape[0], NULL);
+    herr_t h5error    = H5Sselect_hyperslab (fileSpace,
+					     H5S_SELECT_SET,
+					     &itsStart[0],
+					     &itsStride[0],
+					     &itsCount[0],
+					     &itsBlock[0]);
+
+    itsBuffer.resize (nofDatapoints()*itsTypeSize);
+
+    if (h5error >= 0) {
+      h5error = H5Dread (itsDataset,
+			 itsDatatype,
+			 memorySpace,
+			 fileSpace,
+			 H5P_DEFAULT,
+			 &itsBuffer[0]);
+    }
+
+    H5Sclose (memorySpace);
+    H5Sclose (fileSpace);
+
+    if (h5error < 0) {
+      std::cerr << "[HDF5MappedView::read] Failed to read selection!" << std::endl;
+      itsBuffer.clear();
+      itsShape.clear();
+      return false;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     copyData
+
+  /*!
+    \param data    -- Array to which the selected elements are copied.
+    \return status -- Returns \e false if there is no selection.
+  */
+  bool HDF5MappedView::copyData (void *data) const
+  {
+    hsize_t nelem = nofDatapoints();
+    char *target  = static_cast<char *>(data);
+
+    if (nelem == 0) {
+      return false;
+    }
+
+    if (!itsMapped) {
+      memcpy (target, &itsBuffer[0], itsBuffer.size());
+      return true;
+    }
+
+    /* Copy the runs of elements along the last axis */
+    int last    = itsShape.size()-1;
+    hsize_t run = itsCount[last] == 1 || itsStride[last] == itsBlock[last]
+      ? itsShape[last] : itsBlock[last];
+
+    for (hsize_t n=0; n<nelem; n+=run) {
+      memcpy (target + n*itsTypeSize, address(n), run*itsTypeSize);
+    }
+
+    return true;
+  }
+
+  // ============================================================================
+  //
+  //  Static methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                   isMappable
+
+  /*!
+    \param dataset  -- Identifier of the dataset.
+    \param datatype -- Datatype of the elements in memory.
+    \return mappable -- Returns \e true if the raw data of the dataset are
+            stored contiguously, without conversion, in a single file.
+  */
+  bool HDF5MappedView::isMappable (hid_t const &dataset,
+				   hid_t const &datatype)
+  {
+    if (HDF5Object::objectType(dataset) != H5I_DATASET) {
+      return false;
+    }
+
+    /* Contiguous layout within the file */
+    hid_t plist         = H5Dget_create_plist (dataset);
+    H5D_layout_t layout = H5Pget_layout (plist);
+    int nofExternal     = H5Pget_external_count (plist);
+    H5Pclose (plist);
+
+    if (layout != H5D_CONTIGUOUS
+	|| nofExternal > 0
+	|| H5Dget_offset (dataset) == HADDR_UNDEF) {
+      return false;
+    }
+
+    /* No conversion of the elements */
+    hid_t filetype = H5Dget_type (dataset);
+    htri_t equal   = H5Tequal (filetype, datatype);
+    H5Tclose (filetype);
+
+    if (equal <= 0) {
+      return false;
+    }
+
+    /* Addresses are offsets within a single file */
+    hid_t fileID = H5Iget_file_id (dataset);
+    hid_t fapl   = H5Fget_access_plist (fileID);
+    hid_t driver = H5Pget_driver (fapl);
+    H5Pclose (fapl);
+    H5Fclose (fileID);
+
+    return driver == H5FD_SEC2;
+  }
+
+} // Namespace DAL -- end
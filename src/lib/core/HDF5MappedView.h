@@ -0,0 +1,305 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef HDF5MAPPEDVIEW_H
+#define HDF5MAPPEDVIEW_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+#include <vector>
+
+// DAL header files
+#include <core/HDF5Hyperslab.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class HDF5MappedView
+
+    \ingroup DAL
+    \ingroup core
+
+    \brief Read-only view on a selection of a dataset, mapped from the file
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tHDF5MappedView.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::HDF5Dataset
+      <li>DAL::HDF5Hyperslab
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    The raw data of a dataset with contiguous layout are stored as a single
+    block within the file, starting at the address returned by
+    HDF5Dataset::offset(). If, in addition, the elements are stored in the
+    representation they have in memory, the data can be accessed by mapping
+    that part of the file into memory, rather than copying them through the
+    buffers of the HDF5 library -- which e.g. saves a copy for each sample
+    when scanning complete TBB dipole datasets.
+
+    This class maps the part of the file covering a selection of a dataset;
+    the selection is specified by a DAL::HDF5Hyperslab, with the same
+    semantics as for HDF5Dataset::readData(): along each axis \e count blocks
+    of \e block elements are selected, separated by \e stride elements. The
+    selected elements are addressed in row-major order through at(), or copied
+    by readData().
+
+    A dataset is mapped only if
+    <ul>
+      <li>its layout is contiguous (i.e. it is neither chunked nor filtered)
+      and its storage has been allocated,
+      <li>the file is accessed through the default (\e sec2) driver, such that
+      the address of the data is an offset within a single file,
+      <li>the datatype of the dataset is identical to the datatype requested.
+    </ul>
+    In all other cases the selection is read through \c H5Dread into a buffer
+    owned by the view, so the view can be used irrespective of the layout of
+    the dataset; isMapped() tells which of the two is the case.
+
+    The view neither owns the dataset, nor does it keep the file open: the
+    dataset has to stay open as long as the view is used. Data written to the
+    dataset after the selection has been set may not be visible through a
+    mapped view.
+
+    <h3>Example(s)</h3>
+
+    <ol>
+      <li>Scan a complete TBB dipole dataset:
+      \code
+      DAL::HDF5MappedView view (dipole.locationID(), H5T_NATIVE_SHORT);
+      short const *data = view.data<short>();
+
+      for (hsize_t n=0; n<view.nofDatapoints(); ++n) {
+        sum += data[n];
+      }
+      \endcode
+
+      <li>Every tenth sample of the first 1000 samples:
+      \code
+      std::vector<int> start (1,0);
+      std::vector<int> stride (1,10);
+      std::vector<int> count (1,100);
+      std::vector<int> block (1,1);
+
+      DAL::HDF5MappedView view (dataset.objectID(), H5T_NATIVE_SHORT);
+      view.setSelection (DAL::HDF5Hyperslab (start, stride, count, block));
+
+      for (hsize_t n=0; n<view.nofDatapoints(); ++n) {
+        std::cout << view.at<short>(n) << std::endl;
+      }
+      \endcode
+    </ol>
+
+  */
+  class HDF5MappedView {
+
+    //! Dataset viewed
+    hid_t itsDataset;
+    //! Datatype of the elements in memory
+    hid_t itsDatatype;
+    //! Size of an element, [Bytes]
+    size_t itsTypeSize;
+    //! Shape of the dataset
+    std::vector<hsize_t> itsDatasetShape;
+    //! Offset of the first selected element
+    std::vector<hsize_t> itsStart;
+    //! Separation of the blocks selected
+    std::vector<hsize_t> itsStride;
+    //! Number of blocks selected
+    std::vector<hsize_t> itsCount;
+    //! Shape of the blocks selected
+    std::vector<hsize_t> itsBlock;
+    //! Shape of the selection
+    std::vector<hsize_t> itsShape;
+    //! Is the selection mapped from the file?
+    bool itsMapped;
+    //! Start of the mapped region of the file
+    void *itsMapping;
+    //! Size of the mapped region of the file, [Bytes]
+    size_t itsMappingBytes;
+    //! First selected element within the mapped region
+    char const *itsFirst;
+    //! Index of the first selected element within the dataset
+    hsize_t itsFirstIndex;
+    //! Buffer holding the selection, if not mapped
+    std::vector<char> itsBuffer;
+
+    //! Disabled copy constructor
+    HDF5MappedView (HDF5MappedView const &other);
+    //! Disabled assignment operator
+    HDF5MappedView& operator= (HDF5MappedView const &other);
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor
+    HDF5MappedView ();
+
+    //! Argumented constructor, viewing a complete dataset
+    HDF5MappedView (hid_t const &dataset,
+		    hid_t const &datatype);
+
+    // === Destruction ==========================================================
+
+    //! Destructor, releasing the mapping
+    ~HDF5MappedView ();
+
+    // === Parameter access =====================================================
+
+    //! Is the selection mapped from the file (instead of read into a buffer)?
+    inline bool isMapped () const {
+      return itsMapped;
+    }
+
+    //! Get the shape of the selection
+    inline std::vector<hsize_t> shape () const {
+      return itsShape;
+    }
+
+    //! Get the size of an element, [Bytes]
+    inline size_t typeSize () const {
+      return itsTypeSize;
+    }
+
+    //! Get the number of elements selected
+    hsize_t nofDatapoints () const;
+
+    //! Are the selected elements stored next to each other?
+    bool isContiguous () const;
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, HDF5MappedView.
+    */
+    inline std::string className () const {
+      return "HDF5MappedView";
+    }
+
+    // === Methods ==============================================================
+
+    //! View a complete dataset
+    bool open (hid_t const &dataset,
+	       hid_t const &datatype);
+
+    //! View a selection of a dataset
+    bool open (hid_t const &dataset,
+	       hid_t const &datatype,
+	       HDF5Hyperslab const &slab);
+
+    //! Select the part of the dataset viewed
+    bool setSelection (HDF5Hyperslab const &slab);
+
+    //! Release the mapping or buffer
+    void close ();
+
+    //! Get the address of a selected element
+    void const * address (hsize_t const &index) const;
+
+    /*!
+      \brief Get the selected elements as an array
+
+      \return data -- Pointer to the first selected element, or \c NULL if the
+              selected elements are not stored next to each other (see
+              isContiguous()) or the size of \c T does not match the datatype.
+    */
+    template <class T>
+      inline T const * data () const
+      {
+	if (sizeof(T) != itsTypeSize || !isContiguous()) {
+	  return NULL;
+	}
+	return static_cast<T const *>(address (0));
+      }
+
+    /*!
+      \brief Get a selected element
+
+      \param index -- Index of the element within the selection, in row-major
+             order; \c T has to match the datatype of the view.
+      \return value -- The selected element.
+    */
+    template <class T>
+      inline T const & at (hsize_t const &index) const
+      {
+	return *static_cast<T const *>(address (index));
+      }
+
+    /*!
+      \brief Copy the selected elements
+
+      \param data    -- Array to which the selected elements are copied, in
+             row-major order.
+      \return status -- Returns \e false if the size of \c T does not match the
+              datatype of the view.
+    */
+    template <class T>
+      inline bool readData (T data[]) const
+      {
+	if (sizeof(T) != itsTypeSize) {
+	  return false;
+	}
+	return copyData (data);
+      }
+
+    // === Static methods =======================================================
+
+    //! Can a dataset be mapped from the file?
+    static bool isMappable (hid_t const &dataset,
+			    hid_t const &datatype);
+
+  private:
+
+    //! Initialize the internal parameters
+    void init ();
+    //! Attach to a dataset, without selecting any of its elements
+    bool attach (hid_t const &dataset,
+		 hid_t const &datatype);
+    //! Map the selection from the file
+    bool map ();
+    //! Read the selection into the buffer
+    bool read ();
+    //! Copy the selected elements
+    bool copyData (void *data) const;
+    //! Position of a selected element within the dataset
+    hsize_t position (hsize_t const &index) const;
+
+  }; // Class HDF5MappedView -- end
+
+} // Namespace DAL -- end
+
+#endif /* HDF5MAPPEDVIEW_H */
@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include <core/HDF5Object.h>
+#include <core/HDF5IOExecutor.h>
 
 namespace DAL { // Namespace DAL -- begin
   
@@ -120,23 +121,32 @@ namespace DAL { // Namespace DAL -- begin
   //_____________________________________________________________________________
   //                                                                         copy
   
+  /*!
+    The object identifier is shared with \c other rather than opened once more:
+    its reference count is incremented, such that both objects can close it
+    independently of each other.
+  */
   void HDF5Object::copy (HDF5Object const &other)
   {
-    itsLocation = other.itsLocation;
-
-    if (H5Iis_valid(itsLocation)) {
-
-      /*______________________________________________________________
-	Returns a non-negative value if successful; otherwise returns
-	a negative value.
-      */
-      herr_t status = H5Oincr_refcount(itsLocation);
+    itsFlags    = other.itsFlags;
+    itsLocation = share (other.itsLocation);
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                         swap
+  
+  /*!
+    \param other -- Another HDF5Object object with which to exchange the object
+           identifier.
 
-      if (status<0) {
-	std::cerr << "[HDF5Object::copy] Error incrementing object reference counter!"
-		  << std::endl;
-      }
-    }
+    Exchanging the identifiers neither opens nor closes any HDF5 object, such
+    that this is the cheap alternative to assigning an object which is about
+    to be discarded.
+  */
+  void HDF5Object::swap (HDF5Object &other)
+  {
+    std::swap (itsFlags,    other.itsFlags);
+    std::swap (itsLocation, other.itsLocation);
   }
   
   // ============================================================================
@@ -686,16 +696,18 @@ namespace DAL { // Namespace DAL -- begin
   /*!
     \param filename -- Name of the file to be opened.
     \param flags    -- I/O mode flags.
+    \param options  -- Tuning parameters for the access to the file.
     \return fileID  -- HDF5 object identifier for the opened file; returns \e 0 
             in case the operation failed.
    */
   hid_t HDF5Object::openFile (std::string const &filename,
-			  IO_Mode const &flags)
+			      IO_Mode const &flags,
+			      HDF5AccessOptions const &options)
   {
     hid_t fileID = 0;
 
     /* Forward the function call */
-    open (fileID, filename, flags);
+    openFile (fileID, filename, flags, options);
 
     return fileID;
   }
@@ -707,15 +719,20 @@ namespace DAL { // Namespace DAL -- begin
     \retvalfileID    --
     \param filename  -- 
     \param flags     --
+    \param options   -- Tuning parameters for the access to the file, see
+           HDF5AccessOptions.
     \return fileTruncated -- Was the file truncated? Returns \e true is this 
             was the case.
   */
   bool HDF5Object::openFile (hid_t &fileID,
 			     std::string const &filename,
-			     IO_Mode const &flags)
+			     IO_Mode const &flags,
+			     HDF5AccessOptions const &options)
   {
     bool fileExists    = false;
     bool fileTruncated = false; 
+    hid_t accessList   = options.fileAccessList();
+    hid_t creationList = options.fileCreationList();
     std::ifstream infile (filename.c_str(), std::ifstream::in);
     
     /*______________________________________________________
@@ -739,28 +756,24 @@ namespace DAL { // Namespace DAL -- begin
 	fileTruncated = true;
 	fileID        = H5Fcreate (filename.c_str(),
 				   H5F_ACC_TRUNC,
-				   H5P_DEFAULT,
-				   H5P_DEFAULT);
+				   creationList,
+				   accessList);
       } else if ( flags.flags() & IO_Mode::Create ) {
 	/* Truncate existing file */
 	fileTruncated = true;
 	fileID        = H5Fcreate (filename.c_str(),
 				   H5F_ACC_TRUNC,
-				   H5P_DEFAULT,
-				   H5P_DEFAULT);
+				   creationList,
+				   accessList);
       } else {
 	if ( flags.flags() & IO_Mode::ReadWrite ) {
 	  /* Open file as read/write */
 	  fileTruncated = false;
-	  fileID        = H5Fopen (filename.c_str(),
-				   H5F_ACC_RDWR,
-				   H5P_DEFAULT);
+	  fileID        = openExisting (filename, H5F_ACC_RDWR, options);
 	} else {
 	  /* Open file as read-only */
 	  fileTruncated = false;
-	  fileID        = H5Fopen (filename.c_str(),
-				   H5F_ACC_RDONLY,
-				   H5P_DEFAULT);
+	  fileID        = openExisting (filename, H5F_ACC_RDONLY, options);
 	}
       }
     } else {
@@ -768,12 +781,54 @@ namespace DAL { // Namespace DAL -- begin
       fileTruncated = true;
       fileID        = H5Fcreate (filename.c_str(),
 				 H5F_ACC_TRUNC,
-				 H5P_DEFAULT,
-				 H5P_DEFAULT);
+				 creationList,
+				 accessList);
     }
 
+    /* Release the property lists */
+    HDF5AccessOptions::release (accessList);
+    HDF5AccessOptions::release (creationList);
+
     return fileTruncated;
   }
+
+  //_____________________________________________________________________________
+  //                                                                 openExisting
+  
+  /*!
+    Page buffering can only be used with files created with paged file space
+    management; if opening the file with page buffering fails, a second
+    attempt is made without it.
+
+    \param filename -- Name of the existing file.
+    \param access   -- Access flag, \c H5F_ACC_RDWR or \c H5F_ACC_RDONLY.
+    \param options  -- Tuning parameters for the access to the file.
+    \return fileID  -- HDF5 object identifier for the opened file; negative
+            in case the operation failed.
+  */
+  hid_t HDF5Object::openExisting (std::string const &filename,
+				  unsigned int const &access,
+				  HDF5AccessOptions const &options)
+  {
+    hid_t fileID     = -1;
+    hid_t accessList = options.fileAccessList();
+
+    if (options.pageBufferSize() > 0) {
+      H5E_BEGIN_TRY {
+	fileID = H5Fopen (filename.c_str(), access, accessList);
+      } H5E_END_TRY;
+      HDF5AccessOptions::release (accessList);
+      if (fileID >= 0) {
+	return fileID;
+      }
+      accessList = options.fileAccessList(false);
+    }
+
+    fileID = H5Fopen (filename.c_str(), access, accessList);
+    HDF5AccessOptions::release (accessList);
+
+    return fileID;
+  }
   
   //_____________________________________________________________________________
   //                                                                         open
@@ -879,6 +934,35 @@ namespace DAL { // Namespace DAL -- begin
     return objectID;
   }
   
+  //_____________________________________________________________________________
+  //                                                                        share
+  
+  /*!
+    HDF5 keeps a reference count for every identifier, which is decremented
+    by the \c H5Xclose() functions; the object is released once the count
+    drops to zero. Sharing an identifier therefore is a matter of incrementing
+    the count, after which the additional holder releases it through close().
+
+    \param location -- HDF5 object identifier.
+    \return location -- The identifier passed in, if its reference count could
+            be incremented; returns -1 otherwise.
+  */
+  hid_t HDF5Object::share (hid_t const &location)
+  {
+    HDF5IOExecutor::Lock lock;
+
+    if (location > 0 && H5Iis_valid(location) > 0) {
+      if (H5Iinc_ref(location) > 0) {
+	return location;
+      } else {
+	std::cerr << "[HDF5Object::share] Error incrementing reference count!"
+		  << std::endl;
+      }
+    }
+    
+    return -1;
+  }
+
   //_____________________________________________________________________________
   //                                                                        close
   
@@ -897,6 +981,8 @@ namespace DAL { // Namespace DAL -- begin
   herr_t HDF5Object::close (hid_t const &location)
   {
     herr_t status = -1;
+    /* Objects may be closed while requests to the executor are in flight */
+    HDF5IOExecutor::Lock lock;
 
     if (H5Iis_valid(location)) {
 
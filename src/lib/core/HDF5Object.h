@@ -22,6 +22,7 @@
 #define HDF5OBJECT_H
 
 // Standard library header files
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <map>
@@ -30,6 +31,7 @@
 #include <vector>
 
 #include <core/IO_Mode.h>
+#include <core/HDF5AccessOptions.h>
 
 namespace DAL { // Namespace DAL -- begin
   
@@ -195,6 +197,9 @@ namespace DAL { // Namespace DAL -- begin
     
     //! Overloading of the copy operator
     HDF5Object& operator= (HDF5Object const &other); 
+
+    //! Exchange the object identifier with another object
+    void swap (HDF5Object &other);
     
     // === Parameter access =====================================================
     
@@ -301,11 +306,17 @@ namespace DAL { // Namespace DAL -- begin
     
     //! Open HDF5 file
     static hid_t openFile (std::string const &filename,
-			   IO_Mode const &flags=IO_Mode(IO_Mode::OpenOrCreate));
+			   IO_Mode const &flags=IO_Mode(IO_Mode::OpenOrCreate),
+			   HDF5AccessOptions const &options=HDF5AccessOptions());
     //! Open HDF5 file
     static bool openFile (hid_t &fileID,
 			  std::string const &filename,
-			  IO_Mode const &flags=IO_Mode(IO_Mode::OpenOrCreate));
+			  IO_Mode const &flags=IO_Mode(IO_Mode::OpenOrCreate),
+			  HDF5AccessOptions const &options=HDF5AccessOptions());
+    //! Open an existing HDF5 file, falling back to no page buffering
+    static hid_t openExisting (std::string const &filename,
+			       unsigned int const &access,
+			       HDF5AccessOptions const &options=HDF5AccessOptions());
     
     //! Open an object in an HDF5 file
     static hid_t open (hid_t const &location,
@@ -316,6 +327,8 @@ namespace DAL { // Namespace DAL -- begin
 		       std::string const &name,
 		       H5I_type_t const &otype,
 		       IO_Mode const &flags=IO_Mode(IO_Mode::OpenOrCreate));
+    //! Share an object identifier, by incrementing its reference count
+    static hid_t share (hid_t const &location);
     //! Closes an object in an HDF5 file.
     static herr_t close (hid_t const &location);
 
@@ -438,6 +438,31 @@ namespace DAL {
 
   }
 
+  //_____________________________________________________________________________
+  //                                                                       resize
+
+  /*!
+    \param dims The new dimensions of the array. Unlike extend(), this can also
+                shrink the array; data beyond the new dimensions is lost.
+    \return bool -- DAL::FAIL or DAL::SUCCESS
+  */
+  bool dalArray::resize (std::vector<int> const &newdims)
+  {
+    uint32_t rank = newdims.size();
+    hsize_t lcldims[ rank ];
+
+    for ( uint32_t ii=0; ii < rank; ii++ )
+      lcldims[ ii ] = newdims[ ii ];
+
+    if ( H5Dset_extent( itsDatasetID, lcldims ) < 0 )
+      {
+        std::cerr << "ERROR: Could not resize array.\n";
+        return DAL::FAIL;
+      }
+
+    return DAL::SUCCESS;
+  }
+
   //_____________________________________________________________________________
   //                                                                getAttributes
 
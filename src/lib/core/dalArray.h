@@ -170,6 +170,8 @@ namespace DAL {
 
     //! Increase the dimensions of the array.
     bool extend (std::vector<int> const &dims);
+    //! Change the dimensions of the array, possibly shrinking it.
+    bool resize (std::vector<int> const &dims);
     //! Write \e data of type \e short.
     bool write (int offset, short data[], int arraysize);
     //! Write \e data of type \e int.
@@ -23,6 +23,7 @@
 #define DALCOMMON_H
 
 #include <iostream>
+#include <complex>
 #include <stdint.h>
 #include <sstream>
 #include <assert.h>
@@ -143,6 +144,66 @@ namespace DAL {
   //! Byte swap routine
   void swapbytes (char *addr,
 		  int8_t nbytes);
+
+  //! Byte swap an array of 16-bit values in place
+  void swapbytes16 (void *buffer,
+		    size_t nofValues);
+
+  //! Byte swap an array of 32-bit values in place
+  void swapbytes32 (void *buffer,
+		    size_t nofValues);
+
+  //! Byte swap an array of 64-bit values in place
+  void swapbytes64 (void *buffer,
+		    size_t nofValues);
+
+  //! Byte swap an array of 16-bit integers in place
+  inline void swapbytes (int16_t *buffer,
+			 size_t nofValues) {
+    swapbytes16 (buffer, nofValues);
+  }
+
+  //! Byte swap an array of 16-bit unsigned integers in place
+  inline void swapbytes (uint16_t *buffer,
+			 size_t nofValues) {
+    swapbytes16 (buffer, nofValues);
+  }
+
+  //! Byte swap an array of 32-bit integers in place
+  inline void swapbytes (int32_t *buffer,
+			 size_t nofValues) {
+    swapbytes32 (buffer, nofValues);
+  }
+
+  //! Byte swap an array of 32-bit unsigned integers in place
+  inline void swapbytes (uint32_t *buffer,
+			 size_t nofValues) {
+    swapbytes32 (buffer, nofValues);
+  }
+
+  //! Byte swap an array of single precision floats in place
+  inline void swapbytes (float *buffer,
+			 size_t nofValues) {
+    swapbytes32 (buffer, nofValues);
+  }
+
+  //! Byte swap an array of double precision floats in place
+  inline void swapbytes (double *buffer,
+			 size_t nofValues) {
+    swapbytes64 (buffer, nofValues);
+  }
+
+  //! Byte swap an array of complex 16-bit integers in place (parts separately)
+  inline void swapbytes (std::complex<int16_t> *buffer,
+			 size_t nofValues) {
+    swapbytes16 (buffer, 2*nofValues);
+  }
+
+  //! Byte swap an array of complex floats in place (parts separately)
+  inline void swapbytes (std::complex<float> *buffer,
+			 size_t nofValues) {
+    swapbytes32 (buffer, 2*nofValues);
+  }
   
   //_____________________________________________________________________________
   //                                                                        crc16
@@ -150,6 +211,21 @@ namespace DAL {
   //! Calculate a 16-bit CRC
   uint16_t crc16 (uint16_t * buffer,
 		  uint32_t length);
+
+  //! Calculate a 16-bit CRC, processing one bit at a time (reference version)
+  uint16_t crc16_bitwise (uint16_t * buffer,
+			  uint32_t length);
+
+  //_____________________________________________________________________________
+  //                                                                        crc32
+
+  //! Calculate a 32-bit CRC
+  uint32_t crc32 (uint16_t * buffer,
+		  uint32_t length);
+
+  //! Calculate a 32-bit CRC, processing one bit at a time (reference version)
+  uint32_t crc32_bitwise (uint16_t * buffer,
+			  uint32_t length);
   
   // ============================================================================
   //
@@ -234,7 +234,8 @@ namespace DAL {
     
     fileTruncated = HDF5Object::openFile (h5fh_p,
 					  filename,
-					  flags);
+					  flags,
+					  itsAccessOptions);
     
     /* Check the HDF5 objec identifier; if it is ok, do internal book-keeping */
     if (H5Iis_valid(h5fh_p)) {
@@ -99,6 +99,16 @@ namespace DAL {
       // Get the HDF5 file handle identifier
       dataset.getFileHandle();
       \endcode
+      <li>Open an HDF5 file with a larger chunk and metadata cache:
+      \code
+      DAL::HDF5AccessOptions options;
+      options.setChunkCache (64*1024*1024);
+      options.setMetadataCacheSize (8*1024*1024);
+
+      DAL::dalDataset dataset;
+      dataset.setAccessOptions (options);
+      dataset.open (filename);
+      \endcode
     </ol>
   */
 
@@ -108,6 +118,8 @@ namespace DAL {
     dalFilter itsFilter;
     //! HDF5 file handle
     hid_t h5fh_p;
+    //! Tuning parameters for the access to an HDF5 file
+    HDF5AccessOptions itsAccessOptions;
     
 #ifdef DAL_WITH_CASA
     casa::MeasurementSet itsMS;   // CASA measurement set
@@ -148,6 +160,16 @@ namespace DAL {
       return h5fh_p;
     }
 
+    //! Get the tuning parameters for the access to an HDF5 file
+    inline HDF5AccessOptions accessOptions () const {
+      return itsAccessOptions;
+    }
+
+    //! Set the tuning parameters used when opening an HDF5 file
+    inline void setAccessOptions (HDF5AccessOptions const &options) {
+      itsAccessOptions = options;
+    }
+
     // === Public methods =======================================================
     
     //! Open the dataset
@@ -20,6 +20,9 @@
 
 #include <core/dalFilter.h>
 
+#include <cctype>
+#include <cstdlib>
+
 namespace DAL {
 
   // ============================================================================
@@ -82,6 +85,8 @@ namespace DAL {
     itsFilterString = "";
     itsFiletype     = type;
     itsFilterIsSet  = false;
+    itsColumns.clear();
+    itsConditions.clear();
   }
 
   //_____________________________________________________________________________
@@ -103,6 +108,14 @@ namespace DAL {
       itsFilterString = "Select " + columns + " from $1";
       itsFilterIsSet   = true;
       break;
+    case dalFileType::HDF5:
+      {
+	itsConditions.clear();
+	status = parseColumns (columns, itsColumns);
+	itsFilterString = "Select " + columns + " from $1";
+	itsFilterIsSet  = status;
+      }
+      break;
     default:
       {
 	std::cerr << "[dalFilter::setFilter] Operation not yet supoorted for type "
@@ -160,6 +173,14 @@ namespace DAL {
         itsFilterIsSet  = true;
       }
       break;
+    case dalFileType::HDF5:
+      {
+	status = parseColumns (cols, itsColumns)
+	  && parseConditions (conditions, itsConditions);
+	itsFilterString = "Select " + cols + " from $1 where " + conditions;
+	itsFilterIsSet  = status;
+      }
+      break;
     default:
       {
 	std::cerr << "[dalFilter::setFilter] Operation not yet supoorted for type "
@@ -182,6 +203,158 @@ namespace DAL {
     os << "-- Filter string = " << itsFilterString         << std::endl;
     os << "-- File type     = " << itsFiletype.name()      << std::endl;
     os << "-- Filter is set = " << itsFilterIsSet          << std::endl;
+    os << "-- nof. columns  = " << itsColumns.size()       << std::endl;
+    os << "-- Conditions    = " << itsConditions.size()    << std::endl;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     evaluate
+
+  /*!
+    \param condition -- Condition to evaluate.
+    \param value     -- Value of the column the condition refers to.
+    \return result   -- Returns \e true if the value meets the condition.
+  */
+  bool dalFilter::evaluate (Condition const &condition,
+			    double const &value)
+  {
+    switch (condition.op) {
+    case Operator::Equal:
+      return value == condition.value;
+    case Operator::NotEqual:
+      return value != condition.value;
+    case Operator::Greater:
+      return value > condition.value;
+    case Operator::GreaterEqual:
+      return value >= condition.value;
+    case Operator::Lesser:
+      return value < condition.value;
+    case Operator::LesserEqual:
+      return value <= condition.value;
+    default:
+      return false;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 parseColumns
+
+  /*!
+    \param columns -- Comma-separated list of column names; "*" selects all
+           columns.
+    \retval names  -- Names of the columns; empty if all columns are selected.
+    \return status -- Returns \e false if the list contains an empty name.
+  */
+  bool dalFilter::parseColumns (std::string const &columns,
+				std::vector<std::string> &names)
+  {
+    std::string::size_type pos (0);
+    std::string::size_type end (0);
+    std::string const blanks (" \t");
+
+    names.clear();
+
+    if (columns.find_first_not_of (blanks) == std::string::npos
+	|| columns.substr (columns.find_first_not_of (blanks), 1) == "*") {
+      return true;
+    }
+
+    while (pos <= columns.size()) {
+      end = columns.find (',', pos);
+      if (end == std::string::npos) {
+	end = columns.size();
+      }
+      std::string name = columns.substr (pos, end-pos);
+      std::string::size_type first = name.find_first_not_of (blanks);
+      if (first == std::string::npos) {
+	std::cerr << "[dalFilter::parseColumns] Empty column name in \""
+		  << columns << "\"" << std::endl;
+	names.clear();
+	return false;
+      }
+      names.push_back (name.substr (first, name.find_last_not_of (blanks)-first+1));
+      pos = end+1;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                              parseConditions
+
+  /*!
+    \param conditions -- Comparisons of a column with a constant, combined with
+           \c AND, e.g. <tt>"TIME >= 100 AND FLAG == 0"</tt>.
+    \retval result    -- The parsed conditions.
+    \return status    -- Returns \e false if the conditions could not be parsed.
+  */
+  bool dalFilter::parseConditions (std::string const &conditions,
+				   std::vector<Condition> &result)
+  {
+    /* Comparison operators; those of two characters are tried first */
+    char const *symbols[]       = {"==", "!=", "<=", ">=", "=", "<", ">"};
+    Operator::Types const ops[] = {Operator::Equal,
+				   Operator::NotEqual,
+				   Operator::LesserEqual,
+				   Operator::GreaterEqual,
+				   Operator::Equal,
+				   Operator::Lesser,
+				   Operator::Greater};
+    std::string const blanks (" \t");
+    std::string upper (conditions);
+    std::string::size_type pos (0);
+
+    for (unsigned int n=0; n<upper.size(); ++n) {
+      upper[n] = toupper (upper[n]);
+    }
+
+    result.clear();
+
+    while (pos < conditions.size()) {
+      std::string::size_type end = upper.find (" AND ", pos);
+      if (end == std::string::npos) {
+	end = conditions.size();
+      }
+      std::string term = conditions.substr (pos, end-pos);
+      pos = end + 5;
+
+      /* Locate the comparison operator */
+      Condition condition;
+      std::string::size_type opPos = std::string::npos;
+      std::string::size_type opLength = 0;
+      for (unsigned int n=0; n<7 && opPos==std::string::npos; ++n) {
+	opPos = term.find (symbols[n]);
+	if (opPos != std::string::npos) {
+	  condition.op = ops[n];
+	  opLength     = std::string(symbols[n]).size();
+	}
+      }
+
+      std::string column;
+      std::string value;
+      if (opPos != std::string::npos) {
+	column = term.substr (0, opPos);
+	value  = term.substr (opPos+opLength);
+      }
+      std::string::size_type first = column.find_first_not_of (blanks);
+      char *valueEnd = NULL;
+      condition.value = strtod (value.c_str(), &valueEnd);
+
+      if (opPos == std::string::npos
+	  || first == std::string::npos
+	  || valueEnd == value.c_str()
+	  || std::string(valueEnd).find_first_not_of (blanks) != std::string::npos) {
+	std::cerr << "[dalFilter::parseConditions] Cannot parse condition \""
+		  << term << "\"" << std::endl;
+	result.clear();
+	return false;
+      }
+
+      condition.column = column.substr (first, column.find_last_not_of (blanks)-first+1);
+      result.push_back (condition);
+    }
+
+    return true;
   }
   
 } // DAL namespace
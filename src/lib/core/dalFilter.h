@@ -23,6 +23,7 @@
 #include <vector>
 
 #include <core/dalObjectBase.h>
+#include <core/Operator.h>
 
 namespace DAL {
   
@@ -36,14 +37,40 @@ namespace DAL {
 
     \author Joseph Masters
     \author Lars B&auml;hren
+
+    For CASA measurement sets the filter is passed on as a TaQL query. For
+    HDF5 tables the filter is evaluated by dalTable::readFiltered(): the
+    column selection is a comma-separated list of column names ("*" selects
+    all columns), the conditions are comparisons of numerical columns with a
+    constant, combined with \c AND, e.g. <tt>"TIME >= 100 AND FLAG == 0"</tt>.
+    Supported comparisons are <tt>==</tt> (or <tt>=</tt>), <tt>!=</tt>,
+    <tt>&lt;</tt>, <tt>&lt;=</tt>, <tt>&gt;</tt> and <tt>&gt;=</tt>.
   */
   
   class dalFilter : public dalObjectBase {
 
+  public:
+
+    //! Comparison of the value of a numerical column with a constant
+    struct Condition {
+      //! Name of the column
+      std::string column;
+      //! Comparison operator
+      Operator::Types op;
+      //! Constant the value of the column is compared with
+      double value;
+    };
+
+  private:
+
     //! Table filter std::string
     std::string itsFilterString;
     //! Book-keeping whether a filter is set or not.
     bool itsFilterIsSet;
+    //! Names of the selected columns; empty if all columns are selected
+    std::vector<std::string> itsColumns;
+    //! Conditions to be met by the rows passing the filter
+    std::vector<Condition> itsConditions;
     
   public:
 
@@ -87,6 +114,20 @@ namespace DAL {
       return itsFilterString;
     }
 
+    //! Get the names of the selected columns; empty if all columns are selected
+    inline std::vector<std::string> columns () const {
+      return itsColumns;
+    }
+
+    //! Get the conditions to be met by the rows passing the filter
+    inline std::vector<Condition> conditions () const {
+      return itsConditions;
+    }
+
+    //! Does a value meet a condition?
+    static bool evaluate (Condition const &condition,
+			  double const &value);
+
     //! Provide a summary of the internal status
     inline void summary () {
       summary (std::cout);
@@ -98,6 +139,12 @@ namespace DAL {
 
     //! Initialize internal parameters
     void init (dalFileType const &type=dalFileType());
+    //! Split a comma-separated list of column names
+    static bool parseColumns (std::string const &columns,
+			      std::vector<std::string> &names);
+    //! Parse a list of conditions combined with AND
+    static bool parseConditions (std::string const &conditions,
+				 std::vector<Condition> &result);
     
   };
   
@@ -277,6 +277,7 @@ namespace DAL {
     \param data A structure containing the data to be written.  The size
                 of the data must match the provided dimensions.
     \param cdims The chunk dimensions for an extendible array.
+    \param filters Filters applied to the chunks of an extendible array.
 
     \return dalArray * A pointer to an array object.
   */
@@ -284,10 +285,11 @@ namespace DAL {
   dalGroup::createShortArray( std::string arrayname,
                               std::vector<int> dims,
                               short data[],
-                              std::vector<int> cdims )
+                              std::vector<int> cdims,
+                              HDF5FilterPipeline const &filters )
   {
     dalShortArray * la;
-    la = new dalShortArray( itsGroupID, arrayname, dims, data, cdims );
+    la = new dalShortArray( itsGroupID, arrayname, dims, data, cdims, filters );
     return la;
   }
 
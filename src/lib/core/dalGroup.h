@@ -97,7 +97,8 @@ namespace DAL {
     dalArray * createShortArray(        std::string arrayname,
 					std::vector<int> dims,
 					short data[],
-					std::vector<int>cdims);
+					std::vector<int>cdims,
+					HDF5FilterPipeline const &filters=HDF5FilterPipeline());
     //! Create an array of ints within the group.
     dalArray * createIntArray(          std::string arrayname,
 					std::vector<int> dims,
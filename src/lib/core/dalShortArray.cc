@@ -39,12 +39,14 @@ namespace DAL {
                 array.  The size of the structure should match the dimensions
                 of the array.
     \param chnkdims Specifies the chunk size for extendible arrays.
+    \param filters Filters applied to the chunks of an extendible array.
    */
   dalShortArray::dalShortArray( hid_t obj_id,
 				std::string arrayname,
                                 std::vector<int> dims,
 				short data[],
-                                std::vector<int> chnkdims )
+                                std::vector<int> chnkdims,
+				HDF5FilterPipeline const &filters )
   {
     hid_t datatype  = 0;
     hid_t dataspace = 0;  // declare a few h5 variables
@@ -92,6 +94,11 @@ namespace DAL {
 	  std::cerr << "ERROR: Could not set array chunk size.\n";
 	}
       
+      if ( !filters.apply( cparms ) )
+	{
+	  std::cerr << "ERROR: Could not set array filters.\n";
+	}
+      
       if ( ( itsDatasetID = H5Dcreate (obj_id, arrayname.c_str(), datatype,
 				       dataspace, H5P_DEFAULT, cparms, H5P_DEFAULT) ) < 0 )
 	{
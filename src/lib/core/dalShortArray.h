@@ -22,6 +22,7 @@
 #define DALSHORTARRAY_H
 
 #include <core/dalArray.h>
+#include <core/HDF5FilterPipeline.h>
 
 namespace DAL {
 
@@ -44,7 +45,8 @@ namespace DAL {
 		   std::string arrayname,
 		   std::vector<int> dims,
 		   short data[],
-		   std::vector<int>chnkdims);
+		   std::vector<int>chnkdims,
+		   HDF5FilterPipeline const &filters=HDF5FilterPipeline());
 
     //! Read data  from the array
     short * readShortArray (hid_t obj_id,
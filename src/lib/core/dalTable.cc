@@ -61,6 +61,18 @@ namespace DAL {
     init ();
   }
 
+  //_____________________________________________________________________________
+  //                                                                     dalTable
+  
+  /*!
+    \param other -- Another dalTable object from which to create this new one.
+  */
+  dalTable::dalTable (dalTable const &other)
+    : dalObjectBase(other)
+  {
+    copy (other);
+  }
+
   // ============================================================================
   //
   //  Destruction
@@ -72,6 +84,15 @@ namespace DAL {
   
   dalTable::~dalTable()
   {
+    destroy ();
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                      destroy
+  
+  void dalTable::destroy ()
+  {
+    h5releaseLayout ();
 #ifdef DAL_WITH_CASA
     if (itsFiletype.type() == dalFileType::CASA_MS) {
       delete itsCasaTable;
@@ -80,6 +101,67 @@ namespace DAL {
 #endif
   }
   
+  // ============================================================================
+  //
+  //  Operators
+  //
+  // ============================================================================
+  
+  //_____________________________________________________________________________
+  //                                                                    operator=
+  
+  /*!
+    \param other -- Another dalTable object from which to make a copy.
+  */
+  dalTable& dalTable::operator= (dalTable const &other)
+  {
+    if (this != &other) {
+      destroy ();
+      dalObjectBase::operator= (other);
+      copy (other);
+    }
+    return *this;
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                         copy
+  
+  /*!
+    The dataset holding the records and the in-memory datatype of the cached
+    layout are shared with \c other (see HDF5Object::share), such that the
+    identifiers are closed only once both objects have released them.
+  */
+  void dalTable::copy (dalTable const &other)
+  {
+    file           = other.file;
+    itsFileID      = other.itsFileID;
+    itsTableID     = other.itsTableID;
+    nfields        = other.nfields;
+    nofRecords_p   = other.nofRecords_p;
+    status         = other.status;
+    itsFilter      = other.itsFilter;
+    itsFieldNames  = other.itsFieldNames;
+    itsFirstRecord = other.itsFirstRecord;
+    columns        = other.columns;
+    itsLayoutCached = other.itsLayoutCached;
+    itsRecordsID    = HDF5Object::share (other.itsRecordsID);
+    itsRecordType   = HDF5Object::share (other.itsRecordType);
+    itsRecordSize   = other.itsRecordSize;
+    itsFieldSizes   = other.itsFieldSizes;
+    itsFieldOffsets = other.itsFieldOffsets;
+
+#ifdef DAL_WITH_CASA
+    itsCasaTable    = NULL;
+    itsCasaColumn   = NULL;
+    itsArrayDouble  = other.itsArrayDouble;
+    itsArrayComplex = other.itsArrayComplex;
+    if (itsFiletype.type() == dalFileType::CASA_MS) {
+      /* casa::Table has reference semantics, the column is not kept */
+      itsCasaTable = new casa::Table (*other.itsCasaTable);
+    }
+#endif
+  }
+  
   // ============================================================================
   //
   //  Methods
@@ -99,6 +181,12 @@ namespace DAL {
     status         = 0;
     itsFirstRecord = true;
     itsFilter      = dalFilter();
+    itsLayoutCached = false;
+    itsRecordsID    = 0;
+    itsRecordType   = 0;
+    itsRecordSize   = 0;
+    itsFieldSizes.clear();
+    itsFieldOffsets.clear();
 
     columns.clear();
     
@@ -106,7 +194,8 @@ namespace DAL {
 #ifdef DAL_WITH_CASA
     case dalFileType::CASA_MS:
       {
-	itsCasaTable = new casa::Table;
+	itsCasaTable  = new casa::Table;
+	itsCasaColumn = NULL;
       }
       break;
 #endif
@@ -752,6 +841,7 @@ namespace DAL {
                             std::string const &groupname)
   {
     if (itsFiletype.type()==dalFileType::HDF5) {
+      h5releaseLayout ();
       itsName = groupname + '/' + tablename;
       hid_t * lclfile = (hid_t*)voidfile; // H5File object
       file = lclfile;
@@ -839,6 +929,7 @@ namespace DAL {
         // columns are added
         //
 
+        h5releaseLayout ();
         itsName = groupname + '/' + tablename;// set the private class variable: name
         // cast the voidfile to an hdf5 file
         hid_t * lclfile = (hid_t*)voidfile; // H5File object
@@ -1004,6 +1095,9 @@ namespace DAL {
       data[idx] = 0;
     }
 
+    // the dataset is replaced by one holding the additional field
+    h5releaseLayout ();
+
     // create the new column
     status = H5TBinsert_field (itsFileID,
 			       itsName.c_str(),
@@ -1021,6 +1115,162 @@ namespace DAL {
     }
   }
 
+  //_____________________________________________________________________________
+  //                                                                h5cacheLayout
+
+  /*!
+    \return status -- Returns \e false if the table could not be opened.
+
+    Retrieves the in-memory layout of the records -- the native counterpart of
+    the datatype of the table, as used by the H5TB routines -- along with the
+    number of records, and keeps the dataset open for subsequent appends.
+  */
+  bool dalTable::h5cacheLayout ()
+  {
+    if (itsLayoutCached) {
+      return true;
+    } else if (itsFileID <= 0) {
+      return false;
+    }
+
+    itsRecordsID = H5Dopen (itsFileID, itsName.c_str(), H5P_DEFAULT);
+
+    if (itsRecordsID < 0) {
+      std::cerr << "[dalTable::h5cacheLayout] Failed to open table "
+		<< itsName << std::endl;
+      itsRecordsID = 0;
+      return false;
+    }
+
+    hid_t fileType  = H5Dget_type (itsRecordsID);
+    hid_t spaceID   = H5Dget_space (itsRecordsID);
+    hsize_t dims[1] = {0};
+
+    itsRecordType = H5Tget_native_type (fileType, H5T_DIR_DEFAULT);
+    H5Sget_simple_extent_dims (spaceID, dims, NULL);
+    H5Sclose (spaceID);
+    H5Tclose (fileType);
+
+    if (itsRecordType < 0 || H5Tget_class (itsRecordType) != H5T_COMPOUND) {
+      std::cerr << "[dalTable::h5cacheLayout] " << itsName
+		<< " is not a table!" << std::endl;
+      h5releaseLayout ();
+      return false;
+    }
+
+    nfields       = H5Tget_nmembers (itsRecordType);
+    nofRecords_p  = dims[0];
+    itsRecordSize = H5Tget_size (itsRecordType);
+    itsFieldSizes.resize (nfields);
+    itsFieldOffsets.resize (nfields);
+
+    for (unsigned int n=0; n<nfields; ++n) {
+      hid_t memberType    = H5Tget_member_type (itsRecordType, n);
+      itsFieldSizes[n]    = H5Tget_size (memberType);
+      itsFieldOffsets[n]  = H5Tget_member_offset (itsRecordType, n);
+      H5Tclose (memberType);
+    }
+
+    itsLayoutCached = true;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                              h5releaseLayout
+
+  void dalTable::h5releaseLayout ()
+  {
+    if (itsRecordType > 0) {
+      H5Tclose (itsRecordType);
+    }
+    if (itsRecordsID > 0) {
+      H5Dclose (itsRecordsID);
+    }
+
+    itsLayoutCached = false;
+    itsRecordsID    = 0;
+    itsRecordType   = 0;
+    itsRecordSize   = 0;
+    itsFieldSizes.clear();
+    itsFieldOffsets.clear();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 h5fieldsType
+
+  /*!
+    \param columns  -- Names of the columns; if empty, all columns are used.
+    \param asDouble -- Represent the columns as \c double, e.g. to evaluate
+           conditions; only possible for scalar numerical columns.
+    \return datatype -- In-memory compound datatype with the columns as members,
+            aligned as a C struct; returns -1 if a column does not exist or
+            cannot be converted.
+  */
+  hid_t dalTable::h5fieldsType (std::vector<std::string> const &columns,
+				bool const &asDouble)
+  {
+    if (!h5cacheLayout()) {
+      return -1;
+    } else if (columns.empty() && !asDouble) {
+      return H5Tcopy (itsRecordType);
+    }
+
+    std::vector<hid_t> types;
+    size_t size (0);
+    bool ok (true);
+
+    for (unsigned int n=0; ok && n<columns.size(); ++n) {
+      int index = H5Tget_member_index (itsRecordType, columns[n].c_str());
+      if (index < 0) {
+	std::cerr << "[dalTable::h5fieldsType] No column " << columns[n]
+		  << " in table " << itsName << std::endl;
+	ok = false;
+	break;
+      }
+      hid_t type = H5Tget_member_type (itsRecordType, index);
+      if (asDouble) {
+	H5T_class_t typeClass = H5Tget_class (type);
+	H5Tclose (type);
+	if (typeClass != H5T_INTEGER && typeClass != H5T_FLOAT) {
+	  std::cerr << "[dalTable::h5fieldsType] Column " << columns[n]
+		    << " is not a numerical column" << std::endl;
+	  ok = false;
+	  break;
+	}
+	type = H5Tcopy (H5T_NATIVE_DOUBLE);
+      }
+      types.push_back (type);
+      size += H5Tget_size (type);
+    }
+
+    hid_t packed = ok ? H5Tcreate (H5T_COMPOUND, size) : -1;
+    size_t offset (0);
+
+    for (unsigned int n=0; n<types.size(); ++n) {
+      if (ok && H5Tinsert (packed, columns[n].c_str(), offset, types[n]) < 0) {
+	std::cerr << "[dalTable::h5fieldsType] Column " << columns[n]
+		  << " selected twice" << std::endl;
+	ok = false;
+      }
+      offset += H5Tget_size (types[n]);
+      H5Tclose (types[n]);
+    }
+
+    if (!ok) {
+      if (packed > 0) {
+	H5Tclose (packed);
+      }
+      return -1;
+    }
+
+    /* Align the members as the compiler would for a struct */
+    hid_t aligned = H5Tget_native_type (packed, H5T_DIR_DEFAULT);
+    H5Tclose (packed);
+
+    return aligned;
+  }
+
   //_____________________________________________________________________________
   //                                                                    addColumn
   
@@ -1284,6 +1534,7 @@ namespace DAL {
 	  
 	  if (0 == strcmp(colname.c_str(),itsFieldNames[ii])) {
 	    
+	    h5releaseLayout ();
 	    status = H5TBdelete_field( itsFileID, itsName.c_str(),
 				       itsFieldNames[ii]);
 	    
@@ -1331,24 +1582,13 @@ namespace DAL {
   {
     if (itsFiletype.type()==dalFileType::HDF5)
       {
-	
-        size_t * field_sizes = NULL;
-        size_t * field_offsets = NULL;
-        size_t * size_out = NULL;
-	
-        // retrieve the input fields needed for the append_records call
-        H5TBget_table_info ( itsFileID, itsName.c_str(), &nfields, &nofRecords_p );
-	
-        field_sizes   = new size_t[ nfields ];
-        field_offsets = new size_t[ nfields ];
-        size_out      = new size_t[ 1 ];
-
-        status = H5TBget_field_info( itsFileID, itsName.c_str(), NULL, field_sizes,
-                                     field_offsets, size_out );
-        /*
-         * Cleanup to make more efficient.  Check the last three fields for
-         * H5TBget_field_info();
-         */
+        if (!h5cacheLayout() || index < 0 || index >= int(itsFieldSizes.size()))
+          {
+            std::cerr << "[dalTable::writeDataByColNum] No such column "
+                      << index << std::endl;
+            return;
+          }
+
         int num_fields 		= 1;	  // number of fields to overwrite
         const int inum		= index;  // column number to overwrite
         const int * index_num	= &inum;  // pointer to column number to overwrite
@@ -1356,18 +1596,10 @@ namespace DAL {
         hsize_t numrecords	= nrecs;	  // number of records to write
 
         size_t col_offset[1] = { 0 };
-        size_t col_size[1] = { field_sizes[index] };
+        size_t col_size[1] = { itsFieldSizes[index] };
         status = H5TBwrite_fields_index(itsFileID, itsName.c_str(), num_fields,
                                         index_num, start, numrecords, *col_size,
                                         col_offset, col_size, data);
-
-        delete [] field_sizes;
-        field_sizes = NULL;
-        delete [] field_offsets;
-        field_offsets = NULL;
-        delete [] size_out;
-        size_out = NULL;
-
       }
     else {
       std::cerr << "Operation not yet supported for type " << itsFiletype.name()
@@ -1391,39 +1623,7 @@ namespace DAL {
   {
     if (itsFiletype.type()==dalFileType::HDF5)
       {
-        hsize_t recs2write     = 1; // number of records to append
-        size_t * field_sizes   = NULL;
-        size_t * field_offsets = NULL;
-        size_t * size_out      = NULL;
-
-        // retrieve the input fields needed for the append_records call
-        H5TBget_table_info ( itsFileID, itsName.c_str(), &nfields, &nofRecords_p );
-
-        field_sizes = (size_t*)malloc( nfields * sizeof(size_t) );
-        field_offsets = (size_t*)malloc( nfields * sizeof(size_t) );
-        size_out = (size_t*)malloc( sizeof(size_t) );
-
-        status = H5TBget_field_info( itsFileID, itsName.c_str(), NULL, field_sizes,
-                                     field_offsets, size_out );
-
-        if ( itsFirstRecord )
-          {
-            hsize_t start = 0;
-            hsize_t numrows = 1;
-            status = H5TBwrite_records( itsFileID, itsName.c_str(), start,
-                                        numrows, *size_out, field_offsets, field_sizes,
-                                        data);
-            itsFirstRecord = false;
-          }
-        else
-          {
-            status = H5TBappend_records ( itsFileID, itsName.c_str(), recs2write,
-                                          *size_out, field_offsets,
-                                          field_sizes, data );
-          }
-        free( field_sizes );
-        free( field_offsets );
-        free( size_out );
+        append (data, 1);
       }
     else
       {
@@ -1450,43 +1650,10 @@ namespace DAL {
   {
     if (itsFiletype.type()==dalFileType::HDF5)
       {
-        size_t * field_sizes = NULL;
-        size_t * field_offsets = NULL;
-        size_t * size_out = NULL;
-
-        // retrieve the input fields needed for the append_records call
-        H5TBget_table_info( itsFileID, itsName.c_str(), &nfields, &nofRecords_p );
-
-        field_sizes  = (size_t *)malloc((size_t)nfields * sizeof(size_t));
-        field_offsets = (size_t *)malloc((size_t)nfields * sizeof(size_t));
-        size_out = (size_t*)malloc( sizeof(size_t) );
-
-        status = H5TBget_field_info( itsFileID, itsName.c_str(), NULL, field_sizes,
-                                     field_offsets, size_out );
-
-        if ( itsFirstRecord )
+        if (row_count > 0)
           {
-            hsize_t start = 0;
-            if (row_count>1)
-              {
-                status = H5TBappend_records ( itsFileID, itsName.c_str(),
-                                              (hsize_t)row_count-1, *size_out,
-                                              field_offsets, field_sizes, data);
-              }
-            status = H5TBwrite_records( itsFileID, itsName.c_str(), start,
-                                        (hsize_t)row_count, *size_out,
-                                        field_offsets, field_sizes, data );
-            itsFirstRecord = false;
+            append (data, row_count);
           }
-        else
-          {
-            status = H5TBappend_records ( itsFileID, itsName.c_str(),
-                                          (hsize_t)row_count, *size_out,
-                                          field_offsets, field_sizes, data);
-          }
-        free( field_sizes );
-        free( field_offsets );
-        free( size_out );
       }
     else
       {
@@ -1495,6 +1662,247 @@ namespace DAL {
       }
   }
 
+  //_____________________________________________________________________________
+  //                                                                       append
+
+  /*!
+    \param data    -- Records to append, laid out as given by the fields of the
+           table, i.e. <tt>nofRows*recordSize()</tt> bytes.
+    \param nofRows -- Number of records to append.
+
+    \return status -- Returns \e false if the records could not be written.
+
+    The first records written to a newly created table replace the
+    placeholder record, which has to be present when creating an HDF5 table.
+    Apart from the dataset being extended and the records written, no calls
+    into the library are made, as the layout of the records is cached.
+  */
+  bool dalTable::append (void const *data,
+			 hsize_t const &nofRows)
+  {
+    if (itsFiletype.type() != dalFileType::HDF5) {
+      std::cerr << "[dalTable::append] Operation not yet supported for type "
+		<< itsFiletype.name() << std::endl;
+      return false;
+    }
+
+    if (nofRows == 0) {
+      return true;
+    } else if (data == NULL || !h5cacheLayout()) {
+      return false;
+    }
+
+    hsize_t start = itsFirstRecord ? 0 : nofRecords_p;
+    hsize_t count = nofRows;
+    hsize_t end   = start + nofRows;
+
+    if (end > nofRecords_p) {
+      if (H5Dset_extent (itsRecordsID, &end) < 0) {
+	std::cerr << "[dalTable::append] Failed to extend table "
+		  << itsName << std::endl;
+	return false;
+      }
+      nofRecords_p = end;
+    }
+
+    hid_t fileSpace = H5Dget_space (itsRecordsID);
+    hid_t memSpace  = H5Screate_simple (1, &count, NULL);
+
+    H5Sselect_hyperslab (fileSpace, H5S_SELECT_SET, &start, NULL, &count, NULL);
+
+    status = H5Dwrite (itsRecordsID,
+		       itsRecordType,
+		       memSpace,
+		       fileSpace,
+		       H5P_DEFAULT,
+		       data);
+
+    H5Sclose (memSpace);
+    H5Sclose (fileSpace);
+
+    if (status < 0) {
+      std::cerr << "[dalTable::append] Failed to write records to table "
+		<< itsName << std::endl;
+      return false;
+    }
+
+    itsFirstRecord = false;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   recordSize
+
+  /*!
+    \return recordSize -- Size of a record in memory, as expected by append()
+            and readRows(); returns 0 if the table is not available.
+  */
+  size_t dalTable::recordSize ()
+  {
+    return h5cacheLayout() ? itsRecordSize : 0;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 readFiltered
+
+  /*!
+    \retval data   -- The selected columns of the rows passing the filter, one
+           record of filteredRecordSize() bytes per row. A record is laid out
+           as a C struct with the selected columns as members, in the order of
+           the selection; if no columns are selected, a record holds all
+           columns of the table, as for readRows().
+    \retval rows   -- Numbers of the rows passing the filter.
+    \param blocksize -- Number of rows read and evaluated at a time.
+    \return nofRows -- The number of rows passing the filter; returns -1 if the
+            table could not be read, or if the filter refers to columns not
+            present in the table.
+
+    The table is scanned in blocks of rows. Per block, the columns referred to
+    by the conditions of the filter are read first, converted to \c double;
+    the selected columns then are read for the matching rows only. Neither the
+    full table nor the unselected columns are held in memory.
+  */
+  long dalTable::readFiltered (std::vector<char> &data,
+			       std::vector<hsize_t> &rows,
+			       hsize_t const &blocksize)
+  {
+    data.clear();
+    rows.clear();
+
+    if (itsFiletype.type() != dalFileType::HDF5) {
+      std::cerr << "[dalTable::readFiltered] Operation not yet supported for type "
+		<< itsFiletype.name() << std::endl;
+      return -1;
+    } else if (blocksize == 0 || !h5cacheLayout()) {
+      return -1;
+    }
+
+    std::vector<dalFilter::Condition> conditions = itsFilter.conditions();
+    std::vector<std::string> columns;
+    std::vector<size_t> conditionOffset (conditions.size());
+    hid_t selectedType  = h5fieldsType (itsFilter.columns());
+    hid_t conditionType = 0;
+
+    if (selectedType < 0) {
+      return -1;
+    }
+
+    /* Columns referred to by the conditions, each read once */
+    for (unsigned int n=0; n<conditions.size(); ++n) {
+      unsigned int k = 0;
+      while (k<columns.size() && columns[k] != conditions[n].column) {
+	++k;
+      }
+      if (k == columns.size()) {
+	columns.push_back (conditions[n].column);
+      }
+      conditionOffset[n] = k;
+    }
+
+    if (!columns.empty()) {
+      conditionType = h5fieldsType (columns, true);
+      if (conditionType < 0) {
+	H5Tclose (selectedType);
+	return -1;
+      }
+      for (unsigned int n=0; n<conditions.size(); ++n) {
+	conditionOffset[n] = H5Tget_member_offset (conditionType, conditionOffset[n]);
+      }
+    }
+
+    size_t recordSize    = H5Tget_size (selectedType);
+    size_t conditionSize = conditionType > 0 ? H5Tget_size (conditionType) : 0;
+    std::vector<char> buffer (conditionSize*blocksize);
+    std::vector<hsize_t> matches;
+    hid_t fileSpace = H5Dget_space (itsRecordsID);
+    bool ok         = true;
+    double value;
+
+    for (hsize_t start=0; ok && start<nofRecords_p; start+=blocksize) {
+      hsize_t count = nofRecords_p-start < blocksize ? nofRecords_p-start : blocksize;
+
+      matches.clear();
+      H5Sselect_hyperslab (fileSpace, H5S_SELECT_SET, &start, NULL, &count, NULL);
+
+      if (conditionType > 0) {
+	hid_t memSpace = H5Screate_simple (1, &count, NULL);
+	ok = H5Dread (itsRecordsID, conditionType, memSpace, fileSpace,
+		      H5P_DEFAULT, &buffer[0]) >= 0;
+	H5Sclose (memSpace);
+
+	for (hsize_t row=0; ok && row<count; ++row) {
+	  bool pass = true;
+	  for (unsigned int n=0; pass && n<conditions.size(); ++n) {
+	    memcpy (&value, &buffer[row*conditionSize+conditionOffset[n]], sizeof(double));
+	    pass = dalFilter::evaluate (conditions[n], value);
+	  }
+	  if (pass) {
+	    matches.push_back (start+row);
+	  }
+	}
+
+	if (matches.empty()) {
+	  continue;
+	} else if (matches.size() < count) {
+	  H5Sselect_elements (fileSpace, H5S_SELECT_SET, matches.size(), &matches[0]);
+	}
+      } else {
+	for (hsize_t row=0; row<count; ++row) {
+	  matches.push_back (start+row);
+	}
+      }
+
+      /* Selected columns of the matching rows */
+      hsize_t nofMatches = matches.size();
+      size_t offset      = data.size();
+      hid_t memSpace     = H5Screate_simple (1, &nofMatches, NULL);
+
+      data.resize (offset + nofMatches*recordSize);
+      ok = ok && H5Dread (itsRecordsID, selectedType, memSpace, fileSpace,
+			  H5P_DEFAULT, &data[offset]) >= 0;
+      H5Sclose (memSpace);
+
+      rows.insert (rows.end(), matches.begin(), matches.end());
+    }
+
+    H5Sclose (fileSpace);
+    H5Tclose (selectedType);
+    if (conditionType > 0) {
+      H5Tclose (conditionType);
+    }
+
+    if (!ok) {
+      std::cerr << "[dalTable::readFiltered] Failed to read records of table "
+		<< itsName << std::endl;
+      data.clear();
+      rows.clear();
+      return -1;
+    }
+
+    return rows.size();
+  }
+
+  //_____________________________________________________________________________
+  //                                                           filteredRecordSize
+
+  /*!
+    \return recordSize -- Size of a record returned by readFiltered(); returns
+            0 if the selected columns are not present in the table.
+  */
+  size_t dalTable::filteredRecordSize ()
+  {
+    hid_t datatype = h5fieldsType (itsFilter.columns());
+    size_t size    = 0;
+
+    if (datatype > 0) {
+      size = H5Tget_size (datatype);
+      H5Tclose (datatype);
+    }
+
+    return size;
+  }
+
   //_____________________________________________________________________________
   //                                                                 setAttribute
   
@@ -1640,47 +2048,25 @@ namespace DAL {
   {
     if (itsFiletype.type()==dalFileType::HDF5)
       {
-        // retrieve the input fields needed for the append_records call
-        H5TBget_table_info ( itsFileID, itsName.c_str(), &nfields, &nofRecords_p );
-
-        size_t * field_sizes   = new size_t[nfields];
-        size_t * field_offsets = new size_t[nfields];
-        size_t * size_out      = new size_t[1];
-        itsFieldNames = (char**)malloc( nfields * sizeof(char*) );
- 
-	for (unsigned int ii=0; ii<nfields; ii++) {
-	  itsFieldNames[ii] = (char*)malloc(MAX_COL_NAME_SIZE*sizeof(char));
-	}
-	
-        status = H5TBget_field_info (itsFileID,
-				     itsName.c_str(),
-				     itsFieldNames,
-                                     field_sizes,
-				     field_offsets,
-				     size_out);
+        if (!h5cacheLayout())
+          {
+            std::cerr << "[dalTable::readRows] Table " << itsName
+                      << " not available." << std::endl;
+            return;
+          }
 
         hsize_t start = nstart;
         hsize_t nrecs = numberRecs;
+        size_t size_out = buffersize > 0 ? size_t(buffersize) : itsRecordSize;
 
-        if (buffersize > 0)
-          size_out[0] = buffersize;
         status = H5TBread_records (itsFileID,
 				   itsName.c_str(),
 				   start,
 				   nrecs,
-                                   size_out[0],
-				   field_offsets,
-				   field_sizes,
+                                   size_out,
+				   &itsFieldOffsets[0],
+				   &itsFieldSizes[0],
                                    data_out);
-	/* Release allocated memory */
-        delete [] field_sizes;
-        delete [] field_offsets;
-        delete [] size_out;
-
-        for (unsigned int ii=0; ii<nfields; ii++) {
-	  free(itsFieldNames[ii]);
-	}
-        free(itsFieldNames);
 
         if (status < 0) {
 	  std::cerr << "[dalTable::readRows]"
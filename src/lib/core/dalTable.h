@@ -50,6 +50,27 @@ namespace DAL {
 
     A dalTable can reside within a dataset, or within a group that is within
     a dataset.
+
+    For HDF5 tables the layout of the records in memory -- size and offset of
+    the fields -- is retrieved once and kept until the columns of the table
+    are changed. Appending records, as done by appendRow(), appendRows() and
+    append(), then comes down to extending the dataset and a single
+    <tt>H5Dwrite</tt>, without querying the table for its fields on every
+    call. The table does not keep any records in memory.
+
+    Scans over large tables are done with readFiltered(): only the columns
+    selected by the filter (see setFilter()) are read, block by block, and
+    the conditions of the filter are evaluated on the fly, such that only
+    the selected columns of the matching rows are kept in memory:
+
+    \code
+    table->setFilter ("TIME,DATA", "TIME >= 100 AND FLAG == 0");
+
+    std::vector<char> data;
+    std::vector<hsize_t> rows;
+    long nofRows = table->readFiltered (data, rows);
+    size_t size  = table->filteredRecordSize ();
+    \endcode
   */
   
   class dalTable : public dalObjectBase {
@@ -75,6 +96,18 @@ namespace DAL {
     bool itsFirstRecord;
     //! List of table columns
     std::vector<dalColumn> columns;
+    //! Is the layout of the records cached?
+    bool itsLayoutCached;
+    //! HDF5 dataset holding the records, opened along with the cached layout
+    hid_t itsRecordsID;
+    //! HDF5 in-memory datatype of a record
+    hid_t itsRecordType;
+    //! Size of a record in memory, [Bytes]
+    size_t itsRecordSize;
+    //! Sizes of the fields of a record in memory, [Bytes]
+    std::vector<size_t> itsFieldSizes;
+    //! Offsets of the fields within a record in memory, [Bytes]
+    std::vector<size_t> itsFieldOffsets;
     
 #ifdef DAL_WITH_CASA
     casa::Table * itsCasaTable;
@@ -93,12 +126,19 @@ namespace DAL {
     dalTable (dalFileType const &filetype);
     //! Table constructor for a specific file format.
     dalTable (dalFileType::Type const &filetype);
+    //! Copy constructor
+    dalTable (dalTable const &other);
     
     // === Destruction ==========================================================
 
     //! Destructor
     ~dalTable();
     
+    // === Operators ============================================================
+    
+    //! Overloading of the copy operator
+    dalTable& operator= (dalTable const &other);
+    
     // === Parameter access =====================================================
     
     //! Get the HDF5 file identifier
@@ -201,6 +241,17 @@ namespace DAL {
     void appendRow (void * data );
     //! Append rows of data to the table.
     void appendRows (void * data, long number_of_rows );
+    //! Append a block of records to the table, with a single write
+    bool append (void const *data,
+		 hsize_t const &nofRows=1);
+    //! Get the size of a record in memory, [Bytes]
+    size_t recordSize ();
+    //! Read the selected columns of the rows passing the filter
+    long readFiltered (std::vector<char> &data,
+		       std::vector<hsize_t> &rows,
+		       hsize_t const &blocksize=CHUNK_SIZE);
+    //! Get the size of a record as returned by readFiltered(), [Bytes]
+    size_t filteredRecordSize ();
     //! List the column of the table
     std::vector<std::string> listColumns();
     //! Read rows from the table
@@ -304,6 +355,10 @@ namespace DAL {
 
   //! Initialize internal parameters
   void init ();
+  //! Unconditional copying
+  void copy (dalTable const &other);
+  //! Unconditional deletion
+  void destroy ();
   //! Setup for adding another column to an HDF5 table
   bool h5addColumn_setup (std::string const &column_name,
 			  bool &removedummy);
@@ -311,6 +366,13 @@ namespace DAL {
 			   std::string const & colname,
 			   hid_t const & field_type,
 			   bool const & removedummy );
+  //! Retrieve the layout of the records, unless already cached
+  bool h5cacheLayout ();
+  //! Discard the cached layout of the records
+  void h5releaseLayout ();
+  //! Create the in-memory datatype holding a subset of the fields
+  hid_t h5fieldsType (std::vector<std::string> const &columns,
+		      bool const &asDouble=false);
 
   };
   
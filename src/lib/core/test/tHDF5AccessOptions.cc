@@ -0,0 +1,383 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5AccessOptions.h>
+#include <core/HDF5Dataset.h>
+#include <core/HDF5Object.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::HDF5AccessOptions;
+using DAL::HDF5Dataset;
+using DAL::HDF5Object;
+using DAL::IO_Mode;
+
+/*!
+  \file tHDF5AccessOptions.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief A collection of test routines for the DAL::HDF5AccessOptions class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//! Size of the chunk cache used throughout the tests, [Bytes]
+const size_t cacheBytes = 16*1024*1024;
+
+//_______________________________________________________________________________
+//                                                              test_constructors
+
+/*!
+  \brief Test constructors for a new HDF5AccessOptions object
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tHDF5AccessOptions::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing HDF5AccessOptions() ..." << endl;
+  {
+    HDF5AccessOptions options;
+    options.summary();
+
+    if (!options.isDefault()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing HDF5AccessOptions(HDF5AccessOptions) ..." << endl;
+  {
+    HDF5AccessOptions options;
+    options.setChunkCache (cacheBytes, 10007, 1.0);
+    options.setLatestFormat (true);
+
+    HDF5AccessOptions other (options);
+    other.summary();
+
+    if (other.chunkCacheBytes() != cacheBytes
+	|| other.chunkCacheSlots() != 10007
+	|| other.chunkCacheW0() != 1.0
+	|| !other.latestFormat()) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                test_parameters
+
+/*!
+  \brief Test setting and validation of the parameters
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_parameters ()
+{
+  cout << "\n[tHDF5AccessOptions::test_parameters]\n" << endl;
+
+  int nofFailedTests (0);
+  HDF5AccessOptions options;
+
+  cout << "[1] Testing nofChunkSlots() ..." << endl;
+  {
+    size_t small = HDF5AccessOptions::nofChunkSlots (1024*1024, 1024*1024);
+    size_t large = HDF5AccessOptions::nofChunkSlots (cacheBytes, 64*1024);
+
+    cout << "-- 1 chunk in cache    : " << small << " slots" << endl;
+    cout << "-- 256 chunks in cache : " << large << " slots" << endl;
+
+    /* Never below the library default, prime, about 100 slots per chunk */
+    if (small != 521 || large != 25601) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing setChunkCache() ..." << endl;
+  {
+    /* About 521 slots per MB, as for the library default */
+    options.setChunkCache (cacheBytes);
+    if (options.chunkCacheBytes() != cacheBytes
+	|| options.chunkCacheSlots() < 521*15
+	|| options.chunkCacheSlots() > 521*17) {
+      ++nofFailedTests;
+    }
+    /* Invalid preemption policy */
+    if (options.setChunkCache (cacheBytes, 0, 1.5)) {
+      ++nofFailedTests;
+    }
+    /* Reset to the library default */
+    options.setChunkCache (0);
+    if (!options.isDefault()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing setAlignment() ..." << endl;
+  {
+    if (options.setAlignment (1024, 0)) {
+      ++nofFailedTests;
+    }
+    if (!options.setAlignment (1024*1024, 4096) || options.isDefault()) {
+      ++nofFailedTests;
+    }
+    options.setAlignment (0, 1);
+  }
+
+  cout << "[4] Testing setPageBuffering() ..." << endl;
+  {
+#ifdef DAL_HDF5_PAGE_BUFFERING
+    if (options.setPageBuffering (1024, 4096)) {
+      ++nofFailedTests;
+    }
+    if (!options.setPageBuffering (1024*1024, 4096)) {
+      ++nofFailedTests;
+    }
+#else
+    if (options.setPageBuffering (1024*1024, 4096)) {
+      ++nofFailedTests;
+    }
+#endif
+    options.setPageBuffering (0);
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                            test_propertyLists
+
+/*!
+  \brief Test the property lists handed to the HDF5 library
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_propertyLists ()
+{
+  cout << "\n[tHDF5AccessOptions::test_propertyLists]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Default property lists ..." << endl;
+  {
+    HDF5AccessOptions options;
+
+    if (options.fileAccessList() != H5P_DEFAULT
+	|| options.fileCreationList() != H5P_DEFAULT
+	|| options.datasetAccessList() != H5P_DEFAULT) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] File-access property list ..." << endl;
+  {
+    HDF5AccessOptions options;
+    options.setChunkCache (cacheBytes, 10007, 1.0);
+    options.setSieveBufferSize (4*1024*1024);
+    options.setAlignment (64*1024, 4096);
+
+    hid_t plist = options.fileAccessList();
+    int mdcElements;
+    size_t nofSlots, nofBytes, sieveSize;
+    hsize_t threshold, alignment;
+    double w0;
+
+    H5Pget_cache (plist, &mdcElements, &nofSlots, &nofBytes, &w0);
+    H5Pget_sieve_buf_size (plist, &sieveSize);
+    H5Pget_alignment (plist, &threshold, &alignment);
+    HDF5AccessOptions::release (plist);
+
+    cout << "-- Chunk cache  = " << nofBytes << " Bytes, " << nofSlots
+	 << " slots, w0 = " << w0 << endl;
+    cout << "-- Sieve buffer = " << sieveSize << " Bytes" << endl;
+    cout << "-- Alignment    = " << alignment << " above " << threshold << endl;
+
+    if (nofBytes != cacheBytes || nofSlots != 10007 || w0 != 1.0
+	|| sieveSize != 4*1024*1024 || alignment != 4096 || threshold != 64*1024) {
+      ++nofFailedTests;
+    }
+    if (plist != H5P_DEFAULT) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Dataset-access property list ..." << endl;
+  {
+    HDF5AccessOptions options;
+    options.setChunkCache (cacheBytes, 10007, 0.5);
+
+    hid_t plist = options.datasetAccessList();
+    size_t nofSlots, nofBytes;
+    double w0;
+
+    H5Pget_chunk_cache (plist, &nofSlots, &nofBytes, &w0);
+    HDF5AccessOptions::release (plist);
+
+    if (nofBytes != cacheBytes || nofSlots != 10007 || w0 != 0.5) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                     test_files
+
+/*!
+  \brief Test opening files and datasets with access options
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_files ()
+{
+  cout << "\n[tHDF5AccessOptions::test_files]\n" << endl;
+
+  int nofFailedTests (0);
+  std::string filename ("tHDF5AccessOptions.h5");
+  std::vector<hsize_t> shape (2);
+  std::vector<hsize_t> chunk (2);
+
+  shape[0] = 1024;
+  shape[1] = 64;
+  chunk[0] = 128;
+  chunk[1] = 16;
+
+  cout << "[1] Create file with latest format and metadata cache ..." << endl;
+  {
+    HDF5AccessOptions options;
+    options.setLatestFormat (true);
+    options.setMetadataCacheSize (4*1024*1024);
+
+    hid_t fileID = HDF5Object::openFile (filename,
+					 IO_Mode(IO_Mode::Create),
+					 options);
+    if (fileID < 0) {
+      ++nofFailedTests;
+    } else {
+      HDF5Dataset dataset (fileID, "Data", shape, chunk, H5T_NATIVE_FLOAT);
+      H5Fclose (fileID);
+    }
+  }
+
+  cout << "[2] Open file with page buffering as fallback ..." << endl;
+  {
+    HDF5AccessOptions options;
+    options.setPageBuffering (1024*1024);
+
+    /* The file was not created with paged file space management */
+    hid_t fileID = HDF5Object::openExisting (filename, H5F_ACC_RDONLY, options);
+    if (fileID < 0) {
+      ++nofFailedTests;
+    } else {
+      H5Fclose (fileID);
+    }
+  }
+
+  cout << "[3] Set chunk cache of an opened dataset ..." << endl;
+  {
+    hid_t fileID = HDF5Object::openFile (filename,
+					 IO_Mode(IO_Mode::ReadOnly));
+    HDF5Dataset dataset (fileID, "Data");
+
+    if (!dataset.setChunkCache (cacheBytes)) {
+      ++nofFailedTests;
+    }
+
+    hid_t plist = H5Dget_access_plist (dataset.objectID());
+    size_t nofSlots, nofBytes;
+    double w0;
+    H5Pget_chunk_cache (plist, &nofSlots, &nofBytes, &w0);
+    H5Pclose (plist);
+
+    cout << "-- Chunk size  = " << dataset.chunkBytes() << " Bytes" << endl;
+    cout << "-- Chunk cache = " << nofBytes << " Bytes, " << nofSlots
+	 << " slots" << endl;
+
+    if (nofBytes != cacheBytes
+	|| nofSlots != HDF5AccessOptions::nofChunkSlots (cacheBytes, dataset.chunkBytes())
+	|| dataset.shape() != shape) {
+      ++nofFailedTests;
+    }
+
+    H5Fclose (fileID);
+  }
+
+#ifdef DAL_HDF5_PAGE_BUFFERING
+  cout << "[4] Create and re-open paged file ..." << endl;
+  {
+    HDF5AccessOptions options;
+    options.setPageBuffering (1024*1024, 4096);
+
+    hid_t fileID = HDF5Object::openFile (filename,
+					 IO_Mode(IO_Mode::Create),
+					 options);
+    HDF5Dataset (fileID, "Data", shape, chunk, H5T_NATIVE_FLOAT);
+    H5Fclose (fileID);
+
+    fileID = HDF5Object::openExisting (filename, H5F_ACC_RDONLY, options);
+
+    hid_t plist = H5Fget_access_plist (fileID);
+    size_t bufferSize;
+    unsigned int minMeta, minRaw;
+    H5Pget_page_buffer_size (plist, &bufferSize, &minMeta, &minRaw);
+    H5Pclose (plist);
+
+    cout << "-- Page buffer = " << bufferSize << " Bytes" << endl;
+
+    if (bufferSize != 1024*1024) {
+      ++nofFailedTests;
+    }
+
+    H5Fclose (fileID);
+  }
+#endif
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main ()
+{
+  int nofFailedTests (0);
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_parameters ();
+  nofFailedTests += test_propertyLists ();
+  nofFailedTests += test_files ();
+
+  return nofFailedTests;
+}
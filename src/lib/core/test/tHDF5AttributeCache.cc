@@ -0,0 +1,350 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5AttributeCache.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::HDF5Attribute;
+using DAL::HDF5AttributeCache;
+
+/*!
+  \file tHDF5AttributeCache.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief A collection of test routines for the DAL::HDF5AttributeCache class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//_______________________________________________________________________________
+//                                                              test_constructors
+
+/*!
+  \brief Test constructors for a new HDF5AttributeCache object
+
+  \param groupID -- Group without any attributes attached.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors (hid_t const &groupID)
+{
+  cout << "\n[tHDF5AttributeCache::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing HDF5AttributeCache() ..." << endl;
+  {
+    HDF5AttributeCache cache;
+    cache.summary();
+
+    if (cache.isLoaded() || cache.deferredWrites() || cache.nofAttributes() != 0) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing HDF5AttributeCache(hid_t) ..." << endl;
+  {
+    HDF5AttributeCache cache (groupID);
+    cache.summary();
+
+    if (!cache.isLoaded() || cache.location() != groupID || cache.nofAttributes() != 0) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                      test_load
+
+/*!
+  \brief Test reading attributes written by HDF5Attribute into the cache
+
+  \param groupID -- Group to which the attributes are attached.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_load (hid_t const &groupID)
+{
+  cout << "\n[tHDF5AttributeCache::test_load]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<double> position (3);
+  std::vector<std::string> units (3, "m");
+
+  position[0] = 1.5;
+  position[1] = -2.5;
+  position[2] = 3.5;
+
+  HDF5Attribute::write (groupID, "NOF_DIPOLES", int(96));
+  HDF5Attribute::write (groupID, "SAMPLE_FREQUENCY", double(200.0));
+  HDF5Attribute::write (groupID, "POSITION_VALUE", position);
+  HDF5Attribute::write (groupID, "POSITION_UNIT", units);
+  HDF5Attribute::write (groupID, "FLAGGED", true);
+
+  /* Fixed-length string, as written by other tools */
+  {
+    hid_t datatype  = H5Tcopy (H5T_C_S1);
+    hid_t dataspace = H5Screate (H5S_SCALAR);
+    H5Tset_size (datatype, 8);
+    hid_t attribute = H5Acreate (groupID, "TELESCOPE", datatype, dataspace,
+				 H5P_DEFAULT, H5P_DEFAULT);
+    H5Awrite (attribute, datatype, "LOFAR\0\0\0");
+    H5Aclose (attribute);
+    H5Sclose (dataspace);
+    H5Tclose (datatype);
+  }
+
+  HDF5AttributeCache cache (groupID);
+
+  cout << "[1] Testing load(hid_t) ..." << endl;
+  {
+    cache.summary();
+
+    if (cache.nofAttributes() != 6 || cache.nofModified() != 0) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing get(string,T) ..." << endl;
+  {
+    int nofDipoles       = 0;
+    double frequency     = 0;
+    bool flagged         = false;
+    std::string telescope;
+
+    if (!cache.get ("NOF_DIPOLES", nofDipoles) || nofDipoles != 96
+	|| !cache.get ("SAMPLE_FREQUENCY", frequency) || frequency != 200.0
+	|| !cache.get ("FLAGGED", flagged) || !flagged
+	|| !cache.get ("TELESCOPE", telescope) || telescope != "LOFAR") {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing get(string,vector<T>) ..." << endl;
+  {
+    std::vector<double> valDouble;
+    std::vector<std::string> valString;
+
+    if (!cache.get ("POSITION_VALUE", valDouble) || valDouble != position
+	|| !cache.get ("POSITION_UNIT", valString) || valString != units) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[4] Testing get() with type conversion ..." << endl;
+  {
+    float frequency = 0;
+    std::vector<int> valInt;
+    unsigned short nofDipoles = 0;
+
+    if (!cache.get ("SAMPLE_FREQUENCY", frequency) || frequency != 200.0f
+	|| !cache.get ("POSITION_VALUE", valInt) || valInt.size() != 3
+	|| !cache.get ("NOF_DIPOLES", nofDipoles) || nofDipoles != 96) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[5] Testing get() for missing or inconsistent attributes ..." << endl;
+  {
+    int valInt = 0;
+    double valDouble = 0;
+    std::string valString;
+
+    if (cache.get ("NOT_THERE", valInt)
+	|| cache.get ("TELESCOPE", valInt)
+	|| cache.get ("NOF_DIPOLES", valString)
+	|| cache.get ("POSITION_VALUE", valDouble)) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                       test_set
+
+/*!
+  \brief Test modifying attributes through the cache
+
+  \param groupID -- Group to which the attributes are attached.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_set (hid_t const &groupID)
+{
+  cout << "\n[tHDF5AttributeCache::test_set]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing set() with immediate writes ..." << endl;
+  {
+    HDF5AttributeCache cache (groupID);
+    int nofDipoles = 0;
+
+    if (!cache.set ("NOF_DIPOLES", int(48)) || cache.nofModified() != 0) {
+      ++nofFailedTests;
+    }
+
+    HDF5Attribute::read (groupID, "NOF_DIPOLES", nofDipoles);
+
+    if (nofDipoles != 48) {
+      cerr << "-- Attribute not written: " << nofDipoles << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing set() with deferred writes ..." << endl;
+  {
+    HDF5AttributeCache cache (groupID);
+    std::vector<std::string> stations (2);
+    double frequency = 0;
+
+    stations[0] = "CS002";
+    stations[1] = "CS003";
+
+    cache.setDeferredWrites (true);
+
+    /* Unchanged values are not marked as modified */
+    cache.set ("SAMPLE_FREQUENCY", double(200.0));
+    cache.set ("TELESCOPE", std::string("LOFAR"));
+
+    if (cache.nofModified() != 0) {
+      cerr << "-- Unchanged values marked as modified" << endl;
+      ++nofFailedTests;
+    }
+
+    cache.set ("SAMPLE_FREQUENCY", double(160.0));
+    cache.set ("TELESCOPE", std::string("LOFAR-NL"));
+    cache.set ("STATIONS_LIST", stations);
+
+    HDF5Attribute::read (groupID, "SAMPLE_FREQUENCY", frequency);
+
+    if (cache.nofModified() != 3 || frequency != 200.0) {
+      cerr << "-- Modifications written before flush()" << endl;
+      ++nofFailedTests;
+    }
+
+    if (!cache.flush() || cache.nofModified() != 0) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing the values written by flush() ..." << endl;
+  {
+    HDF5AttributeCache cache (groupID);
+    std::vector<std::string> stations;
+    std::string telescope;
+    double frequency = 0;
+
+    if (!cache.get ("SAMPLE_FREQUENCY", frequency) || frequency != 160.0
+	|| !cache.get ("TELESCOPE", telescope) || telescope != "LOFAR-NL"
+	|| !cache.get ("STATIONS_LIST", stations) || stations.size() != 2
+	|| stations[1] != "CS003") {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[4] Testing set() changing the number of elements ..." << endl;
+  {
+    HDF5AttributeCache cache (groupID);
+    std::vector<double> position (2, 0.5);
+    std::vector<double> result;
+
+    cache.set ("POSITION_VALUE", position);
+
+    HDF5AttributeCache check (groupID);
+
+    if (!check.get ("POSITION_VALUE", result) || result != position) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[5] Testing invalidate() after writing around the cache ..." << endl;
+  {
+    HDF5AttributeCache cache (groupID);
+    std::string telescope;
+    int nofDipoles = 0;
+
+    cache.setDeferredWrites (true);
+    cache.set ("TELESCOPE", std::string("LOFAR-UK"));
+
+    HDF5Attribute::write (groupID, "NOF_DIPOLES", int(96));
+    cache.invalidate ();
+
+    if (cache.isLoaded() || !cache.load (groupID)
+	|| !cache.get ("NOF_DIPOLES", nofDipoles) || nofDipoles != 96) {
+      cerr << "-- Stale value read from cache: " << nofDipoles << endl;
+      ++nofFailedTests;
+    }
+
+    /* Pending modifications are kept */
+    if (cache.nofModified() != 1
+	|| !cache.get ("TELESCOPE", telescope) || telescope != "LOFAR-UK") {
+      ++nofFailedTests;
+    }
+
+    cache.resetModified ();
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main ()
+{
+  int nofFailedTests (0);
+  std::string filename ("tHDF5AttributeCache.h5");
+
+  hid_t fileID = H5Fcreate (filename.c_str(),
+			    H5F_ACC_TRUNC,
+			    H5P_DEFAULT,
+			    H5P_DEFAULT);
+  if (fileID < 0) {
+    cerr << "ERROR : Failed to create file " << filename << endl;
+    return -1;
+  }
+
+  hid_t groupID = H5Gcreate (fileID, "Station001",
+			     H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+  nofFailedTests += test_constructors (groupID);
+  nofFailedTests += test_load (groupID);
+  nofFailedTests += test_set (groupID);
+
+  H5Gclose (groupID);
+  H5Fclose (fileID);
+
+  return nofFailedTests;
+}
@@ -0,0 +1,378 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5ChunkPlanner.h>
+#include <core/HDF5Dataset.h>
+#include <core/HDF5Object.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::HDF5ChunkPlanner;
+using DAL::HDF5Dataset;
+using DAL::HDF5Object;
+using DAL::IO_Mode;
+
+/*!
+  \file tHDF5ChunkPlanner.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief A collection of test routines for the DAL::HDF5ChunkPlanner class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//_______________________________________________________________________________
+//                                                                     checkShape
+
+/*!
+  \brief Compare a chunk shape with the expected one
+
+  \param chunk    -- Chunk shape returned by the planner.
+  \param expected -- Expected chunk shape.
+  \return nofFailedTests -- 1 if the shapes differ, 0 otherwise.
+*/
+int checkShape (std::vector<hsize_t> const &chunk,
+		std::vector<hsize_t> const &expected)
+{
+  cout << "-- Chunk shape = " << chunk << endl;
+
+  if (chunk != expected) {
+    cerr << "-- Expected chunk shape " << expected << endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+//_______________________________________________________________________________
+//                                                              test_constructors
+
+/*!
+  \brief Test constructors for a new HDF5ChunkPlanner object
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tHDF5ChunkPlanner::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing HDF5ChunkPlanner() ..." << endl;
+  {
+    HDF5ChunkPlanner planner;
+    planner.summary();
+
+    if (planner.pattern() != HDF5ChunkPlanner::Automatic
+	|| planner.targetBytes() != HDF5ChunkPlanner::defaultTargetBytes
+	|| planner.growthAxis() != -1) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing HDF5ChunkPlanner(AccessPattern,size_t,int) ..." << endl;
+  {
+    HDF5ChunkPlanner planner (HDF5ChunkPlanner::Spectrum, 4096, 0);
+    planner.summary();
+
+    if (planner.pattern() != HDF5ChunkPlanner::Spectrum
+	|| planner.targetBytes() != 4096
+	|| planner.growthAxis() != 0) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing HDF5ChunkPlanner(HDF5ChunkPlanner) ..." << endl;
+  {
+    HDF5ChunkPlanner planner (HDF5ChunkPlanner::Tile, 8192);
+    HDF5ChunkPlanner other (planner);
+    other.summary();
+
+    if (other.pattern() != HDF5ChunkPlanner::Tile
+	|| other.targetBytes() != 8192) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[4] Testing setTargetBytes(0) ..." << endl;
+  {
+    HDF5ChunkPlanner planner (HDF5ChunkPlanner::Tile);
+
+    if (planner.setTargetBytes (0)
+	|| planner.targetBytes() != HDF5ChunkPlanner::defaultTargetBytes) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                test_chunkShape
+
+/*!
+  \brief Test the chunk shapes chosen for the various access patterns
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_chunkShape ()
+{
+  cout << "\n[tHDF5ChunkPlanner::test_chunkShape]\n" << endl;
+
+  int nofFailedTests (0);
+  size_t typeSize = sizeof(float);
+  /* 1 MB of float values */
+  hsize_t budget  = HDF5ChunkPlanner::defaultTargetBytes/typeSize;
+  std::vector<hsize_t> shape (2);
+  std::vector<hsize_t> expected (2);
+
+  shape[0] = 1000;
+  shape[1] = 4096;
+
+  cout << "[1] Extent ..." << endl;
+  {
+    HDF5ChunkPlanner planner (HDF5ChunkPlanner::Extent);
+    std::vector<hsize_t> empty (2, 0);
+    std::vector<hsize_t> ones (2, 1);
+
+    nofFailedTests += checkShape (planner.chunkShape (shape, typeSize), shape);
+    nofFailedTests += checkShape (planner.chunkShape (empty, typeSize), ones);
+  }
+
+  cout << "[2] TimeSeries ..." << endl;
+  {
+    HDF5ChunkPlanner planner (HDF5ChunkPlanner::TimeSeries);
+
+    expected[0] = 1000;
+    expected[1] = budget/1000;
+    nofFailedTests += checkShape (planner.chunkShape (shape, typeSize), expected);
+
+    /* Growing along the time axis, already long enough to fill the chunks */
+    planner.setGrowthAxis (0);
+    nofFailedTests += checkShape (planner.chunkShape (shape, typeSize), expected);
+
+    /* Growing along the time axis, starting from a single sample: the time
+       axis is sized first, the channels are capped at the side of a square
+       chunk */
+    std::vector<hsize_t> row (shape);
+    row[0]      = 1;
+    expected[0] = 512;
+    expected[1] = budget/512;
+    nofFailedTests += checkShape (planner.chunkShape (row, typeSize), expected);
+
+    /* Few channels are covered completely, the time axis takes the rest */
+    std::vector<hsize_t> narrow (2, 1);
+    narrow[1]   = 16;
+    expected[0] = budget/16;
+    expected[1] = 16;
+    nofFailedTests += checkShape (planner.chunkShape (narrow, typeSize), expected);
+
+    /* One-dimensional time series */
+    std::vector<hsize_t> series (1, 1);
+    nofFailedTests += checkShape (planner.chunkShape (series, typeSize),
+				  std::vector<hsize_t> (1, budget));
+  }
+
+  cout << "[3] Spectrum ..." << endl;
+  {
+    HDF5ChunkPlanner planner (HDF5ChunkPlanner::Spectrum, 1024*1024, 0);
+
+    expected[0] = budget/4096;
+    expected[1] = 4096;
+    nofFailedTests += checkShape (planner.chunkShape (shape, typeSize), expected);
+  }
+
+  cout << "[4] Tile ..." << endl;
+  {
+    HDF5ChunkPlanner planner (HDF5ChunkPlanner::Tile);
+    std::vector<hsize_t> cube (3, 4096);
+    std::vector<hsize_t> tile (3);
+
+    /* Square image */
+    shape[0]    = shape[1]    = 4096;
+    expected[0] = expected[1] = 512;
+    nofFailedTests += checkShape (planner.chunkShape (shape, typeSize), expected);
+
+    /* Image cube with a short axis, which is covered completely */
+    cube[2] = 4;
+    tile[0] = tile[1] = 256;
+    tile[2] = 4;
+    nofFailedTests += checkShape (planner.chunkShape (cube, typeSize), tile);
+
+    /* Small image, fitting into a single chunk */
+    shape[0] = shape[1] = 100;
+    nofFailedTests += checkShape (planner.chunkShape (shape, typeSize), shape);
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                 test_nofChunks
+
+/*!
+  \brief Test the number of chunks touched by reading a single channel
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_nofChunks ()
+{
+  cout << "\n[tHDF5ChunkPlanner::test_nofChunks]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<hsize_t> shape (2);
+  std::vector<hsize_t> start (2);
+  std::vector<hsize_t> count (2);
+
+  shape[0] = 10000;
+  shape[1] = 4096;
+  /* Time series of channel 7 */
+  start[0] = 0;
+  start[1] = 7;
+  count[0] = shape[0];
+  count[1] = 1;
+
+  HDF5ChunkPlanner timeSeries (HDF5ChunkPlanner::TimeSeries,
+			       HDF5ChunkPlanner::defaultTargetBytes,
+			       0);
+  HDF5ChunkPlanner spectrum (HDF5ChunkPlanner::Spectrum);
+  std::vector<hsize_t> chunk;
+  hsize_t nofChunks;
+
+  cout << "[1] TimeSeries ..." << endl;
+  chunk     = timeSeries.chunkShape (shape, sizeof(float));
+  nofChunks = HDF5ChunkPlanner::nofChunks (chunk, start, count);
+  cout << "-- nof. chunks read = " << nofChunks << endl;
+  if (nofChunks != 1) {
+    ++nofFailedTests;
+  }
+
+  cout << "[2] Spectrum ..." << endl;
+  chunk     = spectrum.chunkShape (shape, sizeof(float));
+  nofChunks = HDF5ChunkPlanner::nofChunks (chunk, start, count);
+  cout << "-- nof. chunks read = " << nofChunks << endl;
+  if (nofChunks != (shape[0]+63)/64) {
+    ++nofFailedTests;
+  }
+
+  cout << "[3] Inconsistent parameters ..." << endl;
+  count.resize(1);
+  if (HDF5ChunkPlanner::nofChunks (chunk, start, count) != 0) {
+    ++nofFailedTests;
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                   test_dataset
+
+/*!
+  \brief Test creating datasets with a chunk planner
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_dataset ()
+{
+  cout << "\n[tHDF5ChunkPlanner::test_dataset]\n" << endl;
+
+  int nofFailedTests (0);
+  std::string filename ("tHDF5ChunkPlanner.h5");
+  std::vector<hsize_t> shape (2);
+  std::vector<hsize_t> expected (2);
+
+  shape[0] = 1000;
+  shape[1] = 4096;
+
+  hid_t fileID = HDF5Object::openFile (filename, IO_Mode(IO_Mode::Create));
+
+  cout << "[1] Default chunk planner ..." << endl;
+  {
+    HDF5Dataset dataset;
+    dataset.open (fileID, "Automatic", shape, H5T_NATIVE_FLOAT);
+
+    if (dataset.chunking() != shape) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] TimeSeries chunk planner ..." << endl;
+  {
+    HDF5Dataset dataset;
+    dataset.setChunkPlanner (HDF5ChunkPlanner (HDF5ChunkPlanner::TimeSeries,
+					       HDF5ChunkPlanner::defaultTargetBytes,
+					       0));
+    dataset.open (fileID, "TimeSeries", shape, H5T_NATIVE_FLOAT);
+    dataset.summary();
+
+    expected[0] = 1000;
+    expected[1] = HDF5ChunkPlanner::defaultTargetBytes/sizeof(float)/1000;
+    nofFailedTests += checkShape (dataset.chunking(), expected);
+
+    /* Chunk shape stored in the file */
+    hid_t plist = H5Dget_create_plist (dataset.objectID());
+    hsize_t dims[2];
+    H5Pget_chunk (plist, 2, dims);
+    H5Pclose (plist);
+
+    if (dims[0] != expected[0] || dims[1] != expected[1]) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Explicit chunk shape ..." << endl;
+  {
+    std::vector<hsize_t> chunk (2, 100);
+    HDF5Dataset dataset;
+    dataset.setChunkPlanner (HDF5ChunkPlanner (HDF5ChunkPlanner::Tile));
+    dataset.open (fileID, "Explicit", shape, chunk, H5T_NATIVE_FLOAT);
+
+    nofFailedTests += checkShape (dataset.chunking(), chunk);
+  }
+
+  H5Fclose (fileID);
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main ()
+{
+  int nofFailedTests (0);
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_chunkShape ();
+  nofFailedTests += test_nofChunks ();
+  nofFailedTests += test_dataset ();
+
+  return nofFailedTests;
+}
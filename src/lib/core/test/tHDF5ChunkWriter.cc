@@ -0,0 +1,370 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5ChunkWriter.h>
+#include <core/HDF5Dataset.h>
+#include <core/HDF5Object.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::HDF5ChunkWriter;
+using DAL::HDF5Dataset;
+using DAL::HDF5FilterPipeline;
+using DAL::HDF5Object;
+using DAL::IO_Mode;
+
+/*!
+  \file tHDF5ChunkWriter.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief A collection of test routines for the DAL::HDF5ChunkWriter class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//! Number of samples written to the datasets
+const unsigned int nofSamples = 256*1024;
+//! Number of samples per chunk
+const unsigned int chunkSamples = 8*1024;
+
+//_______________________________________________________________________________
+//                                                                      checkData
+
+/*!
+  \brief Read back a dataset and compare it with the data written
+
+  \param dataset -- Dataset to read from.
+  \param data    -- Data written to the dataset.
+  \return nofFailedTests -- The number of failed tests.
+*/
+int checkData (HDF5Dataset &dataset,
+	       short const *data)
+{
+  std::vector<int> start (1, 0);
+  std::vector<int> block (1, nofSamples);
+  short *buffer = new short [nofSamples];
+  int nofFailedTests (0);
+
+  if (!dataset.readData (buffer, start, block)) {
+    ++nofFailedTests;
+  } else {
+    for (unsigned int n=0; n<nofSamples; ++n) {
+      if (buffer[n] != data[n]) {
+	cerr << "-- Mismatch at sample " << n << endl;
+	++nofFailedTests;
+	break;
+      }
+    }
+  }
+
+  delete [] buffer;
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                              test_constructors
+
+/*!
+  \brief Test constructors for a new HDF5ChunkWriter object
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tHDF5ChunkWriter::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing HDF5ChunkWriter() ..." << endl;
+  {
+    HDF5ChunkWriter writer;
+    writer.summary();
+
+    if (writer.nofThreads() < 1 || writer.maxPending() != 4*writer.nofThreads()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing HDF5ChunkWriter(uint,uint) ..." << endl;
+  {
+    HDF5ChunkWriter writer (3, 5);
+    writer.summary();
+
+    if (writer.nofThreads() != 3 || writer.maxPending() != 5) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                    test_encode
+
+/*!
+  \brief Test encoding of chunks outside the library
+
+  \param data -- Samples to write.
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_encode (short const *data)
+{
+  cout << "\n[tHDF5ChunkWriter::test_encode]\n" << endl;
+
+  int nofFailedTests (0);
+  std::string filename ("tHDF5ChunkWriter.h5");
+  std::vector<hsize_t> shape (1, nofSamples);
+  std::vector<hsize_t> chunk (1, chunkSamples);
+  std::vector<hsize_t> offset (1, 0);
+  std::vector<int> start (1, 0);
+  std::vector<int> block (1, nofSamples);
+
+  hid_t fileID = HDF5Object::openFile (filename, IO_Mode(IO_Mode::Create));
+
+  cout << "[1] Testing HDF5FilterPipeline(hid_t) ..." << endl;
+  {
+    HDF5FilterPipeline filters (HDF5FilterPipeline::Deflate, 6, true, true);
+    HDF5Dataset dataset (fileID, "Reference", shape, chunk, filters, H5T_NATIVE_SHORT);
+    HDF5FilterPipeline other (dataset.objectID());
+    bool encodable (false);
+    other.summary();
+
+    /* Deflate is only encoded by DAL itself when linked against zlib */
+#ifdef DAL_WITH_ZLIB
+    encodable = true;
+#endif
+
+    if (other.compression() != HDF5FilterPipeline::Deflate
+	|| other.level() != 6
+	|| !other.shuffle()
+	|| !other.fletcher32()
+	|| other.isEncodable() != encodable) {
+      ++nofFailedTests;
+    }
+
+    dataset.writeData (data, start, block);
+  }
+
+  cout << "[2] Testing HDF5Dataset::writeChunk() ..." << endl;
+  {
+    HDF5FilterPipeline filters (HDF5FilterPipeline::Deflate, 6, true, true);
+    std::vector<hsize_t> empty (1, 0);
+    HDF5Dataset dataset (fileID, "Chunks", empty, chunk, filters, H5T_NATIVE_SHORT);
+
+    for (unsigned int n=0; n<nofSamples; n+=chunkSamples) {
+      offset[0] = n;
+      if (!dataset.writeChunk (data+n, offset)) {
+	++nofFailedTests;
+	break;
+      }
+    }
+
+    /* Chunks extend the dataset as they are written */
+    if (dataset.shape() != shape) {
+      ++nofFailedTests;
+    }
+  }
+
+  H5Fclose (fileID);
+
+  cout << "[3] Read back and compare with the library ..." << endl;
+  {
+    fileID = HDF5Object::openFile (filename, IO_Mode(IO_Mode::ReadOnly));
+    HDF5Dataset reference (fileID, "Reference");
+    HDF5Dataset chunks (fileID, "Chunks");
+
+    /* Checksums are verified upon reading */
+    nofFailedTests += checkData (chunks, data);
+
+    hsize_t referenceBytes = H5Dget_storage_size (reference.objectID());
+    hsize_t chunksBytes    = H5Dget_storage_size (chunks.objectID());
+
+    cout << "-- Storage size (H5Dwrite)       = " << referenceBytes << endl;
+    cout << "-- Storage size (H5Dwrite_chunk) = " << chunksBytes    << endl;
+
+    if (referenceBytes != chunksBytes) {
+      ++nofFailedTests;
+    }
+
+    H5Fclose (fileID);
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                     test_write
+
+/*!
+  \brief Test writing chunks in parallel
+
+  \param data -- Samples to write.
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_write (short const *data)
+{
+  cout << "\n[tHDF5ChunkWriter::test_write]\n" << endl;
+
+  int nofFailedTests (0);
+  std::string filename ("tHDF5ChunkWriter.h5");
+  std::vector<hsize_t> shape (1, nofSamples);
+  std::vector<hsize_t> empty (1, 0);
+  std::vector<hsize_t> chunk (1, chunkSamples);
+  std::vector<hsize_t> offset (1, 0);
+
+  hid_t fileID = HDF5Object::openFile (filename, IO_Mode(IO_Mode::Open|IO_Mode::ReadWrite));
+
+  cout << "[1] Deflate compression on four threads ..." << endl;
+  {
+    HDF5Dataset dataset (fileID,
+			 "Parallel",
+			 empty,
+			 chunk,
+			 HDF5FilterPipeline (HDF5FilterPipeline::Deflate, 6, true, true),
+			 H5T_NATIVE_SHORT);
+    HDF5ChunkWriter writer (4, 6);
+
+    for (unsigned int n=0; n<nofSamples; n+=chunkSamples) {
+      offset[0] = n;
+      if (!writer.write (dataset.objectID(), data+n, offset)) {
+	++nofFailedTests;
+      }
+    }
+
+    if (!writer.flush()) {
+      ++nofFailedTests;
+    }
+    writer.summary();
+
+    /* Without zlib the chunks are passed through the library */
+    bool encodable = dataset.filters().isEncodable();
+    if (writer.nofChunks() != nofSamples/chunkSamples
+	|| (encodable && writer.compressionRatio() <= 1.0)
+	|| (!encodable && writer.compressionRatio() != 1.0)) {
+      ++nofFailedTests;
+    }
+
+    hid_t reference = H5Dopen (fileID, "Reference", H5P_DEFAULT);
+    if (H5Dget_storage_size (reference) != H5Dget_storage_size (dataset.objectID())) {
+      ++nofFailedTests;
+    }
+    H5Dclose (reference);
+  }
+
+  cout << "[2] Fallback for filters not encodable ..." << endl;
+  {
+    /* Scale-offset filter, which only is available through the library */
+    hsize_t maxdims[1] = {H5S_UNLIMITED};
+    hid_t dataspace    = H5Screate_simple (1, &empty[0], maxdims);
+    hid_t plist        = H5Pcreate (H5P_DATASET_CREATE);
+    H5Pset_chunk (plist, 1, &chunk[0]);
+    H5Pset_scaleoffset (plist, H5Z_SO_INT, H5Z_SO_INT_MINBITS_DEFAULT);
+    hid_t dataset = H5Dcreate (fileID,
+			       "Fallback",
+			       H5T_NATIVE_SHORT,
+			       dataspace,
+			       H5P_DEFAULT,
+			       plist,
+			       H5P_DEFAULT);
+    H5Pclose (plist);
+    H5Sclose (dataspace);
+
+    HDF5ChunkWriter writer (2);
+
+    for (unsigned int n=0; n<nofSamples; n+=chunkSamples) {
+      offset[0] = n;
+      if (!writer.write (dataset, data+n, offset)) {
+	++nofFailedTests;
+      }
+    }
+    writer.flush();
+
+    /* Chunks are passed through the library, not counted as compressed */
+    if (writer.nofChunks() != nofSamples/chunkSamples
+	|| writer.compressionRatio() != 1.0) {
+      ++nofFailedTests;
+    }
+
+    H5Dclose (dataset);
+  }
+
+  cout << "[3] Misaligned chunk ..." << endl;
+  {
+    HDF5Dataset dataset (fileID, "Parallel");
+    HDF5ChunkWriter writer (1);
+
+    offset[0] = 1;
+    if (writer.write (dataset.objectID(), data, offset)) {
+      ++nofFailedTests;
+    }
+  }
+
+  H5Fclose (fileID);
+
+  cout << "[4] Read back ..." << endl;
+  {
+    fileID = HDF5Object::openFile (filename, IO_Mode(IO_Mode::ReadOnly));
+    HDF5Dataset parallel (fileID, "Parallel");
+    HDF5Dataset fallback (fileID, "Fallback");
+
+    nofFailedTests += checkData (parallel, data);
+    nofFailedTests += checkData (fallback, data);
+
+    if (parallel.shape() != shape || fallback.shape() != shape) {
+      ++nofFailedTests;
+    }
+
+    H5Fclose (fileID);
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main ()
+{
+  int nofFailedTests (0);
+  short *data = new short [nofSamples];
+
+  /* Noise-like samples of small amplitude, as recorded by the TBBs */
+  for (unsigned int n=0; n<nofSamples; ++n) {
+    data[n] = (short)((n*7919)%61) - 30;
+  }
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_encode (data);
+  nofFailedTests += test_write (data);
+
+  delete [] data;
+
+  return nofFailedTests;
+}
@@ -0,0 +1,334 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5FileIndex.h>
+#include <core/dalCommon.h>
+
+#include <cstdio>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::HDF5Attribute;
+using DAL::HDF5FileIndex;
+
+/*!
+  \file tHDF5FileIndex.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief A collection of test routines for the DAL::HDF5FileIndex class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//_______________________________________________________________________________
+//                                                                    create_file
+
+/*!
+  \brief Create a test file with a few groups and datasets
+
+  \param filename -- Name of the file to be created.
+
+  \return status -- Returns \e false if the file could not be created.
+*/
+bool create_file (std::string const &filename)
+{
+  hid_t fileID = H5Fcreate (filename.c_str(),
+			    H5F_ACC_TRUNC,
+			    H5P_DEFAULT,
+			    H5P_DEFAULT);
+  if (fileID < 0) {
+    return false;
+  }
+
+  HDF5Attribute::write (fileID, "FILETYPE", std::string("tbb"));
+
+  for (int station=1; station<=2; ++station) {
+    char name[20];
+    sprintf (name, "Station%03d", station);
+
+    hid_t groupID = H5Gcreate (fileID, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    HDF5Attribute::write (groupID, "GROUPTYPE", std::string("StationGroup"));
+    HDF5Attribute::write (groupID, "NOF_DIPOLES", int(station));
+
+    /* Nested group, which must not show up among the datasets */
+    hid_t triggerID = H5Gcreate (groupID, "TriggerData", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Gclose (triggerID);
+
+    for (int dipole=0; dipole<station; ++dipole) {
+      hsize_t shape[1] = { hsize_t(1000*(dipole+1)) };
+      hid_t dataspace  = H5Screate_simple (1, shape, NULL);
+      sprintf (name, "00100%d00%d", station, dipole);
+      hid_t datasetID  = H5Dcreate (groupID, name, H5T_NATIVE_SHORT, dataspace,
+				    H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      HDF5Attribute::write (datasetID, "ANTENNA_SET", std::string("HBA\tONE"));
+      H5Dclose (datasetID);
+      H5Sclose (dataspace);
+    }
+
+    H5Gclose (groupID);
+  }
+
+  H5Fclose (fileID);
+
+  return true;
+}
+
+//_______________________________________________________________________________
+//                                                              test_constructors
+
+/*!
+  \brief Test constructors for a new HDF5FileIndex object
+
+  \param filename -- Name of the test file, not yet having a sidecar.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors (std::string const &filename)
+{
+  cout << "\n[tHDF5FileIndex::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing HDF5FileIndex() ..." << endl;
+  {
+    HDF5FileIndex index;
+    index.summary();
+
+    if (index.isValid() || index.nofEntries() != 0) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing HDF5FileIndex(string) without sidecar ..." << endl;
+  {
+    HDF5FileIndex index (filename);
+    index.summary();
+
+    if (index.isValid() || index.filename() != filename) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                     test_build
+
+/*!
+  \brief Test recording the structure of a file
+
+  \param filename -- Name of the test file.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_build (std::string const &filename)
+{
+  cout << "\n[tHDF5FileIndex::test_build]\n" << endl;
+
+  int nofFailedTests (0);
+  HDF5FileIndex index;
+
+  cout << "[1] Testing build(hid_t) ..." << endl;
+  {
+    hid_t fileID = H5Fopen (filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+
+    if (!index.build (fileID) || index.nofEntries() != 8) {
+      ++nofFailedTests;
+    }
+
+    H5Fclose (fileID);
+    index.summary();
+  }
+
+  cout << "[2] Testing names(string,int) against h5get_names() ..." << endl;
+  {
+    hid_t fileID  = H5Fopen (filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t groupID = H5Gopen (fileID, "Station002", H5P_DEFAULT);
+    std::set<std::string> groups;
+    std::set<std::string> datasets;
+
+    DAL::h5get_names (groups, fileID, H5G_GROUP);
+    DAL::h5get_names (datasets, groupID, H5G_DATASET);
+
+    if (index.names ("/", H5G_GROUP) != groups
+	|| index.names ("/Station002", H5G_DATASET) != datasets
+	|| index.names ("/Station002/", H5G_DATASET) != datasets
+	|| index.names ("/Station002", H5G_GROUP).size() != 1
+	|| !index.names ("/", H5G_DATASET).empty()) {
+      ++nofFailedTests;
+    }
+
+    H5Gclose (groupID);
+    H5Fclose (fileID);
+  }
+
+  cout << "[3] Testing entry() and attribute() ..." << endl;
+  {
+    HDF5FileIndex::Entry entry;
+    std::string value;
+
+    if (!index.entry ("/Station002/001002001", entry)
+	|| entry.type != H5G_DATASET
+	|| entry.shape.size() != 1
+	|| entry.shape[0] != 2000
+	|| entry.datatypeClass != H5T_INTEGER
+	|| entry.datatypeSize != sizeof(short)) {
+      ++nofFailedTests;
+    }
+
+    if (!index.attribute ("/Station001", "GROUPTYPE", value)
+	|| value != "StationGroup"
+	|| index.attribute ("/Station001", "NOF_DIPOLES", value)
+	|| index.attribute ("/Station003", "GROUPTYPE", value)) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                      test_read
+
+/*!
+  \brief Test writing the sidecar, reading it back and detecting stale indices
+
+  \param filename -- Name of the test file.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_read (std::string const &filename)
+{
+  cout << "\n[tHDF5FileIndex::test_read]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing update(string) ..." << endl;
+  {
+    if (!HDF5FileIndex::update (filename)) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing read(string) ..." << endl;
+  {
+    HDF5FileIndex index;
+    HDF5FileIndex::Entry entry;
+    std::string value;
+
+    if (!index.read (filename) || index.nofEntries() != 8) {
+      ++nofFailedTests;
+    }
+
+    if (!index.entry ("/Station001/001001000", entry)
+	|| entry.shape.size() != 1
+	|| entry.shape[0] != 1000
+	|| !index.attribute ("/Station001/001001000", "ANTENNA_SET", value)
+	|| value != "HBA\tONE"
+	|| !index.attribute ("/", "FILETYPE", value)
+	|| value != "tbb") {
+      ++nofFailedTests;
+    }
+
+    if (index.names ("/", H5G_GROUP).size() != 2
+	|| index.names ("/Station001", H5G_DATASET).size() != 1) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing read(string) after modification of the file ..." << endl;
+  {
+    hid_t fileID    = H5Fopen (filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+    hsize_t shape[1] = { 100000 };
+    hid_t dataspace = H5Screate_simple (1, shape, NULL);
+    hid_t datasetID = H5Dcreate (fileID, "Extra", H5T_NATIVE_DOUBLE, dataspace,
+				 H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    std::vector<double> data (shape[0], 1.0);
+
+    H5Dwrite (datasetID, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data[0]);
+    H5Dclose (datasetID);
+    H5Sclose (dataspace);
+    H5Fclose (fileID);
+
+    HDF5FileIndex index (filename);
+
+    if (index.isValid() || index.nofEntries() != 0) {
+      cerr << "-- Stale index accepted" << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[4] Testing read(string) after rewriting data in place ..." << endl;
+  {
+    if (!HDF5FileIndex::update (filename)) {
+      ++nofFailedTests;
+    }
+
+    /* Same size, and most likely within the same second as the update */
+    hid_t fileID    = H5Fopen (filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+    hid_t datasetID = H5Dopen (fileID, "Extra", H5P_DEFAULT);
+    std::vector<double> data (100000, 2.0);
+
+    H5Dwrite (datasetID, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data[0]);
+    H5Dclose (datasetID);
+    H5Fclose (fileID);
+
+    HDF5FileIndex index (filename);
+
+    if (index.isValid()) {
+      cerr << "-- Stale index accepted" << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main ()
+{
+  int nofFailedTests (0);
+  std::string filename ("tHDF5FileIndex.h5");
+
+  std::remove (HDF5FileIndex::sidecarName(filename).c_str());
+
+  if (!create_file (filename)) {
+    cerr << "ERROR : Failed to create file " << filename << endl;
+    return -1;
+  }
+
+  nofFailedTests += test_constructors (filename);
+  nofFailedTests += test_build (filename);
+  nofFailedTests += test_read (filename);
+
+  return nofFailedTests;
+}
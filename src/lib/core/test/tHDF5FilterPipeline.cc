@@ -0,0 +1,314 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5FilterPipeline.h>
+#include <core/HDF5Dataset.h>
+#include <core/HDF5Object.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::HDF5Dataset;
+using DAL::HDF5FilterPipeline;
+using DAL::HDF5Object;
+using DAL::IO_Mode;
+
+/*!
+  \file tHDF5FilterPipeline.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief A collection of test routines for the DAL::HDF5FilterPipeline class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//_______________________________________________________________________________
+//                                                              test_constructors
+
+/*!
+  \brief Test constructors for a new HDF5FilterPipeline object
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tHDF5FilterPipeline::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing HDF5FilterPipeline() ..." << endl;
+  {
+    HDF5FilterPipeline filters;
+    filters.summary();
+
+    if (!filters.isEmpty()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing HDF5FilterPipeline(Compression,uint,bool,bool) ..." << endl;
+  {
+    HDF5FilterPipeline filters (HDF5FilterPipeline::Deflate, 6, true, true);
+    filters.summary();
+
+    if (filters.compression() != HDF5FilterPipeline::Deflate
+	|| filters.level() != 6
+	|| !filters.shuffle()
+	|| !filters.fletcher32()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing HDF5FilterPipeline(HDF5FilterPipeline) ..." << endl;
+  {
+    HDF5FilterPipeline filters (HDF5FilterPipeline::LZ4);
+    HDF5FilterPipeline other (filters);
+    other.summary();
+
+    if (other.compression() != HDF5FilterPipeline::LZ4 || !other.shuffle()) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                test_parameters
+
+/*!
+  \brief Test setting and validation of the parameters
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_parameters ()
+{
+  cout << "\n[tHDF5FilterPipeline::test_parameters]\n" << endl;
+
+  int nofFailedTests (0);
+  HDF5FilterPipeline filters;
+
+  cout << "[1] Testing setCompression() ..." << endl;
+  {
+    /* Deflate levels outside [1,9] are rejected */
+    if (filters.setCompression (HDF5FilterPipeline::Deflate, 0)
+	|| filters.setCompression (HDF5FilterPipeline::Deflate, 10)) {
+      ++nofFailedTests;
+    }
+    if (!filters.isEmpty()) {
+      ++nofFailedTests;
+    }
+    if (!filters.setCompression (HDF5FilterPipeline::Deflate, 9)
+	|| filters.isEmpty()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing isAvailable() ..." << endl;
+  {
+    cout << "-- Deflate       = " << HDF5FilterPipeline::isAvailable(HDF5FilterPipeline::Deflate)       << endl;
+    cout << "-- LZ4           = " << HDF5FilterPipeline::isAvailable(HDF5FilterPipeline::LZ4)           << endl;
+    cout << "-- BitshuffleLZ4 = " << HDF5FilterPipeline::isAvailable(HDF5FilterPipeline::BitshuffleLZ4) << endl;
+
+    if (!HDF5FilterPipeline::isAvailable(HDF5FilterPipeline::None)) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                     test_apply
+
+/*!
+  \brief Test adding the filters to a dataset creation property list
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_apply ()
+{
+  cout << "\n[tHDF5FilterPipeline::test_apply]\n" << endl;
+
+  int nofFailedTests (0);
+  hsize_t chunk[1] = {1024};
+
+  cout << "[1] Shuffle, deflate and checksum ..." << endl;
+  {
+    HDF5FilterPipeline filters (HDF5FilterPipeline::Deflate, 1, true, true);
+    hid_t plist = H5Pcreate (H5P_DATASET_CREATE);
+    H5Pset_chunk (plist, 1, chunk);
+
+    if (!filters.apply (plist)) {
+      ++nofFailedTests;
+    }
+
+    std::vector<H5Z_filter_t> ids = HDF5FilterPipeline::filters (plist);
+    H5Pclose (plist);
+
+    /* Checksum has to be computed after compression */
+    if (ids.size() != 3
+	|| ids[0] != H5Z_FILTER_SHUFFLE
+	|| ids[1] != H5Z_FILTER_DEFLATE
+	|| ids[2] != H5Z_FILTER_FLETCHER32) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Plugin with fallback to deflate ..." << endl;
+  {
+    HDF5FilterPipeline filters (HDF5FilterPipeline::BitshuffleLZ4);
+    hid_t plist = H5Pcreate (H5P_DATASET_CREATE);
+    H5Pset_chunk (plist, 1, chunk);
+
+    if (!filters.apply (plist)) {
+      ++nofFailedTests;
+    }
+
+    std::vector<H5Z_filter_t> ids = HDF5FilterPipeline::filters (plist);
+    H5Pclose (plist);
+
+    if (HDF5FilterPipeline::isAvailable(HDF5FilterPipeline::BitshuffleLZ4)) {
+      if (ids.size() != 1 || ids[0] != DAL_H5Z_FILTER_BITSHUFFLE) {
+	++nofFailedTests;
+      }
+    } else {
+      if (ids.size() != 2 || ids[1] != H5Z_FILTER_DEFLATE) {
+	++nofFailedTests;
+      }
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                  test_datasets
+
+/*!
+  \brief Test writing and reading back a filtered dataset
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_datasets ()
+{
+  cout << "\n[tHDF5FilterPipeline::test_datasets]\n" << endl;
+
+  int nofFailedTests (0);
+  std::string filename ("tHDF5FilterPipeline.h5");
+  unsigned int nofSamples (64*1024);
+  std::vector<hsize_t> shape (1, nofSamples);
+  std::vector<hsize_t> chunk (1, 8*1024);
+  std::vector<int> start (1, 0);
+  std::vector<int> block (1, nofSamples);
+  short *data   = new short [nofSamples];
+  short *buffer = new short [nofSamples];
+
+  /* Noise-like samples of small amplitude, as recorded by the TBBs */
+  for (unsigned int n=0; n<nofSamples; ++n) {
+    data[n] = (short)((n*7919)%61) - 30;
+  }
+
+  hid_t fileID = HDF5Object::openFile (filename, IO_Mode(IO_Mode::Create));
+
+  cout << "[1] Create uncompressed and compressed dataset ..." << endl;
+  {
+    HDF5Dataset plain (fileID, "Plain", shape, chunk, H5T_NATIVE_SHORT);
+    HDF5Dataset packed (fileID,
+			"Packed",
+			shape,
+			chunk,
+			HDF5FilterPipeline (HDF5FilterPipeline::Deflate, 1, true, true),
+			H5T_NATIVE_SHORT);
+
+    plain.writeData (data, start, block);
+    packed.writeData (data, start, block);
+    H5Fflush (fileID, H5F_SCOPE_LOCAL);
+
+    hsize_t plainBytes  = H5Dget_storage_size (plain.objectID());
+    hsize_t packedBytes = H5Dget_storage_size (packed.objectID());
+
+    cout << "-- Storage size (plain)  = " << plainBytes  << endl;
+    cout << "-- Storage size (packed) = " << packedBytes << endl;
+
+    if (packedBytes >= plainBytes
+	|| HDF5FilterPipeline::filters(packed.objectID()).size() != 3
+	|| !HDF5FilterPipeline::filters(plain.objectID()).empty()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Read back compressed dataset ..." << endl;
+  {
+    HDF5Dataset packed (fileID, "Packed");
+
+    packed.readData (buffer, start, block);
+
+    for (unsigned int n=0; n<nofSamples; ++n) {
+      if (buffer[n] != data[n]) {
+	++nofFailedTests;
+	break;
+      }
+    }
+  }
+
+  cout << "[3] Set filters before opening a dataset ..." << endl;
+  {
+    HDF5Dataset dataset;
+    dataset.setFilters (HDF5FilterPipeline (HDF5FilterPipeline::LZ4));
+    dataset.open (fileID, "LZ4", shape, chunk, H5T_NATIVE_SHORT);
+    dataset.writeData (data, start, block);
+
+    if (HDF5FilterPipeline::filters(dataset.objectID()).size() != 2) {
+      ++nofFailedTests;
+    }
+  }
+
+  H5Fclose (fileID);
+
+  delete [] data;
+  delete [] buffer;
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main ()
+{
+  int nofFailedTests (0);
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_parameters ();
+  nofFailedTests += test_apply ();
+  nofFailedTests += test_datasets ();
+
+  return nofFailedTests;
+}
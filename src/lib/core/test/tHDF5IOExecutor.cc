@@ -0,0 +1,309 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5Dataset.h>
+#include <core/HDF5IOExecutor.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::HDF5Dataset;
+using DAL::HDF5Future;
+using DAL::HDF5IOExecutor;
+
+/*!
+  \file tHDF5IOExecutor.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief A collection of test routines for the DAL::HDF5IOExecutor class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//_______________________________________________________________________________
+//                                                                    test_future
+
+/*!
+  \brief Test the handling of DAL::HDF5Future objects
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_future ()
+{
+  cout << "\n[tHDF5IOExecutor::test_future]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing HDF5Future() ..." << endl;
+  {
+    HDF5Future future;
+    future.summary();
+
+    if (future.isValid() || future.isReady() || future.wait()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing HDF5Future(bool) ..." << endl;
+  {
+    HDF5Future success (true);
+    HDF5Future failure (false);
+    success.summary();
+
+    if (!success.isReady() || !success.wait()
+	|| !failure.isReady() || failure.wait()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing HDF5Future(HDF5Future) and operator= ..." << endl;
+  {
+    HDF5Future future (true);
+    HDF5Future copy (future);
+    HDF5Future assigned;
+
+    assigned = copy;
+
+    if (!copy.wait() || !assigned.wait()) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                test_read_write
+
+/*!
+  \brief Test asynchronous writing and reading of a dataset
+
+  \param fileID -- Identifier of the file within which the datasets are created.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_read_write (hid_t const &fileID)
+{
+  cout << "\n[tHDF5IOExecutor::test_read_write]\n" << endl;
+
+  int nofFailedTests (0);
+  int nofBlocks (10);
+  std::vector<hsize_t> shape (1,1000);
+  std::vector<hsize_t> chunk (1,100);
+  std::vector<int> start (1,0);
+  std::vector<int> block (1,100);
+  std::vector<double> data (nofBlocks*block[0]);
+  HDF5IOExecutor &executor = HDF5IOExecutor::instance();
+
+  for (unsigned int n=0; n<data.size(); ++n) {
+    data[n] = n;
+  }
+
+  cout << "[1] Testing writeDataAsync(T[],vector<int>,vector<int>) ..." << endl;
+  {
+    HDF5Dataset dataset (fileID, "Array1D", shape, chunk);
+    std::vector<HDF5Future> futures;
+
+    for (int n=0; n<nofBlocks; ++n) {
+      start[0] = n*block[0];
+      futures.push_back (dataset.writeDataAsync (&data[start[0]], start, block));
+    }
+
+    for (unsigned int n=0; n<futures.size(); ++n) {
+      if (!futures[n].wait()) {
+	++nofFailedTests;
+      }
+    }
+  }
+
+  cout << "[2] Testing readDataAsync(T[],vector<int>,vector<int>) ..." << endl;
+  {
+    HDF5Dataset dataset (fileID, "Array1D");
+    std::vector<double> buffer (data.size(),-1);
+    std::vector<HDF5Future> futures;
+
+    for (int n=0; n<nofBlocks; ++n) {
+      start[0] = n*block[0];
+      futures.push_back (dataset.readDataAsync (&buffer[start[0]], start, block));
+    }
+
+    for (unsigned int n=0; n<futures.size(); ++n) {
+      if (!futures[n].wait()) {
+	++nofFailedTests;
+      }
+    }
+
+    if (buffer != data) {
+      cerr << "-- Data read back do not match data written" << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing writeDataAsync() beyond the extent of the dataset ..." << endl;
+  {
+    HDF5Dataset dataset (fileID, "Array1D");
+
+    start[0] = 1000;
+    HDF5Future future = dataset.writeDataAsync (&data[0], start, block);
+
+    if (!future.wait()) {
+      ++nofFailedTests;
+    }
+
+    /* Synchronous access picks up the new extent */
+    std::vector<double> buffer (block[0]);
+    if (!dataset.readData (&buffer[0], start, block)
+	|| buffer[10] != data[10]
+	|| dataset.shape()[0] != 1100) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[4] Testing merging of adjacent requests ..." << endl;
+  {
+    HDF5Dataset dataset (fileID, "Array1D");
+    std::vector<double> buffer (data.size(),-1);
+    std::vector<HDF5Future> futures;
+    unsigned long nofRequests;
+    unsigned long nofCalls;
+
+    executor.flush();
+    nofRequests = executor.nofRequests();
+    nofCalls    = executor.nofCalls();
+
+    /* Hold the lock, such that the requests pile up in the queue */
+    {
+      HDF5IOExecutor::Lock lock;
+      for (int n=0; n<nofBlocks; ++n) {
+	start[0] = n*block[0];
+	futures.push_back (dataset.readDataAsync (&buffer[start[0]], start, block));
+      }
+    }
+
+    executor.flush();
+    executor.summary();
+
+    for (unsigned int n=0; n<futures.size(); ++n) {
+      if (!futures[n].wait()) {
+	++nofFailedTests;
+      }
+    }
+
+    if (buffer != data
+	|| executor.nofRequests() - nofRequests != (unsigned long)(nofBlocks)
+	|| executor.nofCalls() - nofCalls >= (unsigned long)(nofBlocks)) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                    test_errors
+
+/*!
+  \brief Test handling of requests which cannot be carried out
+
+  \param fileID -- Identifier of the file within which the datasets are created.
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_errors (hid_t const &fileID)
+{
+  cout << "\n[tHDF5IOExecutor::test_errors]\n" << endl;
+
+  int nofFailedTests (0);
+  HDF5IOExecutor &executor = HDF5IOExecutor::instance();
+  std::vector<hsize_t> start (1,0);
+  std::vector<hsize_t> block (1,10);
+  std::vector<double> buffer (10);
+
+  cout << "[1] Testing read() from an invalid dataset ..." << endl;
+  {
+    HDF5Future future = executor.read (-1, H5T_NATIVE_DOUBLE, start, block, &buffer[0]);
+
+    if (!future.isReady() || future.wait()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing read() with selection of wrong rank ..." << endl;
+  {
+    HDF5Dataset dataset (fileID, "Array1D");
+    std::vector<hsize_t> start2 (2,0);
+    std::vector<hsize_t> block2 (2,1);
+    HDF5Future future = executor.read (dataset.objectID(), H5T_NATIVE_DOUBLE,
+				       start2, block2, &buffer[0]);
+
+    if (future.wait()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing readDataAsync() on closed dataset ..." << endl;
+  {
+    HDF5Dataset dataset;
+    std::vector<int> offset (1,0);
+    std::vector<int> shape (1,10);
+    HDF5Future future = dataset.readDataAsync (&buffer[0], offset, shape);
+
+    if (future.wait()) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main ()
+{
+  int nofFailedTests (0);
+  std::string filename ("tHDF5IOExecutor.h5");
+
+  hid_t fileID = H5Fcreate (filename.c_str(),
+			    H5F_ACC_TRUNC,
+			    H5P_DEFAULT,
+			    H5P_DEFAULT);
+  if (fileID < 0) {
+    cerr << "ERROR : Failed to create file " << filename << endl;
+    return -1;
+  }
+
+  nofFailedTests += test_future ();
+  nofFailedTests += test_read_write (fileID);
+  nofFailedTests += test_errors (fileID);
+
+  HDF5IOExecutor::instance().flush();
+  H5Fclose (fileID);
+
+  return nofFailedTests;
+}
@@ -0,0 +1,391 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5MappedView.h>
+#include <core/HDF5Dataset.h>
+#include <core/HDF5Object.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::HDF5Dataset;
+using DAL::HDF5Hyperslab;
+using DAL::HDF5MappedView;
+using DAL::HDF5Object;
+using DAL::IO_Mode;
+
+/*!
+  \file tHDF5MappedView.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief A collection of test routines for the DAL::HDF5MappedView class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//! Name of the file used for testing
+const std::string filename ("tHDF5MappedView.h5");
+//! Number of samples in the time series
+const unsigned int nofSamples = 100000;
+//! Number of rows of the image
+const unsigned int nofRows = 100;
+//! Number of columns of the image
+const unsigned int nofColumns = 64;
+
+//_______________________________________________________________________________
+//                                                                    createFile
+
+/*!
+  \brief Create the datasets viewed by the tests
+
+  The same data are stored in datasets with contiguous and with chunked layout.
+*/
+void createFile ()
+{
+  hid_t fileID = HDF5Object::openFile (filename, IO_Mode(IO_Mode::Create));
+
+  /* Time series of samples */
+  short *samples = new short [nofSamples];
+  for (unsigned int n=0; n<nofSamples; ++n) {
+    samples[n] = (short)((n*7919)%2048) - 1024;
+  }
+
+  hsize_t dims[2] = {nofSamples, 0};
+  hid_t dataspace = H5Screate_simple (1, dims, NULL);
+  hid_t dataset   = H5Dcreate (fileID, "Samples", H5T_STD_I16LE, dataspace,
+			       H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  H5Dwrite (dataset, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, samples);
+  H5Dclose (dataset);
+  H5Sclose (dataspace);
+
+  /* Image */
+  float *image = new float [nofRows*nofColumns];
+  for (unsigned int n=0; n<nofRows*nofColumns; ++n) {
+    image[n] = 0.5*n;
+  }
+
+  dims[0] = nofRows;
+  dims[1] = nofColumns;
+  dataspace = H5Screate_simple (2, dims, NULL);
+  dataset   = H5Dcreate (fileID, "Image", H5T_NATIVE_FLOAT, dataspace,
+			 H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  H5Dwrite (dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, image);
+  H5Dclose (dataset);
+  H5Sclose (dataspace);
+
+  /* Image with chunked layout */
+  std::vector<hsize_t> shape (dims, dims+2);
+  std::vector<int> start (2, 0);
+  std::vector<int> block (2);
+  block[0] = nofRows;
+  block[1] = nofColumns;
+  {
+    HDF5Dataset chunked (fileID, "ImageChunked", shape, H5T_NATIVE_FLOAT);
+    chunked.writeData (image, start, block);
+  }
+
+  delete [] samples;
+  delete [] image;
+
+  H5Fclose (fileID);
+}
+
+//_______________________________________________________________________________
+//                                                              test_constructors
+
+/*!
+  \brief Test constructors for a new HDF5MappedView object
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tHDF5MappedView::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+  hid_t fileID = HDF5Object::openFile (filename, IO_Mode(IO_Mode::ReadOnly));
+  hid_t dataset = H5Dopen (fileID, "Samples", H5P_DEFAULT);
+
+  cout << "[1] Testing HDF5MappedView() ..." << endl;
+  {
+    HDF5MappedView view;
+    view.summary();
+
+    if (view.isMapped() || view.nofDatapoints() != 0 || view.address(0) != NULL) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing HDF5MappedView(hid_t,hid_t) ..." << endl;
+  {
+    HDF5MappedView view (dataset, H5T_NATIVE_SHORT);
+    view.summary();
+
+    if (!view.isMapped()
+	|| view.nofDatapoints() != nofSamples
+	|| view.typeSize() != sizeof(short)) {
+      ++nofFailedTests;
+    }
+  }
+
+  H5Dclose (dataset);
+  H5Fclose (fileID);
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                    test_series
+
+/*!
+  \brief Test viewing a one-dimensional dataset
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_series ()
+{
+  cout << "\n[tHDF5MappedView::test_series]\n" << endl;
+
+  int nofFailedTests (0);
+  hid_t fileID  = HDF5Object::openFile (filename, IO_Mode(IO_Mode::ReadOnly));
+  hid_t dataset = H5Dopen (fileID, "Samples", H5P_DEFAULT);
+  short *buffer = new short [nofSamples];
+
+  H5Dread (dataset, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer);
+
+  cout << "[1] Scan the complete dataset ..." << endl;
+  {
+    HDF5MappedView view (dataset, H5T_NATIVE_SHORT);
+    short const *data = view.data<short>();
+
+    if (data == NULL || !view.isContiguous()) {
+      ++nofFailedTests;
+    } else {
+      for (unsigned int n=0; n<nofSamples; ++n) {
+	if (data[n] != buffer[n]) {
+	  cerr << "-- Mismatch at sample " << n << endl;
+	  ++nofFailedTests;
+	  break;
+	}
+      }
+    }
+
+    /* Size of the type not matching */
+    if (view.data<int>() != NULL) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Every tenth sample, starting at an odd position ..." << endl;
+  {
+    std::vector<int> start (1, 4097);
+    std::vector<int> stride (1, 10);
+    std::vector<int> count (1, 1000);
+    std::vector<int> block (1, 1);
+    HDF5MappedView view (dataset, H5T_NATIVE_SHORT);
+
+    if (!view.setSelection (HDF5Hyperslab (start, stride, count, block))
+	|| !view.isMapped()
+	|| view.isContiguous()
+	|| view.data<short>() != NULL) {
+      ++nofFailedTests;
+    }
+
+    for (unsigned int n=0; n<1000; ++n) {
+      if (view.at<short>(n) != buffer[4097+10*n]) {
+	cerr << "-- Mismatch at element " << n << endl;
+	++nofFailedTests;
+	break;
+      }
+    }
+  }
+
+  cout << "[3] Conversion to another datatype ..." << endl;
+  {
+    HDF5MappedView view (dataset, H5T_NATIVE_INT);
+    int *data = new int [nofSamples];
+
+    if (view.isMapped() || !view.readData (data)) {
+      ++nofFailedTests;
+    } else {
+      for (unsigned int n=0; n<nofSamples; ++n) {
+	if (data[n] != buffer[n]) {
+	  ++nofFailedTests;
+	  break;
+	}
+      }
+    }
+
+    delete [] data;
+  }
+
+  cout << "[4] Selection outside the dataset ..." << endl;
+  {
+    std::vector<int> start (1, nofSamples-10);
+    std::vector<int> block (1, 11);
+    HDF5MappedView view (dataset, H5T_NATIVE_SHORT);
+
+    if (view.setSelection (HDF5Hyperslab (start, block))) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[5] Open with a selection ..." << endl;
+  {
+    std::vector<int> start (1, 500);
+    std::vector<int> block (1, 2000);
+    HDF5MappedView view;
+
+    if (!view.open (dataset, H5T_NATIVE_SHORT, HDF5Hyperslab (start, block))
+	|| view.nofDatapoints() != 2000
+	|| view.data<short>() == NULL
+	|| view.data<short>()[1999] != buffer[2499]) {
+      ++nofFailedTests;
+    }
+  }
+
+  delete [] buffer;
+  H5Dclose (dataset);
+  H5Fclose (fileID);
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                     test_image
+
+/*!
+  \brief Test viewing a two-dimensional dataset, mapped and read
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_image ()
+{
+  cout << "\n[tHDF5MappedView::test_image]\n" << endl;
+
+  int nofFailedTests (0);
+  hid_t fileID  = HDF5Object::openFile (filename, IO_Mode(IO_Mode::ReadOnly));
+  hid_t image   = H5Dopen (fileID, "Image", H5P_DEFAULT);
+  hid_t chunked = H5Dopen (fileID, "ImageChunked", H5P_DEFAULT);
+
+  /* Blocks of 2x4 pixels */
+  std::vector<int> start (2);
+  std::vector<int> stride (2);
+  std::vector<int> count (2);
+  std::vector<int> block (2);
+
+  start[0]  = 10;
+  start[1]  = 8;
+  stride[0] = 3;
+  stride[1] = 16;
+  count[0]  = 5;
+  count[1]  = 3;
+  block[0]  = 2;
+  block[1]  = 4;
+
+  HDF5Hyperslab slab (start, stride, count, block);
+  unsigned int nelem = 5*2*3*4;
+
+  cout << "[1] Hyperslab of blocks ..." << endl;
+  {
+    HDF5MappedView mapped (image, H5T_NATIVE_FLOAT);
+    HDF5MappedView read (chunked, H5T_NATIVE_FLOAT);
+    float *mappedData = new float [nelem];
+    float *readData   = new float [nelem];
+
+    mapped.setSelection (slab);
+    read.setSelection (slab);
+    mapped.summary();
+
+    if (!mapped.isMapped() || read.isMapped()) {
+      ++nofFailedTests;
+    }
+
+    if (mapped.shape() != read.shape() || mapped.nofDatapoints() != nelem) {
+      ++nofFailedTests;
+    }
+
+    /* Element [1,5] of the selection: row 10+1, column 8+16+1 */
+    if (mapped.at<float>(1*12+5) != 0.5*(11*nofColumns+25)) {
+      ++nofFailedTests;
+    }
+
+    /* Mapped and read selections are identical */
+    mapped.readData (mappedData);
+    read.readData (readData);
+
+    for (unsigned int n=0; n<nelem; ++n) {
+      if (mappedData[n] != readData[n] || mapped.at<float>(n) != read.at<float>(n)) {
+	cerr << "-- Mismatch at element " << n << endl;
+	++nofFailedTests;
+	break;
+      }
+    }
+
+    delete [] mappedData;
+    delete [] readData;
+  }
+
+  cout << "[2] Complete rows ..." << endl;
+  {
+    std::vector<int> rowStart (2, 0);
+    std::vector<int> rowBlock (2, nofColumns);
+    rowStart[0] = 20;
+    rowBlock[0] = 3;
+
+    HDF5MappedView view (image, H5T_NATIVE_FLOAT);
+    view.setSelection (HDF5Hyperslab (rowStart, rowBlock));
+
+    float const *data = view.data<float>();
+    if (data == NULL || data[0] != 0.5*20*nofColumns) {
+      ++nofFailedTests;
+    }
+  }
+
+  H5Dclose (image);
+  H5Dclose (chunked);
+  H5Fclose (fileID);
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main ()
+{
+  int nofFailedTests (0);
+
+  createFile ();
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_series ();
+  nofFailedTests += test_image ();
+
+  return nofFailedTests;
+}
@@ -0,0 +1,217 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <sys/time.h>
+#include <core/dalCommon.h>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/*!
+  \file tdalCommon_crc.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief Test and micro-benchmark for the CRC routines contained in dalCommon
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tdalCommon_crc [nofFrames]
+  \endverbatim
+
+  Checks the table-driven crc16() and crc32() against the bit-serial reference
+  implementations, and then times both on \e nofFrames (default: 20000)
+  TBB-sized frames: a 44-word header for the 16-bit CRC and a 1026-word payload
+  for the 32-bit CRC.
+*/
+
+//! Number of 16-bit words in a TBB frame header (including the CRC)
+const unsigned int nofHeaderWords  = 44;
+//! Number of 16-bit words in a TBB frame payload (including the CRC)
+const unsigned int nofPayloadWords = 1026;
+
+// -----------------------------------------------------------------------------
+
+//! Get the wall-clock time, [sec]
+double wallTime ()
+{
+  struct timeval tv;
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec + 1e-6*tv.tv_usec;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Compare the table-driven CRC routines with the reference versions
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int test_crc ()
+{
+  cout << "\n[tdalCommon_crc::test_crc]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<uint16_t> buffer (2000);
+
+  srand (42);
+  for (unsigned int n=0; n<buffer.size(); ++n) {
+    buffer[n] = rand() & 0xffff;
+  }
+
+  cout << "[1] Compare with reference implementations ..." << endl;
+  for (unsigned int length=1; length<100; ++length) {
+    if (DAL::crc16(&buffer[0], length) != DAL::crc16_bitwise(&buffer[0], length)) {
+      cerr << "-- crc16 mismatch for length " << length << endl;
+      ++nofFailedTests;
+    }
+    if (DAL::crc32(&buffer[0], length) != DAL::crc32_bitwise(&buffer[0], length)) {
+      cerr << "-- crc32 mismatch for length " << length << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Check a frame with appended CRC ..." << endl;
+  {
+    /* The CRC of the data shifted by the CRC width gives the check value */
+    buffer[nofHeaderWords-1] = 0;
+    buffer[nofHeaderWords-1] = DAL::crc16 (&buffer[0], nofHeaderWords);
+    if (DAL::crc16 (&buffer[0], nofHeaderWords) != 0) {
+      cerr << "-- crc16 of header with CRC not zero" << endl;
+      ++nofFailedTests;
+    }
+
+    buffer[nofPayloadWords-2] = buffer[nofPayloadWords-1] = 0;
+    uint32_t crc = DAL::crc32 (&buffer[0], nofPayloadWords);
+    buffer[nofPayloadWords-2] = crc >> 16;
+    buffer[nofPayloadWords-1] = crc & 0xffff;
+    if (DAL::crc32 (&buffer[0], nofPayloadWords) != 0) {
+      cerr << "-- crc32 of payload with CRC not zero" << endl;
+      ++nofFailedTests;
+    }
+
+    buffer[10] ^= 0x0100;
+    if (DAL::crc32 (&buffer[0], nofPayloadWords) == 0) {
+      cerr << "-- crc32 did not detect a flipped bit" << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Time the CRC routines on TBB-sized frames
+
+  \param nofFrames -- Number of frames to process
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int benchmark_crc (unsigned int const &nofFrames)
+{
+  cout << "\n[tdalCommon_crc::benchmark_crc]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<uint16_t> buffer (nofPayloadWords);
+  uint32_t check16 (0);
+  uint32_t check32 (0);
+  double start;
+  double elapsed[4];
+
+  for (unsigned int n=0; n<buffer.size(); ++n) {
+    buffer[n] = (n*2654435761u) >> 16;
+  }
+
+  start = wallTime();
+  for (unsigned int n=0; n<nofFrames; ++n) {
+    buffer[0] = n;
+    check16  += DAL::crc16_bitwise (&buffer[0], nofHeaderWords);
+  }
+  elapsed[0] = wallTime()-start;
+
+  start = wallTime();
+  for (unsigned int n=0; n<nofFrames; ++n) {
+    buffer[0] = n;
+    check16  -= DAL::crc16 (&buffer[0], nofHeaderWords);
+  }
+  elapsed[1] = wallTime()-start;
+
+  start = wallTime();
+  for (unsigned int n=0; n<nofFrames; ++n) {
+    buffer[0] = n;
+    check32  += DAL::crc32_bitwise (&buffer[0], nofPayloadWords);
+  }
+  elapsed[2] = wallTime()-start;
+
+  start = wallTime();
+  for (unsigned int n=0; n<nofFrames; ++n) {
+    buffer[0] = n;
+    check32  -= DAL::crc32 (&buffer[0], nofPayloadWords);
+  }
+  elapsed[3] = wallTime()-start;
+
+  /* Both versions must have produced the same values */
+  if (check16 != 0 || check32 != 0) {
+    cerr << "-- Results of the CRC versions differ" << endl;
+    ++nofFailedTests;
+  }
+
+  cout << "-- nof. frames ......... : " << nofFrames << endl;
+  cout << "-- crc16 bitwise [sec] . : " << elapsed[0] << endl;
+  cout << "-- crc16 table   [sec] . : " << elapsed[1]
+       << "  (x " << elapsed[0]/(elapsed[1]+1e-9) << ")" << endl;
+  cout << "-- crc32 bitwise [sec] . : " << elapsed[2] << endl;
+  cout << "-- crc32 table   [sec] . : " << elapsed[3]
+       << "  (x " << elapsed[2]/(elapsed[3]+1e-9) << ")" << endl;
+  cout << "-- crc32 table [MB/s] .. : "
+       << nofFrames*nofPayloadWords*2/(elapsed[3]+1e-9)/1e6 << endl;
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+int main (int argc,
+	  char *argv[])
+{
+  int nofFailedTests (0);
+  unsigned int nofFrames (20000);
+
+  if (argc > 1) {
+    nofFrames = atoi (argv[1]);
+  }
+
+  nofFailedTests += test_crc ();
+  nofFailedTests += benchmark_crc (nofFrames);
+
+  return nofFailedTests;
+}
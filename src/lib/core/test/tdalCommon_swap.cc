@@ -0,0 +1,212 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <sys/time.h>
+#include <core/dalCommon.h>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/*!
+  \file tdalCommon_swap.cc
+
+  \ingroup DAL
+  \ingroup core
+
+  \brief Test and micro-benchmark for the bulk byte swapping routines
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tdalCommon_swap [nofFrames]
+  \endverbatim
+
+  Checks swapbytes16(), swapbytes32() and swapbytes64() against the generic
+  DAL::swapbytes(char*,int8_t) for all lengths and alignments of a small
+  buffer, and then times both on \e nofFrames (default: 20000) TBB-sized
+  frames of 1024 samples.
+*/
+
+//! Number of 16-bit samples in a TBB frame
+const unsigned int nofFrameSamples = 1024;
+
+// -----------------------------------------------------------------------------
+
+//! Get the wall-clock time, [sec]
+double wallTime ()
+{
+  struct timeval tv;
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec + 1e-6*tv.tv_usec;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Compare the bulk routines with the generic byte swap
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int test_swap ()
+{
+  cout << "\n[tdalCommon_swap::test_swap]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<char> original (200);
+  std::vector<char> expected;
+  std::vector<char> buffer;
+
+  srand (42);
+  for (unsigned int n=0; n<original.size(); ++n) {
+    original[n] = rand() & 0xff;
+  }
+
+  cout << "[1] Compare with generic byte swap ..." << endl;
+  for (int width=2; width<=8; width*=2) {
+    for (unsigned int offset=0; offset<8; ++offset) {
+      for (unsigned int nofValues=0; nofValues<20; ++nofValues) {
+	expected = buffer = original;
+	for (unsigned int n=0; n<nofValues; ++n) {
+	  DAL::swapbytes (&expected[offset+n*width], width);
+	}
+	switch (width) {
+	case 2:
+	  DAL::swapbytes16 (&buffer[offset], nofValues);
+	  break;
+	case 4:
+	  DAL::swapbytes32 (&buffer[offset], nofValues);
+	  break;
+	default:
+	  DAL::swapbytes64 (&buffer[offset], nofValues);
+	  break;
+	}
+	if (buffer != expected) {
+	  cerr << "-- Mismatch for width " << width << ", offset " << offset
+	       << ", length " << nofValues << endl;
+	  ++nofFailedTests;
+	}
+      }
+    }
+  }
+
+  cout << "[2] Swap typed arrays ..." << endl;
+  {
+    std::complex<int16_t> csdata[3];
+    float fdata[3];
+
+    for (int n=0; n<3; ++n) {
+      csdata[n] = std::complex<int16_t> (0x0102, 0x0304);
+      fdata[n]  = 1.0f;
+    }
+    DAL::swapbytes (csdata, 3);
+    DAL::swapbytes (fdata, 3);
+    if (csdata[2].real() != 0x0201 || csdata[2].imag() != 0x0403) {
+      cerr << "-- Wrong complex<int16_t> swap" << endl;
+      ++nofFailedTests;
+    }
+    DAL::swapbytes (fdata, 3);
+    if (fdata[0] != 1.0f || fdata[2] != 1.0f) {
+      cerr << "-- Swapping floats twice does not give the original" << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Time the byte swapping of TBB-sized frames
+
+  \param nofFrames -- Number of frames to process
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int benchmark_swap (unsigned int const &nofFrames)
+{
+  cout << "\n[tdalCommon_swap::benchmark_swap]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<int16_t> buffer (nofFrameSamples);
+  std::vector<int16_t> reference;
+  double start;
+  double elapsed[2];
+
+  for (unsigned int n=0; n<buffer.size(); ++n) {
+    buffer[n] = n*37;
+  }
+  reference = buffer;
+
+  start = wallTime();
+  for (unsigned int n=0; n<nofFrames; ++n) {
+    for (unsigned int k=0; k<nofFrameSamples; ++k) {
+      DAL::swapbytes ((char *)&buffer[k], 2);
+    }
+  }
+  elapsed[0] = wallTime()-start;
+
+  start = wallTime();
+  for (unsigned int n=0; n<nofFrames; ++n) {
+    DAL::swapbytes (&buffer[0], nofFrameSamples);
+  }
+  elapsed[1] = wallTime()-start;
+
+  /* Each version swapped an equal number of times */
+  if ((nofFrames%2 == 0) && buffer != reference) {
+    cerr << "-- Buffer not restored after an even number of swaps" << endl;
+    ++nofFailedTests;
+  }
+
+  cout << "-- nof. frames ......... : " << nofFrames << endl;
+  cout << "-- generic swap [sec] .. : " << elapsed[0] << endl;
+  cout << "-- bulk swap    [sec] .. : " << elapsed[1]
+       << "  (x " << elapsed[0]/(elapsed[1]+1e-9) << ")" << endl;
+  cout << "-- bulk swap   [MB/s] .. : "
+       << nofFrames*nofFrameSamples*2/(elapsed[1]+1e-9)/1e6 << endl;
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+int main (int argc,
+	  char *argv[])
+{
+  int nofFailedTests (0);
+  unsigned int nofFrames (20000);
+
+  if (argc > 1) {
+    nofFrames = atoi (argv[1]);
+  }
+
+  nofFailedTests += test_swap ();
+  nofFailedTests += benchmark_swap (nofFrames);
+
+  return nofFailedTests;
+}
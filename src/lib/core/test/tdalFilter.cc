@@ -123,6 +123,49 @@ int test_methods ()
   
   int nofFailedTests (0);
   std::string columns ("DATA");
+
+  std::cout << "\n[1] Testing setFilter(string,string) for HDF5 ..." << std::endl;
+  {
+    DAL::dalFilter filter (DAL::dalFileType::HDF5, "TIME, DATA");
+
+    if (!filter.setFilter ("TIME, DATA", "TIME >= 100 AND FLAG != 1 AND X<-2.5")) {
+      ++nofFailedTests;
+    }
+
+    std::vector<std::string> names = filter.columns();
+    std::vector<DAL::dalFilter::Condition> conditions = filter.conditions();
+
+    if (names.size() != 2 || names[1] != "DATA") {
+      ++nofFailedTests;
+    }
+
+    if (conditions.size() != 3
+	|| conditions[0].column != "TIME"
+	|| conditions[0].op != DAL::Operator::GreaterEqual
+	|| conditions[1].op != DAL::Operator::NotEqual
+	|| conditions[2].column != "X"
+	|| conditions[2].value != -2.5) {
+      ++nofFailedTests;
+    } else if (!DAL::dalFilter::evaluate (conditions[0], 100)
+	       || DAL::dalFilter::evaluate (conditions[1], 1)
+	       || DAL::dalFilter::evaluate (conditions[2], -2.5)) {
+      ++nofFailedTests;
+    }
+  }
+
+  std::cout << "\n[2] Testing setFilter() with invalid input ..." << std::endl;
+  {
+    DAL::dalFilter filter (DAL::dalFileType::HDF5, "*");
+
+    if (!filter.isSet() || !filter.columns().empty()) {
+      ++nofFailedTests;
+    }
+    if (filter.setFilter ("TIME,,DATA")
+	|| filter.setFilter ("DATA", "TIME > 1 AND FLAG")
+	|| filter.setFilter ("DATA", "TIME > one")) {
+      ++nofFailedTests;
+    }
+  }
   
   return nofFailedTests;
 }
@@ -186,6 +186,234 @@ int test_methods (std::string const &filename,
   return nofFailedTests;
 }
 
+//_______________________________________________________________________________
+//                                                                    test_append
+
+/*!
+  \brief Test appending records to a newly created table
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int test_append ()
+{
+  std::cout << "\n[tdalTable::test_append]\n" << std::endl;
+
+  int nofFailedTests (0);
+  std::string filename ("tdalTable.h5");
+
+  typedef struct Record {
+    int id;
+    double value;
+  } Record;
+
+  typedef struct Extended {
+    int id;
+    double value;
+    float weight;
+  } Extended;
+
+  DAL::dalDataset dataset (filename, "HDF5", DAL::IO_Mode(DAL::IO_Mode::Truncate));
+  DAL::dalTable * table = dataset.createTable ("RECORDS");
+
+  table->addColumn ("ID", DAL::dal_INT);
+  table->addColumn ("VALUE", DAL::dal_DOUBLE);
+
+  std::cout << "[1] Testing recordSize() ..." << std::endl;
+  if (table->recordSize() != sizeof(Record)) {
+    std::cerr << "-- Wrong record size: " << table->recordSize() << std::endl;
+    delete table;
+    return ++nofFailedTests;
+  }
+
+  std::cout << "[2] Testing appendRow(void*) ..." << std::endl;
+  {
+    Record record = {0, 0.5};
+    table->appendRow (&record);
+    if (table->getNumberOfRows() != 1) {
+      ++nofFailedTests;
+    }
+  }
+
+  std::cout << "[3] Testing appendRows(void*,long) and append(void*,hsize_t) ..."
+	    << std::endl;
+  {
+    Record records[100];
+    for (int n=0; n<100; ++n) {
+      records[n].id    = n+1;
+      records[n].value = 0.5*(n+2);
+    }
+    table->appendRows (records, 10);
+    for (int n=10; n<100; n+=30) {
+      if (!table->append (records+n, 30)) {
+	++nofFailedTests;
+      }
+    }
+    if (table->getNumberOfRows() != 101) {
+      std::cerr << "-- Wrong number of rows: " << table->getNumberOfRows()
+		<< std::endl;
+      ++nofFailedTests;
+    }
+  }
+
+  std::cout << "[4] Reading back the records ..." << std::endl;
+  {
+    Record records[101];
+    table->readRows (records, 0, 101);
+    for (int n=0; n<101; ++n) {
+      if (records[n].id != n || records[n].value != 0.5*(n+1)) {
+	std::cerr << "-- Wrong record " << n << " : " << records[n].id
+		  << " " << records[n].value << std::endl;
+	++nofFailedTests;
+	break;
+      }
+    }
+  }
+
+  std::cout << "[5] Appending after adding a column ..." << std::endl;
+  {
+    table->addColumn ("WEIGHT", DAL::dal_FLOAT);
+    Extended record = {101, 51.0, 2.0f};
+
+    if (table->recordSize() != sizeof(Extended)
+	|| !table->append (&record)
+	|| table->getNumberOfRows() != 102) {
+      ++nofFailedTests;
+    }
+  }
+
+  std::cout << "[6] Testing dalTable(dalTable) and operator= ..." << std::endl;
+  {
+    DAL::dalTable * copy = new DAL::dalTable (*table);
+    DAL::dalTable assigned;
+    Extended record = {102, 51.5, 1.0f};
+
+    assigned = *copy;
+    /* The identifiers of the records are shared, so all copies remain usable */
+    delete copy;
+
+    if (assigned.recordSize() != sizeof(Extended)
+	|| !assigned.append (&record)
+	|| table->getNumberOfRows() != 103) {
+      ++nofFailedTests;
+    }
+  }
+
+  delete table;
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                              test_readFiltered
+
+/*!
+  \brief Test reading the selected columns of the rows passing a filter
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function
+*/
+int test_readFiltered ()
+{
+  std::cout << "\n[tdalTable::test_readFiltered]\n" << std::endl;
+
+  int nofFailedTests (0);
+  int nofRows (1000);
+  std::string filename ("tdalTable_filter.h5");
+
+  typedef struct Record {
+    int id;
+    double value;
+    short flag;
+  } Record;
+
+  typedef struct Selection {
+    double value;
+    int id;
+  } Selection;
+
+  DAL::dalDataset dataset (filename, "HDF5", DAL::IO_Mode(DAL::IO_Mode::Truncate));
+  DAL::dalTable * table = dataset.createTable ("RECORDS");
+
+  table->addColumn ("ID", DAL::dal_INT);
+  table->addColumn ("VALUE", DAL::dal_DOUBLE);
+  table->addColumn ("FLAG", DAL::dal_SHORT);
+
+  std::vector<Record> records (nofRows);
+  for (int n=0; n<nofRows; ++n) {
+    records[n].id    = n;
+    records[n].value = 0.25*n;
+    records[n].flag  = n%3 == 0;
+  }
+  table->append (&records[0], nofRows);
+
+  std::cout << "[1] Projection of two columns, in a different order ..." << std::endl;
+  {
+    std::vector<char> data;
+    std::vector<hsize_t> rows;
+
+    table->setFilter ("VALUE, ID");
+
+    if (table->filteredRecordSize() != sizeof(Selection)
+	|| table->readFiltered (data, rows, 64) != nofRows
+	|| data.size() != nofRows*sizeof(Selection)) {
+      ++nofFailedTests;
+    } else {
+      Selection const *selection = reinterpret_cast<Selection const *>(&data[0]);
+      if (selection[999].id != 999 || selection[999].value != 0.25*999) {
+	++nofFailedTests;
+      }
+    }
+  }
+
+  std::cout << "[2] Projection with conditions on other columns ..." << std::endl;
+  {
+    std::vector<char> data;
+    std::vector<hsize_t> rows;
+
+    table->setFilter ("VALUE,ID", "ID >= 100 AND FLAG == 1 and VALUE < 225");
+
+    long nofMatches = table->readFiltered (data, rows, 64);
+
+    /* Rows 102, 105, ..., 897 */
+    if (nofMatches != 266 || rows.size() != 266 || rows[0] != 102) {
+      std::cerr << "-- Wrong number of matching rows: " << nofMatches << std::endl;
+      ++nofFailedTests;
+    } else {
+      Selection const *selection = reinterpret_cast<Selection const *>(&data[0]);
+      for (long n=0; n<nofMatches; ++n) {
+	if (selection[n].id != int(rows[n])
+	    || selection[n].id != 102+3*n
+	    || selection[n].value != 0.25*selection[n].id) {
+	  std::cerr << "-- Wrong record " << n << std::endl;
+	  ++nofFailedTests;
+	  break;
+	}
+      }
+    }
+  }
+
+  std::cout << "[3] Filters referring to unknown columns ..." << std::endl;
+  {
+    std::vector<char> data;
+    std::vector<hsize_t> rows;
+
+    table->setFilter ("VALUE", "WEIGHT > 1");
+    if (table->readFiltered (data, rows) != -1) {
+      ++nofFailedTests;
+    }
+
+    table->setFilter ("WEIGHT");
+    if (table->readFiltered (data, rows) != -1 || table->filteredRecordSize() != 0) {
+      ++nofFailedTests;
+    }
+  }
+
+  delete table;
+
+  return nofFailedTests;
+}
+
 //_______________________________________________________________________________
 //                                                                           main
 
@@ -210,6 +438,9 @@ int main (int argc,
   //________________________________________________________
   // Run the tests
 
+  nofFailedTests += test_append ();
+  nofFailedTests += test_readFiltered ();
+
   if (haveDataset) {
     nofFailedTests += test_constructors(filename, haveDataset);
     nofFailedTests += test_parameters(filename, haveDataset);
@@ -383,51 +383,56 @@ namespace DAL { // Namespace DAL -- begin
   */
   bool CommonAttributes::h5write (hid_t const &id)
   {
-    bool status (true);
-    
-    HDF5Attribute::write (id, "GROUPTYPE", itsGroupType );
-    HDF5Attribute::write (id, "FILENAME",  itsFilename );
-    HDF5Attribute::write (id, "FILETYPE",  itsFiletype );
-    HDF5Attribute::write (id, "FILEDATE",  itsFiledate );
-    HDF5Attribute::write (id, "TELESCOPE", itsTelescope );
-    HDF5Attribute::write (id, "OBSERVER",  itsObserver );
+    /* Read the current values, such that only modified attributes are written */
+    HDF5AttributeCache cache (id);
+    cache.setDeferredWrites (true);
+
+    cache.set ("GROUPTYPE", itsGroupType );
+    cache.set ("FILENAME",  itsFilename );
+    cache.set ("FILETYPE",  itsFiletype );
+    cache.set ("FILEDATE",  itsFiledate );
+    cache.set ("TELESCOPE", itsTelescope );
+    cache.set ("OBSERVER",  itsObserver );
     /*________________________________________________________________
       Common LOFAR attributes for description of project 
     */
-    HDF5Attribute::write (id, "PROJECT_ID",      itsProjectID );
-    HDF5Attribute::write (id, "PROJECT_TITLE",   itsProjectTitle );
-    HDF5Attribute::write (id, "PROJECT_PI",      itsProjectPI );
-    HDF5Attribute::write (id, "PROJECT_CO_I",    itsProjectCoI );
-    HDF5Attribute::write (id, "PROJECT_CONTACT", itsProjectContact );
+    cache.set ("PROJECT_ID",      itsProjectID );
+    cache.set ("PROJECT_TITLE",   itsProjectTitle );
+    cache.set ("PROJECT_PI",      itsProjectPI );
+    cache.set ("PROJECT_CO_I",    itsProjectCoI );
+    cache.set ("PROJECT_CONTACT", itsProjectContact );
     /*________________________________________________________________
     */
-    HDF5Attribute::write (id, "OBSERVATION_ID",               itsObservationID);
-    HDF5Attribute::write (id, "OBSERVATION_START_MJD",        itsStartMJD);
-    HDF5Attribute::write (id, "OBSERVATION_START_TAI",        itsStartTAI);
-    HDF5Attribute::write (id, "OBSERVATION_START_UTC",        itsStartUTC);
-    HDF5Attribute::write (id, "OBSERVATION_END_MJD",          itsEndMJD);
-    HDF5Attribute::write (id, "OBSERVATION_END_TAI",          itsEndTAI);
-    HDF5Attribute::write (id, "OBSERVATION_END_UTC",          itsEndUTC);
-    HDF5Attribute::write (id, "OBSERVATION_NOF_STATIONS",     itsNofStations);
-    HDF5Attribute::write (id, "OBSERVATION_STATIONS_LIST",    itsStationsList);
-    HDF5Attribute::write (id, "OBSERVATION_FREQUENCY_MIN",    itsFrequencyMin);
-    HDF5Attribute::write (id, "OBSERVATION_FREQUENCY_MAX",    itsFrequencyMax);
-    HDF5Attribute::write (id, "OBSERVATION_FREQUENCY_CENTER", itsFrequencyCenter);
-    HDF5Attribute::write (id, "OBSERVATION_FREQUENCY_UNIT",   itsFrequencyUnit);
-    HDF5Attribute::write (id, "OBSERVATION_NOF_BITS_PER_SAMPLE", itsNofBitsPerSample);
+    cache.set ("OBSERVATION_ID",               itsObservationID);
+    cache.set ("OBSERVATION_START_MJD",        itsStartMJD);
+    cache.set ("OBSERVATION_START_TAI",        itsStartTAI);
+    cache.set ("OBSERVATION_START_UTC",        itsStartUTC);
+    cache.set ("OBSERVATION_END_MJD",          itsEndMJD);
+    cache.set ("OBSERVATION_END_TAI",          itsEndTAI);
+    cache.set ("OBSERVATION_END_UTC",          itsEndUTC);
+    cache.set ("OBSERVATION_NOF_STATIONS",     itsNofStations);
+    cache.set ("OBSERVATION_STATIONS_LIST",    itsStationsList);
+    cache.set ("OBSERVATION_FREQUENCY_MIN",    itsFrequencyMin);
+    cache.set ("OBSERVATION_FREQUENCY_MAX",    itsFrequencyMax);
+    cache.set ("OBSERVATION_FREQUENCY_CENTER", itsFrequencyCenter);
+    cache.set ("OBSERVATION_FREQUENCY_UNIT",   itsFrequencyUnit);
+    cache.set ("OBSERVATION_NOF_BITS_PER_SAMPLE", itsNofBitsPerSample);
     /*________________________________________________________________
     */
-    HDF5Attribute::write (id, "ANTENNA_SET",          itsAntennaSet );
-    HDF5Attribute::write (id, "FILTER_SELECTION",     itsFilterSelection );
-    HDF5Attribute::write (id, "CLOCK_FREQUENCY",      itsClockFrequency );
-    HDF5Attribute::write (id, "CLOCK_FREQUENCY_UNIT", itsClockFrequencyUnit );
-    HDF5Attribute::write (id, "TARGET",               itsTarget );
-    HDF5Attribute::write (id, "SYSTEM_VERSION",       itsSystemVersion );
-    HDF5Attribute::write (id, "PIPELINE_NAME",        itsPipelineName );
-    HDF5Attribute::write (id, "PIPELINE_VERSION",     itsPipelineVersion );
-    HDF5Attribute::write (id, "ICD_NUMBER",           itsIcdNumber       );
-    HDF5Attribute::write (id, "ICD_VERSION",          itsIcdVersion      );
-    HDF5Attribute::write (id, "NOTES",                itsNotes           );
+    cache.set ("ANTENNA_SET",          itsAntennaSet );
+    cache.set ("FILTER_SELECTION",     itsFilterSelection );
+    cache.set ("CLOCK_FREQUENCY",      itsClockFrequency );
+    cache.set ("CLOCK_FREQUENCY_UNIT", itsClockFrequencyUnit );
+    cache.set ("TARGET",               itsTarget );
+    cache.set ("SYSTEM_VERSION",       itsSystemVersion );
+    cache.set ("PIPELINE_NAME",        itsPipelineName );
+    cache.set ("PIPELINE_VERSION",     itsPipelineVersion );
+    cache.set ("ICD_NUMBER",           itsIcdNumber       );
+    cache.set ("ICD_VERSION",          itsIcdVersion      );
+    cache.set ("NOTES",                itsNotes           );
+
+    /* Write the modified attributes in one go */
+    bool status = cache.flush();
 
     return status;
   }
@@ -443,50 +448,53 @@ namespace DAL { // Namespace DAL -- begin
   {
     bool status (true);
 
-    HDF5Attribute::read (location, "GROUPTYPE",      itsGroupType );
-    HDF5Attribute::read (location, "FILENAME",       itsFilename );
-    HDF5Attribute::read (location, "FILETYPE",       itsFiletype );
-    HDF5Attribute::read (location, "FILEDATE",       itsFiledate );
-    HDF5Attribute::read (location, "TELESCOPE",      itsTelescope );
-    HDF5Attribute::read (location, "OBSERVER",       itsObserver );
+    /* Read all attributes with a single pass */
+    HDF5AttributeCache cache (location);
+
+    cache.get ("GROUPTYPE",      itsGroupType );
+    cache.get ("FILENAME",       itsFilename );
+    cache.get ("FILETYPE",       itsFiletype );
+    cache.get ("FILEDATE",       itsFiledate );
+    cache.get ("TELESCOPE",      itsTelescope );
+    cache.get ("OBSERVER",       itsObserver );
     /*________________________________________________________________
       Common LOFAR attributes for description of project 
     */
-    HDF5Attribute::read (location, "PROJECT_ID",      itsProjectID );
-    HDF5Attribute::read (location, "PROJECT_TITLE",   itsProjectTitle );
-    HDF5Attribute::read (location, "PROJECT_PI",      itsProjectPI );
-    HDF5Attribute::read (location, "PROJECT_CO_I",    itsProjectCoI );
-    HDF5Attribute::read (location, "PROJECT_CONTACT", itsProjectContact );
+    cache.get ("PROJECT_ID",      itsProjectID );
+    cache.get ("PROJECT_TITLE",   itsProjectTitle );
+    cache.get ("PROJECT_PI",      itsProjectPI );
+    cache.get ("PROJECT_CO_I",    itsProjectCoI );
+    cache.get ("PROJECT_CONTACT", itsProjectContact );
     /*________________________________________________________________
       Common LOFAR attributes for description of observation
     */
-    HDF5Attribute::read (location, "OBSERVATION_ID",               itsObservationID);
-    HDF5Attribute::read (location, "OBSERVATION_START_MJD",        itsStartMJD);
-    HDF5Attribute::read (location, "OBSERVATION_START_TAI",        itsStartTAI);
-    HDF5Attribute::read (location, "OBSERVATION_START_UTC",        itsStartUTC);
-    HDF5Attribute::read (location, "OBSERVATION_END_MJD",          itsEndMJD);
-    HDF5Attribute::read (location, "OBSERVATION_END_TAI",          itsEndTAI);
-    HDF5Attribute::read (location, "OBSERVATION_END_UTC",          itsEndUTC);
-    HDF5Attribute::read (location, "OBSERVATION_NOF_STATIONS",     itsNofStations);
-    HDF5Attribute::read (location, "OBSERVATION_STATIONS_LIST",    itsStationsList);
-    HDF5Attribute::read (location, "OBSERVATION_FREQUENCY_MIN",    itsFrequencyMin);
-    HDF5Attribute::read (location, "OBSERVATION_FREQUENCY_MAX",    itsFrequencyMax);
-    HDF5Attribute::read (location, "OBSERVATION_FREQUENCY_CENTER", itsFrequencyCenter);
-    HDF5Attribute::read (location, "OBSERVATION_FREQUENCY_UNIT",   itsFrequencyUnit);
-    HDF5Attribute::read (location, "OBSERVATION_NOF_BITS_PER_SAMPLE", itsNofBitsPerSample);
+    cache.get ("OBSERVATION_ID",               itsObservationID);
+    cache.get ("OBSERVATION_START_MJD",        itsStartMJD);
+    cache.get ("OBSERVATION_START_TAI",        itsStartTAI);
+    cache.get ("OBSERVATION_START_UTC",        itsStartUTC);
+    cache.get ("OBSERVATION_END_MJD",          itsEndMJD);
+    cache.get ("OBSERVATION_END_TAI",          itsEndTAI);
+    cache.get ("OBSERVATION_END_UTC",          itsEndUTC);
+    cache.get ("OBSERVATION_NOF_STATIONS",     itsNofStations);
+    cache.get ("OBSERVATION_STATIONS_LIST",    itsStationsList);
+    cache.get ("OBSERVATION_FREQUENCY_MIN",    itsFrequencyMin);
+    cache.get ("OBSERVATION_FREQUENCY_MAX",    itsFrequencyMax);
+    cache.get ("OBSERVATION_FREQUENCY_CENTER", itsFrequencyCenter);
+    cache.get ("OBSERVATION_FREQUENCY_UNIT",   itsFrequencyUnit);
+    cache.get ("OBSERVATION_NOF_BITS_PER_SAMPLE", itsNofBitsPerSample);
     /*________________________________________________________________
      */
-    HDF5Attribute::read (location, "ANTENNA_SET",           itsAntennaSet );
-    HDF5Attribute::read (location, "FILTER_SELECTION",      itsFilterSelection );
-    HDF5Attribute::read (location, "CLOCK_FREQUENCY",       itsClockFrequency );
-    HDF5Attribute::read (location, "CLOCK_FREQUENCY_UNIT",  itsClockFrequencyUnit );
-    HDF5Attribute::read (location, "TARGET",                itsTarget );
-    HDF5Attribute::read (location, "SYSTEM_VERSION",        itsSystemVersion );
-    HDF5Attribute::read (location, "PIPELINE_NAME",         itsPipelineName );
-    HDF5Attribute::read (location, "PIPELINE_VERSION",      itsPipelineVersion );
-    HDF5Attribute::read (location, "ICD_NUMBER",            itsIcdNumber       );
-    HDF5Attribute::read (location, "ICD_VERSION",           itsIcdVersion      );
-    HDF5Attribute::read (location, "NOTES",                 itsNotes           );
+    cache.get ("ANTENNA_SET",           itsAntennaSet );
+    cache.get ("FILTER_SELECTION",      itsFilterSelection );
+    cache.get ("CLOCK_FREQUENCY",       itsClockFrequency );
+    cache.get ("CLOCK_FREQUENCY_UNIT",  itsClockFrequencyUnit );
+    cache.get ("TARGET",                itsTarget );
+    cache.get ("SYSTEM_VERSION",        itsSystemVersion );
+    cache.get ("PIPELINE_NAME",         itsPipelineName );
+    cache.get ("PIPELINE_VERSION",      itsPipelineVersion );
+    cache.get ("ICD_NUMBER",            itsIcdNumber       );
+    cache.get ("ICD_VERSION",           itsIcdVersion      );
+    cache.get ("NOTES",                 itsNotes           );
 
     return status;
   }
@@ -99,7 +99,14 @@ namespace DAL { // Namespace DAL -- begin
   }
   
   void HDF5DatasetBase::destroy ()
-  {;}
+  {
+    HDF5IOExecutor::Lock lock;
+
+    /* Write attributes still kept in memory, while the dataset is open */
+    if (H5Iis_valid(itsLocation)) {
+      flushAttributes ();
+    }
+  }
   
   // ============================================================================
   //
@@ -117,11 +124,29 @@ namespace DAL { // Namespace DAL -- begin
   {
     if (this != &other) {
       destroy ();
+      HDF5Dataset::operator= (other);
       copy (other);
     }
     return *this;
   }
   
+  //_____________________________________________________________________________
+  //                                                                         swap
+  
+  /*!
+    \param other -- Another HDF5DatasetBase object with which to exchange
+           contents.
+  */
+  void HDF5DatasetBase::swap (HDF5DatasetBase &other)
+  {
+    HDF5Dataset::swap (other);
+    std::swap (itsFlags, other.itsFlags);
+    itsAttributes.swap (other.itsAttributes);
+    itsGroupType.swap (other.itsGroupType);
+    itsWCSinfo.swap (other.itsWCSinfo);
+    itsAttributeCache.swap (other.itsAttributeCache);
+  }
+  
   //_____________________________________________________________________________
   //                                                                         copy
   
@@ -134,6 +159,9 @@ namespace DAL { // Namespace DAL -- begin
     itsAttributes = other.itsAttributes;
     itsGroupType  = other.itsGroupType;
     itsWCSinfo    = other.itsWCSinfo;
+    /* The other object remains responsible for writing its modifications */
+    itsAttributeCache = other.itsAttributeCache;
+    itsAttributeCache.resetModified();
   }
   
   // ============================================================================
@@ -184,9 +212,11 @@ namespace DAL { // Namespace DAL -- begin
       if (h5err>0) {
 	itsFlags = flags;
 	/* Open existing dataset */
+	hid_t accessList = itsAccessOptions.datasetAccessList();
 	itsLocation = H5Dopen (location,
 			       name.c_str(),
-			       H5P_DEFAULT);
+			       accessList);
+	HDF5AccessOptions::release (accessList);
       } else {
 	std::cerr << "[HDF5DatasetBase::open]"
 		  << " Object " << name << " not found at provided location!"
@@ -229,6 +259,22 @@ namespace DAL { // Namespace DAL -- begin
     return status;
   }
   
+  //_____________________________________________________________________________
+  //                                                              flushAttributes
+
+  /*!
+    \return status -- Returns \e false if writing any of the modified
+            attributes failed.
+  */
+  bool HDF5DatasetBase::flushAttributes ()
+  {
+    if (itsAttributeCache.location() == itsLocation) {
+      return itsAttributeCache.flush();
+    } else {
+      return true;
+    }
+  }
+  
   // ============================================================================
   //
   //  Static methods
@@ -262,6 +308,24 @@ namespace DAL { // Namespace DAL -- begin
     itsWCSinfo   = "";
   }
   
+  //_____________________________________________________________________________
+  //                                                           loadAttributeCache
+
+  /*!
+    The attributes are read again if the dataset has been (re-)opened since the
+    cache was filled.
+
+    \return status -- Returns \e false if the attributes could not be read.
+  */
+  bool HDF5DatasetBase::loadAttributeCache ()
+  {
+    if (itsAttributeCache.isLoaded() && itsAttributeCache.location() == itsLocation) {
+      return true;
+    } else {
+      return itsAttributeCache.load (itsLocation);
+    }
+  }
+  
   //_____________________________________________________________________________
   //                                                                setAttributes
   
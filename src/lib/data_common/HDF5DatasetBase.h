@@ -28,6 +28,7 @@
 
 // DAL header files
 #include <core/HDF5Dataset.h>
+#include <core/HDF5AttributeCache.h>
 
 namespace DAL { // Namespace DAL -- begin
   
@@ -52,6 +53,13 @@ namespace DAL { // Namespace DAL -- begin
     </ul>
     
     <h3>Synopsis</h3>
+
+    The values of the attributes attached to the dataset are kept in a
+    DAL::HDF5AttributeCache: the first call to readAttribute() reads all
+    attributes in a single pass, further calls are served from memory.
+    writeAttribute() writes an attribute only if its value changes; after
+    setDeferredWrites() modified attributes are kept until flushAttributes()
+    or the destruction of the object.
     
     <h3>Example(s)</h3>
     
@@ -68,6 +76,8 @@ namespace DAL { // Namespace DAL -- begin
     std::string itsGroupType;
     //! Path to the coordinates group
     std::string itsWCSinfo;
+    //! Values of the attributes attached to the dataset
+    HDF5AttributeCache itsAttributeCache;
 
   public:
     
@@ -113,6 +123,9 @@ namespace DAL { // Namespace DAL -- begin
     
     //! Overloading of the copy operator
     HDF5DatasetBase& operator= (HDF5DatasetBase const &other); 
+
+    //! Exchange the contents with another object, without copying
+    void swap (HDF5DatasetBase &other);
     
     // === Parameter access =====================================================
     
@@ -140,6 +153,16 @@ namespace DAL { // Namespace DAL -- begin
     inline void setWCSinfo (std::string const &WCSinfo) {
       itsWCSinfo = WCSinfo;
     }
+
+    //! Are modified attributes kept in memory until flushAttributes()?
+    inline bool deferredWrites () const {
+      return itsAttributeCache.deferredWrites();
+    }
+
+    //! Keep modified attributes in memory until flushAttributes()?
+    inline void setDeferredWrites (bool const &doit=true) {
+      itsAttributeCache.setDeferredWrites (doit);
+    }
     
     /*!
       \brief Get the name of the class
@@ -171,6 +194,50 @@ namespace DAL { // Namespace DAL -- begin
 	       hid_t const &datatype=H5T_NATIVE_DOUBLE,
 	       IO_Mode const &flags=IO_Mode(IO_Mode::CreateNew));
 
+    /*!
+      \brief Read value of attribute attached to dataset
+
+      \param name    -- Name of the attribute.
+      \retval data   -- Value(s) of the attribute.
+      \return status -- Status of the operation; returns \e false in case an
+              error was encountered.
+    */
+    template <class T>
+      inline bool readAttribute (std::string const &name,
+				 T &data)
+      {
+	/* Serve the value from the cache, if it holds the attribute */
+	if (loadAttributeCache() && itsAttributeCache.has(name)) {
+	  return itsAttributeCache.get (name, data);
+	}
+	return HDF5Attribute::read (itsLocation, name, data);
+      }
+
+    /*!
+      \brief Write value of attribute attached to dataset
+
+      \param name    -- Name of the attribute.
+      \param data    -- Value(s) of the attribute.
+      \return status -- Status of the operation; returns \e false in case an
+              error was encountered.
+    */
+    template <class T>
+      inline bool writeAttribute (std::string const &name,
+				  T const &data)
+      {
+	itsAttributeCache.attach (itsLocation);
+	/* Types not handled by the cache are written directly */
+	if (itsAttributeCache.set (name, data)) {
+	  return true;
+	} else {
+	  itsAttributeCache.remove (name);
+	  return HDF5Attribute::write (itsLocation, name, data);
+	}
+      }
+
+    //! Write the modified attributes to the file
+    bool flushAttributes ();
+
     // === Static methods =======================================================
     
     //! Convert dataset index to name of the HDF5 dataset
@@ -178,6 +245,9 @@ namespace DAL { // Namespace DAL -- begin
     
   private:
     
+    //! Read the attributes into the cache, unless already done
+    bool loadAttributeCache ();
+
     //! Initialize internal parameters
     void init (IO_Mode const &flags=IO_Mode());
 
@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include "HDF5GroupBase.h"
+#include <core/HDF5IOExecutor.h>
 
 namespace DAL { // Namespace DAL -- begin
 
@@ -30,7 +31,11 @@ namespace DAL { // Namespace DAL -- begin
 
   void HDF5GroupBase::destroy ()
   {
+    HDF5IOExecutor::Lock lock;
+
     if (hasValidID()) {
+      // Write attributes still kept in memory
+      flushAttributes();
       // Close the object
       HDF5Object::close(location_p);
       // Decrement reference count for the object
@@ -58,6 +63,23 @@ namespace DAL { // Namespace DAL -- begin
     return *this;
   }
   
+  //_____________________________________________________________________________
+  //                                                                         swap
+  
+  /*!
+    \param other -- Another HDF5GroupBase object with which to exchange the
+           identifier, the attributes and the I/O mode flags; neither object is
+           opened or closed in the process.
+  */
+  void HDF5GroupBase::swap (HDF5GroupBase &other)
+  {
+    std::swap (location_p, other.location_p);
+    attributes_p.swap (other.attributes_p);
+    itsGroupType.swap (other.itsGroupType);
+    std::swap (itsFlags, other.itsFlags);
+    itsAttributeCache.swap (other.itsAttributeCache);
+  }
+  
   //_____________________________________________________________________________
   //                                                                         copy
   
@@ -70,6 +92,9 @@ namespace DAL { // Namespace DAL -- begin
     location_p   = other.location_p;
     attributes_p = other.attributes_p;
     itsGroupType = other.itsGroupType;
+    // The other object remains responsible for writing its modifications
+    itsAttributeCache = other.itsAttributeCache;
+    itsAttributeCache.resetModified();
     // Book-keeping
     incrementRefCount ();
   }
@@ -242,6 +267,40 @@ namespace DAL { // Namespace DAL -- begin
     return HDF5Object::objectName (location_p);
   }
   
+  //_____________________________________________________________________________
+  //                                                              flushAttributes
+
+  /*!
+    \return status -- Returns \e false if writing any of the modified
+            attributes failed.
+  */
+  bool HDF5GroupBase::flushAttributes ()
+  {
+    if (itsAttributeCache.location() == location_p) {
+      return itsAttributeCache.flush();
+    } else {
+      return true;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                           loadAttributeCache
+
+  /*!
+    The attributes are read again if the structure has been (re-)opened since
+    the cache was filled.
+
+    \return status -- Returns \e false if the attributes could not be read.
+  */
+  bool HDF5GroupBase::loadAttributeCache ()
+  {
+    if (itsAttributeCache.isLoaded() && itsAttributeCache.location() == location_p) {
+      return true;
+    } else {
+      return itsAttributeCache.load (location_p);
+    }
+  }
+  
   //_____________________________________________________________________________
   //                                                                         open
   
@@ -305,6 +364,7 @@ namespace DAL { // Namespace DAL -- begin
     os << "-- Location ID    = " << location_p              << std::endl;
     os << "-- Group type ID  = " << itsGroupType            << std::endl;
     os << "-- I/O mode flags = " << itsFlags.names()        << std::endl;
+    os << "-- Cached attrib. = " << itsAttributeCache.nofAttributes() << std::endl;
   }
 
   // ============================================================================
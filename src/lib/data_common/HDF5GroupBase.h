@@ -22,6 +22,7 @@
 #define HDF5GROUPBASE_H
 
 // Standard library header files
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -33,6 +34,7 @@
 // DAL header files
 #include <core/dalCommon.h>
 #include <core/HDF5Attribute.h>
+#include <core/HDF5AttributeCache.h>
 #include <core/HDF5Object.h>
 #include <core/IO_Mode.h>
 #include <data_common/CommonAttributes.h>
@@ -76,6 +78,18 @@ namespace DAL { // Namespace DAL -- begin
     std::set<std::string> attributes_p;
     \endcode
 
+    The values of the attributes are kept in a DAL::HDF5AttributeCache: the
+    first call to getAttribute() reads all attributes of the structure in a
+    single pass, further calls are served from memory. setAttribute() writes
+    an attribute only if its value changes; after setDeferredWrites() the
+    modified attributes are kept until flushAttributes(), which writes them
+    back in one go. Since derived classes typically close the structure in
+    their own destructor, they should call flushAttributes() before doing so
+    if deferred writes are enabled. Derived classes writing attributes
+    directly through DAL::HDF5Attribute -- e.g. the defaults written when
+    creating the structure -- call HDF5AttributeCache::invalidate() afterwards,
+    such that getAttribute() does not return stale values.
+
     <h3>Requirements for derived classes</h3>
 
     The HDF5GroupBase requires derived classes to implement the following
@@ -197,6 +211,8 @@ namespace DAL { // Namespace DAL -- begin
     std::string itsGroupType;
     //! I/O mode flags
     IO_Mode itsFlags;
+    //! Values of the attributes attached to the structure
+    HDF5AttributeCache itsAttributeCache;
 
     /* === Protected functions which define basic interface === */
 
@@ -234,6 +250,9 @@ namespace DAL { // Namespace DAL -- begin
 
     //! Copy operator
     HDF5GroupBase& operator= (HDF5GroupBase const &other); 
+
+    //! Exchange the contents with another object, without copying
+    void swap (HDF5GroupBase &other);
     
     // === Parameter accesss ====================================================
     
@@ -268,6 +287,16 @@ namespace DAL { // Namespace DAL -- begin
     bool removeAttribute (std::string const &name);
     //! Remove attributes from the interally kept set
     bool removeAttributes (std::set<std::string> const &names);
+
+    //! Are modified attributes kept in memory until flushAttributes()?
+    inline bool deferredWrites () const {
+      return itsAttributeCache.deferredWrites();
+    }
+
+    //! Keep modified attributes in memory until flushAttributes()?
+    inline void setDeferredWrites (bool const &doit=true) {
+      itsAttributeCache.setDeferredWrites (doit);
+    }
     /*!
       \brief Get the name of the class
       
@@ -293,6 +322,9 @@ namespace DAL { // Namespace DAL -- begin
 
     //! Get the name of the object
     std::string objectName ();
+
+    //! Write the modified attributes to the file
+    bool flushAttributes ();
     
     //! Open a structure (file, group, dataset, etc.)
     bool open (hid_t const &location);
@@ -335,10 +367,13 @@ namespace DAL { // Namespace DAL -- begin
 	if (location_p > 0) {
 	  /* Check if the attribute name is valid */
 	  if (haveAttribute(name)) {
-	    /* Forward the function call to perform the actual retrieval */
+	    /* Serve the value from the cache, if it holds the attribute */
+	    if (loadAttributeCache() && itsAttributeCache.has(name)) {
+	      return itsAttributeCache.get (name, val);
+	    }
 	    return HDF5Attribute::read (location_p,
-					 name,
-					 val);
+					name,
+					val);
 	  } else {
 	    std::cerr << "[HDF5GroupBase::getAttribute]"
 		      << " Invalid attribute name " << name
@@ -370,8 +405,11 @@ namespace DAL { // Namespace DAL -- begin
 	if (location_p > 0) {
 	  /* Check if the attribute name is valid */
 	  if (haveAttribute(name)) {
-	    /* Forward the function call to perform the actual retrieval */
-	    return HDF5Attribute::read(location_p,
+	    /* Serve the value from the cache, if it holds the attribute */
+	    if (loadAttributeCache() && itsAttributeCache.has(name)) {
+	      return itsAttributeCache.get (name, val);
+	    }
+	    return HDF5Attribute::read (location_p,
 					name,
 					val);
 	  } else {
@@ -406,7 +444,15 @@ namespace DAL { // Namespace DAL -- begin
 	if (location_p > 0) {
 	  /* Check if the attribute name is valid */
 	  if (haveAttribute(name)) {
-	    /* Forward the function call to perform the actual retrieval */
+	    /* Serve the value from the cache, if it holds the attribute */
+	    std::vector<T> buffer;
+	    if (loadAttributeCache() && itsAttributeCache.get (name, buffer)) {
+	      val.resize (buffer.size());
+	      for (unsigned int n=0; n<buffer.size(); ++n) {
+		val(n) = buffer[n];
+	      }
+	      return true;
+	    }
 	    return HDF5Attribute::read (location_p,
 					name,
 					val);
@@ -438,9 +484,16 @@ namespace DAL { // Namespace DAL -- begin
       inline bool setAttribute (std::string const &name,
 				T const &val)
       {
-	return HDF5Attribute::write (location_p,
-					    name,
-					    val);
+	itsAttributeCache.attach (location_p);
+	/* Types not handled by the cache are written directly */
+	if (itsAttributeCache.set (name, val)) {
+	  return true;
+	} else {
+	  itsAttributeCache.remove (name);
+	  return HDF5Attribute::write (location_p,
+				       name,
+				       val);
+	}
       }
     
     /*!
@@ -456,10 +509,17 @@ namespace DAL { // Namespace DAL -- begin
       inline bool setAttribute (std::string const &name,
 				std::vector<T> const &val)
       {
-	return HDF5Attribute::write (location_p,
-				     name,
-				     &val[0],
-				     val.size());
+	itsAttributeCache.attach (location_p);
+	/* Types not handled by the cache are written directly */
+	if (itsAttributeCache.set (name, val)) {
+	  return true;
+	} else {
+	  itsAttributeCache.remove (name);
+	  return HDF5Attribute::write (location_p,
+				       name,
+				       &val[0],
+				       val.size());
+	}
       }
     
 #ifdef DAL_WITH_CASA
@@ -476,9 +536,11 @@ namespace DAL { // Namespace DAL -- begin
       inline bool setAttribute (std::string const &name,
 				casa::Vector<T> const &val)
       {
-	return HDF5Attribute::write (location_p,
-				     name,
-				     val);
+	std::vector<T> buffer (val.nelements());
+	for (unsigned int n=0; n<buffer.size(); ++n) {
+	  buffer[n] = val(n);
+	}
+	return setAttribute (name, buffer);
       }
 #endif
 
@@ -496,6 +558,11 @@ namespace DAL { // Namespace DAL -- begin
 		      std::string const &name,
 		      IO_Mode const &flags=IO_Mode(IO_Mode::OpenOrCreate));
     
+  protected:
+
+    //! Read the attributes into the cache, unless already done
+    bool loadAttributeCache ();
+
   private:
     
     //! Increment the reference count for a HDF5 object
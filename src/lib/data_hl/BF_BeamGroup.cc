@@ -224,6 +224,7 @@ namespace DAL { // Namespace DAL -- begin
 	HDF5Attribute::write (location_p,"STOKES_COMPONENTS",          vectString );
 	HDF5Attribute::write (location_p,"COMPLEX_VOLTAGE",            valBool    );
 	HDF5Attribute::write (location_p,"SIGNAL_SUM",                 undefined  );
+	itsAttributeCache.invalidate();
       }
       
       // Open embedded groups ______________________________
@@ -270,7 +271,8 @@ namespace DAL { // Namespace DAL -- begin
       /* Dataset not yet opened */
       if (H5Lexists (location_p, name.c_str(), H5P_DEFAULT)) {
 	/* Dataset exists, but not yet has been opened */
-	itsStokesDatasets[name] = BF_StokesDataset (location_p, name);
+	BF_StokesDataset stokes (location_p, name);
+	itsStokesDatasets[name].swap (stokes);
       } else {
 	/* Dataset does not exist */
 	status = false;
@@ -382,12 +384,13 @@ namespace DAL { // Namespace DAL -- begin
       Create new Stokes dataset.
     */    
     
-    itsStokesDatasets[name] = BF_StokesDataset (location_p,
-						stokesID,
-						nofSamples,
-						nofChannels,
-						component,
-						datatype);
+    BF_StokesDataset stokes (location_p,
+			     stokesID,
+			     nofSamples,
+			     nofChannels,
+			     component,
+			     datatype);
+    itsStokesDatasets[name].swap (stokes);
     
     /*________________________________________________________________
       Check if creation of dataset was successful; is this was not the
@@ -417,7 +420,7 @@ namespace DAL { // Namespace DAL -- begin
       it = itsStokesDatasets.find(name);
 
       if (it != itsStokesDatasets.end()) {
-	return BF_StokesDataset(it->second);
+	return it->second;
       } else {
 	std::cerr << "[BF_BeamGroup::getStokesDataset] No such dataset "
 		  << "\"" << name << "\""
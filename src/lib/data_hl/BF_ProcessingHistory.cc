@@ -170,6 +170,7 @@ namespace DAL { // Namespace DAL -- begin
 	  HDF5Attribute::write (location_p, "PARSET_OBS", false);
 	  HDF5Attribute::write (location_p, "LOG_PRESTO", false);
 	  HDF5Attribute::write (location_p, "PARFILE",    false);
+	  itsAttributeCache.invalidate();
 	} else {
 	  std::cerr << "[BF_ProcessingHistory::open] Failed to create group "
 		    << name
@@ -35,7 +35,8 @@ namespace DAL { // Namespace DAL -- begin
     \param filename -- Name of the dataset to open.
   */
   BF_RootGroup::BF_RootGroup (std::string const &filename)
-    : HDF5GroupBase()
+    : HDF5GroupBase(),
+      itsWriteIndex (false)
   {
     if (!open (0,filename,IO_Mode(itsFlags))) {
       std::cerr << "[BF_RootGroup::BF_RootGroup] Failed to open file "
@@ -54,7 +55,8 @@ namespace DAL { // Namespace DAL -- begin
   */
   BF_RootGroup::BF_RootGroup (DAL::Filename &infile,
 			      IO_Mode const &flags)
-    : HDF5GroupBase(flags)
+    : HDF5GroupBase(flags),
+      itsWriteIndex (false)
   {
     if (!open (0,infile.filename(),itsFlags)) {
       std::cerr << "[BF_RootGroup::BF_RootGroup] Failed to open file "
@@ -73,7 +75,8 @@ namespace DAL { // Namespace DAL -- begin
   */
   BF_RootGroup::BF_RootGroup (CommonAttributes const &attributes,
 			      IO_Mode const &flags)
-    : HDF5GroupBase(flags)
+    : HDF5GroupBase(flags),
+      itsWriteIndex (false)
   {
     if (!open (0,attributes.filename(),itsFlags)) {
       std::cerr << "[BF_RootGroup::BF_RootGroup] Failed to open file "
@@ -82,6 +85,31 @@ namespace DAL { // Namespace DAL -- begin
     }
   }
   
+  //_____________________________________________________________________________
+  //                                                                 BF_RootGroup
+  
+  /*!
+    \param filename -- Filename object from which the actual file name of the
+           dataset is derived.
+    \param options  -- Tuning parameters for the access to the file, e.g. the
+           size of the chunk cache used for the Stokes datasets.
+    \param flags    -- I/O mode flags.
+  */
+  BF_RootGroup::BF_RootGroup (DAL::Filename &infile,
+			      HDF5AccessOptions const &options,
+			      IO_Mode const &flags)
+    : HDF5GroupBase(flags),
+      itsWriteIndex (false)
+  {
+    itsAccessOptions = options;
+
+    if (!open (0,infile.filename(),itsFlags)) {
+      std::cerr << "[BF_RootGroup::BF_RootGroup] Failed to open file "
+		<< infile.filename()
+		<< std::endl;
+    }
+  }
+  
   // ============================================================================
   //
   //  Destruction
@@ -100,6 +128,10 @@ namespace DAL { // Namespace DAL -- begin
       if (object_type == H5I_FILE) {
 	h5error = H5Fclose(location_p);
 	location_p = 0;
+	// the file is closed now, so its size and time stamp are final
+	if (itsWriteIndex) {
+	  HDF5FileIndex::update (itsFilename);
+	}
       }
     }
   }
@@ -248,15 +280,21 @@ namespace DAL { // Namespace DAL -- begin
     itsSubarrayPointings.clear();
     itsSystemLog.clear();
 
+    // Check for a table of contents, before the file is modified
+
+    itsFileIndex.read (name);
+
     // Open or create file _________________________________
 
     bool fileTruncated = HDF5Object::openFile (location_p,
 					       name,
-					       itsFlags);
+					       itsFlags,
+					       itsAccessOptions);
 
     // Set attributes ______________________________________
     
     if (fileTruncated) {
+      itsFileIndex.clear();
       itsCommonAttributes.h5write(location_p);
       /* Write the additional attributes attached to the root group */
       bool valBool          = true;
@@ -283,6 +321,7 @@ namespace DAL { // Namespace DAL -- begin
       HDF5Attribute::write (location_p,"WEATHER_HUMIDITY",          vectD      );
       HDF5Attribute::write (location_p,"SYSTEM_TEMPERATURE",        vectD      );
       HDF5Attribute::write (location_p,"NOF_PRIMARY_BEAMS",         int(0)     );
+      itsAttributeCache.invalidate();
     }
 
     // Read common atributes _______________________________
@@ -310,10 +349,15 @@ namespace DAL { // Namespace DAL -- begin
       std::set<std::string> groups;
       std::set<std::string>::iterator it;
 
-      /* Retrieve the names of the groups attached to the root group */
-      status = h5get_names (groups,
-			    location_p,
-			    H5G_GROUP);
+      /* Retrieve the names of the groups attached to the root group, from
+	 the table of contents if available */
+      if (itsFileIndex.isValid()) {
+	groups = itsFileIndex.names ("/", H5G_GROUP);
+      } else {
+	status = h5get_names (groups,
+			      location_p,
+			      H5G_GROUP);
+      }
       
       /* Open system log group ... */
       status = openSysLog ();
@@ -370,9 +414,8 @@ namespace DAL { // Namespace DAL -- begin
 							flags);
       // internal book-keeping
       int nofPrimaryBeams = itsSubarrayPointings.size();
-      HDF5Attribute::write (location_p,
-			    "NOF_PRIMARY_BEAMS",
-			    nofPrimaryBeams);
+      setAttribute ("NOF_PRIMARY_BEAMS",
+		    nofPrimaryBeams);
     }
 
     return status;
@@ -398,9 +441,8 @@ namespace DAL { // Namespace DAL -- begin
 							name);
       // internal book-keeping
       int nofPrimaryBeams = itsSubarrayPointings.size();
-      HDF5Attribute::write (location_p,
-			    "NOF_PRIMARY_BEAMS",
-			    nofPrimaryBeams);
+      setAttribute ("NOF_PRIMARY_BEAMS",
+		    nofPrimaryBeams);
     }
 
     return status;
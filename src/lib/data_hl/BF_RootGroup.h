@@ -26,6 +26,7 @@
 #include <string>
 
 // DAL header files
+#include <core/HDF5FileIndex.h>
 #include <data_common/HDF5GroupBase.h>
 #include <data_common/Filename.h>
 #include <data_hl/BF_SubArrayPointing.h>
@@ -172,6 +173,12 @@ namespace DAL { // Namespace DAL -- begin
     std::map<std::string,BF_SubArrayPointing> itsSubarrayPointings;
     //! Container for system-wide logs
     std::map<std::string,SysLog> itsSystemLog;
+    //! Tuning parameters for the access to the file
+    HDF5AccessOptions itsAccessOptions;
+    //! Write the table of contents of the file when it is closed?
+    bool itsWriteIndex;
+    //! Table of contents of the file, if an up-to-date one was found
+    HDF5FileIndex itsFileIndex;
 
   public:
     
@@ -188,6 +195,11 @@ namespace DAL { // Namespace DAL -- begin
     BF_RootGroup (CommonAttributes const &attributes,
 		  IO_Mode const &flags=IO_Mode(IO_Mode::OpenOrCreate));
     
+    //! Argumented constructor, with tuning parameters for the file access
+    BF_RootGroup (DAL::Filename &infile,
+		  HDF5AccessOptions const &options,
+		  IO_Mode const &flags=IO_Mode(IO_Mode::OpenOrCreate));
+    
     // === Destruction ==========================================================
     
     //! Default destructor
@@ -201,6 +213,28 @@ namespace DAL { // Namespace DAL -- begin
     //! Set the set of common attributes attached to the root group of the file
     bool setCommonAttributes (CommonAttributes const &attributes);
 
+    //! Get the tuning parameters for the access to the file
+    inline HDF5AccessOptions accessOptions () const {
+      return itsAccessOptions;
+    }
+
+    //! Is the table of contents of the file written when it is closed?
+    inline bool writeIndex () const {
+      return itsWriteIndex;
+    }
+
+    /*!
+      \brief Write the table of contents of the file when it is closed
+
+      \param doit -- Write a DAL::HDF5FileIndex to the sidecar of the file,
+             once the file has been closed; opening the file afterwards then
+             takes the sub-array pointing groups from the index, instead of
+             iterating over the links of the root group.
+    */
+    inline void setWriteIndex (bool const &doit=true) {
+      itsWriteIndex = doit;
+    }
+
     /*!
       \brief Get the name of the class
       
@@ -136,6 +136,81 @@ namespace DAL { // Namespace DAL -- begin
   //_____________________________________________________________________________
   //                                                             BF_StokesDataset
   
+  /*!
+    \param location    -- Identifier for the location at which the dataset is
+           about to be created.
+    \param index       -- Index of the dataset.
+    \param nofSamples  -- Number of bins along the time axis.
+    \param nofSubbands -- Number of sub-bands.
+    \param nofChannels -- Number of channels within the subbands.
+    \param filters     -- Filters applied to the chunks of the dataset.
+    \param component   -- Stokes component stored within the dataset
+    \param datatype    -- Datatype for the elements within the Dataset
+  */
+  BF_StokesDataset::BF_StokesDataset (hid_t const &location,
+				      unsigned int const &index,
+				      unsigned int const &nofSamples,
+				      unsigned int const &nofSubbands,
+				      unsigned int const &nofChannels,
+				      HDF5FilterPipeline const &filters,
+				      DAL::Stokes::Component const &component,
+				      hid_t const &datatype,
+				      IO_Mode const &flags)
+  {
+    itsName     = getName(index);
+    itsDatatype = datatype;
+    itsFilters  = filters;
+
+    open (location,
+	  component,
+	  nofSamples,
+	  nofSubbands,
+	  nofChannels,
+	  flags);
+  }
+  
+  //_____________________________________________________________________________
+  //                                                             BF_StokesDataset
+  
+  /*!
+    \param location    -- Identifier for the location at which the dataset is
+           about to be created.
+    \param index       -- Index of the dataset.
+    \param nofSamples  -- Number of bins along the time axis.
+    \param nofSubbands -- Number of sub-bands.
+    \param nofChannels -- Number of channels within the subbands.
+    \param filters     -- Filters applied to the chunks of the dataset.
+    \param planner     -- Planner for the shape of the chunks of the dataset.
+    \param component   -- Stokes component stored within the dataset
+    \param datatype    -- Datatype for the elements within the Dataset
+  */
+  BF_StokesDataset::BF_StokesDataset (hid_t const &location,
+				      unsigned int const &index,
+				      unsigned int const &nofSamples,
+				      unsigned int const &nofSubbands,
+				      unsigned int const &nofChannels,
+				      HDF5FilterPipeline const &filters,
+				      HDF5ChunkPlanner const &planner,
+				      DAL::Stokes::Component const &component,
+				      hid_t const &datatype,
+				      IO_Mode const &flags)
+  {
+    itsName         = getName(index);
+    itsDatatype     = datatype;
+    itsFilters      = filters;
+    itsChunkPlanner = planner;
+
+    open (location,
+	  component,
+	  nofSamples,
+	  nofSubbands,
+	  nofChannels,
+	  flags);
+  }
+  
+  //_____________________________________________________________________________
+  //                                                             BF_StokesDataset
+  
   /*!
     \param location    -- Identifier for the location at which the dataset is
            about to be created.
@@ -196,6 +271,39 @@ namespace DAL { // Namespace DAL -- begin
   //_____________________________________________________________________________
   //                                                             BF_StokesDataset
   
+  /*!
+    \param location    -- Identifier for the location at which the dataset is
+           about to be created.
+    \param index       -- Index of the dataset.
+    \param shape       -- [nofSamples,nofChannels] Shape of the dataset.
+    \param filters     -- Filters applied to the chunks of the dataset.
+    \param component   -- Stokes component stored within the dataset
+    \param datatype    -- Datatype for the elements within the Dataset
+  */
+  BF_StokesDataset::BF_StokesDataset (hid_t const &location,
+				      unsigned int const &index,
+				      std::vector<hsize_t> const &shape,
+				      HDF5FilterPipeline const &filters,
+				      DAL::Stokes::Component const &component,
+				      hid_t const &datatype,
+				      IO_Mode const &flags)
+  {
+    itsName     = getName(index);
+    itsDatatype = datatype;
+    itsFilters  = filters;
+
+    std::vector<unsigned int> nofChannels (1, shape[1]);
+
+    open (location,
+	  component,
+	  shape[0],
+	  nofChannels,
+	  flags);
+  }
+  
+  //_____________________________________________________________________________
+  //                                                             BF_StokesDataset
+  
   /*!
     \param other -- Another HDF5Property object from which to create this new
            one.
@@ -203,13 +311,7 @@ namespace DAL { // Namespace DAL -- begin
   BF_StokesDataset::BF_StokesDataset (BF_StokesDataset const &other)
     : HDF5DatasetBase (other)
   {
-    *this = other;
-
-    itsNofChannels.clear();
-    itsNofChannels = other.itsNofChannels;
-
-    itsAttributes.clear();
-    itsAttributes = other.itsAttributes;
+    copy (other);
   }
   
   // ============================================================================
@@ -244,12 +346,43 @@ namespace DAL { // Namespace DAL -- begin
   {
     if (this != &other) {
       destroy ();
-      /* Copy internal parameters */
-      itsStokesComponent = other.itsStokesComponent;
+      HDF5DatasetBase::operator= (other);
+      copy (other);
     }
     return *this;
   }
   
+  //_____________________________________________________________________________
+  //                                                                         copy
+  
+  /*!
+    \param other -- Another BF_StokesDataset object from which to make a copy.
+  */
+  void BF_StokesDataset::copy (BF_StokesDataset const &other)
+  {
+    itsAttributes      = other.itsAttributes;
+    itsStokesComponent = other.itsStokesComponent;
+    itsNofChannels     = other.itsNofChannels;
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                         swap
+  
+  /*!
+    \param other -- Another BF_StokesDataset object with which to exchange
+           contents.
+
+    Used to hand over a newly opened dataset to the map kept by BF_BeamGroup,
+    without duplicating its identifiers and buffers.
+  */
+  void BF_StokesDataset::swap (BF_StokesDataset &other)
+  {
+    HDF5DatasetBase::swap (other);
+    itsAttributes.swap (other.itsAttributes);
+    std::swap (itsStokesComponent, other.itsStokesComponent);
+    itsNofChannels.swap (other.itsNofChannels);
+  }
+  
   // ============================================================================
   //
   //  Parameter access
@@ -351,12 +484,12 @@ namespace DAL { // Namespace DAL -- begin
       std::vector<unsigned int> channels;
 
       // Get the Stokes component
-      if ( HDF5Attribute::read (itsLocation, "STOKES_COMPONENT", stokesComponent) ) {
+      if ( readAttribute ("STOKES_COMPONENT", stokesComponent) ) {
 	itsStokesComponent.setType(stokesComponent);
       }
 
       // Get number of channels and number of sub-bands
-      if ( HDF5Attribute::read (itsLocation, "NOF_CHANNELS", channels) ) {
+      if ( readAttribute ("NOF_CHANNELS", channels) ) {
 	itsNofChannels = channels;
       }
       
@@ -478,6 +611,14 @@ namespace DAL { // Namespace DAL -- begin
       }
     }
 
+    /* Chunks extend along the time axis, so that the time series of a single
+       channel is read from a small number of chunks */
+    if (itsChunkPlanner.pattern() == HDF5ChunkPlanner::Automatic) {
+      itsChunkPlanner = HDF5ChunkPlanner (HDF5ChunkPlanner::TimeSeries,
+					  HDF5ChunkPlanner::defaultTargetBytes,
+					  0);
+    }
+
     /* Open/create dataset */
     status = HDF5DatasetBase::open (location,
 				    itsName,
@@ -503,12 +644,12 @@ namespace DAL { // Namespace DAL -- begin
       std::cout << "-- NOF_CHANNELS     = " << channels        << std::endl;
 #endif
       
-      HDF5Attribute::write (itsLocation, "GROUPTYPE",        grouptype       );
-      HDF5Attribute::write (itsLocation, "DATATYPE",         datatype        );
-      HDF5Attribute::write (itsLocation, "STOKES_COMPONENT", stokesComponent );
-      HDF5Attribute::write (itsLocation, "NOF_SAMPLES",      itsShape[0]     );
-      HDF5Attribute::write (itsLocation, "NOF_SUBBANDS",     subbands        );
-      HDF5Attribute::write (itsLocation, "NOF_CHANNELS",     channels        );
+      writeAttribute ("GROUPTYPE",        grouptype       );
+      writeAttribute ("DATATYPE",         datatype        );
+      writeAttribute ("STOKES_COMPONENT", stokesComponent );
+      writeAttribute ("NOF_SAMPLES",      itsShape[0]     );
+      writeAttribute ("NOF_SUBBANDS",     subbands        );
+      writeAttribute ("NOF_CHANNELS",     channels        );
     }
 
     return status;
@@ -180,8 +180,39 @@ namespace DAL { // Namespace DAL -- begin
       </tr>
     </table>
     </center>
+
+    Unless a different planner is set (see HDF5ChunkPlanner), the chunks of a
+    new dataset extend along the time axis -- the axis along which the dataset
+    grows -- up to the target chunk size, such that the time series of a
+    channel is read from a few chunks rather than from one chunk per sample.
     
     <h3>Example(s)</h3>
+
+    <ol>
+      <li>Create a Stokes dataset, of which the chunks are passed through
+      shuffle and LZ4 compression before being written:
+      \code
+      DAL::HDF5FilterPipeline filters (DAL::HDF5FilterPipeline::LZ4);
+
+      DAL::BF_StokesDataset stokes (groupID,
+                                    0,
+                                    shape,
+                                    filters,
+                                    DAL::Stokes::I);
+      \endcode
+
+      <li>Create a Stokes dataset with one chunk per block of samples written,
+      e.g. to hand complete chunks to a DAL::HDF5ChunkWriter:
+      \code
+      DAL::BF_StokesDataset stokes (groupID,
+                                    0,
+                                    blockSize,
+                                    nofSubbands,
+                                    nofChannels,
+                                    filters,
+                                    DAL::HDF5ChunkPlanner (DAL::HDF5ChunkPlanner::Extent));
+      \endcode
+    </ol>
     
   */  
   class BF_StokesDataset : public HDF5DatasetBase {
@@ -229,6 +260,29 @@ namespace DAL { // Namespace DAL -- begin
 		      hid_t const &datatype=H5T_NATIVE_FLOAT,
 		      IO_Mode const &flags=IO_Mode(IO_Mode::CreateNew));
     
+    //! Argumented constructor, creating a new Stokes dataset with filters
+    BF_StokesDataset (hid_t const &location,
+		      unsigned int const &index,
+		      unsigned int const &nofSamples,
+		      unsigned int const &nofSubbands,
+		      unsigned int const &nofChannels,
+		      HDF5FilterPipeline const &filters,
+		      DAL::Stokes::Component const &component=DAL::Stokes::I,
+		      hid_t const &datatype=H5T_NATIVE_FLOAT,
+		      IO_Mode const &flags=IO_Mode(IO_Mode::CreateNew));
+    
+    //! Argumented constructor, creating a new Stokes dataset with filters and chunk planner
+    BF_StokesDataset (hid_t const &location,
+		      unsigned int const &index,
+		      unsigned int const &nofSamples,
+		      unsigned int const &nofSubbands,
+		      unsigned int const &nofChannels,
+		      HDF5FilterPipeline const &filters,
+		      HDF5ChunkPlanner const &planner,
+		      DAL::Stokes::Component const &component=DAL::Stokes::I,
+		      hid_t const &datatype=H5T_NATIVE_FLOAT,
+		      IO_Mode const &flags=IO_Mode(IO_Mode::CreateNew));
+    
     //! Argumented constructor, creating a new Stokes dataset
     BF_StokesDataset (hid_t const &location,
 		      unsigned int const &index,
@@ -246,6 +300,15 @@ namespace DAL { // Namespace DAL -- begin
 		      hid_t const &datatype=H5T_NATIVE_FLOAT,
 		      IO_Mode const &flags=IO_Mode(IO_Mode::CreateNew));
     
+    //! Argumented constructor, creating a new Stokes dataset with filters
+    BF_StokesDataset (hid_t const &location,
+		      unsigned int const &index,
+		      std::vector<hsize_t> const &shape,
+		      HDF5FilterPipeline const &filters,
+		      DAL::Stokes::Component const &component=DAL::Stokes::I,
+		      hid_t const &datatype=H5T_NATIVE_FLOAT,
+		      IO_Mode const &flags=IO_Mode(IO_Mode::CreateNew));
+    
     //! Argumented constructor, creating a new Stokes dataset
     BF_StokesDataset (hid_t const &location,
 		      std::vector<hsize_t> const &shape,
@@ -264,6 +327,9 @@ namespace DAL { // Namespace DAL -- begin
     
     //! Overloading of the copy operator
     BF_StokesDataset& operator= (BF_StokesDataset const &other); 
+
+    //! Exchange the contents with another object, without copying
+    void swap (BF_StokesDataset &other);
     
     // === Parameter access =====================================================
 
@@ -395,6 +461,9 @@ namespace DAL { // Namespace DAL -- begin
       }
     }
     
+    //! Unconditional copying
+    void copy (BF_StokesDataset const &other);
+    
     //! Unconditional deletion 
     void destroy(void);
     
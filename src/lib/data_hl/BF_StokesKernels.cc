@@ -0,0 +1,490 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <data_hl/BF_StokesKernels.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* The AVX2 kernels are compiled through a function target attribute, which
+   requires GCC 4.9 or a compatible compiler */
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__)) && \
+  (defined(__clang__) || (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define DAL_WITH_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*
+    Each kernel reduces a window of samples: the intensity kernels to one sum,
+    the Stokes kernels to the four sums I, Q, U and V. The vector kernels
+    leave the samples which do not fill a vector to the scalar kernel. The
+    compiler does not insert vzeroupper into functions compiled for AVX2
+    through the target attribute only, so the AVX2 kernels clear the upper
+    register halves themselves; otherwise every transition to the (SSE)
+    scalar code is heavily penalized.
+  */
+
+  //! Kernel reducing a window of samples to the total intensity
+  typedef void (*IntensityKernel) (BFRawFormat::Sample const *input,
+				   unsigned int nofSamples,
+				   float *sums);
+
+  //! Kernel reducing a window of samples to the Stokes parameters
+  typedef void (*StokesKernel) (BFRawFormat::Sample const *input,
+				unsigned int nofSamples,
+				float *sums);
+
+  //! Kernel currently used; negative if not yet selected
+  static int currentKernel = -1;
+
+  // ============================================================================
+  //
+  //  Scalar kernels
+  //
+  // ============================================================================
+
+  //! Total intensity of a window of samples, plain C++
+  static void intensityScalar (BFRawFormat::Sample const *input,
+			       unsigned int nofSamples,
+			       float *sums)
+  {
+    float sum (0);
+    float xr, xi, yr, yi;
+
+    for (unsigned int n=0; n<nofSamples; ++n) {
+      xr = real(input[n].xx);
+      xi = imag(input[n].xx);
+      yr = real(input[n].yy);
+      yi = imag(input[n].yy);
+      sum += xr*xr + xi*xi + yr*yr + yi*yi;
+    }
+
+    sums[0] += sum;
+  }
+
+  //! Stokes parameters of a window of samples, plain C++
+  static void stokesScalar (BFRawFormat::Sample const *input,
+			    unsigned int nofSamples,
+			    float *sums)
+  {
+    float xr, xi, yr, yi, xx, yy;
+
+    for (unsigned int n=0; n<nofSamples; ++n) {
+      xr = real(input[n].xx);
+      xi = imag(input[n].xx);
+      yr = real(input[n].yy);
+      yi = imag(input[n].yy);
+      xx = xr*xr + xi*xi;
+      yy = yr*yr + yi*yi;
+      sums[0] += xx + yy;
+      sums[1] += xx - yy;
+      sums[2] += 2*(xr*yr + xi*yi);
+      sums[3] += 2*(xi*yr - xr*yi);
+    }
+  }
+
+  // ============================================================================
+  //
+  //  SSE2 kernels
+  //
+  // ============================================================================
+
+#ifdef __SSE2__
+
+  //! Sum of the four elements of a vector
+  static inline float horizontalSum (__m128 v)
+  {
+    float tmp[4];
+    _mm_storeu_ps (tmp, v);
+    return (tmp[0]+tmp[1]) + (tmp[2]+tmp[3]);
+  }
+
+  //! Convert the low four 16-bit integers of a vector to floats
+  static inline __m128 lowToFloat (__m128i v)
+  {
+    return _mm_cvtepi32_ps (_mm_srai_epi32 (_mm_unpacklo_epi16(v,v), 16));
+  }
+
+  //! Convert the high four 16-bit integers of a vector to floats
+  static inline __m128 highToFloat (__m128i v)
+  {
+    return _mm_cvtepi32_ps (_mm_srai_epi32 (_mm_unpackhi_epi16(v,v), 16));
+  }
+
+  //! Total intensity of a window of samples, two samples per step
+  static void intensitySSE2 (BFRawFormat::Sample const *input,
+			     unsigned int nofSamples,
+			     float *sums)
+  {
+    unsigned int n (0);
+    __m128 acc = _mm_setzero_ps();
+    __m128 lo, hi;
+
+    for (; n+2<=nofSamples; n+=2) {
+      __m128i v = _mm_loadu_si128 (reinterpret_cast<__m128i const*>(input+n));
+      lo  = lowToFloat (v);
+      hi  = highToFloat (v);
+      acc = _mm_add_ps (acc, _mm_add_ps (_mm_mul_ps(lo,lo), _mm_mul_ps(hi,hi)));
+    }
+
+    sums[0] += horizontalSum (acc);
+    intensityScalar (input+n, nofSamples-n, sums);
+  }
+
+  //! Stokes parameters of a window of samples, four samples per step
+  static void stokesSSE2 (BFRawFormat::Sample const *input,
+			  unsigned int nofSamples,
+			  float *sums)
+  {
+    unsigned int n (0);
+    __m128 accI = _mm_setzero_ps();
+    __m128 accQ = _mm_setzero_ps();
+    __m128 accU = _mm_setzero_ps();
+    __m128 accV = _mm_setzero_ps();
+    __m128 xr, xi, yr, yi, xx, yy;
+
+    for (; n+4<=nofSamples; n+=4) {
+      __m128i a = _mm_loadu_si128 (reinterpret_cast<__m128i const*>(input+n));
+      __m128i b = _mm_loadu_si128 (reinterpret_cast<__m128i const*>(input+n+2));
+      /* Transpose to [xr0..xr3, xi0..xi3] and [yr0..yr3, yi0..yi3] */
+      __m128i t0 = _mm_unpacklo_epi16 (a, b);
+      __m128i t1 = _mm_unpackhi_epi16 (a, b);
+      __m128i x  = _mm_unpacklo_epi16 (t0, t1);
+      __m128i y  = _mm_unpackhi_epi16 (t0, t1);
+      xr = lowToFloat (x);
+      xi = highToFloat (x);
+      yr = lowToFloat (y);
+      yi = highToFloat (y);
+      xx = _mm_add_ps (_mm_mul_ps(xr,xr), _mm_mul_ps(xi,xi));
+      yy = _mm_add_ps (_mm_mul_ps(yr,yr), _mm_mul_ps(yi,yi));
+      accI = _mm_add_ps (accI, _mm_add_ps(xx,yy));
+      accQ = _mm_add_ps (accQ, _mm_sub_ps(xx,yy));
+      accU = _mm_add_ps (accU, _mm_add_ps(_mm_mul_ps(xr,yr), _mm_mul_ps(xi,yi)));
+      accV = _mm_add_ps (accV, _mm_sub_ps(_mm_mul_ps(xi,yr), _mm_mul_ps(xr,yi)));
+    }
+
+    sums[0] += horizontalSum (accI);
+    sums[1] += horizontalSum (accQ);
+    sums[2] += 2*horizontalSum (accU);
+    sums[3] += 2*horizontalSum (accV);
+    stokesScalar (input+n, nofSamples-n, sums);
+  }
+
+#endif
+
+  // ============================================================================
+  //
+  //  AVX2 kernels
+  //
+  // ============================================================================
+
+#ifdef DAL_WITH_AVX2_KERNELS
+
+  //! Sum of the eight elements of a vector
+  __attribute__((target("avx2")))
+  static inline float horizontalSum256 (__m256 v)
+  {
+    return horizontalSum (_mm_add_ps (_mm256_castps256_ps128(v),
+				      _mm256_extractf128_ps(v,1)));
+  }
+
+  //! Total intensity of a window of samples, four samples per step
+  __attribute__((target("avx2")))
+  static void intensityAVX2 (BFRawFormat::Sample const *input,
+			     unsigned int nofSamples,
+			     float *sums)
+  {
+    unsigned int n (0);
+    __m256 acc = _mm256_setzero_ps();
+    __m256 lo, hi;
+
+    for (; n+4<=nofSamples; n+=4) {
+      __m128i a = _mm_loadu_si128 (reinterpret_cast<__m128i const*>(input+n));
+      __m128i b = _mm_loadu_si128 (reinterpret_cast<__m128i const*>(input+n+2));
+      lo  = _mm256_cvtepi32_ps (_mm256_cvtepi16_epi32(a));
+      hi  = _mm256_cvtepi32_ps (_mm256_cvtepi16_epi32(b));
+      acc = _mm256_add_ps (acc, _mm256_add_ps (_mm256_mul_ps(lo,lo),
+					       _mm256_mul_ps(hi,hi)));
+    }
+
+    sums[0] += horizontalSum256 (acc);
+    _mm256_zeroupper ();
+    intensityScalar (input+n, nofSamples-n, sums);
+  }
+
+  //! Stokes parameters of a window of samples, eight samples per step
+  __attribute__((target("avx2")))
+  static void stokesAVX2 (BFRawFormat::Sample const *input,
+			  unsigned int nofSamples,
+			  float *sums)
+  {
+    unsigned int n (0);
+    __m256 accI = _mm256_setzero_ps();
+    __m256 accQ = _mm256_setzero_ps();
+    __m256 accU = _mm256_setzero_ps();
+    __m256 accV = _mm256_setzero_ps();
+    __m256 xr, xi, yr, yi, xx, yy;
+
+    for (; n+8<=nofSamples; n+=8) {
+      __m256i a = _mm256_loadu_si256 (reinterpret_cast<__m256i const*>(input+n));
+      __m256i b = _mm256_loadu_si256 (reinterpret_cast<__m256i const*>(input+n+4));
+      /* Same transpose as for SSE2, within each 128-bit lane */
+      __m256i t0 = _mm256_unpacklo_epi16 (a, b);
+      __m256i t1 = _mm256_unpackhi_epi16 (a, b);
+      __m256i x  = _mm256_unpacklo_epi16 (t0, t1);
+      __m256i y  = _mm256_unpackhi_epi16 (t0, t1);
+      xr = _mm256_cvtepi32_ps (_mm256_srai_epi32 (_mm256_unpacklo_epi16(x,x), 16));
+      xi = _mm256_cvtepi32_ps (_mm256_srai_epi32 (_mm256_unpackhi_epi16(x,x), 16));
+      yr = _mm256_cvtepi32_ps (_mm256_srai_epi32 (_mm256_unpacklo_epi16(y,y), 16));
+      yi = _mm256_cvtepi32_ps (_mm256_srai_epi32 (_mm256_unpackhi_epi16(y,y), 16));
+      xx = _mm256_add_ps (_mm256_mul_ps(xr,xr), _mm256_mul_ps(xi,xi));
+      yy = _mm256_add_ps (_mm256_mul_ps(yr,yr), _mm256_mul_ps(yi,yi));
+      accI = _mm256_add_ps (accI, _mm256_add_ps(xx,yy));
+      accQ = _mm256_add_ps (accQ, _mm256_sub_ps(xx,yy));
+      accU = _mm256_add_ps (accU, _mm256_add_ps(_mm256_mul_ps(xr,yr), _mm256_mul_ps(xi,yi)));
+      accV = _mm256_add_ps (accV, _mm256_sub_ps(_mm256_mul_ps(xi,yr), _mm256_mul_ps(xr,yi)));
+    }
+
+    sums[0] += horizontalSum256 (accI);
+    sums[1] += horizontalSum256 (accQ);
+    sums[2] += 2*horizontalSum256 (accU);
+    sums[3] += 2*horizontalSum256 (accV);
+    _mm256_zeroupper ();
+    stokesScalar (input+n, nofSamples-n, sums);
+  }
+
+#endif
+
+  // ============================================================================
+  //
+  //  Parameter access
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                  isSupported
+
+  bool BF_StokesKernels::isSupported (Kernel const &which)
+  {
+    switch (which) {
+    case Scalar:
+      return true;
+#ifdef __SSE2__
+    case SSE2:
+      return true;
+#endif
+#ifdef DAL_WITH_AVX2_KERNELS
+    case AVX2:
+      return __builtin_cpu_supports ("avx2");
+#endif
+    default:
+      return false;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   bestKernel
+
+  BF_StokesKernels::Kernel BF_StokesKernels::bestKernel ()
+  {
+    if (isSupported(AVX2)) {
+      return AVX2;
+    } else if (isSupported(SSE2)) {
+      return SSE2;
+    } else {
+      return Scalar;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       kernel
+
+  BF_StokesKernels::Kernel BF_StokesKernels::kernel ()
+  {
+    if (currentKernel < 0) {
+      currentKernel = bestKernel();
+    }
+    return Kernel(currentKernel);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    setKernel
+
+  /*!
+    \param which -- The kernel to use from now on.
+
+    \return status -- Returns \e false, leaving the selection unchanged, if the
+            kernel is not supported by this build or CPU.
+  */
+  bool BF_StokesKernels::setKernel (Kernel const &which)
+  {
+    if (!isSupported(which)) {
+      return false;
+    }
+    currentKernel = which;
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         name
+
+  std::string BF_StokesKernels::name (Kernel const &which)
+  {
+    switch (which) {
+    case SSE2:
+      return "SSE2";
+    case AVX2:
+      return "AVX2";
+    default:
+      return "Scalar";
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  void BF_StokesKernels::summary (std::ostream &os)
+  {
+    os << "[BF_StokesKernels] Summary of internal parameters" << std::endl;
+    os << "-- Kernel in use ........ : " << name(kernel())   << std::endl;
+    os << "-- Scalar supported ..... : " << isSupported(Scalar) << std::endl;
+    os << "-- SSE2 supported ....... : " << isSupported(SSE2)   << std::endl;
+    os << "-- AVX2 supported ....... : " << isSupported(AVX2)   << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                    intensity
+
+  /*!
+    \param input            -- Raw samples, <tt>nofOutputSamples*downsampleFactor</tt>
+           of them.
+    \retval output          -- Total intensity, summed over \e downsampleFactor
+           samples each.
+    \param nofOutputSamples -- Number of output samples.
+    \param downsampleFactor -- Number of input samples per output sample.
+  */
+  void BF_StokesKernels::intensity (BFRawFormat::Sample const *input,
+				    float *output,
+				    unsigned int const &nofOutputSamples,
+				    unsigned int const &downsampleFactor)
+  {
+    IntensityKernel window = intensityScalar;
+
+    switch (kernel()) {
+#ifdef __SSE2__
+    case SSE2:
+      window = intensitySSE2;
+      break;
+#endif
+#ifdef DAL_WITH_AVX2_KERNELS
+    case AVX2:
+      window = intensityAVX2;
+      break;
+#endif
+    default:
+      break;
+    }
+
+    for (unsigned int n=0; n<nofOutputSamples; ++n) {
+      output[n] = 0;
+      window (input+n*downsampleFactor, downsampleFactor, output+n);
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       stokes
+
+  /*!
+    \param input            -- Raw samples, <tt>nofOutputSamples*downsampleFactor</tt>
+           of them.
+    \retval stokesI         -- Stokes I, summed over \e downsampleFactor samples
+           each.
+    \retval stokesQ         -- Stokes Q
+    \retval stokesU         -- Stokes U
+    \retval stokesV         -- Stokes V
+    \param nofOutputSamples -- Number of output samples.
+    \param downsampleFactor -- Number of input samples per output sample.
+  */
+  void BF_StokesKernels::stokes (BFRawFormat::Sample const *input,
+				 float *stokesI,
+				 float *stokesQ,
+				 float *stokesU,
+				 float *stokesV,
+				 unsigned int const &nofOutputSamples,
+				 unsigned int const &downsampleFactor)
+  {
+    StokesKernel window = stokesScalar;
+    float sums[4];
+
+    switch (kernel()) {
+#ifdef __SSE2__
+    case SSE2:
+      window = stokesSSE2;
+      break;
+#endif
+#ifdef DAL_WITH_AVX2_KERNELS
+    case AVX2:
+      window = stokesAVX2;
+      break;
+#endif
+    default:
+      break;
+    }
+
+    for (unsigned int n=0; n<nofOutputSamples; ++n) {
+      sums[0] = sums[1] = sums[2] = sums[3] = 0;
+      window (input+n*downsampleFactor, downsampleFactor, sums);
+      stokesI[n] = sums[0];
+      stokesQ[n] = sums[1];
+      stokesU[n] = sums[2];
+      stokesV[n] = sums[3];
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     voltages
+
+  /*!
+    \param input      -- Raw samples.
+    \retval voltagesX -- Complex voltages of the X polarization.
+    \retval voltagesY -- Complex voltages of the Y polarization.
+    \param nofSamples -- Number of samples to convert.
+  */
+  void BF_StokesKernels::voltages (BFRawFormat::Sample const *input,
+				   std::complex<float> *voltagesX,
+				   std::complex<float> *voltagesY,
+				   unsigned int const &nofSamples)
+  {
+    for (unsigned int n=0; n<nofSamples; ++n) {
+      voltagesX[n] = std::complex<float> (input[n].xx.real(), input[n].xx.imag());
+      voltagesY[n] = std::complex<float> (input[n].yy.real(), input[n].yy.imag());
+    }
+  }
+
+} // Namespace DAL -- end
@@ -0,0 +1,161 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef BF_STOKESKERNELS_H
+#define BF_STOKESKERNELS_H
+
+// Standard library header files
+#include <complex>
+#include <iostream>
+#include <string>
+
+// DAL header files
+#include <data_hl/BFRawFormat.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class BF_StokesKernels
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Compute downsampled Stokes parameters from raw beam-formed samples
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tBF_StokesKernels.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>BFRawFormat::Sample
+      <li>DAL::BF_StokesDataset
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    For the two polarizations \f$ X \f$ and \f$ Y \f$ of a beam-formed sample
+    the Stokes parameters are
+    \f[
+      I = |X|^2 + |Y|^2 , \quad
+      Q = |X|^2 - |Y|^2 , \quad
+      U = 2\, \mathrm{Re}(X Y^{*}) , \quad
+      V = 2\, \mathrm{Im}(X Y^{*}) ,
+    \f]
+    each of which is summed over \e downsampleFactor consecutive samples to
+    give one output sample.
+
+    The computation is done by one of several kernels, working on the
+    interleaved <tt>complex<int16_t></tt> layout of BFRawFormat::Sample:
+
+    <ul>
+      <li>\e Scalar -- plain C++, available everywhere;
+      <li>\e SSE2 -- four samples per step; part of every x86-64 CPU;
+      <li>\e AVX2 -- eight samples per step; compiled in with a function
+      target attribute, so no special compiler flags are needed, and only used
+      if the CPU supports it.
+    </ul>
+
+    The best kernel supported by the CPU is selected at run-time; setKernel()
+    allows forcing a specific one (e.g. for testing). All kernels do the
+    arithmetic in single precision, so their results only differ by the
+    rounding caused by a different order of the summation.
+
+    <h3>Example(s)</h3>
+
+    \code
+    float *intensity = new float [nofSamples/downsampleFactor];
+
+    DAL::BF_StokesKernels::intensity (samples,
+                                      intensity,
+                                      nofSamples/downsampleFactor,
+                                      downsampleFactor);
+    \endcode
+  */
+  class BF_StokesKernels {
+
+  public:
+
+    //! Implementations of the kernels
+    enum Kernel {
+      //! Plain C++ implementation
+      Scalar,
+      //! SSE2 implementation, four samples per step
+      SSE2,
+      //! AVX2 implementation, eight samples per step
+      AVX2
+    };
+
+    // === Parameter access =====================================================
+
+    //! Get the kernel currently used
+    static Kernel kernel ();
+
+    //! Force the use of a kernel; returns \e false if it is not supported
+    static bool setKernel (Kernel const &which);
+
+    //! Is a kernel supported by this build and CPU?
+    static bool isSupported (Kernel const &which);
+
+    //! Get the fastest kernel supported by this build and CPU
+    static Kernel bestKernel ();
+
+    //! Get the name of a kernel
+    static std::string name (Kernel const &which);
+
+    //! Provide a summary of the kernels
+    static inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the kernels
+    static void summary (std::ostream &os);
+
+    // === Methods ==============================================================
+
+    //! Compute the downsampled total intensity (Stokes I)
+    static void intensity (BFRawFormat::Sample const *input,
+			   float *output,
+			   unsigned int const &nofOutputSamples,
+			   unsigned int const &downsampleFactor);
+
+    //! Compute the downsampled Stokes parameters I, Q, U and V
+    static void stokes (BFRawFormat::Sample const *input,
+			float *stokesI,
+			float *stokesQ,
+			float *stokesU,
+			float *stokesV,
+			unsigned int const &nofOutputSamples,
+			unsigned int const &downsampleFactor);
+
+    //! Convert the raw samples to single precision complex voltages X and Y
+    static void voltages (BFRawFormat::Sample const *input,
+			  std::complex<float> *voltagesX,
+			  std::complex<float> *voltagesY,
+			  unsigned int const &nofSamples);
+
+  }; // Class BF_StokesKernels -- end
+
+} // Namespace DAL -- end
+
+#endif /* BF_STOKESKERNELS_H */
@@ -209,6 +209,7 @@ namespace DAL { // Namespace DAL -- begin
 	HDF5Attribute::write (location_p,"CHANNEL_WIDTH",              valDouble );
 	HDF5Attribute::write (location_p,"CHANNEL_WIDTH_UNIT",         mhz       );
 	HDF5Attribute::write (location_p,"NOF_BEAMS",                  int(0)    );
+	itsAttributeCache.invalidate();
       }
 
       // Open embedded groups ______________________________
@@ -274,9 +275,8 @@ namespace DAL { // Namespace DAL -- begin
 				     flags);
       // internal book-keeping
       int nofBeams = itsBeams.size();
-      HDF5Attribute::write (location_p,
-			    "NOF_BEAMS",
-			    nofBeams);
+      setAttribute ("NOF_BEAMS",
+		    nofBeams);
     }
 
     return status;
@@ -0,0 +1,441 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <data_hl/BF_TaskPool.h>
+#include <sched.h>
+#include <unistd.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  /*!
+    \param nofThreads       -- Number of worker threads; if zero, one thread
+           per processor is used.
+    \param maxTasksPerBlock -- Maximum number of tasks a block can consist of.
+    \param function         -- Function processing a task.
+    \param context          -- Pointer handed to the task function.
+  */
+  BF_TaskPool::BF_TaskPool (unsigned int const &nofThreads,
+			    unsigned int const &maxTasksPerBlock,
+			    Function function,
+			    void *context)
+    : itsNofThreads (nofThreads > 0 ? nofThreads : nofProcessors()),
+      itsMaxTasks (maxTasksPerBlock > 0 ? maxTasksPerBlock : 1),
+      itsFunction (function),
+      itsContext (context),
+      itsBlocksSubmitted (0),
+      itsBlocksClaimed (0),
+      itsTasksSubmitted (0),
+      itsTasksCompleted (0),
+      itsRunning (false),
+      itsStop (false)
+  {
+    /* A worker only claims a block if its deque is empty, so the capacity of
+       a deque needs to hold a single block. */
+    long capacity = 1;
+    while (capacity < (long)itsMaxTasks) {
+      capacity <<= 1;
+    }
+
+    itsWorkers.resize (itsNofThreads);
+
+    for (unsigned int n=0; n<itsNofThreads; ++n) {
+      Deque *deque  = new Deque;
+      deque->tasks.resize (capacity);
+      deque->mask   = capacity-1;
+      deque->top    = 0;
+      deque->bottom = 0;
+      itsDeques.push_back (deque);
+
+      itsWorkers[n].pool      = this;
+      itsWorkers[n].index     = n;
+      itsWorkers[n].nofTasks  = 0;
+      itsWorkers[n].nofStolen = 0;
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  BF_TaskPool::~BF_TaskPool ()
+  {
+    stop ();
+
+    for (unsigned int n=0; n<itsDeques.size(); ++n) {
+      delete itsDeques[n];
+    }
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                    nofStolen
+
+  unsigned long BF_TaskPool::nofStolen () const
+  {
+    unsigned long nofStolen = 0;
+
+    for (unsigned int n=0; n<itsWorkers.size(); ++n) {
+      nofStolen += itsWorkers[n].nofStolen;
+    }
+
+    return nofStolen;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void BF_TaskPool::summary (std::ostream &os)
+  {
+    os << "[BF_TaskPool] Summary of internal parameters." << std::endl;
+    os << "-- nof. threads           = " << itsNofThreads      << std::endl;
+    os << "-- Max. tasks per block   = " << itsMaxTasks        << std::endl;
+    os << "-- Running                = " << itsRunning         << std::endl;
+    os << "-- nof. blocks submitted  = " << itsBlocksSubmitted << std::endl;
+    os << "-- nof. tasks submitted   = " << itsTasksSubmitted  << std::endl;
+    os << "-- nof. tasks completed   = " << nofCompleted()     << std::endl;
+    os << "-- nof. tasks stolen      = " << nofStolen()        << std::endl;
+    os << "-- Tasks per thread       = [";
+    for (unsigned int n=0; n<itsWorkers.size(); ++n) {
+      os << " " << itsWorkers[n].nofTasks;
+    }
+    os << " ]" << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                        start
+
+  /*!
+    \return status -- Returns \e false if not all worker threads could be
+            started.
+  */
+  bool BF_TaskPool::start ()
+  {
+    if (itsRunning) {
+      return true;
+    }
+
+    itsStop    = false;
+    itsRunning = true;
+
+    for (unsigned int n=0; n<itsNofThreads; ++n) {
+      if (pthread_create (&itsWorkers[n].thread, NULL, run, &itsWorkers[n]) != 0) {
+	std::cerr << "[BF_TaskPool::start] Unable to start worker thread "
+		  << n << std::endl;
+	itsNofThreads = n;
+	break;
+      }
+    }
+
+    return itsNofThreads == itsWorkers.size();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       submit
+
+  /*!
+    Must only be called from a single thread.
+
+    \param blockNr  -- Number of the block.
+    \param nofTasks -- Number of tasks the block consists of; the tasks are
+           numbered \f$ 0 \dots N_{\rm Tasks}-1 \f$.
+    \param data     -- Data attached to the block, handed to the task function.
+
+    \return status -- Returns \e false if the block contains more tasks than
+            the pool has been set up for.
+  */
+  bool BF_TaskPool::submit (long const &blockNr,
+			    unsigned int const &nofTasks,
+			    void *data)
+  {
+    if (nofTasks > itsMaxTasks) {
+      std::cerr << "[BF_TaskPool::submit] Block " << blockNr << " holds "
+		<< nofTasks << " tasks, more than " << itsMaxTasks << std::endl;
+      return false;
+    }
+    if (nofTasks == 0) {
+      return true;
+    }
+
+    /* Wait for the workers to make room in the ring */
+    while (itsBlocksSubmitted-itsBlocksClaimed >= BF_TASKPOOL_MAX_BLOCKS) {
+      sched_yield ();
+      __sync_synchronize();
+    }
+
+    Block &block   = itsBlocks[itsBlocksSubmitted % BF_TASKPOOL_MAX_BLOCKS];
+    block.blockNr  = blockNr;
+    block.nofTasks = nofTasks;
+    block.data     = data;
+
+    __sync_fetch_and_add (&itsTasksSubmitted, nofTasks);
+    /* Full barrier: the block must be visible before it is published */
+    __sync_fetch_and_add (&itsBlocksSubmitted, 1);
+
+    itsWorkSignal.notify ();
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     waitIdle
+
+  void BF_TaskPool::waitIdle ()
+  {
+    while (true) {
+      unsigned long sequence = itsDoneSignal.sequence();
+      if (nofPending() == 0) {
+	break;
+      }
+      itsDoneSignal.wait (sequence, 0.1);
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         stop
+
+  /*!
+    \return status -- Returns \e false if a worker thread could not be joined.
+  */
+  bool BF_TaskPool::stop ()
+  {
+    bool status = true;
+
+    if (!itsRunning) {
+      return status;
+    }
+
+    waitIdle ();
+
+    itsStop = true;
+    itsWorkSignal.notify ();
+
+    for (unsigned int n=0; n<itsNofThreads; ++n) {
+      if (pthread_join (itsWorkers[n].thread, NULL) != 0) {
+	status = false;
+      }
+    }
+
+    itsRunning = false;
+
+    return status;
+  }
+
+  // ============================================================================
+  //
+  //  Static methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                nofProcessors
+
+  unsigned int BF_TaskPool::nofProcessors ()
+  {
+    long nofProcessors = sysconf (_SC_NPROCESSORS_ONLN);
+
+    return nofProcessors > 0 ? nofProcessors : 1;
+  }
+
+  // ============================================================================
+  //
+  //  Private methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                          run
+
+  void * BF_TaskPool::run (void *arg)
+  {
+    Worker &worker    = *static_cast<Worker *>(arg);
+    BF_TaskPool *pool = worker.pool;
+    Task task;
+
+    while (true) {
+      /* Take the sequence before looking for work, see TBB_FrameSignal */
+      unsigned long sequence = pool->itsWorkSignal.sequence();
+
+      if (pool->findTask (worker, task)) {
+	pool->itsFunction (task, pool->itsContext);
+	++worker.nofTasks;
+	__sync_fetch_and_add (&pool->itsTasksCompleted, 1);
+	pool->itsDoneSignal.notify ();
+	continue;
+      }
+
+      if (pool->itsStop) {
+	break;
+      }
+
+      pool->itsWorkSignal.wait (sequence, 0.1);
+    }
+
+    return NULL;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     findTask
+
+  bool BF_TaskPool::findTask (Worker &worker,
+			      Task &task)
+  {
+    Deque &own = *itsDeques[worker.index];
+
+    /* Work through the own deque first ... */
+    if (take (own, task)) {
+      return true;
+    }
+
+    /* ... then pick up a new block, waking up the others to help out ... */
+    if (claimBlock (own)) {
+      itsWorkSignal.notify ();
+      return take (own, task);
+    }
+
+    /* ... and finally steal from the peers, starting with the next one */
+    for (unsigned int n=1; n<itsNofThreads; ++n) {
+      if (steal (*itsDeques[(worker.index+n) % itsNofThreads], task)) {
+	++worker.nofStolen;
+	return true;
+      }
+    }
+
+    return false;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         push
+
+  void BF_TaskPool::push (Deque &deque,
+			  Task const &task)
+  {
+    long bottom = deque.bottom;
+
+    deque.tasks[bottom & deque.mask] = task;
+    /* The task must be in place before the thieves can see it */
+    __sync_synchronize();
+    deque.bottom = bottom+1;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         take
+
+  bool BF_TaskPool::take (Deque &deque,
+			  Task &task)
+  {
+    long bottom = deque.bottom-1;
+    long top;
+
+    deque.bottom = bottom;
+    /* Publish the reservation before looking at the top (Chase-Lev) */
+    __sync_synchronize();
+    top = deque.top;
+
+    if (top > bottom) {
+      /* Empty deque */
+      deque.bottom = top;
+      return false;
+    }
+
+    task = deque.tasks[bottom & deque.mask];
+
+    if (top == bottom) {
+      /* Last task: race against the thieves for it */
+      bool won = __sync_bool_compare_and_swap (&deque.top, top, top+1);
+      deque.bottom = top+1;
+      return won;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        steal
+
+  bool BF_TaskPool::steal (Deque &deque,
+			   Task &task)
+  {
+    long top = deque.top;
+    __sync_synchronize();
+    long bottom = deque.bottom;
+
+    if (top >= bottom) {
+      return false;
+    }
+
+    task = deque.tasks[top & deque.mask];
+
+    return __sync_bool_compare_and_swap (&deque.top, top, top+1);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   claimBlock
+
+  bool BF_TaskPool::claimBlock (Deque &deque)
+  {
+    while (true) {
+      long claimed = itsBlocksClaimed;
+      __sync_synchronize();
+
+      if (claimed >= itsBlocksSubmitted) {
+	return false;
+      }
+
+      /* The slot cannot be reused before the claim counter moved past it */
+      Block block = itsBlocks[claimed % BF_TASKPOOL_MAX_BLOCKS];
+
+      if (__sync_bool_compare_and_swap (&itsBlocksClaimed, claimed, claimed+1)) {
+	Task task;
+	task.blockNr = block.blockNr;
+	task.data    = block.data;
+	/* Push in reverse, so the owner works through the block in order and
+	   thieves take the far end */
+	for (unsigned int n=block.nofTasks; n>0; --n) {
+	  task.subband = n-1;
+	  push (deque, task);
+	}
+	return true;
+      }
+    }
+  }
+
+} // Namespace DAL -- end
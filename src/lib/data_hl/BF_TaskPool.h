@@ -0,0 +1,284 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef BF_TASKPOOL_H
+#define BF_TASKPOOL_H
+
+// Standard library header files
+#include <iostream>
+#include <vector>
+#include <pthread.h>
+
+// DAL header files
+#include <data_hl/TBB_FrameRing.h>
+
+//! Maximum number of blocks waiting to be picked up by a worker
+#define BF_TASKPOOL_MAX_BLOCKS 64
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class BF_TaskPool
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Work-stealing pool of threads processing the subbands of data blocks
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tBF_TaskPool.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::TBB_FrameSignal
+      <li>DAL::Bf2h5Calculator
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    A block of data is submitted as a whole, together with the number of
+    tasks (subbands) it consists of; the pool calls the task function once
+    for every <tt>(block,subband)</tt> pair, from one of its worker threads.
+
+    Submitted blocks are queued in a lock-free single-producer ring. An idle
+    worker claims the oldest block from the ring, pushes its tasks onto its own
+    deque and starts working through them from the bottom; the other workers,
+    once they run out of work, steal tasks from the top of the deques of their
+    peers. The deques follow Chase and Lev, so neither taking nor stealing
+    a task involves a lock; workers only block (on a TBB_FrameSignal) if there
+    is nothing to be done at all.
+
+    The task function is called concurrently for different tasks, so it must
+    not touch state shared between tasks without synchronization. The tasks of
+    consecutive blocks may be processed at the same time.
+
+    <h3>Example(s)</h3>
+
+    \code
+    void process (DAL::BF_TaskPool::Task const &task, void *context)
+    {
+      Sample *subband = (Sample *)task.data + task.subband*nofSamples;
+      ...
+    }
+
+    DAL::BF_TaskPool pool (0, nofSubbands, process, this);
+
+    pool.start();
+    pool.submit (blockNr, nofSubbands, samples);
+    pool.waitIdle();
+    pool.stop();
+    \endcode
+  */
+  class BF_TaskPool {
+
+  public:
+
+    //! A single task, i.e. one subband of a block
+    struct Task {
+      //! Number of the data block
+      long blockNr;
+      //! Number of the task within the block
+      unsigned int subband;
+      //! Data attached to the block upon submission
+      void *data;
+    };
+
+    //! Function processing a task
+    typedef void (*Function) (Task const &task,
+			      void *context);
+
+  private:
+
+    //! Chase-Lev deque of tasks, owned by a single worker
+    struct Deque {
+      //! Storage for the tasks
+      std::vector<Task> tasks;
+      //! Mask to map a position onto the storage
+      long mask;
+      //! Padding to keep the top index on its own cache line
+      char pad0[64];
+      //! Position of the oldest task, advanced by thieves and the owner
+      volatile long top;
+      //! Padding to keep the bottom index on its own cache line
+      char pad1[64];
+      //! Position following the newest task, only written by the owner
+      volatile long bottom;
+      //! Padding following the bottom index
+      char pad2[64];
+    };
+
+    //! Per-thread bookkeeping of the workers
+    struct Worker {
+      //! Pool the worker belongs to
+      BF_TaskPool *pool;
+      //! Index of the worker
+      unsigned int index;
+      //! Thread running the worker
+      pthread_t thread;
+      //! Number of tasks processed by the worker
+      unsigned long nofTasks;
+      //! Number of tasks the worker has stolen from its peers
+      unsigned long nofStolen;
+    };
+
+    //! A block waiting to be claimed by a worker
+    struct Block {
+      long blockNr;
+      unsigned int nofTasks;
+      void *data;
+    };
+
+    //! Number of worker threads
+    unsigned int itsNofThreads;
+    //! Maximum number of tasks per block
+    unsigned int itsMaxTasks;
+    //! Function processing a task
+    Function itsFunction;
+    //! Context handed to the task function
+    void *itsContext;
+    //! Deques of the workers
+    std::vector<Deque *> itsDeques;
+    //! Bookkeeping of the workers
+    std::vector<Worker> itsWorkers;
+    //! Ring of submitted blocks
+    Block itsBlocks[BF_TASKPOOL_MAX_BLOCKS];
+    //! Number of blocks submitted
+    volatile long itsBlocksSubmitted;
+    //! Number of blocks claimed by workers
+    volatile long itsBlocksClaimed;
+    //! Number of tasks submitted
+    volatile unsigned long itsTasksSubmitted;
+    //! Number of tasks completed
+    volatile unsigned long itsTasksCompleted;
+    //! Signal waking up idle workers
+    TBB_FrameSignal itsWorkSignal;
+    //! Signal notified whenever a task has been completed
+    TBB_FrameSignal itsDoneSignal;
+    //! Have the workers been started?
+    bool itsRunning;
+    //! Are the workers supposed to stop?
+    volatile bool itsStop;
+
+    //! Disabled copy constructor
+    BF_TaskPool (BF_TaskPool const &other);
+    //! Disabled assignment operator
+    BF_TaskPool& operator= (BF_TaskPool const &other);
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Argumented constructor
+    BF_TaskPool (unsigned int const &nofThreads,
+		 unsigned int const &maxTasksPerBlock,
+		 Function function,
+		 void *context=NULL);
+
+    // === Destruction ==========================================================
+
+    //! Destructor, stops the worker threads
+    ~BF_TaskPool ();
+
+    // === Parameter access =====================================================
+
+    //! Get the number of worker threads
+    inline unsigned int nofThreads () const {
+      return itsNofThreads;
+    }
+    //! Get the maximum number of tasks per block
+    inline unsigned int maxTasksPerBlock () const {
+      return itsMaxTasks;
+    }
+    //! Get the number of tasks submitted so far
+    inline unsigned long nofSubmitted () const {
+      return itsTasksSubmitted;
+    }
+    //! Get the number of tasks completed so far
+    inline unsigned long nofCompleted () const {
+      __sync_synchronize();
+      return itsTasksCompleted;
+    }
+    //! Get the number of tasks submitted, but not yet completed
+    inline unsigned long nofPending () const {
+      __sync_synchronize();
+      return itsTasksSubmitted-itsTasksCompleted;
+    }
+    //! Get the number of tasks stolen by the workers from their peers
+    unsigned long nofStolen () const;
+    //! Get the signal notified whenever a task has been completed
+    inline TBB_FrameSignal* doneSignal () {
+      return &itsDoneSignal;
+    }
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    // === Methods ==============================================================
+
+    //! Start the worker threads
+    bool start ();
+
+    //! Submit a block of \e nofTasks tasks; blocks while the ring is full
+    bool submit (long const &blockNr,
+		 unsigned int const &nofTasks,
+		 void *data);
+
+    //! Block until all submitted tasks have been completed
+    void waitIdle ();
+
+    //! Stop the worker threads, after completing all submitted tasks
+    bool stop ();
+
+    // === Static methods =======================================================
+
+    //! Get the number of processors available, as default number of threads
+    static unsigned int nofProcessors ();
+
+  private:
+
+    //! Main loop of a worker thread
+    static void * run (void *worker);
+    //! Find a task for a worker: own deque, then new block, then steal
+    bool findTask (Worker &worker,
+		   Task &task);
+    //! Push a task onto the bottom of a deque (owner only)
+    void push (Deque &deque,
+	       Task const &task);
+    //! Take a task from the bottom of a deque (owner only)
+    bool take (Deque &deque,
+	       Task &task);
+    //! Steal a task from the top of a deque
+    bool steal (Deque &deque,
+		Task &task);
+    //! Claim the oldest submitted block and push its tasks onto a deque
+    bool claimBlock (Deque &deque);
+
+  }; // Class BF_TaskPool -- end
+
+} // Namespace DAL -- end
+
+#endif /* BF_TASKPOOL_H */
@@ -265,6 +265,7 @@ namespace DAL { // Namespace DAL -- begin
 	HDF5Attribute::write (location_p,"TARGET_RA",   float(0.0)  );
 	HDF5Attribute::write (location_p,"TARGET_DEC",  float(0.0)  );
 	HDF5Attribute::write (location_p,"INPUT_FILE",  undefined   );
+	itsAttributeCache.invalidate();
 	/* Read back in the common attributes after storing default values */
 	commonAttributes_p.h5read(location_p);
       } else {
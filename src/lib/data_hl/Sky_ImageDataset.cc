@@ -68,8 +68,12 @@ namespace DAL { // Namespace DAL -- begin
 				      std::vector< hsize_t > const &shape,
 				      hid_t const &datatype,
 				      IO_Mode const &flags)
-    : HDF5DatasetBase(location, name, shape, datatype, flags)
+    : HDF5DatasetBase()
   {
+    /* Image planes are read as tiles rather than along a single axis */
+    itsChunkPlanner = HDF5ChunkPlanner (HDF5ChunkPlanner::Tile);
+
+    HDF5DatasetBase::open (location, name, shape, datatype, flags);
   }
 
   //_____________________________________________________________________________
@@ -51,6 +51,10 @@ namespace DAL { // Namespace DAL -- begin
     </ul>
     
     <h3>Synopsis</h3>
+
+    A new image dataset is chunked in tiles of about equal length along all
+    axes (HDF5ChunkPlanner::Tile), such that cut-outs and planes along any axis
+    are read from a comparable number of chunks.
     
     <h3>Example(s)</h3>
     
@@ -197,6 +197,7 @@ namespace DAL { // Namespace DAL -- begin
 	HDF5Attribute::write (location_p,"EFFECTIVE_FREQUENCY_UNIT",  undefined );
 	HDF5Attribute::write (location_p,"EFFECTIVE_BANDWIDTH_VALUE", valDouble );
 	HDF5Attribute::write (location_p,"EFFECTIVE_BANDWIDTH_UNIT",  undefined );
+	itsAttributeCache.invalidate();
       }
       
       // Open embedded groups ______________________________
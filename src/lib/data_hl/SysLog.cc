@@ -165,6 +165,7 @@ namespace DAL { // Namespace DAL -- begin
 	  std::string groupName = "SysLog";
 	  // write the attributes
 	  HDF5Attribute::write (location_p, "GROUPTYPE", groupName);
+	  itsAttributeCache.invalidate();
 	} else {
 #ifdef DAL_DEBUGGING_MESSAGES
 	  std::cerr << "[SysLog::open] Failed to create group "
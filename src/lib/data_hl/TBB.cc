@@ -132,11 +132,12 @@ namespace DAL {
     real_part         = 0;
     imag_part         = 0;
 #ifdef USE_INPUT_BUFFER
-    inBufProcessID = inBufStorID = 0;
     maxWaitingFrames = 0;
     noFramesDropped = 0;
-    inputBuffer_P = new char [(INPUT_BUFFER_SIZE*UDP_PACKET_BUFFER_SIZE)];
-    udpBuff_p = inputBuffer_P;
+    inputBuffer_P = new TBB_FrameRing (INPUT_BUFFER_SIZE, UDP_PACKET_BUFFER_SIZE);
+    frameInUse_p = false;
+    batchSize_p = INPUT_BATCH_SIZE;
+    udpBuff_p = NULL;
 #endif
     /* Initialization of public data */
 
@@ -198,7 +199,7 @@ namespace DAL {
         rawfile_p = 0;
       }
 #ifdef USE_INPUT_BUFFER
-    delete [] inputBuffer_P;
+    delete inputBuffer_P;
 #endif
   }
 
@@ -438,73 +439,51 @@ namespace DAL {
   int TBB::readSocketBuffer()
   {
     struct timeval readTimeout;
-    FD_ZERO(&readSet);
-    FD_SET(main_socket, &readSet);
-    int newBufID, nFramesWaiting = 0;
+    int nofFrames, nFramesWaiting = 0;
+
+    //hand the frame processed last back to the input buffer
+    if (frameInUse_p) {
+      inputBuffer_P->release();
+      frameInUse_p = false;
+    };
 
-    //set timeout to zero (don't wait, just poll)
-    readTimeout.tv_sec = readTimeout.tv_usec = 0;
-    while (select(main_socket + 1, &readSet, NULL, NULL, &readTimeout) > 0 )
+    //take whatever is waiting in the vBuffer, a batch per system call; if the
+    //input buffer is full, the frames are discarded
+    while ((nofFrames = inputBuffer_P->receive(main_socket, batchSize_p)) > 0)
       {
-        //there is a frame waiting in the vBuffer
-        newBufID = inBufStorID+1;
-        if (newBufID >= INPUT_BUFFER_SIZE)
-          {
-            newBufID =0;
-          }
-        if (newBufID == inBufProcessID)
-          {
-            //cerr << "TBB::readSocketBuffer: Buffer overflow! Overwriting last frame." << endl;
-            noFramesDropped++;
-            newBufID = inBufStorID;
-          };
-        //perform the actual read
-        rr = recvfrom( main_socket, (inputBuffer_P + (newBufID*UDP_PACKET_BUFFER_SIZE)),
-                       UDP_PACKET_BUFFER_SIZE, 0, (sockaddr *) &incoming_addr, &socklen);
-        nFramesWaiting++;
-        inBufStorID = newBufID;
+        nFramesWaiting += nofFrames;
       };
+    noFramesDropped = inputBuffer_P->nofDropped();
     if (nFramesWaiting > maxWaitingFrames) {
       maxWaitingFrames = nFramesWaiting;
     };
-    if ( inBufStorID == inBufProcessID) {
+    if (inputBuffer_P->empty()) {
       // that means input buffer is empty
       readTimeout.tv_sec = timeoutRead_p.tv_sec;
       readTimeout.tv_usec = timeoutRead_p.tv_usec;
       FD_ZERO(&readSet);
       FD_SET(main_socket, &readSet);
       status = select(main_socket + 1, &readSet, NULL, NULL, &readTimeout);
-      if (status) {
-	inBufStorID++;
-	if (inBufStorID >= INPUT_BUFFER_SIZE) {
-	  inBufStorID =0;
-	}
-	rr = recvfrom( main_socket, (inputBuffer_P+(inBufStorID*UDP_PACKET_BUFFER_SIZE)),
-		       UDP_PACKET_BUFFER_SIZE, 0, (sockaddr *) &incoming_addr, &socklen);
+      if (status > 0) {
+	inputBuffer_P->receive(main_socket, batchSize_p);
       }
       else {
 	// we waited for "timeoutRead_p" but still no data -> end of data
 	cout << "TBB::readSocketBuffer: Data stopped coming" << endl;
-	cout << "TBB::readSocketBuffer: inBufProcessID: " << inBufProcessID
-	     << " inBufStorID: " << inBufStorID << " select-status:" << status
+	cout << "TBB::readSocketBuffer: frames received: " << inputBuffer_P->nofFrames()
+	     << " in batches: " << inputBuffer_P->nofBatches() << " select-status:" << status
 	     << " remaining-sec: " << readTimeout.tv_sec << " -usec: " << readTimeout.tv_usec << endl;
 	cout << "TBB::readSocketBuffer: Max no. of frames waiting: " << maxWaitingFrames
 	     << " number of discarded frames: " << noFramesDropped << endl;
 	return FAIL;
       };
     };
-#ifdef DAL_DEBUGGING_MESSAGES
-    if (inBufStorID == inBufProcessID) {
+    udpBuff_p = inputBuffer_P->readSlot(rr);
+    if (udpBuff_p == NULL) {
       cerr << "TBB::readSocketBuffer: Empty buffer at end of method!" << endl;
       return FAIL;
     };
-#endif
-    inBufProcessID++;
-    if (inBufProcessID >= INPUT_BUFFER_SIZE)
-      {
-        inBufProcessID =0;
-      };
-    udpBuff_p = (inputBuffer_P + (inBufProcessID*UDP_PACKET_BUFFER_SIZE));
+    frameInUse_p = true;
     return SUCCESS;
   };
 #endif
@@ -953,10 +932,7 @@ namespace DAL {
 
     if ( bigendian_p )
       {
-        for ( short zz=0; zz < headerp_p->n_samples_per_frame; zz++ )
-          {
-            swapbytes( (char *)&(sdata[zz]), 2 );
-          };
+        swapbytes( sdata, headerp_p->n_samples_per_frame );
       };
 
     //calculate the writeOffset from time of first block and this block
@@ -1023,16 +999,11 @@ namespace DAL {
   void TBB::processTransientFileDataBlock()
   {
     short sdata[ headerp_p->n_samples_per_frame];
-    for (short zz=0; zz < headerp_p->n_samples_per_frame; zz++ )
-      {
-        rawfile_p->read( reinterpret_cast<char *>(&tran_sample),
-                         sizeof(tran_sample) );
-
-        if ( bigendian_p )  // reverse fields if big endian
-          swapbytes( (char *)&tran_sample.value, 2 );
+    rawfile_p->read( reinterpret_cast<char *>(sdata),
+                     headerp_p->n_samples_per_frame*sizeof(short) );
 
-        sdata[zz] = tran_sample.value;
-      }
+    if ( bigendian_p )  // reverse fields if big endian
+      swapbytes( sdata, headerp_p->n_samples_per_frame );
 
     //calculate the writeOffset from time of first block and this block
     uint starttime, startsamplenum;
@@ -1082,22 +1053,11 @@ namespace DAL {
   {
     std::complex<Int16> csdata[ headerp_p->n_samples_per_frame];
 
-    for ( short zz=0; zz < headerp_p->n_samples_per_frame; zz++ )
-      {
-        rawfile_p->read( reinterpret_cast<char *>(&spec_sample),
-                         sizeof(spec_sample) );
-
-        real_part = real(spec_sample.value);
-        imag_part = imag(spec_sample.value);
-
-        if ( bigendian_p ) // reverse fields if big endian
-          {
-            swapbytes( (char *)&real_part, 2 );
-            swapbytes( (char *)&imag_part, 2 );
-          }
+    rawfile_p->read( reinterpret_cast<char *>(csdata),
+                     headerp_p->n_samples_per_frame*sizeof(std::complex<Int16>) );
 
-        csdata[zz] = std::complex<Int16>( real_part, imag_part );
-      }
+    if ( bigendian_p ) // reverse fields if big endian
+      swapbytes( csdata, headerp_p->n_samples_per_frame );
 
     dims[0] += headerp_p->n_samples_per_frame;
     dipoleArray_p->extend(dims);
@@ -34,6 +34,7 @@
 #include <string>
 
 #include <core/dalDataset.h>
+#include <data_hl/TBB_FrameRing.h>
 
 #define ETHEREAL_HEADER_LENGTH = 46;
 #define FIRST_EXTRA_HDR_LENGTH = 40;
@@ -49,6 +50,8 @@
 // number of frames in the input buffer (50000 is ca. 100MB)
 //(the vBuf of the system on the storage nodes can store ca. 3600 frames!)
 #define INPUT_BUFFER_SIZE 50000
+// max. number of frames taken off the socket by a single system call
+#define INPUT_BATCH_SIZE 32
 
 namespace DAL {
   
@@ -170,11 +173,12 @@ namespace DAL {
     struct timeval timeoutStart_p;
     struct timeval timeoutRead_p;
 #ifdef USE_INPUT_BUFFER
-    //!pointers (array indices) for the last buffer processed and the last buffer written
-    int inBufProcessID,inBufStorID;
-    //!the Input Buffer
-    //    char inputBuffer_P[INPUT_BUFFER_SIZE][UDP_PACKET_BUFFER_SIZE];
-    char * inputBuffer_P;
+    //!the Input Buffer, frames are received into it in batches
+    TBB_FrameRing * inputBuffer_P;
+    //!is udpBuff_p pointing at a frame still held in the input buffer?
+    bool frameInUse_p;
+    //!max. number of frames taken off the socket per system call
+    unsigned int batchSize_p;
     //!pointer to the UDP-datagram
     char *udpBuff_p;
     //!maximum number of frames waiting in the vBuf while reading
@@ -341,6 +345,28 @@ namespace DAL {
       timeoutRead_p.tv_sec  = time_sec;
       timeoutRead_p.tv_usec = time_usec;
     }
+
+#ifdef USE_INPUT_BUFFER
+    //! Get the max. number of frames taken off the socket per system call
+    inline unsigned int batchSize () const {
+      return batchSize_p;
+    }
+
+    /*!
+      \brief Set the max. number of frames taken off the socket per system call
+      \param batchSize -- Number of frames; 1 receives every frame separately,
+             values beyond TBB_FRAMERING_MAX_BATCH are capped.
+    */
+    inline void setBatchSize (unsigned int const &batchSize) {
+      if (batchSize < 1) {
+	batchSize_p = 1;
+      } else if (batchSize > TBB_FRAMERING_MAX_BATCH) {
+	batchSize_p = TBB_FRAMERING_MAX_BATCH;
+      } else {
+	batchSize_p = batchSize;
+      }
+    }
+#endif
     
       //___________________________________________________________________________
       // Methods
@@ -0,0 +1,465 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <data_hl/TBB_BlockIterator.h>
+
+#include <cstring>
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                            TBB_BlockIterator
+
+  /*!
+    \param timeseries  -- Time-series dataset, the selected dipoles of which
+           are iterated over.
+    \param blocksize   -- Number of samples per block.
+    \param offsets     -- Offset of the first sample, per selected dipole; if
+           empty, all dipoles start at the same sample.
+    \param start       -- Number of the sample at which the first block starts.
+    \param nofPrefetch -- Number of blocks loaded ahead of the current one.
+    \param nofBlocks   -- Number of blocks to iterate over; if 0, the number of
+           complete blocks covered by all dipoles.
+  */
+  TBB_BlockIterator::TBB_BlockIterator (TBB_Timeseries &timeseries,
+					int const &blocksize,
+					std::vector<int> const &offsets,
+					int const &start,
+					unsigned int const &nofPrefetch,
+					long const &nofBlocks)
+  {
+    init (timeseries.dipoleSelection(),
+	  blocksize,
+	  offsets,
+	  start,
+	  nofPrefetch,
+	  nofBlocks);
+  }
+
+  //_____________________________________________________________________________
+  //                                                            TBB_BlockIterator
+
+  /*!
+    \param station     -- Station group, the selected dipoles of which are
+           iterated over.
+    \param blocksize   -- Number of samples per block.
+    \param offsets     -- Offset of the first sample, per selected dipole; if
+           empty, all dipoles start at the same sample.
+    \param start       -- Number of the sample at which the first block starts.
+    \param nofPrefetch -- Number of blocks loaded ahead of the current one.
+    \param nofBlocks   -- Number of blocks to iterate over; if 0, the number of
+           complete blocks covered by all dipoles.
+  */
+  TBB_BlockIterator::TBB_BlockIterator (TBB_StationGroup &station,
+					int const &blocksize,
+					std::vector<int> const &offsets,
+					int const &start,
+					unsigned int const &nofPrefetch,
+					long const &nofBlocks)
+  {
+    init (station.dipoleSelection(),
+	  blocksize,
+	  offsets,
+	  start,
+	  nofPrefetch,
+	  nofBlocks);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         init
+
+  void TBB_BlockIterator::init (DipoleSelection const &selection,
+				int const &blocksize,
+				std::vector<int> const &offsets,
+				int const &start,
+				unsigned int const &nofPrefetch,
+				long const &nofBlocks)
+  {
+    itsBlocksize     = blocksize > 0 ? blocksize : 1;
+    itsNofBlocks     = 0;
+    itsBlockNr       = -1;
+    itsNextIssue     = 0;
+    itsCurrent       = NULL;
+    itsThreadRunning = false;
+    itsStop          = false;
+
+    pthread_mutex_init (&itsMutex, NULL);
+    pthread_cond_init (&itsWork, NULL);
+    pthread_cond_init (&itsDone, NULL);
+
+    if (!offsets.empty() && offsets.size() != selection.size()) {
+      std::cerr << "[TBB_BlockIterator] Wrong number of offsets: "
+		<< offsets.size() << " for " << selection.size() << " dipoles!"
+		<< std::endl;
+      return;
+    }
+
+    /* Datasets of the selected dipoles */
+    DipoleSelection::const_iterator it;
+    unsigned int n (0);
+
+    for (it=selection.begin(); it!=selection.end(); ++it, ++n) {
+      it->second->second.openLink();
+      std::vector<hsize_t> shape = it->second->second.shape();
+      itsDipoles.push_back (it->first);
+      itsDatasets.push_back (it->second->second.locationID());
+      itsLengths.push_back (shape.size() == 1 ? shape[0] : 0);
+      itsStart.push_back (long(start) + (offsets.empty() ? 0 : offsets[n]));
+    }
+
+    /* Number of complete blocks covered by all dipoles */
+    if (nofBlocks > 0) {
+      itsNofBlocks = nofBlocks;
+    } else if (!itsDatasets.empty()) {
+      itsNofBlocks = -1;
+      for (n=0; n<itsDatasets.size(); ++n) {
+	long blocks = (long(itsLengths[n]) - itsStart[n])/itsBlocksize;
+	if (itsNofBlocks < 0 || blocks < itsNofBlocks) {
+	  itsNofBlocks = blocks;
+	}
+      }
+      if (itsNofBlocks < 0) {
+	itsNofBlocks = 0;
+      }
+    }
+
+    /* Buffers for the current and the prefetched blocks */
+    for (n=0; n<=nofPrefetch; ++n) {
+      Buffer *buffer  = new Buffer;
+      buffer->blockNr = -1;
+      buffer->state   = Free;
+      buffer->views.resize (itsDatasets.size());
+      buffer->offset.resize (itsDatasets.size(), 0);
+      buffer->nofValid.resize (itsDatasets.size(), 0);
+      buffer->data.resize (itsDatasets.size()*itsBlocksize);
+      for (unsigned int k=0; k<itsDatasets.size(); ++k) {
+	buffer->views[k] = new HDF5MappedView;
+      }
+      itsBuffers.push_back (buffer);
+    }
+
+    if (pthread_create (&itsThread, NULL, TBB_BlockIterator::run, this) == 0) {
+      itsThreadRunning = true;
+    } else {
+      std::cerr << "[TBB_BlockIterator] Failed to start background thread;"
+		<< " converting blocks on demand." << std::endl;
+    }
+
+    issue ();
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  TBB_BlockIterator::~TBB_BlockIterator ()
+  {
+    if (itsThreadRunning) {
+      pthread_mutex_lock (&itsMutex);
+      itsStop = true;
+      pthread_cond_broadcast (&itsWork);
+      pthread_mutex_unlock (&itsMutex);
+
+      pthread_join (itsThread, NULL);
+    }
+
+    for (unsigned int n=0; n<itsBuffers.size(); ++n) {
+      for (unsigned int k=0; k<itsBuffers[n]->views.size(); ++k) {
+	delete itsBuffers[n]->views[k];
+      }
+      delete itsBuffers[n];
+    }
+
+    pthread_cond_destroy (&itsDone);
+    pthread_cond_destroy (&itsWork);
+    pthread_mutex_destroy (&itsMutex);
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                        start
+
+  /*!
+    \return start -- Number of the first sample of the current block, per
+            dipole; empty if there is no current block.
+  */
+  std::vector<long> TBB_BlockIterator::start () const
+  {
+    std::vector<long> result;
+
+    if (itsCurrent != NULL) {
+      result.resize (itsStart.size());
+      for (unsigned int n=0; n<itsStart.size(); ++n) {
+	result[n] = itsStart[n] + itsBlockNr*itsBlocksize;
+      }
+    }
+
+    return result;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         data
+
+  /*!
+    \return data -- Samples of the current block, [blocksize,dipole]; \c NULL
+            if there is no current block.
+  */
+  double const * TBB_BlockIterator::data () const
+  {
+    if (itsCurrent == NULL || itsCurrent->data.empty()) {
+      return NULL;
+    }
+    return &(itsCurrent->data[0]);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         data
+
+  /*!
+    \param dipole -- Index of the dipole, in the order of dipoleNames().
+    \return data  -- The \e blocksize samples of the dipole within the current
+            block; \c NULL if there is no current block.
+  */
+  double const * TBB_BlockIterator::data (unsigned int const &dipole) const
+  {
+    if (itsCurrent == NULL || dipole >= itsDatasets.size()) {
+      return NULL;
+    }
+    return &(itsCurrent->data[dipole*itsBlocksize]);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  /*!
+    \param os -- Output stream to which the summary is written.
+  */
+  void TBB_BlockIterator::summary (std::ostream &os)
+  {
+    os << "[TBB_BlockIterator] Summary of internal parameters." << std::endl;
+    os << "-- nof. dipoles         = " << itsDatasets.size() << std::endl;
+    os << "-- Blocksize            = " << itsBlocksize       << std::endl;
+    os << "-- nof. blocks          = " << itsNofBlocks       << std::endl;
+    os << "-- nof. prefetch blocks = " << nofPrefetch()      << std::endl;
+    os << "-- Current block        = " << itsBlockNr         << std::endl;
+    os << "-- Background thread    = " << itsThreadRunning   << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                         next
+
+  /*!
+    The buffer of the previous block is recycled, i.e. pointers obtained
+    through data() become invalid.
+
+    \return status -- Returns \e false once all blocks have been handed out.
+  */
+  bool TBB_BlockIterator::next ()
+  {
+    pthread_mutex_lock (&itsMutex);
+    if (itsCurrent != NULL) {
+      itsCurrent->state = Free;
+      itsCurrent        = NULL;
+    }
+    pthread_mutex_unlock (&itsMutex);
+
+    if (itsBlockNr+1 >= itsNofBlocks) {
+      itsBlockNr = itsNofBlocks;
+      return false;
+    }
+
+    issue ();
+
+    ++itsBlockNr;
+
+    Buffer *buffer = NULL;
+    for (unsigned int n=0; n<itsBuffers.size(); ++n) {
+      if (itsBuffers[n]->blockNr == itsBlockNr) {
+	buffer = itsBuffers[n];
+      }
+    }
+
+    if (!itsThreadRunning) {
+      convert (buffer);
+      buffer->state = InUse;
+      itsCurrent    = buffer;
+      return true;
+    }
+
+    pthread_mutex_lock (&itsMutex);
+    while (buffer->state != Ready) {
+      pthread_cond_wait (&itsDone, &itsMutex);
+    }
+    buffer->state = InUse;
+    itsCurrent    = buffer;
+    pthread_mutex_unlock (&itsMutex);
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        issue
+
+  /*!
+    Only buffers in the state \e Free are touched, which are not accessed by
+    the background thread; the calls into the HDF5 library are therefore made
+    without holding the lock.
+  */
+  void TBB_BlockIterator::issue ()
+  {
+    for (unsigned int n=0; n<itsBuffers.size() && itsNextIssue<itsNofBlocks; ++n) {
+      Buffer *buffer = itsBuffers[n];
+
+      pthread_mutex_lock (&itsMutex);
+      bool isFree = buffer->state == Free;
+      pthread_mutex_unlock (&itsMutex);
+
+      if (!isFree) {
+	continue;
+      }
+
+      buffer->blockNr = itsNextIssue++;
+
+      for (unsigned int k=0; k<itsDatasets.size(); ++k) {
+	/* Overlap of the block with the dataset */
+	long blockStart = itsStart[k] + buffer->blockNr*itsBlocksize;
+	long first      = blockStart > 0 ? blockStart : 0;
+	long last       = blockStart + itsBlocksize;
+
+	if (last > long(itsLengths[k])) {
+	  last = itsLengths[k];
+	}
+
+	/* Blocks without overlap, e.g. lying wholly before a dataset with a
+	   negative sample offset, are filled with zeros */
+	buffer->offset[k]   = 0;
+	buffer->nofValid[k] = 0;
+
+	if (last > first) {
+	  buffer->offset[k] = first-blockStart;
+
+	  std::vector<int> sliceStart (1, first);
+	  std::vector<int> sliceBlock (1, last-first);
+
+	  if (buffer->views[k]->open (itsDatasets[k],
+				      H5T_NATIVE_SHORT,
+				      HDF5Hyperslab (sliceStart, sliceBlock))) {
+	    buffer->nofValid[k] = last-first;
+	  } else {
+	    std::cerr << "[TBB_BlockIterator::issue] Failed to read block "
+		      << buffer->blockNr << " of dipole " << itsDipoles[k]
+		      << std::endl;
+	  }
+	} else {
+	  buffer->views[k]->close ();
+	}
+      }
+
+      pthread_mutex_lock (&itsMutex);
+      buffer->state = Issued;
+      if (itsThreadRunning) {
+	itsQueue.push_back (buffer);
+	pthread_cond_signal (&itsWork);
+      }
+      pthread_mutex_unlock (&itsMutex);
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      convert
+
+  /*!
+    \param buffer -- Buffer, the views of which are converted into its samples;
+           samples not covered by the datasets are set to zero.
+  */
+  void TBB_BlockIterator::convert (Buffer *buffer)
+  {
+    for (unsigned int k=0; k<itsDatasets.size(); ++k) {
+      double *column = &(buffer->data[k*itsBlocksize]);
+      size_t offset  = buffer->offset[k];
+      size_t valid   = buffer->nofValid[k];
+
+      memset (column, 0, offset*sizeof(double));
+      if (valid > 0) {
+	TBB_DipoleDataset::convertSamples (buffer->views[k]->data<short>(),
+					   valid,
+					   column+offset);
+      }
+      memset (column+offset+valid, 0, (itsBlocksize-offset-valid)*sizeof(double));
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                          run
+
+  /*!
+    \param iterator -- The TBB_BlockIterator object the thread belongs to.
+  */
+  void * TBB_BlockIterator::run (void *iterator)
+  {
+    TBB_BlockIterator *self = static_cast<TBB_BlockIterator *>(iterator);
+
+    pthread_mutex_lock (&(self->itsMutex));
+
+    while (true) {
+      if (self->itsQueue.empty()) {
+	if (self->itsStop) {
+	  break;
+	}
+	pthread_cond_wait (&(self->itsWork), &(self->itsMutex));
+	continue;
+      }
+
+      Buffer *buffer = self->itsQueue.front();
+      self->itsQueue.pop_front();
+      pthread_mutex_unlock (&(self->itsMutex));
+
+      self->convert (buffer);
+
+      pthread_mutex_lock (&(self->itsMutex));
+      buffer->state = Ready;
+      pthread_cond_broadcast (&(self->itsDone));
+    }
+
+    pthread_mutex_unlock (&(self->itsMutex));
+
+    return NULL;
+  }
+
+} // Namespace DAL -- end
@@ -0,0 +1,291 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TBB_BLOCKITERATOR_H
+#define TBB_BLOCKITERATOR_H
+
+// Standard library header files
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+// DAL header files
+#include <core/HDF5MappedView.h>
+#include <data_hl/TBB_StationGroup.h>
+#include <data_hl/TBB_Timeseries.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class TBB_BlockIterator
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Iterate block by block over the selected dipoles, prefetching ahead
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tTBB_BlockIterator.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::TBB_Timeseries
+      <li>DAL::TBB_StationGroup
+      <li>DAL::HDF5MappedView
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    Walking through a TBB dataset with TBB_Timeseries::readData() blocks the
+    analysis on every call until the samples have been read. The block
+    iterator instead keeps a number of blocks in flight: while the caller works
+    on the current block, the following \e nofPrefetch blocks are being
+    loaded and converted to \c double by a background thread.
+
+    Block \e b of dipole \e n covers the samples
+    <tt>[start+offset[n]+b*blocksize, start+offset[n]+(b+1)*blocksize)</tt>,
+    where the offsets per dipole e.g. are those returned by
+    TBB_Timeseries::sample_offset(); samples outside a dataset are set to zero.
+    The samples of a block are stored in a <tt>[blocksize,dipole]</tt> array,
+    i.e. the samples of a dipole follow each other.
+
+    The buffers holding the blocks are allocated once and recycled: the buffer
+    handed out by next() stays valid until the following call of next(), after
+    which it is used to prefetch a block further ahead. Apart from this, no
+    memory for samples is allocated while iterating.
+
+    As the HDF5 library is not necessarily thread-safe, all calls into it are
+    made from the thread calling next(): the datasets are accessed through a
+    DAL::HDF5MappedView, and the background thread only touches the mapped
+    samples and converts them. For contiguous datasets -- the layout of the
+    TBB dipole datasets -- the reading from disk hence overlaps with the
+    computation of the caller; chunked or filtered datasets are read when the
+    block is queued, which happens from within next().
+
+    The iterator refers to the datasets of the TBB_Timeseries or
+    TBB_StationGroup it was created from; these have to stay open, with an
+    unchanged dipole selection, as long as the iterator is in use.
+
+    <h3>Example(s)</h3>
+
+    <ol>
+      <li>Process a dataset block by block, aligned with the first dipole:
+      \code
+      DAL::TBB_Timeseries ts (filename);
+      DAL::TBB_BlockIterator blocks (ts, 1024, ts.sample_offset(0));
+
+      while (blocks.next()) {
+        for (unsigned int n=0; n<blocks.nofDipoles(); ++n) {
+          double const *samples = blocks.data(n);
+          ...
+        }
+      }
+      \endcode
+    </ol>
+  */
+  class TBB_BlockIterator {
+
+    //! Map holding the selected dipole datasets
+    typedef std::map<std::string,std::map<std::string,TBB_DipoleDataset>::iterator> DipoleSelection;
+
+    //! State of a buffer
+    enum BufferState {
+      //! Available for a new block
+      Free,
+      //! Waiting to be converted by the background thread
+      Issued,
+      //! Converted, waiting to be handed out
+      Ready,
+      //! Handed out to the caller
+      InUse
+    };
+
+    //! Buffer holding a block of samples
+    struct Buffer {
+      //! Number of the block held by the buffer
+      long blockNr;
+      //! State of the buffer
+      BufferState state;
+      //! Views on the samples of the dipoles within the datasets
+      std::vector<HDF5MappedView *> views;
+      //! Position of the first sample read within the block, per dipole
+      std::vector<size_t> offset;
+      //! Number of samples read, per dipole
+      std::vector<size_t> nofValid;
+      //! Samples of the block, [blocksize,dipole]
+      std::vector<double> data;
+    };
+
+    //! Names of the dipoles
+    std::vector<std::string> itsDipoles;
+    //! Identifiers of the dipole datasets
+    std::vector<hid_t> itsDatasets;
+    //! Number of samples of the dipole datasets
+    std::vector<hsize_t> itsLengths;
+    //! First sample of the first block, per dipole
+    std::vector<long> itsStart;
+    //! Number of samples per block
+    int itsBlocksize;
+    //! Number of blocks
+    long itsNofBlocks;
+    //! Number of the current block
+    long itsBlockNr;
+    //! Number of the next block to be queued
+    long itsNextIssue;
+    //! Buffers holding the blocks in flight
+    std::vector<Buffer *> itsBuffers;
+    //! Buffer handed out to the caller
+    Buffer *itsCurrent;
+    //! Buffers waiting to be converted, in the order of the blocks
+    std::deque<Buffer *> itsQueue;
+    //! Background thread converting the samples
+    pthread_t itsThread;
+    //! Has the background thread been started?
+    bool itsThreadRunning;
+    //! Mutex guarding the state of the buffers
+    pthread_mutex_t itsMutex;
+    //! Signal a buffer waiting to be converted
+    pthread_cond_t itsWork;
+    //! Signal a converted buffer
+    pthread_cond_t itsDone;
+    //! Is the background thread supposed to stop?
+    bool itsStop;
+
+    //! Disabled copy constructor
+    TBB_BlockIterator (TBB_BlockIterator const &other);
+    //! Disabled assignment operator
+    TBB_BlockIterator& operator= (TBB_BlockIterator const &other);
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Iterate over the dipoles selected within a time-series dataset
+    TBB_BlockIterator (TBB_Timeseries &timeseries,
+		       int const &blocksize,
+		       std::vector<int> const &offsets=std::vector<int>(),
+		       int const &start=0,
+		       unsigned int const &nofPrefetch=2,
+		       long const &nofBlocks=0);
+
+    //! Iterate over the dipoles selected within a station group
+    TBB_BlockIterator (TBB_StationGroup &station,
+		       int const &blocksize,
+		       std::vector<int> const &offsets=std::vector<int>(),
+		       int const &start=0,
+		       unsigned int const &nofPrefetch=2,
+		       long const &nofBlocks=0);
+
+    // === Destruction ==========================================================
+
+    //! Destructor, stopping the background thread
+    ~TBB_BlockIterator ();
+
+    // === Parameter access =====================================================
+
+    //! Get the number of samples per block
+    inline int blocksize () const {
+      return itsBlocksize;
+    }
+
+    //! Get the number of blocks
+    inline long nofBlocks () const {
+      return itsNofBlocks;
+    }
+
+    //! Get the number of blocks prefetched ahead of the current one
+    inline unsigned int nofPrefetch () const {
+      return itsBuffers.empty() ? 0 : itsBuffers.size()-1;
+    }
+
+    //! Get the number of dipoles
+    inline unsigned int nofDipoles () const {
+      return itsDatasets.size();
+    }
+
+    //! Get the names of the dipoles, in the order of the block columns
+    inline std::vector<std::string> dipoleNames () const {
+      return itsDipoles;
+    }
+
+    //! Get the number of the current block; -1 before the first call of next()
+    inline long blockNumber () const {
+      return itsBlockNr;
+    }
+
+    //! Get the first sample of the current block, per dipole
+    std::vector<long> start () const;
+
+    //! Get the samples of the current block, [blocksize,dipole]
+    double const * data () const;
+
+    //! Get the samples of a dipole within the current block
+    double const * data (unsigned int const &dipole) const;
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, TBB_BlockIterator.
+    */
+    inline std::string className () const {
+      return "TBB_BlockIterator";
+    }
+
+    // === Methods ==============================================================
+
+    //! Advance to the next block
+    bool next ();
+
+  private:
+
+    //! Set up the iterator and start prefetching
+    void init (DipoleSelection const &selection,
+	       int const &blocksize,
+	       std::vector<int> const &offsets,
+	       int const &start,
+	       unsigned int const &nofPrefetch,
+	       long const &nofBlocks);
+    //! Queue the following blocks into the free buffers
+    void issue ();
+    //! Convert the samples of a buffer
+    void convert (Buffer *buffer);
+    //! Main loop of the background thread
+    static void * run (void *iterator);
+
+  }; // Class TBB_BlockIterator -- end
+
+} // Namespace DAL -- end
+
+#endif /* TBB_BLOCKITERATOR_H */
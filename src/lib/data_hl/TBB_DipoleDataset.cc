@@ -20,6 +20,10 @@
 
 #include <data_hl/TBB_DipoleDataset.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 using std::cerr;
 using std::cout;
 using std::endl;
@@ -107,6 +111,52 @@ namespace DAL {  // Namespace DAL -- begin
 	  datatype);
   }
   
+  //_____________________________________________________________________________
+  //                                                            TBB_DipoleDataset
+  
+  /*!
+    \param location -- Identifier for the location within the HDF5 file, below
+           which the dataset is placed.
+    \param station  -- Station identifier.
+    \param rsp      -- RSP identifier.
+    \param rcu      -- RCU identifier.
+    \param shape    -- Shape of the dataset array.
+    \param filters  -- Filters applied to the chunks of the dataset.
+    \param datatype -- Datatype of the array elements.
+  */
+  TBB_DipoleDataset::TBB_DipoleDataset (hid_t const &location,
+					uint const &stationID,
+					uint const &rspID,
+					uint const &rcuID,
+					std::vector<hsize_t> const &shape,
+					HDF5FilterPipeline const &filters,
+					hid_t const &datatype)
+  {
+    init ();
+    itsFilters = filters;
+    open (location,
+	  stationID,
+	  rspID,
+	  rcuID,
+	  shape,
+	  datatype);
+  }
+  
+  //_____________________________________________________________________________
+  //                                                            TBB_DipoleDataset
+  
+  /*!
+    \param other -- Another TBB_DipoleDataset object from which to create this
+           new one; if \e other has not been opened yet, only the link to the
+           dataset is copied.
+  */
+  TBB_DipoleDataset::TBB_DipoleDataset (TBB_DipoleDataset const &other)
+    : HDF5GroupBase ()
+  {
+    init ();
+    copy (other);
+  }
+  
   // ============================================================================
   //
   //  Destruction
@@ -123,6 +173,7 @@ namespace DAL {  // Namespace DAL -- begin
   
   void TBB_DipoleDataset::destroy ()
   {
+    HDF5IOExecutor::Lock lock;
     herr_t h5error;
 
     if (datatype_p>0 && H5Iis_valid(datatype_p)) {
@@ -165,14 +216,55 @@ namespace DAL {  // Namespace DAL -- begin
   /*!
     \param other -- Another TBB_DipoleDataset object from which to create
            this new one.
+
+    If \e other has been opened, the identifiers of the dataset, its datatype
+    and its dataspace are shared with it (see HDF5Object::share) rather than
+    the dataset being opened once more through the file.
   */
   void TBB_DipoleDataset::copy (TBB_DipoleDataset const &other)
   {
-    location_p  = other.location_p;
-    datatype_p  = other.datatype_p;
-    dataspace_p = other.dataspace_p;
-
-    open (other.location_p);
+    itsFilters      = other.itsFilters;
+    itsChunkPlanner = other.itsChunkPlanner;
+    itsLinkLocation = other.itsLinkLocation;
+    itsLinkName     = other.itsLinkName;
+    itsLinkFlags    = other.itsLinkFlags;
+    itsShape        = other.itsShape;
+
+    if (other.isOpen()) {
+      location_p   = HDF5Object::share (other.location_p);
+      datatype_p   = HDF5Object::share (other.datatype_p);
+      dataspace_p  = HDF5Object::share (other.dataspace_p);
+      attributes_p = other.attributes_p;
+      itsGroupType = other.itsGroupType;
+      itsFlags     = other.itsFlags;
+      /* The other object remains responsible for writing its modifications */
+      itsAttributeCache = other.itsAttributeCache;
+      itsAttributeCache.resetModified();
+    } else {
+      location_p  = -1;
+      datatype_p  = -1;
+      dataspace_p = -1;
+    }
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                         swap
+  
+  /*!
+    \param other -- Another TBB_DipoleDataset object with which to exchange
+           contents, including the link to a dataset not yet opened.
+  */
+  void TBB_DipoleDataset::swap (TBB_DipoleDataset &other)
+  {
+    HDF5GroupBase::swap (other);
+    std::swap (datatype_p,  other.datatype_p);
+    std::swap (dataspace_p, other.dataspace_p);
+    itsShape.swap (other.itsShape);
+    std::swap (itsFilters,      other.itsFilters);
+    std::swap (itsChunkPlanner, other.itsChunkPlanner);
+    std::swap (itsLinkLocation, other.itsLinkLocation);
+    itsLinkName.swap (other.itsLinkName);
+    std::swap (itsLinkFlags,    other.itsLinkFlags);
   }
   
   // ============================================================================
@@ -190,6 +282,11 @@ namespace DAL {  // Namespace DAL -- begin
     dataspace_p = -1;
     location_p  = -1;
     itsShape     = std::vector<hsize_t>();
+    itsFilters   = HDF5FilterPipeline();
+    itsChunkPlanner = HDF5ChunkPlanner (HDF5ChunkPlanner::TimeSeries);
+    itsLinkLocation = -1;
+    itsLinkName     = "";
+    itsLinkFlags    = IO_Mode(IO_Mode::Open);
   }
 
   //_____________________________________________________________________________
@@ -262,6 +359,53 @@ namespace DAL {  // Namespace DAL -- begin
     attributes_p.insert("ANTENNA_ORIENTATION_FRAME");
   }
 
+  //_____________________________________________________________________________
+  //                                                                      setLink
+  
+  /*!
+    Nothing is read from the file until the dataset is opened through
+    openLink(), which e.g. allows a TBB_StationGroup to register all its
+    dipoles at the cost of listing the names of the datasets.
+
+    \param location -- Identifier for the location within the HDF5 file, below
+           which the dataset is placed; has to stay valid until the dataset
+           has been opened.
+    \param name     -- Name of the dataset.
+    \param flags    -- I/O mode flags used when opening the dataset.
+  */
+  void TBB_DipoleDataset::setLink (hid_t const &location,
+				   std::string const &name,
+				   IO_Mode const &flags)
+  {
+    destroy ();
+
+    location_p      = -1;
+    itsLinkLocation = location;
+    itsLinkName     = name;
+    itsLinkFlags    = flags;
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                     openLink
+  
+  /*!
+    \return status -- Returns \e true if the dataset is open, either already
+            before or after opening it from the link registered through
+            setLink().
+  */
+  bool TBB_DipoleDataset::openLink ()
+  {
+    if (isOpen()) {
+      return true;
+    }
+
+    if (itsLinkName.empty() || !H5Iis_valid(itsLinkLocation)) {
+      return false;
+    }
+
+    return open (itsLinkLocation, itsLinkName, itsLinkFlags) && isOpen();
+  }
+
   //_____________________________________________________________________________
   //                                                                         open
   
@@ -372,14 +516,30 @@ namespace DAL {  // Namespace DAL -- begin
           dimensions[n] = itsShape[n];
         }
         dataspace_p = H5Screate_simple (rank,dimensions,NULL);
+        /* Filters require a chunked layout */
+        hid_t creationProperties = H5P_DEFAULT;
+        if (!itsFilters.isEmpty() && rank > 0) {
+          std::vector<hsize_t> chunk = itsChunkPlanner.chunkShape (itsShape,
+                                                                   H5Tget_size(datatype_p));
+          hsize_t chunkdims [rank];
+          for (int n(0); n<rank; ++n) {
+            chunkdims[n] = chunk[n];
+          }
+          creationProperties = H5Pcreate (H5P_DATASET_CREATE);
+          H5Pset_chunk (creationProperties, rank, chunkdims);
+          itsFilters.apply (creationProperties);
+        }
         /* Create the dataset */
         location_p = H5Dcreate (location,
             name.c_str(),
             datatype_p,
             dataspace_p,
             H5P_DEFAULT,
-            H5P_DEFAULT,
+            creationProperties,
             H5P_DEFAULT);
+        if (creationProperties != H5P_DEFAULT) {
+          H5Pclose (creationProperties);
+        }
         /* If creation was sucessful, add attributes with default values */
         if (location_p > 0) {
           std::string grouptype ("DipoleDataset");
@@ -405,6 +565,7 @@ namespace DAL {  // Namespace DAL -- begin
           HDF5Attribute::write (location_p,"ANTENNA_ORIENTATION_VALUE", vectDouble  );
           HDF5Attribute::write (location_p,"ANTENNA_ORIENTATION_UNIT",  vectString  );
           HDF5Attribute::write (location_p,"ANTENNA_ORIENTATION_FRAME", undefined   );
+          itsAttributeCache.invalidate();
         } else {
 #ifdef DAL_DEBUGGING_MESSAGES
           std::cerr << "[TBB_DipoleDataset::open] Failed to create group "
@@ -522,6 +683,8 @@ namespace DAL {  // Namespace DAL -- begin
     os << "-- Dataspace ID ............ = " << dataspace_p    << std::endl;
     os << "-- Dataset datatype ........ = " << datatype_p     << std::endl;
     os << "-- Data array shape ........ = " << itsShape       << std::endl;
+    os << "-- Compression ............. = " << HDF5FilterPipeline::name(itsFilters.compression()) << std::endl;
+    os << "-- Chunk planner ........... = " << HDF5ChunkPlanner::name(itsChunkPlanner.pattern()) << std::endl;
     
     if (location_p>0) {
       /*
@@ -680,6 +843,70 @@ namespace DAL {  // Namespace DAL -- begin
     
     return id;
   }
+
+  //_____________________________________________________________________________
+  //                                                               convertSamples
+
+  /*!
+    \param samples    -- ADC samples.
+    \param nofSamples -- Number of samples to convert.
+    \retval data      -- Array of at least \e nofSamples elements, to which the
+            converted samples are written.
+  */
+  void TBB_DipoleDataset::convertSamples (short const *samples,
+					  size_t const &nofSamples,
+					  float *data)
+  {
+    size_t n = 0;
+
+#ifdef __SSE2__
+    for (; n+8<=nofSamples; n+=8) {
+      __m128i v  = _mm_loadu_si128 ((__m128i const *)(samples+n));
+      /* Sign-extend to 32 bit by shifting the interleaved copies back down */
+      __m128i lo = _mm_srai_epi32 (_mm_unpacklo_epi16 (v, v), 16);
+      __m128i hi = _mm_srai_epi32 (_mm_unpackhi_epi16 (v, v), 16);
+      _mm_storeu_ps (data+n,   _mm_cvtepi32_ps (lo));
+      _mm_storeu_ps (data+n+4, _mm_cvtepi32_ps (hi));
+    }
+#endif
+
+    for (; n<nofSamples; ++n) {
+      data[n] = samples[n];
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                               convertSamples
+
+  /*!
+    \param samples    -- ADC samples.
+    \param nofSamples -- Number of samples to convert.
+    \retval data      -- Array of at least \e nofSamples elements, to which the
+            converted samples are written.
+  */
+  void TBB_DipoleDataset::convertSamples (short const *samples,
+					  size_t const &nofSamples,
+					  double *data)
+  {
+    size_t n = 0;
+
+#ifdef __SSE2__
+    for (; n+8<=nofSamples; n+=8) {
+      __m128i v  = _mm_loadu_si128 ((__m128i const *)(samples+n));
+      __m128i lo = _mm_srai_epi32 (_mm_unpacklo_epi16 (v, v), 16);
+      __m128i hi = _mm_srai_epi32 (_mm_unpackhi_epi16 (v, v), 16);
+      /* Each conversion takes the lower two integers of its argument */
+      _mm_storeu_pd (data+n,   _mm_cvtepi32_pd (lo));
+      _mm_storeu_pd (data+n+2, _mm_cvtepi32_pd (_mm_unpackhi_epi64 (lo, lo)));
+      _mm_storeu_pd (data+n+4, _mm_cvtepi32_pd (hi));
+      _mm_storeu_pd (data+n+6, _mm_cvtepi32_pd (_mm_unpackhi_epi64 (hi, hi)));
+    }
+#endif
+
+    for (; n<nofSamples; ++n) {
+      data[n] = samples[n];
+    }
+  }
   
   //_____________________________________________________________________________
   //                                                                    julianDay
@@ -742,6 +969,7 @@ namespace DAL {  // Namespace DAL -- begin
 				    short *data)
   {
     bool status (true);
+    HDF5IOExecutor::Lock lock;
 
     //______________________________________________________
     // Set up the logic for secure access to the underlying data
@@ -876,6 +1104,53 @@ namespace DAL {  // Namespace DAL -- begin
     return status;
   }
   
+  //_____________________________________________________________________________
+  //                                                                readDataAsync
+
+  /*!
+    Samples requested before the start of the dataset are set to zero, the
+    remaining ones are read by the HDF5IOExecutor, such that the caller can
+    carry on while the data are being read.
+
+    \param start      -- Number of the sample at which to start reading
+    \param nofSamples -- Number of samples to read, starting from the position
+           given by <tt>start</tt>.
+    \retval data       -- [nofSamples] Array with the raw ADC samples
+            representing the electric field strength as function of time; it
+            has to stay valid until the request has been carried out.
+
+    \return future -- Completion state of the request; the future is ready
+            right away, with status \e false, if the dataset is not open or
+            none of the requested samples lies within the dataset.
+  */
+  HDF5Future TBB_DipoleDataset::readDataAsync (int const &start,
+					       int const &nofSamples,
+					       short *data)
+  {
+    int dataOffset = (start<0) ? -start : 0;
+
+    if (location_p <= 0 || nofSamples <= dataOffset) {
+      cerr << "[TBB_DipoleDataset::readDataAsync]"
+	   << " Dataset not open, or no samples within the requested range!"
+	   << endl;
+      return HDF5Future (false);
+    }
+
+    /* Zero out the data array (note zeros can thus be either real or unread samples) */
+    for (int n(0); n<nofSamples; ++n) {
+      data[n] = 0;
+    }
+
+    std::vector<hsize_t> offset (1, start+dataOffset);
+    std::vector<hsize_t> block (1, nofSamples-dataOffset);
+
+    return HDF5IOExecutor::instance().read (location_p,
+					    H5T_NATIVE_SHORT,
+					    offset,
+					    block,
+					    data+dataOffset);
+  }
+  
   // ============================================================================
   //
   //  Methods using casacore
@@ -921,9 +1196,9 @@ namespace DAL {  // Namespace DAL -- begin
       value.push_back(static_cast<double>(pos.getValue()(1)));
       value.push_back(static_cast<double>(pos.getValue()(2)));
 
-      HDF5Attribute::write (location_p,"ANTENNA_POSITION_VALUE", value);
-      HDF5Attribute::write (location_p,"ANTENNA_POSITION_UNIT", std::vector<std::string>(3, unit));
-      HDF5Attribute::write (location_p,"ANTENNA_POSITION_FRAME", frame);
+      setAttribute ("ANTENNA_POSITION_VALUE", value);
+      setAttribute ("ANTENNA_POSITION_UNIT", std::vector<std::string>(3, unit));
+      setAttribute ("ANTENNA_POSITION_FRAME", frame);
     } else {
 #ifdef DAL_DEBUGGING_MESSAGES
       std::cerr << "[TBB_DipoleDataset::set_antenna_position] Failed to write to group." << std::endl;
@@ -34,6 +34,9 @@
 #endif
 
 #include <data_common/HDF5GroupBase.h>
+#include <core/HDF5FilterPipeline.h>
+#include <core/HDF5ChunkPlanner.h>
+#include <core/HDF5IOExecutor.h>
 
 namespace DAL {  // Namespace DAL -- begin
 
@@ -97,6 +100,16 @@ namespace DAL {  // Namespace DAL -- begin
     hid_t dataspace_p;
     //! Shape of the dataset
     std::vector<hsize_t> itsShape;
+    //! Filters applied to the chunks upon creation of the dataset
+    HDF5FilterPipeline itsFilters;
+    //! Planner for the chunk shape of a filtered dataset
+    HDF5ChunkPlanner itsChunkPlanner;
+    //! Location of a dataset to be opened on first use
+    hid_t itsLinkLocation;
+    //! Name of a dataset to be opened on first use
+    std::string itsLinkName;
+    //! I/O mode flags for a dataset to be opened on first use
+    IO_Mode itsLinkFlags;
     
   public:
 
@@ -120,6 +133,16 @@ namespace DAL {  // Namespace DAL -- begin
 		       uint const &rcuID,
 		       std::vector<hsize_t> const &shape,
 		       hid_t const &datatype=H5T_NATIVE_SHORT);
+    //! Argumented constructor, creating a dataset with filters
+    TBB_DipoleDataset (hid_t const &location,
+		       uint const &stationID,
+		       uint const &rspID,
+		       uint const &rcuID,
+		       std::vector<hsize_t> const &shape,
+		       HDF5FilterPipeline const &filters,
+		       hid_t const &datatype=H5T_NATIVE_SHORT);
+    //! Copy constructor
+    TBB_DipoleDataset (TBB_DipoleDataset const &other);
     
     // === Destruction ==========================================================
     
@@ -130,6 +153,9 @@ namespace DAL {  // Namespace DAL -- begin
     
     //! Overloading of the copy operator
     TBB_DipoleDataset& operator= (TBB_DipoleDataset const &other);
+
+    //! Exchange the contents with another object, without copying
+    void swap (TBB_DipoleDataset &other);
     
     // === Parameter access =====================================================
 
@@ -143,6 +169,43 @@ namespace DAL {  // Namespace DAL -- begin
       return itsShape;
     }
 
+    //! Is the dataset open?
+    inline bool isOpen () const {
+      return location_p > 0;
+    }
+
+    //! Get the filters applied to the chunks upon creation of the dataset
+    inline HDF5FilterPipeline filters () const {
+      return itsFilters;
+    }
+
+    /*!
+      \brief Set the filters applied to the chunks upon creation of the dataset
+
+      \param filters -- Filter pipeline used when a new dataset is created;
+             the dataset then is stored in chunks (see setChunkPlanner())
+             instead of contiguously.
+    */
+    inline void setFilters (HDF5FilterPipeline const &filters) {
+      itsFilters = filters;
+    }
+
+    //! Get the planner for the chunk shape of a filtered dataset
+    inline HDF5ChunkPlanner chunkPlanner () const {
+      return itsChunkPlanner;
+    }
+
+    /*!
+      \brief Set the planner for the chunk shape of a filtered dataset
+
+      \param planner -- Planner used when a new dataset with filters is
+             created; by default the chunks extend along the time axis up to
+             HDF5ChunkPlanner::defaultTargetBytes.
+    */
+    inline void setChunkPlanner (HDF5ChunkPlanner const &planner) {
+      itsChunkPlanner = planner;
+    }
+
     //! Get the time as Julian Day
     double julianDay (bool const &onlySeconds=false);
     
@@ -175,6 +238,12 @@ namespace DAL {  // Namespace DAL -- begin
 	       uint const &rcuID,
 	       std::vector<hsize_t> const &shape,
 	       hid_t const &datatype=H5T_NATIVE_SHORT);
+    //! Register a dataset to be opened on first use
+    void setLink (hid_t const &location,
+		  std::string const &name,
+		  IO_Mode const &flags=IO_Mode(IO_Mode::Open));
+    //! Open the dataset registered through setLink(), unless already open
+    bool openLink ();
     //! Get the unique channel/dipole identifier
     int dipoleNumber ();
     //! Get the unique channel/dipole identifier
@@ -187,10 +256,22 @@ namespace DAL {  // Namespace DAL -- begin
     static std::string dipoleName (unsigned int const &station,
 				   unsigned int const &rsp,
 				   unsigned int const &rcu);
+    //! Convert ADC samples to single precision
+    static void convertSamples (short const *samples,
+				size_t const &nofSamples,
+				float *data);
+    //! Convert ADC samples to double precision
+    static void convertSamples (short const *samples,
+				size_t const &nofSamples,
+				double *data);
     //! Get a number of data values as recorded for this dipole
     bool readData (int const &start,
 		   int const &nofSamples,
 		   short *data);
+    //! Get a number of data values, leaving the reading to the I/O executor
+    HDF5Future readDataAsync (int const &start,
+			      int const &nofSamples,
+			      short *data);
     
     //! Get a number of data values as recorded for this dipole
     /*     bool readData (int const &start, */
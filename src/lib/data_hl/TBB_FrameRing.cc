@@ -0,0 +1,414 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <data_hl/TBB_FrameRing.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace DAL { // Namespace DAL -- begin
+
+  // ============================================================================
+  //
+  //  TBB_FrameSignal
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                              TBB_FrameSignal
+
+  TBB_FrameSignal::TBB_FrameSignal ()
+  {
+    itsSequence = 0;
+    itsSleeping = 0;
+    pthread_mutex_init (&itsMutex, NULL);
+    pthread_cond_init (&itsCondition, NULL);
+  }
+
+  //_____________________________________________________________________________
+  //                                                             ~TBB_FrameSignal
+
+  TBB_FrameSignal::~TBB_FrameSignal ()
+  {
+    pthread_cond_destroy (&itsCondition);
+    pthread_mutex_destroy (&itsMutex);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       notify
+
+  void TBB_FrameSignal::notify ()
+  {
+    /* Full barrier: the increment must be visible before we look at the
+       sleeping flag, mirroring the order of operations in wait(). */
+    __sync_fetch_and_add (&itsSequence, 1);
+
+    if (itsSleeping) {
+      pthread_mutex_lock (&itsMutex);
+      pthread_cond_broadcast (&itsCondition);
+      pthread_mutex_unlock (&itsMutex);
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         wait
+
+  bool TBB_FrameSignal::wait (unsigned long const &sequence,
+			      double const &timeout)
+  {
+    bool woken = true;
+    struct timeval now;
+    struct timespec deadline;
+
+    gettimeofday (&now, NULL);
+    deadline.tv_sec  = now.tv_sec + (time_t)timeout;
+    deadline.tv_nsec = now.tv_usec*1000 + (long)((timeout-(time_t)timeout)*1e9);
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec  += 1;
+      deadline.tv_nsec -= 1000000000L;
+    }
+
+    __sync_fetch_and_add (&itsSleeping, 1);
+
+    pthread_mutex_lock (&itsMutex);
+    while (itsSequence == sequence) {
+      if (pthread_cond_timedwait (&itsCondition, &itsMutex, &deadline) == ETIMEDOUT) {
+	woken = (itsSequence != sequence);
+	break;
+      }
+    }
+    pthread_mutex_unlock (&itsMutex);
+
+    __sync_fetch_and_sub (&itsSleeping, 1);
+
+    return woken;
+  }
+
+  // ============================================================================
+  //
+  //  TBB_FrameRing
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                TBB_FrameRing
+
+  /*!
+    \param nofSlots -- Number of frames the ring can hold.
+    \param slotSize -- Size of a single slot, [Bytes]; this should be at least
+           one byte larger than the largest expected datagram, such that
+           truncated datagrams can be recognized.
+    \param signal   -- Signal to notify when a frame is published; pass the
+           same signal to several rings to have a single consumer wait on all
+           of them. If none is provided, the ring creates its own.
+  */
+  TBB_FrameRing::TBB_FrameRing (unsigned int const &nofSlots,
+				unsigned int const &slotSize,
+				TBB_FrameSignal *signal)
+  {
+    itsNofSlots   = nofSlots > 0 ? nofSlots : 1;
+    itsSlotSize   = slotSize;
+    itsBuffer     = new char [(itsNofSlots+1)*itsSlotSize];
+    itsFrameSize  = new int [itsNofSlots];
+    itsScratch    = false;
+    itsWriteCount = 0;
+    itsNofDropped = 0;
+    itsNofFull    = 0;
+    itsNofBatches = 0;
+    itsMaxBatch   = 0;
+    itsReadCount  = 0;
+    itsMaxFill    = 0;
+
+    if (signal == NULL) {
+      itsSignal    = new TBB_FrameSignal();
+      itsOwnSignal = true;
+    } else {
+      itsSignal    = signal;
+      itsOwnSignal = false;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                               ~TBB_FrameRing
+
+  TBB_FrameRing::~TBB_FrameRing ()
+  {
+    delete [] itsBuffer;
+    delete [] itsFrameSize;
+    if (itsOwnSignal) {
+      delete itsSignal;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  void TBB_FrameRing::summary (std::ostream &os)
+  {
+    os << "[TBB_FrameRing] Summary of internal parameters." << std::endl;
+    os << "-- nof. slots ................... : " << itsNofSlots   << std::endl;
+    os << "-- Slot size [Bytes] ............ : " << itsSlotSize   << std::endl;
+    os << "-- nof. frames published ........ : " << itsWriteCount << std::endl;
+    os << "-- nof. frames released ......... : " << itsReadCount  << std::endl;
+    os << "-- nof. frames dropped .......... : " << itsNofDropped << std::endl;
+    os << "-- nof. times ring was full ..... : " << itsNofFull    << std::endl;
+    os << "-- Max. nof. frames waiting ..... : " << itsMaxFill    << std::endl;
+    os << "-- nof. receive batches ......... : " << itsNofBatches << std::endl;
+    os << "-- Max. nof. frames per batch ... : " << itsMaxBatch   << std::endl;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    writeSlot
+
+  /*!
+    \return slot -- Pointer to a buffer of slotSize() bytes. If the ring is
+            full this is a scratch buffer, the contents of which will be
+            discarded by commit().
+  */
+  char * TBB_FrameRing::writeSlot ()
+  {
+    __sync_synchronize();
+    itsScratch = (itsWriteCount-itsReadCount >= itsNofSlots);
+
+    if (itsScratch) {
+      ++itsNofFull;
+      return itsBuffer + (unsigned long)itsNofSlots*itsSlotSize;
+    } else {
+      return itsBuffer + (itsWriteCount%itsNofSlots)*itsSlotSize;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       commit
+
+  /*!
+    \param nofBytes -- Number of valid bytes written into the slot.
+  */
+  void TBB_FrameRing::commit (int const &nofBytes)
+  {
+    if (itsScratch) {
+      ++itsNofDropped;
+      return;
+    }
+
+    itsFrameSize[itsWriteCount%itsNofSlots] = nofBytes;
+    /* Make the contents of the slot visible before publishing it */
+    __sync_synchronize();
+    itsWriteCount = itsWriteCount+1;
+
+    itsSignal->notify();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      receive
+
+  /*!
+    \param socket    -- Socket to read the datagrams from; the call does not
+           block, so this is typically called after a <tt>select()</tt>.
+    \param batchSize -- Maximum number of datagrams to read in one go; capped
+           at TBB_FRAMERING_MAX_BATCH.
+
+    \return nofFrames -- The number of datagrams taken off the socket (including
+            the ones dropped because the ring was full), 0 if no datagram was
+            waiting, or -1 in case of an error.
+  */
+  int TBB_FrameRing::receive (int const &socket,
+			      unsigned int const &batchSize)
+  {
+    unsigned int nofFree;
+    unsigned int nofMsgs = batchSize;
+    char *scratch        = itsBuffer + (unsigned long)itsNofSlots*itsSlotSize;
+    int nofFrames        = 0;
+
+    if (nofMsgs < 1) {
+      nofMsgs = 1;
+    } else if (nofMsgs > TBB_FRAMERING_MAX_BATCH) {
+      nofMsgs = TBB_FRAMERING_MAX_BATCH;
+    }
+
+    __sync_synchronize();
+    nofFree = itsNofSlots - (unsigned int)(itsWriteCount-itsReadCount);
+
+    /* If the ring is full we still drain the socket, all into the scratch slot */
+    if (nofFree == 0) {
+      ++itsNofFull;
+    } else if (nofFree < nofMsgs) {
+      nofMsgs = nofFree;
+    }
+
+#ifdef __linux__
+    struct mmsghdr msgs[TBB_FRAMERING_MAX_BATCH];
+    struct iovec iovecs[TBB_FRAMERING_MAX_BATCH];
+
+    memset (msgs, 0, nofMsgs*sizeof(struct mmsghdr));
+    for (unsigned int n=0; n<nofMsgs; ++n) {
+      iovecs[n].iov_base = (nofFree == 0) ? scratch
+	: itsBuffer + ((itsWriteCount+n)%itsNofSlots)*itsSlotSize;
+      iovecs[n].iov_len  = itsSlotSize;
+      msgs[n].msg_hdr.msg_iov    = &iovecs[n];
+      msgs[n].msg_hdr.msg_iovlen = 1;
+    }
+
+    nofFrames = recvmmsg (socket, msgs, nofMsgs, MSG_DONTWAIT, NULL);
+
+    if (nofFrames < 0) {
+      return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+    if (nofFree > 0) {
+      for (int n=0; n<nofFrames; ++n) {
+	itsFrameSize[(itsWriteCount+n)%itsNofSlots] = msgs[n].msg_len;
+      }
+    }
+#else
+    ssize_t nofBytes;
+
+    for (; nofFrames<(int)nofMsgs; ++nofFrames) {
+      char *slot = (nofFree == 0) ? scratch
+	: itsBuffer + ((itsWriteCount+nofFrames)%itsNofSlots)*itsSlotSize;
+      nofBytes = recv (socket, slot, itsSlotSize, MSG_DONTWAIT);
+      if (nofBytes < 0) {
+	if (nofFrames == 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+	  return -1;
+	}
+	break;
+      }
+      if (nofFree > 0) {
+	itsFrameSize[(itsWriteCount+nofFrames)%itsNofSlots] = nofBytes;
+      }
+    }
+#endif
+
+    if (nofFrames == 0) {
+      return 0;
+    }
+
+    ++itsNofBatches;
+    if ((unsigned long)nofFrames > itsMaxBatch) {
+      itsMaxBatch = nofFrames;
+    }
+
+    if (nofFree == 0) {
+      itsNofDropped += nofFrames;
+    } else {
+      /* Publish the whole batch at once */
+      __sync_synchronize();
+      itsWriteCount = itsWriteCount+nofFrames;
+      itsSignal->notify();
+    }
+
+    return nofFrames;
+  }
+
+  //_____________________________________________________________________________
+  //                                                         setReceiveBufferSize
+
+  /*!
+    \param socket   -- Socket for which to set the receive buffer size.
+    \param nofBytes -- Requested size of the receive buffer, [Bytes]. Beyond
+           <tt>net.core.rmem_max</tt> this requires the CAP_NET_ADMIN
+           capability; otherwise the size gets capped by the kernel.
+
+    \return nofBytes -- The effective size of the receive buffer as reported by
+            the kernel, or -1 in case of an error.
+  */
+  int TBB_FrameRing::setReceiveBufferSize (int const &socket,
+					   int const &nofBytes)
+  {
+    int size         = nofBytes;
+    socklen_t length = sizeof(size);
+
+#ifdef SO_RCVBUFFORCE
+    if (setsockopt (socket, SOL_SOCKET, SO_RCVBUFFORCE, &size, length) < 0)
+#endif
+      {
+	if (setsockopt (socket, SOL_SOCKET, SO_RCVBUF, &size, length) < 0) {
+	  return -1;
+	}
+      }
+
+    if (getsockopt (socket, SOL_SOCKET, SO_RCVBUF, &size, &length) < 0) {
+      return -1;
+    }
+
+    return size;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     readSlot
+
+  /*!
+    \retval nofBytes -- Number of valid bytes in the frame.
+
+    \return frame -- Pointer to the frame, or \e NULL if the ring is empty. The
+            slot remains owned by the consumer until release() is called.
+  */
+  char * TBB_FrameRing::readSlot (int &nofBytes)
+  {
+    unsigned long nofWaiting = fill();
+
+    if (nofWaiting == 0) {
+      nofBytes = 0;
+      return NULL;
+    }
+
+    if (nofWaiting > itsMaxFill) {
+      itsMaxFill = nofWaiting;
+    }
+
+    unsigned long slot = itsReadCount%itsNofSlots;
+    nofBytes = itsFrameSize[slot];
+    return itsBuffer + slot*itsSlotSize;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      release
+
+  void TBB_FrameRing::release ()
+  {
+    /* We must be done with the contents before the slot is handed back */
+    __sync_synchronize();
+    itsReadCount = itsReadCount+1;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 waitForFrame
+
+  /*!
+    \param timeout -- Maximum time to block, [sec].
+
+    \return available -- Returns \e true if a frame is available for reading.
+  */
+  bool TBB_FrameRing::waitForFrame (double const &timeout)
+  {
+    unsigned long sequence = itsSignal->sequence();
+
+    if (empty()) {
+      itsSignal->wait (sequence, timeout);
+    }
+
+    return !empty();
+  }
+
+} // Namespace DAL -- end
@@ -0,0 +1,321 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TBB_FRAMERING_H
+#define TBB_FRAMERING_H
+
+// Standard library header files
+#include <iostream>
+#include <pthread.h>
+
+//! Maximum number of datagrams pulled from a socket by a single receive() call
+#define TBB_FRAMERING_MAX_BATCH 256
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class TBB_FrameSignal
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Wake-up call for a consumer waiting on one or more frame rings
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tTBB_FrameRing.cc
+
+    <h3>Synopsis</h3>
+
+    Producers bump a sequence counter for every frame they publish; the mutex
+    and condition variable are only touched if the consumer actually went to
+    sleep, so the fast path of a busy ring is free of locks. A consumer reads
+    the sequence counter \e before inspecting its rings and passes it on to
+    wait(), which returns immediately if anything has been published since.
+  */
+  class TBB_FrameSignal {
+
+    //! Number of frames published so far
+    volatile unsigned long itsSequence;
+    //! Is the consumer about to block or blocking?
+    volatile int itsSleeping;
+    //! Mutex protecting the condition variable
+    pthread_mutex_t itsMutex;
+    //! Condition variable the consumer is blocking on
+    pthread_cond_t itsCondition;
+
+    //! Disabled copy constructor
+    TBB_FrameSignal (TBB_FrameSignal const &other);
+    //! Disabled assignment operator
+    TBB_FrameSignal& operator= (TBB_FrameSignal const &other);
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor
+    TBB_FrameSignal ();
+
+    // === Destruction ==========================================================
+
+    //! Destructor
+    ~TBB_FrameSignal ();
+
+    // === Methods ==============================================================
+
+    //! Get the current value of the sequence counter
+    inline unsigned long sequence () const {
+      __sync_synchronize();
+      return itsSequence;
+    }
+
+    //! Signal that a frame was published (or that the consumer should wake up)
+    void notify ();
+
+    /*!
+      \brief Block until notify() was called after \e sequence was taken
+
+      \param sequence -- Value of the sequence counter taken before the
+             consumer checked its rings for data.
+      \param timeout  -- Maximum time to block, [sec].
+
+      \return woken -- Returns \e true if woken up by a producer, \e false if
+              the time-out ran out.
+    */
+    bool wait (unsigned long const &sequence,
+	       double const &timeout);
+
+  }; // Class TBB_FrameSignal -- end
+
+  /*!
+    \class TBB_FrameRing
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Lock-free single-producer/single-consumer ring of raw data frames
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tTBB_FrameRing.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::TBBraw
+      <li>DAL::TBB_FrameSignal
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    Hands UDP datagrams from a socket reader thread over to the thread
+    processing them. The frames are received directly into the slots of the
+    ring, so no copy is made on either side; the only shared state are the
+    read and write counters, which are kept on separate cache lines.
+
+    If the consumer does not keep up, writeSlot() hands out a scratch slot,
+    which gets discarded (and counted in nofDropped()) by commit(), so the
+    socket still gets drained. The fill level high-water mark (maxFill()) and
+    the number of times the ring was found to be full (nofFull()) provide the
+    back-pressure statistics.
+
+    Instead of calling writeSlot()/commit() for every datagram, receive() pulls
+    up to a batch of datagrams off a socket with a single system call
+    (<tt>recvmmsg</tt>, where available) straight into the free slots and
+    publishes them in one go; nofBatches() and maxBatch() keep track of how
+    well the batching works out.
+
+    <h3>Example(s)</h3>
+
+    Producer thread:
+    \code
+    char *slot = ring.writeSlot();
+    int nofBytes = recvfrom (socket, slot, ring.slotSize(), 0, NULL, NULL);
+    if (nofBytes > 0) {
+      ring.commit (nofBytes);
+    }
+    \endcode
+
+    Producer thread, batched ingest of up to 64 datagrams per system call:
+    \code
+    TBB_FrameRing::setReceiveBufferSize (socket, 64*1024*1024);
+
+    while (select (socket+1, &readSet, NULL, NULL, &timeout) > 0) {
+      ring.receive (socket, 64);
+    }
+    \endcode
+
+    Consumer thread:
+    \code
+    int nofBytes;
+    char *frame;
+
+    while ((frame = ring.readSlot(nofBytes))) {
+      tbb.processTBBrawBlock (frame, nofBytes);
+      ring.release();
+    }
+    \endcode
+  */
+  class TBB_FrameRing {
+
+    //! Number of slots in the ring
+    unsigned int itsNofSlots;
+    //! Size of a single slot, [Bytes]
+    unsigned int itsSlotSize;
+    //! Storage for the slots, followed by the scratch slot
+    char *itsBuffer;
+    //! Number of valid bytes in each slot
+    int *itsFrameSize;
+    //! Signal to notify when publishing a frame
+    TBB_FrameSignal *itsSignal;
+    //! Did the ring create its own signal?
+    bool itsOwnSignal;
+    //! Is the slot handed out by writeSlot() the scratch slot?
+    bool itsScratch;
+    //! Padding to keep the write counter on its own cache line
+    char itsPad0[64];
+    //! Number of frames published by the producer
+    volatile unsigned long itsWriteCount;
+    //! Number of frames dropped because the ring was full
+    unsigned long itsNofDropped;
+    //! Number of calls to writeSlot() finding the ring full
+    unsigned long itsNofFull;
+    //! Number of batches taken in by receive()
+    unsigned long itsNofBatches;
+    //! Largest number of datagrams taken in by a single call to receive()
+    unsigned long itsMaxBatch;
+    //! Padding to keep the read counter on its own cache line
+    char itsPad1[64];
+    //! Number of frames released by the consumer
+    volatile unsigned long itsReadCount;
+    //! Maximum number of frames found waiting by the consumer
+    unsigned long itsMaxFill;
+    //! Padding following the read counter
+    char itsPad2[64];
+
+    //! Disabled copy constructor
+    TBB_FrameRing (TBB_FrameRing const &other);
+    //! Disabled assignment operator
+    TBB_FrameRing& operator= (TBB_FrameRing const &other);
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Argumented constructor
+    TBB_FrameRing (unsigned int const &nofSlots,
+		   unsigned int const &slotSize,
+		   TBB_FrameSignal *signal=NULL);
+
+    // === Destruction ==========================================================
+
+    //! Destructor
+    ~TBB_FrameRing ();
+
+    // === Parameter access =====================================================
+
+    //! Get the number of slots in the ring
+    inline unsigned int nofSlots () const {
+      return itsNofSlots;
+    }
+    //! Get the size of a single slot, [Bytes]
+    inline unsigned int slotSize () const {
+      return itsSlotSize;
+    }
+    //! Get the signal notified when a frame is published
+    inline TBB_FrameSignal* signal () const {
+      return itsSignal;
+    }
+    //! Get the number of frames currently waiting in the ring
+    inline unsigned long fill () const {
+      __sync_synchronize();
+      return itsWriteCount-itsReadCount;
+    }
+    //! Is the ring empty?
+    inline bool empty () const {
+      return fill() == 0;
+    }
+    //! Get the number of frames published by the producer
+    inline unsigned long nofFrames () const {
+      return itsWriteCount;
+    }
+    //! Get the number of frames dropped because the ring was full
+    inline unsigned long nofDropped () const {
+      return itsNofDropped;
+    }
+    //! Get the number of times the producer found the ring full
+    inline unsigned long nofFull () const {
+      return itsNofFull;
+    }
+    //! Get the maximum number of frames found waiting by the consumer
+    inline unsigned long maxFill () const {
+      return itsMaxFill;
+    }
+    //! Get the number of batches taken in by receive()
+    inline unsigned long nofBatches () const {
+      return itsNofBatches;
+    }
+    //! Get the largest number of datagrams taken in by one call to receive()
+    inline unsigned long maxBatch () const {
+      return itsMaxBatch;
+    }
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    // === Producer side ========================================================
+
+    //! Get the slot to receive the next frame into
+    char * writeSlot ();
+
+    //! Publish the frame in the slot obtained through writeSlot()
+    void commit (int const &nofBytes);
+
+    //! Receive a batch of datagrams from a socket directly into the ring
+    int receive (int const &socket,
+		 unsigned int const &batchSize=1);
+
+    //! Set the size of the kernel receive buffer of a socket
+    static int setReceiveBufferSize (int const &socket,
+				     int const &nofBytes);
+
+    // === Consumer side ========================================================
+
+    //! Get the oldest frame in the ring; returns NULL if the ring is empty
+    char * readSlot (int &nofBytes);
+
+    //! Hand the slot obtained through readSlot() back to the producer
+    void release ();
+
+    //! Block until a frame is available or the time-out ran out
+    bool waitForFrame (double const &timeout);
+
+  }; // Class TBB_FrameRing -- end
+
+} // Namespace DAL -- end
+
+#endif /* TBB_FRAMERING_H */
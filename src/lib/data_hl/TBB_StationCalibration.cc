@@ -175,6 +175,7 @@ namespace DAL { // Namespace DAL -- begin
 	  std::string grouptype ("StationGroup");
 	  // write the attributes
 	  HDF5Attribute::write (location_p,"GROUPTYPE", grouptype);
+	  itsAttributeCache.invalidate();
 	} else {
 	  std::cerr << "[TBB_StationCalibration::open] Failed to create group "
 		    << name
@@ -0,0 +1,734 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                  *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <data_hl/TBB_StationDataset.h>
+#include <data_hl/TBB_DipoleDataset.h>
+
+#include <cstring>
+#include <map>
+
+namespace DAL { // Namespace DAL -- begin
+
+  //! Number of slots of the chunk cache of a station dataset
+  static const size_t stationCacheSlots = 12421;
+
+  //_____________________________________________________________________________
+  //                                                             accessProperties
+
+  //! Property list for the access to the station dataset, setting the chunk cache
+  static hid_t accessProperties ()
+  {
+    /* Rows are written one by one, so a chunk is completed by several writes;
+       the cache has to hold the partially written chunks until then. Chunks
+       which have been written completely are evicted first. */
+    hid_t dapl = H5Pcreate (H5P_DATASET_ACCESS);
+    H5Pset_chunk_cache (dapl,
+			stationCacheSlots,
+			TBB_STATIONDATASET_CACHE_BYTES,
+			1.0);
+    return dapl;
+  }
+
+  // ============================================================================
+  //
+  //  Construction
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                           TBB_StationDataset
+
+  TBB_StationDataset::TBB_StationDataset ()
+  {
+    init ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                           TBB_StationDataset
+
+  /*!
+    \param location -- Identifier of the station group holding the dataset.
+  */
+  TBB_StationDataset::TBB_StationDataset (hid_t const &location)
+  {
+    init ();
+    open (location);
+  }
+
+  // ============================================================================
+  //
+  //  Destruction
+  //
+  // ============================================================================
+
+  TBB_StationDataset::~TBB_StationDataset ()
+  {
+    close ();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         init
+
+  void TBB_StationDataset::init ()
+  {
+    itsDataset    = -1;
+    itsTable      = -1;
+    itsDipoleType = -1;
+    itsShape      = std::vector<hsize_t> (2, 0);
+    itsChunking   = std::vector<hsize_t> (2, 0);
+    itsModified   = false;
+    itsDipoles.clear();
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        close
+
+  void TBB_StationDataset::close ()
+  {
+    flush ();
+
+    if (itsDataset > 0) {
+      H5Dclose (itsDataset);
+    }
+    if (itsTable > 0) {
+      H5Dclose (itsTable);
+    }
+    if (itsDipoleType > 0) {
+      H5Tclose (itsDipoleType);
+    }
+
+    init ();
+  }
+
+  // ============================================================================
+  //
+  //  Parameters
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                       dipole
+
+  /*!
+    \param row -- Row of the dataset.
+    \return dipole -- Metadata of the dipole; all fields are zero if \e row is
+            out of range.
+  */
+  TBB_StationDataset::Dipole TBB_StationDataset::dipole (unsigned int const &row) const
+  {
+    if (row < itsDipoles.size()) {
+      return itsDipoles[row];
+    } else {
+      Dipole empty;
+      memset (&empty, 0, sizeof(Dipole));
+      return empty;
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   dipoleName
+
+  /*!
+    \param row -- Row of the dataset.
+    \return name -- Name of the dipole, as used for the dipole datasets of
+            the default layout; empty if \e row is out of range.
+  */
+  std::string TBB_StationDataset::dipoleName (unsigned int const &row) const
+  {
+    if (row < itsDipoles.size()) {
+      return TBB_DipoleDataset::dipoleName (itsDipoles[row].stationID,
+					    itsDipoles[row].rspID,
+					    itsDipoles[row].rcuID);
+    } else {
+      return std::string();
+    }
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  dipoleNames
+
+  std::vector<std::string> TBB_StationDataset::dipoleNames () const
+  {
+    std::vector<std::string> names (itsDipoles.size());
+
+    for (unsigned int n=0; n<itsDipoles.size(); ++n) {
+      names[n] = dipoleName (n);
+    }
+
+    return names;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   findDipole
+
+  /*!
+    \param name -- Name of the dipole.
+    \return row -- Row holding the dipole; -1 if the dipole is not contained
+            within the dataset.
+  */
+  int TBB_StationDataset::findDipole (std::string const &name) const
+  {
+    for (unsigned int n=0; n<itsDipoles.size(); ++n) {
+      if (dipoleName(n) == name) {
+	return n;
+      }
+    }
+
+    return -1;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                      summary
+
+  void TBB_StationDataset::summary (std::ostream &os)
+  {
+    os << "[TBB_StationDataset] Summary of internal parameters." << std::endl;
+    os << "-- Dataset ID         = " << itsDataset           << std::endl;
+    os << "-- Table ID           = " << itsTable             << std::endl;
+    os << "-- nof. dipoles       = " << itsDipoles.size()    << std::endl;
+    os << "-- nof. samples       = " << nofSamples()         << std::endl;
+    os << "-- Chunk shape        = [" << itsChunking[0] << ","
+       << itsChunking[1] << "]" << std::endl;
+    os << "-- Table modified     = " << itsModified          << std::endl;
+  }
+
+  // ============================================================================
+  //
+  //  Methods
+  //
+  // ============================================================================
+
+  //_____________________________________________________________________________
+  //                                                                       exists
+
+  /*!
+    \param location -- Identifier of a station group.
+    \return exists -- Returns \e true if the group contains a station dataset.
+  */
+  bool TBB_StationDataset::exists (hid_t const &location)
+  {
+    return H5Lexists (location, getName().c_str(), H5P_DEFAULT) > 0
+      && H5Lexists (location, getTableName().c_str(), H5P_DEFAULT) > 0;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                   dipoleType
+
+  /*!
+    \return type -- Compound datatype of a row of the dipole table, matching
+            the layout of TBB_StationDataset::Dipole; to be released by the
+            caller.
+  */
+  hid_t TBB_StationDataset::dipoleType ()
+  {
+    hid_t type = H5Tcreate (H5T_COMPOUND, sizeof(Dipole));
+
+    H5Tinsert (type, "STATION_ID",             HOFFSET(Dipole, stationID),       H5T_NATIVE_UINT);
+    H5Tinsert (type, "RSP_ID",                 HOFFSET(Dipole, rspID),           H5T_NATIVE_UINT);
+    H5Tinsert (type, "RCU_ID",                 HOFFSET(Dipole, rcuID),           H5T_NATIVE_UINT);
+    H5Tinsert (type, "TIME",                   HOFFSET(Dipole, time),            H5T_NATIVE_UINT);
+    H5Tinsert (type, "SAMPLE_NUMBER",          HOFFSET(Dipole, sampleNumber),    H5T_NATIVE_UINT);
+    H5Tinsert (type, "SAMPLES_PER_FRAME",      HOFFSET(Dipole, samplesPerFrame), H5T_NATIVE_UINT);
+    H5Tinsert (type, "SAMPLE_FREQUENCY_VALUE", HOFFSET(Dipole, sampleFrequency), H5T_NATIVE_DOUBLE);
+    H5Tinsert (type, "DATA_LENGTH",            HOFFSET(Dipole, dataLength),      H5T_NATIVE_UINT);
+
+    return type;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    readShape
+
+  bool TBB_StationDataset::readShape ()
+  {
+    hsize_t dims[2];
+    hid_t space = H5Dget_space (itsDataset);
+    bool status = H5Sget_simple_extent_ndims (space) == 2
+      && H5Sget_simple_extent_dims (space, dims, NULL) == 2;
+
+    if (status) {
+      itsShape[0] = dims[0];
+      itsShape[1] = dims[1];
+    }
+
+    H5Sclose (space);
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         open
+
+  /*!
+    \param location -- Identifier of the station group holding the dataset.
+    \return status -- Returns \e false if the group does not contain a station
+            dataset, or if it could not be opened.
+  */
+  bool TBB_StationDataset::open (hid_t const &location)
+  {
+    close ();
+
+    if (!exists (location)) {
+      return false;
+    }
+
+    hid_t dapl    = accessProperties ();
+    itsDataset    = H5Dopen (location, getName().c_str(), dapl);
+    itsTable      = H5Dopen (location, getTableName().c_str(), H5P_DEFAULT);
+    itsDipoleType = dipoleType ();
+    H5Pclose (dapl);
+
+    if (itsDataset < 0 || itsTable < 0 || !readShape()) {
+      std::cerr << "[TBB_StationDataset::open] Failed to open the station dataset!"
+		<< std::endl;
+      close ();
+      return false;
+    }
+
+    /* Shape of the chunks */
+    hid_t dcpl = H5Dget_create_plist (itsDataset);
+    hsize_t chunk[2] = {0, 0};
+    if (H5Pget_layout (dcpl) == H5D_CHUNKED) {
+      H5Pget_chunk (dcpl, 2, chunk);
+    }
+    itsChunking[0] = chunk[0];
+    itsChunking[1] = chunk[1];
+    H5Pclose (dcpl);
+
+    /* Metadata of the dipoles; the columns are matched by name */
+    hsize_t nofRows = 0;
+    hid_t space = H5Dget_space (itsTable);
+    H5Sget_simple_extent_dims (space, &nofRows, NULL);
+    H5Sclose (space);
+
+    itsDipoles.resize (nofRows);
+    if (nofRows > 0
+	&& H5Dread (itsTable, itsDipoleType, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+		    &itsDipoles[0]) < 0) {
+      std::cerr << "[TBB_StationDataset::open] Failed to read the dipole table!"
+		<< std::endl;
+      close ();
+      return false;
+    }
+
+    if (nofRows != itsShape[0]) {
+      std::cerr << "[TBB_StationDataset::open] Dipole table does not match dataset: "
+		<< nofRows << " rows for " << itsShape[0] << " dipoles!"
+		<< std::endl;
+      close ();
+      return false;
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       create
+
+  /*!
+    \param location     -- Identifier of the station group to hold the dataset.
+    \param chunkDipoles -- Number of dipoles covered by a chunk.
+    \param chunkSamples -- Number of samples covered by a chunk.
+    \param filters      -- Filters applied to the chunks of the dataset.
+    \return status -- Returns \e false if the group already contains a station
+            dataset, or if it could not be created.
+  */
+  bool TBB_StationDataset::create (hid_t const &location,
+				   hsize_t const &chunkDipoles,
+				   hsize_t const &chunkSamples,
+				   HDF5FilterPipeline const &filters)
+  {
+    close ();
+
+    if (chunkDipoles == 0 || chunkSamples == 0) {
+      std::cerr << "[TBB_StationDataset::create] Invalid chunk shape!" << std::endl;
+      return false;
+    }
+
+    if (H5Lexists (location, getName().c_str(), H5P_DEFAULT) > 0
+	|| H5Lexists (location, getTableName().c_str(), H5P_DEFAULT) > 0) {
+      std::cerr << "[TBB_StationDataset::create] Station dataset already exists!"
+		<< std::endl;
+      return false;
+    }
+
+    hsize_t dims[2]    = {0, 0};
+    hsize_t maxdims[2] = {H5S_UNLIMITED, H5S_UNLIMITED};
+    hsize_t chunk[2]   = {chunkDipoles, chunkSamples};
+    hsize_t tableChunk = 64;
+
+    itsDipoleType = dipoleType ();
+
+    /* [dipole,sample] dataset */
+    hid_t space = H5Screate_simple (2, dims, maxdims);
+    hid_t dcpl  = H5Pcreate (H5P_DATASET_CREATE);
+    hid_t dapl  = accessProperties ();
+    H5Pset_chunk (dcpl, 2, chunk);
+    filters.apply (dcpl);
+    itsDataset = H5Dcreate (location, getName().c_str(), H5T_STD_I16LE, space,
+			    H5P_DEFAULT, dcpl, dapl);
+    H5Pclose (dapl);
+    H5Pclose (dcpl);
+    H5Sclose (space);
+
+    /* Dipole table, stored with the packed row type */
+    hid_t fileType = H5Tcopy (itsDipoleType);
+    H5Tpack (fileType);
+    space = H5Screate_simple (1, dims, maxdims);
+    dcpl  = H5Pcreate (H5P_DATASET_CREATE);
+    H5Pset_chunk (dcpl, 1, &tableChunk);
+    itsTable = H5Dcreate (location, getTableName().c_str(), fileType, space,
+			  H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Pclose (dcpl);
+    H5Sclose (space);
+    H5Tclose (fileType);
+
+    if (itsDataset < 0 || itsTable < 0) {
+      std::cerr << "[TBB_StationDataset::create] Failed to create the station dataset!"
+		<< std::endl;
+      close ();
+      return false;
+    }
+
+    itsChunking[0] = chunkDipoles;
+    itsChunking[1] = chunkSamples;
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        flush
+
+  /*!
+    \return status -- Returns \e false if the dipole table could not be written.
+  */
+  bool TBB_StationDataset::flush ()
+  {
+    if (!itsModified || itsTable < 0) {
+      return true;
+    }
+
+    hsize_t nofRows = itsDipoles.size();
+    bool status     = H5Dset_extent (itsTable, &nofRows) >= 0;
+
+    if (status && nofRows > 0) {
+      status = H5Dwrite (itsTable, itsDipoleType, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+			 &itsDipoles[0]) >= 0;
+    }
+
+    itsModified = !status;
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    addDipole
+
+  /*!
+    \param dipole -- Metadata of the dipole; the data length is set as samples
+           are written.
+    \return row -- Row holding the samples of the dipole; -1 if the dipole
+            already is contained within the dataset or if the dataset could
+            not be extended.
+  */
+  int TBB_StationDataset::addDipole (Dipole const &dipole)
+  {
+    if (itsDataset < 0) {
+      return -1;
+    }
+
+    std::string name = TBB_DipoleDataset::dipoleName (dipole.stationID,
+						      dipole.rspID,
+						      dipole.rcuID);
+    if (findDipole(name) >= 0) {
+      std::cerr << "[TBB_StationDataset::addDipole] Dipole " << name
+		<< " already exists!" << std::endl;
+      return -1;
+    }
+
+    hsize_t dims[2] = {itsShape[0]+1, itsShape[1]};
+
+    if (H5Dset_extent (itsDataset, dims) < 0) {
+      return -1;
+    }
+
+    itsShape[0] = dims[0];
+    itsDipoles.push_back (dipole);
+    itsDipoles.back().dataLength = 0;
+    itsModified = true;
+
+    return itsDipoles.size()-1;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                       resize
+
+  /*!
+    \param nofSamples -- Number of samples along the sample axis; the data
+           length of dipoles extending beyond is reduced accordingly.
+    \return status -- Returns \e false if the dataset could not be resized.
+  */
+  bool TBB_StationDataset::resize (hsize_t const &nofSamples)
+  {
+    if (itsDataset < 0) {
+      return false;
+    }
+
+    hsize_t dims[2] = {itsShape[0], nofSamples};
+
+    if (H5Dset_extent (itsDataset, dims) < 0) {
+      return false;
+    }
+
+    itsShape[1] = nofSamples;
+
+    for (unsigned int n=0; n<itsDipoles.size(); ++n) {
+      if (itsDipoles[n].dataLength > nofSamples) {
+	itsDipoles[n].dataLength = nofSamples;
+	itsModified = true;
+      }
+    }
+
+    return true;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    writeData
+
+  /*!
+    \param data       -- Samples to be written.
+    \param row        -- Row of the dipole.
+    \param start      -- Position of the first sample within the row.
+    \param nofSamples -- Number of samples to write.
+    \return status -- Returns \e false if the row does not exist or if the
+            samples could not be written.
+  */
+  bool TBB_StationDataset::writeData (short const *data,
+				      unsigned int const &row,
+				      hsize_t const &start,
+				      hsize_t const &nofSamples)
+  {
+    if (itsDataset < 0 || row >= itsDipoles.size()) {
+      return false;
+    }
+
+    if (nofSamples == 0) {
+      return true;
+    }
+
+    if (start+nofSamples > itsShape[1] && !resize (start+nofSamples)) {
+      return false;
+    }
+
+    hsize_t offset[2] = {row, start};
+    hsize_t count[2]  = {1, nofSamples};
+    hid_t fileSpace   = H5Dget_space (itsDataset);
+    hid_t memSpace    = H5Screate_simple (1, &nofSamples, NULL);
+
+    H5Sselect_hyperslab (fileSpace, H5S_SELECT_SET, offset, NULL, count, NULL);
+
+    bool status = H5Dwrite (itsDataset, H5T_NATIVE_SHORT, memSpace, fileSpace,
+			    H5P_DEFAULT, data) >= 0;
+
+    H5Sclose (memSpace);
+    H5Sclose (fileSpace);
+
+    if (status && start+nofSamples > itsDipoles[row].dataLength) {
+      itsDipoles[row].dataLength = start+nofSamples;
+      itsModified = true;
+    }
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     readData
+
+  /*!
+    \retval data      -- [nofSamples,dipole] Array of samples, owned by the
+            caller; the samples of the dipole in <tt>rows[n]</tt> start at
+            <tt>data+n*nofSamples</tt>.
+    \param rows       -- Rows of the dipoles to read.
+    \param start      -- Number of the sample at which to start reading, per
+           dipole; samples before the start or beyond the end of the dataset
+           are set to zero.
+    \param nofSamples -- Number of samples to read per dipole.
+    \return status    -- Returns \e false if the parameters are inconsistent
+            or if the samples could not be read.
+
+    If the rows are given in ascending order, the samples are read directly
+    into \e data; otherwise the covered segment of each row is read into a
+    temporary buffer first. Either way a single read is issued.
+  */
+  bool TBB_StationDataset::readData (short *data,
+				     std::vector<unsigned int> const &rows,
+				     std::vector<int> const &start,
+				     int const &nofSamples)
+  {
+    if (itsDataset < 0 || data == NULL || nofSamples < 0
+	|| rows.size() != start.size()) {
+      std::cerr << "[TBB_StationDataset::readData] Inconsistent parameters!"
+		<< std::endl;
+      return false;
+    }
+
+    bool ascending (true);
+    std::vector<Segment> segments;
+    Segment segment;
+
+    for (unsigned int n=0; n<rows.size(); ++n) {
+      if (rows[n] >= itsDipoles.size()) {
+	std::cerr << "[TBB_StationDataset::readData] No such row " << rows[n]
+		  << std::endl;
+	return false;
+      }
+      if (n > 0 && rows[n] <= rows[n-1]) {
+	ascending = false;
+      }
+
+      /* Overlap of the requested block with the dataset */
+      long first = start[n] > 0 ? start[n] : 0;
+      long last  = long(start[n]) + nofSamples;
+      if (last > long(itsShape[1])) {
+	last = itsShape[1];
+      }
+      if (last <= first) {
+	first = last = 0;
+      }
+
+      segment.row       = rows[n];
+      segment.first     = first;
+      segment.count     = last-first;
+      segment.memRow    = n;
+      segment.memOffset = last > first ? first-start[n] : 0;
+      segments.push_back (segment);
+
+      /* Samples outside the dataset are set to zero */
+      short *column = data + size_t(n)*nofSamples;
+      memset (column, 0, segment.memOffset*sizeof(short));
+      memset (column + segment.memOffset + segment.count,
+	      0,
+	      (nofSamples - segment.memOffset - segment.count)*sizeof(short));
+    }
+
+    if (ascending) {
+      return readSegments (data, rows.size(), nofSamples, segments);
+    }
+
+    /* The elements of a selection are transferred in the order of their
+       position in the file, so rows out of order (or requested twice) are
+       read through a buffer holding the covered part of each row once. */
+
+    std::map<hsize_t,std::pair<hsize_t,hsize_t> > covered;
+    std::map<hsize_t,std::pair<hsize_t,hsize_t> >::iterator it;
+    std::vector<Segment> merged;
+    std::map<hsize_t,hsize_t> bufferRow;
+    hsize_t width (0);
+
+    for (unsigned int n=0; n<segments.size(); ++n) {
+      if (segments[n].count == 0) {
+	continue;
+      }
+      hsize_t first = segments[n].first;
+      hsize_t last  = first + segments[n].count;
+      it = covered.find (segments[n].row);
+      if (it == covered.end()) {
+	covered[segments[n].row] = std::make_pair (first, last);
+      } else {
+	if (first < it->second.first) it->second.first = first;
+	if (last > it->second.second) it->second.second = last;
+      }
+    }
+
+    for (it=covered.begin(); it!=covered.end(); ++it) {
+      segment.row       = it->first;
+      segment.first     = it->second.first;
+      segment.count     = it->second.second - it->second.first;
+      segment.memRow    = merged.size();
+      segment.memOffset = 0;
+      bufferRow[it->first] = merged.size();
+      merged.push_back (segment);
+      if (segment.count > width) {
+	width = segment.count;
+      }
+    }
+
+    std::vector<short> buffer (merged.size()*width);
+    bool status = merged.empty() || readSegments (&buffer[0], merged.size(), width, merged);
+
+    for (unsigned int n=0; status && n<segments.size(); ++n) {
+      if (segments[n].count == 0) {
+	continue;
+      }
+      Segment const &source = merged[bufferRow[segments[n].row]];
+      memcpy (data + size_t(n)*nofSamples + segments[n].memOffset,
+	      &buffer[source.memRow*width + (segments[n].first - source.first)],
+	      segments[n].count*sizeof(short));
+    }
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 readSegments
+
+  /*!
+    \retval buffer  -- [width,nofRows] Memory buffer receiving the samples.
+    \param nofRows  -- Number of rows of the memory buffer.
+    \param width    -- Number of samples per row of the memory buffer.
+    \param segments -- Segments to read, in ascending order of the rows of both
+           the dataset and the memory buffer.
+    \return status  -- Returns \e false if the samples could not be read.
+  */
+  bool TBB_StationDataset::readSegments (short *buffer,
+					 hsize_t const &nofRows,
+					 hsize_t const &width,
+					 std::vector<Segment> const &segments)
+  {
+    hsize_t memDims[2] = {nofRows, width};
+    hid_t fileSpace    = H5Dget_space (itsDataset);
+    hid_t memSpace     = H5Screate_simple (2, memDims, NULL);
+    bool selected (false);
+
+    for (unsigned int n=0; n<segments.size(); ++n) {
+      if (segments[n].count == 0) {
+	continue;
+      }
+
+      hsize_t fileOffset[2] = {segments[n].row, segments[n].first};
+      hsize_t memOffset[2]  = {segments[n].memRow, segments[n].memOffset};
+      hsize_t count[2]      = {1, segments[n].count};
+      H5S_seloper_t op      = selected ? H5S_SELECT_OR : H5S_SELECT_SET;
+
+      H5Sselect_hyperslab (fileSpace, op, fileOffset, NULL, count, NULL);
+      H5Sselect_hyperslab (memSpace, op, memOffset, NULL, count, NULL);
+      selected = true;
+    }
+
+    bool status = !selected
+      || H5Dread (itsDataset, H5T_NATIVE_SHORT, memSpace, fileSpace,
+		  H5P_DEFAULT, buffer) >= 0;
+
+    H5Sclose (memSpace);
+    H5Sclose (fileSpace);
+
+    return status;
+  }
+
+} // Namespace DAL -- end
@@ -0,0 +1,365 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                  *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TBB_STATIONDATASET_H
+#define TBB_STATIONDATASET_H
+
+// Standard library header files
+#include <iostream>
+#include <string>
+#include <vector>
+
+// DAL header files
+#include <dal_config.h>
+#include <core/HDF5FilterPipeline.h>
+
+//! Default number of dipoles covered by a chunk of a station dataset
+#define TBB_STATIONDATASET_CHUNK_DIPOLES 8
+//! Size of the chunk cache of a station dataset, [Bytes]
+#define TBB_STATIONDATASET_CACHE_BYTES (64*1024*1024)
+
+namespace DAL { // Namespace DAL -- begin
+
+  /*!
+    \class TBB_StationDataset
+
+    \ingroup DAL
+    \ingroup data_hl
+
+    \brief Samples of all dipoles of a station in a single 2-D dataset
+
+    \author Lars B&auml;hren
+
+    \date 2011/06/14
+
+    \test tTBB_StationDataset.cc
+
+    <h3>Prerequisite</h3>
+
+    <ul type="square">
+      <li>DAL::TBB_StationGroup
+      <li>DAL::TBB_DipoleDataset
+      <li>DAL::HDF5FilterPipeline
+    </ul>
+
+    <h3>Synopsis</h3>
+
+    In the default layout of a TBB time-series file every dipole is stored as
+    a 1-D dataset of its own (see DAL::TBB_DipoleDataset), so reading a block
+    of samples for a station takes one read per dipole, and the data of the
+    dipoles are scattered across the file. As an alternative, the samples of
+    all dipoles of a station can be stored in a single dataset:
+
+    \verbatim
+    Station001
+    |-- STATION_DATA              [dipole,sample] Dataset, chunked
+    `-- DIPOLE_TABLE              Table with the metadata per dipole
+    \endverbatim
+
+    Row \e n of the <tt>STATION_DATA</tt> dataset holds the samples of the
+    dipole described by row \e n of the <tt>DIPOLE_TABLE</tt>. The chunks of
+    the dataset span several dipoles (TBB_STATIONDATASET_CHUNK_DIPOLES by
+    default), such that a block of samples for the whole station is returned
+    by a single read touching a few chunks. The table holds the metadata
+    which otherwise are attached as attributes to the dipole datasets:
+
+    <table border=0>
+      <tr>
+        <td class="indexkey">Column</td>
+        <td class="indexkey">Type</td>
+        <td class="indexkey">Description</td>
+      </tr>
+      <tr>
+        <td>STATION_ID, RSP_ID, RCU_ID</td>
+        <td>uint</td>
+        <td>Identifiers of the dipole</td>
+      </tr>
+      <tr>
+        <td>TIME</td>
+        <td>uint</td>
+        <td>Unix time of the first sample</td>
+      </tr>
+      <tr>
+        <td>SAMPLE_NUMBER</td>
+        <td>uint</td>
+        <td>Number of the first sample within the second</td>
+      </tr>
+      <tr>
+        <td>SAMPLES_PER_FRAME</td>
+        <td>uint</td>
+        <td>Number of samples per TBB data frame</td>
+      </tr>
+      <tr>
+        <td>SAMPLE_FREQUENCY_VALUE</td>
+        <td>double</td>
+        <td>Sample frequency, [MHz]</td>
+      </tr>
+      <tr>
+        <td>DATA_LENGTH</td>
+        <td>uint</td>
+        <td>Number of valid samples in the row of the dipole</td>
+      </tr>
+    </table>
+
+    Rows are added as dipoles show up, e.g. while TBBraw is writing a file,
+    and the dataset is extended along the sample axis as data arrive; the
+    dipole table is written upon flush() and when the object is destroyed.
+
+    All calls into the HDF5 library are made from the thread calling the
+    methods of this class.
+
+    <h3>Example(s)</h3>
+
+    <ol>
+      <li>Create the station dataset and add a dipole:
+      \code
+      DAL::TBB_StationDataset station;
+      station.create (groupID);
+
+      DAL::TBB_StationDataset::Dipole dipole;
+      dipole.stationID = 1;
+      dipole.rspID     = 0;
+      dipole.rcuID     = 5;
+      ...
+      int row = station.addDipole (dipole);
+      station.writeData (samples, row, 0, nofSamples);
+      \endcode
+
+      <li>Read a block of samples for three dipoles with a single read:
+      \code
+      DAL::TBB_StationDataset station (groupID);
+      std::vector<unsigned int> rows (3);
+      std::vector<int> start (3, 1024);
+      short *data = new short [3*nofSamples];
+      ...
+      station.readData (data, rows, start, nofSamples);
+      \endcode
+    </ol>
+  */
+  class TBB_StationDataset {
+
+  public:
+
+    //! Metadata of a dipole, stored as a row of the dipole table
+    struct Dipole {
+      //! Identifier of the station
+      unsigned int stationID;
+      //! Identifier of the RSP board
+      unsigned int rspID;
+      //! Identifier of the RCU
+      unsigned int rcuID;
+      //! Unix time of the first sample
+      unsigned int time;
+      //! Number of the first sample within the second
+      unsigned int sampleNumber;
+      //! Number of samples per data frame
+      unsigned int samplesPerFrame;
+      //! Sample frequency, [MHz]
+      double sampleFrequency;
+      //! Number of valid samples
+      unsigned int dataLength;
+    };
+
+  private:
+
+    //! Segment of a row of the dataset, and its position in a memory buffer
+    struct Segment {
+      //! Row of the dataset
+      hsize_t row;
+      //! First sample within the row
+      hsize_t first;
+      //! Number of samples
+      hsize_t count;
+      //! Row of the memory buffer
+      hsize_t memRow;
+      //! Position of the first sample within the row of the memory buffer
+      hsize_t memOffset;
+    };
+
+    //! Identifier of the [dipole,sample] dataset
+    hid_t itsDataset;
+    //! Identifier of the dipole table
+    hid_t itsTable;
+    //! Identifier of the in-memory datatype of a row of the dipole table
+    hid_t itsDipoleType;
+    //! Shape of the dataset, [dipole,sample]
+    std::vector<hsize_t> itsShape;
+    //! Shape of the chunks of the dataset, [dipole,sample]
+    std::vector<hsize_t> itsChunking;
+    //! Metadata of the dipoles, in the order of the rows
+    std::vector<Dipole> itsDipoles;
+    //! Does the dipole table have to be written?
+    bool itsModified;
+
+    //! Disabled copy constructor
+    TBB_StationDataset (TBB_StationDataset const &other);
+    //! Disabled assignment operator
+    TBB_StationDataset& operator= (TBB_StationDataset const &other);
+
+  public:
+
+    // === Construction =========================================================
+
+    //! Default constructor
+    TBB_StationDataset ();
+
+    //! Argumented constructor, opening the station dataset of a group
+    TBB_StationDataset (hid_t const &location);
+
+    // === Destruction ==========================================================
+
+    //! Destructor, writing the dipole table
+    ~TBB_StationDataset ();
+
+    // === Parameter access =====================================================
+
+    //! Is the object connected to a dataset?
+    inline bool isOpen () const {
+      return itsDataset > 0;
+    }
+
+    //! Get the identifier of the [dipole,sample] dataset
+    inline hid_t datasetID () const {
+      return itsDataset;
+    }
+
+    //! Get the shape of the dataset, [dipole,sample]
+    inline std::vector<hsize_t> shape () const {
+      return itsShape;
+    }
+
+    //! Get the shape of the chunks of the dataset, [dipole,sample]
+    inline std::vector<hsize_t> chunking () const {
+      return itsChunking;
+    }
+
+    //! Get the number of dipoles
+    inline unsigned int nofDipoles () const {
+      return itsDipoles.size();
+    }
+
+    //! Get the number of samples along the sample axis of the dataset
+    inline hsize_t nofSamples () const {
+      return itsShape.size() == 2 ? itsShape[1] : 0;
+    }
+
+    //! Get the metadata of the dipoles, in the order of the rows
+    inline std::vector<Dipole> dipoles () const {
+      return itsDipoles;
+    }
+
+    //! Get the metadata of the dipole in a row
+    Dipole dipole (unsigned int const &row) const;
+
+    //! Get the name of the dipole in a row
+    std::string dipoleName (unsigned int const &row) const;
+
+    //! Get the names of the dipoles, in the order of the rows
+    std::vector<std::string> dipoleNames () const;
+
+    //! Get the row holding a dipole
+    int findDipole (std::string const &name) const;
+
+    //! Provide a summary of the object's internal parameters and status
+    inline void summary () {
+      summary (std::cout);
+    }
+
+    //! Provide a summary of the object's internal parameters and status
+    void summary (std::ostream &os);
+
+    /*!
+      \brief Get the name of the class
+
+      \return className -- The name of the class, TBB_StationDataset.
+    */
+    inline std::string className () const {
+      return "TBB_StationDataset";
+    }
+
+    // === Methods ==============================================================
+
+    //! Open the station dataset of a group
+    bool open (hid_t const &location);
+
+    //! Create a station dataset, without any dipoles, within a group
+    bool create (hid_t const &location,
+		 hsize_t const &chunkDipoles=TBB_STATIONDATASET_CHUNK_DIPOLES,
+		 hsize_t const &chunkSamples=CHUNK_SIZE,
+		 HDF5FilterPipeline const &filters=HDF5FilterPipeline());
+
+    //! Write the dipole table and release the dataset
+    void close ();
+
+    //! Write the dipole table to the file
+    bool flush ();
+
+    //! Add a row for a dipole
+    int addDipole (Dipole const &dipole);
+
+    //! Set the number of samples along the sample axis of the dataset
+    bool resize (hsize_t const &nofSamples);
+
+    //! Write samples of a dipole, extending the dataset if necessary
+    bool writeData (short const *data,
+		    unsigned int const &row,
+		    hsize_t const &start,
+		    hsize_t const &nofSamples);
+
+    //! Read a block of samples for a number of dipoles, with a single read
+    bool readData (short *data,
+		   std::vector<unsigned int> const &rows,
+		   std::vector<int> const &start,
+		   int const &nofSamples);
+
+    // === Static methods =======================================================
+
+    //! Get the name of the [dipole,sample] dataset within a station group
+    static std::string getName () {
+      return "STATION_DATA";
+    }
+
+    //! Get the name of the dipole table within a station group
+    static std::string getTableName () {
+      return "DIPOLE_TABLE";
+    }
+
+    //! Does a group contain a station dataset?
+    static bool exists (hid_t const &location);
+
+  private:
+
+    //! Initialize the internal parameters
+    void init ();
+    //! Create the in-memory datatype of a row of the dipole table
+    static hid_t dipoleType ();
+    //! Read the shape of the dataset
+    bool readShape ();
+    //! Read a set of row segments with a single call into the library
+    bool readSegments (short *buffer,
+		       hsize_t const &nofRows,
+		       hsize_t const &width,
+		       std::vector<Segment> const &segments);
+
+  }; // Class TBB_StationDataset -- end
+
+} // Namespace DAL -- end
+
+#endif /* TBB_STATIONDATASET_H */
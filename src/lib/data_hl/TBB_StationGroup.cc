@@ -20,6 +20,8 @@
 
 #include <data_hl/TBB_StationGroup.h>
 
+#include <algorithm>
+
 using std::cout;
 using std::endl;
 
@@ -84,6 +86,22 @@ namespace DAL {  // Namespace DAL -- begin
     open (groupID);
   }
   
+  //_____________________________________________________________________________
+  //                                                             TBB_StationGroup
+  
+  /*!
+    The identifiers held by \e other are shared rather than opened anew; the
+    dipole selection refers to the datasets held by the new object.
+
+    \param other -- Another TBB_StationGroup object from which to create this
+           new one.
+  */
+  TBB_StationGroup::TBB_StationGroup (TBB_StationGroup const &other)
+    : HDF5GroupBase ()
+  {
+    copy (other);
+  }
+  
   // ============================================================================
   //
   //  Destruction
@@ -112,6 +130,8 @@ namespace DAL {  // Namespace DAL -- begin
     }
     // clear standard containers
     selectedDatasets_p.clear();
+    selectedRows_p.clear();
+    stationDataset_p.close();
   }
   
   // ============================================================================
@@ -142,12 +162,81 @@ namespace DAL {  // Namespace DAL -- begin
   /*!
     \param other -- Another TBB_StationGroup object from which to create
            this new one.
+
+    The group identifier is shared with \e other (see HDF5Object::share) and
+    the dipole datasets are copied, which in turn share their identifiers, so
+    that neither the file nor the group have to be traversed once more; the
+    selection of dipoles made for \e other is retained. Only the station
+    dataset, which cannot be copied, is opened once more.
   */
   void TBB_StationGroup::copy (TBB_StationGroup const &other)
   {
-    location_p  = other.location_p;
+    std::map<std::string,iterDipoleDataset>::const_iterator it;
+
+    if (H5Iget_type(other.location_p) == H5I_GROUP) {
+      location_p = HDF5Object::share (other.location_p);
+    } else {
+      location_p = 0;
+    }
+
+    attributes_p = other.attributes_p;
+    itsGroupType = other.itsGroupType;
+    itsFlags     = other.itsFlags;
+    /* The other object remains responsible for writing its modifications */
+    itsAttributeCache = other.itsAttributeCache;
+    itsAttributeCache.resetModified();
+
+    stationID_p            = other.stationID_p;
+    stationTrigger_p       = other.stationTrigger_p;
+    nofTriggeredAntennas_p = other.nofTriggeredAntennas_p;
+    datasets_p             = other.datasets_p;
+    selectedRows_p         = other.selectedRows_p;
+
+    /* Selection refers to the datasets held by this object */
+    selectedDatasets_p.clear();
+    for (it=other.selectedDatasets_p.begin(); it!=other.selectedDatasets_p.end(); ++it) {
+      selectedDatasets_p[it->first] = datasets_p.find(it->second->first);
+    }
 
-    open (other.location_p);
+    if (other.stationDataset_p.isOpen() && location_p > 0) {
+      stationDataset_p.open (location_p);
+    }
+  }
+  
+  //_____________________________________________________________________________
+  //                                                                         swap
+  
+  /*!
+    \param other -- Another TBB_StationGroup object with which to exchange
+           contents.
+
+    Identifiers, dipole datasets and the selection of dipoles are exchanged
+    without being copied; iterators into the datasets remain valid, but then
+    refer to the datasets held by the other object. The station dataset, which
+    cannot be exchanged, is opened once more for either group.
+  */
+  void TBB_StationGroup::swap (TBB_StationGroup &other)
+  {
+    bool thisStationDataset  = stationDataset_p.isOpen();
+    bool otherStationDataset = other.stationDataset_p.isOpen();
+
+    stationDataset_p.close();
+    other.stationDataset_p.close();
+
+    HDF5GroupBase::swap (other);
+    std::swap (stationID_p, other.stationID_p);
+    stationTrigger_p.swap (other.stationTrigger_p);
+    std::swap (nofTriggeredAntennas_p, other.nofTriggeredAntennas_p);
+    datasets_p.swap (other.datasets_p);
+    selectedDatasets_p.swap (other.selectedDatasets_p);
+    selectedRows_p.swap (other.selectedRows_p);
+
+    if (otherStationDataset) {
+      stationDataset_p.open (location_p);
+    }
+    if (thisStationDataset) {
+      other.stationDataset_p.open (other.location_p);
+    }
   }
   
   // ============================================================================
@@ -234,6 +323,52 @@ namespace DAL {  // Namespace DAL -- begin
   bool TBB_StationGroup::open (hid_t const &location,
 			       std::string const &name,
 			       IO_Mode const &flags)
+  {
+    return openGroup (location, name, flags, NULL);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                         open
+  
+  /*!
+    \param location -- Identifier of the location to which the to be opened
+           structure is attached.
+    \param name   -- Name of the structure (file, group, dataset, etc.) to be
+           opened.
+    \param flags  -- I/O mode flags.
+    \param index  -- Table of contents of the file; if it is valid and holds
+           the station group, the dipole datasets are taken from it instead of
+	   iterating over the links of the group.
+    
+    \return status -- Status of the operation; returns <tt>false</tt> in case
+            an error was encountered.
+  */
+  bool TBB_StationGroup::open (hid_t const &location,
+			       std::string const &name,
+			       IO_Mode const &flags,
+			       HDF5FileIndex const &index)
+  {
+    return openGroup (location, name, flags, &index);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                    openGroup
+  
+  /*!
+    \param location -- Identifier of the location to which the to be opened
+           structure is attached.
+    \param name   -- Name of the group to be opened.
+    \param flags  -- I/O mode flags.
+    \param index  -- Table of contents of the file; <tt>NULL</tt> if not
+           available.
+    
+    \return status -- Status of the operation; returns <tt>false</tt> in case
+            an error was encountered.
+  */
+  bool TBB_StationGroup::openGroup (hid_t const &location,
+				    std::string const &name,
+				    IO_Mode const &flags,
+				    HDF5FileIndex const *index)
   {
     bool status (true);
     
@@ -279,6 +414,7 @@ namespace DAL {  // Namespace DAL -- begin
  	  HDF5Attribute::write (location_p,"TRIGGER_OFFSET",           double(0.0) );
  	  HDF5Attribute::write (location_p,"TRIGGERED_ANTENNAS",       triggered   );
 	  HDF5Attribute::write (location_p,"NOF_DIPOLES",              uint(0)     );
+	  itsAttributeCache.invalidate();
 	} else {
 #ifdef DAL_DEBUGGING_MESSAGES
 	  std::cerr << "[TBB_StationGroup::open] Failed to create group "
@@ -299,7 +435,7 @@ namespace DAL {  // Namespace DAL -- begin
     
     // Open embedded groups
     if (status) {
-      status = openEmbedded (flags);
+      status = openEmbedded (flags, index);
     }
 #ifdef DAL_DEBUGGING_MESSAGES
     else {
@@ -315,6 +451,20 @@ namespace DAL {  // Namespace DAL -- begin
   //                                                                 openEmbedded
   
   bool TBB_StationGroup::openEmbedded (IO_Mode const &flags)
+  {
+    return openEmbedded (flags, NULL);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                 openEmbedded
+  
+  /*!
+    \param flags -- I/O mode flags.
+    \param index -- Table of contents of the file; <tt>NULL</tt> if not
+           available.
+  */
+  bool TBB_StationGroup::openEmbedded (IO_Mode const &flags,
+				       HDF5FileIndex const *index)
   {
     bool status = true;
 
@@ -322,9 +472,15 @@ namespace DAL {  // Namespace DAL -- begin
       std::set<std::string> groups;
       std::set<std::string> datasets;
       std::set<std::string>::iterator it;
+      std::string path = HDF5Object::name (location_p);
 
-      h5get_names (groups,location_p,H5G_GROUP);
-      h5get_names (datasets,location_p,H5G_DATASET);
+      if (index != NULL && index->isValid() && index->has(path)) {
+	groups   = index->names (path, H5G_GROUP);
+	datasets = index->names (path, H5G_DATASET);
+      } else {
+	h5get_names (groups,location_p,H5G_GROUP);
+	h5get_names (datasets,location_p,H5G_DATASET);
+      }
 
       // Open station calibration group ____________________
 
@@ -336,12 +492,19 @@ namespace DAL {  // Namespace DAL -- begin
 					     TBB_StationTrigger::getName(),
 					     flags);
 
+      // Open station dataset _____________________________
+
+      if (stationDataset_p.open (location_p)) {
+	datasets.erase (TBB_StationDataset::getName());
+	datasets.erase (TBB_StationDataset::getTableName());
+      }
+
       // Open dipole datasets ______________________________
 
-      if (datasets.size() > 0) {
+      if (datasets.size() > 0 || stationDataset_p.isOpen()) {
 	datasets_p.clear();
 	for (it=datasets.begin(); it!=datasets.end(); ++it) {
-	  datasets_p[*it] = TBB_DipoleDataset(location_p,*it,flags);
+	  datasets_p[*it].setLink(location_p,*it,flags);
 	}
       } else {
 	status = false;
@@ -433,11 +596,16 @@ namespace DAL {  // Namespace DAL -- begin
   {
     std::set<std::string> selection;
     std::map<std::string,iterDipoleDataset>::iterator it;
+    std::map<std::string,unsigned int>::iterator itRow;
     
     for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
       selection.insert(it->first);
     }    
 
+    for (itRow=selectedRows_p.begin(); itRow!=selectedRows_p.end(); ++itRow) {
+      selection.insert(itRow->first);
+    }
+
     return selection;
   }
   
@@ -463,7 +631,9 @@ namespace DAL {  // Namespace DAL -- begin
     bool status (true);
     std::set<std::string>::iterator iterInput;
     std::map<std::string,iterDipoleDataset> tmpSelection;
+    std::map<std::string,unsigned int> tmpRows;
     iterDipoleDataset iterSelection;
+    int row;
     
     for (iterInput=selection.begin(); iterInput!=selection.end(); ++iterInput) {
       /* Get pointer to the selected dataset. */
@@ -471,12 +641,14 @@ namespace DAL {  // Namespace DAL -- begin
       /* If the selection is valid, accept it. */
       if (iterSelection!=datasets_p.end()) {
 	tmpSelection[*iterInput] = iterSelection;
+      } else if ((row = stationDataset_p.findDipole(*iterInput)) >= 0) {
+	tmpRows[*iterInput] = row;
       }
     }
 
     /* If selection is non-empty, store the result. */
     
-    if (tmpSelection.empty()) {
+    if (tmpSelection.empty() && tmpRows.empty()) {
       std::cerr << "[TBB_StationGroup::selectDipoles]"
 		<< " No valid selection of dipoles!"
 		<< std::endl;
@@ -484,6 +656,7 @@ namespace DAL {  // Namespace DAL -- begin
     } else {
       selectedDatasets_p.clear();
       selectedDatasets_p = tmpSelection;
+      selectedRows_p     = tmpRows;
     }
     
     return status;
@@ -502,15 +675,24 @@ namespace DAL {  // Namespace DAL -- begin
   {
     bool status (true);
     std::map<std::string,iterDipoleDataset> selection;
+    std::map<std::string,unsigned int> rows;
     iterDipoleDataset it;
 
     for (it=datasets_p.begin(); it!=datasets_p.end(); ++it) {
       selection[it->first] = it;
     }
 
-    if (!selection.empty()) {
+    for (unsigned int row=0; row<stationDataset_p.nofDipoles(); ++row) {
+      std::string name = stationDataset_p.dipoleName(row);
+      if (datasets_p.find(name) == datasets_p.end()) {
+	rows[name] = row;
+      }
+    }
+
+    if (!selection.empty() || !rows.empty()) {
       selectedDatasets_p.clear();
       selectedDatasets_p = selection;
+      selectedRows_p     = rows;
     }
 
     return status;
@@ -548,6 +730,7 @@ namespace DAL {  // Namespace DAL -- begin
       //
       os << "-- Group name ............. : " << group_name(true)        << endl;
       os << "-- nof. dipole datasets ... : " << nofDipoleDatasets()     << endl;
+      os << "-- Station dataset ........ : " << hasStationDataset()     << endl;
       os << "-- Station position (Value) : " << stationPositionValue    << endl;
       os << "-- Station position (Unit)  : " << stationPositionUnit     << endl;
       os << "-- Station position (Frame) : " << stationPositionFrame    << endl;
@@ -619,6 +802,7 @@ namespace DAL {  // Namespace DAL -- begin
     casa::Vector<casa::MPosition> position (selectedDatasets_p.size());
 
     for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
+      (it->second)->second.openLink();
       position(n) = (it->second)->second.antenna_position();
       ++n;
     }
@@ -637,10 +821,16 @@ namespace DAL {  // Namespace DAL -- begin
     unsigned int n (0);
 
     for (it=datasets_p.begin(); it!=datasets_p.end(); ++it) {
+      it->second.openLink();
       names[n] = it->second.dipoleName();
       ++n;
     }
 
+    /* Dipoles stored as rows of the station dataset */
+    for (unsigned int row=0; row<stationDataset_p.nofDipoles(); ++row) {
+      names.push_back (stationDataset_p.dipoleName(row));
+    }
+
     return names;
   }
 
@@ -653,9 +843,23 @@ namespace DAL {  // Namespace DAL -- begin
     std::map<std::string,iterDipoleDataset>::iterator it;
 
     for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
+      (it->second)->second.openLink();
       numbers.push_back((it->second)->second.dipoleNumber());
     }
 
+    /* Dipoles stored as rows of the station dataset; the numbers are sorted
+       the same way as the names, i.e. in the order of the data columns. */
+    if (!selectedRows_p.empty()) {
+      std::map<std::string,unsigned int>::iterator itRow;
+      for (itRow=selectedRows_p.begin(); itRow!=selectedRows_p.end(); ++itRow) {
+	TBB_StationDataset::Dipole dipole = stationDataset_p.dipole(itRow->second);
+	numbers.push_back(TBB_DipoleDataset::dipoleNumber(dipole.stationID,
+							  dipole.rspID,
+							  dipole.rcuID));
+      }
+      std::sort (numbers.begin(), numbers.end());
+    }
+
     return numbers;
   }
 
@@ -674,6 +878,7 @@ namespace DAL {  // Namespace DAL -- begin
     casa::Vector<hid_t> id (datasets_p.size());
 
     for (it=datasets_p.begin(); it!=datasets_p.end(); ++it) {
+      it->second.openLink();
       id(n) = it->second.locationID();
       ++n;
     }
@@ -688,6 +893,7 @@ namespace DAL {  // Namespace DAL -- begin
     std::vector<hid_t> id (datasets_p.size());
 
     for (it=datasets_p.begin(); it!=datasets_p.end(); ++it) {
+      it->second.openLink();
       id[n] = it->second.locationID();
       ++n;
     }
@@ -709,8 +915,10 @@ namespace DAL {  // Namespace DAL -- begin
   
   /*!
     \retval data -- [nofSamples,dipole] Array of raw ADC samples representing
-            the electric field strength as function of time.
-    \param start      -- Number of the sample at which to start reading
+            the electric field strength as function of time; the columns
+            follow the order of the dipole names, see selectedDipoles().
+    \param start      -- Number of the sample at which to start reading, per
+           selected dipole.
     \param nofSamples -- Number of samples to read, starting from the position
            given by <tt>start</tt>.
   */
@@ -718,7 +926,7 @@ namespace DAL {  // Namespace DAL -- begin
 				   casa::Vector<int> const &start,
 				   int const &nofSamples)
   {
-    uint nofDipoles = selectedDatasets_p.size();
+    uint nofDipoles = nofSelectedDatasets();
     uint nelem      = start.nelements();
     casa::IPosition shape (2,nofSamples,nofDipoles);
 
@@ -747,15 +955,43 @@ namespace DAL {  // Namespace DAL -- begin
     uint n (0);
     casa::Vector<double> tmp (nofSamples);
     std::map<std::string,iterDipoleDataset>::iterator it;
+    std::map<std::string,unsigned int>::iterator itRow;
+    std::set<std::string> names = selectedDipoles();
+    std::set<std::string>::iterator itName;
+    std::map<std::string,uint> column;
+
+    /* Columns of the selected dipoles, in the order of their names */
+    for (itName=names.begin(); itName!=names.end(); ++itName, ++n) {
+      column[*itName] = n;
+    }
     
-    /* Iterate over the selected dipoles */
+    /* Iterate over the selected dipole datasets */
     for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
+      n = column[it->first];
       /* Retrieve dipole data */
+      (it->second)->second.openLink();
       tmp = (it->second)->second.readData(start(n),nofSamples);
       /* Copy the data to the returned array */
       data.column(n) = tmp;
-      /* Increment data array column counter */
-      ++n;
+    }
+
+    /* Read the dipoles within the station dataset at once */
+    if (!selectedRows_p.empty() && nofSamples > 0) {
+      std::vector<unsigned int> rows;
+      std::vector<int> rowStart;
+      std::vector<uint> rowColumn;
+      for (itRow=selectedRows_p.begin(); itRow!=selectedRows_p.end(); ++itRow) {
+	rows.push_back (itRow->second);
+	rowColumn.push_back (column[itRow->first]);
+	rowStart.push_back (start(rowColumn.back()));
+      }
+      std::vector<short> buffer (rows.size()*nofSamples);
+      status = stationDataset_p.readData (&buffer[0], rows, rowStart, nofSamples);
+      for (uint k=0; k<rows.size(); ++k) {
+	for (int sample=0; sample<nofSamples; ++sample) {
+	  data(sample,rowColumn[k]) = buffer[k*nofSamples+sample];
+	}
+      }
     }
 
     // Feedback ____________________________________________
@@ -784,7 +1020,7 @@ namespace DAL {  // Namespace DAL -- begin
 				   int const &start,
 				   int const &nofSamples)
   {
-    uint nofDipoles (selectedDatasets_p.size());
+    uint nofDipoles (nofSelectedDatasets());
     casa::Vector<int> startVect (nofDipoles,start);
 
     return readData (data,
@@ -823,6 +1059,7 @@ namespace DAL {  // Namespace DAL -- begin
     uint n (0);
 
     for (it=datasets_p.begin(); it!=datasets_p.end(); ++it) {
+      it->second.openLink();
       it->second.getAttribute("ANTENNA_POSITION_VALUE",tmp);
       positionValues.row(n) = tmp;
       ++n;
@@ -847,6 +1084,7 @@ namespace DAL {  // Namespace DAL -- begin
     uint n (0);
 
     for (it=datasets_p.begin(); it!=datasets_p.end(); ++it) {
+      it->second.openLink();
       it->second.getAttribute("ANTENNA_POSITION_UNIT",tmp);
       antennaPositionUnits.row(n) = tmp;
       ++n;
@@ -867,6 +1105,7 @@ namespace DAL {  // Namespace DAL -- begin
     freq.resize (datasets_p.size());
 
     for (it=datasets_p.begin(); it!=datasets_p.end(); ++it) {
+      it->second.openLink();
       status *= it->second.sample_frequency(freq(n));
       ++n;
     }
@@ -959,6 +1198,7 @@ namespace DAL {  // Namespace DAL -- begin
       uint n (0);
       
       for (it=datasets_p.begin(); it!=datasets_p.end(); ++it) {
+	it->second.openLink();
 	name = it->second.dipoleName();
 	// retrieve the attributes for the dipole data-set as record
 	it->second.getAttributes(recordDipole);
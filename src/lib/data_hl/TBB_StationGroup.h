@@ -32,8 +32,10 @@
 #include <measures/Measures/MDirection.h>
 #endif
 
+#include <core/HDF5FileIndex.h>
 #include <data_common/HDF5GroupBase.h>
 #include <data_hl/TBB_DipoleDataset.h>
+#include <data_hl/TBB_StationDataset.h>
 #include <data_hl/TBB_StationTrigger.h>
 
 namespace DAL {   // Namespace DAL -- begin
@@ -59,8 +61,20 @@ namespace DAL {   // Namespace DAL -- begin
       <li>DAL::TBB_Timeseries
       <li>DAL::TBB_StationTrigger
       <li>DAL::TBB_DipoleDataset
+      <li>DAL::TBB_StationDataset
     </ul>
 
+    <h3>Synopsis</h3>
+
+    The samples of the dipoles in a station are stored either as one
+    DAL::TBB_DipoleDataset per dipole, or as the rows of a single
+    DAL::TBB_StationDataset. Both layouts are handled transparently: the
+    dipoles are selected by name, and readData() returns the samples of the
+    selected dipoles in the order of their names. Dipoles held by the station
+    dataset are read with a single call into the HDF5 library; the attributes
+    of the individual dipoles (e.g. the antenna positions) only are available
+    for dipole datasets.
+
     <h3>Example(s)</h3>
 
     <ol>
@@ -112,6 +126,10 @@ namespace DAL {   // Namespace DAL -- begin
     std::map<std::string,TBB_DipoleDataset> datasets_p;
     //! Selected dipoles
     std::map<std::string,iterDipoleDataset> selectedDatasets_p;
+    //! Samples of the dipoles stored as rows of a single dataset
+    TBB_StationDataset stationDataset_p;
+    //! Selected dipoles within the station dataset, with their rows
+    std::map<std::string,unsigned int> selectedRows_p;
     
   public:
     
@@ -132,6 +150,9 @@ namespace DAL {   // Namespace DAL -- begin
     
     //! Argumented constructor
     TBB_StationGroup (hid_t const &groupID);
+
+    //! Copy constructor
+    TBB_StationGroup (TBB_StationGroup const &other);
     
     // === Destruction ==========================================================
 
@@ -142,6 +163,9 @@ namespace DAL {   // Namespace DAL -- begin
     
     //! Overloading of the copy operator
     TBB_StationGroup& operator= (TBB_StationGroup const &other);
+
+    //! Exchange the contents with another object, without copying
+    void swap (TBB_StationGroup &other);
     
     // === Parameter access =====================================================
     
@@ -155,6 +179,21 @@ namespace DAL {   // Namespace DAL -- begin
     inline std::map<std::string,iterDipoleDataset> dipoleSelection () const {
       return selectedDatasets_p;
     }
+
+    //! Get the selected dipoles within the station dataset, with their rows
+    inline std::map<std::string,unsigned int> rowSelection () const {
+      return selectedRows_p;
+    }
+
+    //! Are (some of) the dipoles stored as rows of a station dataset?
+    inline bool hasStationDataset () const {
+      return stationDataset_p.isOpen();
+    }
+
+    //! Get the station dataset holding the dipoles stored as rows
+    inline TBB_StationDataset & stationDataset () {
+      return stationDataset_p;
+    }
     
     //! Set the set of selected dipoles
     bool selectDipoles (std::set<std::string> const &selection);
@@ -191,6 +230,12 @@ namespace DAL {   // Namespace DAL -- begin
     bool open (hid_t const &location,
 	       std::string const &name,
 	       IO_Mode const &flags=IO_Mode(IO_Mode::OpenOrCreate));
+
+    //! Open a station group, taking the embedded datasets from the file index
+    bool open (hid_t const &location,
+	       std::string const &name,
+	       IO_Mode const &flags,
+	       HDF5FileIndex const &index);
     
     //! Open a dipole dataset
     bool openDipoleDataset (unsigned int const &rspID,
@@ -201,10 +246,10 @@ namespace DAL {   // Namespace DAL -- begin
       \brief Get the number of dipole datasets within this station group
       
       \return nofDipoleDatasets -- The number of dipole datasets contained with
-      this station group.
+      this station group, including the dipoles stored in the station dataset.
     */
     inline uint nofDipoleDatasets () {
-      return datasets_p.size();
+      return datasets_p.size() + stationDataset_p.nofDipoles();
     }
     
     /*!
@@ -213,7 +258,7 @@ namespace DAL {   // Namespace DAL -- begin
       \return nofSelectedDatasets -- The number of selected dipole datasets within this station group.
     */
     inline uint nofSelectedDatasets() {
-      return selectedDatasets_p.size();
+      return selectedDatasets_p.size() + selectedRows_p.size();
     }
 
     //! Get the groupname for a station identified by <tt>index</tt>
@@ -240,6 +285,7 @@ namespace DAL {   // Namespace DAL -- begin
     result.clear();
 	  
 	  for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
+	    it->second->second.openLink();
 	    it->second->second.getAttribute(name,tmp);
 	    result.push_back(tmp);
 	  }
@@ -266,6 +312,7 @@ namespace DAL {   // Namespace DAL -- begin
 	  result.resize(selectedDatasets_p.size());
 	  
 	  for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
+	    it->second->second.openLink();
 	    it->second->second.getAttribute(name,tmp);
 	    result(n) = tmp;
 	    ++n;
@@ -364,9 +411,18 @@ namespace DAL {   // Namespace DAL -- begin
     void setAttributes ();
     //! Open the structures embedded within the current one
     bool openEmbedded (IO_Mode const &flags=IO_Mode(IO_Mode::OpenOrCreate));
+    //! Open the structures embedded within the current one
+    bool openEmbedded (IO_Mode const &flags,
+		       HDF5FileIndex const *index);
 
   private:
     
+    //! Open a station group, optionally using the file index
+    bool openGroup (hid_t const &location,
+		    std::string const &name,
+		    IO_Mode const &flags,
+		    HDF5FileIndex const *index);
+
     //! Unconditional copying
     void copy (TBB_StationGroup const &other);
     
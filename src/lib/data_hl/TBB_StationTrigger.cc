@@ -212,6 +212,7 @@ namespace DAL { // Namespace DAL -- begin
 	  HDF5Attribute::write (location_p, "PULSE_POWER_PRE",            vecInt        );
 	  HDF5Attribute::write (location_p, "PULSE_POWER_POST",           vecInt        );
 	  HDF5Attribute::write (location_p, "NOF_MISSED_TRIGGERS",        vecInt        );
+	  itsAttributeCache.invalidate();
 	} else {
 #ifdef DAL_DEBUGGING_MESSAGES
 	  std::cerr << "[TBB_StationTrigger::open] Failed to create group "
@@ -19,6 +19,12 @@
  ***************************************************************************/
 
 #include "TBB_Timeseries.h"
+#include <core/HDF5MappedView.h>
+
+#include <cstring>
+
+//! Maximum number of dipoles handed to the read pool as a single block
+#define TBB_TIMESERIES_READ_TASKS 128
 
 using std::cout;
 using std::endl;
@@ -40,7 +46,9 @@ namespace DAL {  // Namespace DAL -- begin
   */
   TBB_Timeseries::TBB_Timeseries ()
   {
-    location_p = -1;
+    location_p       = -1;
+    nofReadThreads_p = 0;
+    readPool_p       = NULL;
     stationGroups_p.clear();
   }
   
@@ -53,6 +61,8 @@ namespace DAL {  // Namespace DAL -- begin
   */
   TBB_Timeseries::TBB_Timeseries (std::string const &filename)
   {
+    nofReadThreads_p = 0;
+    readPool_p       = NULL;
     open (0,filename,true);
   }
 
@@ -65,6 +75,27 @@ namespace DAL {  // Namespace DAL -- begin
   */
   TBB_Timeseries::TBB_Timeseries (std::string const &filename, IO_Mode const &flags)
   {
+    nofReadThreads_p = 0;
+    readPool_p       = NULL;
+    open (0,filename,flags);
+  }
+
+  //_____________________________________________________________________________
+  //                                                               TBB_Timeseries
+
+  /*!
+    \param filename -- Name of the data file;
+    \param options  -- Tuning parameters for the access to the file; the chunk
+           cache settings apply to all dipole datasets within the file.
+    \param flags    -- I/O mode flags.
+  */
+  TBB_Timeseries::TBB_Timeseries (std::string const &filename,
+				  HDF5AccessOptions const &options,
+				  IO_Mode const &flags)
+  {
+    accessOptions_p  = options;
+    nofReadThreads_p = 0;
+    readPool_p       = NULL;
     open (0,filename,flags);
   }
 
@@ -74,11 +105,14 @@ namespace DAL {  // Namespace DAL -- begin
   TBB_Timeseries::TBB_Timeseries (CommonAttributes const &attributes)
   {
     CommonAttributes attr = attributes;
+    nofReadThreads_p      = 0;
+    readPool_p            = NULL;
     // open the new dataset
     open (0,attr.filename(),true);
     // write the LOFAR common attributes
     if (location_p>0 && H5Iis_valid(location_p)) {
       attr.h5write(location_p);
+      itsAttributeCache.invalidate();
     }
   }
   
@@ -108,6 +142,10 @@ namespace DAL {  // Namespace DAL -- begin
   
   void TBB_Timeseries::destroy ()
   {
+    if (readPool_p != NULL) {
+      delete readPool_p;
+      readPool_p = NULL;
+    }
   }
   
   // ============================================================================
@@ -138,6 +176,9 @@ namespace DAL {  // Namespace DAL -- begin
   void TBB_Timeseries::copy (TBB_Timeseries const &other)
   {
     location_p           = -1;
+    accessOptions_p      = other.accessOptions_p;
+    nofReadThreads_p     = other.nofReadThreads_p;
+    readPool_p           = NULL;
     std::string filename = other.filename_p;
     open (0,filename,false);
   }
@@ -148,6 +189,24 @@ namespace DAL {  // Namespace DAL -- begin
   //
   // ============================================================================
 
+  //_____________________________________________________________________________
+  //                                                            setNofReadThreads
+
+  /*!
+    \param nofThreads -- Number of threads converting the data of the selected
+           dipoles into the array provided to readData(); 0 to use one thread
+           per processor, 1 to convert the data from the calling thread.
+  */
+  void TBB_Timeseries::setNofReadThreads (unsigned int const &nofThreads)
+  {
+    if (nofThreads != nofReadThreads_p && readPool_p != NULL) {
+      delete readPool_p;
+      readPool_p = NULL;
+    }
+
+    nofReadThreads_p = nofThreads;
+  }
+
   //_____________________________________________________________________________
   //                                                             commonAttributes
   
@@ -193,7 +252,7 @@ namespace DAL {  // Namespace DAL -- begin
     os << "-- File name  ........... : " << filename_p                << endl;
     os << "-- Location ID .......... : " << locationID()              << endl;
     os << "-- nof. station groups .. : " << stationGroups_p.size()    << endl;
-    os << "-- nof. selected datasets : " << selectedDatasets_p.size() << endl;
+    os << "-- nof. selected datasets : " << nofSelectedDatasets()     << endl;
 
     if (location_p > 0) {
 //       CommonAttributes attr = commonAttributes();
@@ -202,7 +261,7 @@ namespace DAL {  // Namespace DAL -- begin
 //       os << "-- Project              : " << attr.projectTitle()    << endl;
 //       os << "-- Observation ID       : " << attr.observationID()   << endl;
       os << "-- nof. dipole datasets . : " << nofDipoleDatasets()       << endl;
-      os << "-- nof. selected datasets : " << selectedDatasets_p.size() << endl;
+      os << "-- nof. selected datasets : " << nofSelectedDatasets()     << endl;
     }
   }
 
@@ -257,17 +316,21 @@ namespace DAL {  // Namespace DAL -- begin
       // If the file already exists, close it ...
       infile.close();
 
+      // ... check for its table of contents, before it possibly gets modified ...
+      fileIndex_p.read (name);
+
       // and open as HDF5 file
       if ( (flags.flags() & IO_Mode::ReadOnly) ) {
         // Open read-only
-        location_p = H5Fopen (name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        location_p = HDF5Object::openExisting (name, H5F_ACC_RDONLY, accessOptions_p);
       }
       else {
         // Open read-write
-        location_p = H5Fopen (name.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+        location_p = HDF5Object::openExisting (name, H5F_ACC_RDWR, accessOptions_p);
       }
     } else {
       infile.close();
+      fileIndex_p.clear();
       location_p = 0;
     }
 
@@ -277,15 +340,20 @@ namespace DAL {  // Namespace DAL -- begin
       /* If failed to open file, check if we are supposed to create one */
       if ( (flags.flags() & IO_Mode::Create) ||
           (flags.flags() & IO_Mode::OpenOrCreate) ) {
+        hid_t creationList = accessOptions_p.fileCreationList();
+        hid_t accessList   = accessOptions_p.fileAccessList();
         location_p = H5Fcreate (name.c_str(),
             H5F_ACC_TRUNC,
-            H5P_DEFAULT,
-            H5P_DEFAULT);
+            creationList,
+            accessList);
+        HDF5AccessOptions::release (creationList);
+        HDF5AccessOptions::release (accessList);
         /* Write the common attributes attached to the root group */
         CommonAttributes attr;
         attr.h5write(location_p);
         //
         HDF5Attribute::write (location_p, "FILENAME", name );
+        itsAttributeCache.invalidate();
       } else {
         throw IOError();
       }
@@ -356,9 +424,14 @@ namespace DAL {  // Namespace DAL -- begin
     std::set<std::string> groupnames;
 
     //________________________________________________________________
-    // Obtain the number of objects attached to the root level of the file
+    // Obtain the number of objects attached to the root level of the file,
+    // from the table of contents if available
 
-    status = h5get_names (groupnames, location_p, H5G_GROUP);
+    if (fileIndex_p.isValid()) {
+      groupnames = fileIndex_p.names ("/", H5G_GROUP);
+    } else {
+      status = h5get_names (groupnames, location_p, H5G_GROUP);
+    }
     
     //________________________________________________________________
     // Iterate through the list of objects attached to the root group
@@ -367,8 +440,8 @@ namespace DAL {  // Namespace DAL -- begin
     if (groupnames.size() > 0) {
       std::set<std::string>::iterator it;
       for (it=groupnames.begin(); it!=groupnames.end(); ++it) {
-	stationGroups_p[*it] = DAL::TBB_StationGroup (location_p,
-						      *it, flags);
+	/* Open the group in place, rather than copying a temporary */
+	stationGroups_p[*it].open (location_p, *it, flags, fileIndex_p);
       }
     } else {
       throw IOError();
@@ -521,11 +594,16 @@ namespace DAL {  // Namespace DAL -- begin
   {
     std::set<std::string> selection;
     std::map<std::string,iterDipoleDataset>::iterator it;
+    std::map<std::string,TBB_StationGroup *>::iterator itRow;
 
     for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
       selection.insert(it->first);
     }    
 
+    for (itRow=selectedRows_p.begin(); itRow!=selectedRows_p.end(); ++itRow) {
+      selection.insert(itRow->first);
+    }
+
     return selection;
   }
   
@@ -580,8 +658,11 @@ namespace DAL {  // Namespace DAL -- begin
     std::map<std::string,TBB_StationGroup>::iterator iterStation;
     std::map<std::string,iterDipoleDataset> tmp;
     std::map<std::string,iterDipoleDataset>::iterator it;
+    std::map<std::string,unsigned int> rows;
+    std::map<std::string,unsigned int>::iterator itRow;
 
     selectedDatasets_p.clear();
+    selectedRows_p.clear();
 
     for (iterStation=stationGroups_p.begin();
 	 iterStation!=stationGroups_p.end();
@@ -594,6 +675,11 @@ namespace DAL {  // Namespace DAL -- begin
       for (it=tmp.begin(); it!=tmp.end(); ++it) {
 	selectedDatasets_p[it->first] = it->second;
       }
+      /* Add the dipoles stored in the station dataset */
+      rows = iterStation->second.rowSelection();
+      for (itRow=rows.begin(); itRow!=rows.end(); ++itRow) {
+	selectedRows_p[itRow->first] = &(iterStation->second);
+      }
     }
 
     return status;
@@ -905,6 +991,7 @@ namespace DAL {  // Namespace DAL -- begin
       ds_it = selectedDatasets_p.find(pos_it->first);
       if (ds_it != selectedDatasets_p.end())
       {
+        (ds_it->second)->second.openLink();
         if ((ds_it->second)->second.set_antenna_position(pos_it->second) == false)
         {
           status = false;
@@ -1147,6 +1234,387 @@ namespace DAL {  // Namespace DAL -- begin
   //
   // ============================================================================
 
+  //! Conversion of ADC samples into the array returned to the caller
+  typedef void (*TBB_SampleConverter) (short const *samples,
+				       size_t nofSamples,
+				       void *data);
+
+  //! Samples of a single dipole, waiting to be converted
+  struct TBB_DipoleSamples {
+    //! Samples read from the dataset; NULL if none
+    short const *samples;
+    //! Number of samples read from the dataset
+    size_t nofValid;
+    //! Position of the first sample read within the requested block
+    size_t offset;
+    //! Column of the dipole within the returned array
+    char *column;
+  };
+
+  //! Block of dipoles handed to the read pool
+  struct TBB_DipoleBlock {
+    //! Conversion of the samples
+    TBB_SampleConverter convert;
+    //! Size of an element of the returned array, [Bytes]
+    size_t typeSize;
+    //! Number of samples per dipole
+    size_t nofSamples;
+    //! The dipoles
+    std::vector<TBB_DipoleSamples> dipoles;
+  };
+
+  //! Copy ADC samples
+  static void convertToShort (short const *samples,
+			      size_t nofSamples,
+			      void *data)
+  {
+    memcpy (data, samples, nofSamples*sizeof(short));
+  }
+
+  //! Convert ADC samples to single precision
+  static void convertToFloat (short const *samples,
+			      size_t nofSamples,
+			      void *data)
+  {
+    TBB_DipoleDataset::convertSamples (samples, nofSamples,
+				       static_cast<float *>(data));
+  }
+
+  //! Convert ADC samples to double precision
+  static void convertToDouble (short const *samples,
+			       size_t nofSamples,
+			       void *data)
+  {
+    TBB_DipoleDataset::convertSamples (samples, nofSamples,
+				       static_cast<double *>(data));
+  }
+
+  //_____________________________________________________________________________
+  //                                                                convertDipole
+
+  /*!
+    \param task    -- Task handed out by the read pool; the data point to a
+           TBB_DipoleBlock, the subband selects the dipole within the block.
+    \param context -- Not used.
+  */
+  void TBB_Timeseries::convertDipole (BF_TaskPool::Task const &task,
+				      void *context)
+  {
+    (void)context;
+
+    TBB_DipoleBlock const *block    = static_cast<TBB_DipoleBlock const *>(task.data);
+    size_t index                    = size_t(task.blockNr)*TBB_TIMESERIES_READ_TASKS
+      + task.subband;
+    TBB_DipoleSamples const &dipole = block->dipoles[index];
+    size_t tail                     = block->nofSamples - dipole.offset - dipole.nofValid;
+
+    /* Samples outside the dataset are set to zero */
+    memset (dipole.column, 0, dipole.offset*block->typeSize);
+    if (dipole.nofValid > 0) {
+      block->convert (dipole.samples,
+		      dipole.nofValid,
+		      dipole.column + dipole.offset*block->typeSize);
+    }
+    memset (dipole.column + (dipole.offset+dipole.nofValid)*block->typeSize,
+	    0,
+	    tail*block->typeSize);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                  readDipoles
+
+  /*!
+    \retval data      -- Array returned to the caller.
+    \param datatype   -- Datatype of the elements of \e data; one of
+           H5T_NATIVE_SHORT, H5T_NATIVE_FLOAT or H5T_NATIVE_DOUBLE.
+    \param start      -- Number of the sample at which to start reading, per
+           selected dipole.
+    \param nofSamples -- Number of samples to read per dipole.
+    \param stride     -- Separation of the columns of the dipoles within
+           \e data, [elements]; 0 for columns following each other.
+    \return status    -- Returns \e false if the parameters are inconsistent,
+            or if the data of one of the dipoles could not be read; the
+            samples which could not be read are set to zero.
+  */
+  bool TBB_Timeseries::readDipoles (void *data,
+				    hid_t const &datatype,
+				    std::vector<int> const &start,
+				    int const &nofSamples,
+				    size_t const &stride)
+  {
+    std::set<std::string> names = selectedDipoles();
+    unsigned int nofDipoles     = names.size();
+    size_t columnStride         = stride > 0 ? stride : size_t(nofSamples);
+    TBB_DipoleBlock block;
+
+    // Check input parameters ______________________________
+
+    if (data == NULL || nofSamples < 0 || columnStride < size_t(nofSamples)) {
+      std::cerr << "[TBB_Timeseries::readData] Invalid output array: "
+		<< nofSamples << " samples per dipole, stride " << stride
+		<< std::endl;
+      return false;
+    }
+
+    if (start.size() != nofDipoles) {
+      std::cerr << "[TBB_Timeseries::readData]"
+		<< " Wrong length of vector with start positions!"
+		<< std::endl;
+      std::cerr << " -- size(selection) = " << nofDipoles   << std::endl;
+      std::cerr << " -- size(start)     = " << start.size() << std::endl;
+      return false;
+    }
+
+    if (H5Tequal (datatype, H5T_NATIVE_SHORT) > 0) {
+      block.convert = convertToShort;
+    } else if (H5Tequal (datatype, H5T_NATIVE_FLOAT) > 0) {
+      block.convert = convertToFloat;
+    } else if (H5Tequal (datatype, H5T_NATIVE_DOUBLE) > 0) {
+      block.convert = convertToDouble;
+    } else {
+      std::cerr << "[TBB_Timeseries::readData] Unsupported datatype!" << std::endl;
+      return false;
+    }
+
+    if (nofDipoles == 0 || nofSamples == 0) {
+      return true;
+    }
+
+    block.typeSize   = H5Tget_size (datatype);
+    block.nofSamples = nofSamples;
+    block.dipoles.resize (nofDipoles);
+
+    // Access the datasets _________________________________
+
+    /* All calls into the HDF5 library are made from this thread; the views
+       either map the samples from the file, or hold a copy read through the
+       library. */
+
+    bool status (true);
+    unsigned int n (0);
+    std::vector<HDF5MappedView *> views (nofDipoles, (HDF5MappedView *)NULL);
+    std::map<std::string,iterDipoleDataset>::iterator it;
+    std::set<std::string>::iterator itName;
+    std::map<std::string,unsigned int> column;
+
+    /* Columns of the selected dipoles, in the order of their names */
+    for (itName=names.begin(); itName!=names.end(); ++itName, ++n) {
+      column[*itName] = n;
+    }
+
+    for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
+      n = column[it->first];
+      TBB_DipoleSamples &dipole = block.dipoles[n];
+      TBB_DipoleDataset &dataset = it->second->second;
+
+      dipole.samples  = NULL;
+      dipole.nofValid = 0;
+      dipole.offset   = 0;
+      dipole.column   = static_cast<char *>(data) + n*columnStride*block.typeSize;
+
+      /* The dataset is opened on first use */
+      if (!dataset.openLink()) {
+	status = false;
+	continue;
+      }
+
+      std::vector<hsize_t> shape = dataset.shape();
+
+      /* Overlap of the requested block with the dataset */
+      long first = start[n] > 0 ? start[n] : 0;
+      long last  = long(start[n]) + nofSamples;
+
+      if (shape.size() == 1 && last > long(shape[0])) {
+	last = shape[0];
+      }
+
+      if (shape.size() != 1 || last <= first) {
+	if (shape.size() != 1) {
+	  status = false;
+	}
+	continue;
+      }
+
+      std::vector<int> sliceStart (1, first);
+      std::vector<int> sliceBlock (1, last-first);
+
+      views[n] = new HDF5MappedView;
+
+      if (views[n]->open (dataset.locationID(),
+			  H5T_NATIVE_SHORT,
+			  HDF5Hyperslab (sliceStart, sliceBlock))) {
+	dipole.samples  = views[n]->data<short>();
+	dipole.nofValid = last-first;
+	dipole.offset   = first-start[n];
+      } else {
+	std::cerr << "[TBB_Timeseries::readData] Failed to read samples of dipole "
+		  << it->first << std::endl;
+	status = false;
+      }
+    }
+
+    /* Dipoles stored as rows of a station dataset are read with a single call
+       per station, into a buffer held until the samples have been converted. */
+
+    std::map<TBB_StationGroup *,std::vector<std::string> > stations;
+    std::map<TBB_StationGroup *,std::vector<std::string> >::iterator itStation;
+    std::map<std::string,TBB_StationGroup *>::iterator itRow;
+    std::vector<short *> rowBuffers;
+
+    for (itRow=selectedRows_p.begin(); itRow!=selectedRows_p.end(); ++itRow) {
+      if (selectedDatasets_p.find(itRow->first) == selectedDatasets_p.end()) {
+	stations[itRow->second].push_back (itRow->first);
+      }
+    }
+
+    for (itStation=stations.begin(); itStation!=stations.end(); ++itStation) {
+      std::vector<std::string> const &dipoles      = itStation->second;
+      std::map<std::string,unsigned int> selection = itStation->first->rowSelection();
+      std::vector<unsigned int> rows (dipoles.size());
+      std::vector<int> rowStart (dipoles.size());
+      short *buffer = new short [dipoles.size()*size_t(nofSamples)];
+
+      rowBuffers.push_back (buffer);
+
+      for (unsigned int k=0; k<dipoles.size(); ++k) {
+	rows[k]     = selection[dipoles[k]];
+	rowStart[k] = start[column[dipoles[k]]];
+      }
+
+      bool valid = itStation->first->stationDataset().readData (buffer,
+								  rows,
+								  rowStart,
+								  nofSamples);
+      if (!valid) {
+	std::cerr << "[TBB_Timeseries::readData] Failed to read samples of station "
+		  << itStation->first->group_name(true) << std::endl;
+	status = false;
+      }
+
+      for (unsigned int k=0; k<dipoles.size(); ++k) {
+	n = column[dipoles[k]];
+	TBB_DipoleSamples &dipole = block.dipoles[n];
+	dipole.samples  = valid ? buffer + k*size_t(nofSamples) : NULL;
+	dipole.nofValid = valid ? nofSamples : 0;
+	dipole.offset   = 0;
+	dipole.column   = static_cast<char *>(data) + n*columnStride*block.typeSize;
+      }
+    }
+
+    // Convert the samples _________________________________
+
+    unsigned int nofBlocks = (nofDipoles+TBB_TIMESERIES_READ_TASKS-1)/TBB_TIMESERIES_READ_TASKS;
+
+    if (nofReadThreads_p == 1 || nofDipoles == 1) {
+      BF_TaskPool::Task task;
+      task.data = &block;
+      for (n=0; n<nofDipoles; ++n) {
+	task.blockNr = n/TBB_TIMESERIES_READ_TASKS;
+	task.subband = n%TBB_TIMESERIES_READ_TASKS;
+	convertDipole (task, NULL);
+      }
+    } else {
+      if (readPool_p == NULL) {
+	readPool_p = new BF_TaskPool (nofReadThreads_p,
+				      TBB_TIMESERIES_READ_TASKS,
+				      convertDipole);
+	readPool_p->start();
+      }
+      for (unsigned int b=0; b<nofBlocks; ++b) {
+	unsigned int nofTasks = nofDipoles - b*TBB_TIMESERIES_READ_TASKS;
+	if (nofTasks > TBB_TIMESERIES_READ_TASKS) {
+	  nofTasks = TBB_TIMESERIES_READ_TASKS;
+	}
+	readPool_p->submit (b, nofTasks, &block);
+      }
+      readPool_p->waitIdle();
+    }
+
+    // Release the views ___________________________________
+
+    for (n=0; n<nofDipoles; ++n) {
+      delete views[n];
+    }
+
+    for (n=0; n<rowBuffers.size(); ++n) {
+      delete [] rowBuffers[n];
+    }
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     readData
+
+  /*!
+    \retval data      -- [nofSamples,dipole] Array of raw ADC samples, owned by
+            the caller; the samples of the n-th selected dipole start at
+            <tt>data+n*stride</tt>.
+    \param start      -- Number of the sample at which to start reading, per
+           selected dipole; samples before the start or beyond the end of a
+           dataset are set to zero.
+    \param nofSamples -- Number of samples to read per dipole.
+    \param stride     -- Separation of the columns of the dipoles within
+           \e data, [elements]; 0 for columns following each other.
+    \return status    -- Returns \e false if the parameters are inconsistent,
+            or if the data of one of the dipoles could not be read.
+  */
+  bool TBB_Timeseries::readData (short *data,
+				 std::vector<int> const &start,
+				 int const &nofSamples,
+				 size_t const &stride)
+  {
+    return readDipoles (data, H5T_NATIVE_SHORT, start, nofSamples, stride);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     readData
+
+  /*!
+    \retval data      -- [nofSamples,dipole] Array of ADC samples, owned by
+            the caller; the samples of the n-th selected dipole start at
+            <tt>data+n*stride</tt>.
+    \param start      -- Number of the sample at which to start reading, per
+           selected dipole; samples before the start or beyond the end of a
+           dataset are set to zero.
+    \param nofSamples -- Number of samples to read per dipole.
+    \param stride     -- Separation of the columns of the dipoles within
+           \e data, [elements]; 0 for columns following each other.
+    \return status    -- Returns \e false if the parameters are inconsistent,
+            or if the data of one of the dipoles could not be read.
+  */
+  bool TBB_Timeseries::readData (float *data,
+				 std::vector<int> const &start,
+				 int const &nofSamples,
+				 size_t const &stride)
+  {
+    return readDipoles (data, H5T_NATIVE_FLOAT, start, nofSamples, stride);
+  }
+
+  //_____________________________________________________________________________
+  //                                                                     readData
+
+  /*!
+    \retval data      -- [nofSamples,dipole] Array of ADC samples, owned by
+            the caller; the samples of the n-th selected dipole start at
+            <tt>data+n*stride</tt>.
+    \param start      -- Number of the sample at which to start reading, per
+           selected dipole; samples before the start or beyond the end of a
+           dataset are set to zero.
+    \param nofSamples -- Number of samples to read per dipole.
+    \param stride     -- Separation of the columns of the dipoles within
+           \e data, [elements]; 0 for columns following each other.
+    \return status    -- Returns \e false if the parameters are inconsistent,
+            or if the data of one of the dipoles could not be read.
+  */
+  bool TBB_Timeseries::readData (double *data,
+				 std::vector<int> const &start,
+				 int const &nofSamples,
+				 size_t const &stride)
+  {
+    return readDipoles (data, H5T_NATIVE_DOUBLE, start, nofSamples, stride);
+  }
+
 #ifdef DAL_WITH_CASA
 
   //_____________________________________________________________________________
@@ -1187,7 +1655,7 @@ namespace DAL {  // Namespace DAL -- begin
 				 casa::Vector<int> const &start,
 				 int const &nofSamples)
   {
-    uint sizeSelection = selectedDatasets_p.size();
+    uint sizeSelection = nofSelectedDatasets();
     uint sizeStart     = start.nelements();
     casa::IPosition shape (2,nofSamples,sizeSelection);
     
@@ -1211,22 +1679,15 @@ namespace DAL {  // Namespace DAL -- begin
     }
     
     // Retrieve data from file _____________________________
-    
-    bool status (true);
-    uint n (0);
-    casa::Vector<double> tmp (nofSamples);
-    std::map<std::string,iterDipoleDataset>::iterator it;
-    
-    /* Iterate over the selected dipoles */
-    for (it=selectedDatasets_p.begin(); it!=selectedDatasets_p.end(); ++it) {
-      /* Retrieve dipole data */
-      tmp = (it->second)->second.readData(start(n),nofSamples);
-      /* Copy the data to the returned array */
-      data.column(n) = tmp;
-      /* Increment data array column counter */
-      ++n;
+
+    /* The columns of the matrix are stored one after the other */
+    std::vector<int> startPositions (sizeStart);
+    for (uint n=0; n<sizeStart; ++n) {
+      startPositions[n] = start(n);
     }
 
+    bool status = readData (data.data(), startPositions, nofSamples);
+
     // Feedback ____________________________________________
 
 #ifdef DAL_DEBUGGING_MESSAGES
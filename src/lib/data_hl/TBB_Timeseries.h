@@ -26,8 +26,10 @@
 #include <casa/BasicSL/String.h>
 #endif
 
+#include <core/HDF5FileIndex.h>
 #include <data_common/CommonAttributes.h>
 #include <data_common/HDF5GroupBase.h>
+#include <data_hl/BF_TaskPool.h>
 #include <data_hl/SysLog.h>
 #include <data_hl/TBB_StationGroup.h>
 #include <data_hl/TBB_StationTrigger.h>
@@ -137,6 +139,24 @@ namespace DAL {  // Namespace DAL -- begin
       additional values almost certainly will not be used (at least not for a
       long time).
     </ul>
+
+    The ADC values of the selected dipoles can be read directly into an array
+    owned by the caller, holding \c short, \c float or \c double values; the
+    samples of dipole \e n start at <tt>data+n*stride</tt>, i.e. with the
+    default stride the array has the column-major layout of a
+    <tt>[nofSamples,dipole]</tt> matrix. The datasets are accessed one after
+    the other from the calling thread -- through a DAL::HDF5MappedView, such that
+    contiguous datasets are mapped from the file rather than copied --, while
+    the conversion into the array is distributed over a DAL::BF_TaskPool, one
+    task per dipole (see setNofReadThreads()). Dipoles stored as the rows of a
+    DAL::TBB_StationDataset are read with a single call per station. Either
+    way the columns of the array follow the order of the dipole names, as
+    returned by selectedDipoles().
+
+    If the file comes with an up-to-date DAL::HDF5FileIndex -- as written by
+    DAL::TBBraw::setWriteIndex() --, the station groups and dipole datasets
+    are taken from the index, instead of iterating over the links of the root
+    group and of every station group.
     
     <h3>Example(s)</h3>
 
@@ -146,6 +166,14 @@ namespace DAL {  // Namespace DAL -- begin
       // Get the values of DATA_LENGTH for all present datasets
       std::vector<uint> dataength = ts.data_length ();
       \endcode
+
+      <li>Read a block of samples for all selected dipoles:
+      \code
+      std::vector<int> start (ts.nofSelectedDatasets(), 0);
+      std::vector<float> data (start.size()*nofSamples);
+
+      ts.readData (&data[0], start, nofSamples);
+      \endcode
     </ol>
     
   */
@@ -164,6 +192,16 @@ namespace DAL {  // Namespace DAL -- begin
     std::map<std::string,TBB_StationGroup> stationGroups_p;
     //! Selected dipoles
     std::map<std::string,iterDipoleDataset> selectedDatasets_p;
+    //! Selected dipoles stored as rows of a station dataset, with their station
+    std::map<std::string,TBB_StationGroup *> selectedRows_p;
+    //! Tuning parameters for the access to the file
+    HDF5AccessOptions accessOptions_p;
+    //! Number of threads converting the data of the selected dipoles
+    unsigned int nofReadThreads_p;
+    //! Pool of threads converting the data of the selected dipoles
+    BF_TaskPool *readPool_p;
+    //! Table of contents of the file, if an up-to-date one was found
+    HDF5FileIndex fileIndex_p;
     
   public:
     
@@ -175,6 +213,10 @@ namespace DAL {  // Namespace DAL -- begin
     TBB_Timeseries (std::string const &filename);
     //! Open file with IO_Mode flags
     TBB_Timeseries (std::string const &filename, IO_Mode const &flags);
+    //! Open file with tuning parameters for the file access and IO_Mode flags
+    TBB_Timeseries (std::string const &filename,
+		    HDF5AccessOptions const &options,
+		    IO_Mode const &flags=IO_Mode(IO_Mode::ReadOnly));
     //! Create a new dataset from LOFAR common attributes
     TBB_Timeseries (CommonAttributes const &attributes);
     //! Copy constructor
@@ -204,6 +246,19 @@ namespace DAL {  // Namespace DAL -- begin
     inline std::string filename () const {
       return filename_p;
     }
+
+    //! Get the tuning parameters for the access to the file
+    inline HDF5AccessOptions accessOptions () const {
+      return accessOptions_p;
+    }
+
+    //! Get the number of threads converting the data of the selected dipoles
+    inline unsigned int nofReadThreads () const {
+      return nofReadThreads_p;
+    }
+
+    //! Set the number of threads converting the data of the selected dipoles
+    void setNofReadThreads (unsigned int const &nofThreads);
     
     /*!
       \brief Get the name of the class
@@ -324,7 +379,7 @@ namespace DAL {  // Namespace DAL -- begin
     std::set<std::string> selectedDipoles ();
     //! Set the set of selected dipoles
     bool selectDipoles (std::set<std::string> const &selection);
-    //! Get the map constaining the actual dipole dataset selection
+    //! Get the map constaining the actual dipole dataset selection (without station datasets)
     inline std::map<std::string,iterDipoleDataset> dipoleSelection () const {
       return selectedDatasets_p;
     }
@@ -384,6 +439,22 @@ namespace DAL {  // Namespace DAL -- begin
     //! Get the Nyquist zone for the A/D conversion
     std::vector<uint> nyquist_zone ();
 
+    //! Retrieve a block of ADC values per dipole into a caller-owned array
+    bool readData (short *data,
+		   std::vector<int> const &start,
+		   int const &nofSamples,
+		   size_t const &stride=0);
+    //! Retrieve a block of ADC values per dipole into a caller-owned array
+    bool readData (float *data,
+		   std::vector<int> const &start,
+		   int const &nofSamples,
+		   size_t const &stride=0);
+    //! Retrieve a block of ADC values per dipole into a caller-owned array
+    bool readData (double *data,
+		   std::vector<int> const &start,
+		   int const &nofSamples,
+		   size_t const &stride=0);
+
 #ifdef DAL_WITH_CASA
     //! Retrieve a block of ADC values per dipole
     bool readData (casa::Matrix<double> &data,
@@ -415,6 +486,15 @@ namespace DAL {  // Namespace DAL -- begin
     bool openStationGroups (IO_Mode const &flags=IO_Mode(IO_Mode::OpenOrCreate));
     //! Set local map used for book-keeping on selected dipole datasets
     bool setSelectedDatasets ();
+    //! Retrieve the data of the selected dipoles, converted to \e datatype
+    bool readDipoles (void *data,
+		      hid_t const &datatype,
+		      std::vector<int> const &start,
+		      int const &nofSamples,
+		      size_t const &stride);
+    //! Convert the data of a single dipole, called by the read pool
+    static void convertDipole (BF_TaskPool::Task const &task,
+			       void *context);
     //! Unconditional copying
     void copy (TBB_Timeseries const &other);
     //! Unconditional deletion
@@ -90,7 +90,15 @@ namespace DAL {  // Namespace DAL -- begin
 
     fixTimes_p           = 2;
     nofDiscardedHeader_p = 0;
+    nofDiscardedData_p   = 0;
     nofProcessed_p       = 0;
+    nofWritten_p         = 0;
+    writeBufferSize_p    = TBBRAW_WRITE_BUFFER_CHUNKS*CHUNK_SIZE;
+    nofWrites_p          = 0;
+    filters_p            = HDF5FilterPipeline();
+    chunkWriter_p        = NULL;
+    stationLayout_p      = false;
+    writeIndex_p         = false;
 
     //initialize the buffers
     int i;
@@ -99,12 +107,26 @@ namespace DAL {  // Namespace DAL -- begin
       {
         stationBuf[i].ID =0;
         stationBuf[i].group = NULL;
+        stationBuf[i].data = NULL;
       };
     dipoleBuf = new dipoleBufElem [MAX_NO_DIPOLES];
     for (i=0; i<MAX_NO_DIPOLES; i++)
       {
         dipoleBuf[i].ID = 0;
         dipoleBuf[i].array = NULL;
+        dipoleBuf[i].stage = NULL;
+        dipoleBuf[i].stageStart = 0;
+        dipoleBuf[i].stageLength = 0;
+        dipoleBuf[i].dataEnd = 0;
+        dipoleBuf[i].station = -1;
+        dipoleBuf[i].row = -1;
+      };
+    nofStations_p = 0;
+    nofDipoles_p  = 0;
+    for (i=0; i<256; i++)
+      {
+        stationLookup_p[i] = -1;
+        dipoleLookup_p[i]  = NULL;
       };
     
   }
@@ -189,6 +211,9 @@ namespace DAL {  // Namespace DAL -- begin
   void TBBraw::destroy()
   {
     int i;
+    flush();
+    delete chunkWriter_p;
+    chunkWriter_p = NULL;
     for (i=0; i<MAX_NO_DIPOLES; i++)
       {
         if ( dipoleBuf[i].array != NULL )
@@ -196,19 +221,31 @@ namespace DAL {  // Namespace DAL -- begin
             dipoleBuf[i].array->close();
             delete dipoleBuf[i].array;
           };
+        delete [] dipoleBuf[i].stage;
       };
     for (i=0; i<MAX_NO_STATIONS; i++)
       {
+        // the station dataset writes its dipole table upon destruction
+        delete stationBuf[i].data;
         if ( stationBuf[i].group != NULL )
           {
             stationBuf[i].group->close();
             delete stationBuf[i].group;
           };
       };
+    for (i=0; i<256; i++)
+      {
+        delete [] dipoleLookup_p[i];
+      };
     if (dataset_p != NULL)
       {
         delete dataset_p;
         dataset_p=NULL;
+        // the file is closed now, so its size and time stamp are final
+        if (writeIndex_p)
+          {
+            HDF5FileIndex::update (itsFilename);
+          };
       };
     delete [] stationBuf;
     delete [] dipoleBuf;
@@ -226,17 +263,32 @@ namespace DAL {  // Namespace DAL -- begin
   bool TBBraw::processTBBrawBlock (char *inbuff,
 				   int datalen,
 				   bool bigEndian)
+  {
+    if (!prepareTBBrawBlock(inbuff, datalen, bigEndian))
+      {
+        return false;
+      };
+
+    return writeTBBrawBlock(inbuff);
+  };
+
+  //_____________________________________________________________________________
+  //                                                           prepareTBBrawBlock
+  
+  bool TBBraw::prepareTBBrawBlock (char *inbuff,
+				   int datalen,
+				   bool bigEndian)
   {
     TBB_Header *headerp;
 
     if (bigEndian)
       {
-        cout << "TBBraw::processTBBrawBlock: Big endian support is untested! "
+        cout << "TBBraw::prepareTBBrawBlock: Big endian support is untested! "
              << "If you actually need it, test it first!!!" << endl;
       };
     if (datalen < TBB_FRAME_SIZE)
       {
-        cerr << "TBBraw::processTBBrawBlock: Block too small! datalen: " << datalen << endl;
+        cerr << "TBBraw::prepareTBBrawBlock: Block too small! datalen: " << datalen << endl;
         return false;
       };
     nofProcessed_p++;
@@ -261,7 +313,7 @@ namespace DAL {  // Namespace DAL -- begin
 
     if (headerp->n_freq_bands != 0)
       {
-        cerr << "TBBraw::processTBBrawBlock: Can only process raw(=transient) data!" << endl;
+        cerr << "TBBraw::prepareTBBrawBlock: Can only process raw(=transient) data!" << endl;
         return false;
       };
 
@@ -274,18 +326,60 @@ namespace DAL {  // Namespace DAL -- begin
         fixDateOld(headerp);
       };
 
+    //the payload CRC follows the samples
+    int nofWords = headerp->n_samples_per_frame;
+    if (datalen < (int)(nofWords*sizeof(short)+sizeof(TBB_Header)))
+      {
+        cerr << "TBBraw::prepareTBBrawBlock: Too few data read in! Aborting." << endl;
+        cerr << "  block size: " << datalen << " bytes, estimated size: "
+             << (nofWords*sizeof(short)+sizeof(TBB_Header))
+             << " bytes" << endl;
+        return false;
+      };
+    if (do_dataCRC_p)
+      {
+        if (datalen < (int)(nofWords*sizeof(short)+sizeof(TBB_Header)+4))
+          {
+            nofDiscardedData_p++;
+            return false;
+          };
+        nofWords += 2;
+      };
+
+    if ( bigendian_p != bigEndian )
+      {
+        swapbytes16( inbuff+sizeof(TBB_Header), nofWords );
+      };
+
+    if (do_dataCRC_p && !checkDataCRC(headerp))
+      {
+        nofDiscardedData_p++;
+        return false;
+      };
+
+    return true;
+  };
+
+  //_____________________________________________________________________________
+  //                                                             writeTBBrawBlock
+  
+  bool TBBraw::writeTBBrawBlock (char *inbuff)
+  {
+    TBB_Header *headerp = (TBB_Header*)inbuff;
+
     int index = getDipoleIndex(headerp);
     if ((index<0) || (index>=MAX_NO_DIPOLES))
       {
-        cerr << "TBBraw::processTBBrawBlock: Failed to get Dipole Index!" << endl;
+        cerr << "TBBraw::writeTBBrawBlock: Failed to get Dipole Index!" << endl;
         return false;
       };
 
-    if (!addDataToDipole( index, inbuff, datalen, bigEndian))
+    if (!addDataToDipole(index, inbuff))
       {
         return false;
       }
 
+    nofWritten_p++;
     return true;
   };
 
@@ -303,8 +397,108 @@ namespace DAL {  // Namespace DAL -- begin
     // Processing statistics
     os << "-- nof. processed data blocks ... : " << nofProcessed_p       << endl;
     os << "-- nof. blocks with broken header : " << nofDiscardedHeader_p << endl;
-    os << "-- nof. blocks written to file .. : "
-       << (nofProcessed_p-nofDiscardedHeader_p) << endl;
+    os << "-- nof. blocks with broken data . : " << nofDiscardedData_p   << endl;
+    os << "-- nof. blocks written to file .. : " << nofWritten_p         << endl;
+    os << "-- Write buffer size [samples] .. : " << writeBufferSize_p    << endl;
+    os << "-- nof. array write operations .. : " << nofWrites_p          << endl;
+    os << "-- Compression threads .......... : " << compressionThreads() << endl;
+    os << "-- Station layout ............... : " << stationLayout_p      << endl;
+  }
+
+  //_____________________________________________________________________________
+  //                                                                        flush
+
+  bool TBBraw::flush ()
+  {
+    bool status = true;
+
+    for (int i=0; i<nofDipoles_p; i++)
+      {
+        status &= flushDipole(i);
+      };
+
+    // chunks still being compressed have to be stored before trimming
+    if (chunkWriter_p != NULL)
+      {
+        status &= chunkWriter_p->flush();
+      };
+
+    std::vector<int> stationEnd (nofStations_p, 0);
+
+    for (int i=0; i<nofDipoles_p; i++)
+      {
+        if (dipoleBuf[i].array == NULL)
+          {
+            if ((dipoleBuf[i].station >= 0) &&
+                (dipoleBuf[i].dataEnd > stationEnd[dipoleBuf[i].station]))
+              {
+                stationEnd[dipoleBuf[i].station] = dipoleBuf[i].dataEnd;
+              };
+            continue;
+          };
+        // trim the array to the data actually written
+        if (dipoleBuf[i].dimensions[0] > dipoleBuf[i].dataEnd)
+          {
+            dipoleBuf[i].dimensions[0] = dipoleBuf[i].dataEnd;
+            status &= dipoleBuf[i].array->resize(dipoleBuf[i].dimensions);
+          };
+      };
+
+    // trim the station datasets to the longest row, and store the dipole tables
+    for (int i=0; i<nofStations_p; i++)
+      {
+        TBB_StationDataset *station = stationBuf[i].data;
+        if (station == NULL)
+          {
+            continue;
+          };
+        if (station->nofSamples() > hsize_t(stationEnd[i]))
+          {
+            status &= station->resize(stationEnd[i]);
+          };
+        status &= station->flush();
+      };
+
+    return status;
+  }
+
+  //_____________________________________________________________________________
+  //                                                        setCompressionThreads
+
+  void TBBraw::setCompressionThreads (unsigned int const &nofThreads)
+  {
+    if (chunkWriter_p != NULL)
+      {
+        chunkWriter_p->flush();
+        delete chunkWriter_p;
+        chunkWriter_p = NULL;
+      };
+    if (nofThreads > 0)
+      {
+        chunkWriter_p = new HDF5ChunkWriter(nofThreads);
+      };
+  }
+
+  //_____________________________________________________________________________
+  //                                                           setWriteBufferSize
+
+  void TBBraw::setWriteBufferSize (int const &nofSamples)
+  {
+    int nofChunks = (nofSamples+CHUNK_SIZE-1)/CHUNK_SIZE;
+
+    if (nofChunks < 2)
+      {
+        nofChunks = 2;
+      };
+
+    // the staging buffers are (re-)allocated on demand
+    flush();
+    for (int i=0; i<MAX_NO_DIPOLES; i++)
+      {
+        delete [] dipoleBuf[i].stage;
+        dipoleBuf[i].stage = NULL;
+      };
+    writeBufferSize_p = nofChunks*CHUNK_SIZE;
   }
 
   // ============================================================================
@@ -332,6 +526,20 @@ namespace DAL {  // Namespace DAL -- begin
     return (CRC == 0);
   }
 
+  //_____________________________________________________________________________
+  //                                                                 checkDataCRC
+
+  /*!
+    Check the CRC of the payload of a TBB frame, i.e. the samples followed by
+    the 32-bit CRC. Uses CRC32. Returns TRUE if OK, FALSE otherwise.
+  */
+  bool TBBraw::checkDataCRC(TBB_Header *headerp)
+  {
+    uint16_t * payloadBuf = reinterpret_cast<uint16_t*> (headerp+1);
+
+    return (DAL::crc32(payloadBuf, headerp->n_samples_per_frame+2) == 0);
+  }
+
   //_____________________________________________________________________________
   //                                                                   fixDateOld
   
@@ -401,26 +609,16 @@ namespace DAL {  // Namespace DAL -- begin
   
   int TBBraw::getDipoleIndex(TBB_Header *headerp)
   {
-    int i, dipoleIndex=-1;
-    unsigned int dipoleID;
+    short *lookup = dipoleLookup_p[headerp->stationid];
 
-    dipoleID = headerp->stationid*1000000 + headerp->rspid*1000 + headerp->rcuid;
-    
-    for (i=0; i<MAX_NO_DIPOLES; i++) {
-      if ( dipoleBuf[i].ID == dipoleID) {
-	dipoleIndex=i;
-	break;
-      };
-      if (dipoleBuf[i].array == NULL) {
-	break;
-      };
-    }
-    if (dipoleIndex != -1) {
-      return dipoleIndex;
-    }
-    else {
-      return createNewDipole(headerp);
+    if (lookup != NULL) {
+      short dipoleIndex = lookup[(headerp->rspid<<8) | headerp->rcuid];
+      if (dipoleIndex >= 0) {
+	return dipoleIndex;
+      };
     };
+
+    return createNewDipole(headerp);
   };
   
   //_____________________________________________________________________________
@@ -428,25 +626,12 @@ namespace DAL {  // Namespace DAL -- begin
   
   int TBBraw::createNewDipole(TBB_Header *headerp)
   {
-    int i            = 0;
     int stationIndex = -1;
-    int numDipole  = -1;
-    unsigned int stationID, dipoleID;
+    int numDipole    = -1;
+    unsigned int dipoleID;
     
     // find the corresponding staion index
-    stationID = headerp->stationid;
-    for (i=0; i<MAX_NO_STATIONS; i++)
-      {
-        if ( stationBuf[i].ID == stationID)
-          {
-            stationIndex=i;
-            break;
-          };
-        if (stationBuf[i].group == NULL)
-          {
-            break;
-          };
-      }
+    stationIndex = stationLookup_p[headerp->stationid];
     if (stationIndex == -1)
       {
         stationIndex = createNewStation(headerp);
@@ -456,14 +641,8 @@ namespace DAL {  // Namespace DAL -- begin
         cerr << "TBBraw::createNewDipole: createNewStation() returned -1!" << endl;
         return -1;
       };
-    // find an empty dipole index
-    for (numDipole=0; numDipole<MAX_NO_DIPOLES; numDipole++)
-      {
-        if (dipoleBuf[numDipole].array == NULL)
-          {
-            break;
-          };
-      };
+    // take the next empty dipole index
+    numDipole = nofDipoles_p;
     if (numDipole == MAX_NO_DIPOLES)
       {
         cerr << "TBBraw::createNewDipole: Buffer \"dipoleBuf\" is full, cannot create new dipole!" <<endl;
@@ -471,6 +650,11 @@ namespace DAL {  // Namespace DAL -- begin
       };
     
     // Now we have the station and dipole index -> create the dipole
+
+    if (stationBuf[stationIndex].data != NULL)
+      {
+        return createNewRow(headerp, stationIndex, numDipole);
+      };
     
     std::vector<int> firstdims(1,0);
     std::vector<int> cdims(1,CHUNK_SIZE);
@@ -479,12 +663,15 @@ namespace DAL {  // Namespace DAL -- begin
     char newDipoleIDstr[10];
     sprintf(newDipoleIDstr, "%03d%03d%03d", headerp->stationid, headerp->rspid, headerp->rcuid);
     dipoleBuf[numDipole].array =  //see next line
-      stationBuf[stationIndex].group->createShortArray( newDipoleIDstr, firstdims, nodata, cdims );
+      stationBuf[stationIndex].group->createShortArray( newDipoleIDstr, firstdims, nodata, cdims, filters_p );
 
     dipoleID = headerp->stationid*1000000 + headerp->rspid*1000 + headerp->rcuid;
     dipoleBuf[numDipole].ID = dipoleID;
     dipoleBuf[numDipole].dimensions.resize(1);
-    dipoleBuf[numDipole].dimensions[0] = 1;
+    dipoleBuf[numDipole].dimensions[0] = 0;
+    dipoleBuf[numDipole].stageStart = 0;
+    dipoleBuf[numDipole].stageLength = 0;
+    dipoleBuf[numDipole].dataEnd = 0;
     dipoleBuf[numDipole].starttime = headerp->time;
     dipoleBuf[numDipole].startsamplenum = headerp->sample_nr;
 
@@ -530,6 +717,53 @@ namespace DAL {  // Namespace DAL -- begin
     cout << "CREATED New dipole group: " << newDipoleIDstr << endl;
 #endif
 
+    // register the dipole for lookup by getDipoleIndex()
+    dipoleLookup_p[headerp->stationid][(headerp->rspid<<8) | headerp->rcuid] = numDipole;
+    nofDipoles_p++;
+
+    return numDipole;
+  };
+
+  //_____________________________________________________________________________
+  //                                                                 createNewRow
+
+  int TBBraw::createNewRow(TBB_Header *headerp,
+                           int stationIndex,
+                           int numDipole)
+  {
+    TBB_StationDataset::Dipole dipole;
+
+    dipole.stationID       = headerp->stationid;
+    dipole.rspID           = headerp->rspid;
+    dipole.rcuID           = headerp->rcuid;
+    dipole.time            = headerp->time;
+    dipole.sampleNumber    = headerp->sample_nr;
+    dipole.samplesPerFrame = headerp->n_samples_per_frame;
+    dipole.sampleFrequency = headerp->sample_freq;
+    dipole.dataLength      = 0;
+
+    int row = stationBuf[stationIndex].data->addDipole(dipole);
+    if (row < 0)
+      {
+        cerr << "TBBraw::createNewRow: Failed to add the dipole to the station dataset!" << endl;
+        return -1;
+      };
+
+    dipoleBuf[numDipole].ID = headerp->stationid*1000000 + headerp->rspid*1000 + headerp->rcuid;
+    dipoleBuf[numDipole].array = NULL;
+    dipoleBuf[numDipole].dimensions.clear();
+    dipoleBuf[numDipole].stageStart = 0;
+    dipoleBuf[numDipole].stageLength = 0;
+    dipoleBuf[numDipole].dataEnd = 0;
+    dipoleBuf[numDipole].starttime = headerp->time;
+    dipoleBuf[numDipole].startsamplenum = headerp->sample_nr;
+    dipoleBuf[numDipole].station = stationIndex;
+    dipoleBuf[numDipole].row = row;
+
+    // register the dipole for lookup by getDipoleIndex()
+    dipoleLookup_p[headerp->stationid][(headerp->rspid<<8) | headerp->rcuid] = numDipole;
+    nofDipoles_p++;
+
     return numDipole;
   };
 
@@ -545,14 +779,8 @@ namespace DAL {  // Namespace DAL -- begin
       return -1;
     };
     
-    // find an empty station index
-    for (stationIndex=0; stationIndex<MAX_NO_STATIONS; stationIndex++)
-      {
-        if (stationBuf[stationIndex].group == NULL)
-          {
-            break;
-          };
-      };
+    // take the next empty station index
+    stationIndex = nofStations_p;
     if (stationIndex == MAX_NO_STATIONS)
       {
         cerr << "TBBraw::createNewStation: Buffer \"dipoleBuf\" is full, cannot create new dipole!" <<endl;
@@ -565,6 +793,29 @@ namespace DAL {  // Namespace DAL -- begin
     stationBuf[stationIndex].group = dataset_p->createGroup( newStationIDstr );
     
     stationBuf[stationIndex].ID = headerp->stationid;
+
+    if (stationLayout_p && stationBuf[stationIndex].group != NULL)
+      {
+        stationBuf[stationIndex].data = new TBB_StationDataset;
+        if (!stationBuf[stationIndex].data->create(stationBuf[stationIndex].group->getId(),
+                                                   TBB_STATIONDATASET_CHUNK_DIPOLES,
+                                                   CHUNK_SIZE,
+                                                   filters_p))
+          {
+            cerr << "TBBraw::createNewStation: Failed to create the station dataset!" << endl;
+            delete stationBuf[stationIndex].data;
+            stationBuf[stationIndex].data = NULL;
+          };
+      };
+
+    // register the station, with an empty dipole lookup table
+    stationLookup_p[headerp->stationid] = stationIndex;
+    dipoleLookup_p[headerp->stationid]  = new short [256*256];
+    for (int i=0; i<256*256; i++)
+      {
+        dipoleLookup_p[headerp->stationid][i] = -1;
+      };
+    nofStations_p++;
     
     std::vector<string> observationMode        (1, "Transient");
     std::vector<string> triggerType            (1, "UNDEFINED");
@@ -605,42 +856,20 @@ namespace DAL {  // Namespace DAL -- begin
   //                                                              addDataToDipole
   
   bool TBBraw::addDataToDipole (int index,
-				char *buffer,
-				int bufflen,
-				bool bigEndian)
+				char *buffer)
   {
-    int i;
     TBB_Header *headerp = (TBB_Header*)buffer;
-    if (bufflen < (int)(headerp->n_samples_per_frame*sizeof(short)+sizeof(TBB_Header)))
-      {
-        cerr << "TBBraw::addDataToDipole: Too few data read in! Aborting." << endl;
-        cerr << "  block size: " << bufflen << " bytes, estimated size: "
-             << (headerp->n_samples_per_frame*sizeof(short)+sizeof(TBB_Header))
-             << " bytes" << endl;
-        return false;
-      };
     
     //set sdata to the (hopefully correct) position in the udp-buffer
     char *tmpptr = buffer+sizeof(TBB_Header);
     short *sdata = (short *)(tmpptr);
-    
-    if ( bigendian_p != bigEndian )
-      {
-        for ( i=0; i < headerp->n_samples_per_frame; i++ )
-          {
-            swapbytes( (char *)&(sdata[i]), 2 );
-          };
-      };
 
     //calculate the writeOffset from time of first block and this block
     int writeOffset= (headerp->sample_nr-dipoleBuf[index].startsamplenum)+
                      ((headerp->time-dipoleBuf[index].starttime)*headerp->sample_freq*1000000);
 #ifdef DAL_DEBUGGING_MESSAGES
-    uint sid, rsp, rcu;
-    dipoleBuf[index].array->getAttribute( attribute_name(STATION_ID), sid );
-    dipoleBuf[index].array->getAttribute( attribute_name(RSP_ID), rsp );
-    dipoleBuf[index].array->getAttribute( attribute_name(RCU_ID), rcu );
-    std::cout << "Station: " << sid << " RSP: " << rsp << " RCU: " << rcu
+    std::cout << "Station: " << headerp->stationid << " RSP: " << headerp->rspid
+              << " RCU: " << headerp->rcuid
               << " Sequence-Nr: " << headerp->seqnr << endl;
     std::cout << " starttime:"<< headerp->time-dipoleBuf[index].starttime << " startsamplenum:" << headerp->sample_nr-dipoleBuf[index].startsamplenum
               << " writeOffset:" << writeOffset << endl;
@@ -649,17 +878,39 @@ namespace DAL {  // Namespace DAL -- begin
     // (don't extend the array to the front)
     if (writeOffset >= 0)
       {
-        //extend array if neccessary.
-        if ((writeOffset+ headerp->n_samples_per_frame)> dipoleBuf[index].dimensions[0])
+        dipoleBufElem &dipole = dipoleBuf[index];
+        int nofSamples        = headerp->n_samples_per_frame;
+
+        //a gap (or overlap) in the data: write out what we have so far
+        if ((dipole.stageLength > 0) &&
+            (writeOffset != dipole.stageStart+dipole.stageLength))
           {
-#ifdef DAL_DEBUGGING_MESSAGES
-            cout << "extending array to:" << writeOffset+ headerp->n_samples_per_frame
-                 << " from:" << dipoleBuf[index].dimensions[0] << endl;
-#endif
-            dipoleBuf[index].dimensions[0] = writeOffset+ headerp->n_samples_per_frame;
-            dipoleBuf[index].array->extend(dipoleBuf[index].dimensions);
+            flushDipole(index);
+          };
+        //no room left in the staging buffer: write out the complete chunks
+        if (dipole.stageLength+nofSamples > writeBufferSize_p)
+          {
+            flushDipole(index, true);
+            if (dipole.stageLength+nofSamples > writeBufferSize_p)
+              {
+                flushDipole(index);
+              };
+          };
+        if (nofSamples > writeBufferSize_p)
+          {
+            //frame too large to be staged at all
+            return writeToDipole(index, writeOffset, sdata, nofSamples);
+          };
+        if (dipole.stage == NULL)
+          {
+            dipole.stage = new short [writeBufferSize_p];
           };
-        dipoleBuf[index].array->write(writeOffset, sdata, headerp->n_samples_per_frame );
+        if (dipole.stageLength == 0)
+          {
+            dipole.stageStart = writeOffset;
+          };
+        memcpy(dipole.stage+dipole.stageLength, sdata, nofSamples*sizeof(short));
+        dipole.stageLength += nofSamples;
 #ifdef DAL_DEBUGGING_MESSAGES
       }
     else
@@ -669,13 +920,163 @@ namespace DAL {  // Namespace DAL -- begin
 #endif
       };
 
-    // That is not needed/used right now!
-    /*
-      tmpptr += headerp->n_samples_per_frame*sizeof(short);
-      UInt32 *payloadp = (UInt32 *)tmpptr;
-      payload_crc = *payloadp;
-    */
     return true;
   };
 
+  //_____________________________________________________________________________
+  //                                                                writeToDipole
+
+  bool TBBraw::writeToDipole (int index,
+			      int offset,
+			      short *data,
+			      int nofSamples)
+  {
+    int end = offset+nofSamples;
+
+    if (dipoleBuf[index].array == NULL)
+      {
+        return writeToRow(index, offset, data, nofSamples);
+      };
+
+    //extend array if neccessary; grow geometrically to keep the number of
+    //extend operations small, flush() trims the array again.
+    if (end > dipoleBuf[index].dimensions[0])
+      {
+        int growth = dipoleBuf[index].dimensions[0];
+        if (growth > 16*writeBufferSize_p)
+          {
+            growth = 16*writeBufferSize_p;
+          };
+#ifdef DAL_DEBUGGING_MESSAGES
+        cout << "extending array to:" << end+growth
+             << " from:" << dipoleBuf[index].dimensions[0] << endl;
+#endif
+        dipoleBuf[index].dimensions[0] = end+growth;
+        if (!dipoleBuf[index].array->extend(dipoleBuf[index].dimensions))
+          {
+            return false;
+          };
+      };
+    nofWrites_p++;
+    if (chunkWriter_p != NULL && !filters_p.isEmpty())
+      {
+        //complete chunks are compressed in parallel, the partial chunks at
+        //either end are written through the library
+        hid_t arrayID  = dipoleBuf[index].array->getId();
+        int chunkStart = ((offset+CHUNK_SIZE-1)/CHUNK_SIZE)*CHUNK_SIZE;
+        int chunkEnd   = (end/CHUNK_SIZE)*CHUNK_SIZE;
+        std::vector<hsize_t> chunkOffset(1);
+        bool status    = true;
+
+        for (int pos=chunkStart; pos<chunkEnd; pos+=CHUNK_SIZE)
+          {
+            chunkOffset[0] = pos;
+            status &= chunkWriter_p->write(arrayID, data+(pos-offset), chunkOffset);
+          };
+        if (chunkStart >= chunkEnd)
+          {
+            chunkStart = chunkEnd = end;
+          };
+        if (chunkStart > offset || chunkEnd < end)
+          {
+            status &= chunkWriter_p->flush();
+          };
+        if (chunkStart > offset)
+          {
+            status &= dipoleBuf[index].array->write(offset, data, chunkStart-offset);
+          };
+        if (chunkEnd < end)
+          {
+            status &= dipoleBuf[index].array->write(chunkEnd, data+(chunkEnd-offset), end-chunkEnd);
+          };
+        if (!status)
+          {
+            return false;
+          };
+      }
+    else if (!dipoleBuf[index].array->write(offset, data, nofSamples))
+      {
+        return false;
+      };
+    if (end > dipoleBuf[index].dataEnd)
+      {
+        dipoleBuf[index].dataEnd = end;
+      };
+
+    return true;
+  };
+
+  //_____________________________________________________________________________
+  //                                                                   writeToRow
+
+  bool TBBraw::writeToRow (int index,
+                           int offset,
+                           short *data,
+                           int nofSamples)
+  {
+    dipoleBufElem &dipole       = dipoleBuf[index];
+    TBB_StationDataset *station = stationBuf[dipole.station].data;
+    int end                     = offset+nofSamples;
+
+    //extend the dataset if neccessary, geometrically as for the arrays
+    if (end > int(station->nofSamples()))
+      {
+        int growth = station->nofSamples();
+        if (growth > 16*writeBufferSize_p)
+          {
+            growth = 16*writeBufferSize_p;
+          };
+        if (!station->resize(end+growth))
+          {
+            return false;
+          };
+      };
+    nofWrites_p++;
+    if (!station->writeData(data, dipole.row, offset, nofSamples))
+      {
+        return false;
+      };
+    if (end > dipole.dataEnd)
+      {
+        dipole.dataEnd = end;
+      };
+
+    return true;
+  };
+
+  //_____________________________________________________________________________
+  //                                                                  flushDipole
+
+  bool TBBraw::flushDipole (int index,
+			    bool aligned)
+  {
+    dipoleBufElem &dipole = dipoleBuf[index];
+    int nofSamples        = dipole.stageLength;
+
+    if (aligned)
+      {
+        int chunkEnd = ((dipole.stageStart+dipole.stageLength)/CHUNK_SIZE)*CHUNK_SIZE;
+        if (chunkEnd > dipole.stageStart)
+          {
+            nofSamples = chunkEnd-dipole.stageStart;
+          };
+      };
+    if (nofSamples <= 0)
+      {
+        return true;
+      };
+
+    bool status = writeToDipole(index, dipole.stageStart, dipole.stage, nofSamples);
+
+    //keep the remainder (if any) at the start of the staging buffer
+    dipole.stageLength -= nofSamples;
+    dipole.stageStart  += nofSamples;
+    if (dipole.stageLength > 0)
+      {
+        memmove(dipole.stage, dipole.stage+nofSamples, dipole.stageLength*sizeof(short));
+      };
+
+    return status;
+  };
+
 } // Namespace DAL -- end
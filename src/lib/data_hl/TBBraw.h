@@ -45,7 +45,10 @@ using std::vector;
 // DAL header files
 #include <core/dalCommon.h>
 #include <core/dalDataset.h>
+#include <core/HDF5ChunkWriter.h>
+#include <core/HDF5FileIndex.h>
 #include <data_common/CommonAttributes.h>
+#include <data_hl/TBB_StationDataset.h>
 
 namespace DAL {  // Namespace DAL -- begin
   
@@ -61,7 +64,7 @@ namespace DAL {  // Namespace DAL -- begin
     
     \date 2009/01/07
     
-    \test tTBBraw.cpp
+    \test tTBBraw.cc
     
     <h3>Prerequisite</h3>
     
@@ -73,6 +76,14 @@ namespace DAL {  // Namespace DAL -- begin
     The data frames need to be read in by an application (or derived class) from
     a file or an UDP-port.
 
+    Rather than writing every frame to the file as it comes in, the samples of
+    each dipole are collected in a staging buffer (of writeBufferSize() samples)
+    as long as the frames are contiguous. The buffer is written out in whole
+    chunks once it is full, and completely when a gap in the data shows up,
+    when flush() is called (e.g. after a time-out while waiting for data) and
+    when the object is destroyed. The dipole datasets are grown geometrically
+    and trimmed to the size of the data written on flush().
+
     <i>Future enhancements:</i>
     - Suport for handling of TBB sub-band data needs to be added.
     - Support for big-endian systems is still untested.
@@ -86,6 +97,8 @@ namespace DAL {  // Namespace DAL -- begin
 #define TBB_FRAME_SIZE 2140
 #define MAX_NO_STATIONS 50
 #define MAX_NO_DIPOLES 1000
+    //! default size of the per-dipole staging buffer, [chunks]
+#define TBBRAW_WRITE_BUFFER_CHUNKS 40
     
   private:
     // ----------------------------------------------------------- Private Data
@@ -104,8 +117,24 @@ namespace DAL {  // Namespace DAL -- begin
     int fixTimes_p;
     //! number of processed data block
     int nofProcessed_p;    
+    //! number of data blocks written to the file
+    int nofWritten_p;
     //! number of discarded data blocks with broken crc
     int nofDiscardedHeader_p;
+    //! number of discarded data blocks with broken payload crc
+    int nofDiscardedData_p;
+    //! size of the per-dipole staging buffers, [samples]
+    int writeBufferSize_p;
+    //! number of write operations on the dipole arrays
+    int nofWrites_p;
+    //! filters applied to the chunks of the dipole arrays
+    HDF5FilterPipeline filters_p;
+    //! writer compressing complete chunks in parallel (NULL if not used)
+    HDF5ChunkWriter * chunkWriter_p;
+    //! store the dipoles of a station in a single [dipole,sample] dataset?
+    bool stationLayout_p;
+    //! write the table of contents of the file when it is closed?
+    bool writeIndex_p;
     //! am I big endian?
     bool bigendian_p;
     //! buffer for the stations
@@ -115,6 +144,8 @@ namespace DAL {  // Namespace DAL -- begin
       unsigned int ID;
       //! pointer to the corresponding group
       dalGroup * group;
+      //! [dipole,sample] dataset of the station (NULL if not used)
+      TBB_StationDataset * data;
     };
     struct stationBufElem *stationBuf;
     
@@ -131,8 +162,30 @@ namespace DAL {  // Namespace DAL -- begin
 	(used to calculate array offsets).
       */
       unsigned int starttime, startsamplenum;
+      //! staging buffer for samples not yet written to the array
+      short * stage;
+      //! array offset of the first sample in the staging buffer
+      int stageStart;
+      //! number of samples in the staging buffer
+      int stageLength;
+      //! end of the data written to the array, [samples]
+      int dataEnd;
+      //! index in stationBuf, if the dipole is a row of a station dataset
+      int station;
+      //! row of the dipole within the station dataset (-1 if not used)
+      int row;
     };
     struct dipoleBufElem *dipoleBuf;
+    //! number of entries in use in stationBuf
+    int nofStations_p;
+    //! number of entries in use in dipoleBuf
+    int nofDipoles_p;
+    //! index in stationBuf for each station ID (-1 if not yet created)
+    short stationLookup_p[256];
+    /*! for each station ID: index in dipoleBuf for each (rspid<<8 | rcuid),
+      (-1 if not yet created); NULL if the station has not been seen yet.
+    */
+    short *dipoleLookup_p[256];
     
   protected:
     
@@ -173,6 +226,16 @@ namespace DAL {  // Namespace DAL -- begin
       \return <tt>true</tt> if header-CRC is correct
     */
     bool checkHeaderCRC (TBB_Header *headerp);
+
+    /*!
+      \brief check the payload CRC.
+
+      \param headerp -- pointer to the frame header, followed by the samples
+             and the two 16-bit words of the payload CRC (in host byte order)
+
+      \return <tt>true</tt> if payload-CRC is correct
+    */
+    bool checkDataCRC (TBB_Header *headerp);
     
   public:
 
@@ -241,10 +304,7 @@ namespace DAL {  // Namespace DAL -- begin
     */
     inline void doDataCRC(const bool doit=true)
     {
-      if (doit) {
-	cout << "TBBraw::doDataCRC: Data CRC-checking not (yet) implemented!" << endl;
-	//      do_dataCRC_p=doit;
-      };
+      do_dataCRC_p=doit;
     };
     
     /*!
@@ -261,6 +321,100 @@ namespace DAL {  // Namespace DAL -- begin
     inline CommonAttributes commonAttributes () const {
       return itsCommonAttributes;
     }
+
+    //! Get the size of the per-dipole staging buffers, [samples]
+    inline int writeBufferSize () const {
+      return writeBufferSize_p;
+    }
+
+    /*!
+      \brief Set the size of the per-dipole staging buffers
+
+      \param nofSamples -- Size of the buffers, [samples]; rounded up to a
+             multiple of the chunk size, with a minimum of two chunks.
+
+      Data already staged is written to the file first.
+    */
+    void setWriteBufferSize (int const &nofSamples);
+
+    //! Get the number of write operations on the dipole arrays
+    inline int nofWrites () const {
+      return nofWrites_p;
+    }
+
+    //! Get the filters applied to the chunks of the dipole arrays
+    inline HDF5FilterPipeline filters () const {
+      return filters_p;
+    }
+
+    /*!
+      \brief Set the filters applied to the chunks of the dipole arrays
+
+      \param filters -- Filter pipeline, e.g. shuffle and deflate compression;
+             only used for dipole arrays created afterwards.
+
+      As the staging buffers hand complete chunks to the library, every chunk
+      is passed through the filters only once.
+    */
+    inline void setFilters (HDF5FilterPipeline const &filters) {
+      filters_p = filters;
+    }
+
+    //! Get the number of threads compressing the chunks of the dipole arrays
+    inline unsigned int compressionThreads () const {
+      return chunkWriter_p == NULL ? 0 : chunkWriter_p->nofThreads();
+    }
+
+    /*!
+      \brief Compress the chunks of the dipole arrays on a pool of threads
+
+      \param nofThreads -- Number of threads; 0 lets the library compress the
+             chunks upon writing, on the calling thread.
+
+      Complete chunks handed over from the staging buffers are compressed by
+      a DAL::HDF5ChunkWriter and stored with direct chunk writes; partial
+      chunks still are written through the library. Only has an effect if
+      filters are set (see setFilters()).
+    */
+    void setCompressionThreads (unsigned int const &nofThreads);
+
+    //! Are the dipoles of a station stored in a single [dipole,sample] dataset?
+    inline bool stationLayout () const {
+      return stationLayout_p;
+    }
+
+    /*!
+      \brief Store the dipoles of a station in a single [dipole,sample] dataset
+
+      \param doit -- Store the samples of the dipoles as rows of a
+             DAL::TBB_StationDataset instead of a 1-D array per dipole; only
+             used for stations created afterwards.
+
+      The metadata of the dipoles then are kept in the dipole table of the
+      station instead of attributes. Chunks written this way are passed
+      through the filter pipeline by the library, i.e. the compression threads
+      are not used.
+    */
+    inline void setStationLayout (bool const &doit=true) {
+      stationLayout_p = doit;
+    }
+
+    //! Is the table of contents of the file written when it is closed?
+    inline bool writeIndex () const {
+      return writeIndex_p;
+    }
+
+    /*!
+      \brief Write the table of contents of the file when it is closed
+
+      \param doit -- Write a DAL::HDF5FileIndex to the sidecar of the output
+             file, once the file has been closed; readers such as
+             DAL::TBB_Timeseries then can skip iterating over the groups and
+             datasets of the file.
+    */
+    inline void setWriteIndex (bool const &doit=true) {
+      writeIndex_p = doit;
+    }
     
     
     // === Public methods =======================================================
@@ -322,6 +476,47 @@ namespace DAL {  // Namespace DAL -- begin
     bool processTBBrawBlock (char *inbuff,
 			     int datalen,
 			     bool bigEndian=false);
+
+    /*!
+      \brief Prepare one block of data for writing it to the output file
+
+      \param inbuff  -- pointer to one TBB data-frame (incl. header etc.)
+      \param datalen -- length (number of bytes) of the data in inbuff
+      \param bigEndian -- set to true if the data is in big endian byte order
+
+      \return <tt>true</tt> if the block is valid and can be passed on to
+              writeTBBrawBlock()
+
+      This is the first half of processTBBrawBlock(): the data-frame is
+      converted to host byte order, the CRCs are checked and the time-stamps
+      are fixed in place. The output file is not accessed, so this can be done
+      by a different thread (and on a different, unconnected TBBraw object
+      with the same settings) than the one writing the data -- except for
+      old-style time-stamp fixing, which depends on the previous frames.
+    */
+    bool prepareTBBrawBlock (char *inbuff,
+			     int datalen,
+			     bool bigEndian=false);
+
+    /*!
+      \brief Add one block of data prepared by prepareTBBrawBlock() to the file
+
+      \param inbuff  -- pointer to one TBB data-frame (incl. header etc.)
+
+      \return <tt>true</tt> if successful
+    */
+    bool writeTBBrawBlock (char *inbuff);
+
+    /*!
+      \brief Write all staged data to the file
+
+      \return <tt>true</tt> if successful
+
+      Call this when the data stream pauses (e.g. on a read time-out), so that
+      no data is held back in memory while waiting. The dipole arrays are
+      trimmed to the size of the data written.
+    */
+    bool flush ();
     
     //! Provide a summary of the internal status and processing statistics
     inline void summary () {
@@ -413,21 +608,71 @@ namespace DAL {  // Namespace DAL -- begin
       \return index of the new station, or -1 if an error occured
     */
     int createNewStation(TBB_Header *headerp);
+
+    /*!
+      \brief Add a dipole as a row of its station dataset and return its index
+
+      \param headerp      -- pointer to the header of the first frame
+      \param stationIndex -- index of the station in stationBuf
+      \param numDipole    -- index of the dipole in dipoleBuf
+    */
+    int createNewRow(TBB_Header *headerp,
+                     int stationIndex,
+                     int numDipole);
     
     /*!
       \brief Process one block of data and add it's contents to the output file
       
       \param index  -- index of the entry in dipoleBuf to add the data to
-      \param buffer  -- pointer to the TBB data-frame (incl. header etc.)
-      \param datalen -- length (number of bytes) of the data in inbuff
-      \param bigEndian -- set to true if the data is in big endian byte order
+      \param buffer  -- pointer to the TBB data-frame (incl. header etc.), as
+             prepared by prepareTBBrawBlock()
       
       \return <tt>true</tt> if successful
     */
     bool addDataToDipole (int index,
-			  char *buffer,
-			  int bufflen,
-			  bool bigEndian=false);
+			  char *buffer);
+
+    /*!
+      \brief Write data to a dipole array, extending it if neccessary
+
+      \param index      -- index of the entry in dipoleBuf to write to
+      \param offset     -- offset in the array, [samples]
+      \param data       -- the samples to write
+      \param nofSamples -- number of samples to write
+
+      \return <tt>true</tt> if successful
+    */
+    bool writeToDipole (int index,
+			int offset,
+			short *data,
+			int nofSamples);
+
+    /*!
+      \brief Write data to the row of a dipole within its station dataset
+
+      \param index      -- index of the entry in dipoleBuf to write to
+      \param offset     -- offset in the row, [samples]
+      \param data       -- the samples to write
+      \param nofSamples -- number of samples to write
+
+      \return <tt>true</tt> if successful
+    */
+    bool writeToRow (int index,
+		     int offset,
+		     short *data,
+		     int nofSamples);
+
+    /*!
+      \brief Write the staging buffer of a dipole to its array
+
+      \param index   -- index of the entry in dipoleBuf to flush
+      \param aligned -- only write up to the last complete chunk, keeping the
+             remainder in the staging buffer
+
+      \return <tt>true</tt> if successful
+    */
+    bool flushDipole (int index,
+		      bool aligned=false);
     
   }; // class TBBraw -- end
   
@@ -20,6 +20,8 @@
 
 #include <data_hl/BF_RootGroup.h>
 
+#include <cstdio>
+
 // Namespace usage
 using std::cerr;
 using std::cout;
@@ -185,6 +187,27 @@ int test_attributes ()
   BF_RootGroup bf (file);
   bf.summary();
 
+  cout << "[1] Attributes updated when opening sub-array pointings ..." << endl;
+  {
+    Filename name = getFilename("123456789","attributes");
+    BF_RootGroup dataset (name, DAL::IO_Mode(DAL::IO_Mode::Create));
+    int nofBeams (-1);
+
+    /* Read the attribute into the cache before it gets updated */
+    dataset.getAttribute ("NOF_PRIMARY_BEAMS", nofBeams);
+
+    if (nofBeams != 0) {
+      ++nofFailedTests;
+    }
+
+    dataset.openSubArrayPointing (0);
+    dataset.getAttribute ("NOF_PRIMARY_BEAMS", nofBeams);
+
+    if (nofBeams != 1) {
+      cerr << "-- Stale value of NOF_PRIMARY_BEAMS : " << nofBeams << endl;
+      ++nofFailedTests;
+    }
+  }
 
   return nofFailedTests;
 }
@@ -292,6 +315,65 @@ int test_methods ()
   return nofFailedTests;
 }
 
+//_______________________________________________________________________________
+//                                                                 test_fileIndex
+
+/*!
+  \brief Test writing and using the table of contents of the file
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_fileIndex ()
+{
+  cout << "\n[tBF_RootGroup::test_fileIndex]\n" << endl;
+
+  int nofFailedTests = 0;
+  Filename file      = getFilename("123456789","index");
+  std::string name   = file.filename();
+
+  cout << "[1] Write the index when closing the file ..." << endl;
+  {
+    BF_RootGroup dataset (file, DAL::IO_Mode(DAL::IO_Mode::Create));
+    dataset.setWriteIndex();
+    dataset.openSubArrayPointing(0);
+    dataset.openSubArrayPointing(1);
+  }
+
+  DAL::HDF5FileIndex index (name);
+  index.summary();
+
+  if (!index.isValid() || index.names("/",H5G_GROUP).size() != 3) {
+    cerr << "-- No up-to-date index for " << name << endl;
+    ++nofFailedTests;
+  }
+
+  cout << "[2] Open the file using the index ..." << endl;
+  {
+    DAL::IO_Mode flags (DAL::IO_Mode::Open|DAL::IO_Mode::ReadWrite);
+    unsigned int nofPointings = 0;
+
+    {
+      BF_RootGroup dataset (file, flags);
+      nofPointings = dataset.nofSubArrayPointings();
+    }
+
+    /* Same result when iterating over the groups of the file */
+    std::remove (DAL::HDF5FileIndex::sidecarName(name).c_str());
+
+    {
+      BF_RootGroup dataset (file, flags);
+
+      if (nofPointings == 0 || dataset.nofSubArrayPointings() != nofPointings) {
+	cerr << "-- Inconsistent number of SubArrayPointing groups" << endl;
+	++nofFailedTests;
+      }
+    }
+  }
+
+  return nofFailedTests;
+}
+
 //_______________________________________________________________________________
 //                                                                           main
 
@@ -319,6 +401,8 @@ int main (int argc,
   nofFailedTests += test_constructors ();
   // Test access to the attributes attached to the root group
   nofFailedTests += test_attributes ();
+  // Test the table of contents written along with the file
+  nofFailedTests += test_fileIndex ();
   // // Test working with the embedded groups
   // nofFailedTests += test_subGroups ();
   // // Test the various methods 
@@ -18,6 +18,7 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <core/HDF5Datatype.h>
 #include <data_hl/BF_StokesDataset.h>
 
 // Namespace usage
@@ -227,6 +228,49 @@ int test_constructors (hid_t const &fileID)
     // ... and create a new one as copy
     BF_StokesDataset stokesCopy (stokesOrig);
     stokesCopy.summary();
+    // The copy shares the identifier of the original dataset
+    if (stokesCopy.objectID() != stokesOrig.objectID()
+	|| H5Iget_ref(stokesOrig.objectID()) != 2
+	|| stokesCopy.nofChannels() != stokesOrig.nofChannels()) {
+      std::cerr << "-- Copy does not share the dataset identifier" << endl;
+      nofFailedTests++;
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  /*_______________________________________________________________________
+    Test 9: Assignment and exchange of contents
+  */
+
+  cout << "[9] Testing operator=(BF_StokesDataset) and swap(BF_StokesDataset) ..." << endl;
+  try {
+    index = 9;
+    BF_StokesDataset stokesOrig (groupID, index, shape);
+    BF_StokesDataset stokesAssigned;
+    BF_StokesDataset stokesSwapped;
+    hid_t datasetID = stokesOrig.objectID();
+
+    stokesAssigned = stokesOrig;
+
+    if (stokesAssigned.objectID() != datasetID
+	|| H5Iget_ref(datasetID) != 2
+	|| stokesAssigned.nofChannels() != stokesOrig.nofChannels()
+	|| stokesAssigned.shape() != shape) {
+      std::cerr << "-- Assignment does not share the dataset identifier" << endl;
+      nofFailedTests++;
+    }
+
+    stokesSwapped.swap (stokesOrig);
+
+    if (stokesSwapped.objectID() != datasetID
+	|| H5Iget_ref(datasetID) != 2
+	|| stokesOrig.objectID() > 0
+	|| stokesSwapped.shape() != shape) {
+      std::cerr << "-- Swap did not exchange the dataset identifier" << endl;
+      nofFailedTests++;
+    }
   } catch (std::string message) {
     std::cerr << message << endl;
     nofFailedTests++;
@@ -668,6 +712,63 @@ int test_data (hid_t const &fileID)
     nofFailedTests++;
   }
 
+  //________________________________________________________
+  // Test 6
+
+  cout << "[6] Testing appending blocks of complex voltages ..." << endl;
+  try {
+    unsigned int nofBlocks = 4;
+    hid_t datatype         = DAL::HDF5Datatype::complexFloat();
+
+    nofSamples = 100;
+
+    BF_StokesDataset stokes (groupID,
+			     6,
+			     nofSamples,
+			     nofSubbands,
+			     1,
+			     DAL::Stokes::X,
+			     datatype);
+    H5Tclose (datatype);
+
+    start[0]      = 0;
+    start[1]      = 0;
+    block[0]      = nofSamples;
+    block[1]      = nofSubbands;
+    nofDatapoints = nofSamples*nofSubbands;
+    std::vector<std::complex<float> > data (nofDatapoints);
+    std::vector<std::complex<float> > check (nofDatapoints);
+
+    /* Each block extends the dataset along the time axis */
+    for (unsigned int step=0; step<nofBlocks; ++step) {
+      start[0] = step*nofSamples;
+      for (unsigned int n(0); n<nofDatapoints; ++n) {
+	data[n] = std::complex<float> (step, n);
+      }
+      stokes.writeData (&data[0], start, block);
+    }
+
+    shape = stokes.shape();
+    cout << "-- Shape           = " << shape    << endl;
+    if (shape[0] != nofBlocks*nofSamples || shape[1] != nofSubbands) {
+      cerr << "-- Wrong shape of the dataset" << endl;
+      nofFailedTests++;
+    }
+
+    /* Read back the last block */
+    stokes.readData (&check[0], start, block);
+    for (unsigned int n(0); n<nofDatapoints; ++n) {
+      if (check[n] != std::complex<float>(nofBlocks-1, n)) {
+	cerr << "-- Wrong value at position " << n << " : " << check[n] << endl;
+	nofFailedTests++;
+	break;
+      }
+    }
+  } catch (std::string message) {
+    std::cerr << message << endl;
+    nofFailedTests++;
+  }
+
   /* Release HDF5 group handler */ 
   H5Gclose (groupID);
 
@@ -0,0 +1,286 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <sys/time.h>
+#include <data_hl/BF_StokesKernels.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::BF_StokesKernels;
+
+/*!
+  \file tBF_StokesKernels.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the DAL::BF_StokesKernels class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+
+  <h3>Usage</h3>
+
+  \verbatim
+  tBF_StokesKernels [nofBlocks]
+  \endverbatim
+
+  Compares all kernels supported on the machine with a double precision
+  reference, and then times them on \e nofBlocks (default: 50) subband blocks
+  of 196608 samples.
+*/
+
+//! Number of samples in a subband block (200 MHz clock)
+const unsigned int nofBlockSamples = 196608;
+
+// -----------------------------------------------------------------------------
+
+//! Get the wall-clock time, [sec]
+double wallTime ()
+{
+  struct timeval tv;
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec + 1e-6*tv.tv_usec;
+}
+
+//! Fill a buffer with random samples, including the extreme values
+void fillSamples (std::vector<BFRawFormat::Sample> &samples)
+{
+  srand (42);
+  for (unsigned int n=0; n<samples.size(); ++n) {
+    samples[n].xx = std::complex<int16_t> (rand()%65536-32768, rand()%65536-32768);
+    samples[n].yy = std::complex<int16_t> (rand()%2001-1000, rand()%2001-1000);
+  }
+  samples[0].xx = std::complex<int16_t> (-32768, -32768);
+  samples[0].yy = std::complex<int16_t> (32767, -32768);
+}
+
+//! Does a value agree with the reference within the single precision rounding?
+bool agrees (double value,
+	     double reference,
+	     double scale)
+{
+  return std::fabs(value-reference) <= 1e-5*scale;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test the kernels against a double precision reference
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_kernels ()
+{
+  cout << "\n[tBF_StokesKernels::test_kernels]\n" << endl;
+
+  int nofFailedTests (0);
+  BF_StokesKernels::Kernel kernels[] = { BF_StokesKernels::Scalar,
+					 BF_StokesKernels::SSE2,
+					 BF_StokesKernels::AVX2 };
+  unsigned int factors[] = { 1, 3, 16, 37 };
+  unsigned int nofOutput (20);
+  std::vector<BFRawFormat::Sample> samples (nofOutput*37);
+
+  fillSamples (samples);
+  BF_StokesKernels::summary();
+
+  for (unsigned int k=0; k<3; ++k) {
+    if (!BF_StokesKernels::setKernel(kernels[k])) {
+      cout << "-- Skipping unsupported kernel " << BF_StokesKernels::name(kernels[k]) << endl;
+      continue;
+    }
+    cout << "[" << k+1 << "] Testing kernel "
+	 << BF_StokesKernels::name(BF_StokesKernels::kernel()) << " ..." << endl;
+
+    for (unsigned int f=0; f<4; ++f) {
+      unsigned int factor = factors[f];
+      std::vector<float> intensity (nofOutput);
+      std::vector<float> stokes (4*nofOutput);
+
+      BF_StokesKernels::intensity (&samples[0], &intensity[0], nofOutput, factor);
+      BF_StokesKernels::stokes (&samples[0],
+				&stokes[0],
+				&stokes[nofOutput],
+				&stokes[2*nofOutput],
+				&stokes[3*nofOutput],
+				nofOutput,
+				factor);
+
+      for (unsigned int n=0; n<nofOutput; ++n) {
+	double ref[4] = { 0, 0, 0, 0 };
+	for (unsigned int m=n*factor; m<(n+1)*factor; ++m) {
+	  double xr = real(samples[m].xx);
+	  double xi = imag(samples[m].xx);
+	  double yr = real(samples[m].yy);
+	  double yi = imag(samples[m].yy);
+	  ref[0] += xr*xr + xi*xi + yr*yr + yi*yi;
+	  ref[1] += xr*xr + xi*xi - yr*yr - yi*yi;
+	  ref[2] += 2*(xr*yr + xi*yi);
+	  ref[3] += 2*(xi*yr - xr*yi);
+	}
+	bool ok = agrees (intensity[n], ref[0], ref[0]);
+	for (unsigned int s=0; s<4; ++s) {
+	  ok = ok && agrees (stokes[s*nofOutput+n], ref[s], ref[0]);
+	}
+	if (!ok) {
+	  cerr << "-- Wrong result for downsample factor " << factor
+	       << ", output sample " << n << endl;
+	  ++nofFailedTests;
+	  break;
+	}
+      }
+    }
+  }
+
+  BF_StokesKernels::setKernel (BF_StokesKernels::bestKernel());
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test the conversion to complex voltages
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_voltages ()
+{
+  cout << "\n[tBF_StokesKernels::test_voltages]\n" << endl;
+
+  int nofFailedTests (0);
+  std::vector<BFRawFormat::Sample> samples (100);
+  std::vector<std::complex<float> > voltagesX (samples.size());
+  std::vector<std::complex<float> > voltagesY (samples.size());
+
+  fillSamples (samples);
+
+  cout << "[1] Convert " << samples.size() << " samples ..." << endl;
+  BF_StokesKernels::voltages (&samples[0],
+			      &voltagesX[0],
+			      &voltagesY[0],
+			      samples.size());
+
+  for (unsigned int n=0; n<samples.size(); ++n) {
+    if (voltagesX[n].real() != real(samples[n].xx)
+	|| voltagesX[n].imag() != imag(samples[n].xx)
+	|| voltagesY[n].real() != real(samples[n].yy)
+	|| voltagesY[n].imag() != imag(samples[n].yy)) {
+      cerr << "-- Wrong voltages for sample " << n << endl;
+      ++nofFailedTests;
+      break;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Time the kernels on full subband blocks
+
+  \param nofBlocks -- Number of subband blocks to process
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int benchmark_kernels (unsigned int const &nofBlocks)
+{
+  cout << "\n[tBF_StokesKernels::benchmark_kernels]\n" << endl;
+
+  int nofFailedTests (0);
+  unsigned int factor (16);
+  unsigned int nofOutput (nofBlockSamples/factor);
+  std::vector<BFRawFormat::Sample> samples (nofBlockSamples);
+  std::vector<float> stokes (4*nofOutput);
+  BF_StokesKernels::Kernel kernels[] = { BF_StokesKernels::Scalar,
+					 BF_StokesKernels::SSE2,
+					 BF_StokesKernels::AVX2 };
+  double elapsed;
+  double start;
+
+  fillSamples (samples);
+
+  cout << "-- nof. blocks ......... : " << nofBlocks << endl;
+  cout << "-- downsample factor ... : " << factor << endl;
+
+  for (unsigned int k=0; k<3; ++k) {
+    if (!BF_StokesKernels::setKernel(kernels[k])) {
+      continue;
+    }
+
+    start = wallTime();
+    for (unsigned int n=0; n<nofBlocks; ++n) {
+      BF_StokesKernels::intensity (&samples[0], &stokes[0], nofOutput, factor);
+    }
+    elapsed = wallTime()-start;
+    cout << "-- " << BF_StokesKernels::name(kernels[k])
+	 << " intensity [Msamples/s] : " << nofBlocks*nofBlockSamples/(elapsed+1e-9)/1e6
+	 << endl;
+
+    start = wallTime();
+    for (unsigned int n=0; n<nofBlocks; ++n) {
+      BF_StokesKernels::stokes (&samples[0],
+				&stokes[0],
+				&stokes[nofOutput],
+				&stokes[2*nofOutput],
+				&stokes[3*nofOutput],
+				nofOutput,
+				factor);
+    }
+    elapsed = wallTime()-start;
+    cout << "-- " << BF_StokesKernels::name(kernels[k])
+	 << " IQUV      [Msamples/s] : " << nofBlocks*nofBlockSamples/(elapsed+1e-9)/1e6
+	 << endl;
+  }
+
+  BF_StokesKernels::setKernel (BF_StokesKernels::bestKernel());
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+int main (int argc,
+	  char *argv[])
+{
+  int nofFailedTests (0);
+  unsigned int nofBlocks (50);
+
+  if (argc > 1) {
+    nofBlocks = atoi (argv[1]);
+  }
+
+  nofFailedTests += test_kernels ();
+  nofFailedTests += test_voltages ();
+  nofFailedTests += benchmark_kernels (nofBlocks);
+
+  return nofFailedTests;
+}
@@ -0,0 +1,195 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <vector>
+#include <sys/time.h>
+#include <data_hl/BF_TaskPool.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::BF_TaskPool;
+
+/*!
+  \file tBF_TaskPool.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the DAL::BF_TaskPool class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//! Number of blocks submitted by the tests
+const unsigned int nofBlocks   = 500;
+//! Number of tasks (subbands) per block
+const unsigned int nofSubbands = 61;
+
+//! Shared state of the task function
+struct Counters {
+  //! Number of times each (block,subband) task was processed
+  std::vector<int> processed;
+  //! Amount of work per task, in loop iterations
+  unsigned int work;
+};
+
+// -----------------------------------------------------------------------------
+
+//! Get the wall-clock time, [sec]
+double wallTime ()
+{
+  struct timeval tv;
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec + 1e-6*tv.tv_usec;
+}
+
+//! Task function: count the task, and burn some cycles
+void countTask (BF_TaskPool::Task const &task,
+		void *context)
+{
+  Counters *counters = static_cast<Counters *>(context);
+  volatile float sum = 0;
+
+  /* Uneven amount of work, so the workers need to balance the load */
+  unsigned int work = counters->work * (1 + task.subband%4);
+  for (unsigned int n=0; n<work; ++n) {
+    sum += n;
+  }
+
+  __sync_fetch_and_add (&counters->processed[task.blockNr*nofSubbands+task.subband], 1);
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test constructors for a new BF_TaskPool object
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tBF_TaskPool::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing argumented constructor ..." << endl;
+  {
+    BF_TaskPool pool (3, nofSubbands, countTask);
+    pool.summary();
+
+    if (pool.nofThreads() != 3 || pool.maxTasksPerBlock() != nofSubbands) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing default number of threads ..." << endl;
+  {
+    BF_TaskPool pool (0, nofSubbands, countTask);
+
+    if (pool.nofThreads() != BF_TaskPool::nofProcessors()) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Run blocks of tasks through the pool
+
+  \param nofThreads -- Number of worker threads
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_tasks (unsigned int const &nofThreads)
+{
+  cout << "\n[tBF_TaskPool::test_tasks] nofThreads = " << nofThreads << "\n" << endl;
+
+  int nofFailedTests (0);
+  Counters counters;
+  BF_TaskPool pool (nofThreads, nofSubbands, countTask, &counters);
+
+  counters.processed.resize (nofBlocks*nofSubbands, 0);
+  counters.work = 2000;
+
+  cout << "[1] Submit " << nofBlocks << " blocks of " << nofSubbands << " tasks ..." << endl;
+  double start = wallTime();
+  pool.start();
+  for (unsigned int block=0; block<nofBlocks; ++block) {
+    if (!pool.submit (block, nofSubbands, NULL)) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Wait for the tasks to complete ..." << endl;
+  pool.waitIdle();
+  double elapsed = wallTime()-start;
+  pool.summary();
+  cout << "-- Elapsed time [sec] = " << elapsed << endl;
+
+  if (pool.nofPending() != 0 || pool.nofCompleted() != nofBlocks*nofSubbands) {
+    cerr << "-- Wrong number of completed tasks: " << pool.nofCompleted() << endl;
+    ++nofFailedTests;
+  }
+
+  cout << "[3] Check every task was processed exactly once ..." << endl;
+  for (unsigned int n=0; n<counters.processed.size(); ++n) {
+    if (counters.processed[n] != 1) {
+      cerr << "-- Task " << n << " processed " << counters.processed[n]
+	   << " times" << endl;
+      ++nofFailedTests;
+      break;
+    }
+  }
+
+  cout << "[4] Reject an oversized block ..." << endl;
+  if (pool.submit (nofBlocks, nofSubbands+1, NULL)) {
+    ++nofFailedTests;
+  }
+
+  if (!pool.stop()) {
+    ++nofFailedTests;
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+int main ()
+{
+  int nofFailedTests (0);
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_tasks (1);
+  nofFailedTests += test_tasks (4);
+  nofFailedTests += test_tasks (BF_TaskPool::nofProcessors());
+
+  return nofFailedTests;
+}
@@ -0,0 +1,335 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <core/HDF5Object.h>
+#include <data_hl/TBB_BlockIterator.h>
+
+#include <set>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::HDF5Object;
+using DAL::IO_Mode;
+using DAL::TBB_BlockIterator;
+using DAL::TBB_DipoleDataset;
+using DAL::TBB_StationGroup;
+using DAL::TBB_Timeseries;
+
+/*!
+  \file tTBB_BlockIterator.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the DAL::TBB_BlockIterator class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//! Name of the file used for testing
+const std::string filename ("tTBB_BlockIterator.h5");
+//! Number of stations within the test file
+const unsigned int nofStations = 2;
+//! Number of dipoles per station
+const unsigned int nofRCUs = 3;
+//! Number of samples per dipole
+const hsize_t dataLength = 10000;
+
+//_______________________________________________________________________________
+//                                                                    sampleValue
+
+/*!
+  \brief ADC value stored in the test file
+
+  \param dipole -- Index of the dipole within the file.
+  \param sample -- Number of the sample.
+  \return value -- ADC value.
+*/
+short sampleValue (unsigned int const &dipole,
+		   long const &sample)
+{
+  return (short)((sample*31+dipole*1009)%4096) - 2048;
+}
+
+//_______________________________________________________________________________
+//                                                                     createFile
+
+/*!
+  \brief Create a time-series dataset with two stations of three dipoles
+
+  One of the dipole datasets uses a chunked layout, such that it is read
+  through the HDF5 library rather than mapped from the file.
+*/
+void createFile ()
+{
+  hid_t fileID    = HDF5Object::openFile (filename, IO_Mode(IO_Mode::Create));
+  short *buffer   = new short [dataLength];
+  hid_t dataspace = H5Screate_simple (1, &dataLength, NULL);
+  hid_t chunked   = H5Pcreate (H5P_DATASET_CREATE);
+  hsize_t chunk   = 1024;
+  H5Pset_chunk (chunked, 1, &chunk);
+
+  for (unsigned int station=0; station<nofStations; ++station) {
+    std::string name = TBB_StationGroup::getName (station+1);
+    hid_t groupID    = H5Gcreate (fileID, name.c_str(),
+				  H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    for (unsigned int rcu=0; rcu<nofRCUs; ++rcu) {
+      unsigned int dipole = station*nofRCUs+rcu;
+      for (hsize_t n=0; n<dataLength; ++n) {
+	buffer[n] = sampleValue (dipole, n);
+      }
+      name = TBB_DipoleDataset::dipoleName (station+1, 0, rcu);
+      hid_t datasetID = H5Dcreate (groupID, name.c_str(), H5T_STD_I16LE, dataspace,
+				   H5P_DEFAULT,
+				   dipole == 4 ? chunked : H5P_DEFAULT,
+				   H5P_DEFAULT);
+      H5Dwrite (datasetID, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer);
+      H5Dclose (datasetID);
+    }
+    H5Gclose (groupID);
+  }
+
+  H5Pclose (chunked);
+  H5Sclose (dataspace);
+  H5Fclose (fileID);
+  delete [] buffer;
+}
+
+//_______________________________________________________________________________
+//                                                                     checkBlock
+
+/*!
+  \brief Compare the current block of an iterator with the test file
+
+  \param blocks     -- Block iterator.
+  \param firstIndex -- Index within the file of the first dipole iterated over.
+  \return nofFailedTests -- 1 if the block does not match, 0 otherwise.
+*/
+int checkBlock (TBB_BlockIterator const &blocks,
+		unsigned int const &firstIndex=0)
+{
+  std::vector<long> start = blocks.start();
+
+  if (start.size() != blocks.nofDipoles() || blocks.data() == NULL) {
+    cerr << "-- No data for block " << blocks.blockNumber() << endl;
+    return 1;
+  }
+
+  for (unsigned int dipole=0; dipole<blocks.nofDipoles(); ++dipole) {
+    double const *data = blocks.data (dipole);
+    for (int n=0; n<blocks.blocksize(); ++n) {
+      long sample     = start[dipole]+n;
+      double expected = 0;
+      if (sample >= 0 && sample < long(dataLength)) {
+	expected = sampleValue (firstIndex+dipole, sample);
+      }
+      if (data[n] != expected) {
+	cerr << "-- Mismatch in block " << blocks.blockNumber()
+	     << " at sample " << n << " of dipole " << dipole
+	     << ": " << data[n] << " != " << expected << endl;
+	return 1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+//_______________________________________________________________________________
+//                                                              test_constructors
+
+/*!
+  \brief Test constructors for a new TBB_BlockIterator object
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tTBB_BlockIterator::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+  TBB_Timeseries ts (filename, IO_Mode(IO_Mode::ReadOnly));
+
+  cout << "[1] Testing TBB_BlockIterator(TBB_Timeseries,int) ..." << endl;
+  {
+    TBB_BlockIterator blocks (ts, 1000);
+    blocks.summary();
+
+    if (blocks.nofDipoles() != nofStations*nofRCUs
+	|| blocks.nofBlocks() != 10
+	|| blocks.nofPrefetch() != 2
+	|| blocks.blockNumber() != -1
+	|| blocks.data() != NULL) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing TBB_BlockIterator(TBB_StationGroup,int,...) ..." << endl;
+  {
+    TBB_StationGroup station = ts.stationGroup (2);
+    std::vector<int> offsets (nofRCUs, 100);
+    TBB_BlockIterator blocks (station, 3000, offsets, 0, 4);
+    blocks.summary();
+
+    if (blocks.nofDipoles() != nofRCUs
+	|| blocks.nofBlocks() != 3
+	|| blocks.nofPrefetch() != 4) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing with inconsistent offsets ..." << endl;
+  {
+    std::vector<int> offsets (2, 0);
+    TBB_BlockIterator blocks (ts, 1000, offsets);
+
+    if (blocks.nofBlocks() != 0 || blocks.next()) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                   test_iterate
+
+/*!
+  \brief Test iterating over the blocks of a dataset
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_iterate ()
+{
+  cout << "\n[tTBB_BlockIterator::test_iterate]\n" << endl;
+
+  int nofFailedTests (0);
+  TBB_Timeseries ts (filename, IO_Mode(IO_Mode::ReadOnly));
+
+  cout << "[1] Iterate over all complete blocks ..." << endl;
+  {
+    TBB_BlockIterator blocks (ts, 1024);
+    long nofBlocks (0);
+    std::set<double const *> buffers;
+
+    while (blocks.next()) {
+      nofFailedTests += checkBlock (blocks);
+      buffers.insert (blocks.data());
+      ++nofBlocks;
+    }
+
+    cout << "-- nof. blocks  = " << nofBlocks      << endl;
+    cout << "-- nof. buffers = " << buffers.size() << endl;
+
+    /* The buffers are recycled */
+    if (nofBlocks != long(dataLength/1024)
+	|| buffers.size() != blocks.nofPrefetch()+1
+	|| blocks.data() != NULL
+	|| blocks.next()) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Per-dipole offsets, beyond the end of the datasets ..." << endl;
+  {
+    std::vector<int> offsets (nofStations*nofRCUs);
+    for (unsigned int n=0; n<offsets.size(); ++n) {
+      offsets[n] = 7*n;
+    }
+
+    TBB_BlockIterator blocks (ts, 1000, offsets, -20, 3, 12);
+    long nofBlocks (0);
+
+    while (blocks.next()) {
+      nofFailedTests += checkBlock (blocks);
+      ++nofBlocks;
+    }
+
+    if (nofBlocks != 12) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Iterate over the dipoles of a station ..." << endl;
+  {
+    TBB_StationGroup station = ts.stationGroup (2);
+    TBB_BlockIterator blocks (station, 500, std::vector<int>(), 250, 1);
+
+    while (blocks.next()) {
+      nofFailedTests += checkBlock (blocks, nofRCUs);
+    }
+
+    if (blocks.blockNumber() != 19) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[4] Negative offsets, blocks wholly before the datasets ..." << endl;
+  {
+    std::vector<int> offsets (nofStations*nofRCUs, 0);
+    offsets[1] = -3000;
+    offsets[4] = -1024;
+
+    TBB_BlockIterator blocks (ts, 1024, offsets, 0, 2, 5);
+    long nofBlocks (0);
+
+    while (blocks.next()) {
+      nofFailedTests += checkBlock (blocks);
+      ++nofBlocks;
+    }
+
+    if (nofBlocks != 5) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[5] Stop before the end ..." << endl;
+  {
+    TBB_BlockIterator blocks (ts, 100);
+
+    for (int n=0; n<5; ++n) {
+      blocks.next();
+      nofFailedTests += checkBlock (blocks);
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main ()
+{
+  int nofFailedTests (0);
+
+  createFile ();
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_iterate ();
+
+  return nofFailedTests;
+}
@@ -22,6 +22,8 @@
 #include <data_hl/TBB_DipoleDataset.h>
 
 // Namespace usage
+using DAL::HDF5Future;
+using DAL::HDF5IOExecutor;
 using DAL::TBB_DipoleDataset;
 using std::cerr;
 using std::cout;
@@ -76,6 +78,133 @@ int test_constructors (hid_t const &fileID)
     nofFailedTests++;
   }
   
+  cout << "[3] Testing TBB_DipoleDataset(TBB_DipoleDataset) ..." << endl;
+  try {
+    std::vector<hsize_t> shape (1,1024);
+    hid_t dataspaceID = H5Screate_simple (1, &shape[0], NULL);
+    hid_t datasetID   = H5Dcreate (fileID, "000000001", H5T_NATIVE_SHORT, dataspaceID,
+				   H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dclose (datasetID);
+    H5Sclose (dataspaceID);
+
+    TBB_DipoleDataset dataset (fileID,"000000001");
+    TBB_DipoleDataset datasetCopy (dataset);
+    TBB_DipoleDataset datasetSwapped;
+
+    /* The copy shares the identifiers rather than opening the dataset again */
+    if (datasetCopy.locationID() != dataset.locationID()
+	|| H5Iget_ref(dataset.locationID()) != 2
+	|| datasetCopy.shape() != shape) {
+      cerr << "-- Copy does not share the dataset identifier" << endl;
+      nofFailedTests++;
+    }
+
+    datasetSwapped.swap (datasetCopy);
+
+    if (datasetSwapped.locationID() != dataset.locationID()
+	|| datasetCopy.isOpen()
+	|| H5Iget_ref(dataset.locationID()) != 2) {
+      cerr << "-- Swap did not exchange the dataset identifier" << endl;
+      nofFailedTests++;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+  
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                     test_async
+
+/*!
+  \brief Test asynchronous reading of the data
+
+  \param fileID          -- HDF5 object identifier for the file.
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_async (hid_t const &fileID)
+{
+  cout << "\n[tTBB_DipoleDataset::test_async]\n" << endl;
+
+  int nofFailedTests = 0;
+  int nofSamples     = 1024;
+  std::vector<hsize_t> shape (1,nofSamples);
+  std::vector<short> data (nofSamples);
+
+  for (int n=0; n<nofSamples; ++n) {
+    data[n] = n;
+  }
+
+  hid_t dataspaceID = H5Screate_simple (1, &shape[0], NULL);
+  hid_t datasetID   = H5Dcreate (fileID, "000000002", H5T_NATIVE_SHORT, dataspaceID,
+				 H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  H5Dwrite (datasetID, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data[0]);
+  H5Dclose (datasetID);
+  H5Sclose (dataspaceID);
+
+  cout << "[1] Testing readDataAsync(int,int,short*) ..." << endl;
+  try {
+    TBB_DipoleDataset dataset (fileID,"000000002");
+    std::vector<short> buffer (nofSamples,-1);
+    HDF5Future future = dataset.readDataAsync (0, nofSamples, &buffer[0]);
+
+    if (!future.wait() || buffer != data) {
+      cerr << "-- Data read back do not match data written" << endl;
+      nofFailedTests++;
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
+  cout << "[2] Testing destruction with readDataAsync() pending ..." << endl;
+  try {
+    std::vector<short> buffer (nofSamples,-1);
+    std::vector<HDF5Future> futures;
+
+    /* Hold the lock, such that the requests are still queued on destruction */
+    {
+      HDF5IOExecutor::Lock lock;
+      TBB_DipoleDataset *dataset = new TBB_DipoleDataset (fileID,"000000002");
+      for (int n=0; n<nofSamples; n+=128) {
+	futures.push_back (dataset->readDataAsync (n, 128, &buffer[n]));
+      }
+      delete dataset;
+    }
+
+    for (unsigned int n=0; n<futures.size(); ++n) {
+      if (!futures[n].wait()) {
+	nofFailedTests++;
+      }
+    }
+
+    if (buffer != data) {
+      cerr << "-- Data read back do not match data written" << endl;
+      nofFailedTests++;
+    }
+
+    /* Destroy while the executor thread works on the requests */
+    std::vector<short> buffers (10*nofSamples,-1);
+    futures.clear();
+    for (int n=0; n<10; ++n) {
+      TBB_DipoleDataset dataset (fileID,"000000002");
+      futures.push_back (dataset.readDataAsync (0, nofSamples, &buffers[n*nofSamples]));
+    }
+
+    for (unsigned int n=0; n<futures.size(); ++n) {
+      if (!futures[n].wait()
+	  || !std::equal (data.begin(), data.end(), buffers.begin()+n*nofSamples)) {
+	nofFailedTests++;
+      }
+    }
+  } catch (std::string message) {
+    cerr << message << endl;
+    nofFailedTests++;
+  }
+
   return nofFailedTests;
 }
 
@@ -450,6 +579,8 @@ int main (int argc, char *argv[])
     
     // Test for the constructor(s)
     nofFailedTests += test_constructors (fileID);
+    // Test asynchronous access to the data
+    nofFailedTests += test_async (fileID);
     
     if (haveDataset) {
       // Test for the constructor(s)
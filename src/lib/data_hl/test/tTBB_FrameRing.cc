@@ -0,0 +1,324 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cstring>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <data_hl/TBB_FrameRing.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::TBB_FrameRing;
+
+/*!
+  \file tTBB_FrameRing.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the DAL::TBB_FrameRing class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//! Number of frames pushed through the ring by the producer thread
+const unsigned int nofTestFrames = 200000;
+
+// -----------------------------------------------------------------------------
+
+//! Producer thread: publish frames carrying their sequence number
+void * producer (void *arg)
+{
+  TBB_FrameRing *ring = static_cast<TBB_FrameRing*>(arg);
+  unsigned int n = 0;
+
+  while (n < nofTestFrames) {
+    /* Do not overrun the consumer, we want to check the ordering */
+    if (ring->fill() >= ring->nofSlots()) {
+      continue;
+    }
+    char *slot = ring->writeSlot();
+    memcpy (slot, &n, sizeof(n));
+    ring->commit (sizeof(n));
+    ++n;
+  }
+
+  return NULL;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test constructors for a new TBB_FrameRing object
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tTBB_FrameRing::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing argumented constructor ..." << endl;
+  {
+    TBB_FrameRing ring (100, 2141);
+    ring.summary();
+
+    if (!ring.empty() || ring.nofSlots() != 100 || ring.slotSize() != 2141) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing rings sharing a signal ..." << endl;
+  {
+    DAL::TBB_FrameSignal signal;
+    TBB_FrameRing ring1 (10, 2141, &signal);
+    TBB_FrameRing ring2 (10, 2141, &signal);
+
+    if (ring1.signal() != ring2.signal()) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test handling of a full ring
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_overflow ()
+{
+  cout << "\n[tTBB_FrameRing::test_overflow]\n" << endl;
+
+  int nofFailedTests (0);
+  unsigned int nofSlots (16);
+  TBB_FrameRing ring (nofSlots, 64);
+
+  cout << "[1] Fill the ring beyond its capacity ..." << endl;
+  for (unsigned int n=0; n<nofSlots+5; ++n) {
+    char *slot = ring.writeSlot();
+    memcpy (slot, &n, sizeof(n));
+    ring.commit (sizeof(n));
+  }
+  ring.summary();
+
+  if (ring.fill() != nofSlots || ring.nofDropped() != 5 || ring.nofFull() != 5) {
+    cerr << "-- Unexpected fill level or drop count" << endl;
+    ++nofFailedTests;
+  }
+
+  cout << "[2] Drain the ring ..." << endl;
+  {
+    int nofBytes;
+    unsigned int value;
+    unsigned int expected (0);
+    char *frame;
+
+    while ((frame = ring.readSlot(nofBytes))) {
+      memcpy (&value, frame, sizeof(value));
+      if (value != expected || nofBytes != (int)sizeof(value)) {
+	++nofFailedTests;
+      }
+      ring.release();
+      ++expected;
+    }
+
+    if (expected != nofSlots || ring.maxFill() != nofSlots) {
+      cerr << "-- Wrong number of frames read back: " << expected << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Wait on an empty ring ..." << endl;
+  if (ring.waitForFrame(0.05)) {
+    ++nofFailedTests;
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test passing frames between two threads
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_threads ()
+{
+  cout << "\n[tTBB_FrameRing::test_threads]\n" << endl;
+
+  int nofFailedTests (0);
+  TBB_FrameRing ring (1000, 2141);
+  pthread_t thread;
+  unsigned int expected (0);
+  unsigned int value;
+  int nofBytes;
+  char *frame;
+
+  cout << "[1] Consume " << nofTestFrames << " frames ..." << endl;
+
+  pthread_create (&thread, NULL, producer, &ring);
+
+  while (expected < nofTestFrames) {
+    if (!ring.waitForFrame(5.0)) {
+      cerr << "-- Timed out waiting for frame " << expected << endl;
+      ++nofFailedTests;
+      break;
+    }
+    while ((frame = ring.readSlot(nofBytes))) {
+      memcpy (&value, frame, sizeof(value));
+      if (value != expected) {
+	++nofFailedTests;
+      }
+      ring.release();
+      ++expected;
+    }
+  }
+
+  pthread_join (thread, NULL);
+  ring.summary();
+
+  if (ring.nofFrames() != nofTestFrames || ring.nofDropped() != 0) {
+    ++nofFailedTests;
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test batched ingest of datagrams from a socket
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_receive ()
+{
+  cout << "\n[tTBB_FrameRing::test_receive]\n" << endl;
+
+  int nofFailedTests (0);
+  unsigned int nofSlots (16);
+  unsigned int nofSent (40);
+  TBB_FrameRing ring (nofSlots, 64);
+  struct sockaddr_in address;
+  socklen_t length (sizeof(address));
+  int rx = socket (AF_INET, SOCK_DGRAM, 0);
+  int tx = socket (AF_INET, SOCK_DGRAM, 0);
+
+  memset (&address, 0, sizeof(address));
+  address.sin_family      = AF_INET;
+  address.sin_port        = 0;
+  address.sin_addr.s_addr = inet_addr ("127.0.0.1");
+
+  if (rx < 0 || tx < 0
+      || bind (rx, (struct sockaddr *) &address, sizeof(address)) < 0
+      || getsockname (rx, (struct sockaddr *) &address, &length) < 0) {
+    cerr << "-- Unable to set up loopback socket; skipping test." << endl;
+    return nofFailedTests;
+  }
+
+  cout << "[1] Set the socket receive buffer size ..." << endl;
+  {
+    int size = TBB_FrameRing::setReceiveBufferSize (rx, 1024*1024);
+    cout << "-- Effective receive buffer size = " << size << endl;
+    if (size <= 0) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Receive from an idle socket ..." << endl;
+  if (ring.receive(rx, 8) != 0) {
+    ++nofFailedTests;
+  }
+
+  cout << "[3] Receive " << nofSent << " datagrams in batches of 8 ..." << endl;
+  {
+    int nofFrames;
+    unsigned int nofReceived (0);
+
+    for (unsigned int n=0; n<nofSent; ++n) {
+      sendto (tx, &n, sizeof(n), 0, (struct sockaddr *) &address, sizeof(address));
+    }
+
+    while ((nofFrames = ring.receive(rx, 8)) > 0) {
+      nofReceived += nofFrames;
+    }
+    ring.summary();
+
+    if (nofReceived != nofSent
+	|| ring.fill() != nofSlots
+	|| ring.nofDropped() != nofSent-nofSlots
+	|| ring.maxBatch() != 8) {
+      cerr << "-- Unexpected number of frames received or dropped" << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[4] Check the frames in the ring ..." << endl;
+  {
+    int nofBytes;
+    unsigned int value;
+    unsigned int expected (0);
+    char *frame;
+
+    while ((frame = ring.readSlot(nofBytes))) {
+      memcpy (&value, frame, sizeof(value));
+      if (value != expected || nofBytes != (int)sizeof(value)) {
+	++nofFailedTests;
+      }
+      ring.release();
+      ++expected;
+    }
+  }
+
+  close (tx);
+  close (rx);
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+int main ()
+{
+  int nofFailedTests (0);
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_overflow ();
+  nofFailedTests += test_threads ();
+  nofFailedTests += test_receive ();
+
+  return nofFailedTests;
+}
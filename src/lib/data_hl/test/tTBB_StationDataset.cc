@@ -0,0 +1,363 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <data_hl/TBB_StationDataset.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::TBB_StationDataset;
+
+/*!
+  \file tTBB_StationDataset.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the DAL::TBB_StationDataset class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//! Number of dipoles written to the test file
+const unsigned int nofDipoles = 5;
+//! Number of samples written per dipole
+const int dataLength          = 12000;
+
+//_______________________________________________________________________________
+//                                                                    sampleValue
+
+/*!
+  \brief ADC value stored in the test file
+
+  \param row    -- Row of the dipole.
+  \param sample -- Number of the sample.
+  \return value -- ADC value.
+*/
+short sampleValue (unsigned int const &row,
+		   long const &sample)
+{
+  return (short)((sample*17+row*1013)%4096) - 2048;
+}
+
+//_______________________________________________________________________________
+//                                                                    checkBuffer
+
+/*!
+  \brief Check a block of samples returned by TBB_StationDataset::readData
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int checkBuffer (std::vector<short> const &data,
+		 std::vector<unsigned int> const &rows,
+		 std::vector<int> const &start,
+		 int const &nofSamples)
+{
+  for (unsigned int k=0; k<rows.size(); ++k) {
+    for (int n=0; n<nofSamples; ++n) {
+      long sample    = long(start[k])+n;
+      short expected = 0;
+      if (sample >= 0 && sample < dataLength) {
+	expected = sampleValue (rows[k], sample);
+      }
+      if (data[k*nofSamples+n] != expected) {
+	cerr << "-- Mismatch at sample " << n << " of row " << rows[k]
+	     << ": " << data[k*nofSamples+n] << " != " << expected << endl;
+	return 1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+//_______________________________________________________________________________
+//                                                              test_constructors
+
+/*!
+  \brief Test constructors for a new TBB_StationDataset object
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors (hid_t const &groupID)
+{
+  cout << "\n[tTBB_StationDataset::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing TBB_StationDataset() ..." << endl;
+  {
+    TBB_StationDataset station;
+    station.summary();
+
+    if (station.isOpen() || station.nofDipoles() != 0) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing TBB_StationDataset(hid_t) without station dataset ..." << endl;
+  {
+    TBB_StationDataset station (groupID);
+
+    if (station.isOpen() || TBB_StationDataset::exists (groupID)) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                     test_write
+
+/*!
+  \brief Test creating a station dataset and writing the dipoles
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_write (hid_t const &groupID)
+{
+  cout << "\n[tTBB_StationDataset::test_write]\n" << endl;
+
+  int nofFailedTests (0);
+  TBB_StationDataset station;
+
+  cout << "[1] Testing create(hid_t,hsize_t,hsize_t) ..." << endl;
+
+  if (!station.create (groupID, 2, 1000)) {
+    cerr << "-- Failed to create the station dataset" << endl;
+    return ++nofFailedTests;
+  }
+
+  std::vector<hsize_t> chunking = station.chunking();
+
+  if (chunking.size() != 2 || chunking[0] != 2 || chunking[1] != 1000) {
+    ++nofFailedTests;
+  }
+
+  cout << "[2] Testing addDipole(Dipole) ..." << endl;
+  {
+    TBB_StationDataset::Dipole dipole;
+    dipole.stationID       = 1;
+    dipole.rspID           = 0;
+    dipole.time            = 1000000;
+    dipole.sampleNumber    = 512;
+    dipole.samplesPerFrame = 1024;
+    dipole.sampleFrequency = 200;
+    dipole.dataLength      = 0;
+
+    /* Rows are added in descending order of the RCU */
+    for (unsigned int row=0; row<nofDipoles; ++row) {
+      dipole.rcuID = nofDipoles-row;
+      if (station.addDipole (dipole) != int(row)) {
+	++nofFailedTests;
+      }
+    }
+
+    /* A dipole can be stored only once */
+    if (station.addDipole (dipole) >= 0) {
+      cerr << "-- Dipole added twice" << endl;
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing writeData(short*,unsigned int,hsize_t,hsize_t) ..." << endl;
+  {
+    std::vector<short> buffer (dataLength);
+
+    for (unsigned int row=0; row<nofDipoles; ++row) {
+      for (int n=0; n<dataLength; ++n) {
+	buffer[n] = sampleValue (row, n);
+      }
+      /* Written in two parts, the dataset being extended as required */
+      if (!station.writeData (&buffer[0], row, 0, dataLength/2)
+	  || !station.writeData (&buffer[dataLength/2], row, dataLength/2,
+				 dataLength-dataLength/2)) {
+	++nofFailedTests;
+      }
+    }
+
+    if (station.writeData (&buffer[0], nofDipoles, 0, 10)) {
+      cerr << "-- Wrote to a row not holding a dipole" << endl;
+      ++nofFailedTests;
+    }
+
+    if (station.nofSamples() != hsize_t(dataLength)
+	|| station.dipole(0).dataLength != (unsigned int)dataLength) {
+      ++nofFailedTests;
+    }
+
+    station.summary();
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                      test_read
+
+/*!
+  \brief Test reading blocks of samples for several dipoles
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_read (hid_t const &groupID)
+{
+  cout << "\n[tTBB_StationDataset::test_read]\n" << endl;
+
+  int nofFailedTests (0);
+  int nofSamples (1500);
+  TBB_StationDataset station (groupID);
+
+  cout << "[1] Testing open(hid_t) ..." << endl;
+  {
+    std::vector<hsize_t> shape = station.shape();
+
+    if (!station.isOpen()
+	|| shape.size() != 2
+	|| shape[0] != nofDipoles
+	|| shape[1] != hsize_t(dataLength)) {
+      cerr << "-- Wrong shape of the station dataset" << endl;
+      return ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing the dipole table ..." << endl;
+  {
+    for (unsigned int row=0; row<nofDipoles; ++row) {
+      TBB_StationDataset::Dipole dipole = station.dipole(row);
+      if (dipole.rcuID != nofDipoles-row
+	  || dipole.sampleNumber != 512
+	  || dipole.sampleFrequency != 200
+	  || dipole.dataLength != (unsigned int)dataLength) {
+	cerr << "-- Wrong metadata in row " << row << endl;
+	++nofFailedTests;
+      }
+    }
+
+    std::string name = station.dipoleName(1);
+
+    if (station.findDipole (name) != 1 || station.findDipole ("999999999") != -1) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[3] Testing readData() for rows in ascending order ..." << endl;
+  {
+    std::vector<unsigned int> rows;
+    std::vector<int> start;
+    std::vector<short> data (3*nofSamples);
+
+    rows.push_back(0);  start.push_back(10);
+    rows.push_back(2);  start.push_back(1999);
+    rows.push_back(3);  start.push_back(5000);
+
+    if (!station.readData (&data[0], rows, start, nofSamples)) {
+      ++nofFailedTests;
+    }
+    nofFailedTests += checkBuffer (data, rows, start, nofSamples);
+  }
+
+  cout << "[4] Testing readData() for unordered and repeated rows ..." << endl;
+  {
+    std::vector<unsigned int> rows;
+    std::vector<int> start;
+    std::vector<short> data (4*nofSamples);
+
+    rows.push_back(4);  start.push_back(0);
+    rows.push_back(1);  start.push_back(700);
+    rows.push_back(4);  start.push_back(3);
+    rows.push_back(0);  start.push_back(8000);
+
+    if (!station.readData (&data[0], rows, start, nofSamples)) {
+      ++nofFailedTests;
+    }
+    nofFailedTests += checkBuffer (data, rows, start, nofSamples);
+  }
+
+  cout << "[5] Testing readData() beyond the limits of the dataset ..." << endl;
+  {
+    std::vector<unsigned int> rows;
+    std::vector<int> start;
+    std::vector<short> data (3*nofSamples, -1);
+
+    rows.push_back(1);  start.push_back(-100);
+    rows.push_back(2);  start.push_back(dataLength-nofSamples/2);
+    rows.push_back(3);  start.push_back(dataLength+10);
+
+    if (!station.readData (&data[0], rows, start, nofSamples)) {
+      ++nofFailedTests;
+    }
+    nofFailedTests += checkBuffer (data, rows, start, nofSamples);
+  }
+
+  cout << "[6] Testing readData() with inconsistent parameters ..." << endl;
+  {
+    std::vector<unsigned int> rows (2, 0);
+    std::vector<int> start (2, 0);
+    std::vector<short> data (2*nofSamples);
+
+    rows[1] = nofDipoles;
+
+    if (station.readData (&data[0], rows, start, nofSamples)
+	|| station.readData (&data[0], rows, std::vector<int>(1,0), nofSamples)) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                                           main
+
+int main ()
+{
+  int nofFailedTests (0);
+  std::string filename ("tTBB_StationDataset.h5");
+
+  hid_t fileID = H5Fcreate (filename.c_str(),
+			    H5F_ACC_TRUNC,
+			    H5P_DEFAULT,
+			    H5P_DEFAULT);
+  if (fileID < 0) {
+    cerr << "ERROR : Failed to create file " << filename << endl;
+    return -1;
+  }
+
+  hid_t groupID = H5Gcreate (fileID, "Station001",
+			     H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+  nofFailedTests += test_constructors (groupID);
+  nofFailedTests += test_write (groupID);
+  nofFailedTests += test_read (groupID);
+
+  H5Gclose (groupID);
+  H5Fclose (fileID);
+
+  return nofFailedTests;
+}
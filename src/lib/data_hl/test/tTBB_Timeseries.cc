@@ -26,11 +26,16 @@
 #include <casa/HDF5/HDF5Record.h>
 #endif
 
+#include <core/HDF5Object.h>
 #include <data_hl/TBB_Timeseries.h>
 
 using std::cerr;
 using std::cout;
 using std::endl;
+using DAL::HDF5Object;
+using DAL::IO_Mode;
+using DAL::TBB_DipoleDataset;
+using DAL::TBB_StationGroup;
 using DAL::TBB_Timeseries;
 
 /*!
@@ -397,6 +402,314 @@ int test_data (std::string const &filename)
 
 #endif
 
+//_______________________________________________________________________________
+//                                                                    sampleValue
+
+/*!
+  \brief ADC value stored in the test file created by test_readBuffers()
+
+  \param dipole -- Index of the dipole within the selection.
+  \param sample -- Number of the sample.
+  \return value -- ADC value.
+*/
+short sampleValue (unsigned int const &dipole,
+		   unsigned int const &sample)
+{
+  return (short)((sample*31+dipole*1009)%4096) - 2048;
+}
+
+//_______________________________________________________________________________
+//                                                               test_readBuffers
+
+/*!
+  \brief Test reading the data of the selected dipoles into caller-owned arrays
+
+  The test file is created from scratch: two stations with three dipoles each,
+  one of the datasets using a chunked layout, such that it cannot be mapped
+  from the file.
+
+  \return nofFailedTests -- The number of failed tests.
+*/
+int test_readBuffers ()
+{
+  cout << "\n[tTBB_Timeseries::test_readBuffers]\n" << endl;
+
+  int nofFailedTests (0);
+  std::string filename ("tTBB_Timeseries_read.h5");
+  unsigned int nofStations = 2;
+  unsigned int nofRCUs     = 3;
+  unsigned int nofDipoles  = nofStations*nofRCUs;
+  hsize_t dataLength       = 10000;
+
+  cout << "[1] Creating test file " << filename << " ..." << endl;
+  {
+    hid_t fileID  = HDF5Object::openFile (filename, IO_Mode(IO_Mode::Create));
+    short *buffer = new short [dataLength];
+    hid_t dataspace = H5Screate_simple (1, &dataLength, NULL);
+    hid_t chunked   = H5Pcreate (H5P_DATASET_CREATE);
+    hsize_t chunk   = 1024;
+    H5Pset_chunk (chunked, 1, &chunk);
+
+    for (unsigned int station=0; station<nofStations; ++station) {
+      std::string name = TBB_StationGroup::getName (station+1);
+      hid_t groupID    = H5Gcreate (fileID, name.c_str(),
+				    H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      for (unsigned int rcu=0; rcu<nofRCUs; ++rcu) {
+	unsigned int dipole = station*nofRCUs+rcu;
+	for (hsize_t n=0; n<dataLength; ++n) {
+	  buffer[n] = sampleValue (dipole, n);
+	}
+	name = TBB_DipoleDataset::dipoleName (station+1, 0, rcu);
+	hid_t datasetID = H5Dcreate (groupID, name.c_str(), H5T_STD_I16LE, dataspace,
+				     H5P_DEFAULT,
+				     dipole == 4 ? chunked : H5P_DEFAULT,
+				     H5P_DEFAULT);
+	H5Dwrite (datasetID, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer);
+	H5Dclose (datasetID);
+      }
+      H5Gclose (groupID);
+    }
+
+    H5Pclose (chunked);
+    H5Sclose (dataspace);
+    H5Fclose (fileID);
+    delete [] buffer;
+  }
+
+  TBB_Timeseries ts (filename, IO_Mode(IO_Mode::ReadOnly));
+  int nofSamples = 1000;
+  std::vector<int> start (nofDipoles, 0);
+
+  if (ts.dipoleSelection().size() != nofDipoles) {
+    cerr << "-- Wrong number of selected dipoles: "
+	 << ts.dipoleSelection().size() << endl;
+    return ++nofFailedTests;
+  }
+
+  /* The dipole datasets are opened on first use */
+  typedef std::map<std::string,TBB_DipoleDataset>::iterator iterDipoleDataset;
+  std::map<std::string,iterDipoleDataset> selection = ts.dipoleSelection();
+  std::map<std::string,iterDipoleDataset>::iterator it;
+
+  for (it=selection.begin(); it!=selection.end(); ++it) {
+    if ((it->second)->second.isOpen()) {
+      cerr << "-- Dataset " << it->first << " opened before first use" << endl;
+      ++nofFailedTests;
+      break;
+    }
+  }
+
+  cout << "[2] Testing readData(short*,vector<int>,int) ..." << endl;
+  {
+    std::vector<short> data (nofDipoles*nofSamples);
+
+    for (unsigned int n=0; n<nofDipoles; ++n) {
+      start[n] = 100*n+1;
+    }
+
+    if (!ts.readData (&data[0], start, nofSamples)) {
+      ++nofFailedTests;
+    }
+
+    for (unsigned int n=0; n<nofDipoles*nofSamples; ++n) {
+      unsigned int dipole = n/nofSamples;
+      if (data[n] != sampleValue (dipole, start[dipole]+n%nofSamples)) {
+	cerr << "-- Mismatch at sample " << n%nofSamples
+	     << " of dipole " << dipole << endl;
+	++nofFailedTests;
+	break;
+      }
+    }
+  }
+
+  cout << "[3] Testing readData(float*,vector<int>,int,size_t) ..." << endl;
+  {
+    size_t stride = nofSamples+5;
+    std::vector<float> data (nofDipoles*stride, -1.0f);
+
+    /* Blocks partially before the start and beyond the end of the datasets */
+    start[0] = -10;
+    start[1] = dataLength-nofSamples+7;
+    start[2] = dataLength;
+
+    if (!ts.readData (&data[0], start, nofSamples, stride)) {
+      ++nofFailedTests;
+    }
+
+    for (unsigned int dipole=0; dipole<nofDipoles; ++dipole) {
+      for (int n=0; n<nofSamples; ++n) {
+	long sample    = long(start[dipole])+n;
+	float expected = 0;
+	if (sample >= 0 && sample < long(dataLength)) {
+	  expected = sampleValue (dipole, sample);
+	}
+	if (data[dipole*stride+n] != expected) {
+	  cerr << "-- Mismatch at sample " << n << " of dipole " << dipole
+	       << ": " << data[dipole*stride+n] << " != " << expected << endl;
+	  ++nofFailedTests;
+	  dipole = nofDipoles;
+	  break;
+	}
+      }
+      /* Elements between the columns are left untouched */
+      if (dipole < nofDipoles && data[dipole*stride+nofSamples] != -1.0f) {
+	++nofFailedTests;
+      }
+    }
+  }
+
+  cout << "[4] Testing readData(double*,vector<int>,int) from a single thread ..."
+       << endl;
+  {
+    std::vector<double> parallel (nofDipoles*nofSamples);
+    std::vector<double> serial (nofDipoles*nofSamples);
+
+    ts.readData (&parallel[0], start, nofSamples);
+    ts.setNofReadThreads (1);
+    ts.readData (&serial[0], start, nofSamples);
+
+    if (ts.nofReadThreads() != 1 || parallel != serial) {
+      ++nofFailedTests;
+    }
+    if (serial[3*nofSamples+17] != sampleValue (3, start[3]+17)) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[5] Testing readData with inconsistent parameters ..." << endl;
+  {
+    std::vector<short> data (nofDipoles*nofSamples);
+    std::vector<int> tooShort (nofDipoles-1, 0);
+
+    if (ts.readData (&data[0], tooShort, nofSamples)
+	|| ts.readData (&data[0], start, nofSamples, nofSamples-1)) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[6] Testing that the datasets read from have been opened ..." << endl;
+  {
+    for (it=selection.begin(); it!=selection.end(); ++it) {
+      if (!(it->second)->second.isOpen()) {
+	cerr << "-- Dataset " << it->first << " still closed" << endl;
+	++nofFailedTests;
+	break;
+      }
+    }
+  }
+
+  return nofFailedTests;
+}
+
+//_______________________________________________________________________________
+//                                                         test_readStationLayout
+
+/*!
+  \brief Test reading dipoles stored in a station-level [dipole,sample] dataset
+
+  The test file holds a single station: RCU 0 is stored as a dataset of its
+  own, RCUs 1-3 as rows of the station dataset, added in descending order. The
+  columns returned by readData() follow the names of the dipoles.
+
+  \return nofFailedTests -- The number of failed tests.
+*/
+int test_readStationLayout ()
+{
+  cout << "\n[tTBB_Timeseries::test_readStationLayout]\n" << endl;
+
+  int nofFailedTests (0);
+  std::string filename ("tTBB_Timeseries_station.h5");
+  unsigned int nofDipoles = 4;
+  hsize_t dataLength      = 10000;
+  int nofSamples          = 1000;
+
+  cout << "[1] Creating test file " << filename << " ..." << endl;
+  {
+    hid_t fileID  = HDF5Object::openFile (filename, IO_Mode(IO_Mode::Create));
+    std::string name = TBB_StationGroup::getName (1);
+    hid_t groupID = H5Gcreate (fileID, name.c_str(),
+			       H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    std::vector<short> buffer (dataLength);
+
+    for (hsize_t n=0; n<dataLength; ++n) {
+      buffer[n] = sampleValue (0, n);
+    }
+    hid_t dataspace = H5Screate_simple (1, &dataLength, NULL);
+    name = TBB_DipoleDataset::dipoleName (1, 0, 0);
+    hid_t datasetID = H5Dcreate (groupID, name.c_str(), H5T_STD_I16LE, dataspace,
+				 H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite (datasetID, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &buffer[0]);
+    H5Dclose (datasetID);
+    H5Sclose (dataspace);
+
+    DAL::TBB_StationDataset station;
+    DAL::TBB_StationDataset::Dipole dipole;
+    station.create (groupID);
+    dipole.stationID       = 1;
+    dipole.rspID           = 0;
+    dipole.time            = 0;
+    dipole.sampleNumber    = 0;
+    dipole.samplesPerFrame = 1024;
+    dipole.sampleFrequency = 200;
+    dipole.dataLength      = 0;
+    for (unsigned int rcu=nofDipoles-1; rcu>0; --rcu) {
+      dipole.rcuID = rcu;
+      int row = station.addDipole (dipole);
+      for (hsize_t n=0; n<dataLength; ++n) {
+	buffer[n] = sampleValue (rcu, n);
+      }
+      station.writeData (&buffer[0], row, 0, dataLength);
+    }
+    station.close();
+
+    H5Gclose (groupID);
+    H5Fclose (fileID);
+  }
+
+  TBB_Timeseries ts (filename, IO_Mode(IO_Mode::ReadOnly));
+
+  if (ts.nofSelectedDatasets() != nofDipoles
+      || ts.dipoleSelection().size() != 1) {
+    cerr << "-- Wrong number of selected dipoles: "
+	 << ts.nofSelectedDatasets() << endl;
+    return ++nofFailedTests;
+  }
+
+  cout << "[2] Testing readData(double*,vector<int>,int) ..." << endl;
+  {
+    std::vector<double> data (nofDipoles*nofSamples);
+    std::vector<int> start (nofDipoles);
+
+    for (unsigned int n=0; n<nofDipoles; ++n) {
+      start[n] = 500*n - 100;
+    }
+    start[3] = dataLength-nofSamples/2;
+
+    if (!ts.readData (&data[0], start, nofSamples)) {
+      ++nofFailedTests;
+    }
+
+    for (unsigned int dipole=0; dipole<nofDipoles; ++dipole) {
+      for (int n=0; n<nofSamples; ++n) {
+	long sample     = long(start[dipole])+n;
+	double expected = 0;
+	if (sample >= 0 && sample < long(dataLength)) {
+	  expected = sampleValue (dipole, sample);
+	}
+	if (data[dipole*nofSamples+n] != expected) {
+	  cerr << "-- Mismatch at sample " << n << " of dipole " << dipole
+	       << ": " << data[dipole*nofSamples+n] << " != " << expected << endl;
+	  ++nofFailedTests;
+	  dipole = nofDipoles;
+	  break;
+	}
+      }
+    }
+  }
+
+  return nofFailedTests;
+}
+
 //_______________________________________________________________________________
 //                                                                           main
 
@@ -420,6 +733,8 @@ int main (int argc,
   //________________________________________________________
   // Run the tests
 
+  nofFailedTests += test_readBuffers ();
+  nofFailedTests += test_readStationLayout ();
   nofFailedTests += test_construction ();
 
   if (haveDataset) {
@@ -0,0 +1,507 @@
+/***************************************************************************
+ *   Copyright (C) 2011                                                    *
+ *   Lars B"ahren (bahren@astron.nl)                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cstring>
+#include <data_hl/TBBraw.h>
+
+// Namespace usage
+using std::cerr;
+using std::cout;
+using std::endl;
+using DAL::TBBraw;
+
+/*!
+  \file tTBBraw.cc
+
+  \ingroup DAL
+  \ingroup data_hl
+
+  \brief A collection of test routines for the DAL::TBBraw class
+
+  \author Lars B&auml;hren
+
+  \date 2011/06/14
+*/
+
+//! Number of samples in a transient data frame
+const int nofFrameSamples = 1024;
+//! Size of the frame header, [Bytes]
+const int headerSize      = 88;
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Fill a buffer with a transient data frame
+
+  \param frame    -- Buffer of (at least) TBB_FRAME_SIZE bytes
+  \param rcu      -- RCU ID of the dipole
+  \param frameNum -- Number of the frame in the data stream; used to set the
+         sample number and the sample values.
+*/
+void makeFrame (char *frame,
+		unsigned char rcu,
+		int frameNum)
+{
+  unsigned int sampleNr = frameNum*nofFrameSamples;
+  int time              = 1000000;
+  unsigned short nofSamples = nofFrameSamples;
+  short *data           = (short *)(frame+headerSize);
+
+  memset (frame, 0, TBB_FRAME_SIZE);
+  frame[0] = 1;    // station ID
+  frame[1] = 2;    // RSP ID
+  frame[2] = rcu;  // RCU ID
+  frame[3] = (char)200;  // sample frequency [MHz]
+  memcpy (frame+4,  &frameNum, 4);
+  memcpy (frame+8,  &time, 4);
+  memcpy (frame+12, &sampleNr, 4);
+  memcpy (frame+16, &nofSamples, 2);
+
+  for (int n=0; n<nofFrameSamples; ++n) {
+    data[n] = (short)((sampleNr+n)%30000);
+  }
+
+  /* Payload CRC, such that the CRC over samples and CRC words is zero */
+  uint16_t *crcWords = (uint16_t *)(data+nofFrameSamples);
+  uint32_t crc       = DAL::crc32 ((uint16_t *)data, nofFrameSamples+2);
+  crcWords[0] = crc >> 16;
+  crcWords[1] = crc & 0xffff;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Check the contents of a dipole dataset written by TBBraw
+
+  \param filename   -- Name of the HDF5 file
+  \param dataset    -- Path to the dipole dataset
+  \param nofFrames  -- Expected length of the dataset, [frames]
+  \param gapStart   -- First frame missing from the data
+  \param gapEnd     -- First frame after the gap in the data
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int checkDipole (std::string const &filename,
+		 std::string const &dataset,
+		 int nofFrames,
+		 int gapStart=0,
+		 int gapEnd=0)
+{
+  int nofFailedTests (0);
+  hsize_t dims[1];
+  hid_t fileID    = H5Fopen (filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  hid_t datasetID = H5Dopen (fileID, dataset.c_str(), H5P_DEFAULT);
+  hid_t spaceID   = H5Dget_space (datasetID);
+
+  H5Sget_simple_extent_dims (spaceID, dims, NULL);
+
+  if (dims[0] != (hsize_t)nofFrames*nofFrameSamples) {
+    cerr << "-- Wrong length of dataset " << dataset << " : " << dims[0] << endl;
+    ++nofFailedTests;
+  } else {
+    std::vector<short> data (dims[0]);
+    H5Dread (datasetID, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data[0]);
+    for (unsigned int n=0; n<dims[0]; ++n) {
+      int frame      = n/nofFrameSamples;
+      short expected = (frame>=gapStart && frame<gapEnd) ? 0 : (short)(n%30000);
+      if (data[n] != expected) {
+	cerr << "-- Wrong value at sample " << n << " : " << data[n] << endl;
+	++nofFailedTests;
+	break;
+      }
+    }
+  }
+
+  H5Sclose (spaceID);
+  H5Dclose (datasetID);
+  H5Fclose (fileID);
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test constructors for a new TBBraw object
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_constructors ()
+{
+  cout << "\n[tTBBraw::test_constructors]\n" << endl;
+
+  int nofFailedTests (0);
+
+  cout << "[1] Testing default constructor ..." << endl;
+  {
+    TBBraw tbb;
+    tbb.summary();
+
+    if (tbb.isConnected() || tbb.writeBufferSize() != TBBRAW_WRITE_BUFFER_CHUNKS*CHUNK_SIZE) {
+      ++nofFailedTests;
+    }
+  }
+
+  cout << "[2] Testing setWriteBufferSize() ..." << endl;
+  {
+    TBBraw tbb;
+
+    tbb.setWriteBufferSize (1);
+    if (tbb.writeBufferSize() != 2*CHUNK_SIZE) {
+      ++nofFailedTests;
+    }
+    tbb.setWriteBufferSize (10*CHUNK_SIZE+1);
+    if (tbb.writeBufferSize() != 11*CHUNK_SIZE) {
+      ++nofFailedTests;
+    }
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test writing frames through the per-dipole staging buffers
+
+  \param filename -- Name of the HDF5 file to create
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_write (std::string const &filename)
+{
+  cout << "\n[tTBBraw::test_write]\n" << endl;
+
+  int nofFailedTests (0);
+  int nofWrites (0);
+  char frame[TBB_FRAME_SIZE];
+
+  remove (filename.c_str());
+
+  cout << "[1] Write contiguous frames and a gap ..." << endl;
+  {
+    TBBraw tbb (filename);
+    tbb.doHeaderCRC (false);
+    tbb.setFixTimes (0);
+
+    /* Dipole 3: frames 0-199, then a gap, then frames 210-219 */
+    for (int n=0; n<220; ++n) {
+      if (n>=200 && n<210) {
+	continue;
+      }
+      makeFrame (frame, 3, n);
+      if (!tbb.processTBBrawBlock (frame, TBB_FRAME_SIZE)) {
+	++nofFailedTests;
+      }
+      /* Dipole 4: frames 0-49, interleaved with dipole 3 */
+      if (n < 50) {
+	makeFrame (frame, 4, n);
+	tbb.processTBBrawBlock (frame, TBB_FRAME_SIZE);
+      }
+    }
+
+    cout << "[2] Flush the staged data ..." << endl;
+    if (!tbb.flush()) {
+      ++nofFailedTests;
+    }
+    tbb.summary();
+
+    nofWrites = tbb.nofWrites();
+  }
+
+  /* With 260 frames, each frame written separately would be 260 writes */
+  if (nofWrites > 20) {
+    cerr << "-- Too many write operations: " << nofWrites << endl;
+    ++nofFailedTests;
+  }
+
+  cout << "[3] Check the data written to file ..." << endl;
+  nofFailedTests += checkDipole (filename, "Station001/001002003", 220, 200, 210);
+  nofFailedTests += checkDipole (filename, "Station001/001002004", 50);
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test checking of the payload CRC
+
+  \param filename -- Name of the HDF5 file to create
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_dataCRC (std::string const &filename)
+{
+  cout << "\n[tTBBraw::test_dataCRC]\n" << endl;
+
+  int nofFailedTests (0);
+  char frame[TBB_FRAME_SIZE];
+
+  remove (filename.c_str());
+
+  TBBraw tbb (filename);
+  tbb.doHeaderCRC (false);
+  tbb.doDataCRC (true);
+  tbb.setFixTimes (0);
+
+  cout << "[1] Process a frame with intact payload ..." << endl;
+  makeFrame (frame, 5, 0);
+  if (!tbb.processTBBrawBlock (frame, TBB_FRAME_SIZE)) {
+    ++nofFailedTests;
+  }
+
+  cout << "[2] Process a frame with corrupted payload ..." << endl;
+  makeFrame (frame, 5, 1);
+  frame[headerSize+100] ^= 0x01;
+  if (tbb.processTBBrawBlock (frame, TBB_FRAME_SIZE)) {
+    cerr << "-- Corrupted payload not detected" << endl;
+    ++nofFailedTests;
+  }
+
+  tbb.summary();
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test preparing and writing frames by separate TBBraw objects
+
+  \param filename -- Name of the HDF5 file to create
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_prepare (std::string const &filename)
+{
+  cout << "\n[tTBBraw::test_prepare]\n" << endl;
+
+  int nofFailedTests (0);
+  char frame[TBB_FRAME_SIZE];
+
+  remove (filename.c_str());
+
+  {
+    TBBraw parser;
+    TBBraw tbb (filename);
+    parser.doHeaderCRC (false);
+    parser.doDataCRC (true);
+    parser.setFixTimes (0);
+
+    cout << "[1] Prepare frames in an unconnected object ..." << endl;
+    for (int n=0; n<30; ++n) {
+      makeFrame (frame, 6, n);
+      if (n==10) {
+	frame[headerSize+10] ^= 0x01;
+      }
+      if (parser.prepareTBBrawBlock (frame, TBB_FRAME_SIZE)) {
+	tbb.writeTBBrawBlock (frame);
+      } else if (n!=10) {
+	++nofFailedTests;
+      }
+    }
+
+    cout << "[2] Flush the staged data ..." << endl;
+    tbb.flush();
+    parser.summary();
+    tbb.summary();
+  }
+
+  cout << "[3] Check the data written to file ..." << endl;
+  nofFailedTests += checkDipole (filename, "Station001/001002006", 30, 10, 11);
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test compressing the chunks of the dipole arrays on several threads
+
+  \param filename -- Name of the HDF5 file to create
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_compression (std::string const &filename)
+{
+  cout << "\n[tTBBraw::test_compression]\n" << endl;
+
+  int nofFailedTests (0);
+  char frame[TBB_FRAME_SIZE];
+
+  remove (filename.c_str());
+
+  cout << "[1] Write frames with a gap, compressing on two threads ..." << endl;
+  {
+    TBBraw tbb (filename);
+    tbb.doHeaderCRC (false);
+    tbb.setFixTimes (0);
+    tbb.setFilters (DAL::HDF5FilterPipeline (DAL::HDF5FilterPipeline::Deflate, 1));
+    tbb.setCompressionThreads (2);
+
+    if (tbb.compressionThreads() != 2) {
+      ++nofFailedTests;
+    }
+
+    for (int n=0; n<220; ++n) {
+      if (n>=200 && n<210) {
+	continue;
+      }
+      makeFrame (frame, 7, n);
+      if (!tbb.processTBBrawBlock (frame, TBB_FRAME_SIZE)) {
+	++nofFailedTests;
+      }
+    }
+
+    if (!tbb.flush()) {
+      ++nofFailedTests;
+    }
+    tbb.summary();
+  }
+
+  cout << "[2] Check the data written to file ..." << endl;
+  nofFailedTests += checkDipole (filename, "Station001/001002007", 220, 200, 210);
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+/*!
+  \brief Test storing the dipoles of a station in a single [dipole,sample] dataset
+
+  \param filename -- Name of the HDF5 file to create
+
+  \return nofFailedTests -- The number of failed tests encountered within this
+          function.
+*/
+int test_stationLayout (std::string const &filename)
+{
+  cout << "\n[tTBBraw::test_stationLayout]\n" << endl;
+
+  int nofFailedTests (0);
+  char frame[TBB_FRAME_SIZE];
+
+  remove (filename.c_str());
+
+  cout << "[1] Write interleaved frames of two dipoles, with a gap ..." << endl;
+  {
+    TBBraw tbb (filename);
+    tbb.doHeaderCRC (false);
+    tbb.setFixTimes (0);
+    tbb.setStationLayout (true);
+
+    if (!tbb.stationLayout()) {
+      ++nofFailedTests;
+    }
+
+    for (int n=0; n<220; ++n) {
+      if (n>=200 && n<210) {
+	continue;
+      }
+      makeFrame (frame, 9, n);
+      if (!tbb.processTBBrawBlock (frame, TBB_FRAME_SIZE)) {
+	++nofFailedTests;
+      }
+      if (n < 50) {
+	makeFrame (frame, 8, n);
+	tbb.processTBBrawBlock (frame, TBB_FRAME_SIZE);
+      }
+    }
+
+    if (!tbb.flush()) {
+      ++nofFailedTests;
+    }
+    tbb.summary();
+  }
+
+  cout << "[2] Check the station dataset written to file ..." << endl;
+  {
+    hid_t fileID  = H5Fopen (filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t groupID = H5Gopen (fileID, "Station001", H5P_DEFAULT);
+    DAL::TBB_StationDataset station (groupID);
+    int nofSamples = 220*nofFrameSamples;
+
+    /* Rows in the order in which the dipoles showed up */
+    if (station.nofDipoles() != 2
+	|| station.nofSamples() != hsize_t(nofSamples)
+	|| station.dipoleName(0) != "001002009"
+	|| station.dipole(1).dataLength != (unsigned int)(50*nofFrameSamples)
+	|| H5Lexists (groupID, "001002009", H5P_DEFAULT) > 0) {
+      cerr << "-- Wrong layout of the station dataset" << endl;
+      ++nofFailedTests;
+    } else {
+      std::vector<unsigned int> rows (2);
+      std::vector<int> start (2, 0);
+      std::vector<short> data (2*nofSamples);
+
+      rows[1] = 1;
+      station.readData (&data[0], rows, start, nofSamples);
+
+      for (int n=0; n<2*nofSamples; ++n) {
+	int sample     = n%nofSamples;
+	int frame      = sample/nofFrameSamples;
+	bool missing   = n < nofSamples ? (frame>=200 && frame<210) : frame>=50;
+	short expected = missing ? 0 : (short)(sample%30000);
+	if (data[n] != expected) {
+	  cerr << "-- Wrong value at sample " << sample << " of row " << n/nofSamples
+	       << " : " << data[n] << endl;
+	  ++nofFailedTests;
+	  break;
+	}
+      }
+    }
+
+    station.close();
+    H5Gclose (groupID);
+    H5Fclose (fileID);
+  }
+
+  return nofFailedTests;
+}
+
+// -----------------------------------------------------------------------------
+
+int main (int argc,
+	  char *argv[])
+{
+  int nofFailedTests (0);
+  std::string filename ("tTBBraw.h5");
+
+  if (argc > 1) {
+    filename = argv[1];
+  }
+
+  nofFailedTests += test_constructors ();
+  nofFailedTests += test_write (filename);
+  nofFailedTests += test_dataCRC (filename);
+  nofFailedTests += test_prepare (filename);
+  nofFailedTests += test_compression (filename);
+  nofFailedTests += test_stationLayout (filename);
+
+  return nofFailedTests;
+}